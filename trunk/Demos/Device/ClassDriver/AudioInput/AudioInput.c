@@ -51,6 +51,15 @@ USB_ClassInfo_Audio_Device_t Microphone_Audio_Interface =
 			},
 	};
 
+/** Circular buffer of samples captured by the sample reload timer ISR, waiting to be written to the USB interface. */
+int16_t Samples[SAMPLE_BUFFER_SIZE];
+
+/** Index of the next free location in \ref Samples, written only by the sample reload timer ISR. */
+volatile uint8_t SamplesIn;
+
+/** Index of the next sample to write to the USB interface in \ref Samples, written only by the main program loop. */
+volatile uint8_t SamplesOut;
+
 /** Main program entry point. This routine contains the overall program flow, including initial
  *  setup of all components and the main program loop.
  */
@@ -62,7 +71,7 @@ int main(void)
 	
 	for (;;)
 	{
-		ProcessNextSample();
+		ProcessSamples();
 
 		Audio_Device_USBTask(&Microphone_Audio_Interface);
 		USB_USBTask();
@@ -89,26 +98,47 @@ void SetupHardware(void)
 	ADC_StartReading(ADC_REFERENCE_AVCC | ADC_RIGHT_ADJUSTED | MIC_IN_ADC_MUX_MASK);
 }
 
-/** Processes the next audio sample by reading the last ADC conversion and writing it to the audio
- *  interface, each time the sample reload timer period elapses to give a constant sample rate.
+/** Writes blocks of buffered samples captured by the sample reload timer ISR to the audio interface. */
+void ProcessSamples(void)
+{
+	uint8_t OutIndex      = SamplesOut;
+	uint8_t StoredSamples = ((SamplesIn - OutIndex) & (SAMPLE_BUFFER_SIZE - 1));
+
+	/* Limit the block to the contiguous stored samples before the end of the buffer */
+	if (StoredSamples > (SAMPLE_BUFFER_SIZE - OutIndex))
+	  StoredSamples = (SAMPLE_BUFFER_SIZE - OutIndex);
+	
+	if (!(StoredSamples))
+	  return;
+
+	uint8_t SamplesWritten = Audio_Device_WriteSampleFrames(&Microphone_Audio_Interface, &Samples[OutIndex],
+	                                                        sizeof(int16_t), StoredSamples);
+
+	SamplesOut = ((OutIndex + SamplesWritten) & (SAMPLE_BUFFER_SIZE - 1));
+}
+
+/** ISR to capture the last ADC conversion into the sample buffer each time the sample reload timer period
+ *  elapses, to give a constant sample rate.
  */
-void ProcessNextSample(void)
+ISR(TIMER0_COMPA_vect, ISR_BLOCK)
 {
-	/* Check if the sample reload timer period has elapsed, and that the USB bus is ready for a new sample */
-	if ((TIFR0 & (1 << OCF0A)) && Audio_Device_IsReadyForNextSample(&Microphone_Audio_Interface))
-	{
-		TIFR0 |= (1 << OCF0A);
+	uint8_t InIndex   = SamplesIn;
+	uint8_t NextIndex = ((InIndex + 1) & (SAMPLE_BUFFER_SIZE - 1));
 
-		/* Audio sample is ADC value scaled to fit the entire range */
-		int16_t AudioSample = ((SAMPLE_MAX_RANGE / ADC_MAX_RANGE) * ADC_GetResult());
-		
-		#if defined(MICROPHONE_BIASED_TO_HALF_RAIL)
-		/* Microphone is biased to half rail voltage, subtract the bias from the sample value */
-		AudioSample -= (SAMPLE_MAX_RANGE / 2);
-		#endif
+	/* Drop the sample if the host has not been reading samples quickly enough to leave space in the buffer */
+	if (NextIndex == SamplesOut)
+	  return;
 
-		Audio_Device_WriteSample16(&Microphone_Audio_Interface, AudioSample);
-	}
+	/* Audio sample is ADC value scaled to fit the entire range */
+	int16_t AudioSample = ((SAMPLE_MAX_RANGE / ADC_MAX_RANGE) * ADC_GetResult());
+	
+	#if defined(MICROPHONE_BIASED_TO_HALF_RAIL)
+	/* Microphone is biased to half rail voltage, subtract the bias from the sample value */
+	AudioSample -= (SAMPLE_MAX_RANGE / 2);
+	#endif
+
+	Samples[InIndex] = AudioSample;
+	SamplesIn        = NextIndex;
 }
 
 /** Event handler for the library USB Connection event. */
@@ -120,6 +150,11 @@ void EVENT_USB_Device_Connect(void)
 	OCR0A   = (F_CPU / 8 / AUDIO_SAMPLE_FREQUENCY) - 1;
 	TCCR0A  = (1 << WGM01);  // CTC mode
 	TCCR0B  = (1 << CS01);   // Fcpu/8 speed
+	TIMSK0  = (1 << OCIE0A); // Compare match interrupt
+
+	/* Discard any samples remaining from a previous connection */
+	SamplesIn  = 0;
+	SamplesOut = 0;
 }
 
 /** Event handler for the library USB Disconnection event. */
@@ -127,6 +162,7 @@ void EVENT_USB_Device_Disconnect(void)
 {
 	/* Stop the sample reload timer */
 	TCCR0B = 0;
+	TIMSK0 = 0;
 
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 }
@@ -40,6 +40,7 @@
 		#include <avr/io.h>
 		#include <avr/wdt.h>
 		#include <avr/power.h>
+		#include <avr/interrupt.h>
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
@@ -74,9 +75,14 @@
 		/** LED mask for the library LED driver, to indicate that an error has occurred in the USB interface. */
 		#define LEDMASK_USB_ERROR        (LEDS_LED1 | LEDS_LED3)
 
+		/** Number of samples which can be buffered between the sample reload timer ISR and the USB interface. This must
+		 *  be a power of two, no larger than 128.
+		 */
+		#define SAMPLE_BUFFER_SIZE        64
+
 	/* Function Prototypes: */
 		void SetupHardware(void);
-		void ProcessNextSample(void);
+		void ProcessSamples(void);
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
@@ -48,9 +48,29 @@ USB_ClassInfo_Audio_Device_t Speaker_Audio_Interface =
 
 				.DataOUTEndpointNumber    = AUDIO_STREAM_EPNUM,
 				.DataOUTEndpointSize      = AUDIO_STREAM_EPSIZE,
+
+				.FeedbackEndpointNumber   = AUDIO_FEEDBACK_EPNUM,
 			},
 	};
 
+/** Circular buffer of sample frames read from the USB interface, waiting to be output by the sample reload timer ISR. */
+SampleFrame_t SampleFrames[SAMPLE_FRAME_BUFFER_SIZE];
+
+/** Index of the next free location in \ref SampleFrames, written only by the main program loop. */
+volatile uint8_t SampleFramesIn;
+
+/** Index of the next frame to output in \ref SampleFrames, written only by the sample reload timer ISR. */
+volatile uint8_t SampleFramesOut;
+
+/** Number of sample reload timer periods elapsed, counted by the sample reload timer ISR. */
+uint16_t SampleClockCount;
+
+/** Number of sample reload timer periods elapsed over the last \ref FEEDBACK_MEASURE_FRAMES USB frames. */
+volatile uint16_t MeasuredSampleClocks;
+
+/** Flag to indicate that a new sample rate measurement is available in \ref MeasuredSampleClocks. */
+volatile bool SampleClocksMeasured;
+
 /** Main program entry point. This routine contains the overall program flow, including initial
  *  setup of all components and the main program loop.
  */
@@ -62,7 +82,7 @@ int main(void)
 	
 	for (;;)
 	{
-		ProcessNextSample();
+		ProcessSampleFrames();
 
 		Audio_Device_USBTask(&Speaker_Audio_Interface);
 		USB_USBTask();
@@ -84,20 +104,58 @@ void SetupHardware(void)
 	USB_Init();
 }
 
-/** Processes the next audio sample by reading the last ADC conversion and writing it to the audio
- *  interface, each time the sample reload timer period elapses to give a constant sample rate.
+/** Reads blocks of sample frames from the audio interface into the sample frame buffer, so that they can be
+ *  output at a constant sample rate by the sample reload timer ISR.
  */
-void ProcessNextSample(void)
+void ProcessSampleFrames(void)
 {
-	/* Check if the sample reload timer period has elapsed, and that the USB bus is ready for a new sample */
-	if ((TIFR0 & (1 << OCF0A)) && Audio_Device_IsSampleReceived(&Speaker_Audio_Interface))
+	uint8_t InIndex    = SampleFramesIn;
+	uint8_t FreeFrames = ((SAMPLE_FRAME_BUFFER_SIZE - 1) - ((InIndex - SampleFramesOut) & (SAMPLE_FRAME_BUFFER_SIZE - 1)));
+
+	/* Limit the block to the contiguous free space before the end of the buffer */
+	if (FreeFrames > (SAMPLE_FRAME_BUFFER_SIZE - InIndex))
+	  FreeFrames = (SAMPLE_FRAME_BUFFER_SIZE - InIndex);
+	
+	uint8_t FramesRead = Audio_Device_ReadSampleFrames(&Speaker_Audio_Interface, &SampleFrames[InIndex],
+	                                                   sizeof(SampleFrame_t), FreeFrames);
+
+	SampleFramesIn = ((InIndex + FramesRead) & (SAMPLE_FRAME_BUFFER_SIZE - 1));
+
+	/* Report the latest sample rate measurement to the host, corrected to keep the buffer half full */
+	if (SampleClocksMeasured)
 	{
-		/* Clear the sample reload timer */
-		TIFR0 |= (1 << OCF0A);
+		uint16_t SampleClocks;
+		
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			SampleClocks         = MeasuredSampleClocks;
+			SampleClocksMeasured = false;
+		}
+		
+		int16_t StoredFrames = ((SampleFramesIn - SampleFramesOut) & (SAMPLE_FRAME_BUFFER_SIZE - 1));
 
+		Audio_Device_UpdateFeedback(&Speaker_Audio_Interface, SampleClocks, FEEDBACK_MEASURE_FRAMES,
+		                            (StoredFrames - (SAMPLE_FRAME_BUFFER_SIZE / 2)));
+	}
+}
+
+/** ISR to output the next buffered sample frame each time the sample reload timer period elapses, to give a
+ *  constant sample rate.
+ */
+ISR(TIMER0_COMPA_vect, ISR_BLOCK)
+{
+	uint8_t OutIndex = SampleFramesOut;
+
+	SampleClockCount++;
+
+	/* Check that a sample frame has been buffered, and not yet output */
+	if (OutIndex != SampleFramesIn)
+	{
 		/* Retrieve the signed 16-bit left and right audio samples, convert to 8-bit */
-		int8_t  LeftSample_8Bit   = (Audio_Device_ReadSample16(&Speaker_Audio_Interface) >> 8);
-		int8_t  RightSample_8Bit  = (Audio_Device_ReadSample16(&Speaker_Audio_Interface) >> 8);
+		int8_t  LeftSample_8Bit   = (SampleFrames[OutIndex].Left  >> 8);
+		int8_t  RightSample_8Bit  = (SampleFrames[OutIndex].Right >> 8);
+		
+		SampleFramesOut = ((OutIndex + 1) & (SAMPLE_FRAME_BUFFER_SIZE - 1));
 
 		/* Mix the two channels together to produce a mono, 8-bit sample */
 		int8_t  MixedSample_8Bit  = (((int16_t)LeftSample_8Bit + (int16_t)RightSample_8Bit) >> 1);
@@ -139,6 +197,12 @@ void EVENT_USB_Device_Connect(void)
 	OCR0A   = (F_CPU / 8 / AUDIO_SAMPLE_FREQUENCY) - 1;
 	TCCR0A  = (1 << WGM01);  // CTC mode
 	TCCR0B  = (1 << CS01);   // Fcpu/8 speed
+	TIMSK0  = (1 << OCIE0A); // Compare match interrupt
+
+	/* Discard any frames and measurements remaining from a previous connection */
+	SampleFramesIn       = 0;
+	SampleFramesOut      = 0;
+	SampleClocksMeasured = false;
 
 #if defined(AUDIO_OUT_MONO)
 	/* Set speaker as output */
@@ -166,6 +230,7 @@ void EVENT_USB_Device_Disconnect(void)
 
 	/* Stop the sample reload timer */
 	TCCR0B = 0;
+	TIMSK0 = 0;
 
 #if (defined(AUDIO_OUT_MONO) || defined(AUDIO_OUT_STEREO))
 	/* Stop the PWM generation timer */
@@ -191,6 +256,8 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 	
 	if (!(Audio_Device_ConfigureEndpoints(&Speaker_Audio_Interface)))
 	  LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+
+	USB_Device_EnableSOFEvents();
 }
 
 /** Event handler for the library USB Unhandled Control Request event. */
@@ -198,3 +265,21 @@ void EVENT_USB_Device_UnhandledControlRequest(void)
 {
 	Audio_Device_ProcessControlRequest(&Speaker_Audio_Interface);
 }
+
+/** Event handler for the USB device Start Of Frame event, used to measure the sample reload timer rate against the
+ *  host's USB frame clock.
+ */
+void EVENT_USB_Device_StartOfFrame(void)
+{
+	static uint16_t LastSampleClockCount;
+	static uint8_t  FramesElapsed;
+
+	if (++FramesElapsed == FEEDBACK_MEASURE_FRAMES)
+	{
+		MeasuredSampleClocks  = (SampleClockCount - LastSampleClockCount);
+		SampleClocksMeasured  = true;
+
+		LastSampleClockCount  = SampleClockCount;
+		FramesElapsed         = 0;
+	}
+}
@@ -40,6 +40,9 @@
 		#include <avr/io.h>
 		#include <avr/wdt.h>
 		#include <avr/power.h>
+		#include <avr/interrupt.h>
+		#include <util/atomic.h>
+		#include <stdbool.h>
 		#include <stdlib.h>
 
 		#include "Descriptors.h"
@@ -61,14 +64,33 @@
 
 		/** LED mask for the library LED driver, to indicate that an error has occurred in the USB interface. */
 		#define LEDMASK_USB_ERROR        (LEDS_LED1 | LEDS_LED3)
+
+		/** Number of stereo sample frames which can be buffered between the USB interface and the sample reload timer ISR.
+		 *  This must be a power of two, no larger than 128.
+		 */
+		#define SAMPLE_FRAME_BUFFER_SIZE  64
+
+		/** Number of USB frames over which the sample reload timer rate is measured, to update the feedback value sent
+		 *  to the host so that it transmits sample frames at the rate they are consumed by the device.
+		 */
+		#define FEEDBACK_MEASURE_FRAMES   (1 << AUDIO_FEEDBACK_REFRESH)
+
+	/* Type Defines: */
+		/** Type define for a single stereo 16-bit sample frame, as sent by the host. */
+		typedef struct
+		{
+			int16_t Left; /**< Left channel audio sample */
+			int16_t Right; /**< Right channel audio sample */
+		} SampleFrame_t;
 		
 	/* Function Prototypes: */
 		void SetupHardware(void);
-		void ProcessNextSample(void);
+		void ProcessSampleFrames(void);
 		
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
 		void EVENT_USB_Device_ConfigurationChanged(void);
 		void EVENT_USB_Device_UnhandledControlRequest(void);
+		void EVENT_USB_Device_StartOfFrame(void);
 
 #endif
@@ -169,7 +169,7 @@ USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 			.InterfaceNumber          = 1,
 			.AlternateSetting         = 1,
 			
-			.TotalEndpoints           = 1,
+			.TotalEndpoints           = 2,
 			
 			.Class                    = 0x01,
 			.SubClass                 = 0x02,
@@ -211,13 +211,13 @@ USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 					.Header              = {.Size = sizeof(USB_Audio_StreamEndpoint_Std_t), .Type = DTYPE_Endpoint},
 
 					.EndpointAddress     = (ENDPOINT_DESCRIPTOR_DIR_OUT | AUDIO_STREAM_EPNUM),
-					.Attributes          = (EP_TYPE_ISOCHRONOUS | ENDPOINT_ATTR_SYNC | ENDPOINT_USAGE_DATA),
+					.Attributes          = (EP_TYPE_ISOCHRONOUS | ENDPOINT_ATTR_ASYNC | ENDPOINT_USAGE_DATA),
 					.EndpointSize        = AUDIO_STREAM_EPSIZE,
 					.PollingIntervalMS   = 1
 				},
 			
 			.Refresh                  = 0,
-			.SyncEndpointNumber       = 0
+			.SyncEndpointNumber       = (ENDPOINT_DESCRIPTOR_DIR_IN | AUDIO_FEEDBACK_EPNUM)
 		},
 		
 	.Audio_StreamEndpoint_SPC = 
@@ -229,6 +229,22 @@ USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 			
 			.LockDelayUnits           = 0x00,
 			.LockDelay                = 0x0000
+		},
+
+	.Audio_FeedbackEndpoint = 
+		{
+			.Endpoint = 
+				{
+					.Header              = {.Size = sizeof(USB_Audio_StreamEndpoint_Std_t), .Type = DTYPE_Endpoint},
+
+					.EndpointAddress     = (ENDPOINT_DESCRIPTOR_DIR_IN | AUDIO_FEEDBACK_EPNUM),
+					.Attributes          = (EP_TYPE_ISOCHRONOUS | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_FEEDBACK),
+					.EndpointSize        = AUDIO_FEEDBACK_EPSIZE,
+					.PollingIntervalMS   = 1
+				},
+			
+			.Refresh                  = AUDIO_FEEDBACK_REFRESH,
+			.SyncEndpointNumber       = 0
 		}
 };
 
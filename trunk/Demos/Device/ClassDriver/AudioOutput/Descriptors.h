@@ -51,6 +51,12 @@
 		 *  USB AVR models will result in unavoidable distorted output.
 		 */
 		#define AUDIO_STREAM_EPSIZE          ENDPOINT_MAX_SIZE(AUDIO_STREAM_EPNUM)
+
+		/** Endpoint number of the Audio isochronous feedback endpoint, reporting the device's actual sample rate to the host. */
+		#define AUDIO_FEEDBACK_EPNUM         2
+
+		/** Power of two exponent of the period in milliseconds at which the host should poll the feedback endpoint. */
+		#define AUDIO_FEEDBACK_REFRESH       5
 		
 		/** Sample frequency of the data being transmitted through the streaming endpoint. */
 		#define AUDIO_SAMPLE_FREQUENCY       48000
@@ -73,6 +79,7 @@
 			USB_Audio_Format_t                    Audio_AudioFormat;
 			USB_Audio_StreamEndpoint_Std_t        Audio_StreamEndpoint;
 			USB_Audio_StreamEndpoint_Spc_t        Audio_StreamEndpoint_SPC;
+			USB_Audio_StreamEndpoint_Std_t        Audio_FeedbackEndpoint;
 		} USB_Descriptor_Configuration_t;
 		
 	/* Function Prototypes: */
@@ -86,6 +86,32 @@ USB_ClassInfo_CDC_Device_t VirtualSerial2_CDC_Interface =
 			},
 	};
 
+/** LUFA CDC Class driver multiplexer ports, one for each of the device's CDC interfaces. The port counters record the
+ *  bytes sent through each interface, and how often an interface had to wait for the host to read its data.
+ */
+CDC_Device_MuxPort_t VirtualSerial_MuxPorts[] =
+	{
+		[MUX_PORT_JOYSTICK] = {.CDCInterfaceInfo = &VirtualSerial1_CDC_Interface},
+		[MUX_PORT_ECHO]     = {.CDCInterfaceInfo = &VirtualSerial2_CDC_Interface},
+	};
+
+/** LUFA CDC Class driver multiplexer configuration and state information. This services the IN endpoints of both CDC
+ *  interfaces in turn, so that the echo port cannot hold up the joystick strings while the host is flooding it with
+ *  data, nor the reverse.
+ */
+CDC_Device_Mux_t VirtualSerial_Mux =
+	{
+		.Config =
+			{
+				.Ports                            = VirtualSerial_MuxPorts,
+				.TotalPorts                       = (sizeof(VirtualSerial_MuxPorts) / sizeof(VirtualSerial_MuxPorts[0])),
+				.PortByteBudget                   = CDC_TXRX_EPSIZE,
+			},
+	};
+
+/** Joystick string waiting to be sent to the host through the first CDC interface, or NULL if none is pending. */
+static char* JoystickString;
+
 /** Main program entry point. This routine contains the overall program flow, including initial
  *  setup of all components and the main program loop.
  */
@@ -103,12 +129,8 @@ int main(void)
 		while (CDC_Device_BytesReceived(&VirtualSerial1_CDC_Interface))
 		  CDC_Device_ReceiveByte(&VirtualSerial1_CDC_Interface);
 
-		/* Echo all received data on the second CDC interface */
-		while (CDC_Device_BytesReceived(&VirtualSerial2_CDC_Interface))
-		  CDC_Device_SendByte(&VirtualSerial2_CDC_Interface, CDC_Device_ReceiveByte(&VirtualSerial2_CDC_Interface));
-		  
-		CDC_Device_USBTask(&VirtualSerial1_CDC_Interface);
-		CDC_Device_USBTask(&VirtualSerial2_CDC_Interface);
+		/* Send the joystick strings and echo the received data of the second CDC interface */
+		CDC_Device_MuxTask(&VirtualSerial_Mux);
 		USB_USBTask();
 	}
 }
@@ -129,8 +151,9 @@ void SetupHardware(void)
 	USB_Init();
 }
 
-/** Checks for changes in the position of the board joystick, sending strings to the host upon each change
- *  through the first of the CDC interfaces.
+/** Checks for changes in the position of the board joystick, queuing strings to be sent to the host upon each change
+ *  through the first of the CDC interfaces. A new movement is only reported once the string of the previous movement
+ *  has been sent.
  */
 void CheckJoystickMovement(void)
 {
@@ -151,12 +174,44 @@ void CheckJoystickMovement(void)
 	else
 	  ActionSent = false;
 	  
-	if ((ReportString != NULL) && (ActionSent == false))
+	if ((ReportString != NULL) && (ActionSent == false) && (JoystickString == NULL))
 	{
 		ActionSent = true;
 		
-		CDC_Device_SendString(&VirtualSerial1_CDC_Interface, ReportString, strlen(ReportString));		
+		JoystickString = ReportString;
+	}
+}
+
+/** CDC class driver callback for the next byte to send through a multiplexed CDC interface. The first interface sends
+ *  the pending joystick string, while the second echoes back the data received from the host.
+ *
+ *  \param[in,out] MuxInfo  Pointer to the CDC multiplexer being serviced
+ *  \param[in] PortIndex  Index of the port being serviced within the multiplexer
+ *  \param[out] Data  Pointer to a location where the next byte to send should be stored
+ *
+ *  \return Boolean true if a byte was stored to Data, false if the port has no data waiting to be sent
+ */
+bool CALLBACK_CDC_Device_MuxGetTxByte(CDC_Device_Mux_t* const MuxInfo, const uint8_t PortIndex, uint8_t* const Data)
+{
+	if (PortIndex == MUX_PORT_JOYSTICK)
+	{
+		if (JoystickString == NULL)
+		  return false;
+		
+		*Data = *(JoystickString++);
+		
+		if (*JoystickString == '\0')
+		  JoystickString = NULL;
 	}
+	else
+	{
+		if (!(CDC_Device_BytesReceived(&VirtualSerial2_CDC_Interface)))
+		  return false;
+
+		*Data = CDC_Device_ReceiveByte(&VirtualSerial2_CDC_Interface);
+	}
+
+	return true;
 }
 
 /** Event handler for the library USB Connection event. */
@@ -176,6 +231,8 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 {
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 
+	JoystickString = NULL;
+
 	if (!(CDC_Device_ConfigureEndpoints(&VirtualSerial1_CDC_Interface)))
 	  LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 
@@ -62,6 +62,12 @@
 
 		/** LED mask for the library LED driver, to indicate that an error has occurred in the USB interface. */
 		#define LEDMASK_USB_ERROR        (LEDS_LED1 | LEDS_LED3)
+
+		/** Index of the first CDC interface's port within the CDC multiplexer, which sends the joystick strings. */
+		#define MUX_PORT_JOYSTICK         0
+
+		/** Index of the second CDC interface's port within the CDC multiplexer, which echoes back the received data. */
+		#define MUX_PORT_ECHO             1
 		
 	/* Function Prototypes: */
 		void SetupHardware(void);
@@ -72,4 +78,6 @@
 		void EVENT_USB_Device_ConfigurationChanged(void);
 		void EVENT_USB_Device_UnhandledControlRequest(void);
 
+		bool CALLBACK_CDC_Device_MuxGetTxByte(CDC_Device_Mux_t* const MuxInfo, const uint8_t PortIndex, uint8_t* const Data);
+
 #endif
@@ -53,12 +53,16 @@
 			USB_Descriptor_Interface_t            HID_Interface;
 			USB_HID_Descriptor_t                  HID_GenericHID;
 	        USB_Descriptor_Endpoint_t             HID_ReportINEndpoint;
+	        USB_Descriptor_Endpoint_t             HID_ReportOUTEndpoint;
 		} USB_Descriptor_Configuration_t;
 
 	/* Macros: */
 		/** Endpoint number of the Generic HID reporting IN endpoint. */
 		#define GENERIC_IN_EPNUM          1
 
+		/** Endpoint number of the Generic HID reporting OUT endpoint. */
+		#define GENERIC_OUT_EPNUM         2
+
 		/** Size in bytes of the Generic HID reporting endpoint. */
 		#define GENERIC_EPSIZE            8
 		
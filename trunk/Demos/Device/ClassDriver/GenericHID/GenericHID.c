@@ -60,6 +60,11 @@ USB_ClassInfo_HID_Device_t Generic_HID_Interface =
 				.ReportINEndpointNumber       = GENERIC_IN_EPNUM,
 				.ReportINEndpointSize         = GENERIC_EPSIZE,
 				.ReportINEndpointDoubleBank   = false,
+
+				.ReportOUTEndpointNumber      = GENERIC_OUT_EPNUM,
+				.ReportOUTEndpointSize        = GENERIC_EPSIZE,
+				.ReportOUTEndpointDoubleBank  = false,
+				.ReportOUTMaxSize             = GENERIC_REPORT_SIZE,
 				
 				.PrevReportINBuffer           = PrevHIDReportBuffer,
 				.PrevReportINBufferSize       = sizeof(PrevHIDReportBuffer),
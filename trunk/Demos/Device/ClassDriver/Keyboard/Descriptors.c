@@ -57,9 +57,11 @@ USB_Descriptor_HIDReport_Datatype_t PROGMEM KeyboardReport[] =
 	0x15, 0x00,          /*   Logical Minimum (0)                           */
 	0x25, 0x01,          /*   Logical Maximum (1)                           */
 	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+#if !defined(KEYBOARD_NKRO)
 	0x95, 0x01,          /*   Report Count (1)                              */
 	0x75, 0x08,          /*   Report Size (8)                               */
 	0x81, 0x03,          /*   Input (Const, Variable, Absolute)             */
+#endif
 	0x95, 0x05,          /*   Report Count (5)                              */
 	0x75, 0x01,          /*   Report Size (1)                               */
 	0x05, 0x08,          /*   Usage Page (LEDs)                             */
@@ -69,6 +71,16 @@ USB_Descriptor_HIDReport_Datatype_t PROGMEM KeyboardReport[] =
 	0x95, 0x01,          /*   Report Count (1)                              */
 	0x75, 0x03,          /*   Report Size (3)                               */
 	0x91, 0x03,          /*   Output (Const, Variable, Absolute)            */
+#if defined(KEYBOARD_NKRO)
+	0x95, HID_KEYBOARD_NKRO_KEYCODES, /* Report Count (HID_KEYBOARD_NKRO_KEYCODES) */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x01,          /*   Logical Maximum (1)                           */
+	0x05, 0x07,          /*   Usage Page (Keyboard)                         */
+	0x19, 0x00,          /*   Usage Minimum (Reserved (no event indicated)) */
+	0x29, (HID_KEYBOARD_NKRO_KEYCODES - 1), /* Usage Maximum (Last NKRO Key Code) */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+#else
 	0x95, 0x06,          /*   Report Count (6)                              */
 	0x75, 0x08,          /*   Report Size (8)                               */
 	0x15, 0x00,          /*   Logical Minimum (0)                           */
@@ -77,9 +89,18 @@ USB_Descriptor_HIDReport_Datatype_t PROGMEM KeyboardReport[] =
 	0x19, 0x00,          /*   Usage Minimum (Reserved (no event indicated)) */
 	0x29, 0x65,          /*   Usage Maximum (Keyboard Application)          */
 	0x81, 0x00,          /*   Input (Data, Array, Absolute)                 */
+#endif
 	0xc0                 /* End Collection                                  */
 };
 
+#if defined(KEYBOARD_NKRO)
+/** Compile time check that the N-Key Rollover report structure is exactly the size of the input items declared in the
+ *  keyboard report descriptor (an 8-bit modifier bitmap followed by one bit per key code), as any mismatch would shift the
+ *  key bits decoded by the host. The array size is negative, causing a compile error, if the sizes differ.
+ */
+typedef char KeyboardNKROReportSizeCheck_t[(sizeof(USB_KeyboardNKROReport_Data_t) * 8 == (8 + HID_KEYBOARD_NKRO_KEYCODES)) ? 1 : -1];
+#endif
+
 /** Device descriptor structure. This descriptor, located in FLASH memory, describes the overall
  *  device characteristics, including the supported USB version, control endpoint size and the
  *  number of device configurations. The descriptor is read out by the USB host when the enumeration
@@ -163,7 +184,7 @@ USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 			.EndpointAddress        = (ENDPOINT_DESCRIPTOR_DIR_IN | KEYBOARD_EPNUM),
 			.Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
 			.EndpointSize           = KEYBOARD_EPSIZE,
-			.PollingIntervalMS      = 0x0A
+			.PollingIntervalMS      = KEYBOARD_POLLINGINTERVAL
 		},
 };
 
@@ -60,8 +60,20 @@
 		/** Endpoint number of the Keyboard HID reporting IN endpoint. */
 		#define KEYBOARD_EPNUM               1
 		
-		/** Size in bytes of the Keyboard HID reporting IN and OUT endpoints. */		
-		#define KEYBOARD_EPSIZE              8
+		#if defined(KEYBOARD_NKRO) || defined(__DOXYGEN__)
+			/** Size in bytes of the Keyboard HID reporting IN and OUT endpoints. */		
+			#define KEYBOARD_EPSIZE              16
+
+			/** Polling interval in milliseconds of the Keyboard HID reporting IN endpoint. */
+			#define KEYBOARD_POLLINGINTERVAL     1
+
+			/** Size in bytes of the largest Keyboard HID input report sent to the host. */
+			#define KEYBOARD_REPORT_SIZE         sizeof(USB_KeyboardNKROReport_Data_t)
+		#else
+			#define KEYBOARD_EPSIZE              8
+			#define KEYBOARD_POLLINGINTERVAL     10
+			#define KEYBOARD_REPORT_SIZE         sizeof(USB_KeyboardReport_Data_t)
+		#endif
 
 	/* Function Prototypes: */
 		uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue, const uint8_t wIndex, void** const DescriptorAddress)
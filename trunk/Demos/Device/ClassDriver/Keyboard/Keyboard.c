@@ -37,8 +37,13 @@
 
 #include "Keyboard.h"
 
-/** Buffer to hold the previously generated Keyboard HID report, for comparison purposes inside the HID class driver. */
-uint8_t PrevKeyboardHIDReportBuffer[sizeof(USB_KeyboardReport_Data_t)];
+/** Buffer to hold the Keyboard HID report being created by the HID class driver, large enough for the largest report format. */
+uint8_t KeyboardHIDReportBuffer[KEYBOARD_REPORT_SIZE];
+
+/** Current state of each of the keyboard's keys as of the last key scan, stored in N-Key Rollover bitmap form regardless of
+ *  the report format sent to the host.
+ */
+USB_KeyboardNKROReport_Data_t CurrentKeyStates;
 
 /** LUFA HID Class driver interface configuration and state information. This structure is
  *  passed to all HID Class driver functions, so that multiple instances of the same class
@@ -54,8 +59,10 @@ USB_ClassInfo_HID_Device_t Keyboard_HID_Interface =
 				.ReportINEndpointSize         = KEYBOARD_EPSIZE,
 				.ReportINEndpointDoubleBank   = false,
 
-				.PrevReportINBuffer           = PrevKeyboardHIDReportBuffer,
-				.PrevReportINBufferSize       = sizeof(PrevKeyboardHIDReportBuffer),
+				.PrevReportINBuffer           = KeyboardHIDReportBuffer,
+				.PrevReportINBufferSize       = sizeof(KeyboardHIDReportBuffer),
+				
+				.ReportINChangesMarked        = true,
 			},
     };
 
@@ -70,6 +77,8 @@ int main(void)
 	
 	for (;;)
 	{
+		ScanKeys();
+
 		HID_Device_USBTask(&Keyboard_HID_Interface);
 		USB_USBTask();
 	}
@@ -92,6 +101,55 @@ void SetupHardware()
 	USB_Init();
 }
 
+/** Scans the board joystick and buttons for key presses, updating the current key states. As the scan is decoupled from the
+ *  creation of the HID reports, the keyboard report is only marked as changed in the HID class driver when a key changes
+ *  state, so that a new report is created and sent to the host on the next poll of the keyboard's IN endpoint once any
+ *  previously sent report has been read by the host.
+ */
+void ScanKeys(void)
+{
+	USB_KeyboardNKROReport_Data_t NewKeyStates;
+
+	uint8_t JoyStatus_LCL    = Joystick_GetStatus();
+	uint8_t ButtonStatus_LCL = Buttons_GetStatus();
+
+	memset(&NewKeyStates, 0, sizeof(NewKeyStates));
+	
+	NewKeyStates.Modifier = HID_KEYBOARD_MODIFER_LEFTSHIFT;
+
+	if (JoyStatus_LCL & JOY_UP)
+	  SetKeyPressed(&NewKeyStates, 0x04); // A
+	else if (JoyStatus_LCL & JOY_DOWN)
+	  SetKeyPressed(&NewKeyStates, 0x05); // B
+
+	if (JoyStatus_LCL & JOY_LEFT)
+	  SetKeyPressed(&NewKeyStates, 0x06); // C
+	else if (JoyStatus_LCL & JOY_RIGHT)
+	  SetKeyPressed(&NewKeyStates, 0x07); // D
+
+	if (JoyStatus_LCL & JOY_PRESS)
+	  SetKeyPressed(&NewKeyStates, 0x08); // E
+	  
+	if (ButtonStatus_LCL & BUTTONS_BUTTON1)
+	  SetKeyPressed(&NewKeyStates, 0x09); // F
+
+	if (memcmp(&NewKeyStates, &CurrentKeyStates, sizeof(USB_KeyboardNKROReport_Data_t)) != 0)
+	{
+		CurrentKeyStates = NewKeyStates;
+		HID_Device_MarkReportChanged(&Keyboard_HID_Interface, 0);
+	}
+}
+
+/** Marks the given key code as pressed in the given set of key states.
+ *
+ *  \param[out] KeyStates  Pointer to the key states to update
+ *  \param[in]  KeyCode    Key code of the pressed key
+ */
+void SetKeyPressed(USB_KeyboardNKROReport_Data_t* const KeyStates, const uint8_t KeyCode)
+{
+	KeyStates->KeyBitmap[KeyCode / 8] |= (1 << (KeyCode % 8));
+}
+
 /** Event handler for the library USB Connection event. */
 void EVENT_USB_Device_Connect(void)
 {
@@ -140,30 +198,37 @@ void EVENT_USB_Device_StartOfFrame(void)
 bool CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo, uint8_t* const ReportID,
                                          const uint8_t ReportType, void* ReportData, uint16_t* ReportSize)
 {
+	#if defined(KEYBOARD_NKRO)
+	/* N-Key Rollover bitmap report when in Report protocol mode */
+	if (HIDInterfaceInfo->State.UsingReportProtocol)
+	{
+		memcpy(ReportData, &CurrentKeyStates, sizeof(USB_KeyboardNKROReport_Data_t));
+
+		*ReportSize = sizeof(USB_KeyboardNKROReport_Data_t);
+		return false;
+	}
+	#endif
+
 	USB_KeyboardReport_Data_t* KeyboardReport = (USB_KeyboardReport_Data_t*)ReportData;
-	
-	uint8_t JoyStatus_LCL    = Joystick_GetStatus();
-	uint8_t ButtonStatus_LCL = Buttons_GetStatus();
 
 	uint8_t UsedKeyCodes = 0;
 	
-	KeyboardReport->Modifier = HID_KEYBOARD_MODIFER_LEFTSHIFT;
-	
-	if (JoyStatus_LCL & JOY_UP)
-	  KeyboardReport->KeyCode[UsedKeyCodes++] = 0x04; // A
-	else if (JoyStatus_LCL & JOY_DOWN)
-	  KeyboardReport->KeyCode[UsedKeyCodes++] = 0x05; // B
+	KeyboardReport->Modifier = CurrentKeyStates.Modifier;
 
-	if (JoyStatus_LCL & JOY_LEFT)
-	  KeyboardReport->KeyCode[UsedKeyCodes++] = 0x06; // C
-	else if (JoyStatus_LCL & JOY_RIGHT)
-	  KeyboardReport->KeyCode[UsedKeyCodes++] = 0x07; // D
+	for (uint8_t KeyCode = 0; KeyCode < HID_KEYBOARD_NKRO_KEYCODES; KeyCode++)
+	{
+		if (!(CurrentKeyStates.KeyBitmap[KeyCode / 8] & (1 << (KeyCode % 8))))
+		  continue;
 
-	if (JoyStatus_LCL & JOY_PRESS)
-	  KeyboardReport->KeyCode[UsedKeyCodes++] = 0x08; // E
-	  
-	if (ButtonStatus_LCL & BUTTONS_BUTTON1)
-	  KeyboardReport->KeyCode[UsedKeyCodes++] = 0x09; // F
+		/* Indicate a rollover error in all key code slots if too many keys are pressed for a boot report */
+		if (UsedKeyCodes == sizeof(KeyboardReport->KeyCode))
+		{
+			memset(KeyboardReport->KeyCode, 0x01, sizeof(KeyboardReport->KeyCode));
+			break;
+		}
+
+		KeyboardReport->KeyCode[UsedKeyCodes++] = KeyCode;
+	}
 
 	*ReportSize = sizeof(USB_KeyboardReport_Data_t);
 	return false;
@@ -37,8 +37,13 @@
 
 #include "KeyboardMouse.h"
 
-/** Buffer to hold the previously generated Keyboard HID report, for comparison purposes inside the HID class driver. */
-uint8_t PrevKeyboardHIDReportBuffer[sizeof(USB_KeyboardReport_Data_t)];
+/** Buffer to hold the Keyboard HID report being created by the HID class driver, large enough for the largest report format. */
+uint8_t KeyboardHIDReportBuffer[KEYBOARD_REPORT_SIZE];
+
+/** Current state of each of the keyboard's keys as of the last key scan, stored in N-Key Rollover bitmap form regardless of
+ *  the report format sent to the host.
+ */
+USB_KeyboardNKROReport_Data_t CurrentKeyStates;
 
 /** Buffer to hold the previously generated Mouse HID report, for comparison purposes inside the HID class driver. */
 uint8_t PrevMouseHIDReportBuffer[sizeof(USB_MouseReport_Data_t)];
@@ -55,11 +60,13 @@ USB_ClassInfo_HID_Device_t Keyboard_HID_Interface =
 				.InterfaceNumber              = 0,
 
 				.ReportINEndpointNumber       = KEYBOARD_IN_EPNUM,
-				.ReportINEndpointSize         = HID_EPSIZE,
+				.ReportINEndpointSize         = KEYBOARD_EPSIZE,
 				.ReportINEndpointDoubleBank   = false,
 
-				.PrevReportINBuffer           = PrevKeyboardHIDReportBuffer,
-				.PrevReportINBufferSize       = sizeof(PrevKeyboardHIDReportBuffer),
+				.PrevReportINBuffer           = KeyboardHIDReportBuffer,
+				.PrevReportINBufferSize       = sizeof(KeyboardHIDReportBuffer),
+				
+				.ReportINChangesMarked        = true,
 			},
 	};
 	
@@ -93,6 +100,8 @@ int main(void)
 
 	for (;;)
 	{
+		ScanKeys();
+
 		HID_Device_USBTask(&Keyboard_HID_Interface);
 		HID_Device_USBTask(&Mouse_HID_Interface);
 		USB_USBTask();
@@ -115,6 +124,56 @@ void SetupHardware()
 	USB_Init();
 }
 
+/** Scans the board joystick and buttons for key presses, updating the current key states. As the scan is decoupled from the
+ *  creation of the HID reports, the keyboard report is only marked as changed in the HID class driver when a key changes
+ *  state, so that a new report is created and sent to the host on the next poll of the keyboard's IN endpoint once any
+ *  previously sent report has been read by the host.
+ */
+void ScanKeys(void)
+{
+	USB_KeyboardNKROReport_Data_t NewKeyStates;
+
+	uint8_t JoyStatus_LCL    = Joystick_GetStatus();
+	uint8_t ButtonStatus_LCL = Buttons_GetStatus();
+
+	memset(&NewKeyStates, 0, sizeof(NewKeyStates));
+
+	/* If first board button being held down, keys are pressed according to the joystick position */
+	if (ButtonStatus_LCL & BUTTONS_BUTTON1)
+	{
+		NewKeyStates.Modifier = HID_KEYBOARD_MODIFER_LEFTSHIFT;
+
+		if (JoyStatus_LCL & JOY_UP)
+		  SetKeyPressed(&NewKeyStates, 0x04); // A
+		else if (JoyStatus_LCL & JOY_DOWN)
+		  SetKeyPressed(&NewKeyStates, 0x05); // B
+
+		if (JoyStatus_LCL & JOY_LEFT)
+		  SetKeyPressed(&NewKeyStates, 0x06); // C
+		else if (JoyStatus_LCL & JOY_RIGHT)
+		  SetKeyPressed(&NewKeyStates, 0x07); // D
+
+		if (JoyStatus_LCL & JOY_PRESS)
+		  SetKeyPressed(&NewKeyStates, 0x08); // E
+	}
+
+	if (memcmp(&NewKeyStates, &CurrentKeyStates, sizeof(USB_KeyboardNKROReport_Data_t)) != 0)
+	{
+		CurrentKeyStates = NewKeyStates;
+		HID_Device_MarkReportChanged(&Keyboard_HID_Interface, 0);
+	}
+}
+
+/** Marks the given key code as pressed in the given set of key states.
+ *
+ *  \param[out] KeyStates  Pointer to the key states to update
+ *  \param[in]  KeyCode    Key code of the pressed key
+ */
+void SetKeyPressed(USB_KeyboardNKROReport_Data_t* const KeyStates, const uint8_t KeyCode)
+{
+	KeyStates->KeyBitmap[KeyCode / 8] |= (1 << (KeyCode % 8));
+}
+
 /** Event handler for the library USB Connection event. */
 void EVENT_USB_Device_Connect(void)
 {
@@ -168,32 +227,40 @@ void EVENT_USB_Device_StartOfFrame(void)
 bool CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo, uint8_t* const ReportID,
                                          const uint8_t ReportType, void* ReportData, uint16_t* ReportSize)
 {
-	uint8_t JoyStatus_LCL    = Joystick_GetStatus();
-	uint8_t ButtonStatus_LCL = Buttons_GetStatus();
-
 	/* Determine which interface must have its report generated */
 	if (HIDInterfaceInfo == &Keyboard_HID_Interface)
 	{
+		#if defined(KEYBOARD_NKRO)
+		/* N-Key Rollover bitmap report when in Report protocol mode */
+		if (HIDInterfaceInfo->State.UsingReportProtocol)
+		{
+			memcpy(ReportData, &CurrentKeyStates, sizeof(USB_KeyboardNKROReport_Data_t));
+
+			*ReportSize = sizeof(USB_KeyboardNKROReport_Data_t);
+			return false;
+		}
+		#endif
+
 		USB_KeyboardReport_Data_t* KeyboardReport = (USB_KeyboardReport_Data_t*)ReportData;
 		
-		/* If first board button not being held down, no keyboard report */
-		if (!(ButtonStatus_LCL & BUTTONS_BUTTON1))
-		  return 0;
-		
-		KeyboardReport->Modifier = HID_KEYBOARD_MODIFER_LEFTSHIFT;
+		uint8_t UsedKeyCodes = 0;
 
-		if (JoyStatus_LCL & JOY_UP)
-		  KeyboardReport->KeyCode[0] = 0x04; // A
-		else if (JoyStatus_LCL & JOY_DOWN)
-		  KeyboardReport->KeyCode[0] = 0x05; // B
+		KeyboardReport->Modifier = CurrentKeyStates.Modifier;
 
-		if (JoyStatus_LCL & JOY_LEFT)
-		  KeyboardReport->KeyCode[0] = 0x06; // C
-		else if (JoyStatus_LCL & JOY_RIGHT)
-		  KeyboardReport->KeyCode[0] = 0x07; // D
+		for (uint8_t KeyCode = 0; KeyCode < HID_KEYBOARD_NKRO_KEYCODES; KeyCode++)
+		{
+			if (!(CurrentKeyStates.KeyBitmap[KeyCode / 8] & (1 << (KeyCode % 8))))
+			  continue;
 
-		if (JoyStatus_LCL & JOY_PRESS)
-		  KeyboardReport->KeyCode[0] = 0x08; // E
+			/* Indicate a rollover error in all key code slots if too many keys are pressed for a boot report */
+			if (UsedKeyCodes == sizeof(KeyboardReport->KeyCode))
+			{
+				memset(KeyboardReport->KeyCode, 0x01, sizeof(KeyboardReport->KeyCode));
+				break;
+			}
+
+			KeyboardReport->KeyCode[UsedKeyCodes++] = KeyCode;
+		}
 		
 		*ReportSize = sizeof(USB_KeyboardReport_Data_t);
 		return false;
@@ -202,6 +269,9 @@ bool CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDIn
 	{
 		USB_MouseReport_Data_t* MouseReport = (USB_MouseReport_Data_t*)ReportData;
 
+		uint8_t JoyStatus_LCL    = Joystick_GetStatus();
+		uint8_t ButtonStatus_LCL = Buttons_GetStatus();
+
 		/* If first board button being held down, no mouse report */
 		if (ButtonStatus_LCL & BUTTONS_BUTTON1)
 		  return 0;
@@ -63,6 +63,8 @@
 			
 	/* Function Prototypes: */
 		void SetupHardware(void);
+		void ScanKeys(void);
+		void SetKeyPressed(USB_KeyboardNKROReport_Data_t* const KeyStates, const uint8_t KeyCode);
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
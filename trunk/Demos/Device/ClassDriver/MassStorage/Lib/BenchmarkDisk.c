@@ -0,0 +1,235 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Benchmarking storage backends for the mass storage demo, selected with the BENCHMARK_DISK_MODE compile time option.
+ *  These replace the dataflash for an additional LUN so that the time taken by the USB, SCSI and Mass Storage class
+ *  layers can be measured separately from the time taken by the physical storage medium. The number of commands and
+ *  bytes processed by each LUN is reported over the serial port once per second.
+ */
+
+#define  INCLUDE_FROM_BENCHMARKDISK_C
+#include "BenchmarkDisk.h"
+
+#if defined(BENCHMARK_DISK_MODE)
+
+#if (BENCHMARK_DISK_MODE == BENCHMARK_DISK_RAM)
+/** Storage for the RAM disk backend's blocks. */
+static uint8_t RAMDiskBlocks[BENCHMARK_RAM_DISK_BLOCKS][BLOCKDEV_BLOCK_SIZE];
+#endif
+
+/** Command and byte counters of each LUN for the current statistics reporting period. */
+static BenchmarkDisk_LUNStatistics_t LUNStatistics[TOTAL_DEVICE_LUNS];
+
+/** USB frame number at the start of the current statistics reporting period. */
+static uint16_t StatisticsStartFrame;
+
+/** Writes blocks (OS blocks, not Dataflash pages) to the benchmarking disk from the host. Depending on the selected
+ *  backend the data is either stored into the RAM disk, or read from the endpoint and discarded.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] BlockAddress  Data block starting address for the write sequence
+ *  \param[in] TotalBlocks   Number of blocks of data to write
+ */
+void BenchmarkDisk_WriteBlocks(USB_ClassInfo_MS_Device_t* MSInterfaceInfo, const uint32_t BlockAddress,
+                               uint16_t TotalBlocks)
+{
+	uint32_t CurrBlock = BlockAddress;
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return;
+
+	while (TotalBlocks)
+	{
+		/* Read the block from the host one 16-byte chunk at a time */
+		for (uint16_t BlockByte = 0; BlockByte < BLOCKDEV_BLOCK_SIZE; BlockByte += 16)
+		{
+			/* Check if the endpoint is currently empty */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the current endpoint bank */
+				Endpoint_ClearOUT();
+				
+				/* Wait until the host has sent another packet */
+				if (Endpoint_WaitUntilReady())
+				  return;
+			}
+
+			#if (BENCHMARK_DISK_MODE == BENCHMARK_DISK_RAM)
+			/* Store one 16-byte chunk of data into the RAM disk */
+			for (uint8_t ChunkByte = 0; ChunkByte < 16; ChunkByte++)
+			  RAMDiskBlocks[CurrBlock][BlockByte + ChunkByte] = Endpoint_Read_Byte();
+			#else
+			/* Discard one 16-byte chunk of data, as the backend has no storage */
+			for (uint8_t ChunkByte = 0; ChunkByte < 16; ChunkByte++)
+			  Endpoint_Discard_Byte();
+			#endif
+
+			/* Check if the current command is being aborted by the host */
+			if (MSInterfaceInfo->State.IsMassStoreReset)
+			  return;
+		}
+
+		#if (BENCHMARK_DISK_MODE == BENCHMARK_DISK_SIMFLASH)
+		/* Simulate the time taken for the storage medium to program the block */
+		_delay_us(BENCHMARK_SIMFLASH_WRITE_DELAY_US);
+		#endif
+
+		/* Move to the next block and decrement the blocks remaining counter */
+		CurrBlock++;
+		TotalBlocks--;
+	}
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+}
+
+/** Reads blocks (OS blocks, not Dataflash pages) from the benchmarking disk, and writes them to the host. Depending on
+ *  the selected backend the data is either read from the RAM disk, or generated as zeros or a block address pattern.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] BlockAddress  Data block starting address for the read sequence
+ *  \param[in] TotalBlocks   Number of blocks of data to read
+ */
+void BenchmarkDisk_ReadBlocks(USB_ClassInfo_MS_Device_t* MSInterfaceInfo, const uint32_t BlockAddress,
+                              uint16_t TotalBlocks)
+{
+	uint32_t CurrBlock = BlockAddress;
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return;
+
+	while (TotalBlocks)
+	{
+		#if (BENCHMARK_DISK_MODE == BENCHMARK_DISK_SIMFLASH)
+		/* Simulate the time taken for the storage medium to make the block's data available */
+		_delay_us(BENCHMARK_SIMFLASH_READ_DELAY_US);
+		#endif
+
+		/* Send the block to the host one 16-byte chunk at a time */
+		for (uint16_t BlockByte = 0; BlockByte < BLOCKDEV_BLOCK_SIZE; BlockByte += 16)
+		{
+			/* Check if the endpoint is currently full */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the endpoint bank to send its contents to the host */
+				Endpoint_ClearIN();
+				
+				/* Wait until the endpoint is ready for more data */
+				if (Endpoint_WaitUntilReady())
+				  return;
+			}
+
+			/* Write one 16-byte chunk of data to the endpoint */
+			for (uint8_t ChunkByte = 0; ChunkByte < 16; ChunkByte++)
+			{
+				#if (BENCHMARK_DISK_MODE == BENCHMARK_DISK_RAM)
+				Endpoint_Write_Byte(RAMDiskBlocks[CurrBlock][BlockByte + ChunkByte]);
+				#elif (BENCHMARK_DISK_MODE == BENCHMARK_DISK_NULL)
+				Endpoint_Write_Byte(0x00);
+				#else
+				Endpoint_Write_Byte(BenchmarkDisk_GetPatternByte(CurrBlock, (BlockByte + ChunkByte)));
+				#endif
+			}
+
+			/* Check if the current command is being aborted by the host */
+			if (MSInterfaceInfo->State.IsMassStoreReset)
+			  return;
+		}
+
+		/* Move to the next block and decrement the blocks remaining counter */
+		CurrBlock++;
+		TotalBlocks--;
+	}
+
+	/* If the endpoint is full, send its contents to the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+}
+
+/** Returns the byte at the given offset of a block of the pattern backends, so that the host can verify that the correct
+ *  block was returned for each read.
+ *
+ *  \param[in] BlockAddress  Address of the block being read
+ *  \param[in] BlockByte     Offset of the byte within the block
+ *
+ *  \return Pattern byte at the given location of the benchmarking disk
+ */
+static inline uint8_t BenchmarkDisk_GetPatternByte(const uint32_t BlockAddress, const uint16_t BlockByte)
+{
+	return ((uint8_t)BlockAddress ^ (uint8_t)BlockByte);
+}
+
+/** Adds a completed SCSI command to the statistics of the LUN it was issued to.
+ *
+ *  \param[in] LUNIndex  Index of the LUN the command was issued to
+ *  \param[in] BytesTransferred  Number of data bytes transferred to or from the host while processing the command
+ */
+void BenchmarkDisk_RecordCommand(const uint8_t LUNIndex, const uint32_t BytesTransferred)
+{
+	if (LUNIndex >= TOTAL_DEVICE_LUNS)
+	  return;
+
+	LUNStatistics[LUNIndex].Commands++;
+	LUNStatistics[LUNIndex].Bytes += BytesTransferred;
+}
+
+/** Task to report the commands and bytes processed per second by each LUN over the serial port, and reset the counters
+ *  for the next reporting period. This should be called repeatedly in the main program loop.
+ */
+void BenchmarkDisk_StatisticsTask(void)
+{
+	/* Frame numbers are only valid while the device is configured by the host */
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return;
+
+	uint16_t CurrentFrame = USB_Device_GetFrameNumber();
+
+	/* Check if the current reporting period has elapsed */
+	if (((CurrentFrame - StatisticsStartFrame) & FRAME_NUMBER_MASK) < BENCHMARK_STATISTICS_PERIOD_FRAMES)
+	  return;
+
+	StatisticsStartFrame = CurrentFrame;
+
+	for (uint8_t LUNIndex = 0; LUNIndex < TOTAL_DEVICE_LUNS; LUNIndex++)
+	{
+		printf_P(PSTR("LUN %d: %u cmd/s, %lu B/s\r\n"), LUNIndex,
+		         LUNStatistics[LUNIndex].Commands, LUNStatistics[LUNIndex].Bytes);
+
+		LUNStatistics[LUNIndex].Commands = 0;
+		LUNStatistics[LUNIndex].Bytes    = 0;
+	}
+}
+
+#endif
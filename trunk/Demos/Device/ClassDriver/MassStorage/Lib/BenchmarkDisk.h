@@ -0,0 +1,119 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for BenchmarkDisk.c.
+ */
+ 
+#ifndef _BENCHMARK_DISK_H_
+#define _BENCHMARK_DISK_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <util/delay.h>
+		#include <stdio.h>
+		
+		#include "MassStorage.h"
+
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/USB/USB.h>
+		#include <LUFA/Drivers/USB/Class/MassStorage.h>
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
+		#include <LUFA/Drivers/Peripheral/SerialStream.h>
+
+	/* Defines: */
+		/** Benchmarking disk backend where reads return zeros and written data is discarded. */
+		#define BENCHMARK_DISK_NULL                 0
+
+		/** Benchmarking disk backend where reads return a fixed pattern derived from the block address, and written data
+		 *  is discarded.
+		 */
+		#define BENCHMARK_DISK_PATTERN              1
+
+		/** Benchmarking disk backend where blocks are stored in a small RAM disk of \ref BENCHMARK_RAM_DISK_BLOCKS blocks. */
+		#define BENCHMARK_DISK_RAM                  2
+
+		/** Benchmarking disk backend which behaves as \ref BENCHMARK_DISK_PATTERN, but which delays each block read or write
+		 *  to simulate the access times of a flash storage medium.
+		 */
+		#define BENCHMARK_DISK_SIMFLASH             3
+
+		#if !defined(BENCHMARK_RAM_DISK_BLOCKS) || defined(__DOXYGEN__)
+			/** Number of blocks in the RAM disk when the \ref BENCHMARK_DISK_RAM backend is selected. Each block consumes
+			 *  BLOCKDEV_BLOCK_SIZE bytes of SRAM.
+			 */
+			#define BENCHMARK_RAM_DISK_BLOCKS       4
+		#endif
+
+		#if !defined(BENCHMARK_SIMFLASH_READ_DELAY_US) || defined(__DOXYGEN__)
+			/** Delay in microseconds before each block read when the \ref BENCHMARK_DISK_SIMFLASH backend is selected. */
+			#define BENCHMARK_SIMFLASH_READ_DELAY_US    100
+		#endif
+
+		#if !defined(BENCHMARK_SIMFLASH_WRITE_DELAY_US) || defined(__DOXYGEN__)
+			/** Delay in microseconds after each block write when the \ref BENCHMARK_DISK_SIMFLASH backend is selected. */
+			#define BENCHMARK_SIMFLASH_WRITE_DELAY_US   2500
+		#endif
+
+		#if (BENCHMARK_DISK_MODE == BENCHMARK_DISK_RAM) || defined(__DOXYGEN__)
+			/** Total number of blocks in the benchmarking LUN, reported to the host as the LUN's capacity. */
+			#define BENCHMARK_DISK_BLOCKS           BENCHMARK_RAM_DISK_BLOCKS
+		#else
+			#define BENCHMARK_DISK_BLOCKS           65536UL
+		#endif
+
+		/** Number of USB frames between each statistics report. As each frame is one millisecond long, the reported counts are
+		 *  per second.
+		 */
+		#define BENCHMARK_STATISTICS_PERIOD_FRAMES  1000
+
+	/* Type Defines: */
+		/** Type define for the command and byte counters of a single LUN over one statistics reporting period. */
+		typedef struct
+		{
+			uint16_t Commands; /**< Number of SCSI commands processed by the LUN */
+			uint32_t Bytes; /**< Number of data bytes transferred to or from the host by the LUN */
+		} BenchmarkDisk_LUNStatistics_t;
+
+	/* Function Prototypes: */
+		void BenchmarkDisk_WriteBlocks(USB_ClassInfo_MS_Device_t* MSInterfaceInfo, const uint32_t BlockAddress,
+		                               uint16_t TotalBlocks);
+		void BenchmarkDisk_ReadBlocks(USB_ClassInfo_MS_Device_t* MSInterfaceInfo, const uint32_t BlockAddress,
+		                              uint16_t TotalBlocks);
+		void BenchmarkDisk_RecordCommand(const uint8_t LUNIndex, const uint32_t BytesTransferred);
+		void BenchmarkDisk_StatisticsTask(void);
+
+		#if defined(INCLUDE_FROM_BENCHMARKDISK_C) && defined(BENCHMARK_DISK_MODE)
+			static inline uint8_t BenchmarkDisk_GetPatternByte(const uint32_t BlockAddress, const uint16_t BlockByte);
+		#endif
+
+#endif
@@ -114,8 +114,23 @@ bool SCSI_DecodeSCSICommand(USB_ClassInfo_MS_Device_t* MSInterfaceInfo)
 		case SCSI_CMD_READ_10:
 			SCSI_Command_ReadWrite_10(MSInterfaceInfo, DATA_READ);
 			break;
-		case SCSI_CMD_TEST_UNIT_READY:
+		case SCSI_CMD_MODE_SENSE_6:
+			SCSI_Command_Mode_Sense_6(MSInterfaceInfo);
+			break;
 		case SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL:
+			SCSI_Command_Prevent_Allow_Medium_Removal(MSInterfaceInfo);
+			break;
+		case SCSI_CMD_SYNCHRONIZE_CACHE_10:
+			/* Write back all cached data to the storage medium before the command completes */
+			BlockDevice_Flush();
+			MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+			break;
+		case SCSI_CMD_TEST_UNIT_READY:
+			/* Removable media must be present and initialized before the unit can be used */
+			SCSI_CheckMediumPresent(MSInterfaceInfo, true);
+
+			MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+			break;
 		case SCSI_CMD_VERIFY_10:
 			/* These commands should just succeed, no handling required */
 			MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
@@ -196,8 +211,19 @@ static void SCSI_Command_Request_Sense(USB_ClassInfo_MS_Device_t* MSInterfaceInf
  */
 static void SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo)
 {
-	uint32_t LastBlockAddressInLUN = (LUN_MEDIA_BLOCKS - 1);
-	uint32_t MediaBlockSize        = VIRTUAL_MEMORY_BLOCK_SIZE;
+	uint32_t LastBlockAddressInLUN;
+	uint32_t MediaBlockSize        = BLOCKDEV_BLOCK_SIZE;
+
+	/* The capacity of removable media is unknown while no medium is present */
+	if (!(SCSI_CheckMediumPresent(MSInterfaceInfo, false)))
+	  return;
+
+	LastBlockAddressInLUN = (LUN_MEDIA_BLOCKS - 1);
+
+	#if defined(BENCHMARK_DISK_MODE)
+	if (MSInterfaceInfo->State.CommandBlock.LUN == BENCHMARK_LUN)
+	  LastBlockAddressInLUN = (BENCHMARK_DISK_BLOCKS - 1);
+	#endif
 
 	Endpoint_Write_Stream_BE(&LastBlockAddressInLUN, sizeof(LastBlockAddressInLUN), NO_STREAM_CALLBACK);
 	Endpoint_Write_Stream_BE(&MediaBlockSize, sizeof(MediaBlockSize), NO_STREAM_CALLBACK);
@@ -207,8 +233,8 @@ static void SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* MSInterface
 	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= 8;
 }
 
-/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the Dataflash ICs on the
- *  board, and indicates if they are present and functioning correctly. Only the Self-Test portion of the diagnostic command is
+/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the storage medium,
+ *  and indicates if it is present and functioning correctly. Only the Self-Test portion of the diagnostic command is
  *  supported.
  *
  *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
@@ -226,8 +252,8 @@ static void SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* MSInterfaceI
 		return;
 	}
 	
-	/* Check to see if all attached Dataflash ICs are functional */
-	if (!(DataflashManager_CheckDataflashOperation()))
+	/* Check to see if the storage medium is functional */
+	if (!(BlockDevice_CheckOperation()))
 	{
 		/* Update SENSE key with a hardware error condition and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
@@ -242,7 +268,7 @@ static void SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* MSInterfaceI
 }
 
 /** Command processing for an issued SCSI READ (10) or WRITE (10) command. This command reads in the block start address
- *  and total number of blocks to process, then calls the appropriate low-level dataflash routine to handle the actual
+ *  and total number of blocks to process, then calls the appropriate block device routine to handle the actual
  *  reading and writing of the data.
  *
  *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
@@ -252,15 +278,46 @@ static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo
 {
 	uint32_t BlockAddress;
 	uint16_t TotalBlocks;
+	uint8_t  ErrorCode;
 	
 	/* Load in the 32-bit block address (SCSI uses big-endian, so have to reverse the byte order) */
 	BlockAddress = SwapEndian_32(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[2]);
 
 	/* Load in the 16-bit total blocks (SCSI uses big-endian, so have to reverse the byte order) */
 	TotalBlocks  = SwapEndian_16(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[7]);
+
+	/* Removable media must be present, as every block address lies outside a medium which is not present */
+	if (!(SCSI_CheckMediumPresent(MSInterfaceInfo, false)))
+	  return;
 	
-	/* Check if the block address is outside the maximum allowable value for the LUN */
-	if (BlockAddress >= LUN_MEDIA_BLOCKS)
+	#if defined(BENCHMARK_DISK_MODE)
+	/* Commands to the benchmarking LUN are handled by the benchmarking disk instead of the dataflash */
+	if (MSInterfaceInfo->State.CommandBlock.LUN == BENCHMARK_LUN)
+	{
+		/* Check if any of the requested blocks lie outside the benchmarking disk, as the RAM disk must not be overrun */
+		if ((BlockAddress + TotalBlocks) > BENCHMARK_DISK_BLOCKS)
+		{
+			/* Block address is invalid, update SENSE key and return command fail */
+			SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+			               SCSI_ASENSE_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE,
+			               SCSI_ASENSEQ_NO_QUALIFIER);
+
+			return;
+		}
+
+		if (IsDataRead == DATA_READ)
+		  BenchmarkDisk_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+		else
+		  BenchmarkDisk_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+
+		/* Update the bytes transferred counter and succeed the command */
+		MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
+		return;
+	}
+	#endif
+
+	/* Check if any of the requested blocks lie outside the LUN */
+	if ((BlockAddress + TotalBlocks) > LUN_MEDIA_BLOCKS)
 	{
 		/* Block address is invalid, update SENSE key and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
@@ -277,10 +334,118 @@ static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo
 	
 	/* Determine if the packet is a READ (10) or WRITE (10) command, call appropriate function */
 	if (IsDataRead == DATA_READ)
-	  DataflashManager_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	  ErrorCode = BlockDevice_ReadBlocks_Endpoint(BlockAddress, TotalBlocks, &MSInterfaceInfo->State.IsMassStoreReset);
 	else
-	  DataflashManager_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	  ErrorCode = BlockDevice_WriteBlocks_Endpoint(BlockAddress, TotalBlocks, &MSInterfaceInfo->State.IsMassStoreReset);
+
+	if (ErrorCode == BLOCKDEV_ERROR_NotReady)
+	{
+		/* Removable medium is not present, update SENSE key and return command fail */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_NOT_READY,
+		               SCSI_ASENSE_MEDIUM_NOT_PRESENT,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return;
+	}
+	else if (ErrorCode != BLOCKDEV_ERROR_NoError)
+	{
+		/* Transfer could not be completed, update SENSE key and return command fail */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
+		               SCSI_ASENSE_NO_ADDITIONAL_INFORMATION,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return;
+	}
 
 	/* Update the bytes transferred counter and succeed the command */
-	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
+}
+
+/** Command processing for an issued SCSI MODE SENSE (6) command. This command returns the device's caching mode page to the
+ *  host, indicating that the device's write cache is enabled so that the host will issue SYNCHRONIZE CACHE commands when
+ *  written data must reach the storage medium.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
+ */
+static void SCSI_Command_Mode_Sense_6(USB_ClassInfo_MS_Device_t* MSInterfaceInfo)
+{
+	uint8_t PageControl      = (MSInterfaceInfo->State.CommandBlock.SCSICommandData[2] >> 6);
+	uint8_t PageCode         = (MSInterfaceInfo->State.CommandBlock.SCSICommandData[2] & 0x3F);
+	uint8_t AllocationLength = MSInterfaceInfo->State.CommandBlock.SCSICommandData[4];
+
+	/* Only the caching mode page is supported, either on its own or as part of a request for all mode pages */
+	if ((PageCode != MODE_PAGE_CACHING) && (PageCode != MODE_PAGE_ALL))
+	{
+		/* Unsupported mode page requested - update the SENSE key and fail the request */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		               SCSI_ASENSE_INVALID_FIELD_IN_CDB,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return;
+	}
+
+	SCSI_Mode_Sense_Caching_Response_t ModeData;
+	uint8_t BytesTransferred = (AllocationLength < sizeof(ModeData)) ? AllocationLength : sizeof(ModeData);
+
+	memset(&ModeData, 0x00, sizeof(ModeData));
+	ModeData.ModeDataLength = (sizeof(ModeData) - 1);
+	ModeData.PageCode       = MODE_PAGE_CACHING;
+	ModeData.PageLength     = (sizeof(ModeData) - offsetof(SCSI_Mode_Sense_Caching_Response_t, CachingFlags));
+
+	/* The write cache is enabled if the storage medium has one, and cannot be changed by the host */
+	if ((PageControl != MODE_PAGE_CONTROL_CHANGEABLE) && (BlockDevice_GetCapabilities() & BLOCKDEV_CAP_WRITE_CACHE))
+	  ModeData.CachingFlags = MODE_CACHING_WCE;
+
+	Endpoint_Write_Stream_LE(&ModeData, BytesTransferred, NO_STREAM_CALLBACK);
+	Endpoint_ClearIN();
+
+	/* Succeed the command and update the bytes transferred counter */
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= BytesTransferred;
+}
+
+/** Command processing for an issued SCSI PREVENT ALLOW MEDIUM REMOVAL command. When the host allows the medium to be removed
+ *  it may be ejected at any time, so all cached data is written back to the storage medium.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
+ */
+static void SCSI_Command_Prevent_Allow_Medium_Removal(USB_ClassInfo_MS_Device_t* MSInterfaceInfo)
+{
+	if (!(MSInterfaceInfo->State.CommandBlock.SCSICommandData[4] & PREVENT_REMOVAL_MASK))
+	  BlockDevice_Flush();
+
+	/* Succeed the command, no data is transferred */
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+}
+
+/** Checks that the storage medium is present if it is removable, failing the current command with a NOT READY sense
+ *  key if it is not. A removable medium which is not initialized is first initialized, in case it has been inserted since
+ *  it was last checked.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
+ *  \param[in] CheckRemoval     Boolean true to also check that an initialized medium has not been removed, false if its
+ *                              removal is instead detected when the medium is next accessed
+ *
+ *  \return Boolean true if the medium is present, false otherwise
+ */
+static bool SCSI_CheckMediumPresent(USB_ClassInfo_MS_Device_t* MSInterfaceInfo, const bool CheckRemoval)
+{
+	#if defined(BENCHMARK_DISK_MODE)
+	/* The benchmarking disk is always present */
+	if (MSInterfaceInfo->State.CommandBlock.LUN == BENCHMARK_LUN)
+	  return true;
+	#endif
+
+	if (!(BlockDevice_GetCapabilities() & BLOCKDEV_CAP_REMOVABLE))
+	  return true;
+
+	/* An initialized medium has a non-zero capacity, and is checked only when requested as the check may be slow */
+	if ((!(CheckRemoval) && BlockDevice_GetTotalBlocks()) || BlockDevice_CheckOperation())
+	  return true;
+
+	/* Removable medium is not present, update SENSE key and return command fail */
+	SCSI_SET_SENSE(SCSI_SENSE_KEY_NOT_READY,
+	               SCSI_ASENSE_MEDIUM_NOT_PRESENT,
+	               SCSI_ASENSEQ_NO_QUALIFIER);
+
+	return false;
 }
@@ -39,13 +39,17 @@
 	/* Includes: */
 		#include <avr/io.h>
 		#include <avr/pgmspace.h>
+		#include <string.h>
+		#include <stddef.h>
 
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
 
 		#include "MassStorage.h"
 		#include "Descriptors.h"
-		#include "DataflashManager.h"
+		#include "BenchmarkDisk.h"
+
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
 	
 	/* Macros: */
 		/** Macro to set the current SCSI sense data to the given key, additional sense code and additional sense qualifier. This
@@ -71,6 +75,38 @@
 		
 		/** Value for the DeviceType entry in the SCSI_Inquiry_Response_t enum, indicating a CD-ROM device. */
 		#define DEVICE_TYPE_CDROM   0x05
+
+		/** Page code of the caching mode page, returned to the host in response to a SCSI MODE SENSE command. */
+		#define MODE_PAGE_CACHING             0x08
+
+		/** Page code requesting that all supported mode pages be returned to the host in response to a SCSI MODE SENSE command. */
+		#define MODE_PAGE_ALL                 0x3F
+		
+		/** Page control value of a SCSI MODE SENSE command, requesting the mask of the mode page parameters which may be changed. */
+		#define MODE_PAGE_CONTROL_CHANGEABLE  0x01
+
+		/** Mask for the Write Cache Enable bit of the caching mode page, indicating that written data may be cached by the device. */
+		#define MODE_CACHING_WCE              (1 << 2)
+		
+		/** Mask for the prevent bits of a SCSI PREVENT ALLOW MEDIUM REMOVAL command, set if medium removal is to be prevented. */
+		#define PREVENT_REMOVAL_MASK          0x03
+	
+	/* Type Defines: */
+		/** Type define for the response data to a SCSI MODE SENSE (6) command, consisting of the mode parameter header
+		 *  followed by the caching mode page. See the SCSI Block Commands specification for details on each field.
+		 */
+		typedef struct
+		{
+			uint8_t ModeDataLength; /**< Length of the mode data following this field, in bytes */
+			uint8_t MediumType; /**< Medium type of the device, always zero for block devices */
+			uint8_t DeviceSpecificParameter; /**< Device specific parameters, including the write protect flag */
+			uint8_t BlockDescriptorLength; /**< Length of the block descriptors following the header, always zero */
+
+			uint8_t PageCode; /**< Page code of the caching mode page, \ref MODE_PAGE_CACHING */
+			uint8_t PageLength; /**< Length of the caching mode page parameters following this field, in bytes */
+			uint8_t CachingFlags; /**< Caching flags of the device, a mask of MODE_CACHING_* masks */
+			uint8_t Reserved[17]; /**< Remaining caching mode page parameters, unused by the device */
+		} SCSI_Mode_Sense_Caching_Response_t;
 		
 	/* Function Prototypes: */
 		bool SCSI_DecodeSCSICommand(USB_ClassInfo_MS_Device_t* MSInterfaceInfo);
@@ -81,6 +117,9 @@
 			static void SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo);
 			static void SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* MSInterfaceInfo);
 			static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo, const bool IsDataRead);
+			static void SCSI_Command_Mode_Sense_6(USB_ClassInfo_MS_Device_t* MSInterfaceInfo);
+			static void SCSI_Command_Prevent_Allow_Medium_Removal(USB_ClassInfo_MS_Device_t* MSInterfaceInfo);
+			static bool SCSI_CheckMediumPresent(USB_ClassInfo_MS_Device_t* MSInterfaceInfo, const bool CheckRemoval);
 		#endif
 		
 #endif
@@ -48,16 +48,25 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 
 				.DataINEndpointNumber      = MASS_STORAGE_IN_EPNUM,
 				.DataINEndpointSize        = MASS_STORAGE_IO_EPSIZE,
-				.DataINEndpointDoubleBank  = false,
+				.DataINEndpointDoubleBank  = true,
 
 				.DataOUTEndpointNumber     = MASS_STORAGE_OUT_EPNUM,
 				.DataOUTEndpointSize       = MASS_STORAGE_IO_EPSIZE,
-				.DataOUTEndpointDoubleBank = false,
+				.DataOUTEndpointDoubleBank = true,
 
-				.TotalLUNs                 = TOTAL_LUNS,
+				.TotalLUNs                 = TOTAL_DEVICE_LUNS,
 			},
 	};
 
+/** Indicates if the storage medium's write-back cache may hold data that has not been flushed since the last SCSI command. */
+bool CacheFlushPending = false;
+
+/** USB frame number of the last SCSI command received from the host, for the write-back cache flush timeout. */
+uint16_t LastCommandFrame;
+
+/** Indicates if the storage medium was still completing a write in the background when the last SCSI command completed. */
+bool MediumBusy = false;
+
 /** Main program entry point. This routine contains the overall program flow, including initial
  *  setup of all components and the main program loop.
  */
@@ -70,6 +79,11 @@ int main(void)
 	for (;;)
 	{
 		MS_Device_USBTask(&Disk_MS_Interface);
+		CacheFlushTask();
+		MediumBusyTask();
+		#if defined(BENCHMARK_DISK_MODE)
+		BenchmarkDisk_StatisticsTask();
+		#endif
 		USB_USBTask();
 	}
 }
@@ -89,9 +103,48 @@ void SetupHardware(void)
 	SPI_Init(SPI_SPEED_FCPU_DIV_2 | SPI_SCK_LEAD_FALLING | SPI_SAMPLE_TRAILING | SPI_MODE_MASTER);
 	Dataflash_Init();
 	USB_Init();
+	#if defined(BENCHMARK_DISK_MODE)
+	SerialStream_Init(115200, true);
+	#endif
+
+	/* Prepare the storage medium for use, clearing Dataflash sector protections if enabled */
+	BlockDevice_Init();
+}
+
+/** Flushes the storage medium's write-back cache once no SCSI command has been received from the host for
+ *  \ref CACHE_FLUSH_TIMEOUT_MS, or immediately if the device is no longer configured by the host. This ensures
+ *  that written data reaches the medium even if the host does not issue a SYNCHRONIZE CACHE command. While the
+ *  device is configured the flush is also deferred until the medium has finished any write still running in the
+ *  background, so that the main loop does not stall waiting for it.
+ */
+void CacheFlushTask(void)
+{
+	if (!(CacheFlushPending))
+	  return;
+
+	if ((USB_DeviceState == DEVICE_STATE_Configured) &&
+	    ((((USB_Device_GetFrameNumber() - LastCommandFrame) & FRAME_NUMBER_MASK) < CACHE_FLUSH_TIMEOUT_MS) ||
+	     BlockDevice_IsBusy()))
+	{
+		return;
+	}
+	
+	BlockDevice_Flush();
+	CacheFlushPending = false;
+}
+
+/** Keeps the busy LED lit after a SCSI command has completed until the storage medium has finished any write it is still
+ *  completing in the background, so that the LEDs show when it is safe to remove power from the device.
+ */
+void MediumBusyTask(void)
+{
+	if (!(MediumBusy) || BlockDevice_IsBusy())
+	  return;
+
+	MediumBusy = false;
 
-	/* Clear Dataflash sector protections, if enabled */
-	DataflashManager_ResetDataflashProtections();
+	if (USB_DeviceState == DEVICE_STATE_Configured)
+	  LEDs_SetAllLEDs(LEDMASK_USB_READY);
 }
 
 /** Event handler for the library USB Connection event. */
@@ -129,9 +182,31 @@ bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* MSInterfa
 {
 	bool CommandSuccess;
 	
+	#if defined(BENCHMARK_DISK_MODE)
+	uint32_t DataTransferLength = MSInterfaceInfo->State.CommandBlock.DataTransferLength;
+	#endif
+
 	LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
 	CommandSuccess = SCSI_DecodeSCSICommand(MSInterfaceInfo);
-	LEDs_SetAllLEDs(LEDMASK_USB_READY);
+
+	/* Leave the busy LED lit if a written block is still being stored by the medium, until MediumBusyTask() clears it */
+	if (BlockDevice_IsBusy())
+	  MediumBusy = true;
+	else
+	  LEDs_SetAllLEDs(LEDMASK_USB_READY);
 	
+	/* Restart the write-back cache flush timeout, if the storage medium has a write-back cache */
+	if (BlockDevice_GetCapabilities() & BLOCKDEV_CAP_WRITE_CACHE)
+	{
+		CacheFlushPending = true;
+		LastCommandFrame  = USB_Device_GetFrameNumber();
+	}
+
+	#if defined(BENCHMARK_DISK_MODE)
+	/* Count the command and the data actually transferred against the LUN it was issued to */
+	BenchmarkDisk_RecordCommand(MSInterfaceInfo->State.CommandBlock.LUN,
+	                            (DataTransferLength - MSInterfaceInfo->State.CommandBlock.DataTransferLength));
+	#endif
+
 	return CommandSuccess;
 }
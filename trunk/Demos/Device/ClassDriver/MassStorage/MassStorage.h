@@ -44,10 +44,12 @@
 		#include "Descriptors.h"
 
 		#include "Lib/SCSI.h"
-		#include "Lib/DataflashManager.h"
+		#include "Lib/BenchmarkDisk.h"
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
+		#include <LUFA/Drivers/Board/Dataflash.h>
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
 
@@ -71,10 +73,30 @@
 		#define TOTAL_LUNS                1
 		
 		/** Blocks in each LUN, calculated from the total capacity divided by the total number of Logical Units in the device. */
-		#define LUN_MEDIA_BLOCKS         (VIRTUAL_MEMORY_BLOCKS / TOTAL_LUNS)
+		#define LUN_MEDIA_BLOCKS         (BlockDevice_GetTotalBlocks() / TOTAL_LUNS)
+
+		/** Time in milliseconds after the last SCSI command from the host before any data held in the storage medium's
+		 *  write-back cache is written back to the medium, if the host has not already flushed it.
+		 */
+		#define CACHE_FLUSH_TIMEOUT_MS    500
+
+		/** Mask for the 11-bit USB frame number, used to handle frame number wrap-around. */
+		#define FRAME_NUMBER_MASK         0x07FF
+
+		#if defined(BENCHMARK_DISK_MODE) || defined(__DOXYGEN__)
+			/** Index of the benchmarking LUN, which follows the dataflash LUNs when a benchmarking disk backend is selected. */
+			#define BENCHMARK_LUN             TOTAL_LUNS
+
+			/** Total number of logical drives reported to the host, including the benchmarking LUN if present. */
+			#define TOTAL_DEVICE_LUNS        (TOTAL_LUNS + 1)
+		#else
+			#define TOTAL_DEVICE_LUNS         TOTAL_LUNS
+		#endif
 		
 	/* Function Prototypes: */
 		void SetupHardware(void);
+		void CacheFlushTask(void);
+		void MediumBusyTask(void);
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
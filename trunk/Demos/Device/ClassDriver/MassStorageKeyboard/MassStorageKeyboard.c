@@ -49,11 +49,11 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 
 				.DataINEndpointNumber      = MASS_STORAGE_IN_EPNUM,
 				.DataINEndpointSize        = MASS_STORAGE_IO_EPSIZE,
-				.DataINEndpointDoubleBank  = false,
+				.DataINEndpointDoubleBank  = true,
 
 				.DataOUTEndpointNumber     = MASS_STORAGE_OUT_EPNUM,
 				.DataOUTEndpointSize       = MASS_STORAGE_IO_EPSIZE,
-				.DataOUTEndpointDoubleBank = false,
+				.DataOUTEndpointDoubleBank = true,
 
 				.TotalLUNs                 = TOTAL_LUNS,
 			},
@@ -116,8 +116,8 @@ void SetupHardware(void)
 	Dataflash_Init();
 	USB_Init();
 
-	/* Clear Dataflash sector protections, if enabled */
-	DataflashManager_ResetDataflashProtections();
+	/* Prepare the storage medium for use, clearing Dataflash sector protections if enabled */
+	BlockDevice_Init();
 }
 
 /** Event handler for the library USB Connection event. */
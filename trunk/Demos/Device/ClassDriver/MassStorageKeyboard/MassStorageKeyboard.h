@@ -48,12 +48,13 @@
 		#include "Descriptors.h"
 
 		#include "Lib/SCSI.h"
-		#include "Lib/DataflashManager.h"
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/Board/Joystick.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Board/Buttons.h>
+		#include <LUFA/Drivers/Board/Dataflash.h>
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
 		#include <LUFA/Drivers/USB/Class/Device/HID.h>
@@ -78,7 +79,7 @@
 		#define TOTAL_LUNS               1
 		
 		/** Blocks in each LUN, calculated from the total capacity divided by the total number of Logical Units in the device. */
-		#define LUN_MEDIA_BLOCKS         (VIRTUAL_MEMORY_BLOCKS / TOTAL_LUNS)
+		#define LUN_MEDIA_BLOCKS         (BlockDevice_GetTotalBlocks() / TOTAL_LUNS)
 		
 	/* Function Prototypes: */
 		void SetupHardware(void);
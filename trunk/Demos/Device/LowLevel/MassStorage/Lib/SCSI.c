@@ -200,7 +200,7 @@ static void SCSI_Command_Read_Capacity_10(void)
 	Endpoint_Write_DWord_BE(LUN_MEDIA_BLOCKS - 1);
 
 	/* Send the logical block size of the device (must be 512 bytes) */
-	Endpoint_Write_DWord_BE(VIRTUAL_MEMORY_BLOCK_SIZE);
+	Endpoint_Write_DWord_BE(BLOCKDEV_BLOCK_SIZE);
 
 	/* Check if the current command is being aborted by the host */
 	if (IsMassStoreReset)
@@ -213,8 +213,8 @@ static void SCSI_Command_Read_Capacity_10(void)
 	CommandBlock.DataTransferLength -= 8;
 }
 
-/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the Dataflash ICs on the
- *  board, and indicates if they are present and functioning correctly. Only the Self-Test portion of the diagnostic command is
+/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the storage medium,
+ *  and indicates if it is present and functioning correctly. Only the Self-Test portion of the diagnostic command is
  *  supported.
  */
 static void SCSI_Command_Send_Diagnostic(void)
@@ -230,8 +230,8 @@ static void SCSI_Command_Send_Diagnostic(void)
 		return;
 	}
 	
-	/* Check to see if all attached Dataflash ICs are functional */
-	if (!(DataflashManager_CheckDataflashOperation()))
+	/* Check to see if the storage medium is functional */
+	if (!(BlockDevice_CheckOperation()))
 	{
 		/* Update SENSE key with a hardware error condition and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
@@ -246,7 +246,7 @@ static void SCSI_Command_Send_Diagnostic(void)
 }
 
 /** Command processing for an issued SCSI READ (10) or WRITE (10) command. This command reads in the block start address
- *  and total number of blocks to process, then calls the appropriate low-level dataflash routine to handle the actual
+ *  and total number of blocks to process, then calls the appropriate block device routine to handle the actual
  *  reading and writing of the data.
  *
  *  \param[in] IsDataRead  Indicates if the command is a READ (10) command or WRITE (10) command (DATA_READ or DATA_WRITE)
@@ -255,6 +255,7 @@ static void SCSI_Command_ReadWrite_10(const bool IsDataRead)
 {
 	uint32_t BlockAddress;
 	uint16_t TotalBlocks;
+	uint8_t  ErrorCode;
 	
 	/* Load in the 32-bit block address (SCSI uses big-endian, so have to do it byte-by-byte) */
 	((uint8_t*)&BlockAddress)[3] = CommandBlock.SCSICommandData[2];
@@ -266,8 +267,8 @@ static void SCSI_Command_ReadWrite_10(const bool IsDataRead)
 	((uint8_t*)&TotalBlocks)[1]  = CommandBlock.SCSICommandData[7];
 	((uint8_t*)&TotalBlocks)[0]  = CommandBlock.SCSICommandData[8];
 	
-	/* Check if the block address is outside the maximum allowable value for the LUN */
-	if (BlockAddress >= LUN_MEDIA_BLOCKS)
+	/* Check if any of the requested blocks lie outside the LUN */
+	if ((BlockAddress + TotalBlocks) > LUN_MEDIA_BLOCKS)
 	{
 		/* Block address is invalid, update SENSE key and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
@@ -284,10 +285,20 @@ static void SCSI_Command_ReadWrite_10(const bool IsDataRead)
 	
 	/* Determine if the packet is a READ (10) or WRITE (10) command, call appropriate function */
 	if (IsDataRead == DATA_READ)
-	  DataflashManager_ReadBlocks(BlockAddress, TotalBlocks);
+	  ErrorCode = BlockDevice_ReadBlocks_Endpoint(BlockAddress, TotalBlocks, &IsMassStoreReset);
 	else
-	  DataflashManager_WriteBlocks(BlockAddress, TotalBlocks);
+	  ErrorCode = BlockDevice_WriteBlocks_Endpoint(BlockAddress, TotalBlocks, &IsMassStoreReset);
+
+	if (ErrorCode != BLOCKDEV_ERROR_NoError)
+	{
+		/* Transfer could not be completed, update SENSE key and return command fail */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
+		               SCSI_ASENSE_NO_ADDITIONAL_INFORMATION,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return;
+	}
 
 	/* Update the bytes transferred counter and succeed the command */
-	CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
+	CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
 }
@@ -46,8 +46,9 @@
 
 		#include "MassStorage.h"
 		#include "Descriptors.h"
-		#include "DataflashManager.h"
 		#include "SCSI_Codes.h"
+
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
 	
 	/* Macros: */
 		/** Macro to set the current SCSI sense data to the given key, additional sense code and additional sense qualifier. This
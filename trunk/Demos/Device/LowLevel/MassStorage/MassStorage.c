@@ -79,8 +79,8 @@ void SetupHardware(void)
 	Dataflash_Init();
 	USB_Init();
 
-	/* Clear Dataflash sector protections, if enabled */
-	DataflashManager_ResetDataflashProtections();
+	/* Prepare the storage medium for use, clearing Dataflash sector protections if enabled */
+	BlockDevice_Init();
 }
 
 /** Event handler for the USB_Connect event. This indicates that the device is enumerating via the status LEDs. */
@@ -113,14 +113,14 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 	/* Setup Mass Storage In and Out Endpoints */
 	if (!(Endpoint_ConfigureEndpoint(MASS_STORAGE_IN_EPNUM, EP_TYPE_BULK,
 		                             ENDPOINT_DIR_IN, MASS_STORAGE_IO_EPSIZE,
-	                                 ENDPOINT_BANK_SINGLE)))
+	                                 ENDPOINT_BANK_DOUBLE)))
 	{
 		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 	}
 	
 	if (!(Endpoint_ConfigureEndpoint(MASS_STORAGE_OUT_EPNUM, EP_TYPE_BULK,
 		                             ENDPOINT_DIR_OUT, MASS_STORAGE_IO_EPSIZE,
-	                                 ENDPOINT_BANK_SINGLE)))
+	                                 ENDPOINT_BANK_DOUBLE)))
 	{
 		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 	}							   
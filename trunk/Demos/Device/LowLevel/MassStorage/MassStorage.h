@@ -44,12 +44,12 @@
 		#include "Descriptors.h"
 
 		#include "Lib/SCSI.h"
-		#include "Lib/DataflashManager.h"
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Board/Dataflash.h>
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
 
 	/* Macros: */
 		/** Mass Storage Class specific request to reset the Mass Storage interface, ready for the next command. */
@@ -67,7 +67,7 @@
 		#define TOTAL_LUNS                 1
 		
 		/** Blocks in each LUN, calculated from the total capacity divided by the total number of Logical Units in the device. */
-		#define LUN_MEDIA_BLOCKS           (VIRTUAL_MEMORY_BLOCKS / TOTAL_LUNS)    
+		#define LUN_MEDIA_BLOCKS           (BlockDevice_GetTotalBlocks() / TOTAL_LUNS)    
 		
 		/** Magic signature for a Command Block Wrapper used in the Mass Storage Bulk-Only transport protocol. */
 		#define CBW_SIGNATURE              0x43425355UL
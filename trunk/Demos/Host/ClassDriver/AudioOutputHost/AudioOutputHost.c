@@ -0,0 +1,258 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Main source file for the AudioOutputHost demo. This file contains the main tasks of
+ *  the demo and is responsible for the initial application hardware configuration.
+ */
+ 
+#include "AudioOutputHost.h"
+
+/** LUFA Audio Class driver interface configuration and state information. This structure is
+ *  passed to all Audio Class driver functions, so that multiple instances of the same class
+ *  within a device can be differentiated from one another.
+ */
+USB_ClassInfo_Audio_Host_t Speaker_Audio_Interface =
+	{
+		.Config =
+			{
+				.DataOUTPipeNumber      = 1,
+				.FeedbackPipeNumber     = 2,
+
+				.DataOUTFormat          =
+					{
+						.Channels        = 2,
+						.SubFrameSize    = 2,
+						.BitResolution   = 16,
+						.SampleFrequency = TONE_SAMPLE_FREQUENCY,
+					},
+			},
+	};
+
+	
+/** Main program entry point. This routine configures the hardware required by the application, then
+ *  enters a loop to run the application tasks in sequence.
+ */
+int main(void)
+{
+	SetupHardware();
+
+	puts_P(PSTR(ESC_FG_CYAN "Audio Output Host Demo running.\r\n" ESC_FG_WHITE));
+
+	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+
+	for (;;)
+	{
+		switch (USB_HostState)
+		{
+			case HOST_STATE_Addressed:
+				LEDs_SetAllLEDs(LEDMASK_USB_ENUMERATING);
+			
+				uint16_t ConfigDescriptorSize;
+				uint8_t  ConfigDescriptorData[512];
+
+				if (USB_Host_GetDeviceConfigDescriptor(1, &ConfigDescriptorSize, ConfigDescriptorData,
+				                                       sizeof(ConfigDescriptorData)) != HOST_GETCONFIG_Successful)
+				{
+					printf("Error Retrieving Configuration Descriptor.\r\n");
+					LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+					break;
+				}
+
+				if (Audio_Host_ConfigurePipes(&Speaker_Audio_Interface,
+				                              ConfigDescriptorSize, ConfigDescriptorData) != AUDIO_ENUMERROR_NoError)
+				{
+					printf("Attached Device Not a Valid Audio Output Device.\r\n");
+					LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+					break;
+				}
+				
+				if (USB_Host_SetDeviceConfiguration(1) != HOST_SENDCONTROL_Successful)
+				{
+					printf("Error Setting Device Configuration.\r\n");
+					LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+					break;
+				}
+
+				if (Audio_Host_StartStopStreaming(&Speaker_Audio_Interface, true) != HOST_SENDCONTROL_Successful)
+				{
+					printf("Error Starting Audio Stream.\r\n");
+					LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+					break;
+				}
+				
+				printf("Audio Device Enumerated.\r\n");
+				LEDs_SetAllLEDs(LEDMASK_USB_READY);
+				USB_HostState = HOST_STATE_Configured;
+				break;
+			case HOST_STATE_Configured:
+				SendTestTone();
+				break;
+		}
+	
+		Audio_Host_USBTask(&Speaker_Audio_Interface);
+		USB_USBTask();
+	}
+}
+
+/** Configures the board hardware and chip peripherals for the demo's functionality. */
+void SetupHardware(void)
+{
+	/* Disable watchdog if enabled by bootloader/fuses */
+	MCUSR &= ~(1 << WDRF);
+	wdt_disable();
+
+	/* Disable clock division */
+	clock_prescale_set(clock_div_1);
+
+	/* Hardware Initialization */
+	SerialStream_Init(9600, false);
+	LEDs_Init();
+	USB_Init();
+}
+
+/** Sends the next block of a square wave test tone to the attached device, and gathers statistics on the streaming
+ *  throughput and on the jitter in the main loop's servicing of the stream, printing them once per statistics period.
+ */
+void SendTestTone(void)
+{
+	static SampleFrame_t ToneFrames[TONE_BLOCK_FRAMES];
+	static uint8_t       ToneFramesOffset;
+	static uint8_t       ToneFramesPending;
+	static uint8_t       TonePhase;
+
+	static uint16_t      StatisticsStartFrame;
+	static uint16_t      LastWriteFrame;
+	static uint32_t      FramesWritten;
+	static uint16_t      MaxServiceGap;
+
+	/* Generate the next block of the test tone once the previous block has been sent */
+	if (!(ToneFramesPending))
+	{
+		for (uint8_t FrameIndex = 0; FrameIndex < TONE_BLOCK_FRAMES; FrameIndex++)
+		{
+			int16_t Sample = ((TonePhase < (TONE_SAMPLE_FREQUENCY / TONE_FREQUENCY / 2)) ? TONE_AMPLITUDE : -TONE_AMPLITUDE);
+			
+			ToneFrames[FrameIndex].Left  = Sample;
+			ToneFrames[FrameIndex].Right = Sample;
+
+			if (++TonePhase == (TONE_SAMPLE_FREQUENCY / TONE_FREQUENCY))
+			  TonePhase = 0;
+		}
+		
+		ToneFramesOffset  = 0;
+		ToneFramesPending = TONE_BLOCK_FRAMES;
+	}
+
+	uint8_t  FramesSent   = Audio_Host_WriteSampleFrames(&Speaker_Audio_Interface, &ToneFrames[ToneFramesOffset],
+	                                                     ToneFramesPending);
+	uint16_t CurrentFrame = USB_Host_GetFrameNumber();
+
+	ToneFramesOffset  += FramesSent;
+	ToneFramesPending -= FramesSent;
+
+	if (FramesSent)
+	{
+		uint16_t ServiceGap = ((CurrentFrame - LastWriteFrame) & FRAME_NUMBER_MASK);
+		
+		if (FramesWritten && (ServiceGap > MaxServiceGap))
+		  MaxServiceGap = ServiceGap;
+		
+		FramesWritten  += FramesSent;
+		LastWriteFrame  = CurrentFrame;
+	}
+	
+	/* Print and reset the statistics once the statistics period has elapsed */
+	if (((CurrentFrame - StatisticsStartFrame) & FRAME_NUMBER_MASK) >= STATISTICS_PERIOD_FRAMES)
+	{
+		printf_P(PSTR("Sample Frames/s: %lu, Max Service Gap: %u ms\r\n"), FramesWritten, MaxServiceGap);
+
+		StatisticsStartFrame = CurrentFrame;
+		FramesWritten        = 0;
+		MaxServiceGap        = 0;
+	}
+}
+
+/** Event handler for the USB_DeviceAttached event. This indicates that a device has been attached to the host, and
+ *  starts the library USB task to begin the enumeration and USB management process.
+ */
+void EVENT_USB_Host_DeviceAttached(void)
+{
+	puts_P(PSTR("Device Attached.\r\n"));
+	LEDs_SetAllLEDs(LEDMASK_USB_ENUMERATING);
+}
+
+/** Event handler for the USB_DeviceUnattached event. This indicates that a device has been removed from the host, and
+ *  stops the library USB task management process.
+ */
+void EVENT_USB_Host_DeviceUnattached(void)
+{
+	puts_P(PSTR("\r\nDevice Unattached.\r\n"));
+	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+}
+
+/** Event handler for the USB_DeviceEnumerationComplete event. This indicates that a device has been successfully
+ *  enumerated by the host and is now ready to be used by the application.
+ */
+void EVENT_USB_Host_DeviceEnumerationComplete(void)
+{
+	LEDs_SetAllLEDs(LEDMASK_USB_READY);
+}
+
+/** Event handler for the USB_HostError event. This indicates that a hardware error occurred while in host mode. */
+void EVENT_USB_Host_HostError(const uint8_t ErrorCode)
+{
+	USB_ShutDown();
+
+	printf_P(PSTR(ESC_FG_RED "Host Mode Error\r\n"
+	                         " -- Error Code %d\r\n" ESC_FG_WHITE), ErrorCode);
+
+	LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+	for(;;);
+}
+
+/** Event handler for the USB_DeviceEnumerationFailed event. This indicates that a problem occurred while
+ *  enumerating an attached USB device.
+ */
+void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode, const uint8_t SubErrorCode)
+{
+	printf_P(PSTR(ESC_FG_RED "Dev Enum Error\r\n"
+	                         " -- Error Code %d\r\n"
+	                         " -- Sub Error Code %d\r\n"
+	                         " -- In State %d\r\n" ESC_FG_WHITE), ErrorCode, SubErrorCode, USB_HostState);
+	
+	LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+}
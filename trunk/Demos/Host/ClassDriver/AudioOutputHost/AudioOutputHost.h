@@ -0,0 +1,103 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Header file for AudioOutputHost.c.
+ */
+
+#ifndef _AUDIO_OUTPUT_HOST_H_
+#define _AUDIO_OUTPUT_HOST_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/wdt.h>
+		#include <avr/pgmspace.h>
+		#include <avr/power.h>
+		#include <stdio.h>
+
+		#include <LUFA/Version.h>
+		#include <LUFA/Drivers/Misc/TerminalCodes.h>
+		#include <LUFA/Drivers/Peripheral/SerialStream.h>
+		#include <LUFA/Drivers/Board/LEDs.h>
+		#include <LUFA/Drivers/USB/USB.h>
+		#include <LUFA/Drivers/USB/Class/Audio.h>
+		
+	/* Macros: */
+		/** Sample rate of the test tone sent to the attached device, in Hz. */
+		#define TONE_SAMPLE_FREQUENCY     48000
+
+		/** Frequency of the square wave test tone sent to the attached device, in Hz. */
+		#define TONE_FREQUENCY            1000
+
+		/** Peak amplitude of the square wave test tone sent to the attached device. */
+		#define TONE_AMPLITUDE            0x2000
+
+		/** Number of sample frames generated into the test tone buffer at a time. */
+		#define TONE_BLOCK_FRAMES         48
+
+		/** Number of USB frames over which the streaming throughput and jitter statistics are gathered before being printed. */
+		#define STATISTICS_PERIOD_FRAMES  1000
+
+		/** Mask for the 11-bit USB frame number, used to handle frame number wrap-around. */
+		#define FRAME_NUMBER_MASK         0x07FF
+
+		/** LED mask for the library LED driver, to indicate that the USB interface is not ready. */
+		#define LEDMASK_USB_NOTREADY      LEDS_LED1
+
+		/** LED mask for the library LED driver, to indicate that the USB interface is enumerating. */
+		#define LEDMASK_USB_ENUMERATING  (LEDS_LED2 | LEDS_LED3)
+
+		/** LED mask for the library LED driver, to indicate that the USB interface is ready. */
+		#define LEDMASK_USB_READY        (LEDS_LED2 | LEDS_LED4)
+
+		/** LED mask for the library LED driver, to indicate that an error has occurred in the USB interface. */
+		#define LEDMASK_USB_ERROR        (LEDS_LED1 | LEDS_LED3)
+
+	/* Type Defines: */
+		/** Type define for a single stereo 16-bit sample frame, as sent to the attached device. */
+		typedef struct
+		{
+			int16_t Left; /**< Left channel audio sample */
+			int16_t Right; /**< Right channel audio sample */
+		} SampleFrame_t;
+		
+	/* Function Prototypes: */
+		void SetupHardware(void);
+		void SendTestTone(void);
+	
+		void EVENT_USB_Host_HostError(const uint8_t ErrorCode);
+		void EVENT_USB_Host_DeviceAttached(void);
+		void EVENT_USB_Host_DeviceUnattached(void);
+		void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode, const uint8_t SubErrorCode);
+		void EVENT_USB_Host_DeviceEnumerationComplete(void);
+		
+#endif
@@ -125,41 +125,41 @@ int main(void)
 					uint8_t JoystickReport[Joystick_HID_Interface.State.LargestReportSize];
 					HID_Host_ReceiveReport(&Joystick_HID_Interface, &JoystickReport);
 
-					uint8_t LEDMask = LEDS_NO_LEDS;
+					uint8_t LEDMask  = LEDS_NO_LEDS;
+					uint8_t ReportID = (HIDReportInfo.UsingReportIDs) ? JoystickReport[0] : 0;
 
-					for (uint8_t ReportNumber = 0; ReportNumber < HIDReportInfo.TotalReportItems; ReportNumber++)
+					/* Update the values of all the report items contained within the current report in a single pass */
+					USB_DecodeHIDReport(JoystickReport, &HIDReportInfo, REPORT_ITEM_TYPE_In);
+
+					/* Look up the report items of interest by their usage, rather than testing each stored report item */
+					for (uint8_t ButtonUsage = 1; ButtonUsage <= JOYSTICK_MAX_BUTTONS; ButtonUsage++)
+					{
+						HID_ReportItem_t* ButtonItem = USB_FindHIDReportItem(&HIDReportInfo, REPORT_ITEM_TYPE_In,
+						                                                     USAGE_PAGE_BUTTON, ButtonUsage, ReportID);
+
+						if ((ButtonItem != NULL) && ButtonItem->Value)
+						  LEDMask = LEDS_ALL_LEDS;
+					}
+
+					HID_ReportItem_t* XAxisItem = USB_FindHIDReportItem(&HIDReportInfo, REPORT_ITEM_TYPE_In,
+					                                                    USAGE_PAGE_GENERIC_DCTRL, USAGE_X, ReportID);
+					HID_ReportItem_t* YAxisItem = USB_FindHIDReportItem(&HIDReportInfo, REPORT_ITEM_TYPE_In,
+					                                                    USAGE_PAGE_GENERIC_DCTRL, USAGE_Y, ReportID);
+
+					if (XAxisItem != NULL)
 					{
-						HID_ReportItem_t* ReportItem = &HIDReportInfo.ReportItems[ReportNumber];
-						
-						/* Update the report item value if it is contained within the current report */
-						if (!(USB_GetHIDReportItemInfo(JoystickReport, ReportItem)))
-						  continue;
-
-						/* Determine what report item is being tested, process updated value as needed */
-						if ((ReportItem->Attributes.Usage.Page        == USAGE_PAGE_BUTTON) &&
-							(ReportItem->ItemType                     == REPORT_ITEM_TYPE_In))
-						{
-							if (ReportItem->Value)
-							  LEDMask = LEDS_ALL_LEDS;
-						}
-						else if ((ReportItem->Attributes.Usage.Page   == USAGE_PAGE_GENERIC_DCTRL) &&
-								 ((ReportItem->Attributes.Usage.Usage == USAGE_X)                  ||
-								  (ReportItem->Attributes.Usage.Usage == USAGE_Y))                 &&
-								 (ReportItem->ItemType                == REPORT_ITEM_TYPE_In))
-						{
-							int16_t DeltaMovement = (int16_t)(ReportItem->Value << (16 - ReportItem->Attributes.BitSize));
-							
-							if (ReportItem->Attributes.Usage.Usage == USAGE_X)
-							{
-								if (DeltaMovement)
-								  LEDMask |= ((DeltaMovement > 0) ? LEDS_LED1 : LEDS_LED2);
-							}
-							else
-							{
-								if (DeltaMovement)
-								  LEDMask |= ((DeltaMovement > 0) ? LEDS_LED3 : LEDS_LED4);
-							}
-						}
+						int16_t DeltaMovement = (int16_t)(XAxisItem->Value << (16 - XAxisItem->Attributes.BitSize));
+
+						if (DeltaMovement)
+						  LEDMask |= ((DeltaMovement > 0) ? LEDS_LED1 : LEDS_LED2);
+					}
+
+					if (YAxisItem != NULL)
+					{
+						int16_t DeltaMovement = (int16_t)(YAxisItem->Value << (16 - YAxisItem->Attributes.BitSize));
+
+						if (DeltaMovement)
+						  LEDMask |= ((DeltaMovement > 0) ? LEDS_LED3 : LEDS_LED4);
 					}
 					
 					LEDs_SetAllLEDs(LEDMask);
@@ -77,6 +77,11 @@
 
 		/** HID Report Descriptor Usage value for a Y axis movement */
 		#define USAGE_Y                     0x31
+
+		/** Number of joystick buttons, from the HID Report Descriptor Usage value for button 1 upwards, which are
+		 *  checked for presses.
+		 */
+		#define JOYSTICK_MAX_BUTTONS        8
 		
 	/* Function Prototypes: */
 		void SetupHardware(void);
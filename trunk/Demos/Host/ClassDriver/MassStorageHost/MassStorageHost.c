@@ -53,6 +53,9 @@ USB_ClassInfo_MS_Host_t FlashDisk_MS_Interface =
 	};
 
 	
+/** Size in bytes of each block of the attached disk, as reported by the device's READ CAPACITY response. */
+static uint16_t DiskBlockSize;
+
 /** Main program entry point. This routine configures the hardware required by the application, then
  *  enters a loop to run the application tasks in sequence.
  */
@@ -186,41 +189,54 @@ int main(void)
 				
 				printf("%lu blocks of %lu bytes.\r\n", DiskCapacity.Blocks, DiskCapacity.BlockSize);
 
+				DiskBlockSize = DiskCapacity.BlockSize;
+
 				uint8_t BlockBuffer[DiskCapacity.BlockSize];
 
-				if (MS_Host_ReadDeviceBlocks(&FlashDisk_MS_Interface, 0, 0x00000000, 1, DiskCapacity.BlockSize, BlockBuffer))
+				printf("\r\nContents of first block:\r\n");
+
+				if (MS_Host_ReadDeviceBlocks_Stream(&FlashDisk_MS_Interface, 0, 0x00000000, 1, DiskCapacity.BlockSize,
+				                                    BlockBuffer, PrintBlockHex))
 				{
 					printf("Error reading device block.\r\n");
 					LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
 					break;
 				}
-			
-				printf("\r\nContents of first block:\r\n");
 
-				for (uint16_t Chunk = 0; Chunk < (DiskCapacity.BlockSize >> 4); Chunk++)
+				puts_P(PSTR("\r\n\r\nPress board button to read entire ASCII contents of disk...\r\n\r\n"));
+
+				/* Wait for the board button to be pressed, aborting if the device is removed */
+				while (!(Buttons_GetStatus() & BUTTONS_BUTTON1))
 				{
-					uint8_t* ChunkPtr = &BlockBuffer[Chunk << 4];
-					
-					/* Print out the 16 bytes of the chunk in HEX format */
-					for (uint8_t ByteOffset = 0; ByteOffset < (1 << 4); ByteOffset++)
-					{
-						char CurrByte = *(ChunkPtr + ByteOffset);
-						printf_P(PSTR("%.2X "), CurrByte);
-					}
-					
-					printf("    ");
+					if (USB_HostState == HOST_STATE_Unattached)
+					  break;
+				}
+
+				if (USB_HostState == HOST_STATE_Unattached)
+				  break;
+
+				/* Stream the entire disk in large multi-block reads, printing each block as it arrives */
+				for (uint32_t CurrBlockAddress = 0; CurrBlockAddress < DiskCapacity.Blocks; )
+				{
+					uint32_t BlocksRem  = (DiskCapacity.Blocks - CurrBlockAddress);
+					uint16_t ReadBlocks = (BlocksRem > DISK_READ_CHUNK_BLOCKS) ? DISK_READ_CHUNK_BLOCKS : BlocksRem;
 
-					/* Print out the 16 bytes of the chunk in ASCII format */
-					for (uint8_t ByteOffset = 0; ByteOffset < (1 << 4); ByteOffset++)
+					if (MS_Host_ReadDeviceBlocks_Stream(&FlashDisk_MS_Interface, 0, CurrBlockAddress, ReadBlocks,
+					                                    DiskCapacity.BlockSize, BlockBuffer, PrintBlockASCII))
 					{
-						char CurrByte = *(ChunkPtr + ByteOffset);
-						putchar(isprint(CurrByte) ? CurrByte : '.');
+						printf("Error reading device block.\r\n");
+						LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+						USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+						break;
 					}
-					
-					printf("\r\n");
+
+					CurrBlockAddress += ReadBlocks;
 				}
 
+				if (USB_HostState == HOST_STATE_WaitForDeviceRemoval)
+				  break;
+
 				LEDs_SetAllLEDs(LEDMASK_USB_READY);
 				USB_HostState = HOST_STATE_WaitForDeviceRemoval;
 				break;
@@ -244,9 +260,67 @@ void SetupHardware(void)
 	/* Hardware Initialization */
 	SerialStream_Init(9600, false);
 	LEDs_Init();
+	Buttons_Init();
 	USB_Init();
 }
 
+/** Block callback for the streamed read of the disk's first block, printing out the block in both HEX and ASCII
+ *  form, 16 bytes per line.
+ *
+ *  \param[in,out] MSInterfaceInfo  Pointer to the MS Class host configuration and state of the transfer
+ *  \param[in] BlockAddress  Address of the received block within the device
+ *  \param[in] BlockBuffer  Pointer to the received block's data
+ *
+ *  \return Boolean true to continue the transfer
+ */
+bool PrintBlockHex(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint32_t BlockAddress, void* BlockBuffer)
+{
+	for (uint16_t Chunk = 0; Chunk < (DiskBlockSize >> 4); Chunk++)
+	{
+		uint8_t* ChunkPtr = &((uint8_t*)BlockBuffer)[Chunk << 4];
+		
+		/* Print out the 16 bytes of the chunk in HEX format */
+		for (uint8_t ByteOffset = 0; ByteOffset < (1 << 4); ByteOffset++)
+		{
+			char CurrByte = *(ChunkPtr + ByteOffset);
+			printf_P(PSTR("%.2X "), CurrByte);
+		}
+		
+		printf("    ");
+
+		/* Print out the 16 bytes of the chunk in ASCII format */
+		for (uint8_t ByteOffset = 0; ByteOffset < (1 << 4); ByteOffset++)
+		{
+			char CurrByte = *(ChunkPtr + ByteOffset);
+			putchar(isprint(CurrByte) ? CurrByte : '.');
+		}
+		
+		printf("\r\n");
+	}
+
+	return true;
+}
+
+/** Block callback for the streamed read of the entire disk, printing out the block's contents in ASCII form.
+ *
+ *  \param[in,out] MSInterfaceInfo  Pointer to the MS Class host configuration and state of the transfer
+ *  \param[in] BlockAddress  Address of the received block within the device
+ *  \param[in] BlockBuffer  Pointer to the received block's data
+ *
+ *  \return Boolean true to continue the transfer
+ */
+bool PrintBlockASCII(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint32_t BlockAddress, void* BlockBuffer)
+{
+	for (uint16_t Byte = 0; Byte < DiskBlockSize; Byte++)
+	{
+		char CurrByte = ((uint8_t*)BlockBuffer)[Byte];
+		
+		putchar(isprint(CurrByte) ? CurrByte : '.');
+	}
+
+	return true;
+}
+
 /** Event handler for the USB_DeviceAttached event. This indicates that a device has been attached to the host, and
  *  starts the library USB task to begin the enumeration and USB management process.
  */
@@ -48,6 +48,7 @@
 		#include <LUFA/Drivers/Misc/TerminalCodes.h>
 		#include <LUFA/Drivers/Peripheral/SerialStream.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
+		#include <LUFA/Drivers/Board/Buttons.h>
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
 		
@@ -67,8 +68,17 @@
 		/** LED mask for the library LED driver, to indicate that the USB interface is busy. */
 		#define LEDMASK_USB_BUSY          LEDS_LED2
 
+		/** Maximum number of blocks read from the attached disk in each streamed read command, when dumping the disk's
+		 *  entire contents. Each block is passed to the dump routine as it is received, so this only limits the number
+		 *  of commands issued and not the amount of RAM used.
+		 */
+		#define DISK_READ_CHUNK_BLOCKS    1024
+
 	/* Function Prototypes: */
 		void SetupHardware(void);
+		
+		bool PrintBlockHex(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint32_t BlockAddress, void* BlockBuffer);
+		bool PrintBlockASCII(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint32_t BlockAddress, void* BlockBuffer);
 	
 		void EVENT_USB_Host_HostError(const uint8_t ErrorCode);
 		void EVENT_USB_Host_DeviceAttached(void);
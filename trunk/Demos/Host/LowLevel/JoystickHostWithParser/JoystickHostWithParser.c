@@ -204,6 +204,15 @@ void Joystick_HID_Task(void)
 				         ((ReportSizeFeatureBits >> 3) + ((ReportSizeFeatureBits & 0x07) != 0)));
 			}
 
+			#if defined(HID_PARSER_STATISTICS)
+			/* Print out the parser resource usage, for tuning of the parser limits */
+			printf_P(PSTR("Parser: %d items, %d data items (%d stored), %d collections, %d PUSH levels, %d usages\r\n"),
+			         HIDReportInfo.Statistics.TotalDescriptorItems, HIDReportInfo.Statistics.TotalDataItems,
+			         HIDReportInfo.TotalReportItems, HIDReportInfo.Statistics.TotalCollections,
+			         HIDReportInfo.Statistics.PeakStateTableDepth, HIDReportInfo.Statistics.PeakUsageListSize);
+			printf_P(PSTR("Parser Output Size: %d bytes\r\n"), sizeof(HID_ReportInfo_t));
+			#endif
+
 			puts_P(PSTR("Joystick Enumerated.\r\n"));
 
 			USB_HostState = HOST_STATE_Configured;
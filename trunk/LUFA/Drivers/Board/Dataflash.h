@@ -204,6 +204,24 @@
 				Dataflash_ToggleSelectedChipCS();				
 			}
 
+			/** Determines if the currently selected dataflash is busy executing a command, such as a main memory page
+			 *  program or main memory to buffer transfer, without waiting for the command to complete. This allows the
+			 *  dataflash to be polled while other work is performed.
+			 *
+			 *  \return Boolean true if the currently selected dataflash is busy, false if it is ready for a new command
+			 */
+			static inline bool Dataflash_IsBusy(void)
+			{
+				bool IsBusy;
+
+				Dataflash_ToggleSelectedChipCS();
+				Dataflash_SendByte(DF_CMD_GETSTATUS);
+				IsBusy = !(Dataflash_ReceiveByte() & DF_STATUS_READY);
+				Dataflash_ToggleSelectedChipCS();
+				
+				return IsBusy;
+			}
+
 			/** Selects a dataflash IC from the given page number, which should range from 0 to
 			 *  ((DATAFLASH_PAGES * DATAFLASH_TOTALCHIPS) - 1). For boards containing only one
 			 *  dataflash IC, this will select DATAFLASH_CHIP1. If the given page number is outside
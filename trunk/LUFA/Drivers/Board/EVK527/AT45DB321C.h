@@ -70,6 +70,7 @@
 			
 			#define DF_CMD_MAINMEMPAGEREAD                  0xD2
 			#define DF_CMD_CONTARRAYREAD_LF                 0xE8
+			#define DF_CONTARRAYREAD_LF_DUMMYBYTES          4
 			#define DF_CMD_BUFF1READ_LF                     0xD4
 			#define DF_CMD_BUFF2READ_LF                     0xD6
 			
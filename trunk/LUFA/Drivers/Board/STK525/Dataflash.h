@@ -84,6 +84,11 @@
 			/** Total number of pages inside the board's dataflash IC. */
 			#define DATAFLASH_PAGES                      8192
 
+			/** Number of unused bytes at the end of each internal main memory page of the board's dataflash ICs, beyond
+			 *  \ref DATAFLASH_PAGE_SIZE. These bytes are skipped over when a continuous array read crosses a page boundary.
+			 */
+			#define DATAFLASH_PAGE_SPARE_BYTES           16
+
 		/* Inline Functions: */
 			/** Selects a dataflash IC from the given page number, which should range from 0 to
 			 *  ((DATAFLASH_PAGES * DATAFLASH_TOTALCHIPS) - 1). For boards containing only one
@@ -73,6 +73,7 @@
 			
 			#define DF_CMD_MAINMEMPAGEREAD                  0xD2
 			#define DF_CMD_CONTARRAYREAD_LF                 0x03
+			#define DF_CONTARRAYREAD_LF_DUMMYBYTES          0
 			#define DF_CMD_BUFF1READ_LF                     0xD1
 			#define DF_CMD_BUFF2READ_LF                     0xD3
 			
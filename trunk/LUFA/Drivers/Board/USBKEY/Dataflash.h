@@ -86,6 +86,11 @@
 
 			/** Total number of pages inside each of the board's dataflash ICs. */
 			#define DATAFLASH_PAGES                      8192
+
+			/** Number of unused bytes at the end of each internal main memory page of the board's dataflash ICs, beyond
+			 *  \ref DATAFLASH_PAGE_SIZE. These bytes are skipped over when a continuous array read crosses a page boundary.
+			 */
+			#define DATAFLASH_PAGE_SPARE_BYTES           32
 			
 		/* Inline Functions: */
 			/** Selects a dataflash IC from the given page number, which should range from 0 to
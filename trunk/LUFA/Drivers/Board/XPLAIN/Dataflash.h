@@ -88,6 +88,11 @@
 
 				/** Total number of pages inside each of the board's dataflash ICs. */
 				#define DATAFLASH_PAGES                  8192			
+
+				/** Number of unused bytes at the end of each internal main memory page of the board's dataflash ICs, beyond
+				 *  \ref DATAFLASH_PAGE_SIZE. These bytes are skipped over when a continuous array read crosses a page boundary.
+				 */
+				#define DATAFLASH_PAGE_SPARE_BYTES       32
 			#endif
 			
 		/* Inline Functions: */
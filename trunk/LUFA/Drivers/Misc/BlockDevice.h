@@ -0,0 +1,244 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Common block storage device interface.
+ *
+ *  Common interface for block storage devices such as the board dataflash, which may be linked to both the SCSI command
+ *  handlers of a USB Mass Storage device and the disk IO layer of a FAT filesystem library.
+ */
+
+/** \ingroup Group_MiscDrivers
+ *  @defgroup Group_BlockDevice Block Storage Device Interface - LUFA/Drivers/Misc/BlockDevice.h
+ *
+ *  \section Sec_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - Exactly one block device backend, from the following list:
+ *      - LUFA/Drivers/Misc/BlockDevice/DataflashBlockDevice.c <i>(Board dataflash IC(s))</i>
+ *      - LUFA/Drivers/Misc/BlockDevice/DataflashFTLBlockDevice.c <i>(Board dataflash IC(s) with wear levelling)</i>
+ *      - LUFA/Drivers/Misc/BlockDevice/RAMBlockDevice.c <i>(Small RAM disk)</i>
+ *      - LUFA/Drivers/Misc/BlockDevice/SDBlockDevice.c <i>(SD/MMC card connected to the SPI port)</i>
+ *      - LUFA/Drivers/Misc/BlockDevice/MSHostBlockDevice.c <i>(Medium of an attached USB Mass Storage device)</i>
+ *
+ *  \section Module Description
+ *  Common interface for block storage devices, which store data in fixed sized blocks of \ref BLOCKDEV_BLOCK_SIZE bytes.
+ *  All block devices implement the same set of functions, so that the storage medium of a project can be changed simply
+ *  by linking in a different backend in the project makefile, and so that improvements to a backend are shared by every
+ *  project that uses it.
+ *
+ *  Blocks may be transferred to or from a RAM buffer, or streamed directly to or from the currently selected endpoint in
+ *  USB device mode so that large transfers from a USB host do not need to be buffered in RAM. Backends which cannot complete
+ *  a write immediately (such as flash media) return once the data has been handed to the storage medium, and complete the
+ *  write in the background - \ref BlockDevice_IsBusy() indicates if such a write is still in progress, and \ref BlockDevice_Flush()
+ *  waits until all written data is stored on the medium. The features of the linked backend can be determined at runtime
+ *  via \ref BlockDevice_GetCapabilities().
+ *
+ *  Example Usage:
+ *  \code
+ *      uint8_t Buffer[BLOCKDEV_BLOCK_SIZE];
+ *
+ *      BlockDevice_Init();
+ *      
+ *      // Copy the first block of the storage medium to the second block
+ *      if (BlockDevice_ReadBlocks(0, 1, Buffer) == BLOCKDEV_ERROR_NoError)
+ *        BlockDevice_WriteBlocks(1, 1, Buffer);
+ *        
+ *      // Ensure that the written block is stored on the medium before power is removed
+ *      BlockDevice_Flush();
+ *  \endcode
+ *
+ *  @{
+ */
+
+#ifndef __BLOCKDEVICE_H__
+#define __BLOCKDEVICE_H__
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+		#include <stddef.h>
+
+		#include "../../Common/Common.h"
+		#include "../USB/USB.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Size in bytes of each block of a block storage device. */
+			#define BLOCKDEV_BLOCK_SIZE              512
+
+			/** Capability mask returned by \ref BlockDevice_GetCapabilities(), indicating that the device can be written to. */
+			#define BLOCKDEV_CAP_WRITABLE            (1 << 0)
+
+			/** Capability mask returned by \ref BlockDevice_GetCapabilities(), indicating that written data may be held in a
+			 *  write-back cache after a write completes, and so the device must be flushed via \ref BlockDevice_Flush() before
+			 *  the written data is stored on the medium.
+			 */
+			#define BLOCKDEV_CAP_WRITE_CACHE         (1 << 1)
+
+			/** Capability mask returned by \ref BlockDevice_GetCapabilities(), indicating that writes are completed by the
+			 *  storage medium in the background after the write functions return, which may be tested for via
+			 *  \ref BlockDevice_IsBusy().
+			 */
+			#define BLOCKDEV_CAP_ASYNC_WRITES        (1 << 2)
+
+			/** Capability mask returned by \ref BlockDevice_GetCapabilities(), indicating that the storage medium may be
+			 *  removed from the device.
+			 */
+			#define BLOCKDEV_CAP_REMOVABLE           (1 << 3)
+
+			/** Capability mask returned by \ref BlockDevice_GetCapabilities(), indicating that the contents of the storage
+			 *  medium are lost when power is removed.
+			 */
+			#define BLOCKDEV_CAP_VOLATILE            (1 << 4)
+
+		/* Enums: */
+			/** Enum for the possible error return codes of the block device functions. */
+			enum BlockDevice_ErrorCodes_t
+			{
+				BLOCKDEV_ERROR_NoError           = 0, /**< Command completed successfully, no error. */
+				BLOCKDEV_ERROR_OutOfRange        = 1, /**< One or more of the requested blocks lie outside the device. */
+				BLOCKDEV_ERROR_DeviceError       = 2, /**< The storage medium failed to complete the command. */
+				BLOCKDEV_ERROR_NotReady          = 3, /**< The storage medium is not present or not yet initialized. */
+				BLOCKDEV_ERROR_WriteProtected    = 4, /**< A write was attempted to a write protected storage medium. */
+				BLOCKDEV_ERROR_EndpointError     = 5, /**< The endpoint being streamed to or from failed to become ready,
+				                                       *   due to a timeout, stall or disconnection of the host.
+				                                       */
+				BLOCKDEV_ERROR_Aborted           = 6, /**< The endpoint transfer was aborted via the given abort flag. */
+			};
+
+		/* Function Prototypes: */
+			/** Initializes the storage medium ready for use, including any hardware interfaces used by the block device
+			 *  backend which are not already initialized by the user application.
+			 *
+			 *  \return A value from the \ref BlockDevice_ErrorCodes_t enum
+			 */
+			uint8_t BlockDevice_Init(void);
+
+			/** Retrieves the features of the linked block device backend.
+			 *
+			 *  \return Mask of BLOCKDEV_CAP_* masks indicating the capabilities of the block device
+			 */
+			uint8_t BlockDevice_GetCapabilities(void) ATTR_WARN_UNUSED_RESULT;
+
+			/** Retrieves the total number of blocks in the storage medium.
+			 *
+			 *  \return Total number of \ref BLOCKDEV_BLOCK_SIZE sized blocks in the block device
+			 */
+			uint32_t BlockDevice_GetTotalBlocks(void) ATTR_WARN_UNUSED_RESULT;
+
+			/** Reads one or more consecutive blocks from the storage medium into a RAM buffer.
+			 *
+			 *  \param[in] BlockAddress  Address of the first block to read
+			 *  \param[in] TotalBlocks   Number of blocks to read
+			 *  \param[out] BufferPtr    Pointer to a RAM buffer of at least (TotalBlocks * \ref BLOCKDEV_BLOCK_SIZE) bytes
+			 *
+			 *  \return A value from the \ref BlockDevice_ErrorCodes_t enum
+			 */
+			uint8_t BlockDevice_ReadBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks,
+			                               uint8_t* BufferPtr) ATTR_NON_NULL_PTR_ARG(3);
+
+			/** Writes one or more consecutive blocks to the storage medium from a RAM buffer.
+			 *
+			 *  \param[in] BlockAddress  Address of the first block to write
+			 *  \param[in] TotalBlocks   Number of blocks to write
+			 *  \param[in] BufferPtr     Pointer to a RAM buffer of at least (TotalBlocks * \ref BLOCKDEV_BLOCK_SIZE) bytes
+			 *
+			 *  \return A value from the \ref BlockDevice_ErrorCodes_t enum
+			 */
+			uint8_t BlockDevice_WriteBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks,
+			                                const uint8_t* BufferPtr) ATTR_NON_NULL_PTR_ARG(3);
+
+			#if defined(USB_CAN_BE_DEVICE) || defined(__DOXYGEN__)
+			/** Reads one or more consecutive blocks from the storage medium, and writes them to the currently selected
+			 *  IN endpoint. Full endpoint banks are sent to the host as the transfer progresses; the last bank is sent
+			 *  only if it is full.
+			 *
+			 *  \note This function is not available when the library is compiled for USB host only mode.
+			 *
+			 *  \param[in] BlockAddress  Address of the first block to read
+			 *  \param[in] TotalBlocks   Number of blocks to read
+			 *  \param[in] AbortFlag     Pointer to a flag which aborts the transfer when set, or NULL if the transfer
+			 *                           cannot be aborted
+			 *
+			 *  \return A value from the \ref BlockDevice_ErrorCodes_t enum
+			 */
+			uint8_t BlockDevice_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+			                                        const volatile bool* const AbortFlag);
+
+			/** Reads one or more consecutive blocks from the currently selected OUT endpoint, and writes them to the
+			 *  storage medium. Endpoint banks are cleared as they are emptied.
+			 *
+			 *  \note This function is not available when the library is compiled for USB host only mode.
+			 *
+			 *  \param[in] BlockAddress  Address of the first block to write
+			 *  \param[in] TotalBlocks   Number of blocks to write
+			 *  \param[in] AbortFlag     Pointer to a flag which aborts the transfer when set, or NULL if the transfer
+			 *                           cannot be aborted
+			 *
+			 *  \return A value from the \ref BlockDevice_ErrorCodes_t enum
+			 */
+			uint8_t BlockDevice_WriteBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+			                                         const volatile bool* const AbortFlag);
+			#endif
+
+			/** Waits until all data written to the device, including any data held in a write-back cache, has been
+			 *  stored on the medium.
+			 *
+			 *  \return A value from the \ref BlockDevice_ErrorCodes_t enum
+			 */
+			uint8_t BlockDevice_Flush(void);
+
+			/** Determines if the storage medium is still completing a previous write in the background. This will only
+			 *  return true for block devices with the \ref BLOCKDEV_CAP_ASYNC_WRITES capability. This function does not
+			 *  wait for the write to complete, and so may be polled between endpoint bank transfers or other tasks.
+			 *
+			 *  \return Boolean true if a write is still in progress, false otherwise
+			 */
+			bool BlockDevice_IsBusy(void) ATTR_WARN_UNUSED_RESULT;
+
+			/** Performs a simple test of the storage medium to ensure that it is present and working.
+			 *
+			 *  \return Boolean true if the storage medium is working, false otherwise
+			 */
+			bool BlockDevice_CheckOperation(void) ATTR_WARN_UNUSED_RESULT;
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
@@ -0,0 +1,661 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_DATAFLASH_BLOCKDEVICE_C
+#include "DataflashBlockDevice.h"
+
+/** Dataflash page held in each dataflash IC's SRAM buffers, or \ref DATAFLASH_NO_CACHED_PAGE if the IC holds no page. Written
+ *  data is held in one of the IC's SRAM buffers until the page is evicted by a write to a different page of the same IC, or the
+ *  page is written back at the end of the write (or on a flush, if the write cache is enabled).
+ */
+static uint16_t CachedPages[DATAFLASH_TOTALCHIPS] = {[0 ... (DATAFLASH_TOTALCHIPS - 1)] = DATAFLASH_NO_CACHED_PAGE};
+
+/** Mask of the dataflash ICs whose most recently filled SRAM buffer is the IC's second buffer, one bit per IC. That buffer
+ *  either holds the IC's cached page or is being programmed into the dataflash in the background, thus the next page
+ *  written to each IC is always filled into the other buffer.
+ */
+static uint8_t SecondBufferChips;
+
+/** Mask of the dataflash ICs which may still be busy executing a page program started in the background, one bit per IC.
+ *  ICs not in the mask are known to be ready, and are not polled before a new command is sent to them.
+ */
+static uint8_t ProgrammingChips = ((1 << DATAFLASH_TOTALCHIPS) - 1);
+
+/** Retrieves the index of the currently selected dataflash IC, for the cached page state.
+ *
+ *  \return Index of the selected dataflash IC, from 0 to (DATAFLASH_TOTALCHIPS - 1)
+ */
+static uint8_t DataflashBlockDevice_GetSelectedChipIndex(void)
+{
+	return (Dataflash_GetSelectedChip() == DATAFLASH_CHIP_MASK(DATAFLASH_TOTALCHIPS)) ? (DATAFLASH_TOTALCHIPS - 1) : 0;
+}
+
+/** Waits until the selected dataflash IC has completed any page program started in the background. If no page program
+ *  has been started since the IC was last found to be ready, the IC is not polled.
+ *
+ *  \param[in] ChipIndex  Index of the selected dataflash IC, as returned by \ref DataflashBlockDevice_GetSelectedChipIndex()
+ */
+static void DataflashBlockDevice_WaitWhileChipBusy(const uint8_t ChipIndex)
+{
+	if (!(ProgrammingChips & (1 << ChipIndex)))
+	  return;
+
+	Dataflash_WaitWhileBusy();
+	ProgrammingChips &= ~(1 << ChipIndex);
+}
+
+/** Starts writing back the page held in the selected dataflash IC's SRAM buffer to the dataflash, once the IC's previous
+ *  page program has completed. The page program is not waited on, and begins when the IC is next deselected.
+ *
+ *  \param[in] ChipIndex  Index of the selected dataflash IC, as returned by \ref DataflashBlockDevice_GetSelectedChipIndex()
+ */
+static void DataflashBlockDevice_WriteBackCachedPage(const uint8_t ChipIndex)
+{
+	/* Wait until the selected dataflash's previous page program has completed */
+	DataflashBlockDevice_WaitWhileChipBusy(ChipIndex);
+	
+	/* Send the dataflash buffer to main memory page program command */
+	Dataflash_SendByte((SecondBufferChips & (1 << ChipIndex)) ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(CachedPages[ChipIndex], 0);
+	
+	CachedPages[ChipIndex] = DATAFLASH_NO_CACHED_PAGE;
+	ProgrammingChips      |= (1 << ChipIndex);
+}
+
+/** Writes back the pages held in the SRAM buffers of all dataflash ICs to the dataflash.
+ *
+ *  \param[in] WaitForCompletion  Boolean true if each page program should be waited on, false if the programs should be left
+ *                                to complete in the background
+ */
+static void DataflashBlockDevice_WriteBackAllPages(const bool WaitForCompletion)
+{
+	for (uint8_t ChipIndex = 0; ChipIndex < DATAFLASH_TOTALCHIPS; ChipIndex++)
+	{
+		if (CachedPages[ChipIndex] == DATAFLASH_NO_CACHED_PAGE)
+		  continue;
+		  
+		/* Write back the cached page, starting the page program */
+		Dataflash_SelectChipFromPage(CachedPages[ChipIndex]);
+		DataflashBlockDevice_WriteBackCachedPage(ChipIndex);
+
+		if (WaitForCompletion)
+		  DataflashBlockDevice_WaitWhileChipBusy(ChipIndex);
+	}
+
+	/* Deselect all dataflash chips */
+	Dataflash_DeselectChip();
+}
+
+/** Completes a write to the dataflash, by starting the page programs of the written pages unless the write cache is enabled,
+ *  and deselecting the dataflash.
+ *
+ *  \param[in] ErrorCode  Error code of the write, from the \ref BlockDevice_ErrorCodes_t enum
+ *
+ *  \return The given error code, so that it can be returned directly by the write function
+ */
+static uint8_t DataflashBlockDevice_EndWrite(const uint8_t ErrorCode)
+{
+	#if !defined(DATAFLASH_BLOCKDEV_WRITE_CACHE)
+	/* Start programming the written pages, leaving the programs to complete while the next command is processed */
+	DataflashBlockDevice_WriteBackAllPages(false);
+	#else
+	/* Leave the last pages in the write-back cache, to be written back on eviction or flush */
+	Dataflash_DeselectChip();
+	#endif
+	
+	return ErrorCode;
+}
+
+/** Selects the dataflash IC containing the given page and opens the page in one of the IC's SRAM buffers, ready for the page's
+ *  new contents to be written into the returned buffer. Any other page held in the IC's buffers is evicted, and written back to
+ *  the dataflash in the background while the new page is filled.
+ *
+ *  \param[in] PageAddress       Dataflash page address which is to be written to
+ *  \param[in] PreserveContents  Boolean true if the page is to be partially written, and thus its existing contents must
+ *                               be loaded into the buffer
+ *
+ *  \return Boolean true if the page is held in the selected IC's second SRAM buffer, false otherwise
+ */
+static bool DataflashBlockDevice_OpenCachedPage(const uint16_t PageAddress, const bool PreserveContents)
+{
+	Dataflash_SelectChipFromPage(PageAddress);
+
+	uint8_t ChipIndex = DataflashBlockDevice_GetSelectedChipIndex();
+	uint8_t ChipMask  = (1 << ChipIndex);
+
+	/* If the page is already cached, continue writing to the buffer holding it */
+	if (CachedPages[ChipIndex] == PageAddress)
+	  return (SecondBufferChips & ChipMask);
+
+	/* Evict any other page held in the buffers, programming it into the dataflash in the background */
+	if (CachedPages[ChipIndex] != DATAFLASH_NO_CACHED_PAGE)
+	  DataflashBlockDevice_WriteBackCachedPage(ChipIndex);
+
+	/* Fill the new page into the buffer not in use by the evicted page */
+	SecondBufferChips     ^= ChipMask;
+	CachedPages[ChipIndex] = PageAddress;
+
+	Dataflash_ToggleSelectedChipCS();
+
+	if (PreserveContents)
+	{
+		/* Copy selected dataflash's current page contents to the buffer once any running page program completes */
+		DataflashBlockDevice_WaitWhileChipBusy(ChipIndex);
+		Dataflash_SendByte((SecondBufferChips & ChipMask) ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
+		Dataflash_SendAddressBytes(PageAddress, 0);
+		Dataflash_WaitWhileBusy();
+	}
+
+	return (SecondBufferChips & ChipMask);
+}
+
+/** Selects the dataflash IC containing the given page and starts a main memory read from the given byte of the page. If
+ *  any of the pages to be read are held in the IC's SRAM buffers they are first written back to the dataflash, and any
+ *  running page program of the IC is waited on.
+ *
+ *  When continuous reads are available the read continues into the following pages of the IC, with the spare bytes at
+ *  the end of each page to be skipped by the caller. Otherwise the read wraps at the end of the page, and a new read must
+ *  be started for each subsequent page.
+ *
+ *  \param[in] PageAddress  Dataflash page address which is to be read from
+ *  \param[in] PageByte     Address within the dataflash page of the first byte to read
+ *  \param[in] TotalPages   Number of consecutive pages which are to be read by the started read
+ */
+static void DataflashBlockDevice_StartRead(const uint16_t PageAddress, const uint16_t PageByte, const uint16_t TotalPages)
+{
+	Dataflash_SelectChipFromPage(PageAddress);
+
+	uint8_t ChipIndex = DataflashBlockDevice_GetSelectedChipIndex();
+
+	/* Pages are read from the dataflash main memory, so any cached copy of the pages must be written back first */
+	if ((CachedPages[ChipIndex] >= PageAddress) && (CachedPages[ChipIndex] < (PageAddress + TotalPages)))
+	  DataflashBlockDevice_WriteBackCachedPage(ChipIndex);
+
+	/* Wait until any page program of the selected dataflash has completed */
+	DataflashBlockDevice_WaitWhileChipBusy(ChipIndex);
+
+	#if defined(DATAFLASH_BLOCKDEV_CONTINUOUS_READ)
+	/* Send the dataflash continuous array read command */
+	Dataflash_SendByte(DF_CMD_CONTARRAYREAD_LF);
+	Dataflash_SendAddressBytes(PageAddress, PageByte);
+
+	for (uint8_t DummyByte = 0; DummyByte < DF_CONTARRAYREAD_LF_DUMMYBYTES; DummyByte++)
+	  Dataflash_SendByte(0x00);
+	#else
+	/* Send the dataflash main memory page read command */
+	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+	Dataflash_SendAddressBytes(PageAddress, PageByte);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	#endif
+}
+
+uint8_t BlockDevice_Init(void)
+{
+	/* Select first dataflash chip, send the read status register command */
+	Dataflash_SelectChip(DATAFLASH_CHIP1);
+	Dataflash_SendByte(DF_CMD_GETSTATUS);
+	
+	/* Check if sector protection is enabled */
+	if (Dataflash_ReceiveByte() & DF_STATUS_SECTORPROTECTION_ON)
+	{
+		Dataflash_ToggleSelectedChipCS();
+
+		/* Send the commands to disable sector protection */
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[0]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[1]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[2]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[3]);
+	}
+	
+	/* Select second dataflash chip (if present on selected board), send read status register command */
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	Dataflash_SelectChip(DATAFLASH_CHIP2);
+	Dataflash_SendByte(DF_CMD_GETSTATUS);
+	
+	/* Check if sector protection is enabled */
+	if (Dataflash_ReceiveByte() & DF_STATUS_SECTORPROTECTION_ON)
+	{
+		Dataflash_ToggleSelectedChipCS();
+
+		/* Send the commands to disable sector protection */
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[0]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[1]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[2]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[3]);
+	}
+	#endif
+	
+	/* Deselect current dataflash chip */
+	Dataflash_DeselectChip();
+	
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_GetCapabilities(void)
+{
+	#if defined(DATAFLASH_BLOCKDEV_WRITE_CACHE)
+	return (BLOCKDEV_CAP_WRITABLE | BLOCKDEV_CAP_ASYNC_WRITES | BLOCKDEV_CAP_WRITE_CACHE);
+	#else
+	return (BLOCKDEV_CAP_WRITABLE | BLOCKDEV_CAP_ASYNC_WRITES);
+	#endif
+}
+
+uint32_t BlockDevice_GetTotalBlocks(void)
+{
+	return DATAFLASH_BLOCKDEV_TOTAL_BLOCKS;
+}
+
+#if defined(USB_CAN_BE_DEVICE)
+uint8_t BlockDevice_WriteBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                         const volatile bool* const AbortFlag)
+{
+	uint16_t CurrDFPage          = ((BlockAddress * BLOCKDEV_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
+	uint16_t CurrDFPageByte      = ((BlockAddress * BLOCKDEV_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
+	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
+	bool     UsingSecondBuffer;
+
+	/* Check that all the requested blocks lie within the dataflash */
+	if ((BlockAddress + TotalBlocks) > DATAFLASH_BLOCKDEV_TOTAL_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+
+	/* Select the correct starting Dataflash IC for the block requested, and open the page in one of its buffers */
+	UsingSecondBuffer = DataflashBlockDevice_OpenCachedPage(CurrDFPage, (DATAFLASH_PAGE_SIZE > BLOCKDEV_BLOCK_SIZE));
+
+	/* Send the dataflash buffer write command */
+	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, CurrDFPageByte);
+
+	while (TotalBlocks)
+	{
+		uint8_t BytesInBlockDiv16 = 0;
+		
+		/* Write an endpoint packet sized data block to the dataflash */
+		while (BytesInBlockDiv16 < (BLOCKDEV_BLOCK_SIZE >> 4))
+		{
+			/* Check if the endpoint is currently empty */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the current endpoint bank */
+				Endpoint_ClearOUT();
+				
+				/* Wait until the host has sent another packet */
+				if (Endpoint_WaitUntilReady())
+				  return DataflashBlockDevice_EndWrite(BLOCKDEV_ERROR_EndpointError);
+			}
+
+			/* Check if end of dataflash page reached */
+			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
+			{
+				/* Reset the dataflash buffer counter, increment the page counter */
+				CurrDFPageByteDiv16 = 0;
+				CurrDFPage++;
+
+				/* If less than one dataflash page remaining, the existing page contents must be preserved to keep trailing data */
+				bool PreserveContents = ((DATAFLASH_PAGE_SIZE > BLOCKDEV_BLOCK_SIZE) &&
+				                         ((TotalBlocks * (BLOCKDEV_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4)));
+
+				/* Select the next dataflash chip based on the new dataflash page index, and open the page in one of its buffers */
+				UsingSecondBuffer = DataflashBlockDevice_OpenCachedPage(CurrDFPage, PreserveContents);
+
+				/* Send the dataflash buffer write command */
+				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+				Dataflash_SendAddressBytes(0, 0);				
+			}
+
+			/* Write one 16-byte chunk of data to the dataflash */
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			
+			/* Increment the dataflash page 16 byte block counter */
+			CurrDFPageByteDiv16++;
+
+			/* Increment the block 16 byte block counter */
+			BytesInBlockDiv16++;
+
+			/* Check if the current transfer is being aborted */
+			if ((AbortFlag != NULL) && *AbortFlag)
+			  return DataflashBlockDevice_EndWrite(BLOCKDEV_ERROR_Aborted);
+		}
+			
+		/* Decrement the blocks remaining counter and reset the sub block counter */
+		TotalBlocks--;
+	}
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	return DataflashBlockDevice_EndWrite(BLOCKDEV_ERROR_NoError);
+}
+
+uint8_t BlockDevice_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                        const volatile bool* const AbortFlag)
+{
+	uint16_t CurrDFPage          = ((BlockAddress * BLOCKDEV_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
+	uint16_t CurrDFPageByte      = ((BlockAddress * BLOCKDEV_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
+	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
+
+	/* Check that all the requested blocks lie within the dataflash */
+	if ((BlockAddress + TotalBlocks) > DATAFLASH_BLOCKDEV_TOTAL_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	/* Select the correct starting Dataflash IC for the block requested, and start reading from the block */
+	DataflashBlockDevice_StartRead(CurrDFPage, CurrDFPageByte, DATAFLASH_BLOCKDEV_READ_PAGES(BlockAddress, TotalBlocks));
+	
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+	
+	while (TotalBlocks)
+	{
+		uint8_t BytesInBlockDiv16 = 0;
+		
+		/* Write an endpoint packet sized data block to the dataflash */
+		while (BytesInBlockDiv16 < (BLOCKDEV_BLOCK_SIZE >> 4))
+		{
+			/* Check if the endpoint is currently full */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the endpoint bank to send its contents to the host */
+				Endpoint_ClearIN();
+				
+				/* Wait until the endpoint is ready for more data */
+				if (Endpoint_WaitUntilReady())
+				  return BLOCKDEV_ERROR_EndpointError;
+			}
+			
+			/* Check if end of dataflash page reached */
+			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
+			{
+				/* Reset the dataflash buffer counter, increment the page counter */
+				CurrDFPageByteDiv16 = 0;
+				CurrDFPage++;
+
+				#if defined(DATAFLASH_BLOCKDEV_CONTINUOUS_READ)
+				/* Skip over the spare bytes at the end of the page, the continuous read carries on into the next page */
+				for (uint8_t SpareByte = 0; SpareByte < DATAFLASH_PAGE_SPARE_BYTES; SpareByte++)
+				  Dataflash_ReceiveByte();
+				#else
+				/* Select the next dataflash chip based on the new dataflash page index, and start reading from the page */
+				DataflashBlockDevice_StartRead(CurrDFPage, 0, 1);
+				#endif
+			}	
+
+			/* Read one 16-byte chunk of data from the dataflash */
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			
+			/* Increment the dataflash page 16 byte block counter */
+			CurrDFPageByteDiv16++;
+			
+			/* Increment the block 16 byte block counter */
+			BytesInBlockDiv16++;
+
+			/* Check if the current transfer is being aborted */
+			if ((AbortFlag != NULL) && *AbortFlag)
+			  return BLOCKDEV_ERROR_Aborted;
+		}
+		
+		/* Decrement the blocks remaining counter */
+		TotalBlocks--;
+	}
+	
+	/* If the endpoint is full, send its contents to the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	/* Deselect all dataflash chips */
+	Dataflash_DeselectChip();
+	
+	return BLOCKDEV_ERROR_NoError;
+}
+#endif
+
+uint8_t BlockDevice_WriteBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, const uint8_t* BufferPtr)
+{
+	uint16_t CurrDFPage          = ((BlockAddress * BLOCKDEV_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
+	uint16_t CurrDFPageByte      = ((BlockAddress * BLOCKDEV_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
+	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
+	bool     UsingSecondBuffer;
+
+	/* Check that all the requested blocks lie within the dataflash */
+	if ((BlockAddress + TotalBlocks) > DATAFLASH_BLOCKDEV_TOTAL_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	/* Select the correct starting Dataflash IC for the block requested, and open the page in one of its buffers */
+	UsingSecondBuffer = DataflashBlockDevice_OpenCachedPage(CurrDFPage, (DATAFLASH_PAGE_SIZE > BLOCKDEV_BLOCK_SIZE));
+
+	/* Send the dataflash buffer write command */
+	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, CurrDFPageByte);
+	
+	while (TotalBlocks)
+	{
+		uint8_t BytesInBlockDiv16 = 0;
+		
+		/* Write an endpoint packet sized data block to the dataflash */
+		while (BytesInBlockDiv16 < (BLOCKDEV_BLOCK_SIZE >> 4))
+		{
+			/* Check if end of dataflash page reached */
+			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
+			{
+				/* Reset the dataflash buffer counter, increment the page counter */
+				CurrDFPageByteDiv16 = 0;
+				CurrDFPage++;
+
+				/* If less than one dataflash page remaining, the existing page contents must be preserved to keep trailing data */
+				bool PreserveContents = ((DATAFLASH_PAGE_SIZE > BLOCKDEV_BLOCK_SIZE) &&
+				                         ((TotalBlocks * (BLOCKDEV_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4)));
+
+				/* Select the next dataflash chip based on the new dataflash page index, and open the page in one of its buffers */
+				UsingSecondBuffer = DataflashBlockDevice_OpenCachedPage(CurrDFPage, PreserveContents);
+
+				/* Send the dataflash buffer write command */
+				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+				Dataflash_SendAddressBytes(0, 0);
+			}
+			
+			/* Write one 16-byte chunk of data to the dataflash */
+			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+			  Dataflash_SendByte(*(BufferPtr++));
+			
+			/* Increment the dataflash page 16 byte block counter */
+			CurrDFPageByteDiv16++;
+
+			/* Increment the block 16 byte block counter */
+			BytesInBlockDiv16++;		
+		}
+			
+		/* Decrement the blocks remaining counter and reset the sub block counter */
+		TotalBlocks--;
+	}
+
+	return DataflashBlockDevice_EndWrite(BLOCKDEV_ERROR_NoError);
+}
+
+uint8_t BlockDevice_ReadBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, uint8_t* BufferPtr)
+{
+	uint16_t CurrDFPage          = ((BlockAddress * BLOCKDEV_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
+	uint16_t CurrDFPageByte      = ((BlockAddress * BLOCKDEV_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
+	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
+
+	/* Check that all the requested blocks lie within the dataflash */
+	if ((BlockAddress + TotalBlocks) > DATAFLASH_BLOCKDEV_TOTAL_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	/* Select the correct starting Dataflash IC for the block requested, and start reading from the block */
+	DataflashBlockDevice_StartRead(CurrDFPage, CurrDFPageByte, DATAFLASH_BLOCKDEV_READ_PAGES(BlockAddress, TotalBlocks));
+
+	while (TotalBlocks)
+	{
+		uint8_t BytesInBlockDiv16 = 0;
+		
+		/* Write an endpoint packet sized data block to the dataflash */
+		while (BytesInBlockDiv16 < (BLOCKDEV_BLOCK_SIZE >> 4))
+		{
+			/* Check if end of dataflash page reached */
+			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
+			{
+				/* Reset the dataflash buffer counter, increment the page counter */
+				CurrDFPageByteDiv16 = 0;
+				CurrDFPage++;
+
+				#if defined(DATAFLASH_BLOCKDEV_CONTINUOUS_READ)
+				/* Skip over the spare bytes at the end of the page, the continuous read carries on into the next page */
+				for (uint8_t SpareByte = 0; SpareByte < DATAFLASH_PAGE_SPARE_BYTES; SpareByte++)
+				  Dataflash_ReceiveByte();
+				#else
+				/* Select the next dataflash chip based on the new dataflash page index, and start reading from the page */
+				DataflashBlockDevice_StartRead(CurrDFPage, 0, 1);
+				#endif
+			}	
+
+			/* Read one 16-byte chunk of data from the dataflash */
+			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+			  *(BufferPtr++) = Dataflash_ReceiveByte();
+			
+			/* Increment the dataflash page 16 byte block counter */
+			CurrDFPageByteDiv16++;
+			
+			/* Increment the block 16 byte block counter */
+			BytesInBlockDiv16++;
+		}
+		
+		/* Decrement the blocks remaining counter */
+		TotalBlocks--;
+	}
+
+	/* Deselect all dataflash chips */
+	Dataflash_DeselectChip();
+	
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_Flush(void)
+{
+	/* Write back all held pages and wait for any running page programs to complete */
+	DataflashBlockDevice_WriteBackAllPages(true);
+
+	while (BlockDevice_IsBusy());
+	
+	return BLOCKDEV_ERROR_NoError;
+}
+
+bool BlockDevice_IsBusy(void)
+{
+	/* Check if the first dataflash IC is still programming a page, if one was started */
+	if (ProgrammingChips & (1 << 0))
+	{
+		Dataflash_SelectChip(DATAFLASH_CHIP1);
+
+		if (!(Dataflash_IsBusy()))
+		  ProgrammingChips &= ~(1 << 0);
+	}
+
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	/* Check if the second dataflash IC is still programming a page, if one was started */
+	if (ProgrammingChips & (1 << 1))
+	{
+		Dataflash_SelectChip(DATAFLASH_CHIP2);
+
+		if (!(Dataflash_IsBusy()))
+		  ProgrammingChips &= ~(1 << 1);
+	}
+	#endif
+
+	/* Deselect current dataflash chip */
+	Dataflash_DeselectChip();
+	
+	return (ProgrammingChips != 0);
+}
+
+bool BlockDevice_CheckOperation(void)
+{
+	uint8_t ReturnByte;
+
+	/* Test first Dataflash IC is present and responding to commands */
+	Dataflash_SelectChip(DATAFLASH_CHIP1);
+	Dataflash_SendByte(DF_CMD_READMANUFACTURERDEVICEINFO);
+	ReturnByte = Dataflash_ReceiveByte();
+	Dataflash_DeselectChip();
+
+	/* If returned data is invalid, fail the command */
+	if (ReturnByte != DF_MANUFACTURER_ATMEL)
+	  return false;
+
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	/* Test second Dataflash IC is present and responding to commands */
+	Dataflash_SelectChip(DATAFLASH_CHIP2);
+	Dataflash_SendByte(DF_CMD_READMANUFACTURERDEVICEINFO);
+	ReturnByte = Dataflash_ReceiveByte();
+	Dataflash_DeselectChip();
+
+	/* If returned data is invalid, fail the command */
+	if (ReturnByte != DF_MANUFACTURER_ATMEL)
+	  return false;
+	#endif
+	
+	return true;
+}
@@ -0,0 +1,97 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Board dataflash block device backend.
+ *
+ *  Block device backend for the board dataflash IC(s). The dataflash pages of all attached ICs are combined into a single
+ *  storage medium, and the SPI and board dataflash drivers must be initialized by the user application before
+ *  \ref BlockDevice_Init() is called.
+ *
+ *  Page programs are started from one of each IC's two SRAM buffers and left to complete in the background, while the next
+ *  page's data is transferred into the other buffer. If the DATAFLASH_BLOCKDEV_WRITE_CACHE token is defined in the project
+ *  makefile and passed to the compiler via the -D switch, the last page written to each IC is additionally held in its SRAM
+ *  buffer until it is evicted by a write to a different page of the same IC or \ref BlockDevice_Flush() is called, so that
+ *  repeated small writes to the same page (such as FAT updates) are coalesced into a single page program. Projects enabling
+ *  the write cache must ensure that the cache is flushed before power may be removed.
+ *
+ *  The page programs running in the background are tracked for each IC, so that \ref BlockDevice_IsBusy() only polls the ICs
+ *  which may still be busy and may be called cheaply between endpoint bank transfers. On boards with a single dataflash IC
+ *  whose spare page bytes are known (DATAFLASH_PAGE_SPARE_BYTES), multi-page reads are performed with a single continuous array
+ *  read command rather than a new main memory page read command for each page.
+ *
+ *  \note This file should not be included directly. Include LUFA/Drivers/Misc/BlockDevice.h instead, and add this backend's
+ *        source file to the project makefile.
+ */
+
+#ifndef __DATAFLASH_BLOCKDEVICE_H__
+#define __DATAFLASH_BLOCKDEVICE_H__
+
+	/* Includes: */
+		#include "../BlockDevice.h"
+		#include "../../Board/Dataflash.h"
+
+	/* Preprocessor Checks: */
+		#if (DATAFLASH_PAGE_SIZE % 16)
+			#error Dataflash page size must be a multiple of 16 bytes.
+		#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define DATAFLASH_BLOCKDEV_TOTAL_BLOCKS  (((uint32_t)DATAFLASH_PAGES * DATAFLASH_PAGE_SIZE * DATAFLASH_TOTALCHIPS) / \
+			                                          BLOCKDEV_BLOCK_SIZE)
+
+			#define DATAFLASH_NO_CACHED_PAGE         0xFFFF
+
+			#if ((DATAFLASH_TOTALCHIPS == 1) && defined(DATAFLASH_PAGE_SPARE_BYTES) && defined(DF_CMD_CONTARRAYREAD_LF))
+				#define DATAFLASH_BLOCKDEV_CONTINUOUS_READ
+
+				#define DATAFLASH_BLOCKDEV_READ_PAGES(BlockAddress, TotalBlocks) \
+				                                   ((((((BlockAddress) + (TotalBlocks)) * BLOCKDEV_BLOCK_SIZE) - 1) / DATAFLASH_PAGE_SIZE) - \
+				                                    (((BlockAddress) * BLOCKDEV_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE) + 1)
+			#else
+				#define DATAFLASH_BLOCKDEV_READ_PAGES(BlockAddress, TotalBlocks) 1
+			#endif
+
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_DATAFLASH_BLOCKDEVICE_C)
+				static uint8_t DataflashBlockDevice_GetSelectedChipIndex(void);
+				static void    DataflashBlockDevice_WaitWhileChipBusy(const uint8_t ChipIndex);
+				static void    DataflashBlockDevice_WriteBackCachedPage(const uint8_t ChipIndex);
+				static void    DataflashBlockDevice_WriteBackAllPages(const bool WaitForCompletion);
+				static uint8_t DataflashBlockDevice_EndWrite(const uint8_t ErrorCode);
+				static bool    DataflashBlockDevice_OpenCachedPage(const uint16_t PageAddress, const bool PreserveContents);
+				static void    DataflashBlockDevice_StartRead(const uint16_t PageAddress, const uint16_t PageByte,
+				                                              const uint16_t TotalPages);
+			#endif
+	#endif
+
+#endif
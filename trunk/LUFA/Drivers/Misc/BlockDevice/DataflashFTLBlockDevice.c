@@ -0,0 +1,1065 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_DATAFLASHFTL_BLOCKDEVICE_C
+#include "DataflashFTLBlockDevice.h"
+
+/** Physical page holding each page of the logical to physical page mapping table, or \ref DATAFLASH_FTL_NO_PAGE if none of
+ *  the logical pages covered by the map page have been written.
+ */
+static uint16_t MapDirectory[DATAFLASH_FTL_MAP_PAGES];
+
+/** Mapping table changes which have not yet been written to the map pages in the dataflash. */
+static DataflashFTL_JournalEntry_t Journal[DATAFLASH_FTL_JOURNAL_ENTRIES];
+
+/** Number of valid entries in the \ref Journal array. */
+static uint8_t JournalEntries;
+
+/** Owner of each page of the segment currently being written, for the segment's summary. */
+static uint16_t HeadOwners[DATAFLASH_FTL_DATA_PAGES];
+
+/** Index of the segment currently being written (the head of the log). */
+static uint16_t HeadSegment;
+
+/** Index of the next free page in the head segment. */
+static uint8_t HeadOffset;
+
+/** Number of times the head segment has been written, including the current write. */
+static uint16_t HeadEraseCount;
+
+/** Sequence number of the most recently written segment summary. */
+static uint32_t LastSequence;
+
+/** Number of free segments following the head segment, which may be written once the head segment is full. */
+static uint16_t FreeSegments;
+
+/** Number of segments following the free segments which have been cleaned, but which may still be referenced by the last
+ *  written segment summary. These become free segments once the head segment's summary has been written.
+ */
+static uint16_t PendingFreeSegments;
+
+/** Mask of the dataflash ICs which may still be programming a page, one bit per IC. */
+static uint8_t ProgrammingChips = ((1 << DATAFLASH_TOTALCHIPS) - 1);
+
+/** Mask of the dataflash ICs whose next page is to be filled into the IC's second SRAM buffer, one bit per IC. The other
+ *  buffer may still be being programmed into the dataflash in the background.
+ */
+static uint8_t SecondBufferChips;
+
+/** Indicates if pages have been written since the last segment summary, and so must be committed on a flush. */
+static bool CheckpointPending;
+
+/** Indicates if the dataflash has run out of free segments, preventing any further writes. */
+static bool MediaFull;
+
+/** Selects the dataflash IC containing the given physical page, ready for a new command.
+ *
+ *  \param[in] PhysicalPage  Physical dataflash page address which is to be accessed
+ *
+ *  \return Index of the selected dataflash IC, from 0 to (DATAFLASH_TOTALCHIPS - 1)
+ */
+static uint8_t DataflashFTL_SelectPage(const uint16_t PhysicalPage)
+{
+	Dataflash_SelectChipFromPage(PhysicalPage);
+
+	return (Dataflash_GetSelectedChip() == DATAFLASH_CHIP_MASK(DATAFLASH_TOTALCHIPS)) ? (DATAFLASH_TOTALCHIPS - 1) : 0;
+}
+
+/** Reads bytes from a physical page of the dataflash main memory into RAM, once any running page program has completed.
+ *
+ *  \param[in]  PhysicalPage  Physical dataflash page address to read from
+ *  \param[in]  PageByte      Starting byte within the page to read from
+ *  \param[out] Buffer        Pointer to the buffer to store the read bytes into
+ *  \param[in]  Length        Number of bytes to read
+ */
+static void DataflashFTL_ReadPage(const uint16_t PhysicalPage, const uint16_t PageByte, void* Buffer, const uint16_t Length)
+{
+	uint8_t* BufferPtr = (uint8_t*)Buffer;
+
+	DataflashFTL_SelectPage(PhysicalPage);
+	Dataflash_WaitWhileBusy();
+
+	/* Send the dataflash main memory page read command */
+	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+	Dataflash_SendAddressBytes(PhysicalPage, PageByte);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+
+	for (uint16_t ByteNum = 0; ByteNum < Length; ByteNum++)
+	  *(BufferPtr++) = Dataflash_ReceiveByte();
+
+	Dataflash_DeselectChip();
+}
+
+/** Preloads the SRAM buffer of the dataflash IC containing the given physical page with the contents of an existing page,
+ *  so that the new page may be partially written. This is not required when the entire page is to be written.
+ *
+ *  \param[in] PhysicalPage  Physical dataflash page address which is to be programmed
+ *  \param[in] SourcePage    Physical dataflash page whose contents are to be preloaded, or \ref DATAFLASH_FTL_NO_PAGE to
+ *                           preload the buffer with erased (0xFF) data
+ */
+static void DataflashFTL_OpenPageBuffer(const uint16_t PhysicalPage, const uint16_t SourcePage)
+{
+	if (SourcePage == DATAFLASH_FTL_NO_PAGE)
+	{
+		DataflashFTL_WritePageBuffer(PhysicalPage, 0);
+
+		for (uint16_t ByteNum = 0; ByteNum < DATAFLASH_PAGE_SIZE; ByteNum++)
+		  Dataflash_SendByte(0xFF);
+
+		Dataflash_DeselectChip();
+		return;
+	}
+
+	uint8_t ChipIndex = DataflashFTL_SelectPage(PhysicalPage);
+	uint8_t ChipMask  = Dataflash_GetSelectedChip();
+
+	DataflashFTL_SelectPage(SourcePage);
+
+	if (Dataflash_GetSelectedChip() == ChipMask)
+	{
+		/* Source page is within the same dataflash IC, copy it to the buffer once any running page program completes */
+		Dataflash_WaitWhileBusy();
+		Dataflash_SendByte((SecondBufferChips & (1 << ChipIndex)) ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
+		Dataflash_SendAddressBytes(SourcePage, 0);
+		Dataflash_WaitWhileBusy();
+	}
+	else
+	{
+		uint8_t Chunk[16];
+
+		/* Source page is within a different dataflash IC, copy it between the ICs in small chunks */
+		for (uint16_t PageByte = 0; PageByte < DATAFLASH_PAGE_SIZE; PageByte += sizeof(Chunk))
+		{
+			DataflashFTL_ReadPage(SourcePage, PageByte, Chunk, sizeof(Chunk));
+			DataflashFTL_WritePageBuffer(PhysicalPage, PageByte);
+
+			for (uint8_t ByteNum = 0; ByteNum < sizeof(Chunk); ByteNum++)
+			  Dataflash_SendByte(Chunk[ByteNum]);
+		}
+	}
+
+	Dataflash_DeselectChip();
+}
+
+/** Selects the dataflash IC containing the given physical page and sends the buffer write command, so that the page's
+ *  contents can be written into the IC's SRAM buffer opened by \ref DataflashFTL_OpenPageBuffer().
+ *
+ *  \param[in] PhysicalPage  Physical dataflash page address which is to be programmed
+ *  \param[in] PageByte      Starting byte within the page to write to
+ */
+static void DataflashFTL_WritePageBuffer(const uint16_t PhysicalPage, const uint16_t PageByte)
+{
+	uint8_t ChipIndex = DataflashFTL_SelectPage(PhysicalPage);
+
+	Dataflash_SendByte((SecondBufferChips & (1 << ChipIndex)) ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, PageByte);
+}
+
+/** Starts programming the filled SRAM buffer of the dataflash IC containing the given physical page into the page, once any
+ *  running page program of the IC has completed. The page program is not waited on, and the IC's other buffer is used for
+ *  the next page so that it may be filled while the program completes in the background.
+ *
+ *  \param[in] PhysicalPage  Physical dataflash page address which is to be programmed
+ */
+static void DataflashFTL_ProgramPage(const uint16_t PhysicalPage)
+{
+	uint8_t ChipIndex = DataflashFTL_SelectPage(PhysicalPage);
+
+	Dataflash_WaitWhileBusy();
+
+	/* Send the dataflash buffer to main memory page program command */
+	Dataflash_SendByte((SecondBufferChips & (1 << ChipIndex)) ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(PhysicalPage, 0);
+	Dataflash_DeselectChip();
+
+	SecondBufferChips ^= (1 << ChipIndex);
+	ProgrammingChips  |= (1 << ChipIndex);
+}
+
+/** Adds the given bytes to a running segment summary checksum, used to detect summaries which were not completely written.
+ *
+ *  \param[in] Checksum  Current value of the running checksum
+ *  \param[in] Data      Pointer to the bytes to add to the checksum
+ *  \param[in] Length    Number of bytes to add to the checksum
+ *
+ *  \return Updated value of the running checksum
+ */
+static uint16_t DataflashFTL_UpdateChecksum(uint16_t Checksum, const void* Data, const uint16_t Length)
+{
+	const uint8_t* DataPtr = (const uint8_t*)Data;
+
+	for (uint16_t ByteNum = 0; ByteNum < Length; ByteNum++)
+	  Checksum = ((Checksum << 1) | (Checksum >> 15)) + *(DataPtr++);
+
+	return Checksum;
+}
+
+/** Sends the given bytes of a segment summary to the dataflash buffer opened by \ref DataflashFTL_WritePageBuffer(),
+ *  adding them to the summary's running checksum.
+ *
+ *  \param[in]     Data      Pointer to the summary bytes to send
+ *  \param[in]     Length    Number of bytes to send
+ *  \param[in,out] Checksum  Pointer to the summary's running checksum
+ */
+static void DataflashFTL_WriteSummaryData(const void* Data, const uint16_t Length, uint16_t* const Checksum)
+{
+	const uint8_t* DataPtr = (const uint8_t*)Data;
+
+	for (uint16_t ByteNum = 0; ByteNum < Length; ByteNum++)
+	  Dataflash_SendByte(DataPtr[ByteNum]);
+
+	*Checksum = DataflashFTL_UpdateChecksum(*Checksum, Data, Length);
+}
+
+/** Reads the header of the given segment's summary from the dataflash.
+ *
+ *  \param[in]  Segment  Index of the segment whose summary header is to be read
+ *  \param[out] Header   Pointer to the location where the summary header is to be stored
+ *
+ *  \return Boolean true if the segment contains a summary written by the FTL, false otherwise
+ */
+static bool DataflashFTL_ReadSummaryHeader(const uint16_t Segment, DataflashFTL_SummaryHeader_t* const Header)
+{
+	DataflashFTL_ReadPage(DATAFLASH_FTL_SUMMARY_PAGE(Segment), 0, Header, sizeof(DataflashFTL_SummaryHeader_t));
+
+	return (Header->Signature == DATAFLASH_FTL_SUMMARY_SIGNATURE);
+}
+
+/** Verifies the checksum of the given segment's summary, to determine if the summary was completely written.
+ *
+ *  \param[in] Segment  Index of the segment whose summary is to be verified
+ *
+ *  \return Boolean true if the summary is complete, false otherwise
+ */
+static bool DataflashFTL_VerifySummary(const uint16_t Segment)
+{
+	uint8_t  Chunk[16];
+	uint16_t Checksum = DATAFLASH_FTL_SUMMARY_SIGNATURE;
+	uint16_t StoredChecksum;
+
+	for (uint16_t PageByte = 0; PageByte < offsetof(DataflashFTL_SegmentSummary_t, Checksum); PageByte += sizeof(Chunk))
+	{
+		uint16_t ChunkLength = (offsetof(DataflashFTL_SegmentSummary_t, Checksum) - PageByte);
+
+		if (ChunkLength > sizeof(Chunk))
+		  ChunkLength = sizeof(Chunk);
+
+		DataflashFTL_ReadPage(DATAFLASH_FTL_SUMMARY_PAGE(Segment), PageByte, Chunk, ChunkLength);
+		Checksum = DataflashFTL_UpdateChecksum(Checksum, Chunk, ChunkLength);
+	}
+
+	DataflashFTL_ReadPage(DATAFLASH_FTL_SUMMARY_PAGE(Segment), offsetof(DataflashFTL_SegmentSummary_t, Checksum),
+	                      &StoredChecksum, sizeof(StoredChecksum));
+
+	return (StoredChecksum == Checksum);
+}
+
+/** Advances the head of the log to the next free segment, ready for its pages to be written.
+ *
+ *  \return Boolean true if a free segment was available, false if the dataflash is full
+ */
+static bool DataflashFTL_OpenNextSegment(void)
+{
+	DataflashFTL_SummaryHeader_t Header;
+
+	if (!(FreeSegments))
+	{
+		MediaFull = true;
+		return false;
+	}
+
+	FreeSegments--;
+
+	if (++HeadSegment == DATAFLASH_FTL_TOTAL_SEGMENTS)
+	  HeadSegment = 0;
+
+	/* Retrieve the wear count of the new head segment from its previous summary, if any */
+	HeadEraseCount = DataflashFTL_ReadSummaryHeader(HeadSegment, &Header) ? (Header.EraseCount + 1) : 1;
+	HeadOffset     = 0;
+
+	memset(HeadOwners, 0xFF, sizeof(HeadOwners));
+
+	return true;
+}
+
+/** Writes the summary of the head segment, checkpointing the translation state, and advances the head of the log to the
+ *  next free segment.
+ *
+ *  \return Boolean true if a free segment was available for the new head, false if the dataflash is full
+ */
+static bool DataflashFTL_CloseSegment(void)
+{
+	DataflashFTL_SummaryHeader_t Header;
+	uint16_t Checksum = DATAFLASH_FTL_SUMMARY_SIGNATURE;
+
+	/* Segments cleaned since the last summary are no longer referenced once this summary is written */
+	FreeSegments       += PendingFreeSegments;
+	PendingFreeSegments = 0;
+
+	Header.Sequence       = ++LastSequence;
+	Header.Signature      = DATAFLASH_FTL_SUMMARY_SIGNATURE;
+	Header.EraseCount     = HeadEraseCount;
+	Header.FreeSegments   = FreeSegments;
+	Header.JournalEntries = JournalEntries;
+
+	/* Send the summary directly from the translation state into the last page of the head segment */
+	DataflashFTL_WritePageBuffer(DATAFLASH_FTL_SUMMARY_PAGE(HeadSegment), 0);
+	DataflashFTL_WriteSummaryData(&Header, sizeof(Header), &Checksum);
+	DataflashFTL_WriteSummaryData(MapDirectory, sizeof(MapDirectory), &Checksum);
+	DataflashFTL_WriteSummaryData(Journal, sizeof(Journal), &Checksum);
+	DataflashFTL_WriteSummaryData(HeadOwners, sizeof(HeadOwners), &Checksum);
+	Dataflash_SendByte(Checksum & 0xFF);
+	Dataflash_SendByte(Checksum >> 8);
+
+	DataflashFTL_ProgramPage(DATAFLASH_FTL_SUMMARY_PAGE(HeadSegment));
+
+	CheckpointPending = false;
+
+	return DataflashFTL_OpenNextSegment();
+}
+
+/** Allocates the next free page at the head of the log, closing the head segment if it is full.
+ *
+ *  \param[in] Owner  Logical page or map page tag which is to be stored in the allocated page
+ *
+ *  \return Physical address of the allocated dataflash page, or \ref DATAFLASH_FTL_NO_PAGE if the dataflash is full
+ */
+static uint16_t DataflashFTL_AllocatePage(const uint16_t Owner)
+{
+	if (MediaFull)
+	  return DATAFLASH_FTL_NO_PAGE;
+
+	if ((HeadOffset == DATAFLASH_FTL_DATA_PAGES) && !(DataflashFTL_CloseSegment()))
+	  return DATAFLASH_FTL_NO_PAGE;
+
+	HeadOwners[HeadOffset] = Owner;
+	CheckpointPending      = true;
+
+	return ((HeadSegment * DATAFLASH_FTL_SEGMENT_PAGES) + HeadOffset++);
+}
+
+/** Retrieves the physical dataflash page currently holding the given logical page.
+ *
+ *  \param[in] LogicalPage  Logical page to look up
+ *
+ *  \return Physical dataflash page address of the logical page, or \ref DATAFLASH_FTL_NO_PAGE if it has never been written
+ */
+static uint16_t DataflashFTL_LookupPage(const uint16_t LogicalPage)
+{
+	uint16_t PhysicalPage;
+
+	/* Recent mapping changes are held in the journal until they are committed to the map pages */
+	for (uint8_t EntryIndex = 0; EntryIndex < JournalEntries; EntryIndex++)
+	{
+		if (Journal[EntryIndex].LogicalPage == LogicalPage)
+		  return Journal[EntryIndex].PhysicalPage;
+	}
+
+	uint16_t MapPage = MapDirectory[LogicalPage / DATAFLASH_FTL_MAP_ENTRIES];
+
+	if (MapPage == DATAFLASH_FTL_NO_PAGE)
+	  return DATAFLASH_FTL_NO_PAGE;
+
+	DataflashFTL_ReadPage(MapPage, ((LogicalPage % DATAFLASH_FTL_MAP_ENTRIES) * sizeof(uint16_t)),
+	                      &PhysicalPage, sizeof(PhysicalPage));
+
+	return PhysicalPage;
+}
+
+/** Frees space in the journal, by writing the journal's mapping changes for the map page with the most pending changes
+ *  to a new copy of the map page at the head of the log.
+ *
+ *  \return Boolean true if the journal entries were committed, false if the dataflash is full
+ */
+static bool DataflashFTL_CommitJournal(void)
+{
+	uint8_t MapIndex     = 0;
+	uint8_t MapIndexHits = 0;
+
+	/* Find the map page covering the most journal entries, so that each map page write frees as many entries as possible */
+	for (uint8_t EntryIndex = 0; EntryIndex < JournalEntries; EntryIndex++)
+	{
+		uint8_t EntryMapIndex = (Journal[EntryIndex].LogicalPage / DATAFLASH_FTL_MAP_ENTRIES);
+		uint8_t Hits          = 0;
+
+		for (uint8_t CompareIndex = EntryIndex; CompareIndex < JournalEntries; CompareIndex++)
+		{
+			if ((Journal[CompareIndex].LogicalPage / DATAFLASH_FTL_MAP_ENTRIES) == EntryMapIndex)
+			  Hits++;
+		}
+
+		if (Hits > MapIndexHits)
+		{
+			MapIndex     = EntryMapIndex;
+			MapIndexHits = Hits;
+		}
+	}
+
+	uint16_t MapPage = DataflashFTL_AllocatePage(DATAFLASH_FTL_MAP_OWNER(MapIndex));
+
+	if (MapPage == DATAFLASH_FTL_NO_PAGE)
+	  return false;
+
+	/* Start from the existing contents of the map page, or an empty map page if it has never been written */
+	DataflashFTL_OpenPageBuffer(MapPage, MapDirectory[MapIndex]);
+
+	/* Apply and remove all journal entries for logical pages covered by the map page */
+	uint8_t EntryIndex = 0;
+
+	while (EntryIndex < JournalEntries)
+	{
+		DataflashFTL_JournalEntry_t* Entry = &Journal[EntryIndex];
+
+		if ((Entry->LogicalPage / DATAFLASH_FTL_MAP_ENTRIES) != MapIndex)
+		{
+			EntryIndex++;
+			continue;
+		}
+
+		DataflashFTL_WritePageBuffer(MapPage, ((Entry->LogicalPage % DATAFLASH_FTL_MAP_ENTRIES) * sizeof(uint16_t)));
+		Dataflash_SendByte(Entry->PhysicalPage & 0xFF);
+		Dataflash_SendByte(Entry->PhysicalPage >> 8);
+
+		*Entry = Journal[--JournalEntries];
+	}
+
+	DataflashFTL_ProgramPage(MapPage);
+
+	MapDirectory[MapIndex] = MapPage;
+
+	return true;
+}
+
+/** Records a new physical location for the given logical page in the journal, committing the journal first if it is full.
+ *
+ *  \param[in] LogicalPage   Logical page whose location has changed
+ *  \param[in] PhysicalPage  New physical dataflash page address of the logical page
+ *
+ *  \return Boolean true if the mapping was updated, false if the dataflash is full
+ */
+static bool DataflashFTL_UpdateMapping(const uint16_t LogicalPage, const uint16_t PhysicalPage)
+{
+	for (uint8_t EntryIndex = 0; EntryIndex < JournalEntries; EntryIndex++)
+	{
+		if (Journal[EntryIndex].LogicalPage == LogicalPage)
+		{
+			Journal[EntryIndex].PhysicalPage = PhysicalPage;
+			return true;
+		}
+	}
+
+	if ((JournalEntries == DATAFLASH_FTL_JOURNAL_ENTRIES) && !(DataflashFTL_CommitJournal()))
+	  return false;
+
+	Journal[JournalEntries].LogicalPage  = LogicalPage;
+	Journal[JournalEntries].PhysicalPage = PhysicalPage;
+	JournalEntries++;
+
+	return true;
+}
+
+/** Cleans the oldest segment of the log (the tail), by moving any of its pages which are still in use to the head of the
+ *  log. The cleaned segment becomes free once the next segment summary has been written.
+ *
+ *  \return Boolean true if the segment was cleaned, false if the dataflash is full
+ */
+static bool DataflashFTL_CleanTailSegment(void)
+{
+	DataflashFTL_SummaryHeader_t Header;
+	uint16_t Owners[DATAFLASH_FTL_DATA_PAGES];
+
+	uint16_t TailSegment = ((HeadSegment + FreeSegments + PendingFreeSegments + 1) % DATAFLASH_FTL_TOTAL_SEGMENTS);
+
+	if (TailSegment == HeadSegment)
+	  return true;
+
+	uint16_t FirstPage = (TailSegment * DATAFLASH_FTL_SEGMENT_PAGES);
+
+	/* Segments which have never been summarized contain no pages in use */
+	if (DataflashFTL_ReadSummaryHeader(TailSegment, &Header))
+	{
+		DataflashFTL_ReadPage(DATAFLASH_FTL_SUMMARY_PAGE(TailSegment), offsetof(DataflashFTL_SegmentSummary_t, Owners),
+		                      Owners, sizeof(Owners));
+
+		for (uint8_t PageIndex = 0; PageIndex < DATAFLASH_FTL_DATA_PAGES; PageIndex++)
+		{
+			uint16_t Owner     = Owners[PageIndex];
+			uint16_t OldPage   = (FirstPage + PageIndex);
+			uint8_t  MapIndex  = (Owner & 0xFF);
+			bool     IsMapPage = (Owner >= DATAFLASH_FTL_MAP_OWNER(0));
+			bool     IsCurrent;
+
+			/* Only move pages which are still the current location of their logical page or map page */
+			if (Owner == DATAFLASH_FTL_NO_PAGE)
+			  IsCurrent = false;
+			else if (IsMapPage)
+			  IsCurrent = ((MapIndex < DATAFLASH_FTL_MAP_PAGES) && (MapDirectory[MapIndex] == OldPage));
+			else
+			  IsCurrent = ((Owner < DATAFLASH_FTL_LOGICAL_PAGES) && (DataflashFTL_LookupPage(Owner) == OldPage));
+
+			if (!(IsCurrent))
+			  continue;
+
+			uint16_t NewPage = DataflashFTL_AllocatePage(Owner);
+
+			if (NewPage == DATAFLASH_FTL_NO_PAGE)
+			  return false;
+
+			DataflashFTL_OpenPageBuffer(NewPage, OldPage);
+			DataflashFTL_ProgramPage(NewPage);
+
+			if (IsMapPage)
+			  MapDirectory[MapIndex] = NewPage;
+			else if (!(DataflashFTL_UpdateMapping(Owner, NewPage)))
+			  return false;
+		}
+	}
+
+	PendingFreeSegments++;
+	return true;
+}
+
+/** Allocates a new physical page for the given logical page and opens it for writing, cleaning segments as needed so that
+ *  free segments remain available. Once this function returns the dataflash buffer write command has been sent, so that the
+ *  new page data can be sent directly to the dataflash.
+ *
+ *  \param[in] LogicalPage      Logical page which is to be written
+ *  \param[in] FirstBlock       Index of the first block within the page which is to be written
+ *  \param[in] TotalPageBlocks  Number of blocks within the page which are to be written
+ *
+ *  \return Physical address of the dataflash page being written, or \ref DATAFLASH_FTL_NO_PAGE if the dataflash is full
+ */
+static uint16_t DataflashFTL_BeginPageWrite(const uint16_t LogicalPage, const uint8_t FirstBlock,
+                                            const uint8_t TotalPageBlocks)
+{
+	while ((FreeSegments + PendingFreeSegments) < DATAFLASH_FTL_MIN_FREE_SEGMENTS)
+	{
+		if (!(DataflashFTL_CleanTailSegment()))
+		  return DATAFLASH_FTL_NO_PAGE;
+	}
+
+	uint16_t PhysicalPage = DataflashFTL_AllocatePage(LogicalPage);
+
+	if (PhysicalPage == DATAFLASH_FTL_NO_PAGE)
+	  return DATAFLASH_FTL_NO_PAGE;
+
+	/* If only part of the page is written, the rest of the page must be preserved from its current location */
+	if (TotalPageBlocks < DATAFLASH_FTL_BLOCKS_PER_PAGE)
+	  DataflashFTL_OpenPageBuffer(PhysicalPage, DataflashFTL_LookupPage(LogicalPage));
+	DataflashFTL_WritePageBuffer(PhysicalPage, (FirstBlock * BLOCKDEV_BLOCK_SIZE));
+
+	return PhysicalPage;
+}
+
+/** Completes the write of a page opened by \ref DataflashFTL_BeginPageWrite(), by starting the page program and recording the
+ *  logical page's new location.
+ *
+ *  \param[in] LogicalPage   Logical page which has been written
+ *  \param[in] PhysicalPage  Physical page the logical page was written to
+ *
+ *  \return Boolean true if the write was completed, false if the dataflash is full
+ */
+static bool DataflashFTL_EndPageWrite(const uint16_t LogicalPage, const uint16_t PhysicalPage)
+{
+	DataflashFTL_ProgramPage(PhysicalPage);
+
+	return DataflashFTL_UpdateMapping(LogicalPage, PhysicalPage);
+}
+
+/** Starts a main memory read of the physical page holding the given logical page, so that the page data can be read directly
+ *  from the dataflash.
+ *
+ *  \param[in] LogicalPage  Logical page which is to be read
+ *  \param[in] FirstBlock   Index of the first block within the page which is to be read
+ *
+ *  \return Boolean true if the read was started, false if the logical page has never been written
+ */
+static bool DataflashFTL_BeginPageRead(const uint16_t LogicalPage, const uint8_t FirstBlock)
+{
+	uint16_t PhysicalPage = DataflashFTL_LookupPage(LogicalPage);
+
+	if (PhysicalPage == DATAFLASH_FTL_NO_PAGE)
+	  return false;
+
+	DataflashFTL_SelectPage(PhysicalPage);
+	Dataflash_WaitWhileBusy();
+
+	/* Send the dataflash main memory page read command */
+	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+	Dataflash_SendAddressBytes(PhysicalPage, (FirstBlock * BLOCKDEV_BLOCK_SIZE));
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+
+	return true;
+}
+
+/** Restores the translation state from the most recent complete segment summary in the dataflash, or starts a new empty
+ *  log if no summaries are present.
+ */
+static void DataflashFTL_Mount(void)
+{
+	DataflashFTL_SummaryHeader_t Header;
+	uint32_t SequenceLimit = 0xFFFFFFFF;
+	uint16_t LatestSegment;
+
+	SecondBufferChips   = 0;
+	PendingFreeSegments = 0;
+	CheckpointPending   = false;
+	MediaFull           = false;
+
+	for (;;)
+	{
+		uint32_t LatestSequence = 0;
+
+		LatestSegment = DATAFLASH_FTL_NO_PAGE;
+
+		/* Find the most recently written segment summary, skipping any summaries found to be incomplete */
+		for (uint16_t Segment = 0; Segment < DATAFLASH_FTL_TOTAL_SEGMENTS; Segment++)
+		{
+			if (DataflashFTL_ReadSummaryHeader(Segment, &Header) &&
+			    (Header.Sequence > LatestSequence) && (Header.Sequence < SequenceLimit))
+			{
+				LatestSegment  = Segment;
+				LatestSequence = Header.Sequence;
+			}
+		}
+
+		if ((LatestSegment == DATAFLASH_FTL_NO_PAGE) || DataflashFTL_VerifySummary(LatestSegment))
+		  break;
+
+		SequenceLimit = LatestSequence;
+	}
+
+	if (LatestSegment == DATAFLASH_FTL_NO_PAGE)
+	{
+		/* No summaries found, start a new empty log at the first segment */
+		memset(MapDirectory, 0xFF, sizeof(MapDirectory));
+		JournalEntries = 0;
+		LastSequence   = 0;
+		HeadSegment    = (DATAFLASH_FTL_TOTAL_SEGMENTS - 1);
+		FreeSegments   = DATAFLASH_FTL_TOTAL_SEGMENTS;
+	}
+	else
+	{
+		/* Restore the checkpointed state, and continue the log at the segment following the summarized segment */
+		uint16_t SummaryPage = DATAFLASH_FTL_SUMMARY_PAGE(LatestSegment);
+
+		DataflashFTL_ReadSummaryHeader(LatestSegment, &Header);
+		DataflashFTL_ReadPage(SummaryPage, offsetof(DataflashFTL_SegmentSummary_t, MapDirectory),
+		                      MapDirectory, sizeof(MapDirectory));
+		DataflashFTL_ReadPage(SummaryPage, offsetof(DataflashFTL_SegmentSummary_t, Journal), Journal, sizeof(Journal));
+
+		JournalEntries = Header.JournalEntries;
+		LastSequence   = Header.Sequence;
+		HeadSegment    = LatestSegment;
+		FreeSegments   = Header.FreeSegments;
+	}
+
+	DataflashFTL_OpenNextSegment();
+}
+
+uint8_t BlockDevice_Init(void)
+{
+	/* Select first dataflash chip, send the read status register command */
+	Dataflash_SelectChip(DATAFLASH_CHIP1);
+	Dataflash_SendByte(DF_CMD_GETSTATUS);
+	
+	/* Check if sector protection is enabled */
+	if (Dataflash_ReceiveByte() & DF_STATUS_SECTORPROTECTION_ON)
+	{
+		Dataflash_ToggleSelectedChipCS();
+
+		/* Send the commands to disable sector protection */
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[0]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[1]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[2]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[3]);
+	}
+	
+	/* Select second dataflash chip (if present on selected board), send read status register command */
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	Dataflash_SelectChip(DATAFLASH_CHIP2);
+	Dataflash_SendByte(DF_CMD_GETSTATUS);
+	
+	/* Check if sector protection is enabled */
+	if (Dataflash_ReceiveByte() & DF_STATUS_SECTORPROTECTION_ON)
+	{
+		Dataflash_ToggleSelectedChipCS();
+
+		/* Send the commands to disable sector protection */
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[0]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[1]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[2]);
+		Dataflash_SendByte(DF_CMD_SECTORPROTECTIONOFF[3]);
+	}
+	#endif
+	
+	/* Deselect current dataflash chip */
+	Dataflash_DeselectChip();
+
+	/* Restore the translation state from the dataflash */
+	DataflashFTL_Mount();
+	
+	return (MediaFull ? BLOCKDEV_ERROR_DeviceError : BLOCKDEV_ERROR_NoError);
+}
+
+uint8_t BlockDevice_GetCapabilities(void)
+{
+	return (BLOCKDEV_CAP_WRITABLE | BLOCKDEV_CAP_ASYNC_WRITES | BLOCKDEV_CAP_WRITE_CACHE);
+}
+
+uint32_t BlockDevice_GetTotalBlocks(void)
+{
+	return DATAFLASH_FTL_TOTAL_BLOCKS;
+}
+
+#if defined(USB_CAN_BE_DEVICE)
+uint8_t BlockDevice_WriteBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                         const volatile bool* const AbortFlag)
+{
+	uint16_t LogicalPage = (BlockAddress / DATAFLASH_FTL_BLOCKS_PER_PAGE);
+	uint8_t  PageBlock   = (BlockAddress % DATAFLASH_FTL_BLOCKS_PER_PAGE);
+
+	/* Check that all the requested blocks lie within the storage medium */
+	if ((BlockAddress + TotalBlocks) > DATAFLASH_FTL_TOTAL_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+
+	while (TotalBlocks)
+	{
+		uint8_t PageBlocks = (DATAFLASH_FTL_BLOCKS_PER_PAGE - PageBlock);
+
+		if (PageBlocks > TotalBlocks)
+		  PageBlocks = TotalBlocks;
+
+		/* Allocate a new dataflash page for the logical page, and open it for writing */
+		uint16_t PhysicalPage = DataflashFTL_BeginPageWrite(LogicalPage, PageBlock, PageBlocks);
+
+		if (PhysicalPage == DATAFLASH_FTL_NO_PAGE)
+		  return BLOCKDEV_ERROR_DeviceError;
+
+		for (uint16_t ChunkNum = 0; ChunkNum < (PageBlocks * (BLOCKDEV_BLOCK_SIZE >> 4)); ChunkNum++)
+		{
+			/* Check if the endpoint is currently empty */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the current endpoint bank */
+				Endpoint_ClearOUT();
+				
+				/* Wait until the host has sent another packet */
+				if (Endpoint_WaitUntilReady())
+				{
+					Dataflash_DeselectChip();
+					return BLOCKDEV_ERROR_EndpointError;
+				}
+			}
+
+			/* Write one 16-byte chunk of data to the dataflash */
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+			Dataflash_SendByte(Endpoint_Read_Byte());
+
+			/* Check if the current transfer is being aborted, abandoning the partially written page */
+			if ((AbortFlag != NULL) && *AbortFlag)
+			{
+				Dataflash_DeselectChip();
+				return BLOCKDEV_ERROR_Aborted;
+			}
+		}
+
+		/* Program the new page and record the logical page's new location */
+		if (!(DataflashFTL_EndPageWrite(LogicalPage, PhysicalPage)))
+		  return BLOCKDEV_ERROR_DeviceError;
+
+		TotalBlocks -= PageBlocks;
+		LogicalPage++;
+		PageBlock    = 0;
+	}
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                        const volatile bool* const AbortFlag)
+{
+	uint16_t LogicalPage = (BlockAddress / DATAFLASH_FTL_BLOCKS_PER_PAGE);
+	uint8_t  PageBlock   = (BlockAddress % DATAFLASH_FTL_BLOCKS_PER_PAGE);
+
+	/* Check that all the requested blocks lie within the storage medium */
+	if ((BlockAddress + TotalBlocks) > DATAFLASH_FTL_TOTAL_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+
+	while (TotalBlocks)
+	{
+		uint8_t PageBlocks = (DATAFLASH_FTL_BLOCKS_PER_PAGE - PageBlock);
+
+		if (PageBlocks > TotalBlocks)
+		  PageBlocks = TotalBlocks;
+
+		/* Start reading the page's current location, unwritten pages are returned as erased (0xFF) data */
+		bool IsPageWritten = DataflashFTL_BeginPageRead(LogicalPage, PageBlock);
+
+		for (uint16_t ChunkNum = 0; ChunkNum < (PageBlocks * (BLOCKDEV_BLOCK_SIZE >> 4)); ChunkNum++)
+		{
+			/* Check if the endpoint is currently full */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the endpoint bank to send its contents to the host */
+				Endpoint_ClearIN();
+				
+				/* Wait until the endpoint is ready for more data */
+				if (Endpoint_WaitUntilReady())
+				{
+					Dataflash_DeselectChip();
+					return BLOCKDEV_ERROR_EndpointError;
+				}
+			}
+
+			if (IsPageWritten)
+			{
+				/* Read one 16-byte chunk of data from the dataflash */
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+				Endpoint_Write_Byte(Dataflash_ReceiveByte());
+			}
+			else
+			{
+				for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+				  Endpoint_Write_Byte(0xFF);
+			}
+
+			/* Check if the current transfer is being aborted */
+			if ((AbortFlag != NULL) && *AbortFlag)
+			{
+				Dataflash_DeselectChip();
+				return BLOCKDEV_ERROR_Aborted;
+			}
+		}
+
+		Dataflash_DeselectChip();
+
+		TotalBlocks -= PageBlocks;
+		LogicalPage++;
+		PageBlock    = 0;
+	}
+
+	/* If the endpoint is full, send its contents to the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	return BLOCKDEV_ERROR_NoError;
+}
+#endif
+
+uint8_t BlockDevice_WriteBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, const uint8_t* BufferPtr)
+{
+	uint16_t LogicalPage = (BlockAddress / DATAFLASH_FTL_BLOCKS_PER_PAGE);
+	uint8_t  PageBlock   = (BlockAddress % DATAFLASH_FTL_BLOCKS_PER_PAGE);
+
+	/* Check that all the requested blocks lie within the storage medium */
+	if ((BlockAddress + TotalBlocks) > DATAFLASH_FTL_TOTAL_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	while (TotalBlocks)
+	{
+		uint8_t PageBlocks = (DATAFLASH_FTL_BLOCKS_PER_PAGE - PageBlock);
+
+		if (PageBlocks > TotalBlocks)
+		  PageBlocks = TotalBlocks;
+
+		/* Allocate a new dataflash page for the logical page, and open it for writing */
+		uint16_t PhysicalPage = DataflashFTL_BeginPageWrite(LogicalPage, PageBlock, PageBlocks);
+
+		if (PhysicalPage == DATAFLASH_FTL_NO_PAGE)
+		  return BLOCKDEV_ERROR_DeviceError;
+
+		for (uint16_t ByteNum = 0; ByteNum < (PageBlocks * BLOCKDEV_BLOCK_SIZE); ByteNum++)
+		  Dataflash_SendByte(*(BufferPtr++));
+
+		/* Program the new page and record the logical page's new location */
+		if (!(DataflashFTL_EndPageWrite(LogicalPage, PhysicalPage)))
+		  return BLOCKDEV_ERROR_DeviceError;
+
+		TotalBlocks -= PageBlocks;
+		LogicalPage++;
+		PageBlock    = 0;
+	}
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_ReadBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, uint8_t* BufferPtr)
+{
+	uint16_t LogicalPage = (BlockAddress / DATAFLASH_FTL_BLOCKS_PER_PAGE);
+	uint8_t  PageBlock   = (BlockAddress % DATAFLASH_FTL_BLOCKS_PER_PAGE);
+
+	/* Check that all the requested blocks lie within the storage medium */
+	if ((BlockAddress + TotalBlocks) > DATAFLASH_FTL_TOTAL_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	while (TotalBlocks)
+	{
+		uint8_t PageBlocks = (DATAFLASH_FTL_BLOCKS_PER_PAGE - PageBlock);
+
+		if (PageBlocks > TotalBlocks)
+		  PageBlocks = TotalBlocks;
+
+		/* Read the page's current location, unwritten pages are returned as erased (0xFF) data */
+		if (DataflashFTL_BeginPageRead(LogicalPage, PageBlock))
+		{
+			for (uint16_t ByteNum = 0; ByteNum < (PageBlocks * BLOCKDEV_BLOCK_SIZE); ByteNum++)
+			  *(BufferPtr++) = Dataflash_ReceiveByte();
+
+			Dataflash_DeselectChip();
+		}
+		else
+		{
+			memset(BufferPtr, 0xFF, (PageBlocks * BLOCKDEV_BLOCK_SIZE));
+			BufferPtr += (PageBlocks * BLOCKDEV_BLOCK_SIZE);
+		}
+
+		TotalBlocks -= PageBlocks;
+		LogicalPage++;
+		PageBlock    = 0;
+	}
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_Flush(void)
+{
+	/* Write a segment summary to make all written pages and mapping changes permanent */
+	if (CheckpointPending && !(DataflashFTL_CloseSegment()))
+	  return BLOCKDEV_ERROR_DeviceError;
+
+	/* Wait for any running page programs to complete */
+	while (BlockDevice_IsBusy());
+	
+	return BLOCKDEV_ERROR_NoError;
+}
+
+bool BlockDevice_IsBusy(void)
+{
+	/* Check if the first dataflash IC is still programming a page, if one was started */
+	if (ProgrammingChips & (1 << 0))
+	{
+		Dataflash_SelectChip(DATAFLASH_CHIP1);
+
+		if (!(Dataflash_IsBusy()))
+		  ProgrammingChips &= ~(1 << 0);
+	}
+
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	/* Check if the second dataflash IC is still programming a page, if one was started */
+	if (ProgrammingChips & (1 << 1))
+	{
+		Dataflash_SelectChip(DATAFLASH_CHIP2);
+
+		if (!(Dataflash_IsBusy()))
+		  ProgrammingChips &= ~(1 << 1);
+	}
+	#endif
+
+	/* Deselect current dataflash chip */
+	Dataflash_DeselectChip();
+	
+	return (ProgrammingChips != 0);
+}
+
+bool BlockDevice_CheckOperation(void)
+{
+	uint8_t ReturnByte;
+
+	/* Test first Dataflash IC is present and responding to commands */
+	Dataflash_SelectChip(DATAFLASH_CHIP1);
+	Dataflash_SendByte(DF_CMD_READMANUFACTURERDEVICEINFO);
+	ReturnByte = Dataflash_ReceiveByte();
+	Dataflash_DeselectChip();
+
+	/* If returned data is invalid, fail the command */
+	if (ReturnByte != DF_MANUFACTURER_ATMEL)
+	  return false;
+
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	/* Test second Dataflash IC is present and responding to commands */
+	Dataflash_SelectChip(DATAFLASH_CHIP2);
+	Dataflash_SendByte(DF_CMD_READMANUFACTURERDEVICEINFO);
+	ReturnByte = Dataflash_ReceiveByte();
+	Dataflash_DeselectChip();
+
+	/* If returned data is invalid, fail the command */
+	if (ReturnByte != DF_MANUFACTURER_ATMEL)
+	  return false;
+	#endif
+	
+	return true;
+}
@@ -0,0 +1,196 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Board dataflash block device backend with wear levelling.
+ *
+ *  Block device backend for the board dataflash IC(s), which stores blocks through a log-structured flash translation
+ *  layer rather than at fixed dataflash pages. This spreads the page programs of frequently rewritten blocks (such as
+ *  FAT tables or appended log files) evenly over the entire dataflash, at the cost of a reduced storage capacity and a
+ *  small amount of SRAM for the translation state. The SPI and board dataflash drivers must be initialized by the user
+ *  application before \ref BlockDevice_Init() is called.
+ *
+ *  The dataflash is divided into segments of DATAFLASH_FTL_SEGMENT_PAGES pages, which are written in turn as a circular
+ *  log. Each written block is stored in the next free page of the current segment, and the logical to physical page
+ *  mapping table is itself stored in dataflash pages within the log, with recent mapping changes held in a small SRAM
+ *  journal of DATAFLASH_FTL_JOURNAL_ENTRIES entries. The last page of each segment holds a summary of the segment's
+ *  contents, the segment's erase count and a checkpoint of the translation state, from which the state is restored
+ *  by \ref BlockDevice_Init(). Before each segment is reused, any of its pages still in use are moved to the head of
+ *  the log, so that every segment (and thus every page) of the dataflash is programmed an equal number of times.
+ *  DATAFLASH_FTL_SPARE_SEGMENTS segments (a quarter of the dataflash by default) are reserved so that free segments can
+ *  always be reclaimed.
+ *
+ *  As segments are always cleaned and reused in log order, the erase count recorded in each summary is informational only
+ *  and is not used to choose the next segment; long-lived data is instead moved along with the log, costing one extra page
+ *  program for each page still in use each time its segment is cleaned. The spare segments must therefore be large enough
+ *  that the cleaned segments free more pages than their moved pages and the resulting mapping table updates consume, or
+ *  writes to a full storage medium will fail with a device error. The page programs performed for a given workload and
+ *  number of spare segments can be measured with the host simulator in LUFA/Drivers/Misc/BlockDevice/HostTest/.
+ *
+ *  Written data and mapping changes are only made permanent by the next segment summary, thus the storage medium
+ *  behaves as a write-back cache, and \ref BlockDevice_Flush() must be called before power may be removed. Each flush which
+ *  follows a write closes the head segment early to write its summary, leaving the segment's remaining pages unused until
+ *  the segment is next reused. Frequent flushes after small writes therefore add a summary page program to every flush and
+ *  cause more frequent cleaning, and should be avoided where possible. All three tokens may be overridden by defining them
+ *  in the project makefile and passing them to the compiler via the -D switch.
+ *
+ *  \note The translation layer stores its data in a different format to \c DataflashBlockDevice.c, thus the storage
+ *        medium must be reformatted when a project is switched between the two backends.
+ *
+ *  \note This file should not be included directly. Include LUFA/Drivers/Misc/BlockDevice.h instead, and add this backend's
+ *        source file to the project makefile.
+ */
+
+#ifndef __DATAFLASH_FTL_BLOCKDEVICE_H__
+#define __DATAFLASH_FTL_BLOCKDEVICE_H__
+
+	/* Includes: */
+		#include <stddef.h>
+		#include <string.h>
+
+		#include "../BlockDevice.h"
+		#include "../../Board/Dataflash.h"
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#if !defined(DATAFLASH_FTL_SEGMENT_PAGES)
+				#define DATAFLASH_FTL_SEGMENT_PAGES      16
+			#endif
+
+			#if !defined(DATAFLASH_FTL_SPARE_SEGMENTS)
+				#define DATAFLASH_FTL_SPARE_SEGMENTS     (DATAFLASH_FTL_TOTAL_SEGMENTS / 4)
+			#endif
+
+			#if !defined(DATAFLASH_FTL_JOURNAL_ENTRIES)
+				#define DATAFLASH_FTL_JOURNAL_ENTRIES    (((DATAFLASH_PAGE_SIZE / 8) < 96) ? (DATAFLASH_PAGE_SIZE / 8) : 96)
+			#endif
+
+			#define DATAFLASH_FTL_TOTAL_PAGES            (DATAFLASH_PAGES * DATAFLASH_TOTALCHIPS)
+			#define DATAFLASH_FTL_DATA_PAGES             (DATAFLASH_FTL_SEGMENT_PAGES - 1)
+			#define DATAFLASH_FTL_TOTAL_SEGMENTS         (DATAFLASH_FTL_TOTAL_PAGES / DATAFLASH_FTL_SEGMENT_PAGES)
+			#define DATAFLASH_FTL_MAP_ENTRIES            (DATAFLASH_PAGE_SIZE / 2)
+			#define DATAFLASH_FTL_USABLE_PAGES           ((DATAFLASH_FTL_TOTAL_SEGMENTS - DATAFLASH_FTL_SPARE_SEGMENTS) * \
+			                                              DATAFLASH_FTL_DATA_PAGES)
+			#define DATAFLASH_FTL_MAP_PAGES              ((DATAFLASH_FTL_USABLE_PAGES + DATAFLASH_FTL_MAP_ENTRIES - 1) / \
+			                                              DATAFLASH_FTL_MAP_ENTRIES)
+			#define DATAFLASH_FTL_LOGICAL_PAGES          (DATAFLASH_FTL_USABLE_PAGES - DATAFLASH_FTL_MAP_PAGES)
+			#define DATAFLASH_FTL_BLOCKS_PER_PAGE        (DATAFLASH_PAGE_SIZE / BLOCKDEV_BLOCK_SIZE)
+			#define DATAFLASH_FTL_TOTAL_BLOCKS           ((uint32_t)DATAFLASH_FTL_LOGICAL_PAGES * DATAFLASH_FTL_BLOCKS_PER_PAGE)
+
+			#define DATAFLASH_FTL_MIN_FREE_SEGMENTS      3
+			#define DATAFLASH_FTL_NO_PAGE                0xFFFF
+			#define DATAFLASH_FTL_MAP_OWNER(Index)       (0xFF00 | (Index))
+			#define DATAFLASH_FTL_SUMMARY_PAGE(Segment)  (((Segment) * DATAFLASH_FTL_SEGMENT_PAGES) + DATAFLASH_FTL_DATA_PAGES)
+			#define DATAFLASH_FTL_SUMMARY_SIGNATURE      0x4654
+
+		/* Preprocessor Checks: */
+			#if (DATAFLASH_PAGE_SIZE < BLOCKDEV_BLOCK_SIZE)
+				#error The dataflash FTL backend requires a dataflash page size of at least one block.
+			#endif
+
+			#if ((DATAFLASH_FTL_SEGMENT_PAGES < 2) || (DATAFLASH_FTL_SEGMENT_PAGES > 256))
+				#error DATAFLASH_FTL_SEGMENT_PAGES must be between 2 and 256 pages.
+			#endif
+
+			#if (DATAFLASH_FTL_TOTAL_PAGES > 0xFF00)
+				#error The dataflash FTL backend supports a maximum of 65280 dataflash pages.
+			#endif
+
+			#if (DATAFLASH_FTL_SPARE_SEGMENTS < (DATAFLASH_FTL_MIN_FREE_SEGMENTS * 2))
+				#error DATAFLASH_FTL_SPARE_SEGMENTS is too small for the free segments needed by the FTL.
+			#endif
+
+			#if (DATAFLASH_FTL_MAP_PAGES >= 255)
+				#error The dataflash FTL mapping table is too large, increase DATAFLASH_FTL_SPARE_SEGMENTS.
+			#endif
+
+			#if ((DATAFLASH_FTL_JOURNAL_ENTRIES < 1) || (DATAFLASH_FTL_JOURNAL_ENTRIES > 255))
+				#error DATAFLASH_FTL_JOURNAL_ENTRIES must be between 1 and 255 entries.
+			#endif
+
+			#if ((14 + (DATAFLASH_FTL_MAP_PAGES * 2) + (DATAFLASH_FTL_JOURNAL_ENTRIES * 4) + \
+			      (DATAFLASH_FTL_DATA_PAGES * 2)) > DATAFLASH_PAGE_SIZE)
+				#error The dataflash FTL segment summary does not fit into a single dataflash page.
+			#endif
+
+		/* Type Defines: */
+			typedef struct
+			{
+				uint16_t LogicalPage;
+				uint16_t PhysicalPage;
+			} DataflashFTL_JournalEntry_t;
+
+			typedef struct
+			{
+				uint32_t Sequence;
+				uint16_t Signature;
+				uint16_t EraseCount;
+				uint16_t FreeSegments;
+				uint16_t JournalEntries;
+			} DataflashFTL_SummaryHeader_t;
+
+			typedef struct
+			{
+				DataflashFTL_SummaryHeader_t Header;
+				uint16_t                     MapDirectory[DATAFLASH_FTL_MAP_PAGES];
+				DataflashFTL_JournalEntry_t  Journal[DATAFLASH_FTL_JOURNAL_ENTRIES];
+				uint16_t                     Owners[DATAFLASH_FTL_DATA_PAGES];
+				uint16_t                     Checksum;
+			} DataflashFTL_SegmentSummary_t;
+
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_DATAFLASHFTL_BLOCKDEVICE_C)
+				static uint8_t  DataflashFTL_SelectPage(const uint16_t PhysicalPage);
+				static void     DataflashFTL_ReadPage(const uint16_t PhysicalPage, const uint16_t PageByte, void* Buffer,
+				                                      const uint16_t Length);
+				static void     DataflashFTL_OpenPageBuffer(const uint16_t PhysicalPage, const uint16_t SourcePage);
+				static void     DataflashFTL_WritePageBuffer(const uint16_t PhysicalPage, const uint16_t PageByte);
+				static void     DataflashFTL_ProgramPage(const uint16_t PhysicalPage);
+				static uint16_t DataflashFTL_UpdateChecksum(uint16_t Checksum, const void* Data, const uint16_t Length);
+				static void     DataflashFTL_WriteSummaryData(const void* Data, const uint16_t Length, uint16_t* const Checksum);
+				static bool     DataflashFTL_ReadSummaryHeader(const uint16_t Segment, DataflashFTL_SummaryHeader_t* const Header);
+				static bool     DataflashFTL_VerifySummary(const uint16_t Segment);
+				static bool     DataflashFTL_OpenNextSegment(void);
+				static bool     DataflashFTL_CloseSegment(void);
+				static uint16_t DataflashFTL_AllocatePage(const uint16_t Owner);
+				static uint16_t DataflashFTL_LookupPage(const uint16_t LogicalPage);
+				static bool     DataflashFTL_CommitJournal(void);
+				static bool     DataflashFTL_UpdateMapping(const uint16_t LogicalPage, const uint16_t PhysicalPage);
+				static bool     DataflashFTL_CleanTailSegment(void);
+				static uint16_t DataflashFTL_BeginPageWrite(const uint16_t LogicalPage, const uint8_t FirstBlock,
+				                                            const uint8_t TotalPageBlocks);
+				static bool     DataflashFTL_EndPageWrite(const uint16_t LogicalPage, const uint16_t PhysicalPage);
+				static bool     DataflashFTL_BeginPageRead(const uint16_t LogicalPage, const uint8_t FirstBlock);
+				static void     DataflashFTL_Mount(void);
+			#endif
+	#endif
+
+#endif
@@ -0,0 +1,306 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Host benchmark for the dataflash block device backend, as used by the SCSI READ (10) and WRITE (10) command handlers
+ *  of the mass storage demos and projects. The backend is built for the host against models of the board's dataflash
+ *  IC(s) (see DataflashModel.c) and of a full speed bulk endpoint (see EndpointModel.c), and each scenario issues a series
+ *  of SCSI style read or write commands which stream blocks between the endpoint and the dataflash. The sustained transfer
+ *  rate is reported from the simulated time, along with the time spent waiting on the host and the dataflash, and the
+ *  page programs performed. Every written block is read back and verified once all scenarios are complete.
+ *
+ *  Timings are modelled from typical datasheet values rather than measured, and so are most useful for comparing backend
+ *  changes and board configurations against each other. Build and run with "make dataflash" in this directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../BlockDevice.h"
+#include "DataflashModel.h"
+#include "EndpointModel.h"
+
+/** Size in bytes of the command block wrapper sent by the host before each mass storage command. */
+#define COMMAND_WRAPPER_BYTES    31
+
+/** Size in bytes of the command status wrapper sent by the device after each mass storage command. */
+#define STATUS_WRAPPER_BYTES     13
+
+/** Largest number of blocks transferred by a single command. */
+#define MAX_COMMAND_BLOCKS       128
+
+/** Enum for the access patterns of the benchmark scenarios. */
+enum Pattern_t
+{
+	PATTERN_Sequential, /**< Commands access consecutive blocks, starting from block zero */
+	PATTERN_Random, /**< Commands access random command sized, aligned groups of blocks */
+	PATTERN_Hotspot, /**< Commands access random blocks within the first 64 blocks, as FAT and directory updates do */
+};
+
+/** Type define for a benchmark scenario. */
+typedef struct
+{
+	const char* Name; /**< Name of the scenario */
+	bool        Write; /**< Indicates if the scenario writes (true) or reads (false) */
+	uint8_t     Pattern; /**< Access pattern of the commands, a value from the \ref Pattern_t enum */
+	uint16_t    CommandBlocks; /**< Number of blocks transferred by each command */
+	uint32_t    TotalBlocks; /**< Total number of blocks transferred by the scenario */
+} Scenario_t;
+
+/** Benchmark scenarios, run in order. */
+static const Scenario_t Scenarios[] =
+	{
+		{"Sequential write",     true,  PATTERN_Sequential, 128, 2048},
+		{"Sequential read",      false, PATTERN_Sequential, 128, 2048},
+		{"Sequential read",      false, PATTERN_Sequential,   8, 2048},
+		{"Sequential read",      false, PATTERN_Sequential,   1,  512},
+		{"Random write",         true,  PATTERN_Random,       8,  512},
+		{"Random read",          false, PATTERN_Random,       8,  512},
+		{"FAT update write",     true,  PATTERN_Hotspot,      1,  256},
+	};
+
+/** Current simulated time, in nanoseconds. */
+uint64_t SimTimeNS;
+
+/** Number of times each block has been written, used to generate and verify the block contents. Blocks never written
+ *  are not verified.
+ */
+static uint8_t* BlockGenerations;
+
+/** Host data buffer for the data phase of each command. */
+static uint8_t HostData[MAX_COMMAND_BLOCKS * BLOCKDEV_BLOCK_SIZE];
+
+/** Generates the expected contents of a byte of a written block.
+ *
+ *  \param[in] BlockAddress  Address of the block
+ *  \param[in] Offset        Offset of the byte within the block
+ *
+ *  \return Expected value of the byte
+ */
+static uint8_t ExpectedByte(const uint32_t BlockAddress, const uint16_t Offset)
+{
+	uint32_t Value = ((BlockAddress * 2654435761UL) ^ (Offset * 40503UL) ^ (BlockGenerations[BlockAddress] * 97UL));
+
+	return (uint8_t)(Value ^ (Value >> 11) ^ (Value >> 19));
+}
+
+/** Performs a single SCSI style read or write command through the block device backend and the simulated endpoint.
+ *
+ *  \param[in] Write         Boolean true to write the blocks, false to read them
+ *  \param[in] BlockAddress  Address of the first block to transfer
+ *  \param[in] TotalBlocks   Number of blocks to transfer
+ *
+ *  \return Number of verification failures of the read blocks (always zero for writes), or -1 on a backend error
+ */
+static int DoCommand(const bool Write, const uint32_t BlockAddress, const uint16_t TotalBlocks)
+{
+	uint32_t Length = ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
+	uint8_t  ErrorCode;
+	int      Failures = 0;
+
+	EndpointModel_TransferPacket(COMMAND_WRAPPER_BYTES);
+
+	if (Write)
+	{
+		for (uint16_t Block = 0; Block < TotalBlocks; Block++)
+		{
+			BlockGenerations[BlockAddress + Block]++;
+
+			for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+			  HostData[(Block * BLOCKDEV_BLOCK_SIZE) + Offset] = ExpectedByte(BlockAddress + Block, Offset);
+		}
+
+		EndpointModel_BeginOUT(HostData, Length);
+		ErrorCode = BlockDevice_WriteBlocks_Endpoint(BlockAddress, TotalBlocks, NULL);
+	}
+	else
+	{
+		EndpointModel_BeginIN(HostData, Length);
+		ErrorCode = BlockDevice_ReadBlocks_Endpoint(BlockAddress, TotalBlocks, NULL);
+	}
+
+	EndpointModel_End();
+	EndpointModel_TransferPacket(STATUS_WRAPPER_BYTES);
+
+	if (ErrorCode != BLOCKDEV_ERROR_NoError)
+	  return -1;
+
+	if (!(Write))
+	{
+		for (uint16_t Block = 0; Block < TotalBlocks; Block++)
+		{
+			if (!(BlockGenerations[BlockAddress + Block]))
+			  continue;
+
+			for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+			{
+				if (HostData[(Block * BLOCKDEV_BLOCK_SIZE) + Offset] != ExpectedByte(BlockAddress + Block, Offset))
+				{
+					Failures++;
+					break;
+				}
+			}
+		}
+	}
+
+	return Failures;
+}
+
+/** Runs a single benchmark scenario, printing its results.
+ *
+ *  \param[in] Scenario  Scenario to run
+ *
+ *  \return Number of errors encountered by the scenario
+ */
+static uint32_t RunScenario(const Scenario_t* const Scenario)
+{
+	uint32_t DeviceBlocks = BlockDevice_GetTotalBlocks();
+	uint32_t Errors       = 0;
+	uint64_t StartNS      = SimTimeNS;
+
+	DataflashModel_ResetStats();
+	memset(&EndpointModel_Stats, 0x00, sizeof(EndpointModel_Stats));
+
+	for (uint32_t BlocksDone = 0; BlocksDone < Scenario->TotalBlocks; BlocksDone += Scenario->CommandBlocks)
+	{
+		uint32_t BlockAddress;
+
+		switch (Scenario->Pattern)
+		{
+			case PATTERN_Sequential:
+				BlockAddress = BlocksDone;
+				break;
+			case PATTERN_Random:
+				BlockAddress = ((rand() % (DeviceBlocks / Scenario->CommandBlocks)) * Scenario->CommandBlocks);
+				break;
+			default:
+				BlockAddress = (rand() % 64);
+				break;
+		}
+
+		int Failures = DoCommand(Scenario->Write, BlockAddress, Scenario->CommandBlocks);
+		
+		Errors += ((Failures < 0) ? 1 : Failures);
+	}
+
+	/* Writes are only complete once the dataflash has finished programming the written pages */
+	if (Scenario->Write)
+	  BlockDevice_Flush();
+
+	double ElapsedMS = ((double)(SimTimeNS - StartNS) / 1000000);
+
+	Errors += (DataflashModel_Stats.ProtocolErrors + EndpointModel_Stats.ProtocolErrors);
+
+	printf("%-18s %6u %9.1f %9.1f %9.1f %8lu %8lu %8lu %6lu\n", Scenario->Name, Scenario->CommandBlocks,
+	       (((double)Scenario->TotalBlocks * BLOCKDEV_BLOCK_SIZE / 1024) / (ElapsedMS / 1000)), ElapsedMS,
+	       ((double)EndpointModel_Stats.WaitNS / 1000000),
+	       (unsigned long)DataflashModel_Stats.PagePrograms, (unsigned long)DataflashModel_Stats.PageTransfers,
+	       (unsigned long)DataflashModel_Stats.BusyStatusReads, (unsigned long)Errors);
+
+	return Errors;
+}
+
+/** Reads back every written block of the device through the RAM buffer interface, and checks its contents.
+ *
+ *  \return Number of blocks with incorrect contents
+ */
+static uint32_t VerifyAllBlocks(void)
+{
+	uint32_t Failures = 0;
+	uint8_t  Buffer[BLOCKDEV_BLOCK_SIZE];
+
+	for (uint32_t BlockAddress = 0; BlockAddress < BlockDevice_GetTotalBlocks(); BlockAddress++)
+	{
+		if (!(BlockGenerations[BlockAddress]))
+		  continue;
+
+		if (BlockDevice_ReadBlocks(BlockAddress, 1, Buffer) != BLOCKDEV_ERROR_NoError)
+		{
+			Failures++;
+			continue;
+		}
+
+		for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+		{
+			if (Buffer[Offset] != ExpectedByte(BlockAddress, Offset))
+			{
+				Failures++;
+				break;
+			}
+		}
+	}
+
+	return Failures;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	srand(1);
+	DataflashModel_Reset();
+
+	if ((BlockDevice_Init() != BLOCKDEV_ERROR_NoError) || !(BlockDevice_CheckOperation()))
+	{
+		printf("Block device initialization failed\n");
+		return 1;
+	}
+
+	BlockGenerations = calloc(BlockDevice_GetTotalBlocks(), 1);
+
+	printf("Dataflash block device benchmark: %u chip(s) of %u byte pages, %lu blocks, SPI byte %llu ns%s\n\n",
+	       DATAFLASH_TOTALCHIPS, DATAFLASH_PAGE_SIZE, (unsigned long)BlockDevice_GetTotalBlocks(),
+	       (unsigned long long)SIM_SPI_BYTE_NS,
+	       (BlockDevice_GetCapabilities() & BLOCKDEV_CAP_WRITE_CACHE) ? ", write cache enabled" : "");
+	printf("%-18s %6s %9s %9s %9s %8s %8s %8s %6s\n", "Scenario", "Blocks", "KB/s", "Time ms", "USB ms", "Programs", "Loads",
+	       "Polls", "Errors");
+
+	for (uint8_t Index = 0; Index < (sizeof(Scenarios) / sizeof(Scenarios[0])); Index++)
+	  TotalErrors += RunScenario(&Scenarios[Index]);
+
+	uint32_t VerifyFailures = VerifyAllBlocks();
+	TotalErrors += (VerifyFailures + DataflashModel_Stats.ProtocolErrors);
+
+	printf("\nBlocks is the number of blocks transferred by each command, USB ms the time spent waiting on the host to\n");
+	printf("fill or empty an endpoint bank, Loads the main memory to buffer transfers for partial page writes, and\n");
+	printf("Polls the dataflash status reads which found a busy IC.\n");
+	printf("Read back verification of all written blocks: %s\n", (VerifyFailures ? "FAILED" : "passed"));
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,503 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Host model of the board dataflash IC(s), implementing the dataflash interface declared in BlockDeviceShim.h. Each
+ *  simulated IC decodes the commands used by the block device backends byte by byte, including the chip select edges
+ *  which start page programs and buffer transfers, and holds its main memory, SRAM buffers and per page program counts.
+ *  Every byte sent or received advances the simulated time by one SPI byte time, and page programs and transfers keep
+ *  the IC busy for their typical datasheet duration, so that status polling loops consume simulated time as they would
+ *  on the AVR. Commands which a real IC would reject, such as a main memory access while the IC is busy, are counted
+ *  as protocol errors.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../BlockDevice.h"
+#include "DataflashModel.h"
+
+/** Enum for the command decoding states of a simulated dataflash IC. */
+enum DataflashModel_States_t
+{
+	DFMODEL_STATE_Idle, /**< Waiting for a command byte */
+	DFMODEL_STATE_Address, /**< Receiving the address bytes of a command */
+	DFMODEL_STATE_Dummy, /**< Receiving the dummy bytes of a read command */
+	DFMODEL_STATE_Data, /**< Transferring the data bytes of a command */
+	DFMODEL_STATE_Status, /**< Returning the status register */
+	DFMODEL_STATE_DeviceInfo, /**< Returning the manufacturer and device information */
+	DFMODEL_STATE_Protection, /**< Receiving the remaining bytes of the sector protection off sequence */
+	DFMODEL_STATE_Complete, /**< Command complete, no further bytes expected until the IC is deselected */
+};
+
+/** Type define for the state of a simulated dataflash IC. */
+typedef struct
+{
+	uint8_t  Memory[DATAFLASH_PAGES][DFMODEL_PAGE_TOTAL_BYTES]; /**< Main memory pages of the IC */
+	uint8_t  Buffers[2][DFMODEL_PAGE_TOTAL_BYTES]; /**< SRAM buffers of the IC */
+	uint32_t PageWear[DATAFLASH_PAGES]; /**< Number of erase and program cycles of each page */
+	uint64_t BusyUntilNS; /**< Simulated time at which the IC's current page program or transfer completes */
+	int8_t   ProgrammingBuffer; /**< Index of the buffer being programmed into main memory while busy, or -1 for none */
+	bool     SectorProtection; /**< Indicates if sector protection is enabled */
+	uint8_t  State; /**< Command decoding state, a value from the \ref DataflashModel_States_t enum */
+	uint8_t  Command; /**< Command currently being decoded */
+	uint8_t  BytesRemaining; /**< Number of address, dummy or sequence bytes remaining in the current state */
+	uint32_t Address; /**< Address bytes received for the current command */
+	uint16_t Page; /**< Main memory page of the current command */
+	uint16_t Byte; /**< Current byte within the page or buffer of the current command */
+} DataflashModel_Chip_t;
+
+DataflashModel_Stats_t DataflashModel_Stats;
+
+/** Simulated dataflash ICs, one per chip select line of the simulated board. */
+static DataflashModel_Chip_t Chips[DATAFLASH_TOTALCHIPS];
+
+/** Chip select mask of the simulated board's chip select port, as set by \ref Dataflash_SelectChip(). */
+static uint8_t SelectedChipMask = DATAFLASH_NO_CHIP;
+
+/** Number of address bits selecting the byte within a page, for the page size of the simulated board. */
+#define PAGE_BYTE_ADDRESS_BITS       ((DATAFLASH_PAGE_SIZE == 1024) ? 11 : 10)
+
+/** Retrieves the simulated IC selected by the given chip select mask.
+ *
+ *  \param[in] ChipMask  Chip select mask, as given to \ref Dataflash_SelectChip()
+ *
+ *  \return Pointer to the selected simulated IC, or NULL if no IC is selected
+ */
+static DataflashModel_Chip_t* DataflashModel_GetChip(const uint8_t ChipMask)
+{
+	if (ChipMask == DATAFLASH_CHIP_MASK(1))
+	  return &Chips[0];
+
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	if (ChipMask == DATAFLASH_CHIP_MASK(2))
+	  return &Chips[1];
+	#endif
+
+	return NULL;
+}
+
+/** Determines if the given simulated IC is still busy with a page program or transfer.
+ *
+ *  \param[in] Chip  Simulated IC to check
+ *
+ *  \return Boolean true if the IC is busy, false otherwise
+ */
+static bool DataflashModel_IsBusy(const DataflashModel_Chip_t* const Chip)
+{
+	return (SimTimeNS < Chip->BusyUntilNS);
+}
+
+/** Records a protocol error, for a command or byte which a real dataflash IC would reject or misinterpret.
+ *
+ *  \param[in] Chip         Simulated IC the error occurred on
+ *  \param[in] Description  Description of the error, printed for the first few errors only
+ */
+static void DataflashModel_ProtocolError(DataflashModel_Chip_t* const Chip, const char* const Description)
+{
+	if (DataflashModel_Stats.ProtocolErrors++ < 10)
+	{
+		printf("Dataflash protocol error on chip %d: %s (command %02X)\n", (int)(Chip - Chips), Description,
+		       Chip->Command);
+	}
+
+	Chip->State = DFMODEL_STATE_Complete;
+}
+
+/** Completes the current command of a simulated IC as it is deselected, starting any page program or transfer.
+ *
+ *  \param[in] Chip  Simulated IC being deselected
+ */
+static void DataflashModel_EndCommand(DataflashModel_Chip_t* const Chip)
+{
+	bool AddressComplete = ((Chip->State != DFMODEL_STATE_Idle) && (Chip->State != DFMODEL_STATE_Address));
+
+	switch (Chip->Command)
+	{
+		case DF_CMD_BUFF1TOMAINMEMWITHERASE:
+		case DF_CMD_BUFF2TOMAINMEMWITHERASE:
+			if (!(AddressComplete))
+			  break;
+
+			Chip->ProgrammingBuffer = ((Chip->Command == DF_CMD_BUFF2TOMAINMEMWITHERASE) ? 1 : 0);
+			Chip->BusyUntilNS       = (SimTimeNS + DFMODEL_PROGRAM_NS);
+
+			memcpy(Chip->Memory[Chip->Page], Chip->Buffers[Chip->ProgrammingBuffer], DFMODEL_PAGE_TOTAL_BYTES);
+			Chip->PageWear[Chip->Page]++;
+			DataflashModel_Stats.PagePrograms++;
+			break;
+		case DF_CMD_MAINMEMTOBUFF1:
+		case DF_CMD_MAINMEMTOBUFF2:
+			if (!(AddressComplete))
+			  break;
+
+			Chip->ProgrammingBuffer = -1;
+			Chip->BusyUntilNS       = (SimTimeNS + DFMODEL_TRANSFER_NS);
+
+			memcpy(Chip->Buffers[(Chip->Command == DF_CMD_MAINMEMTOBUFF2) ? 1 : 0], Chip->Memory[Chip->Page],
+			       DFMODEL_PAGE_TOTAL_BYTES);
+			DataflashModel_Stats.PageTransfers++;
+			break;
+	}
+
+	Chip->State   = DFMODEL_STATE_Idle;
+	Chip->Command = 0;
+}
+
+/** Starts decoding a new command on a simulated IC, checking that the IC can accept it.
+ *
+ *  \param[in] Chip     Simulated IC the command was sent to
+ *  \param[in] Command  Command byte sent to the IC
+ */
+static void DataflashModel_StartCommand(DataflashModel_Chip_t* const Chip, const uint8_t Command)
+{
+	Chip->Command        = Command;
+	Chip->State          = DFMODEL_STATE_Address;
+	Chip->BytesRemaining = 3;
+	Chip->Address        = 0;
+
+	DataflashModel_Stats.CommandBytes++;
+
+	switch (Command)
+	{
+		case DF_CMD_GETSTATUS:
+			Chip->State = DFMODEL_STATE_Status;
+			return;
+		case DF_CMD_READMANUFACTURERDEVICEINFO:
+			Chip->State          = DFMODEL_STATE_DeviceInfo;
+			Chip->BytesRemaining = 0;
+			return;
+		case DF_CMD_SECTORPROTECTIONOFF_BYTE1:
+			Chip->State          = DFMODEL_STATE_Protection;
+			Chip->BytesRemaining = 3;
+			break;
+		case DF_CMD_BUFF1WRITE:
+		case DF_CMD_BUFF2WRITE:
+			/* The buffer not being programmed into main memory may be written while the IC is busy */
+			if (DataflashModel_IsBusy(Chip) &&
+			    (Chip->ProgrammingBuffer == ((Command == DF_CMD_BUFF2WRITE) ? 1 : 0)))
+			{
+				DataflashModel_ProtocolError(Chip, "buffer written while being programmed");
+			}
+			
+			return;
+		case DF_CMD_MAINMEMPAGEREAD:
+		case DF_CMD_CONTARRAYREAD_LF:
+		case DF_CMD_MAINMEMTOBUFF1:
+		case DF_CMD_MAINMEMTOBUFF2:
+		case DF_CMD_BUFF1TOMAINMEMWITHERASE:
+		case DF_CMD_BUFF2TOMAINMEMWITHERASE:
+			break;
+		default:
+			DataflashModel_ProtocolError(Chip, "unsupported command");
+			return;
+	}
+
+	if (DataflashModel_IsBusy(Chip))
+	  DataflashModel_ProtocolError(Chip, "main memory command while busy");
+}
+
+/** Processes a complete address received by a simulated IC, moving on to the command's dummy or data bytes.
+ *
+ *  \param[in] Chip  Simulated IC which received the address
+ */
+static void DataflashModel_AddressComplete(DataflashModel_Chip_t* const Chip)
+{
+	Chip->Page = ((Chip->Address >> PAGE_BYTE_ADDRESS_BITS) & (DATAFLASH_PAGES - 1));
+	Chip->Byte = (Chip->Address & ((1 << PAGE_BYTE_ADDRESS_BITS) - 1));
+
+	if (Chip->Byte >= DFMODEL_PAGE_TOTAL_BYTES)
+	{
+		DataflashModel_ProtocolError(Chip, "byte address beyond the end of the page");
+		return;
+	}
+
+	switch (Chip->Command)
+	{
+		case DF_CMD_MAINMEMPAGEREAD:
+			Chip->State          = DFMODEL_STATE_Dummy;
+			Chip->BytesRemaining = 4;
+			break;
+		case DF_CMD_CONTARRAYREAD_LF:
+			Chip->State          = (DF_CONTARRAYREAD_LF_DUMMYBYTES ? DFMODEL_STATE_Dummy : DFMODEL_STATE_Data);
+			Chip->BytesRemaining = DF_CONTARRAYREAD_LF_DUMMYBYTES;
+			break;
+		case DF_CMD_BUFF1WRITE:
+		case DF_CMD_BUFF2WRITE:
+			Chip->State = DFMODEL_STATE_Data;
+			break;
+		default:
+			Chip->State = DFMODEL_STATE_Complete;
+			break;
+	}
+}
+
+uint8_t Dataflash_GetSelectedChip(void)
+{
+	return SelectedChipMask;
+}
+
+void Dataflash_SelectChip(const uint8_t ChipMask)
+{
+	if (ChipMask == SelectedChipMask)
+	  return;
+
+	DataflashModel_Chip_t* Chip = DataflashModel_GetChip(SelectedChipMask);
+
+	/* Deselecting an IC completes its current command */
+	if (Chip != NULL)
+	  DataflashModel_EndCommand(Chip);
+
+	SelectedChipMask = ChipMask;
+}
+
+void Dataflash_SendByte(const uint8_t Byte)
+{
+	DataflashModel_Chip_t* Chip = DataflashModel_GetChip(SelectedChipMask);
+
+	SimTimeNS += SIM_SPI_BYTE_NS;
+
+	if (Chip == NULL)
+	{
+		DataflashModel_Stats.ProtocolErrors++;
+		return;
+	}
+
+	switch (Chip->State)
+	{
+		case DFMODEL_STATE_Idle:
+			DataflashModel_StartCommand(Chip, Byte);
+			break;
+		case DFMODEL_STATE_Address:
+			DataflashModel_Stats.CommandBytes++;
+			Chip->Address = ((Chip->Address << 8) | Byte);
+
+			if (!(--Chip->BytesRemaining))
+			  DataflashModel_AddressComplete(Chip);
+
+			break;
+		case DFMODEL_STATE_Dummy:
+			DataflashModel_Stats.CommandBytes++;
+
+			if (!(--Chip->BytesRemaining))
+			  Chip->State = DFMODEL_STATE_Data;
+
+			break;
+		case DFMODEL_STATE_Protection:
+			DataflashModel_Stats.CommandBytes++;
+
+			if (Byte != (uint8_t)DF_CMD_SECTORPROTECTIONOFF[4 - Chip->BytesRemaining])
+			{
+				DataflashModel_ProtocolError(Chip, "invalid sector protection off sequence");
+				break;
+			}
+
+			if (!(--Chip->BytesRemaining))
+			{
+				Chip->SectorProtection = false;
+				Chip->State            = DFMODEL_STATE_Complete;
+			}
+
+			break;
+		case DFMODEL_STATE_Data:
+			if ((Chip->Command == DF_CMD_BUFF1WRITE) || (Chip->Command == DF_CMD_BUFF2WRITE))
+			{
+				DataflashModel_Stats.DataBytes++;
+				Chip->Buffers[(Chip->Command == DF_CMD_BUFF2WRITE) ? 1 : 0][Chip->Byte] = Byte;
+
+				/* Buffer writes wrap at the end of the buffer */
+				if (++Chip->Byte == DFMODEL_PAGE_TOTAL_BYTES)
+				  Chip->Byte = 0;
+
+				break;
+			}
+
+			/* Fall through, data bytes are only sent to the IC for buffer writes */
+		default:
+			DataflashModel_ProtocolError(Chip, "unexpected byte sent");
+			break;
+	}
+}
+
+uint8_t Dataflash_ReceiveByte(void)
+{
+	DataflashModel_Chip_t* Chip = DataflashModel_GetChip(SelectedChipMask);
+	uint8_t                Byte = 0xFF;
+
+	SimTimeNS += SIM_SPI_BYTE_NS;
+
+	if (Chip == NULL)
+	{
+		DataflashModel_Stats.ProtocolErrors++;
+		return Byte;
+	}
+
+	switch (Chip->State)
+	{
+		case DFMODEL_STATE_Status:
+			DataflashModel_Stats.StatusReads++;
+
+			/* The status register reports the density of the IC, in addition to the ready and protection flags */
+			Byte = ((DATAFLASH_PAGE_SIZE == 1024) ? 0x3C : 0x34);
+
+			if (DataflashModel_IsBusy(Chip))
+			  DataflashModel_Stats.BusyStatusReads++;
+			else
+			  Byte |= DF_STATUS_READY;
+
+			if (Chip->SectorProtection)
+			  Byte |= DF_STATUS_SECTORPROTECTION_ON;
+
+			break;
+		case DFMODEL_STATE_DeviceInfo:
+			Byte = ((Chip->BytesRemaining++ == 0) ? DF_MANUFACTURER_ATMEL : 0x00);
+			break;
+		case DFMODEL_STATE_Data:
+			if (Chip->Command == DF_CMD_MAINMEMPAGEREAD)
+			{
+				DataflashModel_Stats.DataBytes++;
+				Byte = Chip->Memory[Chip->Page][Chip->Byte];
+
+				/* Main memory page reads wrap at the end of the page */
+				if (++Chip->Byte == DFMODEL_PAGE_TOTAL_BYTES)
+				  Chip->Byte = 0;
+
+				break;
+			}
+			else if (Chip->Command == DF_CMD_CONTARRAYREAD_LF)
+			{
+				DataflashModel_Stats.DataBytes++;
+				Byte = Chip->Memory[Chip->Page][Chip->Byte];
+
+				/* Continuous array reads carry on into the next page, wrapping at the end of the memory */
+				if (++Chip->Byte == DFMODEL_PAGE_TOTAL_BYTES)
+				{
+					Chip->Byte = 0;
+					Chip->Page = ((Chip->Page + 1) & (DATAFLASH_PAGES - 1));
+				}
+
+				break;
+			}
+
+			/* Fall through, data bytes are only received from the IC for main memory reads */
+		default:
+			DataflashModel_ProtocolError(Chip, "unexpected byte received");
+			break;
+	}
+
+	return Byte;
+}
+
+/** Resets the simulated ICs to their factory state, with every page erased and sector protection enabled, and clears the
+ *  operation counters and simulated time.
+ */
+void DataflashModel_Reset(void)
+{
+	for (uint8_t ChipIndex = 0; ChipIndex < DATAFLASH_TOTALCHIPS; ChipIndex++)
+	{
+		DataflashModel_Chip_t* Chip = &Chips[ChipIndex];
+
+		memset(Chip->Memory, 0xFF, sizeof(Chip->Memory));
+		memset(Chip->Buffers, 0xFF, sizeof(Chip->Buffers));
+		memset(Chip->PageWear, 0x00, sizeof(Chip->PageWear));
+
+		Chip->BusyUntilNS       = 0;
+		Chip->ProgrammingBuffer = -1;
+		Chip->SectorProtection  = true;
+		Chip->State             = DFMODEL_STATE_Idle;
+		Chip->Command           = 0;
+	}
+
+	SelectedChipMask = DATAFLASH_NO_CHIP;
+	SimTimeNS        = 0;
+
+	DataflashModel_ResetStats();
+}
+
+/** Clears the operation counters of the simulated ICs, leaving their contents and wear counts intact. */
+void DataflashModel_ResetStats(void)
+{
+	memset(&DataflashModel_Stats, 0x00, sizeof(DataflashModel_Stats));
+}
+
+/** Simulates the removal and restoration of power to the simulated ICs. Any page program in progress completes (as the
+ *  models do not simulate torn programs), and the contents of the SRAM buffers are lost.
+ */
+void DataflashModel_PowerCycle(void)
+{
+	for (uint8_t ChipIndex = 0; ChipIndex < DATAFLASH_TOTALCHIPS; ChipIndex++)
+	{
+		DataflashModel_Chip_t* Chip = &Chips[ChipIndex];
+
+		memset(Chip->Buffers, 0x00, sizeof(Chip->Buffers));
+
+		Chip->BusyUntilNS       = 0;
+		Chip->ProgrammingBuffer = -1;
+		Chip->SectorProtection  = true;
+		Chip->State             = DFMODEL_STATE_Idle;
+		Chip->Command           = 0;
+	}
+
+	SelectedChipMask = DATAFLASH_NO_CHIP;
+}
+
+/** Retrieves the number of erase and program cycles of a page of a simulated IC.
+ *
+ *  \param[in] ChipIndex    Index of the simulated IC, from 0 to (DATAFLASH_TOTALCHIPS - 1)
+ *  \param[in] PageAddress  Address of the page within the IC
+ *
+ *  \return Number of erase and program cycles of the page
+ */
+uint32_t DataflashModel_GetPageWear(const uint8_t ChipIndex, const uint16_t PageAddress)
+{
+	return Chips[ChipIndex].PageWear[PageAddress];
+}
+
+/** Retrieves the highest number of erase and program cycles of any page of the simulated ICs.
+ *
+ *  \return Highest number of erase and program cycles of any page
+ */
+uint32_t DataflashModel_GetMaxPageWear(void)
+{
+	uint32_t MaxWear = 0;
+
+	for (uint8_t ChipIndex = 0; ChipIndex < DATAFLASH_TOTALCHIPS; ChipIndex++)
+	{
+		for (uint16_t PageAddress = 0; PageAddress < DATAFLASH_PAGES; PageAddress++)
+		{
+			if (Chips[ChipIndex].PageWear[PageAddress] > MaxWear)
+			  MaxWear = Chips[ChipIndex].PageWear[PageAddress];
+		}
+	}
+
+	return MaxWear;
+}
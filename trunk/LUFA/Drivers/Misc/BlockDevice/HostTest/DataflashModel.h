@@ -0,0 +1,79 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Header file for DataflashModel.c.
+ */
+
+#ifndef _DATAFLASH_MODEL_H_
+#define _DATAFLASH_MODEL_H_
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+
+		#include "SimTime.h"
+
+	/* Macros: */
+		/** Total size in bytes of each dataflash page, including the spare bytes at the end of the page. */
+		#define DFMODEL_PAGE_TOTAL_BYTES    (DATAFLASH_PAGE_SIZE + DATAFLASH_PAGE_SPARE_BYTES)
+
+		/** Typical time taken by the dataflash to erase and program a page from one of its SRAM buffers, in nanoseconds. */
+		#define DFMODEL_PROGRAM_NS          17000000ULL
+
+		/** Typical time taken by the dataflash to transfer a page of main memory into one of its SRAM buffers, in nanoseconds. */
+		#define DFMODEL_TRANSFER_NS         200000ULL
+
+	/* Type Defines: */
+		/** Type define for the operation counters of the simulated dataflash ICs. */
+		typedef struct
+		{
+			uint64_t PagePrograms; /**< Number of page erase and program cycles started */
+			uint64_t PageTransfers; /**< Number of main memory page to buffer transfers started */
+			uint64_t StatusReads; /**< Number of status register bytes read */
+			uint64_t BusyStatusReads; /**< Number of status register bytes read which indicated a busy IC */
+			uint64_t CommandBytes; /**< Number of command, address and dummy bytes sent */
+			uint64_t DataBytes; /**< Number of data bytes sent to or received from the ICs */
+			uint32_t ProtocolErrors; /**< Number of commands or bytes the real ICs would have rejected or misinterpreted */
+		} DataflashModel_Stats_t;
+
+	/* External Variables: */
+		extern DataflashModel_Stats_t DataflashModel_Stats;
+
+	/* Function Prototypes: */
+		void     DataflashModel_Reset(void);
+		void     DataflashModel_ResetStats(void);
+		void     DataflashModel_PowerCycle(void);
+		uint32_t DataflashModel_GetPageWear(const uint8_t ChipIndex, const uint16_t PageAddress);
+		uint32_t DataflashModel_GetMaxPageWear(void);
+
+#endif
@@ -0,0 +1,314 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Host model of a double banked full speed bulk endpoint of the AVR's USB controller in device mode, implementing the
+ *  endpoint interface declared in BlockDeviceShim.h, SDCardShim.h and MSHostShim.h for the data phase of a mass storage
+ *  command. The
+ *  simulated host fills (for an OUT data phase) or empties (for an IN data phase) each endpoint bank as soon as the
+ *  bank is available and the bus is free, taking one bulk packet time per bank, while the AVR concurrently copies data
+ *  between the other bank and the storage medium. Waiting on a bank advances the simulated time to the moment the host
+ *  completes it, so that the overlap of USB and storage transfers achieved by a block device backend is reflected in
+ *  the elapsed time.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../BlockDevice.h"
+#include "EndpointModel.h"
+
+EndpointModel_Stats_t EndpointModel_Stats;
+
+/** Indicates if the current data phase is an OUT (host to device) transfer. */
+static bool IsOUT;
+
+/** Host data sent to the device during an OUT data phase. */
+static const uint8_t* OUTData;
+
+/** Host buffer receiving the data sent by the device during an IN data phase. */
+static uint8_t* INBuffer;
+
+/** Total length of the current data phase, in bytes. */
+static uint32_t DataLength;
+
+/** Number of bytes the host has placed into or taken from the endpoint banks. */
+static uint32_t HostOffset;
+
+/** Number of bytes the device has read from or written to the endpoint banks. */
+static uint32_t DeviceOffset;
+
+/** Simulated time at which each bank's packet arrives from the host (OUT), or each bank's packet has been sent to the
+ *  host and the bank is free again (IN).
+ */
+static uint64_t BankReadyNS[EPMODEL_BANKS];
+
+/** Number of bytes held in each bank. */
+static uint16_t BankBytes[EPMODEL_BANKS];
+
+/** Index of the bank currently accessed by the device. */
+static uint8_t CurrentBank;
+
+/** Number of bytes of the current OUT bank read by the device. */
+static uint16_t BankPosition;
+
+/** Simulated time at which the bus completes its last scheduled packet. */
+static uint64_t BusFreeNS;
+
+/** Abort flag to set once the device has transferred \ref AbortOffset bytes of the data phase, or NULL for none. */
+static volatile bool* AbortFlag;
+
+/** Number of bytes of the data phase after which \ref AbortFlag is set. */
+static uint32_t AbortOffset;
+
+/** Records an endpoint access which would fail on the real endpoint.
+ *
+ *  \param[in] Description  Description of the error, printed for the first few errors only
+ */
+static void EndpointModel_ProtocolError(const char* const Description)
+{
+	if (EndpointModel_Stats.ProtocolErrors++ < 10)
+	  printf("Endpoint protocol error: %s (offset %lu)\n", Description, (unsigned long)DeviceOffset);
+}
+
+/** Schedules the bus transfer of a packet, once the bus has completed any earlier packet.
+ *
+ *  \param[in] Bytes  Size of the packet, in bytes
+ *
+ *  \return Simulated time at which the packet transfer completes
+ */
+static uint64_t EndpointModel_SchedulePacket(const uint16_t Bytes)
+{
+	uint64_t StartNS = ((BusFreeNS > SimTimeNS) ? BusFreeNS : SimTimeNS);
+
+	BusFreeNS = (StartNS + EPMODEL_PACKET_NS(Bytes));
+	return BusFreeNS;
+}
+
+/** Sets the abort flag of the data phase once the device has transferred the requested number of bytes, as a mass
+ *  storage reset received from the host part way through the data phase would.
+ */
+static void EndpointModel_CheckAbort(void)
+{
+	if ((AbortFlag != NULL) && (DeviceOffset == AbortOffset))
+	  *AbortFlag = true;
+}
+
+/** Has the host fill the given OUT bank with its next packet, if any data remains to be sent.
+ *
+ *  \param[in] Bank  Index of the freed bank to fill
+ */
+static void EndpointModel_FillOUTBank(const uint8_t Bank)
+{
+	uint32_t BytesRemaining = (DataLength - HostOffset);
+
+	BankBytes[Bank] = ((BytesRemaining > EPMODEL_BANK_SIZE) ? EPMODEL_BANK_SIZE : BytesRemaining);
+
+	if (!(BankBytes[Bank]))
+	  return;
+
+	BankReadyNS[Bank] = EndpointModel_SchedulePacket(BankBytes[Bank]);
+	HostOffset       += BankBytes[Bank];
+
+	EndpointModel_Stats.Packets++;
+}
+
+/** Starts an OUT data phase, in which the host sends the given data to the device.
+ *
+ *  \param[in] HostData  Data to send to the device
+ *  \param[in] Length    Length of the data, in bytes
+ */
+void EndpointModel_BeginOUT(const uint8_t* const HostData, const uint32_t Length)
+{
+	IsOUT        = true;
+	AbortFlag    = NULL;
+	OUTData      = HostData;
+	DataLength   = Length;
+	HostOffset   = 0;
+	DeviceOffset = 0;
+	CurrentBank  = 0;
+	BankPosition = 0;
+
+	for (uint8_t Bank = 0; Bank < EPMODEL_BANKS; Bank++)
+	  EndpointModel_FillOUTBank(Bank);
+}
+
+/** Starts an IN data phase, in which the host receives data from the device into the given buffer.
+ *
+ *  \param[out] HostBuffer  Buffer receiving the data sent by the device
+ *  \param[in]  Length      Length of the data phase, in bytes
+ */
+void EndpointModel_BeginIN(uint8_t* const HostBuffer, const uint32_t Length)
+{
+	IsOUT        = false;
+	AbortFlag    = NULL;
+	INBuffer     = HostBuffer;
+	DataLength   = Length;
+	HostOffset   = 0;
+	DeviceOffset = 0;
+	CurrentBank  = 0;
+
+	for (uint8_t Bank = 0; Bank < EPMODEL_BANKS; Bank++)
+	{
+		BankReadyNS[Bank] = SimTimeNS;
+		BankBytes[Bank]   = 0;
+	}
+}
+
+/** Aborts the current data phase part way through, by setting the given abort flag once the device has transferred the
+ *  given number of bytes. The data phase is then not required to complete.
+ *
+ *  \param[out] Flag    Abort flag passed to the block device backend, cleared by this function
+ *  \param[in]  Offset  Number of bytes of the data phase to transfer before the flag is set
+ */
+void EndpointModel_AbortAt(volatile bool* const Flag, const uint32_t Offset)
+{
+	*Flag       = false;
+	AbortFlag   = Flag;
+	AbortOffset = Offset;
+}
+
+/** Completes the current data phase, sending any partially filled IN bank as the mass storage class driver would, and
+ *  waiting until the bus has transferred every packet.
+ *
+ *  \return Number of bytes transferred by the device in the data phase
+ */
+uint32_t EndpointModel_End(void)
+{
+	if (!(IsOUT) && BankBytes[CurrentBank])
+	  Endpoint_ClearIN();
+
+	if ((DeviceOffset != DataLength) && !((AbortFlag != NULL) && *AbortFlag))
+	  EndpointModel_ProtocolError("data phase incomplete");
+
+	if (BusFreeNS > SimTimeNS)
+	  SimTimeNS = BusFreeNS;
+
+	return DeviceOffset;
+}
+
+/** Transfers a single non-data packet over the bus, such as the command and status wrappers of a mass storage command,
+ *  waiting until the transfer completes.
+ *
+ *  \param[in] Bytes  Size of the packet, in bytes
+ */
+void EndpointModel_TransferPacket(const uint16_t Bytes)
+{
+	SimTimeNS = EndpointModel_SchedulePacket(Bytes);
+}
+
+uint8_t Endpoint_WaitUntilReady(void)
+{
+	/* An OUT bank which the host has no further data for would never be filled, and the real wait would time out */
+	if (IsOUT && !(BankBytes[CurrentBank]))
+	  return 3;
+
+	if (SimTimeNS < BankReadyNS[CurrentBank])
+	{
+		EndpointModel_Stats.WaitNS += (BankReadyNS[CurrentBank] - SimTimeNS);
+		SimTimeNS = BankReadyNS[CurrentBank];
+	}
+
+	return 0;
+}
+
+bool Endpoint_IsReadWriteAllowed(void)
+{
+	if (SimTimeNS < BankReadyNS[CurrentBank])
+	  return false;
+
+	if (IsOUT)
+	  return (BankPosition < BankBytes[CurrentBank]);
+	else
+	  return ((BankBytes[CurrentBank] < EPMODEL_BANK_SIZE) && (DeviceOffset < DataLength));
+}
+
+void Endpoint_ClearOUT(void)
+{
+	if (!(IsOUT) || !(BankBytes[CurrentBank]) || (SimTimeNS < BankReadyNS[CurrentBank]))
+	{
+		EndpointModel_ProtocolError("OUT bank cleared before it was received");
+		return;
+	}
+
+	EndpointModel_FillOUTBank(CurrentBank);
+
+	CurrentBank  = ((CurrentBank + 1) % EPMODEL_BANKS);
+	BankPosition = 0;
+}
+
+void Endpoint_ClearIN(void)
+{
+	if (IsOUT || (SimTimeNS < BankReadyNS[CurrentBank]))
+	{
+		EndpointModel_ProtocolError("IN bank sent while still busy");
+		return;
+	}
+
+	BankReadyNS[CurrentBank] = EndpointModel_SchedulePacket(BankBytes[CurrentBank]);
+	HostOffset              += BankBytes[CurrentBank];
+	BankBytes[CurrentBank]   = 0;
+
+	EndpointModel_Stats.Packets++;
+
+	CurrentBank = ((CurrentBank + 1) % EPMODEL_BANKS);
+}
+
+uint8_t Endpoint_Read_Byte(void)
+{
+	if (!(IsOUT) || !(Endpoint_IsReadWriteAllowed()))
+	{
+		EndpointModel_ProtocolError("byte read from an empty bank");
+		return 0;
+	}
+
+	uint8_t Byte = OUTData[DeviceOffset++];
+
+	BankPosition++;
+	EndpointModel_CheckAbort();
+
+	return Byte;
+}
+
+void Endpoint_Write_Byte(const uint8_t Byte)
+{
+	if (IsOUT || !(Endpoint_IsReadWriteAllowed()))
+	{
+		EndpointModel_ProtocolError("byte written to a full or busy bank");
+		return;
+	}
+
+	BankBytes[CurrentBank]++;
+	INBuffer[DeviceOffset++] = Byte;
+
+	EndpointModel_CheckAbort();
+}
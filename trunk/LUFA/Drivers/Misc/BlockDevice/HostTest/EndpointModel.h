@@ -0,0 +1,81 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Header file for EndpointModel.c.
+ */
+
+#ifndef _ENDPOINT_MODEL_H_
+#define _ENDPOINT_MODEL_H_
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+
+		#include "SimTime.h"
+
+	/* Macros: */
+		/** Size in bytes of each bank of the simulated bulk endpoint. */
+		#define EPMODEL_BANK_SIZE          64
+
+		/** Number of banks of the simulated bulk endpoint. */
+		#define EPMODEL_BANKS              2
+
+		/** Time taken to transfer one byte over the full speed USB bus, in nanoseconds. */
+		#define EPMODEL_USB_BYTE_NS        667
+
+		/** Number of protocol bytes (token, handshake, PID, CRC and inter-packet gaps) of each bulk transaction. */
+		#define EPMODEL_PACKET_OVERHEAD    13
+
+		/** Time taken to transfer a bulk packet of the given size over the full speed USB bus, in nanoseconds. */
+		#define EPMODEL_PACKET_NS(Bytes)   (((Bytes) + EPMODEL_PACKET_OVERHEAD) * EPMODEL_USB_BYTE_NS)
+
+	/* Type Defines: */
+		/** Type define for the counters of the simulated endpoint. */
+		typedef struct
+		{
+			uint64_t Packets; /**< Number of data packets transferred over the bus */
+			uint64_t WaitNS; /**< Simulated time spent waiting for the host to fill or empty an endpoint bank */
+			uint32_t ProtocolErrors; /**< Number of endpoint accesses which would fail on the real endpoint */
+		} EndpointModel_Stats_t;
+
+	/* External Variables: */
+		extern EndpointModel_Stats_t EndpointModel_Stats;
+
+	/* Function Prototypes: */
+		void     EndpointModel_BeginOUT(const uint8_t* const HostData, const uint32_t Length);
+		void     EndpointModel_BeginIN(uint8_t* const HostBuffer, const uint32_t Length);
+		void     EndpointModel_AbortAt(volatile bool* const Flag, const uint32_t Offset);
+		uint32_t EndpointModel_End(void);
+		void     EndpointModel_TransferPacket(const uint16_t Bytes);
+
+#endif
@@ -0,0 +1,344 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Host simulator for the wear levelling dataflash block device backend. The backend is built for the host against models
+ *  of the board's dataflash IC(s) (see DataflashModel.c), and each workload writes blocks through the RAM buffer interface
+ *  in a pattern typical of an embedded FAT filesystem or a USB host, flushing the backend at the given interval. The page
+ *  programs performed by the dataflash for each written block and the resulting erase and program cycles of the most and
+ *  least worn pages are reported, showing the write amplification of the translation layer and how evenly the wear is
+ *  spread over the dataflash.
+ *
+ *  After each workload the simulated ICs are power cycled and the backend remounted, and every written block is verified.
+ *  Each workload then writes further blocks without a flush and is power cycled again, to check that the remounted contents
+ *  of every block are either those of the last flush or a later write. Build and run with "make ftl" in this directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../BlockDevice.h"
+#include "DataflashModel.h"
+
+/** Number of blocks in the simulated FAT filesystem's metadata region, holding its FAT and root directory. */
+#define METADATA_BLOCKS          32
+
+/** Number of blocks written without a flush before each workload's unflushed power cycle. */
+#define UNFLUSHED_BLOCKS         64
+
+/** Enum for the write patterns of the simulator workloads. */
+enum Pattern_t
+{
+	PATTERN_Sequential, /**< Each write continues from the end of the previous write, wrapping at the end of the device */
+	PATTERN_Random, /**< Each write is to a random, write sized and aligned group of blocks */
+	PATTERN_LogAppend, /**< Each write appends a block to a log file, and updates the file's FAT and directory blocks */
+};
+
+/** Type define for a simulator workload. */
+typedef struct
+{
+	const char* Name; /**< Name of the workload */
+	uint8_t     Pattern; /**< Write pattern of the workload, a value from the \ref Pattern_t enum */
+	uint16_t    WriteBlocks; /**< Number of blocks written by each write */
+	uint32_t    TotalWrites; /**< Total number of writes performed by the workload */
+	uint16_t    FlushInterval; /**< Number of writes between each flush of the block device */
+} Workload_t;
+
+/** Simulator workloads, run in order on a freshly erased dataflash. */
+static const Workload_t Workloads[] =
+	{
+		{"Sequential fill",    PATTERN_Sequential, 64,  1024, 256},
+		{"Random 4K",          PATTERN_Random,      8,  4096,  64},
+		{"Log append",         PATTERN_LogAppend,   1,  8192, 256},
+		{"Log append, 16",     PATTERN_LogAppend,   1,  8192,  16},
+		{"Log append, 1",      PATTERN_LogAppend,   1,  8192,   1},
+	};
+
+/** Current simulated time, in nanoseconds. */
+uint64_t SimTimeNS;
+
+/** Number of times each block has been written, used to generate and verify the block contents. */
+static uint16_t* BlockGenerations;
+
+/** Value of each block's entry in \ref BlockGenerations at the last flush of the block device. */
+static uint16_t* FlushedGenerations;
+
+/** Number of blocks which are verified, set to the total number of blocks of the block device. */
+static uint32_t TotalBlocks;
+
+/** Data buffer for the blocks of each write. */
+static uint8_t WriteBuffer[64 * BLOCKDEV_BLOCK_SIZE];
+
+/** Generates the expected contents of a byte of a block.
+ *
+ *  \param[in] BlockAddress  Address of the block
+ *  \param[in] Generation    Number of times the block has been written, or zero for an unwritten block
+ *  \param[in] Offset        Offset of the byte within the block
+ *
+ *  \return Expected value of the byte
+ */
+static uint8_t ExpectedByte(const uint32_t BlockAddress, const uint16_t Generation, const uint16_t Offset)
+{
+	if (!(Generation))
+	  return 0xFF;
+
+	uint32_t Value = ((BlockAddress * 2654435761UL) ^ (Offset * 40503UL) ^ (Generation * 97UL));
+
+	return (uint8_t)(Value ^ (Value >> 11) ^ (Value >> 19));
+}
+
+/** Writes a group of blocks through the block device, recording and generating their new contents.
+ *
+ *  \param[in] BlockAddress  Address of the first block to write
+ *  \param[in] Blocks        Number of blocks to write
+ *
+ *  \return Boolean true if the blocks were written, false on a block device error
+ */
+static bool WriteBlocks(const uint32_t BlockAddress, const uint16_t Blocks)
+{
+	for (uint16_t Block = 0; Block < Blocks; Block++)
+	{
+		uint16_t Generation = ++BlockGenerations[BlockAddress + Block];
+
+		for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+		  WriteBuffer[(Block * BLOCKDEV_BLOCK_SIZE) + Offset] = ExpectedByte(BlockAddress + Block, Generation, Offset);
+	}
+
+	return (BlockDevice_WriteBlocks(BlockAddress, Blocks, WriteBuffer) == BLOCKDEV_ERROR_NoError);
+}
+
+/** Flushes the block device, recording the flushed contents of every block.
+ *
+ *  \return Boolean true if the block device was flushed, false on a block device error
+ */
+static bool FlushBlocks(void)
+{
+	memcpy(FlushedGenerations, BlockGenerations, (TotalBlocks * sizeof(uint16_t)));
+
+	return (BlockDevice_Flush() == BLOCKDEV_ERROR_NoError);
+}
+
+/** Power cycles the simulated dataflash and remounts the block device, then verifies the contents of every block. Each
+ *  block must contain either its contents at the last flush, or the contents of a later write of the block.
+ *
+ *  \return Number of blocks with incorrect contents, or one if the block device failed to remount
+ */
+static uint32_t RemountAndVerify(void)
+{
+	uint8_t  Buffer[BLOCKDEV_BLOCK_SIZE];
+	uint32_t Failures = 0;
+
+	DataflashModel_PowerCycle();
+
+	if (BlockDevice_Init() != BLOCKDEV_ERROR_NoError)
+	  return 1;
+
+	for (uint32_t BlockAddress = 0; BlockAddress < TotalBlocks; BlockAddress++)
+	{
+		bool IsValid = false;
+
+		if (BlockDevice_ReadBlocks(BlockAddress, 1, Buffer) == BLOCKDEV_ERROR_NoError)
+		{
+			for (uint16_t Generation = FlushedGenerations[BlockAddress];
+			     !(IsValid) && (Generation <= BlockGenerations[BlockAddress]); Generation++)
+			{
+				IsValid = true;
+
+				for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+				{
+					if (Buffer[Offset] != ExpectedByte(BlockAddress, Generation, Offset))
+					{
+						IsValid = false;
+						break;
+					}
+				}
+
+				/* Once a block's later contents are found the earlier ones can no longer be returned */
+				if (IsValid)
+				  FlushedGenerations[BlockAddress] = BlockGenerations[BlockAddress] = Generation;
+			}
+		}
+
+		if (!(IsValid))
+		  Failures++;
+	}
+
+	return Failures;
+}
+
+/** Runs a single simulator workload, printing its results.
+ *
+ *  \param[in] Workload  Workload to run
+ *
+ *  \return Number of errors encountered by the workload
+ */
+static uint32_t RunWorkload(const Workload_t* const Workload)
+{
+	uint32_t HostBlocks   = 0;
+	uint32_t Flushes      = 0;
+	uint32_t NextBlock    = 0;
+	uint32_t Errors       = 0;
+
+	DataflashModel_Reset();
+	memset(BlockGenerations, 0x00, (TotalBlocks * sizeof(uint16_t)));
+	memset(FlushedGenerations, 0x00, (TotalBlocks * sizeof(uint16_t)));
+
+	if (BlockDevice_Init() != BLOCKDEV_ERROR_NoError)
+	  return 1;
+
+	DataflashModel_ResetStats();
+
+	for (uint32_t WriteNum = 0; WriteNum < Workload->TotalWrites; WriteNum++)
+	{
+		bool WriteOK;
+
+		switch (Workload->Pattern)
+		{
+			case PATTERN_Sequential:
+				if ((NextBlock + Workload->WriteBlocks) > TotalBlocks)
+				  NextBlock = 0;
+
+				WriteOK    = WriteBlocks(NextBlock, Workload->WriteBlocks);
+				NextBlock += Workload->WriteBlocks;
+				HostBlocks += Workload->WriteBlocks;
+				break;
+			case PATTERN_Random:
+				NextBlock  = ((rand() % (TotalBlocks / Workload->WriteBlocks)) * Workload->WriteBlocks);
+				WriteOK    = WriteBlocks(NextBlock, Workload->WriteBlocks);
+				HostBlocks += Workload->WriteBlocks;
+				break;
+			default:
+				/* Append the log data, then update the FAT block covering it and the file's directory entry block */
+				if ((NextBlock < METADATA_BLOCKS) || (NextBlock >= TotalBlocks))
+				  NextBlock = METADATA_BLOCKS;
+
+				WriteOK    = (WriteBlocks(NextBlock, 1) &&
+				              WriteBlocks(1 + ((NextBlock / 256) % (METADATA_BLOCKS - 2)), 1) &&
+				              WriteBlocks(METADATA_BLOCKS - 1, 1));
+				NextBlock++;
+				HostBlocks += 3;
+				break;
+		}
+
+		if (!(WriteOK))
+		{
+			printf("%-18s write %lu failed\n", Workload->Name, (unsigned long)WriteNum);
+			return (Errors + 1);
+		}
+
+		if (!((WriteNum + 1) % Workload->FlushInterval))
+		{
+			if (!(FlushBlocks()))
+			  Errors++;
+
+			Flushes++;
+		}
+	}
+
+	if (!(FlushBlocks()))
+	  Errors++;
+
+	uint64_t PagePrograms = DataflashModel_Stats.PagePrograms;
+	uint32_t MinWear      = UINT32_MAX;
+	uint64_t TotalWear    = 0;
+
+	for (uint8_t ChipIndex = 0; ChipIndex < DATAFLASH_TOTALCHIPS; ChipIndex++)
+	{
+		for (uint16_t PageAddress = 0; PageAddress < DATAFLASH_PAGES; PageAddress++)
+		{
+			uint32_t Wear = DataflashModel_GetPageWear(ChipIndex, PageAddress);
+
+			if (Wear < MinWear)
+			  MinWear = Wear;
+
+			TotalWear += Wear;
+		}
+	}
+
+	/* Verify the flushed contents, then write further blocks without a flush and check that the remount recovers */
+	Errors += RemountAndVerify();
+
+	for (uint16_t Block = 0; Block < UNFLUSHED_BLOCKS; Block++)
+	{
+		if (!(WriteBlocks((rand() % TotalBlocks), 1)))
+		  Errors++;
+	}
+
+	Errors += RemountAndVerify();
+	Errors += DataflashModel_Stats.ProtocolErrors;
+
+	printf("%-18s %8lu %6lu %9llu %8.2f %6lu %6lu %8.1f %6lu\n", Workload->Name, (unsigned long)HostBlocks,
+	       (unsigned long)Flushes, (unsigned long long)PagePrograms, ((double)PagePrograms / HostBlocks),
+	       (unsigned long)DataflashModel_GetMaxPageWear(), (unsigned long)MinWear,
+	       ((double)TotalWear / (DATAFLASH_PAGES * DATAFLASH_TOTALCHIPS)), (unsigned long)Errors);
+
+	return Errors;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	srand(1);
+	DataflashModel_Reset();
+
+	if (BlockDevice_Init() != BLOCKDEV_ERROR_NoError)
+	{
+		printf("Block device initialization failed\n");
+		return 1;
+	}
+
+	TotalBlocks        = BlockDevice_GetTotalBlocks();
+	BlockGenerations   = calloc(TotalBlocks, sizeof(uint16_t));
+	FlushedGenerations = calloc(TotalBlocks, sizeof(uint16_t));
+
+	printf("Dataflash FTL simulator: %u chip(s) of %u pages of %u bytes, %lu blocks available\n\n",
+	       DATAFLASH_TOTALCHIPS, DATAFLASH_PAGES, DATAFLASH_PAGE_SIZE, (unsigned long)TotalBlocks);
+	printf("%-18s %8s %6s %9s %8s %6s %6s %8s %6s\n", "Workload", "Blocks", "Flush", "Programs", "Per blk",
+	       "Max", "Min", "Mean", "Errors");
+
+	for (uint8_t Index = 0; Index < (sizeof(Workloads) / sizeof(Workloads[0])); Index++)
+	  TotalErrors += RunWorkload(&Workloads[Index]);
+
+	printf("\nBlocks is the number of blocks written by the host and Flush the number of flushes, Programs the page programs\n");
+	printf("performed by the dataflash and Per blk the page programs per written block. Max, Min and Mean are the erase\n");
+	printf("and program cycles of the most, least and average worn dataflash page.\n");
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
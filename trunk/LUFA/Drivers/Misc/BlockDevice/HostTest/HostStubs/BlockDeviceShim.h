@@ -0,0 +1,177 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Shim header force-included (via the compiler's -include switch) when building the block device backends for the host
+ *  machine. The AVR specific USB core and board dataflash headers are suppressed, and the endpoint and dataflash interfaces
+ *  the backends use are declared here instead, implemented by the simulated USB endpoint (EndpointModel.c) and dataflash
+ *  ICs (DataflashModel.c). The dataflash geometry and command set of the board selected by the SIM_BOARD_* token are
+ *  those of the real board driver, and the address byte packing mirrors the board driver's.
+ */
+
+#ifndef _BLOCKDEVICE_SHIM_H_
+#define _BLOCKDEVICE_SHIM_H_
+
+	/* Macros: */
+		#define __USB_H__
+		#define __DATAFLASH_H__
+		#define USB_CAN_BE_DEVICE
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#if defined(SIM_BOARD_USBKEY)
+				#include "../../../../Board/USBKEY/AT45DB642D.h"
+
+				#define DATAFLASH_TOTALCHIPS             2
+				#define DATAFLASH_NO_CHIP                ((1 << 1) | (1 << 0))
+				#define DATAFLASH_CHIP1                  (1 << 1)
+				#define DATAFLASH_CHIP2                  (1 << 0)
+				#define DATAFLASH_PAGE_SIZE              1024
+				#define DATAFLASH_PAGES                  8192
+				#define DATAFLASH_PAGE_SPARE_BYTES       32
+			#elif defined(SIM_BOARD_XPLAIN)
+				#include "../../../../Board/XPLAIN/AT45DB642D.h"
+
+				#define DATAFLASH_TOTALCHIPS             1
+				#define DATAFLASH_NO_CHIP                (1 << 5)
+				#define DATAFLASH_CHIP1                  0
+				#define DATAFLASH_PAGE_SIZE              1024
+				#define DATAFLASH_PAGES                  8192
+				#define DATAFLASH_PAGE_SPARE_BYTES       32
+			#elif defined(SIM_BOARD_STK525)
+				#include "../../../../Board/STK525/AT45DB321C.h"
+
+				#define DATAFLASH_TOTALCHIPS             1
+				#define DATAFLASH_NO_CHIP                (1 << 4)
+				#define DATAFLASH_CHIP1                  0
+				#define DATAFLASH_PAGE_SIZE              512
+				#define DATAFLASH_PAGES                  8192
+				#define DATAFLASH_PAGE_SPARE_BYTES       16
+			#else
+				#error A simulated board must be selected via the SIM_BOARD_* token.
+			#endif
+
+			#if !defined(__DOXYGEN__)
+				#define __GET_DATAFLASH_MASK2(x, y)      x ## y
+				#define __GET_DATAFLASH_MASK(x)          __GET_DATAFLASH_MASK2(DATAFLASH_CHIP,x)
+			#endif
+
+			#define DATAFLASH_CHIP_MASK(index)           __GET_DATAFLASH_MASK(index)
+
+			#define Dataflash_DeselectChip()             Dataflash_SelectChip(DATAFLASH_NO_CHIP)
+
+		/* Function Prototypes: */
+			uint8_t Dataflash_GetSelectedChip(void);
+			void    Dataflash_SelectChip(const uint8_t ChipMask);
+			void    Dataflash_SendByte(const uint8_t Byte);
+			uint8_t Dataflash_ReceiveByte(void);
+
+			uint8_t Endpoint_WaitUntilReady(void);
+			bool    Endpoint_IsReadWriteAllowed(void);
+			void    Endpoint_ClearOUT(void);
+			void    Endpoint_ClearIN(void);
+			uint8_t Endpoint_Read_Byte(void);
+			void    Endpoint_Write_Byte(const uint8_t Byte);
+
+		/* Inline Functions: */
+			static inline uint8_t Dataflash_TransferByte(const uint8_t Byte)
+			{
+				Dataflash_SendByte(Byte);
+				return Dataflash_ReceiveByte();
+			}
+
+			static inline void Dataflash_ToggleSelectedChipCS(void)
+			{
+				uint8_t SelectedChipMask = Dataflash_GetSelectedChip();
+
+				Dataflash_DeselectChip();
+				Dataflash_SelectChip(SelectedChipMask);
+			}
+
+			static inline void Dataflash_WaitWhileBusy(void)
+			{
+				Dataflash_ToggleSelectedChipCS();
+				Dataflash_SendByte(DF_CMD_GETSTATUS);
+				while (!(Dataflash_ReceiveByte() & DF_STATUS_READY));
+				Dataflash_ToggleSelectedChipCS();
+			}
+
+			static inline bool Dataflash_IsBusy(void)
+			{
+				bool IsBusy;
+
+				Dataflash_ToggleSelectedChipCS();
+				Dataflash_SendByte(DF_CMD_GETSTATUS);
+				IsBusy = !(Dataflash_ReceiveByte() & DF_STATUS_READY);
+				Dataflash_ToggleSelectedChipCS();
+
+				return IsBusy;
+			}
+
+			static inline void Dataflash_SelectChipFromPage(const uint16_t PageAddress)
+			{
+				Dataflash_DeselectChip();
+
+				if (PageAddress >= (DATAFLASH_PAGES * DATAFLASH_TOTALCHIPS))
+				  return;
+
+				#if (DATAFLASH_TOTALCHIPS == 2)
+				if (PageAddress & 0x01)
+				  Dataflash_SelectChip(DATAFLASH_CHIP2);
+				else
+				  Dataflash_SelectChip(DATAFLASH_CHIP1);
+				#else
+				Dataflash_SelectChip(DATAFLASH_CHIP1);
+				#endif
+			}
+
+			static inline void Dataflash_SendAddressBytes(uint16_t PageAddress, const uint16_t BufferByte)
+			{
+				#if (DATAFLASH_TOTALCHIPS == 2)
+				PageAddress >>= 1;
+				#endif
+
+				#if (DATAFLASH_PAGE_SIZE == 1024)
+				Dataflash_SendByte(PageAddress >> 5);
+				Dataflash_SendByte((PageAddress << 3) | (BufferByte >> 8));
+				#else
+				Dataflash_SendByte(PageAddress >> 6);
+				Dataflash_SendByte((PageAddress << 2) | (BufferByte >> 8));
+				#endif
+				Dataflash_SendByte(BufferByte);
+			}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Shim header force-included (via the compiler's -include switch) when building the Mass Storage host block device
+ *  backend for the host machine. The AVR specific USB core and Mass Storage class driver headers are suppressed, and the
+ *  host state, class driver types and class driver functions the backend uses are declared here instead, implemented by
+ *  the simulated USB flash drive of the test (MSHostBlockDeviceTest.c). The device mode endpoint interface used by the
+ *  simulated drive to send and receive its data is implemented by the simulated USB endpoint (EndpointModel.c).
+ */
+
+#ifndef _MSHOST_SHIM_H_
+#define _MSHOST_SHIM_H_
+
+	/* Macros: */
+		#define __USB_H__
+		#define _MS_CLASS_H_
+		#define __INCLUDE_FROM_USB_DRIVER
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+
+		#include "../../../../USB/HighLevel/USBMode.h"
+
+	/* Public Interface - May be used in end-application: */
+		/* Type Defines: */
+			typedef struct
+			{
+				struct
+				{
+					bool IsActive;
+				} State;
+			} USB_ClassInfo_MS_Host_t;
+
+			typedef struct
+			{
+				uint32_t Blocks;
+				uint32_t BlockSize;
+			} SCSI_Capacity_t;
+
+			typedef bool (*MS_Host_BlockCallback_t)(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+			                                        const uint32_t BlockAddress, void* BlockBuffer);
+
+		/* Enums: */
+			enum USB_Host_States_t
+			{
+				HOST_STATE_Unattached                   = 0,
+				HOST_STATE_Configured                   = 12,
+			};
+
+		/* External Variables: */
+			extern volatile uint8_t USB_HostState;
+
+		/* Function Prototypes: */
+			uint8_t MS_Host_TestUnitReady(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex);
+			uint8_t MS_Host_ReadDeviceCapacity(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+			                                   SCSI_Capacity_t* const DeviceCapacity);
+			uint8_t MS_Host_ReadDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+			                                 const uint32_t BlockAddress, const uint8_t Blocks, const uint16_t BlockSize,
+			                                 void* BlockBuffer);
+			uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+			                                  const uint32_t BlockAddress, const uint8_t Blocks, const uint16_t BlockSize,
+			                                  void* BlockBuffer);
+			uint8_t MS_Host_ReadDeviceBlocks_Stream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+			                                        const uint32_t BlockAddress, const uint16_t Blocks, const uint16_t BlockSize,
+			                                        void* BlockBuffer, MS_Host_BlockCallback_t const Callback);
+
+			uint8_t Endpoint_WaitUntilReady(void);
+			bool    Endpoint_IsReadWriteAllowed(void);
+			void    Endpoint_ClearOUT(void);
+			void    Endpoint_ClearIN(void);
+			uint8_t Endpoint_Read_Byte(void);
+			void    Endpoint_Write_Byte(const uint8_t Byte);
+
+#endif
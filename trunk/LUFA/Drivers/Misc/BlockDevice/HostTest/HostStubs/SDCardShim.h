@@ -0,0 +1,102 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Shim header force-included (via the compiler's -include switch) when building the SD card block device backend for
+ *  the host machine. The AVR specific USB core and SPI driver headers are suppressed, and the SPI and endpoint
+ *  interfaces the backend uses are declared here instead, implemented by the simulated SD card (SDCardModel.c) and USB
+ *  endpoint (EndpointModel.c). The card's chip select line is the simulated PORTB, as the backend's default.
+ */
+
+#ifndef _SDCARD_SHIM_H_
+#define _SDCARD_SHIM_H_
+
+	/* Macros: */
+		#define __USB_H__
+		#define __SPI_H__
+		#define USB_CAN_BE_DEVICE
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+
+		#include "../SimTime.h"
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#define F_CPU                          SIM_CPU_HZ
+
+			/* The SPI speed masks hold the log2 of the SPI clock divider, so that the simulated card can determine the
+			 * SPI clock of each transfer.
+			 */
+			#define SPI_SPEED_FCPU_DIV_2           1
+			#define SPI_SPEED_FCPU_DIV_4           2
+			#define SPI_SPEED_FCPU_DIV_8           3
+			#define SPI_SPEED_FCPU_DIV_16          4
+			#define SPI_SPEED_FCPU_DIV_32          5
+			#define SPI_SPEED_FCPU_DIV_64          6
+			#define SPI_SPEED_FCPU_DIV_128         7
+			#define SPI_SPEED_MASK                 0x07
+
+			#define SPI_SCK_LEAD_RISING            (0 << 3)
+			#define SPI_SCK_LEAD_FALLING           (1 << 3)
+			#define SPI_SAMPLE_LEADING             (0 << 4)
+			#define SPI_SAMPLE_TRAILING            (1 << 4)
+			#define SPI_MODE_SLAVE                 (0 << 5)
+			#define SPI_MODE_MASTER                (1 << 5)
+
+		/* External Variables: */
+			extern volatile uint8_t PORTB;
+			extern volatile uint8_t DDRB;
+
+		/* Function Prototypes: */
+			void    SPI_Init(const uint8_t SPIOptions);
+			uint8_t SPI_TransferByte(const uint8_t Byte);
+
+			uint8_t Endpoint_WaitUntilReady(void);
+			bool    Endpoint_IsReadWriteAllowed(void);
+			void    Endpoint_ClearOUT(void);
+			void    Endpoint_ClearIN(void);
+			uint8_t Endpoint_Read_Byte(void);
+			void    Endpoint_Write_Byte(const uint8_t Byte);
+
+		/* Inline Functions: */
+			static inline void SPI_SendByte(const uint8_t Byte)
+			{
+				SPI_TransferByte(Byte);
+			}
+
+			static inline uint8_t SPI_ReceiveByte(void)
+			{
+				return SPI_TransferByte(0x00);
+			}
+
+#endif
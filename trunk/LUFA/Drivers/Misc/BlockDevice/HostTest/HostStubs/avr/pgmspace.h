@@ -0,0 +1,6 @@
+/* Stand-in for the AVR program space header, program space data is placed in host memory. */
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(Address)   (*(const uint8_t*)(Address))
@@ -0,0 +1,871 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Host test and benchmark for the Mass Storage host block device backend. The backend is built for the host against a
+ *  simulated USB flash drive attached to the AVR, which implements the Mass Storage host class driver functions used by
+ *  the backend and sends and receives the data phase of each command through a model of a full speed bulk endpoint (see
+ *  EndpointModel.c) - here the endpoint is that of the drive, and the AVR takes the place of the model's USB host. The
+ *  backend is checked to report the drive's capacity, to serve repeated reads from its block cache, to replace cached
+ *  blocks in least recently used order, to read ahead on sequential reads, and to discard its cache after failed
+ *  commands and drive changes, both by counting the commands issued to the drive and by verifying a random sequence of
+ *  reads and writes against the contents of the simulated drive. The disk IO layer of the Webserver project's FatFs
+ *  port is linked against the backend, and checked to report a removed drive to FatFs. Finally the transfer rate and command count of typical
+ *  filesystem access patterns is reported from the simulated time.
+ *
+ *  The drive's command latency is modelled from typical values rather than measured, and so the results are most useful
+ *  for comparing backend changes against each other. Build and run with "make mshost" in this directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../BlockDevice.h"
+#include "../MSHostBlockDevice.h"
+#include "EndpointModel.h"
+#include "diskio.h"
+
+/** Size in bytes of the command block wrapper sent by the host before each mass storage command. */
+#define COMMAND_WRAPPER_BYTES    31
+
+/** Size in bytes of the command status wrapper sent by the device after each mass storage command. */
+#define STATUS_WRAPPER_BYTES     13
+
+/** Size in bytes of the data returned by the drive for a READ CAPACITY command. */
+#define CAPACITY_DATA_BYTES      8
+
+/** Capacity of the simulated drive, in blocks. */
+#define DRIVE_BLOCKS             16384
+
+/** Time taken by the simulated drive to process each command, in nanoseconds. */
+#define DRIVE_COMMAND_NS         500000ULL
+
+/** Error code returned by the simulated class driver functions when a command fails. */
+#define DRIVE_COMMAND_FAILED     0x80
+
+/** Value of the drive's bad block address when no block is bad. */
+#define DRIVE_NO_BAD_BLOCK       0xFFFFFFFF
+
+/** Largest number of blocks transferred by a single test operation. */
+#define MAX_TEST_BLOCKS          256
+
+/** Number of random operations performed on the drive. */
+#define RANDOM_OPERATIONS        4000
+
+/** Total number of blocks read by each benchmark scenario. */
+#define BENCHMARK_BLOCKS         1024
+
+/** Type define for the counters of the simulated drive. */
+typedef struct
+{
+	uint32_t Commands; /**< Number of commands issued to the drive */
+	uint32_t BlocksRead; /**< Number of blocks sent by the drive */
+	uint32_t BlocksWritten; /**< Number of blocks written to the drive */
+	uint32_t ProtocolErrors; /**< Number of commands which the real class driver or drive would reject */
+} Drive_Stats_t;
+
+/** Current simulated time, in nanoseconds. */
+uint64_t SimTimeNS;
+
+/** Current state of the simulated USB host state machine. */
+volatile uint8_t USB_HostState;
+
+/** Mass Storage host class interface of the simulated drive. */
+static USB_ClassInfo_MS_Host_t DriveInterface;
+
+/** Counters of the simulated drive. */
+static Drive_Stats_t Drive_Stats;
+
+/** Indicates if the simulated drive is still attached to the bus. */
+static bool DrivePresent;
+
+/** Block size reported by the simulated drive, in bytes. */
+static uint32_t DriveBlockSize;
+
+/** Address of a block of the drive which cannot be read or written, or \ref DRIVE_NO_BAD_BLOCK for none. */
+static uint32_t DriveBadBlock = DRIVE_NO_BAD_BLOCK;
+
+/** Contents of the simulated drive's medium. */
+static uint8_t  DriveMedium[DRIVE_BLOCKS][BLOCKDEV_BLOCK_SIZE];
+
+/** Buffer for the data phase of a streamed read, from which each block is given to the block callback. */
+static uint8_t  DriveStreamData[MSHOST_BLOCKDEV_MAX_TRANSFER_BLOCKS * BLOCKDEV_BLOCK_SIZE];
+
+/** Host data buffer for each operation. */
+static uint8_t  HostData[MAX_TEST_BLOCKS * BLOCKDEV_BLOCK_SIZE];
+
+/** Expected contents of the blocks of each operation, once the operation completes. */
+static uint8_t  ExpectedData[MAX_TEST_BLOCKS * BLOCKDEV_BLOCK_SIZE];
+
+/** Records a command which the real class driver or drive would reject.
+ *
+ *  \param[in] Description  Description of the error, printed for the first few errors only
+ */
+static void Drive_ProtocolError(const char* const Description)
+{
+	if (Drive_Stats.ProtocolErrors++ < 10)
+	  printf("Drive protocol error: %s\n", Description);
+}
+
+/** Starts a command of the simulated drive, checking that the backend issued it to the configured interface and
+ *  within the medium, and sending the command block wrapper.
+ *
+ *  \param[in] MSInterfaceInfo  Interface the command was issued to
+ *  \param[in] LUNIndex         LUN the command was issued to
+ *  \param[in] BlockAddress     Address of the first block accessed by the command
+ *  \param[in] Blocks           Number of blocks accessed by the command
+ *
+ *  \return Boolean true if the drive accepted the command, false if it has been removed
+ */
+static bool Drive_BeginCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+                               const uint32_t BlockAddress, const uint32_t Blocks)
+{
+	if ((MSInterfaceInfo != &DriveInterface) || LUNIndex)
+	  Drive_ProtocolError("command issued to the wrong interface or LUN");
+
+	if (!(DriveInterface.State.IsActive) || (USB_HostState != HOST_STATE_Configured))
+	  Drive_ProtocolError("command issued while the drive is not configured");
+
+	if ((BlockAddress + Blocks) > DRIVE_BLOCKS)
+	  Drive_ProtocolError("command accesses blocks past the end of the medium");
+
+	Drive_Stats.Commands++;
+
+	/* A removed drive never acknowledges the command, which fails once the host detects the disconnection */
+	if (!(DrivePresent))
+	  return false;
+
+	EndpointModel_TransferPacket(COMMAND_WRAPPER_BYTES);
+	SimTimeNS += DRIVE_COMMAND_NS;
+
+	return true;
+}
+
+/** Completes a command of the simulated drive, sending the command status wrapper.
+ *
+ *  \param[in] Passed  Boolean true if the command completed successfully, false otherwise
+ *
+ *  \return Error code returned by the class driver for the command
+ */
+static uint8_t Drive_EndCommand(const bool Passed)
+{
+	EndpointModel_TransferPacket(STATUS_WRAPPER_BYTES);
+
+	return (Passed ? 0 : DRIVE_COMMAND_FAILED);
+}
+
+/** Determines the number of blocks of a command which the drive can transfer before it reaches its bad block.
+ *
+ *  \param[in] BlockAddress  Address of the first block of the command
+ *  \param[in] Blocks        Number of blocks of the command
+ *
+ *  \return Number of blocks before the bad block, or the total number of blocks if none is bad
+ */
+static uint16_t Drive_GoodBlocks(const uint32_t BlockAddress, const uint16_t Blocks)
+{
+	if ((DriveBadBlock >= BlockAddress) && (DriveBadBlock < (BlockAddress + Blocks)))
+	  return (DriveBadBlock - BlockAddress);
+
+	return Blocks;
+}
+
+/** Sends a group of blocks from the drive's medium to the host through the drive's bulk IN endpoint, stopping at the
+ *  drive's bad block.
+ *
+ *  \param[in]  BlockAddress  Address of the first block to send
+ *  \param[in]  Blocks        Number of blocks to send
+ *  \param[out] HostBuffer    Host buffer receiving the blocks
+ *
+ *  \return Number of blocks sent
+ */
+static uint16_t Drive_SendBlocks(const uint32_t BlockAddress, const uint16_t Blocks, uint8_t* const HostBuffer)
+{
+	uint16_t GoodBlocks = Drive_GoodBlocks(BlockAddress, Blocks);
+
+	if (!(GoodBlocks))
+	  return 0;
+
+	EndpointModel_BeginIN(HostBuffer, ((uint32_t)GoodBlocks * BLOCKDEV_BLOCK_SIZE));
+	Endpoint_WaitUntilReady();
+
+	for (uint16_t Block = 0; Block < GoodBlocks; Block++)
+	{
+		for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+		{
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				Endpoint_ClearIN();
+				Endpoint_WaitUntilReady();
+			}
+
+			Endpoint_Write_Byte(DriveMedium[BlockAddress + Block][Offset]);
+		}
+	}
+
+	EndpointModel_End();
+
+	Drive_Stats.BlocksRead += GoodBlocks;
+	return GoodBlocks;
+}
+
+/** Receives a group of blocks from the host through the drive's bulk OUT endpoint and stores them on the drive's
+ *  medium, stopping at the drive's bad block.
+ *
+ *  \param[in] BlockAddress  Address of the first block to receive
+ *  \param[in] Blocks        Number of blocks to receive
+ *  \param[in] HostData      Host data containing the blocks
+ *
+ *  \return Number of blocks received
+ */
+static uint16_t Drive_ReceiveBlocks(const uint32_t BlockAddress, const uint16_t Blocks, const uint8_t* const HostData)
+{
+	uint16_t GoodBlocks = Drive_GoodBlocks(BlockAddress, Blocks);
+
+	if (!(GoodBlocks))
+	  return 0;
+
+	EndpointModel_BeginOUT(HostData, ((uint32_t)GoodBlocks * BLOCKDEV_BLOCK_SIZE));
+	Endpoint_WaitUntilReady();
+
+	for (uint16_t Block = 0; Block < GoodBlocks; Block++)
+	{
+		for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+		{
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				Endpoint_ClearOUT();
+				Endpoint_WaitUntilReady();
+			}
+
+			DriveMedium[BlockAddress + Block][Offset] = Endpoint_Read_Byte();
+		}
+	}
+
+	Endpoint_ClearOUT();
+	EndpointModel_End();
+
+	Drive_Stats.BlocksWritten += GoodBlocks;
+	return GoodBlocks;
+}
+
+uint8_t MS_Host_TestUnitReady(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex)
+{
+	if (!(Drive_BeginCommand(MSInterfaceInfo, LUNIndex, 0, 0)))
+	  return DRIVE_COMMAND_FAILED;
+
+	return Drive_EndCommand(true);
+}
+
+uint8_t MS_Host_ReadDeviceCapacity(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+                                   SCSI_Capacity_t* const DeviceCapacity)
+{
+	if (!(Drive_BeginCommand(MSInterfaceInfo, LUNIndex, 0, 0)))
+	  return DRIVE_COMMAND_FAILED;
+
+	EndpointModel_TransferPacket(CAPACITY_DATA_BYTES);
+
+	/* The drive reports the address of its last block rather than the total number of blocks */
+	DeviceCapacity->Blocks    = (DRIVE_BLOCKS - 1);
+	DeviceCapacity->BlockSize = DriveBlockSize;
+
+	return Drive_EndCommand(true);
+}
+
+uint8_t MS_Host_ReadDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+                                 const uint32_t BlockAddress, const uint8_t Blocks, const uint16_t BlockSize,
+                                 void* BlockBuffer)
+{
+	if ((BlockSize != DriveBlockSize) || !(Blocks))
+	  Drive_ProtocolError("read with an invalid block size or count");
+
+	if (!(Drive_BeginCommand(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks)))
+	  return DRIVE_COMMAND_FAILED;
+
+	return Drive_EndCommand(Drive_SendBlocks(BlockAddress, Blocks, BlockBuffer) == Blocks);
+}
+
+uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+                                  const uint32_t BlockAddress, const uint8_t Blocks, const uint16_t BlockSize,
+                                  void* BlockBuffer)
+{
+	if ((BlockSize != DriveBlockSize) || !(Blocks))
+	  Drive_ProtocolError("write with an invalid block size or count");
+
+	if (!(Drive_BeginCommand(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks)))
+	  return DRIVE_COMMAND_FAILED;
+
+	return Drive_EndCommand(Drive_ReceiveBlocks(BlockAddress, Blocks, BlockBuffer) == Blocks);
+}
+
+uint8_t MS_Host_ReadDeviceBlocks_Stream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+                                        const uint32_t BlockAddress, const uint16_t Blocks, const uint16_t BlockSize,
+                                        void* BlockBuffer, MS_Host_BlockCallback_t const Callback)
+{
+	if ((BlockSize != DriveBlockSize) || !(Blocks) || (Blocks > MSHOST_BLOCKDEV_MAX_TRANSFER_BLOCKS))
+	{
+		Drive_ProtocolError("streamed read with an invalid block size or count");
+		return DRIVE_COMMAND_FAILED;
+	}
+
+	if (!(Drive_BeginCommand(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks)))
+	  return DRIVE_COMMAND_FAILED;
+
+	uint16_t SentBlocks = Drive_SendBlocks(BlockAddress, Blocks, DriveStreamData);
+
+	/* Each block is received into the caller's single block buffer and handed to the callback, as the class driver does */
+	for (uint16_t Block = 0; Block < SentBlocks; Block++)
+	{
+		memcpy(BlockBuffer, &DriveStreamData[(uint32_t)Block * BLOCKDEV_BLOCK_SIZE], BLOCKDEV_BLOCK_SIZE);
+
+		if (!(Callback(MSInterfaceInfo, (BlockAddress + Block), BlockBuffer)))
+		  return Drive_EndCommand(false);
+	}
+
+	return Drive_EndCommand(SentBlocks == Blocks);
+}
+
+/** Fills a buffer with random data.
+ *
+ *  \param[out] Buffer  Buffer to fill
+ *  \param[in]  Length  Length of the buffer, in bytes
+ */
+static void FillRandom(uint8_t* const Buffer, const uint32_t Length)
+{
+	for (uint32_t Offset = 0; Offset < Length; Offset++)
+	  Buffer[Offset] = rand();
+}
+
+/** Reads the current contents of a group of blocks directly from the simulated drive.
+ *
+ *  \param[in]  BlockAddress  Address of the first block
+ *  \param[in]  TotalBlocks   Number of blocks to read
+ *  \param[out] Buffer        Buffer where the block contents are to be stored
+ */
+static void GetDriveBlocks(const uint32_t BlockAddress, const uint16_t TotalBlocks, uint8_t* const Buffer)
+{
+	memcpy(Buffer, DriveMedium[BlockAddress], ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE));
+}
+
+/** Compares data transferred by the backend against the expected data, reporting the first difference.
+ *
+ *  \param[in] Operation  Name of the operation, for the failure report
+ *  \param[in] Data       Data transferred by the backend
+ *  \param[in] Expected   Expected data
+ *  \param[in] Length     Length of the data, in bytes
+ *
+ *  \return Number of failures, zero if the data matches or one otherwise
+ */
+static uint32_t CompareData(const char* const Operation, const uint8_t* const Data, const uint8_t* const Expected,
+                            const uint32_t Length)
+{
+	for (uint32_t Offset = 0; Offset < Length; Offset++)
+	{
+		if (Data[Offset] != Expected[Offset])
+		{
+			printf("%s: data mismatch at offset %lu\n", Operation, (unsigned long)Offset);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/** Checks the error code returned by the backend against the expected error code.
+ *
+ *  \param[in] Operation  Name of the operation, for the failure report
+ *  \param[in] ErrorCode  Error code returned by the backend
+ *  \param[in] Expected   Expected error code
+ *
+ *  \return Number of failures, zero if the error code is as expected or one otherwise
+ */
+static uint32_t CheckErrorCode(const char* const Operation, const uint8_t ErrorCode, const uint8_t Expected)
+{
+	if (ErrorCode == Expected)
+	  return 0;
+
+	printf("%s: returned error code %u, expected %u\n", Operation, ErrorCode, Expected);
+	return 1;
+}
+
+/** Checks the number of commands issued to the drive since the given count against the expected number.
+ *
+ *  \param[in] Operation      Name of the operation, for the failure report
+ *  \param[in] StartCommands  Drive command count before the operation
+ *  \param[in] Expected       Expected number of commands issued by the operation
+ *
+ *  \return Number of failures, zero if the command count is as expected or one otherwise
+ */
+static uint32_t CheckCommands(const char* const Operation, const uint32_t StartCommands, const uint32_t Expected)
+{
+	uint32_t Commands = (Drive_Stats.Commands - StartCommands);
+
+	if (Commands == Expected)
+	  return 0;
+
+	printf("%s: issued %lu commands, expected %lu\n", Operation, (unsigned long)Commands, (unsigned long)Expected);
+	return 1;
+}
+
+/** Reads a single block through the backend, checking its contents against the drive and the number of commands the
+ *  read issued to the drive.
+ *
+ *  \param[in] Operation     Name of the operation, for the failure report
+ *  \param[in] BlockAddress  Address of the block to read
+ *  \param[in] Commands      Expected number of commands issued by the read
+ *
+ *  \return Number of failures of the operation
+ */
+static uint32_t ReadBlock(const char* const Operation, const uint32_t BlockAddress, const uint32_t Commands)
+{
+	uint32_t StartCommands = Drive_Stats.Commands;
+
+	GetDriveBlocks(BlockAddress, 1, ExpectedData);
+
+	return (CheckErrorCode(Operation, BlockDevice_ReadBlocks(BlockAddress, 1, HostData), BLOCKDEV_ERROR_NoError) +
+	        CheckCommands(Operation, StartCommands, Commands) +
+	        CompareData(Operation, HostData, ExpectedData, BLOCKDEV_BLOCK_SIZE));
+}
+
+/** Attaches the simulated drive and initializes the backend, emptying the backend's block cache.
+ *
+ *  \return Number of failures of the operation
+ */
+static uint32_t AttachDrive(void)
+{
+	DrivePresent                   = true;
+	DriveBlockSize                 = BLOCKDEV_BLOCK_SIZE;
+	DriveInterface.State.IsActive  = true;
+	USB_HostState                  = HOST_STATE_Configured;
+
+	return CheckErrorCode("Init", BlockDevice_Init(), BLOCKDEV_ERROR_NoError);
+}
+
+/** Checks that the backend refuses to initialize with a drive which is not configured or has an unsupported block size,
+ *  and that it reports the capacity of a supported drive.
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t TestInit(void)
+{
+	uint32_t Failures      = 0;
+	uint32_t StartCommands = Drive_Stats.Commands;
+
+	MSHostBlockDevice_SetInterface(&DriveInterface, 0);
+
+	DrivePresent                  = true;
+	DriveInterface.State.IsActive = false;
+	USB_HostState                 = HOST_STATE_Unattached;
+
+	Failures += CheckErrorCode("Init of unconfigured drive", BlockDevice_Init(), BLOCKDEV_ERROR_NotReady);
+	Failures += CheckCommands("Init of unconfigured drive", StartCommands, 0);
+
+	DriveInterface.State.IsActive = true;
+	USB_HostState                 = HOST_STATE_Configured;
+	DriveBlockSize                = 2048;
+
+	Failures += CheckErrorCode("Init of 2048 byte block drive", BlockDevice_Init(), BLOCKDEV_ERROR_DeviceError);
+
+	Failures += AttachDrive();
+
+	if (BlockDevice_GetTotalBlocks() != DRIVE_BLOCKS)
+	{
+		printf("Init: reported %lu blocks, expected %lu\n", (unsigned long)BlockDevice_GetTotalBlocks(),
+		       (unsigned long)DRIVE_BLOCKS);
+		Failures++;
+	}
+
+	if (!(BlockDevice_CheckOperation()))
+	{
+		printf("Attached drive reported as not operating\n");
+		Failures++;
+	}
+
+	return Failures;
+}
+
+/** Checks that repeated reads of a block are served from the block cache.
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t TestCacheHits(void)
+{
+	uint32_t Failures = AttachDrive();
+
+	Failures += ReadBlock("First read of block", 1000, 1);
+	Failures += ReadBlock("Repeated read of block", 1000, 0);
+	Failures += ReadBlock("Read of other block", 1200, 1);
+	Failures += ReadBlock("Repeated read of first block", 1000, 0);
+
+	return Failures;
+}
+
+/** Checks that once the block cache is full, the least recently used block is the one replaced by a new block.
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t TestEviction(void)
+{
+	uint32_t Failures = AttachDrive();
+
+	/* Blocks are spaced apart so that no read is sequential, and so no read-ahead occurs */
+	for (uint8_t Block = 0; Block < MSHOST_BLOCKDEV_CACHE_BLOCKS; Block++)
+	  Failures += ReadBlock("Fill cache", (2000 + (Block * 10)), 1);
+
+	/* Make the oldest block the most recently used, leaving the second block as the least recently used */
+	Failures += ReadBlock("Touch oldest block", 2000, 0);
+	Failures += ReadBlock("Read new block", 3000, 1);
+
+	Failures += ReadBlock("Read most recently used block", 2000, 0);
+
+	for (uint8_t Block = 2; Block < MSHOST_BLOCKDEV_CACHE_BLOCKS; Block++)
+	  Failures += ReadBlock("Read retained block", (2000 + (Block * 10)), 0);
+
+	Failures += ReadBlock("Read new block again", 3000, 0);
+
+	#if (MSHOST_BLOCKDEV_CACHE_BLOCKS > 1)
+	Failures += ReadBlock("Read evicted block", 2010, 1);
+	#endif
+
+	return Failures;
+}
+
+/** Checks that sequential single block reads read ahead into the block cache, issuing one command for each group of
+ *  read-ahead blocks, and that read-ahead stops at the end of the medium.
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t TestReadAhead(void)
+{
+	uint32_t Failures      = AttachDrive();
+	uint32_t StartCommands = Drive_Stats.Commands;
+	uint32_t ExpectedCommands;
+
+	for (uint16_t Block = 0; Block < 64; Block++)
+	{
+		GetDriveBlocks((4000 + Block), 1, ExpectedData);
+
+		Failures += (CheckErrorCode("Sequential read", BlockDevice_ReadBlocks((4000 + Block), 1, HostData),
+		                            BLOCKDEV_ERROR_NoError) +
+		             CompareData("Sequential read", HostData, ExpectedData, BLOCKDEV_BLOCK_SIZE));
+	}
+
+	/* The first read is not known to be sequential, and each following command reads ahead the next group of blocks */
+	if (MSHOST_BLOCKDEV_READAHEAD_BLOCKS > 1)
+	  ExpectedCommands = (1 + ((63 + (MSHOST_BLOCKDEV_READAHEAD_BLOCKS - 1)) / MSHOST_BLOCKDEV_READAHEAD_BLOCKS));
+	else
+	  ExpectedCommands = 64;
+
+	Failures += CheckCommands("Sequential reads", StartCommands, ExpectedCommands);
+
+	/* Sequential reads interrupted by a read of another block, such as a FAT block, must continue to read ahead */
+	Failures += AttachDrive();
+	Failures += ReadBlock("Read before sequential reads", 4100, 1);
+	Failures += ReadBlock("Read ahead", 4101, 1);
+	Failures += ReadBlock("Read of other block", 32, 1);
+	Failures += ReadBlock("Read ahead after other block", 4102, 1);
+	Failures += ReadBlock("Read of read-ahead block", 4105, ((MSHOST_BLOCKDEV_READAHEAD_BLOCKS > 1) ? 0 : 1));
+
+	/* Read-ahead at the end of the medium must be limited to the remaining blocks */
+	Failures += AttachDrive();
+	Failures += ReadBlock("Read before end of medium", (DRIVE_BLOCKS - 3), 1);
+	Failures += ReadBlock("Read ahead at end of medium", (DRIVE_BLOCKS - 2), 1);
+	Failures += ReadBlock("Read last block", (DRIVE_BLOCKS - 1), ((MSHOST_BLOCKDEV_READAHEAD_BLOCKS > 1) ? 0 : 1));
+
+	return Failures;
+}
+
+/** Checks that writes update cached copies of the written blocks, and that multiple block transfers are split into as
+ *  few commands as possible.
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t TestWrites(void)
+{
+	uint32_t Failures = AttachDrive();
+	uint32_t StartCommands;
+
+	Failures += ReadBlock("Read block before write", 5000, 1);
+
+	StartCommands = Drive_Stats.Commands;
+	FillRandom(HostData, (4 * BLOCKDEV_BLOCK_SIZE));
+	Failures += CheckErrorCode("Write over cached block", BlockDevice_WriteBlocks(4998, 4, HostData),
+	                           BLOCKDEV_ERROR_NoError);
+	Failures += CheckCommands("Write over cached block", StartCommands, 1);
+
+	Failures += ReadBlock("Read written cached block", 5000, 0);
+
+	StartCommands = Drive_Stats.Commands;
+	FillRandom(HostData, (200 * BLOCKDEV_BLOCK_SIZE));
+	memcpy(ExpectedData, HostData, (200 * BLOCKDEV_BLOCK_SIZE));
+	Failures += CheckErrorCode("Large write", BlockDevice_WriteBlocks(6000, 200, HostData), BLOCKDEV_ERROR_NoError);
+	Failures += CheckCommands("Large write", StartCommands, 4);
+
+	StartCommands = Drive_Stats.Commands;
+	Failures += CheckErrorCode("Large read", BlockDevice_ReadBlocks(6000, 200, HostData), BLOCKDEV_ERROR_NoError);
+	Failures += CheckCommands("Large read", StartCommands, 4);
+	Failures += CompareData("Large read", HostData, ExpectedData, (200 * BLOCKDEV_BLOCK_SIZE));
+
+	return Failures;
+}
+
+/** Checks that a failed write or read leaves no stale or partially read blocks in the block cache.
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t TestFailedCommands(void)
+{
+	uint32_t Failures = AttachDrive();
+
+	/* Cache the first block of a write which fails part way through, after the drive has stored its first blocks */
+	Failures += ReadBlock("Read block before failed write", 7000, 1);
+	Failures += ReadBlock("Read other block before failed write", 7100, 1);
+
+	DriveBadBlock = 7002;
+	FillRandom(HostData, (4 * BLOCKDEV_BLOCK_SIZE));
+	Failures += CheckErrorCode("Failed write", BlockDevice_WriteBlocks(7000, 4, HostData), BLOCKDEV_ERROR_DeviceError);
+	DriveBadBlock = DRIVE_NO_BAD_BLOCK;
+
+	/* The drive stored the first block, so the cached copy is stale and must have been discarded */
+	Failures += ReadBlock("Read block after failed write", 7000, 1);
+	Failures += ReadBlock("Read unwritten block after failed write", 7002, 1);
+
+	/* A failed single block read must not leave its partially filled cache entry behind */
+	Failures += ReadBlock("Read block before failed read", 7200, 1);
+
+	DriveBadBlock = 7300;
+	Failures += CheckErrorCode("Failed read", BlockDevice_ReadBlocks(7300, 1, HostData), BLOCKDEV_ERROR_DeviceError);
+	DriveBadBlock = DRIVE_NO_BAD_BLOCK;
+
+	Failures += ReadBlock("Read block after failed read", 7300, 1);
+
+	/* A read-ahead which fails part way through must fail the read, and leave the following reads correct */
+	Failures += ReadBlock("Read block before failed read-ahead", 7400, 1);
+
+	DriveBadBlock = 7401 + (MSHOST_BLOCKDEV_READAHEAD_BLOCKS - 1);
+	Failures += CheckErrorCode("Failed read-ahead", BlockDevice_ReadBlocks(7401, 1, HostData), BLOCKDEV_ERROR_DeviceError);
+	DriveBadBlock = DRIVE_NO_BAD_BLOCK;
+
+	Failures += ReadBlock("Read block after failed read-ahead", 7401, 1);
+
+	return Failures;
+}
+
+/** Checks that the backend reports a removed drive as not operating and refuses to access it once the host has detected
+ *  the removal, and that the cache is emptied when a different drive is then attached.
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t TestRemoval(void)
+{
+	uint32_t Failures = AttachDrive();
+	uint32_t StartCommands;
+
+	Failures += ReadBlock("Read block before removal", 8000, 1);
+
+	/* Until the host detects the removal, commands are issued to the drive and fail */
+	DrivePresent = false;
+
+	if (BlockDevice_CheckOperation() || ((disk_status(0) & (STA_NOINIT | STA_NODISK)) != (STA_NOINIT | STA_NODISK)))
+	{
+		printf("Removed drive reported as operating\n");
+		Failures++;
+	}
+
+	Failures += CheckErrorCode("Read of removed drive", BlockDevice_ReadBlocks(8100, 1, HostData),
+	                           BLOCKDEV_ERROR_DeviceError);
+
+	/* Once the host has detected the removal, the backend must not issue any commands */
+	DriveInterface.State.IsActive = false;
+	USB_HostState                 = HOST_STATE_Unattached;
+	StartCommands                 = Drive_Stats.Commands;
+
+	if (BlockDevice_CheckOperation())
+	{
+		printf("Detached drive reported as operating\n");
+		Failures++;
+	}
+
+	Failures += CheckErrorCode("Read of detached drive", BlockDevice_ReadBlocks(8000, 1, HostData),
+	                           BLOCKDEV_ERROR_NotReady);
+	Failures += CheckErrorCode("Write of detached drive", BlockDevice_WriteBlocks(8000, 1, HostData),
+	                           BLOCKDEV_ERROR_NotReady);
+	Failures += CheckCommands("Access of detached drive", StartCommands, 0);
+
+	/* Attach a different drive, whose contents differ from the block cached from the previous drive */
+	FillRandom(DriveMedium[8000], BLOCKDEV_BLOCK_SIZE);
+
+	Failures += AttachDrive();
+	Failures += ReadBlock("Read block of new drive", 8000, 1);
+
+	if (disk_initialize(0) || disk_status(0))
+	{
+		printf("Attached drive reported to FatFs as not ready\n");
+		Failures++;
+	}
+
+	/* Requests which extend beyond the end of the drive must be rejected without accessing the drive */
+	StartCommands = Drive_Stats.Commands;
+	Failures += CheckErrorCode("Read past end", BlockDevice_ReadBlocks(DRIVE_BLOCKS, 1, HostData),
+	                           BLOCKDEV_ERROR_OutOfRange);
+	Failures += CheckErrorCode("Write past end", BlockDevice_WriteBlocks((DRIVE_BLOCKS - 1), 2, HostData),
+	                           BLOCKDEV_ERROR_OutOfRange);
+	Failures += CheckCommands("Access past end", StartCommands, 0);
+
+	return Failures;
+}
+
+/** Performs a random sequence of reads and writes through the backend, with occasional failed commands, verifying all
+ *  data read against the contents of the simulated drive. Accesses are concentrated on a small area of the drive, and
+ *  are frequently sequential, so that cached and read-ahead blocks are read back after the blocks are written.
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t TestRandom(void)
+{
+	uint32_t Failures  = AttachDrive();
+	uint32_t NextBlock = 0;
+
+	for (uint16_t Operation = 0; Operation < RANDOM_OPERATIONS; Operation++)
+	{
+		uint16_t TotalBlocks  = ((rand() % 4) ? 1 : (1 + (rand() % MAX_TEST_BLOCKS)));
+		uint32_t BlockAddress = ((rand() % 2) ? NextBlock : (rand() % 512));
+		uint32_t Length       = ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
+		bool     Fail         = !(rand() % 32);
+
+		if ((BlockAddress + TotalBlocks) > DRIVE_BLOCKS)
+		  BlockAddress = (DRIVE_BLOCKS - TotalBlocks);
+
+		if (Fail)
+		  DriveBadBlock = (BlockAddress + (rand() % (TotalBlocks + MSHOST_BLOCKDEV_READAHEAD_BLOCKS)));
+
+		if (rand() % 3)
+		{
+			GetDriveBlocks(BlockAddress, TotalBlocks, ExpectedData);
+
+			uint8_t ErrorCode = BlockDevice_ReadBlocks(BlockAddress, TotalBlocks, HostData);
+
+			/* A failed read may fail on a read-ahead block, but must never return incorrect data */
+			if (!(Fail) || (ErrorCode == BLOCKDEV_ERROR_NoError))
+			{
+				Failures += (CheckErrorCode("Random read", ErrorCode, BLOCKDEV_ERROR_NoError) +
+				             CompareData("Random read", HostData, ExpectedData, Length));
+			}
+		}
+		else
+		{
+			FillRandom(HostData, Length);
+
+			Failures += CheckErrorCode("Random write", BlockDevice_WriteBlocks(BlockAddress, TotalBlocks, HostData),
+			                           ((Fail && (DriveBadBlock < (BlockAddress + TotalBlocks))) ?
+			                            BLOCKDEV_ERROR_DeviceError : BLOCKDEV_ERROR_NoError));
+		}
+
+		DriveBadBlock = DRIVE_NO_BAD_BLOCK;
+		NextBlock     = (BlockAddress + TotalBlocks);
+	}
+
+	return Failures;
+}
+
+/** Measures the transfer rate of a typical filesystem access pattern, printing the results.
+ *
+ *  \param[in] Name      Name of the access pattern
+ *  \param[in] FATReads  Number of data blocks read between each re-read of the same FAT block, or zero for none
+ *  \param[in] Blocks    Number of blocks read by each read, or one for single block reads
+ *
+ *  \return Number of failures of the benchmark
+ */
+static uint32_t Benchmark(const char* const Name, const uint16_t FATReads, const uint16_t Blocks)
+{
+	uint32_t Failures      = AttachDrive();
+	uint32_t StartCommands = Drive_Stats.Commands;
+	uint64_t StartNS       = SimTimeNS;
+
+	for (uint32_t BlockAddress = 1024; BlockAddress < (1024 + BENCHMARK_BLOCKS); BlockAddress += Blocks)
+	{
+		/* A filesystem re-reads the same FAT block as it follows the cluster chain of the file being read */
+		if (FATReads && !((BlockAddress - 1024) % FATReads))
+		  Failures += CheckErrorCode(Name, BlockDevice_ReadBlocks(32, 1, HostData), BLOCKDEV_ERROR_NoError);
+
+		GetDriveBlocks(BlockAddress, Blocks, ExpectedData);
+		Failures += (CheckErrorCode(Name, BlockDevice_ReadBlocks(BlockAddress, Blocks, HostData), BLOCKDEV_ERROR_NoError) +
+		             CompareData(Name, HostData, ExpectedData, ((uint32_t)Blocks * BLOCKDEV_BLOCK_SIZE)));
+	}
+
+	double ElapsedMS = ((double)(SimTimeNS - StartNS) / 1000000);
+
+	printf("  %-24s %9.1f %9.1f %8lu\n", Name,
+	       (((double)BENCHMARK_BLOCKS * BLOCKDEV_BLOCK_SIZE / 1024) / (ElapsedMS / 1000)), ElapsedMS,
+	       (unsigned long)(Drive_Stats.Commands - StartCommands));
+
+	return Failures;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	srand(1);
+
+	for (uint32_t Block = 0; Block < DRIVE_BLOCKS; Block++)
+	  FillRandom(DriveMedium[Block], BLOCKDEV_BLOCK_SIZE);
+
+	printf("%u block cache, %u block read-ahead\n", MSHOST_BLOCKDEV_CACHE_BLOCKS, MSHOST_BLOCKDEV_READAHEAD_BLOCKS);
+
+	TotalErrors += TestInit();
+	TotalErrors += TestCacheHits();
+	TotalErrors += TestEviction();
+	TotalErrors += TestReadAhead();
+	TotalErrors += TestWrites();
+	TotalErrors += TestFailedCommands();
+	TotalErrors += TestRemoval();
+	TotalErrors += TestRandom();
+
+	printf("  %u random operations: %lu blocks written, %lu blocks read, %lu errors\n", RANDOM_OPERATIONS,
+	       (unsigned long)Drive_Stats.BlocksWritten, (unsigned long)Drive_Stats.BlocksRead,
+	       (unsigned long)(TotalErrors + Drive_Stats.ProtocolErrors + EndpointModel_Stats.ProtocolErrors));
+
+	printf("  %-24s %9s %9s %8s\n", "Scenario", "KB/s", "Time ms", "Commands");
+
+	TotalErrors += Benchmark("Sequential block reads", 0, 1);
+	TotalErrors += Benchmark("Reads with FAT lookups", 4, 1);
+	TotalErrors += Benchmark("8 block reads", 0, 8);
+
+	TotalErrors += (Drive_Stats.ProtocolErrors + EndpointModel_Stats.ProtocolErrors);
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
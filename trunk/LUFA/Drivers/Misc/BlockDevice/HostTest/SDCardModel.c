@@ -0,0 +1,870 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host model of an MMC or SD card on the AVR's SPI bus, implementing the SPI interface declared in SDCardShim.h. The
+ *  simulated card decodes the SPI mode commands, data tokens and chip select edges used by the SD card block device
+ *  backend byte by byte, with the randomized response latencies a real card may use. Every byte transferred advances
+ *  the simulated time by one byte time at the current SPI clock, written blocks keep the card busy for a typical
+ *  programming time (shorter for blocks pre-erased by SET_WR_BLK_ERASE_COUNT), and read blocks are only sent once the
+ *  card's typical access time has passed. The card may be removed and reinserted at any time. Commands and bytes which
+ *  a real card would reject or misinterpret, such as a command sent while the card is busy or an SPI clock faster than
+ *  the card allows, are counted as protocol errors.
+ *
+ *  Unwritten blocks are not stored, and read back as a fixed pattern derived from their address, so that cards of any
+ *  capacity can be simulated.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../BlockDevice.h"
+#include "SDCardModel.h"
+
+/** Enum for the command decoding states of the simulated card. */
+enum SDCardModel_States_t
+{
+	SDMODEL_STATE_Command, /**< Waiting for or receiving a command */
+	SDMODEL_STATE_ReadBlocks, /**< Sending the blocks of a single or multiple block read */
+	SDMODEL_STATE_WriteToken, /**< Waiting for the start or stop token of a written block */
+	SDMODEL_STATE_WriteData, /**< Receiving the data and CRC of a written block */
+};
+
+/** Size in bytes of the queue of bytes to be sent by the card. */
+#define QUEUE_SIZE                  1024
+
+/** Largest number of bytes the card waits before sending a command response or a register's start token. */
+#define MAX_RESPONSE_LATENCY        8
+
+/** Time for which the card remains busy after the stop token of a multiple block write, in nanoseconds. */
+#define STOP_TRAN_BUSY_NS           50000ULL
+
+/** Time for which the card remains busy after a multiple block read is stopped, in nanoseconds. */
+#define STOP_READ_BUSY_NS           2000ULL
+
+volatile uint8_t PORTB = 0xFF;
+volatile uint8_t DDRB;
+
+SDCardModel_Stats_t SDCardModel_Stats;
+
+/** Type of the simulated card, a value from the \ref SDCardModel_CardTypes_t enum. */
+static uint8_t   CardType;
+
+/** Total number of blocks of the simulated card. */
+static uint32_t  CardBlocks;
+
+/** Written blocks of the card, indexed by block address, or NULL for blocks which have never been written. */
+static uint8_t** Blocks;
+
+/** Address of a block which the card fails to read or write, or SDMODEL_NO_BAD_BLOCK for none. */
+static uint32_t  BadBlock = SDMODEL_NO_BAD_BLOCK;
+
+/** Card Specific Data register of the card. */
+static uint8_t   CSD[16];
+
+/** Maximum SPI clock of the card once it has been initialized, in Hz, as given by its CSD register. */
+static uint32_t  MaxClockHz;
+
+/** Indicates if the card is inserted. */
+static bool      Present;
+
+/** Indicates if the card has been reset into SPI mode since it was inserted. Until then the card ignores every command
+ *  other than GO_IDLE_STATE, as a card still in SD bus mode would.
+ */
+static bool      SPIMode;
+
+/** Indicates if the card is in the idle state, having been reset but not yet initialized. */
+static bool      Idle;
+
+/** Number of further initialization commands the card responds to as still idle, before completing initialization. */
+static uint8_t   InitPollsRemaining;
+
+/** Number of bytes clocked with the card deselected since it was inserted, up to the ten bytes needed for power up. */
+static uint8_t   PowerUpBytes;
+
+/** Indicates if the next command is an application specific command, following an APP_CMD command. */
+static bool      AppCommand;
+
+/** Number of further blocks of the next multiple block write which were pre-erased by SET_WR_BLK_ERASE_COUNT. */
+static uint32_t  PreErasedBlocks;
+
+/** Command decoding state, a value from the \ref SDCardModel_States_t enum. */
+static uint8_t   State;
+
+/** Bytes of the command currently being received. */
+static uint8_t   Command[6];
+
+/** Number of bytes of the current command received so far. */
+static uint8_t   CommandLength;
+
+/** Indicates if the current read or write is a multiple block transfer. */
+static bool      MultipleBlock;
+
+/** Address of the next block of the current read or write. */
+static uint32_t  CurrentBlock;
+
+/** Data and CRC of the block currently being written. */
+static uint8_t   WriteBuffer[BLOCKDEV_BLOCK_SIZE + 2];
+
+/** Number of bytes of the block currently being written received so far. */
+static uint16_t  WritePosition;
+
+/** Simulated time at which the card finishes programming, and releases its data output. */
+static uint64_t  BusyUntilNS;
+
+/** Time for which the card becomes busy once the bytes currently queued have been sent, in nanoseconds. */
+static uint64_t  PendingBusyNS;
+
+/** Simulated time at which the next block of the current read is ready to be sent. */
+static uint64_t  ReadReadyNS;
+
+/** Bytes to be sent by the card, ahead of any busy indication. */
+static uint8_t   Queue[QUEUE_SIZE];
+
+/** Index of the next byte to be sent from the queue. */
+static uint16_t  QueueHead;
+
+/** Number of bytes held in the queue. */
+static uint16_t  QueueLength;
+
+/** SPI clock divider of the AVR, as the log2 of the divider. */
+static uint8_t   SPISpeedShift = 7;
+
+/** Indicates if the card was selected during the previous byte transfer. */
+static bool      WasSelected;
+
+/** Multipliers of the maximum transfer rate, indexed by the time value field of the CSD TRAN_SPEED byte. */
+static const uint8_t TransferRateMultipliers[] = {0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80};
+
+/** Records a protocol error, for a command or byte which a real card would reject or misinterpret.
+ *
+ *  \param[in] Description  Description of the error, printed for the first few errors only
+ */
+static void SDCardModel_ProtocolError(const char* const Description)
+{
+	if (SDCardModel_Stats.ProtocolErrors++ < 10)
+	  printf("SD card protocol error: %s (command %u)\n", Description, (Command[0] & 0x3F));
+}
+
+/** Determines if the card is busy programming written data.
+ *
+ *  \return Boolean true if the card is busy, false otherwise
+ */
+static bool SDCardModel_IsBusy(void)
+{
+	return (SimTimeNS < BusyUntilNS);
+}
+
+/** Checks that the current SPI clock does not exceed the identification clock while the card is uninitialized, or the
+ *  card's maximum transfer rate once it has been initialized.
+ */
+static void SDCardModel_CheckClock(void)
+{
+	if (Idle && (SDCardModel_Stats.SPIClockHz > SDMODEL_IDENTIFICATION_HZ))
+	  SDCardModel_ProtocolError("SPI clock above the identification clock while the card is uninitialized");
+	else if (SDCardModel_Stats.SPIClockHz > MaxClockHz)
+	  SDCardModel_ProtocolError("SPI clock above the card's maximum transfer rate");
+}
+
+/** Adds a byte to the queue of bytes to be sent by the card.
+ *
+ *  \param[in] Byte  Byte to queue
+ */
+static void SDCardModel_QueueByte(const uint8_t Byte)
+{
+	if (QueueLength == QUEUE_SIZE)
+	{
+		printf("SD card model response queue overflow\n");
+		exit(1);
+	}
+
+	Queue[(QueueHead + QueueLength++) % QUEUE_SIZE] = Byte;
+}
+
+/** Queues a random number of idle bytes, for the latency of the card before a response or start token. */
+static void SDCardModel_QueueLatency(void)
+{
+	for (uint8_t Latency = (rand() % MAX_RESPONSE_LATENCY); Latency; Latency--)
+	  SDCardModel_QueueByte(0xFF);
+}
+
+/** Returns the contents of the given block, which is a fixed pattern if the block has never been written.
+ *
+ *  \param[in]  BlockAddress  Address of the block
+ *  \param[out] Buffer        Buffer of \ref BLOCKDEV_BLOCK_SIZE bytes where the contents are to be stored
+ */
+static void SDCardModel_ReadBlock(const uint32_t BlockAddress, uint8_t* const Buffer)
+{
+	if (Blocks[BlockAddress] != NULL)
+	{
+		memcpy(Buffer, Blocks[BlockAddress], BLOCKDEV_BLOCK_SIZE);
+		return;
+	}
+
+	for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+	  Buffer[Offset] = (uint8_t)((BlockAddress * 13) + (BlockAddress >> 8) + Offset);
+}
+
+/** Queues the next block of the current read once it is ready, or an error token once the read reaches a bad block or
+ *  passes the end of the card. No further blocks are sent after an error token.
+ */
+static void SDCardModel_QueueReadBlock(void)
+{
+	uint8_t Data[BLOCKDEV_BLOCK_SIZE];
+
+	if (SimTimeNS < ReadReadyNS)
+	  return;
+
+	if ((CurrentBlock >= CardBlocks) || (CurrentBlock == BadBlock))
+	{
+		/* Out of range or card ECC failed error token */
+		SDCardModel_QueueByte((CurrentBlock >= CardBlocks) ? 0x08 : 0x04);
+		ReadReadyNS = UINT64_MAX;
+
+		if (!(MultipleBlock))
+		  State = SDMODEL_STATE_Command;
+
+		return;
+	}
+
+	SDCardModel_ReadBlock(CurrentBlock++, Data);
+
+	SDCardModel_QueueByte(0xFE);
+
+	for (uint16_t Offset = 0; Offset < BLOCKDEV_BLOCK_SIZE; Offset++)
+	  SDCardModel_QueueByte(Data[Offset]);
+
+	/* The block CRC is not checked by the host while the card is in SPI mode */
+	SDCardModel_QueueByte(0x00);
+	SDCardModel_QueueByte(0x00);
+
+	SDCardModel_Stats.BlocksRead++;
+	ReadReadyNS = (SimTimeNS + SDMODEL_READ_ACCESS_NS);
+
+	if (!(MultipleBlock))
+	  State = SDMODEL_STATE_Command;
+}
+
+/** Decodes the block address argument of a read or write command, which is a byte address for standard capacity cards.
+ *
+ *  \param[in]  Argument      Argument of the command
+ *  \param[out] BlockAddress  Decoded address of the block
+ *
+ *  \return R1 response of the card to the command
+ */
+static uint8_t SDCardModel_DecodeAddress(const uint32_t Argument, uint32_t* const BlockAddress)
+{
+	if (CardType == SDMODEL_CARD_SDHC)
+	{
+		*BlockAddress = Argument;
+	}
+	else
+	{
+		if (Argument % BLOCKDEV_BLOCK_SIZE)
+		{
+			SDCardModel_ProtocolError("byte address not aligned to a block");
+			return 0x20;
+		}
+
+		*BlockAddress = (Argument / BLOCKDEV_BLOCK_SIZE);
+	}
+
+	if (*BlockAddress >= CardBlocks)
+	{
+		SDCardModel_ProtocolError("block address beyond the end of the card");
+		return 0x40;
+	}
+
+	return 0x00;
+}
+
+/** Queues the R1 response of the card to a command, after the card's response latency.
+ *
+ *  \param[in] Response  R1 response to queue
+ */
+static void SDCardModel_QueueResponse(const uint8_t Response)
+{
+	SDCardModel_QueueLatency();
+	SDCardModel_QueueByte(Response);
+}
+
+/** Processes an application specific command, which followed an APP_CMD command.
+ *
+ *  \param[in] Index     Index of the command
+ *  \param[in] Argument  Argument of the command
+ */
+static void SDCardModel_ProcessAppCommand(const uint8_t Index, const uint32_t Argument)
+{
+	switch (Index)
+	{
+		case 41:
+			/* High capacity cards never leave the idle state if the host does not indicate high capacity support */
+			if (((CardType == SDMODEL_CARD_SDHC) && !(Argument & (1UL << 30))) || InitPollsRemaining)
+			{
+				if (InitPollsRemaining)
+				  InitPollsRemaining--;
+
+				SDCardModel_QueueResponse(0x01);
+			}
+			else
+			{
+				Idle = false;
+				SDCardModel_QueueResponse(0x00);
+			}
+
+			break;
+		case 23:
+			if (Idle)
+			  SDCardModel_ProtocolError("SET_WR_BLK_ERASE_COUNT sent to an uninitialized card");
+
+			PreErasedBlocks = (Argument & 0x7FFFFF);
+			SDCardModel_QueueResponse(0x00);
+			break;
+		default:
+			SDCardModel_QueueResponse(0x04 | Idle);
+			break;
+	}
+}
+
+/** Processes a complete command received from the host, queueing the card's response. */
+static void SDCardModel_ProcessCommand(void)
+{
+	uint8_t  Index        = (Command[0] & 0x3F);
+	uint32_t Argument     = (((uint32_t)Command[1] << 24) | ((uint32_t)Command[2] << 16) |
+	                         ((uint16_t)Command[3] << 8)  | Command[4]);
+	bool     IsAppCommand = AppCommand;
+	uint32_t BlockAddress;
+	uint8_t  Response;
+
+	SDCardModel_Stats.Commands++;
+	AppCommand = false;
+
+	if (!(Command[5] & 0x01))
+	  SDCardModel_ProtocolError("command without an end bit");
+
+	if (!(SPIMode))
+	{
+		if (Index != 0)
+		  return;
+
+		if (PowerUpBytes < 10)
+		  SDCardModel_ProtocolError("card reset before it completed its power up sequence");
+
+		SDCardModel_CheckClock();
+	}
+
+	if (IsAppCommand)
+	{
+		SDCardModel_ProcessAppCommand(Index, Argument);
+		return;
+	}
+
+	/* Only the reset, identification and initialization commands are accepted by an uninitialized card */
+	if (Idle && (Index != 0) && (Index != 1) && (Index != 8) && (Index != 55) && (Index != 58))
+	{
+		SDCardModel_ProtocolError("command sent to an uninitialized card");
+		SDCardModel_QueueResponse(0x05);
+		return;
+	}
+
+	/* The pre-erase count only applies to a multiple block write which immediately follows it */
+	if (Index != 25)
+	  PreErasedBlocks = 0;
+
+	switch (Index)
+	{
+		case 0:
+			/* The CRC of the reset command is checked, as the card is not yet in SPI mode */
+			if (Command[5] != 0x95)
+			{
+				SDCardModel_ProtocolError("GO_IDLE_STATE sent with an incorrect CRC");
+				break;
+			}
+
+			SPIMode            = true;
+			Idle               = true;
+			InitPollsRemaining = (1 + (rand() % 8));
+			SDCardModel_QueueResponse(0x01);
+			break;
+		case 1:
+			if (InitPollsRemaining)
+			{
+				InitPollsRemaining--;
+				SDCardModel_QueueResponse(0x01);
+			}
+			else
+			{
+				Idle = false;
+				SDCardModel_QueueResponse(0x00);
+			}
+
+			break;
+		case 8:
+			if ((CardType == SDMODEL_CARD_MMC) || (CardType == SDMODEL_CARD_SDv1))
+			{
+				SDCardModel_QueueResponse(0x04 | Idle);
+				break;
+			}
+
+			if (Command[5] != 0x87)
+			  SDCardModel_ProtocolError("SEND_IF_COND sent with an incorrect CRC");
+
+			/* The card echoes back the accepted voltage range and check pattern */
+			SDCardModel_QueueResponse(Idle);
+			SDCardModel_QueueByte(0x00);
+			SDCardModel_QueueByte(0x00);
+			SDCardModel_QueueByte((Argument >> 8) & 0x0F);
+			SDCardModel_QueueByte(Argument);
+			break;
+		case 55:
+			/* MMC cards do not accept application specific commands, which is only used to identify them */
+			if (CardType == SDMODEL_CARD_MMC)
+			{
+				if (!(Idle))
+				  SDCardModel_ProtocolError("APP_CMD sent to an initialized MMC card");
+
+				SDCardModel_QueueResponse(0x04 | Idle);
+				break;
+			}
+
+			AppCommand = true;
+			SDCardModel_QueueResponse(Idle);
+			break;
+		case 58:
+			/* The card capacity status bit is only valid once the card has been initialized */
+			SDCardModel_QueueResponse(Idle);
+			SDCardModel_QueueByte(0x80 | (((CardType == SDMODEL_CARD_SDHC) && !(Idle)) ? 0x40 : 0x00));
+			SDCardModel_QueueByte(0xFF);
+			SDCardModel_QueueByte(0x80);
+			SDCardModel_QueueByte(0x00);
+			break;
+		case 9:
+			SDCardModel_QueueResponse(0x00);
+			SDCardModel_QueueLatency();
+			SDCardModel_QueueByte(0xFE);
+
+			for (uint8_t ByteNum = 0; ByteNum < sizeof(CSD); ByteNum++)
+			  SDCardModel_QueueByte(CSD[ByteNum]);
+
+			SDCardModel_QueueByte(0x00);
+			SDCardModel_QueueByte(0x00);
+			break;
+		case 13:
+			SDCardModel_QueueResponse(0x00);
+			SDCardModel_QueueByte(0x00);
+			break;
+		case 16:
+			if (Argument != BLOCKDEV_BLOCK_SIZE)
+			  SDCardModel_ProtocolError("SET_BLOCKLEN sent with a block length other than the block device block size");
+
+			SDCardModel_QueueResponse((Argument == BLOCKDEV_BLOCK_SIZE) ? 0x00 : 0x40);
+			break;
+		case 17:
+		case 18:
+		case 24:
+		case 25:
+			if ((Response = SDCardModel_DecodeAddress(Argument, &BlockAddress)) != 0x00)
+			{
+				SDCardModel_QueueResponse(Response);
+				break;
+			}
+
+			SDCardModel_QueueResponse(0x00);
+
+			CurrentBlock  = BlockAddress;
+			MultipleBlock = ((Index == 18) || (Index == 25));
+
+			if ((Index == 17) || (Index == 18))
+			{
+				State       = SDMODEL_STATE_ReadBlocks;
+				ReadReadyNS = (SimTimeNS + SDMODEL_READ_ACCESS_NS);
+			}
+			else
+			{
+				State = SDMODEL_STATE_WriteToken;
+			}
+
+			break;
+		case 12:
+			SDCardModel_ProtocolError("STOP_TRANSMISSION sent outside of a multiple block read");
+			SDCardModel_QueueResponse(0x00);
+			break;
+		default:
+			SDCardModel_QueueResponse(0x04);
+			break;
+	}
+}
+
+/** Processes a complete command received during a multiple block read, which must be a stop command. */
+static void SDCardModel_StopRead(void)
+{
+	SDCardModel_Stats.Commands++;
+
+	if ((Command[0] & 0x3F) != 12)
+	  SDCardModel_ProtocolError("command other than STOP_TRANSMISSION sent during a read");
+
+	/* The card abandons the block being sent, and sends a stuff byte before its busy response */
+	QueueLength = 0;
+	State       = SDMODEL_STATE_Command;
+
+	SDCardModel_QueueByte(rand());
+	SDCardModel_QueueResponse(0x00);
+	PendingBusyNS = STOP_READ_BUSY_NS;
+}
+
+/** Processes a byte received while waiting for the start token of a written block. */
+static void SDCardModel_ReceiveWriteToken(const uint8_t Byte)
+{
+	if (Byte == 0xFF)
+	  return;
+
+	if (Byte == (MultipleBlock ? 0xFC : 0xFE))
+	{
+		State         = SDMODEL_STATE_WriteData;
+		WritePosition = 0;
+	}
+	else if (MultipleBlock && (Byte == 0xFD))
+	{
+		/* The card sends one further byte before it begins programming the remaining data */
+		State           = SDMODEL_STATE_Command;
+		PreErasedBlocks = 0;
+
+		SDCardModel_QueueByte(0xFF);
+		PendingBusyNS = STOP_TRAN_BUSY_NS;
+	}
+	else
+	{
+		SDCardModel_ProtocolError("invalid write start token");
+	}
+}
+
+/** Processes a data or CRC byte of a written block, storing the block once it is complete. */
+static void SDCardModel_ReceiveWriteData(const uint8_t Byte)
+{
+	WriteBuffer[WritePosition++] = Byte;
+
+	if (WritePosition < sizeof(WriteBuffer))
+	  return;
+
+	State = (MultipleBlock ? SDMODEL_STATE_WriteToken : SDMODEL_STATE_Command);
+
+	if (CurrentBlock >= CardBlocks)
+	{
+		SDCardModel_ProtocolError("block written beyond the end of the card");
+		SDCardModel_QueueByte(0xED);
+		return;
+	}
+
+	/* Bad blocks are rejected with a write error data response, without programming */
+	if (CurrentBlock == BadBlock)
+	{
+		SDCardModel_QueueByte(0xED);
+		CurrentBlock++;
+		return;
+	}
+
+	if (Blocks[CurrentBlock] == NULL)
+	  Blocks[CurrentBlock] = malloc(BLOCKDEV_BLOCK_SIZE);
+
+	memcpy(Blocks[CurrentBlock++], WriteBuffer, BLOCKDEV_BLOCK_SIZE);
+
+	uint64_t ProgramNS = SDMODEL_PROGRAM_NS;
+
+	if (PreErasedBlocks)
+	{
+		PreErasedBlocks--;
+		ProgramNS = SDMODEL_PRE_ERASED_NS;
+
+		SDCardModel_Stats.BlocksPreErased++;
+	}
+
+	SDCardModel_Stats.BlocksWritten++;
+
+	/* The data accepted response is followed by the busy indication while the card programs the block */
+	SDCardModel_QueueByte(0xE5);
+	PendingBusyNS = (ProgramNS + (rand() % (ProgramNS / 2)));
+}
+
+/** Ends the current command or transfer as the card is deselected. */
+static void SDCardModel_Deselect(void)
+{
+	if ((State == SDMODEL_STATE_ReadBlocks) && MultipleBlock)
+	  SDCardModel_ProtocolError("card deselected during a multiple block read");
+	else if ((State == SDMODEL_STATE_WriteToken) || (State == SDMODEL_STATE_WriteData))
+	  SDCardModel_ProtocolError("card deselected during a block write");
+
+	/* The card continues to program any written data while deselected */
+	if (PendingBusyNS)
+	  BusyUntilNS = (SimTimeNS + PendingBusyNS);
+
+	State         = SDMODEL_STATE_Command;
+	CommandLength = 0;
+	QueueLength   = 0;
+	PendingBusyNS = 0;
+}
+
+void SPI_Init(const uint8_t SPIOptions)
+{
+	if (!(SPIOptions & SPI_MODE_MASTER) || (SPIOptions & (SPI_SCK_LEAD_FALLING | SPI_SAMPLE_TRAILING)))
+	  SDCardModel_ProtocolError("SPI interface not configured as a mode 0 master");
+
+	SPISpeedShift                = (SPIOptions & SPI_SPEED_MASK);
+	SDCardModel_Stats.SPIClockHz = (SIM_CPU_HZ >> SPISpeedShift);
+}
+
+uint8_t SPI_TransferByte(const uint8_t Byte)
+{
+	bool    Selected = !(PORTB & SDMODEL_CS_MASK);
+	uint8_t Response = 0xFF;
+
+	/* Each byte takes eight SPI clocks, plus the loop overhead of the backend */
+	SimTimeNS += ((((8UL << SPISpeedShift) + SIM_CYCLES_PER_SPI_BYTE - 16) * 1000000000ULL) / SIM_CPU_HZ);
+	SDCardModel_Stats.SPIBytes++;
+
+	if (WasSelected && !(Selected))
+	  SDCardModel_Deselect();
+
+	WasSelected = Selected;
+
+	if (!(Present))
+	  return 0xFF;
+
+	if (!(Selected))
+	{
+		if (PowerUpBytes < 10)
+		  PowerUpBytes++;
+
+		return 0xFF;
+	}
+
+	if (SPIMode)
+	  SDCardModel_CheckClock();
+
+	if (QueueLength)
+	{
+		Response  = Queue[QueueHead];
+		QueueHead = ((QueueHead + 1) % QUEUE_SIZE);
+
+		/* The card becomes busy once it has sent the response which precedes the busy indication */
+		if (!(--QueueLength) && PendingBusyNS)
+		{
+			BusyUntilNS   = (SimTimeNS + PendingBusyNS);
+			PendingBusyNS = 0;
+		}
+	}
+	else if (SDCardModel_IsBusy())
+	{
+		SDCardModel_Stats.BusyBytes++;
+
+		if (Byte != 0xFF)
+		  SDCardModel_ProtocolError("byte sent while the card is busy");
+
+		return 0x00;
+	}
+
+	switch (State)
+	{
+		case SDMODEL_STATE_Command:
+			if (!(CommandLength) && ((Byte & 0xC0) != 0x40))
+			{
+				if (Byte != 0xFF)
+				  SDCardModel_ProtocolError("invalid command start byte");
+
+				break;
+			}
+
+			if (!(CommandLength) && QueueLength)
+			  SDCardModel_ProtocolError("command sent before the previous response was received");
+
+			Command[CommandLength++] = Byte;
+
+			if (CommandLength == sizeof(Command))
+			{
+				CommandLength = 0;
+				SDCardModel_ProcessCommand();
+			}
+
+			break;
+		case SDMODEL_STATE_ReadBlocks:
+			if (CommandLength || ((Byte & 0xC0) == 0x40))
+			{
+				Command[CommandLength++] = Byte;
+
+				if (CommandLength == sizeof(Command))
+				{
+					CommandLength = 0;
+					SDCardModel_StopRead();
+				}
+
+				break;
+			}
+
+			if (Byte != 0xFF)
+			  SDCardModel_ProtocolError("data output not held high during a read");
+
+			if (!(QueueLength))
+			  SDCardModel_QueueReadBlock();
+
+			break;
+		case SDMODEL_STATE_WriteToken:
+			SDCardModel_ReceiveWriteToken(Byte);
+			break;
+		case SDMODEL_STATE_WriteData:
+			SDCardModel_ReceiveWriteData(Byte);
+			break;
+	}
+
+	return Response;
+}
+
+/** Inserts a new card of the given type and capacity. Every block of the new card holds its unwritten pattern.
+ *
+ *  \param[in] Type           Type of card, a value from the \ref SDCardModel_CardTypes_t enum
+ *  \param[in] TotalBlocks    Capacity of the card in blocks, a multiple of 1024 blocks
+ *  \param[in] TransferSpeed  TRAN_SPEED byte of the card's CSD register, giving the card's maximum SPI clock
+ */
+void SDCardModel_Insert(const uint8_t Type, const uint32_t TotalBlocks, const uint8_t TransferSpeed)
+{
+	if (Blocks != NULL)
+	{
+		for (uint32_t BlockAddress = 0; BlockAddress < CardBlocks; BlockAddress++)
+		  free(Blocks[BlockAddress]);
+
+		free(Blocks);
+	}
+
+	CardType   = Type;
+	CardBlocks = TotalBlocks;
+	Blocks     = calloc(TotalBlocks, sizeof(uint8_t*));
+
+	memset(CSD, 0x00, sizeof(CSD));
+	CSD[3] = TransferSpeed;
+
+	if (Type == SDMODEL_CARD_SDHC)
+	{
+		uint32_t DeviceSize = ((TotalBlocks >> 10) - 1);
+
+		/* Version 2 CSD structure, whose device size is in units of 512KB */
+		CSD[0] = 0x40;
+		CSD[7] = ((DeviceSize >> 16) & 0x3F);
+		CSD[8] = (DeviceSize >> 8);
+		CSD[9] = DeviceSize;
+	}
+	else
+	{
+		uint8_t BlockLengthBits = 9;
+		uint8_t SizeMultiplier  = 0;
+
+		/* Version 1 CSD structure, using the smallest size multiplier and block length which fit the device size field */
+		while ((TotalBlocks >> (SizeMultiplier + 2 + BlockLengthBits - 9)) > 4096)
+		{
+			if (SizeMultiplier < 7)
+			  SizeMultiplier++;
+			else
+			  BlockLengthBits++;
+		}
+
+		uint16_t DeviceSize = ((TotalBlocks >> (SizeMultiplier + 2 + BlockLengthBits - 9)) - 1);
+
+		CSD[0]  = ((Type == SDMODEL_CARD_MMC) ? 0x80 : 0x00);
+		CSD[5]  = BlockLengthBits;
+		CSD[6]  = ((DeviceSize >> 10) & 0x03);
+		CSD[7]  = (DeviceSize >> 2);
+		CSD[8]  = (DeviceSize << 6);
+		CSD[9]  = (SizeMultiplier >> 1);
+		CSD[10] = (SizeMultiplier << 7);
+	}
+
+	MaxClockHz = (10000UL * TransferRateMultipliers[(TransferSpeed >> 3) & 0x0F]);
+
+	for (uint8_t RateUnit = (TransferSpeed & 0x07); RateUnit; RateUnit--)
+	  MaxClockHz *= 10;
+
+	SDCardModel_SetPresent(true);
+}
+
+/** Removes or reinserts the current card. A reinserted card keeps its contents, and must be initialized again.
+ *
+ *  \param[in] IsPresent  Boolean true to insert the card, false to remove it
+ */
+void SDCardModel_SetPresent(const bool IsPresent)
+{
+	Present            = IsPresent;
+	SPIMode            = false;
+	Idle               = true;
+	InitPollsRemaining = 0;
+	PowerUpBytes       = 0;
+	AppCommand         = false;
+	PreErasedBlocks    = 0;
+	State              = SDMODEL_STATE_Command;
+	CommandLength      = 0;
+	QueueLength        = 0;
+	BusyUntilNS        = 0;
+	PendingBusyNS      = 0;
+}
+
+/** Determines if the card is still programming written data.
+ *
+ *  \return Boolean true if the card is present and busy, false otherwise
+ */
+bool SDCardModel_IsProgramming(void)
+{
+	return (Present && (SDCardModel_IsBusy() || PendingBusyNS));
+}
+
+/** Sets a block which the card fails to read or write, as a worn out or damaged card would.
+ *
+ *  \param[in] BlockAddress  Address of the bad block, or SDMODEL_NO_BAD_BLOCK for none
+ */
+void SDCardModel_SetBadBlock(const uint32_t BlockAddress)
+{
+	BadBlock = BlockAddress;
+}
+
+/** Resets the operation counters of the card, other than the current SPI clock. */
+void SDCardModel_ResetStats(void)
+{
+	uint32_t SPIClockHz = SDCardModel_Stats.SPIClockHz;
+
+	memset(&SDCardModel_Stats, 0x00, sizeof(SDCardModel_Stats));
+	SDCardModel_Stats.SPIClockHz = SPIClockHz;
+}
+
+/** Retrieves the current contents of a block of the card.
+ *
+ *  \param[in]  BlockAddress  Address of the block
+ *  \param[out] Buffer        Buffer of \ref BLOCKDEV_BLOCK_SIZE bytes where the contents are to be stored
+ */
+void SDCardModel_GetBlock(const uint32_t BlockAddress, uint8_t* const Buffer)
+{
+	SDCardModel_ReadBlock(BlockAddress, Buffer);
+}
@@ -0,0 +1,101 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for SDCardModel.c.
+ */
+
+#ifndef _SDCARD_MODEL_H_
+#define _SDCARD_MODEL_H_
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+
+		#include "SimTime.h"
+
+	/* Macros: */
+		/** Mask of the simulated card's chip select line on PORTB, the default of the SD card block device backend. */
+		#define SDMODEL_CS_MASK             (1 << 0)
+
+		/** Maximum SPI clock of a card which has not yet been initialized, in Hz. */
+		#define SDMODEL_IDENTIFICATION_HZ   400000UL
+
+		/** Typical time taken by the card to program a written block, in nanoseconds. */
+		#define SDMODEL_PROGRAM_NS          800000ULL
+
+		/** Typical time taken by the card to program a written block which was pre-erased following a
+		 *  SET_WR_BLK_ERASE_COUNT command, in nanoseconds.
+		 */
+		#define SDMODEL_PRE_ERASED_NS       250000ULL
+
+		/** Value for \ref SDCardModel_SetBadBlock() indicating that every block of the card can be read and written. */
+		#define SDMODEL_NO_BAD_BLOCK        UINT32_MAX
+
+		/** Typical time taken by the card to read a block before sending it to the host, in nanoseconds. */
+		#define SDMODEL_READ_ACCESS_NS      100000ULL
+
+	/* Enums: */
+		/** Enum for the types of card which can be simulated. */
+		enum SDCardModel_CardTypes_t
+		{
+			SDMODEL_CARD_MMC  = 0, /**< MultiMediaCard, which does not accept the SD application specific commands */
+			SDMODEL_CARD_SDv1 = 1, /**< Version 1 SD card, which does not accept the SEND_IF_COND command */
+			SDMODEL_CARD_SDv2 = 2, /**< Standard capacity version 2 SD card */
+			SDMODEL_CARD_SDHC = 3, /**< High capacity version 2 SD card, which is block rather than byte addressed */
+		};
+
+	/* Type Defines: */
+		/** Type define for the operation counters of the simulated card. */
+		typedef struct
+		{
+			uint64_t Commands; /**< Number of commands received */
+			uint64_t BlocksWritten; /**< Number of blocks written */
+			uint64_t BlocksPreErased; /**< Number of written blocks which were pre-erased by a SET_WR_BLK_ERASE_COUNT command */
+			uint64_t BlocksRead; /**< Number of blocks read */
+			uint64_t BusyBytes; /**< Number of bytes clocked out of the selected card while it was busy programming */
+			uint64_t SPIBytes; /**< Number of bytes transferred over the SPI bus */
+			uint32_t SPIClockHz; /**< Current SPI clock, in Hz */
+			uint32_t ProtocolErrors; /**< Number of commands or bytes the real card would have rejected or misinterpreted */
+		} SDCardModel_Stats_t;
+
+	/* External Variables: */
+		extern SDCardModel_Stats_t SDCardModel_Stats;
+
+	/* Function Prototypes: */
+		void SDCardModel_Insert(const uint8_t Type, const uint32_t TotalBlocks, const uint8_t TransferSpeed);
+		void SDCardModel_SetPresent(const bool IsPresent);
+		bool SDCardModel_IsProgramming(void);
+		void SDCardModel_SetBadBlock(const uint32_t BlockAddress);
+		void SDCardModel_ResetStats(void);
+		void SDCardModel_GetBlock(const uint32_t BlockAddress, uint8_t* const Buffer);
+
+#endif
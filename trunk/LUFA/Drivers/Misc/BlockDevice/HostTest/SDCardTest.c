@@ -0,0 +1,521 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host test and benchmark for the SD card block device backend. The backend is built for the host against a model of
+ *  an MMC or SD card on the SPI bus (see SDCardModel.c) and of a full speed bulk endpoint (see EndpointModel.c). For
+ *  each simulated card, the backend is checked to report the card's capacity and to select the fastest SPI clock the
+ *  card allows, and a random sequence of buffer and endpoint reads and writes, aborted endpoint transfers, busy polls,
+ *  flushes, operation checks and card removals is then verified against the contents of the simulated card. Finally
+ *  the sustained transfer rate of sequential endpoint reads and writes is reported from the simulated time.
+ *
+ *  Card timings are modelled from typical values rather than measured, and so are most useful for comparing backend
+ *  changes against each other. Build and run with "make sd" in this directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../BlockDevice.h"
+#include "SDCardModel.h"
+#include "EndpointModel.h"
+
+/** Size in bytes of the command block wrapper sent by the host before each mass storage command. */
+#define COMMAND_WRAPPER_BYTES    31
+
+/** Size in bytes of the command status wrapper sent by the device after each mass storage command. */
+#define STATUS_WRAPPER_BYTES     13
+
+/** Largest number of blocks transferred by a single command. */
+#define MAX_COMMAND_BLOCKS       64
+
+/** Number of random operations performed on each simulated card. */
+#define RANDOM_OPERATIONS        1500
+
+/** Total number of blocks transferred by each benchmark scenario. */
+#define BENCHMARK_BLOCKS         2048
+
+/** Type define for a simulated card configuration. */
+typedef struct
+{
+	const char* Name; /**< Name of the card configuration */
+	uint8_t     Type; /**< Type of card, a value from the \ref SDCardModel_CardTypes_t enum */
+	uint32_t    TotalBlocks; /**< Capacity of the card, in blocks */
+	uint8_t     TransferSpeed; /**< TRAN_SPEED byte of the card's CSD register */
+	uint32_t    ExpectedClockHz; /**< SPI clock the backend is expected to select for the card, in Hz */
+} Card_t;
+
+/** Simulated card configurations, each tested in order. */
+static const Card_t Cards[] =
+	{
+		{"16MB MMC",          SDMODEL_CARD_MMC,    32768, 0x2A, (F_CPU / 2)},
+		{"2GB SD v1",         SDMODEL_CARD_SDv1, 4194304, 0x32, (F_CPU / 2)},
+		{"512MB SD v2 slow",  SDMODEL_CARD_SDv2, 1048576, 0x19, (F_CPU / 8)},
+		{"4GB SDHC",          SDMODEL_CARD_SDHC, 8388608, 0x32, (F_CPU / 2)},
+	};
+
+/** Current simulated time, in nanoseconds. */
+uint64_t SimTimeNS;
+
+/** Host data buffer for the data phase of each command. */
+static uint8_t HostData[MAX_COMMAND_BLOCKS * BLOCKDEV_BLOCK_SIZE];
+
+/** Expected contents of the blocks of each command, once the command completes. */
+static uint8_t ExpectedData[MAX_COMMAND_BLOCKS * BLOCKDEV_BLOCK_SIZE];
+
+/** Abort flag passed to the backend's endpoint transfer functions. */
+static volatile bool AbortFlag;
+
+/** Fills a buffer with random data.
+ *
+ *  \param[out] Buffer  Buffer to fill
+ *  \param[in]  Length  Length of the buffer, in bytes
+ */
+static void FillRandom(uint8_t* const Buffer, const uint32_t Length)
+{
+	for (uint32_t Offset = 0; Offset < Length; Offset++)
+	  Buffer[Offset] = rand();
+}
+
+/** Reads the current contents of a group of blocks directly from the simulated card.
+ *
+ *  \param[in]  BlockAddress  Address of the first block
+ *  \param[in]  TotalBlocks   Number of blocks to read
+ *  \param[out] Buffer        Buffer where the block contents are to be stored
+ */
+static void GetCardBlocks(const uint32_t BlockAddress, const uint16_t TotalBlocks, uint8_t* const Buffer)
+{
+	for (uint16_t Block = 0; Block < TotalBlocks; Block++)
+	  SDCardModel_GetBlock(BlockAddress + Block, &Buffer[Block * BLOCKDEV_BLOCK_SIZE]);
+}
+
+/** Compares data transferred by the backend against the expected data, reporting the first difference.
+ *
+ *  \param[in] Operation  Name of the operation, for the failure report
+ *  \param[in] Data       Data transferred by the backend
+ *  \param[in] Expected   Expected data
+ *  \param[in] Length     Length of the data, in bytes
+ *
+ *  \return Number of failures, zero if the data matches or one otherwise
+ */
+static uint32_t CompareData(const char* const Operation, const uint8_t* const Data, const uint8_t* const Expected,
+                            const uint32_t Length)
+{
+	for (uint32_t Offset = 0; Offset < Length; Offset++)
+	{
+		if (Data[Offset] != Expected[Offset])
+		{
+			printf("%s: data mismatch at offset %lu\n", Operation, (unsigned long)Offset);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/** Checks the error code returned by the backend against the expected error code.
+ *
+ *  \param[in] Operation  Name of the operation, for the failure report
+ *  \param[in] ErrorCode  Error code returned by the backend
+ *  \param[in] Expected   Expected error code
+ *
+ *  \return Number of failures, zero if the error code is as expected or one otherwise
+ */
+static uint32_t CheckErrorCode(const char* const Operation, const uint8_t ErrorCode, const uint8_t Expected)
+{
+	if (ErrorCode == Expected)
+	  return 0;
+
+	printf("%s: returned error code %u, expected %u\n", Operation, ErrorCode, Expected);
+	return 1;
+}
+
+/** Writes a group of blocks through the simulated endpoint, optionally aborting the transfer part way through, and
+ *  checks the blocks written to the card. Blocks after an aborted block are unchanged, and the remainder of an aborted
+ *  block is padded from the aborted 16 byte chunk onwards.
+ *
+ *  \param[in] BlockAddress  Address of the first block to write
+ *  \param[in] TotalBlocks   Number of blocks to write
+ *  \param[in] Abort         Boolean true to abort the transfer at a random point, false to complete it
+ *
+ *  \return Number of failures of the operation
+ */
+static uint32_t EndpointWrite(const uint32_t BlockAddress, const uint16_t TotalBlocks, const bool Abort)
+{
+	uint32_t Length      = ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
+	uint32_t AbortOffset = (1 + (rand() % Length));
+	uint8_t  ErrorCode;
+
+	FillRandom(HostData, Length);
+	GetCardBlocks(BlockAddress, TotalBlocks, ExpectedData);
+
+	EndpointModel_TransferPacket(COMMAND_WRAPPER_BYTES);
+	EndpointModel_BeginOUT(HostData, Length);
+
+	if (Abort)
+	  EndpointModel_AbortAt(&AbortFlag, AbortOffset);
+	else
+	  AbortFlag = false;
+
+	ErrorCode = BlockDevice_WriteBlocks_Endpoint(BlockAddress, TotalBlocks, &AbortFlag);
+	EndpointModel_End();
+	EndpointModel_TransferPacket(STATUS_WRAPPER_BYTES);
+
+	if (Abort)
+	{
+		uint32_t ChunkEnd = ((AbortOffset + 15) & ~15UL);
+		uint32_t BlockEnd = ((AbortOffset + (BLOCKDEV_BLOCK_SIZE - 1)) & ~(BLOCKDEV_BLOCK_SIZE - 1UL));
+
+		memcpy(ExpectedData, HostData, ChunkEnd);
+		memset(&ExpectedData[ChunkEnd], 0xFF, (BlockEnd - ChunkEnd));
+	}
+	else
+	{
+		memcpy(ExpectedData, HostData, Length);
+	}
+
+	GetCardBlocks(BlockAddress, TotalBlocks, HostData);
+
+	return (CheckErrorCode("Endpoint write", ErrorCode, (Abort ? BLOCKDEV_ERROR_Aborted : BLOCKDEV_ERROR_NoError)) +
+	        CompareData("Endpoint write", HostData, ExpectedData, Length));
+}
+
+/** Reads a group of blocks through the simulated endpoint, optionally aborting the transfer part way through, and checks
+ *  the data received by the host.
+ *
+ *  \param[in] BlockAddress  Address of the first block to read
+ *  \param[in] TotalBlocks   Number of blocks to read
+ *  \param[in] Abort         Boolean true to abort the transfer at a random point, false to complete it
+ *
+ *  \return Number of failures of the operation
+ */
+static uint32_t EndpointRead(const uint32_t BlockAddress, const uint16_t TotalBlocks, const bool Abort)
+{
+	uint32_t Length = ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
+	uint8_t  ErrorCode;
+
+	GetCardBlocks(BlockAddress, TotalBlocks, ExpectedData);
+
+	EndpointModel_TransferPacket(COMMAND_WRAPPER_BYTES);
+	EndpointModel_BeginIN(HostData, Length);
+
+	if (Abort)
+	  EndpointModel_AbortAt(&AbortFlag, (1 + (rand() % Length)));
+	else
+	  AbortFlag = false;
+
+	ErrorCode = BlockDevice_ReadBlocks_Endpoint(BlockAddress, TotalBlocks, &AbortFlag);
+	uint32_t Received = EndpointModel_End();
+	EndpointModel_TransferPacket(STATUS_WRAPPER_BYTES);
+
+	return (CheckErrorCode("Endpoint read", ErrorCode, (Abort ? BLOCKDEV_ERROR_Aborted : BLOCKDEV_ERROR_NoError)) +
+	        CompareData("Endpoint read", HostData, ExpectedData, Received));
+}
+
+/** Removes the card and checks that the backend reports it as not ready, either from an operation check or from a
+ *  failed transfer, then reinserts the card and checks that it is initialized again by an operation check.
+ *
+ *  \param[in] Card  Configuration of the simulated card
+ *
+ *  \return Number of failures of the operation
+ */
+static uint32_t RemoveCard(const Card_t* const Card)
+{
+	uint32_t Failures = 0;
+
+	SDCardModel_SetPresent(false);
+
+	if (rand() % 2)
+	{
+		if (BlockDevice_CheckOperation())
+		{
+			printf("Removed card reported as operating\n");
+			Failures++;
+		}
+	}
+	else
+	{
+		Failures += CheckErrorCode("Write to removed card", BlockDevice_WriteBlocks(0, (1 + (rand() % 4)), HostData),
+		                           BLOCKDEV_ERROR_NotReady);
+	}
+
+	/* Once the removal has been detected, the card must be forgotten until it is initialized again */
+	if (BlockDevice_GetTotalBlocks())
+	{
+		printf("Removed card reported with a capacity\n");
+		Failures++;
+	}
+
+	Failures += CheckErrorCode("Read of removed card", BlockDevice_ReadBlocks(0, 1, HostData), BLOCKDEV_ERROR_NotReady);
+	Failures += CheckErrorCode("Flush of removed card", BlockDevice_Flush(), BLOCKDEV_ERROR_NotReady);
+
+	SDCardModel_SetPresent(true);
+
+	if (!(BlockDevice_CheckOperation()) || (BlockDevice_GetTotalBlocks() != Card->TotalBlocks))
+	{
+		printf("Reinserted card not initialized\n");
+		Failures++;
+	}
+
+	return Failures;
+}
+
+/** Reads or writes a group of blocks containing a bad block of the card, and checks that the transfer fails once it
+ *  reaches the bad block. The blocks before the bad block must have been transferred, and the blocks after it must be
+ *  left unchanged by a write.
+ *
+ *  \param[in] BlockAddress  Address of the first block to transfer
+ *  \param[in] TotalBlocks   Number of blocks to transfer
+ *  \param[in] Write         Boolean true to write the blocks, false to read them
+ *
+ *  \return Number of failures of the operation
+ */
+static uint32_t BadBlockTransfer(const uint32_t BlockAddress, const uint16_t TotalBlocks, const bool Write)
+{
+	uint16_t BadBlockIndex = (rand() % TotalBlocks);
+	uint32_t GoodLength    = ((uint32_t)BadBlockIndex * BLOCKDEV_BLOCK_SIZE);
+	uint32_t Length        = ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
+	uint32_t Failures;
+
+	GetCardBlocks(BlockAddress, TotalBlocks, ExpectedData);
+	SDCardModel_SetBadBlock(BlockAddress + BadBlockIndex);
+
+	if (Write)
+	{
+		FillRandom(HostData, Length);
+		memcpy(ExpectedData, HostData, GoodLength);
+
+		Failures = CheckErrorCode("Write of bad block", BlockDevice_WriteBlocks(BlockAddress, TotalBlocks, HostData),
+		                          BLOCKDEV_ERROR_DeviceError);
+
+		GetCardBlocks(BlockAddress, TotalBlocks, HostData);
+		Failures += CompareData("Write of bad block", HostData, ExpectedData, Length);
+	}
+	else
+	{
+		Failures = (CheckErrorCode("Read of bad block", BlockDevice_ReadBlocks(BlockAddress, TotalBlocks, HostData),
+		                           BLOCKDEV_ERROR_DeviceError) +
+		            CompareData("Read of bad block", HostData, ExpectedData, GoodLength));
+	}
+
+	SDCardModel_SetBadBlock(SDMODEL_NO_BAD_BLOCK);
+	return Failures;
+}
+
+/** Performs a single random operation on the card through the backend, and checks its result.
+ *
+ *  \param[in] Card  Configuration of the simulated card
+ *
+ *  \return Number of failures of the operation
+ */
+static uint32_t RandomOperation(const Card_t* const Card)
+{
+	uint16_t TotalBlocks  = ((rand() % 4) ? (1 + (rand() % 4)) : (1 + (rand() % MAX_COMMAND_BLOCKS)));
+	uint32_t BlockAddress = (rand() % (Card->TotalBlocks - TotalBlocks + 1));
+	uint32_t Length       = ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
+
+	/* Exercise the end of the card as often as the start, and reuse a small area so that written blocks are read back */
+	if (rand() % 2)
+	  BlockAddress = ((rand() % 2) ? (Card->TotalBlocks - TotalBlocks) : (rand() % 256));
+
+	switch (rand() % 13)
+	{
+		case 0:
+		case 1:
+			FillRandom(HostData, Length);
+
+			if (BlockDevice_WriteBlocks(BlockAddress, TotalBlocks, HostData) != BLOCKDEV_ERROR_NoError)
+			  return CheckErrorCode("Write", BLOCKDEV_ERROR_DeviceError, BLOCKDEV_ERROR_NoError);
+
+			GetCardBlocks(BlockAddress, TotalBlocks, ExpectedData);
+			return CompareData("Write", ExpectedData, HostData, Length);
+		case 2:
+		case 3:
+			GetCardBlocks(BlockAddress, TotalBlocks, ExpectedData);
+			return (CheckErrorCode("Read", BlockDevice_ReadBlocks(BlockAddress, TotalBlocks, HostData), BLOCKDEV_ERROR_NoError) +
+			        CompareData("Read", HostData, ExpectedData, Length));
+		case 4:
+			return EndpointWrite(BlockAddress, TotalBlocks, false);
+		case 5:
+			return EndpointRead(BlockAddress, TotalBlocks, false);
+		case 6:
+			return EndpointWrite(BlockAddress, TotalBlocks, true);
+		case 7:
+			return EndpointRead(BlockAddress, TotalBlocks, true);
+		case 8:
+			/* Once the backend reports that programming has finished, the card must no longer be busy */
+			while (BlockDevice_IsBusy());
+
+			if (SDCardModel_IsProgramming())
+			{
+				printf("Card still programming once reported as not busy\n");
+				return 1;
+			}
+
+			return 0;
+		case 9:
+			if ((BlockDevice_Flush() != BLOCKDEV_ERROR_NoError) || SDCardModel_IsProgramming())
+			{
+				printf("Card still programming after a flush\n");
+				return 1;
+			}
+
+			return 0;
+		case 10:
+			if (!(BlockDevice_CheckOperation()))
+			{
+				printf("Present card reported as not operating\n");
+				return 1;
+			}
+
+			/* Requests which extend beyond the end of the card must be rejected without accessing the card */
+			return (CheckErrorCode("Read past end", BlockDevice_ReadBlocks((Card->TotalBlocks - TotalBlocks + 1),
+			                                                              TotalBlocks, HostData), BLOCKDEV_ERROR_OutOfRange) +
+			        CheckErrorCode("Write past end", BlockDevice_WriteBlocks(Card->TotalBlocks, 1, HostData),
+			                       BLOCKDEV_ERROR_OutOfRange));
+		case 11:
+			return BadBlockTransfer(BlockAddress, TotalBlocks, (rand() % 2));
+		default:
+			return ((rand() % 8) ? 0 : RemoveCard(Card));
+	}
+}
+
+/** Measures the sustained transfer rate of sequential endpoint reads or writes, printing the results.
+ *
+ *  \param[in] Write          Boolean true to write the blocks, false to read them
+ *  \param[in] CommandBlocks  Number of blocks transferred by each command
+ *
+ *  \return Number of failures of the benchmark
+ */
+static uint32_t Benchmark(const bool Write, const uint16_t CommandBlocks)
+{
+	uint32_t Failures = 0;
+	uint64_t StartNS  = SimTimeNS;
+
+	SDCardModel_ResetStats();
+
+	for (uint32_t BlockAddress = 0; BlockAddress < BENCHMARK_BLOCKS; BlockAddress += CommandBlocks)
+	{
+		if (Write)
+		  Failures += EndpointWrite(BlockAddress, CommandBlocks, false);
+		else
+		  Failures += EndpointRead(BlockAddress, CommandBlocks, false);
+	}
+
+	/* Writes are only complete once the card has finished programming the written blocks */
+	if (Write)
+	  Failures += CheckErrorCode("Flush", BlockDevice_Flush(), BLOCKDEV_ERROR_NoError);
+
+	double ElapsedMS = ((double)(SimTimeNS - StartNS) / 1000000);
+
+	printf("  %-16s %6u %9.1f %9.1f %8lu %8lu %10.1f\n", (Write ? "Sequential write" : "Sequential read"), CommandBlocks,
+	       (((double)BENCHMARK_BLOCKS * BLOCKDEV_BLOCK_SIZE / 1024) / (ElapsedMS / 1000)), ElapsedMS,
+	       (unsigned long)SDCardModel_Stats.Commands, (unsigned long)SDCardModel_Stats.BlocksPreErased,
+	       ((double)SDCardModel_Stats.BusyBytes / BENCHMARK_BLOCKS));
+
+	return Failures;
+}
+
+/** Tests the backend with the given simulated card, and measures its transfer rates.
+ *
+ *  \param[in] Card  Configuration of the simulated card
+ *
+ *  \return Number of errors encountered with the card
+ */
+static uint32_t TestCard(const Card_t* const Card)
+{
+	uint32_t Errors = 0;
+
+	SDCardModel_Insert(Card->Type, Card->TotalBlocks, Card->TransferSpeed);
+	SDCardModel_ResetStats();
+	memset(&EndpointModel_Stats, 0x00, sizeof(EndpointModel_Stats));
+
+	if (BlockDevice_Init() != BLOCKDEV_ERROR_NoError)
+	{
+		printf("%s: initialization failed\n", Card->Name);
+		return 1;
+	}
+
+	printf("%s: %lu blocks, SPI clock %lu Hz\n", Card->Name, (unsigned long)BlockDevice_GetTotalBlocks(),
+	       (unsigned long)SDCardModel_Stats.SPIClockHz);
+
+	if ((BlockDevice_GetTotalBlocks() != Card->TotalBlocks) || (SDCardModel_Stats.SPIClockHz != Card->ExpectedClockHz))
+	{
+		printf("  Expected %lu blocks, SPI clock %lu Hz\n", (unsigned long)Card->TotalBlocks,
+		       (unsigned long)Card->ExpectedClockHz);
+		Errors++;
+	}
+
+	for (uint16_t Operation = 0; Operation < RANDOM_OPERATIONS; Operation++)
+	  Errors += RandomOperation(Card);
+
+	printf("  %u random operations: %lu blocks written (%lu pre-erased), %lu blocks read, %lu errors\n",
+	       RANDOM_OPERATIONS, (unsigned long)SDCardModel_Stats.BlocksWritten,
+	       (unsigned long)SDCardModel_Stats.BlocksPreErased, (unsigned long)SDCardModel_Stats.BlocksRead,
+	       (unsigned long)(Errors + SDCardModel_Stats.ProtocolErrors + EndpointModel_Stats.ProtocolErrors));
+
+	Errors += (SDCardModel_Stats.ProtocolErrors + EndpointModel_Stats.ProtocolErrors);
+
+	printf("  %-16s %6s %9s %9s %8s %8s %10s\n", "Scenario", "Blocks", "KB/s", "Time ms", "Commands", "PreErase",
+	       "Busy/block");
+
+	for (uint16_t CommandBlocks = 1; CommandBlocks <= MAX_COMMAND_BLOCKS; CommandBlocks *= 8)
+	{
+		Errors += Benchmark(true, CommandBlocks);
+		Errors += Benchmark(false, CommandBlocks);
+	}
+
+	Errors += (SDCardModel_Stats.ProtocolErrors + EndpointModel_Stats.ProtocolErrors);
+
+	return Errors;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	srand(1);
+
+	for (uint8_t Index = 0; Index < (sizeof(Cards) / sizeof(Cards[0])); Index++)
+	  TotalErrors += TestCard(&Cards[Index]);
+
+	printf("\nBlocks is the number of blocks transferred by each command, PreErase the written blocks pre-erased by\n");
+	printf("SET_WR_BLK_ERASE_COUNT, and Busy/block the bytes clocked from the card while busy per block transferred.\n");
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Simulated time shared by the host models of the block device hardware. Each model advances the time by the duration
+ *  of the bus transfers and waits it performs, so that the elapsed time of a block device operation can be measured.
+ */
+
+#ifndef _SIM_TIME_H_
+#define _SIM_TIME_H_
+
+	/* Includes: */
+		#include <stdint.h>
+
+	/* Macros: */
+		/** Clock frequency of the simulated AVR, in Hz. */
+		#define SIM_CPU_HZ                8000000UL
+
+		/** Number of CPU cycles taken to transfer one byte over the SPI bus at the maximum SPI clock of F_CPU/2, including
+		 *  the eight SPI clock cycles of the byte itself and the loop overhead of the block device backends.
+		 */
+		#define SIM_CYCLES_PER_SPI_BYTE   20
+
+		/** Time taken to transfer one byte over the SPI bus, in nanoseconds. */
+		#define SIM_SPI_BYTE_NS           ((SIM_CYCLES_PER_SPI_BYTE * 1000000000ULL) / SIM_CPU_HZ)
+
+	/* External Variables: */
+		/** Current simulated time, in nanoseconds. This is defined by each host tool, and advanced by the models. */
+		extern uint64_t SimTimeNS;
+
+#endif
@@ -0,0 +1,354 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../../USB/HighLevel/USBMode.h"
+#if defined(USB_CAN_BE_HOST)
+
+#define  __INCLUDE_FROM_MSHOST_BLOCKDEVICE_C
+#include "MSHostBlockDevice.h"
+
+/** Mass Storage host class interface of the attached device, set by \ref MSHostBlockDevice_SetInterface(). */
+static USB_ClassInfo_MS_Host_t* MSInterface;
+
+/** Index of the LUN within the attached device whose medium is accessed. */
+static uint8_t  MSLUNIndex;
+
+/** Total number of blocks in the medium, read from the device by \ref BlockDevice_Init(). */
+static uint32_t MediumTotalBlocks;
+
+/** Address of the block following the last block read, used to detect sequential reads for read-ahead. */
+static uint32_t NextSequentialBlock = MSHOST_BLOCKDEV_NO_BLOCK;
+
+/** Storage for the data of each cached block. */
+static uint8_t  CacheData[MSHOST_BLOCKDEV_CACHE_BLOCKS][BLOCKDEV_BLOCK_SIZE];
+
+/** Block address of each cached block, or \ref MSHOST_BLOCKDEV_NO_BLOCK if the cache entry is unused. */
+static uint32_t CacheBlockAddresses[MSHOST_BLOCKDEV_CACHE_BLOCKS];
+
+/** Indexes of the cache entries, ordered from the most to the least recently used. */
+static uint8_t  CacheUsageOrder[MSHOST_BLOCKDEV_CACHE_BLOCKS];
+
+void MSHostBlockDevice_SetInterface(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex)
+{
+	MSInterface = MSInterfaceInfo;
+	MSLUNIndex  = LUNIndex;
+}
+
+/** Determines if the Mass Storage interface set by \ref MSHostBlockDevice_SetInterface() is attached and configured.
+ *
+ *  \return Boolean true if the interface can be used, false otherwise
+ */
+static bool MSHostBlockDevice_IsReady(void)
+{
+	return ((MSInterface != NULL) && (USB_HostState == HOST_STATE_Configured) && MSInterface->State.IsActive);
+}
+
+/** Searches the block cache for the given block.
+ *
+ *  \param[in] BlockAddress  Address of the block to search for
+ *
+ *  \return Index of the cache entry holding the block, or MSHOST_BLOCKDEV_CACHE_BLOCKS if the block is not cached
+ */
+static uint8_t MSHostBlockDevice_FindBlock(const uint32_t BlockAddress)
+{
+	for (uint8_t CacheIndex = 0; CacheIndex < MSHOST_BLOCKDEV_CACHE_BLOCKS; CacheIndex++)
+	{
+		if (CacheBlockAddresses[CacheIndex] == BlockAddress)
+		  return CacheIndex;
+	}
+
+	return MSHOST_BLOCKDEV_CACHE_BLOCKS;
+}
+
+/** Marks a cache entry as the most recently used, so that it is the last entry to be replaced.
+ *
+ *  \param[in] CacheIndex  Index of the cache entry that has been used
+ */
+static void MSHostBlockDevice_TouchBlock(const uint8_t CacheIndex)
+{
+	uint8_t OrderIndex = 0;
+
+	/* Find the entry's position in the usage order list */
+	while (CacheUsageOrder[OrderIndex] != CacheIndex)
+	  OrderIndex++;
+
+	/* Move the entry to the front of the list, as the most recently used entry */
+	while (OrderIndex)
+	{
+		CacheUsageOrder[OrderIndex] = CacheUsageOrder[OrderIndex - 1];
+		OrderIndex--;
+	}
+
+	CacheUsageOrder[0] = CacheIndex;
+}
+
+/** Assigns the least recently used cache entry to the given block, discarding the block it previously held. The data of
+ *  the entry is left unchanged, and must be filled in by the caller.
+ *
+ *  \param[in] BlockAddress  Address of the block to store in the cache
+ *
+ *  \return Index of the cache entry assigned to the block
+ */
+static uint8_t MSHostBlockDevice_AllocateBlock(const uint32_t BlockAddress)
+{
+	/* Replace the least recently used entry with the new block */
+	uint8_t CacheIndex = CacheUsageOrder[MSHOST_BLOCKDEV_CACHE_BLOCKS - 1];
+
+	CacheBlockAddresses[CacheIndex] = BlockAddress;
+	MSHostBlockDevice_TouchBlock(CacheIndex);
+
+	return CacheIndex;
+}
+
+/** Block callback for \ref MS_Host_ReadDeviceBlocks_Stream(), storing each block read ahead from the device in the
+ *  block cache.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the MS Class host configuration and state of the transfer
+ *  \param[in] BlockAddress  Address of the received block within the device
+ *  \param[in] BlockBuffer  Pointer to the received block data
+ *
+ *  \return Boolean true, to continue the transfer
+ */
+static bool MSHostBlockDevice_CacheReadBlock(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                             const uint32_t BlockAddress, void* BlockBuffer)
+{
+	uint8_t CacheIndex = MSHostBlockDevice_FindBlock(BlockAddress);
+
+	/* Re-use the existing entry if the block is already cached, so that the cache never holds duplicate blocks */
+	if (CacheIndex == MSHOST_BLOCKDEV_CACHE_BLOCKS)
+	  CacheIndex = MSHostBlockDevice_AllocateBlock(BlockAddress);
+	else
+	  MSHostBlockDevice_TouchBlock(CacheIndex);
+
+	memcpy(CacheData[CacheIndex], BlockBuffer, BLOCKDEV_BLOCK_SIZE);
+
+	return true;
+}
+
+uint8_t BlockDevice_Init(void)
+{
+	SCSI_Capacity_t Capacity;
+
+	MediumTotalBlocks   = 0;
+	NextSequentialBlock = MSHOST_BLOCKDEV_NO_BLOCK;
+
+	/* Empty the cache, as it may hold blocks of a previously attached device */
+	for (uint8_t CacheIndex = 0; CacheIndex < MSHOST_BLOCKDEV_CACHE_BLOCKS; CacheIndex++)
+	{
+		CacheBlockAddresses[CacheIndex] = MSHOST_BLOCKDEV_NO_BLOCK;
+		CacheUsageOrder[CacheIndex]     = CacheIndex;
+	}
+
+	if (!(MSHostBlockDevice_IsReady()))
+	  return BLOCKDEV_ERROR_NotReady;
+
+	if (MS_Host_ReadDeviceCapacity(MSInterface, MSLUNIndex, &Capacity))
+	  return BLOCKDEV_ERROR_DeviceError;
+
+	if (Capacity.BlockSize != BLOCKDEV_BLOCK_SIZE)
+	  return BLOCKDEV_ERROR_DeviceError;
+
+	/* The device reports the address of its last block rather than the total number of blocks */
+	MediumTotalBlocks = (Capacity.Blocks + 1);
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_GetCapabilities(void)
+{
+	return (BLOCKDEV_CAP_WRITABLE | BLOCKDEV_CAP_REMOVABLE);
+}
+
+uint32_t BlockDevice_GetTotalBlocks(void)
+{
+	return MediumTotalBlocks;
+}
+
+#if defined(USB_CAN_BE_DEVICE)
+uint8_t BlockDevice_WriteBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                         const volatile bool* const AbortFlag)
+{
+	/* The USB controller cannot be in device mode while it is hosting the attached device */
+	return BLOCKDEV_ERROR_NotReady;
+}
+
+uint8_t BlockDevice_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                        const volatile bool* const AbortFlag)
+{
+	/* The USB controller cannot be in device mode while it is hosting the attached device */
+	return BLOCKDEV_ERROR_NotReady;
+}
+#endif
+
+uint8_t BlockDevice_WriteBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, const uint8_t* BufferPtr)
+{
+	uint32_t CurrBlock = BlockAddress;
+
+	if (!(MSHostBlockDevice_IsReady()))
+	  return BLOCKDEV_ERROR_NotReady;
+
+	/* Check that all the requested blocks lie within the medium */
+	if ((BlockAddress + TotalBlocks) > MediumTotalBlocks)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	while (TotalBlocks)
+	{
+		uint8_t CommandBlocks = (TotalBlocks < MSHOST_BLOCKDEV_MAX_TRANSFER_BLOCKS) ? TotalBlocks :
+		                        MSHOST_BLOCKDEV_MAX_TRANSFER_BLOCKS;
+
+		if (MS_Host_WriteDeviceBlocks(MSInterface, MSLUNIndex, CurrBlock, CommandBlocks, BLOCKDEV_BLOCK_SIZE,
+		                              (void*)BufferPtr))
+		{
+			/* The device may have written only some of the blocks, so cached copies of the blocks can no longer be trusted */
+			for (uint8_t CacheIndex = 0; CacheIndex < MSHOST_BLOCKDEV_CACHE_BLOCKS; CacheIndex++)
+			  CacheBlockAddresses[CacheIndex] = MSHOST_BLOCKDEV_NO_BLOCK;
+
+			return BLOCKDEV_ERROR_DeviceError;
+		}
+
+		/* Update any cached copies of the written blocks */
+		for (uint8_t BlockIndex = 0; BlockIndex < CommandBlocks; BlockIndex++)
+		{
+			uint8_t CacheIndex = MSHostBlockDevice_FindBlock(CurrBlock + BlockIndex);
+
+			if (CacheIndex != MSHOST_BLOCKDEV_CACHE_BLOCKS)
+			  memcpy(CacheData[CacheIndex], &BufferPtr[(uint16_t)BlockIndex * BLOCKDEV_BLOCK_SIZE], BLOCKDEV_BLOCK_SIZE);
+		}
+
+		CurrBlock   += CommandBlocks;
+		BufferPtr   += ((uint16_t)CommandBlocks * BLOCKDEV_BLOCK_SIZE);
+		TotalBlocks -= CommandBlocks;
+	}
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_ReadBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, uint8_t* BufferPtr)
+{
+	uint32_t CurrBlock = BlockAddress;
+
+	if (!(MSHostBlockDevice_IsReady()))
+	  return BLOCKDEV_ERROR_NotReady;
+
+	/* Check that all the requested blocks lie within the medium */
+	if ((BlockAddress + TotalBlocks) > MediumTotalBlocks)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	if (TotalBlocks == 1)
+	{
+		uint8_t CacheIndex = MSHostBlockDevice_FindBlock(BlockAddress);
+
+		if (CacheIndex == MSHOST_BLOCKDEV_CACHE_BLOCKS)
+		{
+			/* Reads are sequential if they follow the last read, or follow a cached block which other reads (such as those of a
+			 * filesystem's FAT) have interrupted */
+			bool IsSequential = ((BlockAddress == NextSequentialBlock) ||
+			                     (BlockAddress && (MSHostBlockDevice_FindBlock(BlockAddress - 1) != MSHOST_BLOCKDEV_CACHE_BLOCKS)));
+
+			if (IsSequential && (MSHOST_BLOCKDEV_READAHEAD_BLOCKS > 1))
+			{
+				uint32_t ReadBlocks = (MediumTotalBlocks - BlockAddress);
+
+				if (ReadBlocks > MSHOST_BLOCKDEV_READAHEAD_BLOCKS)
+				  ReadBlocks = MSHOST_BLOCKDEV_READAHEAD_BLOCKS;
+
+				/* Sequential read, fetch the requested block and the blocks following it into the cache in one command */
+				if (MS_Host_ReadDeviceBlocks_Stream(MSInterface, MSLUNIndex, BlockAddress, ReadBlocks, BLOCKDEV_BLOCK_SIZE,
+				                                    BufferPtr, MSHostBlockDevice_CacheReadBlock))
+				{
+					for (CacheIndex = 0; CacheIndex < MSHOST_BLOCKDEV_CACHE_BLOCKS; CacheIndex++)
+					  CacheBlockAddresses[CacheIndex] = MSHOST_BLOCKDEV_NO_BLOCK;
+
+					return BLOCKDEV_ERROR_DeviceError;
+				}
+
+				CacheIndex = MSHostBlockDevice_FindBlock(BlockAddress);
+			}
+			else
+			{
+				CacheIndex = MSHostBlockDevice_AllocateBlock(BlockAddress);
+
+				if (MS_Host_ReadDeviceBlocks(MSInterface, MSLUNIndex, BlockAddress, 1, BLOCKDEV_BLOCK_SIZE,
+				                             CacheData[CacheIndex]))
+				{
+					CacheBlockAddresses[CacheIndex] = MSHOST_BLOCKDEV_NO_BLOCK;
+					return BLOCKDEV_ERROR_DeviceError;
+				}
+			}
+		}
+
+		memcpy(BufferPtr, CacheData[CacheIndex], BLOCKDEV_BLOCK_SIZE);
+		MSHostBlockDevice_TouchBlock(CacheIndex);
+
+		NextSequentialBlock = (BlockAddress + 1);
+	}
+	else
+	{
+		/* Multiple block reads are made directly into the caller's buffer, as the cache is always up to date with the medium */
+		while (TotalBlocks)
+		{
+			uint8_t CommandBlocks = (TotalBlocks < MSHOST_BLOCKDEV_MAX_TRANSFER_BLOCKS) ? TotalBlocks :
+			                        MSHOST_BLOCKDEV_MAX_TRANSFER_BLOCKS;
+
+			if (MS_Host_ReadDeviceBlocks(MSInterface, MSLUNIndex, CurrBlock, CommandBlocks, BLOCKDEV_BLOCK_SIZE,
+			                             BufferPtr))
+			{
+				return BLOCKDEV_ERROR_DeviceError;
+			}
+
+			CurrBlock   += CommandBlocks;
+			BufferPtr   += ((uint16_t)CommandBlocks * BLOCKDEV_BLOCK_SIZE);
+			TotalBlocks -= CommandBlocks;
+		}
+
+		NextSequentialBlock = CurrBlock;
+	}
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_Flush(void)
+{
+	/* Writes are passed straight through to the device, so there is never any cached data to write back */
+	return BLOCKDEV_ERROR_NoError;
+}
+
+bool BlockDevice_IsBusy(void)
+{
+	return false;
+}
+
+bool BlockDevice_CheckOperation(void)
+{
+	return (MSHostBlockDevice_IsReady() && !(MS_Host_TestUnitReady(MSInterface, MSLUNIndex)));
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief USB Mass Storage host block device backend.
+ *
+ *  Block device backend for the medium of a USB Mass Storage device (such as a USB flash drive) attached to the AVR
+ *  while it is in USB host mode, so that a FAT filesystem library using the block device interface can read and write
+ *  files on the attached device. The Mass Storage host class driver must be built with the user project, and the
+ *  enumerated interface and the LUN to use must be given to \ref MSHostBlockDevice_SetInterface() before
+ *  \ref BlockDevice_Init() is called; only devices with a block size of \ref BLOCKDEV_BLOCK_SIZE bytes are supported.
+ *
+ *  As the per-command overhead of the Mass Storage protocol dominates the transfer time of single blocks, this backend
+ *  keeps a small cache of recently read blocks, replaced in least recently used order, which absorbs the repeated reads
+ *  of FAT and directory blocks made by a filesystem. When a single block is read immediately after the block preceding
+ *  it, or while the block preceding it is still cached (so that the FAT reads made between the data reads of a file do
+ *  not interrupt a sequential read), the following blocks are read ahead into the cache in the same command, so that
+ *  sequential single block reads need only one command per MSHOST_BLOCKDEV_READAHEAD_BLOCKS blocks. Multiple block reads and writes are each issued
+ *  as a single command (or as few commands as possible for very large transfers), directly to or from the caller's buffer.
+ *  Writes are passed straight through to the device, updating any cached copies of the written blocks.
+ *
+ *  The cache holds MSHOST_BLOCKDEV_CACHE_BLOCKS blocks of \ref BLOCKDEV_BLOCK_SIZE bytes each, and defaults to four
+ *  blocks on AVR models with 8KB of SRAM and two blocks otherwise. MSHOST_BLOCKDEV_READAHEAD_BLOCKS defaults to the
+ *  size of the cache, and may not exceed it. Both tokens may be overridden by defining them in the project makefile
+ *  and passing them to the compiler via the -D switch.
+ *
+ *  \note This file should not be included directly, except by user applications to gain access to
+ *        \ref MSHostBlockDevice_SetInterface(). Include LUFA/Drivers/Misc/BlockDevice.h instead, and add this backend's
+ *        source file to the project makefile.
+ */
+
+#ifndef __MSHOST_BLOCKDEVICE_H__
+#define __MSHOST_BLOCKDEVICE_H__
+
+	/* Includes: */
+		#include <string.h>
+
+		#include "../BlockDevice.h"
+		#include "../../USB/Class/MassStorage.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Function Prototypes: */
+			#if defined(USB_CAN_BE_HOST) || defined(__DOXYGEN__)
+			/** Sets the Mass Storage host class interface and LUN whose medium is accessed through the block device interface.
+			 *  This must be called once the attached device has been enumerated and is ready, before \ref BlockDevice_Init() is
+			 *  called to read the medium's capacity.
+			 *
+			 *  \param[in] MSInterfaceInfo  Pointer to the configured Mass Storage host class interface of the attached device
+			 *  \param[in] LUNIndex  Index of the LUN within the attached device to access
+			 */
+			void MSHostBlockDevice_SetInterface(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex)
+			                                    ATTR_NON_NULL_PTR_ARG(1);
+			#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#if !defined(MSHOST_BLOCKDEV_CACHE_BLOCKS)
+				#if (defined(__AVR_AT90USB1287__) || defined(__AVR_AT90USB1286__))
+					#define MSHOST_BLOCKDEV_CACHE_BLOCKS      4
+				#else
+					#define MSHOST_BLOCKDEV_CACHE_BLOCKS      2
+				#endif
+			#endif
+
+			#if !defined(MSHOST_BLOCKDEV_READAHEAD_BLOCKS)
+				#define MSHOST_BLOCKDEV_READAHEAD_BLOCKS      MSHOST_BLOCKDEV_CACHE_BLOCKS
+			#endif
+
+			#define MSHOST_BLOCKDEV_MAX_TRANSFER_BLOCKS       64
+			#define MSHOST_BLOCKDEV_NO_BLOCK                  0xFFFFFFFF
+
+		/* Preprocessor Checks: */
+			#if ((MSHOST_BLOCKDEV_CACHE_BLOCKS < 1) || (MSHOST_BLOCKDEV_CACHE_BLOCKS > 255))
+				#error MSHOST_BLOCKDEV_CACHE_BLOCKS must be between 1 and 255 blocks.
+			#endif
+
+			#if ((MSHOST_BLOCKDEV_READAHEAD_BLOCKS < 1) || (MSHOST_BLOCKDEV_READAHEAD_BLOCKS > MSHOST_BLOCKDEV_CACHE_BLOCKS))
+				#error MSHOST_BLOCKDEV_READAHEAD_BLOCKS must be between 1 and MSHOST_BLOCKDEV_CACHE_BLOCKS blocks.
+			#endif
+
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_MSHOST_BLOCKDEVICE_C)
+				static bool    MSHostBlockDevice_IsReady(void);
+				static uint8_t MSHostBlockDevice_FindBlock(const uint32_t BlockAddress);
+				static uint8_t MSHostBlockDevice_AllocateBlock(const uint32_t BlockAddress);
+				static void    MSHostBlockDevice_TouchBlock(const uint8_t CacheIndex);
+				static bool    MSHostBlockDevice_CacheReadBlock(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                                const uint32_t BlockAddress, void* BlockBuffer);
+			#endif
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
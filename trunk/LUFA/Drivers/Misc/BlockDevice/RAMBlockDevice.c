@@ -0,0 +1,171 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_RAM_BLOCKDEVICE_C
+#include "RAMBlockDevice.h"
+
+/** Storage for the blocks of the RAM disk. */
+static uint8_t RAMDiskBlocks[BLOCKDEV_RAM_BLOCKS][BLOCKDEV_BLOCK_SIZE];
+
+uint8_t BlockDevice_Init(void)
+{
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_GetCapabilities(void)
+{
+	return (BLOCKDEV_CAP_WRITABLE | BLOCKDEV_CAP_VOLATILE);
+}
+
+uint32_t BlockDevice_GetTotalBlocks(void)
+{
+	return BLOCKDEV_RAM_BLOCKS;
+}
+
+#if defined(USB_CAN_BE_DEVICE)
+uint8_t BlockDevice_WriteBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                         const volatile bool* const AbortFlag)
+{
+	/* Check that all the requested blocks lie within the RAM disk */
+	if ((BlockAddress + TotalBlocks) > BLOCKDEV_RAM_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	uint8_t* BufferPtr = RAMDiskBlocks[BlockAddress];
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+
+	for (uint32_t BytesRem = ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE); BytesRem; BytesRem -= 16)
+	{
+		/* Check if the endpoint is currently empty */
+		if (!(Endpoint_IsReadWriteAllowed()))
+		{
+			/* Clear the current endpoint bank */
+			Endpoint_ClearOUT();
+			
+			/* Wait until the host has sent another packet */
+			if (Endpoint_WaitUntilReady())
+			  return BLOCKDEV_ERROR_EndpointError;
+		}
+
+		/* Store one 16-byte chunk of data into the RAM disk */
+		for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+		  *(BufferPtr++) = Endpoint_Read_Byte();
+
+		/* Check if the current transfer is being aborted */
+		if ((AbortFlag != NULL) && *AbortFlag)
+		  return BLOCKDEV_ERROR_Aborted;
+	}
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                        const volatile bool* const AbortFlag)
+{
+	/* Check that all the requested blocks lie within the RAM disk */
+	if ((BlockAddress + TotalBlocks) > BLOCKDEV_RAM_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	uint8_t* BufferPtr = RAMDiskBlocks[BlockAddress];
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+
+	for (uint32_t BytesRem = ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE); BytesRem; BytesRem -= 16)
+	{
+		/* Check if the endpoint is currently full */
+		if (!(Endpoint_IsReadWriteAllowed()))
+		{
+			/* Clear the endpoint bank to send its contents to the host */
+			Endpoint_ClearIN();
+			
+			/* Wait until the endpoint is ready for more data */
+			if (Endpoint_WaitUntilReady())
+			  return BLOCKDEV_ERROR_EndpointError;
+		}
+
+		/* Send one 16-byte chunk of data from the RAM disk */
+		for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+		  Endpoint_Write_Byte(*(BufferPtr++));
+
+		/* Check if the current transfer is being aborted */
+		if ((AbortFlag != NULL) && *AbortFlag)
+		  return BLOCKDEV_ERROR_Aborted;
+	}
+
+	/* If the endpoint is full, send its contents to the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	return BLOCKDEV_ERROR_NoError;
+}
+#endif
+
+uint8_t BlockDevice_WriteBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, const uint8_t* BufferPtr)
+{
+	/* Check that all the requested blocks lie within the RAM disk */
+	if ((BlockAddress + TotalBlocks) > BLOCKDEV_RAM_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	memcpy(RAMDiskBlocks[BlockAddress], BufferPtr, ((uint16_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE));
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_ReadBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, uint8_t* BufferPtr)
+{
+	/* Check that all the requested blocks lie within the RAM disk */
+	if ((BlockAddress + TotalBlocks) > BLOCKDEV_RAM_BLOCKS)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	memcpy(BufferPtr, RAMDiskBlocks[BlockAddress], ((uint16_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE));
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_Flush(void)
+{
+	return BLOCKDEV_ERROR_NoError;
+}
+
+bool BlockDevice_IsBusy(void)
+{
+	return false;
+}
+
+bool BlockDevice_CheckOperation(void)
+{
+	return true;
+}
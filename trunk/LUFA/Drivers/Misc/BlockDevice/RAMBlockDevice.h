@@ -0,0 +1,59 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief RAM disk block device backend.
+ *
+ *  Block device backend for a small RAM disk, whose contents are lost when power is removed. This is intended for testing
+ *  and benchmarking of the layers above the block device, as the RAM disk transfers data as fast as the processor allows.
+ *  The size of the RAM disk in blocks may be set by defining the BLOCKDEV_RAM_BLOCKS token in the project makefile and
+ *  passing it to the compiler via the -D switch; each block consumes \ref BLOCKDEV_BLOCK_SIZE bytes of SRAM.
+ *
+ *  \note This file should not be included directly. Include LUFA/Drivers/Misc/BlockDevice.h instead, and add this backend's
+ *        source file to the project makefile.
+ */
+
+#ifndef __RAM_BLOCKDEVICE_H__
+#define __RAM_BLOCKDEVICE_H__
+
+	/* Includes: */
+		#include <string.h>
+
+		#include "../BlockDevice.h"
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#if !defined(BLOCKDEV_RAM_BLOCKS)
+				#define BLOCKDEV_RAM_BLOCKS          4
+			#endif
+	#endif
+
+#endif
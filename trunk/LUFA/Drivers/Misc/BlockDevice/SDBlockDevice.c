@@ -0,0 +1,744 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_SD_BLOCKDEVICE_C
+#include "SDBlockDevice.h"
+
+/** Multipliers of the card's maximum transfer rate, indexed by the time value field of the CSD TRAN_SPEED byte. */
+static const uint8_t PROGMEM TransferRateMultipliers[] = {0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80};
+
+/** Type of the currently initialized card, a value from the SD_CardTypes_t enum. */
+static uint8_t  CardType = SD_CARDTYPE_None;
+
+/** Total number of blocks on the currently initialized card. */
+static uint32_t CardTotalBlocks;
+
+/** Flag to indicate if the card may still be programming data written by a previous write operation. */
+static bool     CardProgramming;
+
+/** Selects the card, so that it accepts commands and data. The card remains selected for the whole of a multiple block
+ *  transfer, between \ref SDBlockDevice_BeginTransfer() and \ref SDBlockDevice_EndTransfer().
+ */
+static void SDBlockDevice_SelectCard(void)
+{
+	SD_BLOCKDEV_CS_PORT &= ~SD_BLOCKDEV_CS_MASK;
+}
+
+/** Deselects the card, ending the current command or transfer. An extra byte is clocked through after the card is
+ *  deselected, so that the card releases the SPI bus for other devices.
+ */
+static void SDBlockDevice_DeselectCard(void)
+{
+	SD_BLOCKDEV_CS_PORT |= SD_BLOCKDEV_CS_MASK;
+
+	/* Send an extra clock byte so that the card releases its data output */
+	SDBlockDevice_ReceiveByte();
+}
+
+/** Forgets the currently initialized card, after it has been removed or has stopped responding. All further transfers fail
+ *  with \ref BLOCKDEV_ERROR_NotReady until a card is initialized again by \ref BlockDevice_Init() or
+ *  \ref BlockDevice_CheckOperation().
+ */
+static void SDBlockDevice_RemoveCard(void)
+{
+	CardType        = SD_CARDTYPE_None;
+	CardTotalBlocks = 0;
+	CardProgramming = false;
+}
+
+/** Receives a byte from the selected card, while holding the card's data input high.
+ *
+ *  \return Byte received from the card
+ */
+static uint8_t SDBlockDevice_ReceiveByte(void)
+{
+	/* The card's data input must be held high while data is being received */
+	return SPI_TransferByte(0xFF);
+}
+
+/** Waits until the selected card has finished programming any previously written data, or until
+ *  SD_BLOCKDEV_BUSY_TIMEOUT bytes have been received while it is still busy.
+ *
+ *  \return Boolean true if the card is ready, false if the card remained busy until the timeout
+ */
+static bool SDBlockDevice_WaitWhileBusy(void)
+{
+	/* The card holds its data output low while it is programming written data */
+	for (uint32_t Timeout = SD_BLOCKDEV_BUSY_TIMEOUT; Timeout; Timeout--)
+	{
+		if (SDBlockDevice_ReceiveByte() == 0xFF)
+		{
+			CardProgramming = false;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** Sends a command to the selected card, once the card has finished programming any previously written data, and
+ *  receives the card's R1 response. Application specific commands are automatically preceded by an APP_CMD command.
+ *
+ *  \param[in] Command   Command to send, a SD_CMD_* or SD_ACMD_* command index
+ *  \param[in] Argument  32-bit argument of the command
+ *
+ *  \return R1 response of the card, or SD_R1_NO_RESPONSE if the card did not respond
+ */
+static uint8_t SDBlockDevice_SendCommand(const uint8_t Command, const uint32_t Argument)
+{
+	uint8_t Response;
+
+	/* Application specific commands must be preceded by an APP_CMD command */
+	if (Command & SD_ACMD_MASK)
+	{
+		Response = SDBlockDevice_SendCommand(SD_CMD_APP_CMD, 0);
+
+		if (Response > SD_R1_IDLE_STATE)
+		  return Response;
+	}
+
+	/* Wait for any previous programming to complete, unless resetting the card or stopping a read */
+	if ((Command != SD_CMD_GO_IDLE_STATE) && (Command != SD_CMD_STOP_TRANSMISSION))
+	{
+		if (!(SDBlockDevice_WaitWhileBusy()))
+		  return SD_R1_NO_RESPONSE;
+	}
+
+	SPI_SendByte(0x40 | (Command & ~SD_ACMD_MASK));
+	SPI_SendByte(Argument >> 24);
+	SPI_SendByte(Argument >> 16);
+	SPI_SendByte(Argument >> 8);
+	SPI_SendByte(Argument);
+
+	/* The command CRC is only checked for the commands sent before the card has entered SPI mode */
+	if (Command == SD_CMD_GO_IDLE_STATE)
+	  SPI_SendByte(0x95);
+	else if (Command == SD_CMD_SEND_IF_COND)
+	  SPI_SendByte(0x87);
+	else
+	  SPI_SendByte(0x01);
+
+	/* Discard the stuff byte which follows a stop command */
+	if (Command == SD_CMD_STOP_TRANSMISSION)
+	  SDBlockDevice_ReceiveByte();
+
+	/* Wait for the card's response, which always has the MSB cleared */
+	for (uint8_t Retries = 0; Retries < SD_BLOCKDEV_RESPONSE_RETRIES; Retries++)
+	{
+		Response = SDBlockDevice_ReceiveByte();
+
+		if (!(Response & 0x80))
+		  break;
+	}
+
+	return Response;
+}
+
+/** Repeatedly sends an initialization command to the selected card until it leaves the idle state, for up to
+ *  SD_BLOCKDEV_INIT_RETRIES attempts.
+ *
+ *  \param[in] Command   Initialization command to send, SD_ACMD_SEND_OP_COND for SD cards or SD_CMD_SEND_OP_COND for MMC cards
+ *  \param[in] Argument  32-bit argument of the initialization command
+ *
+ *  \return Boolean true if the card is initialized, false if it returned an error or did not initialize in time
+ */
+static bool SDBlockDevice_WaitForInit(const uint8_t Command, const uint32_t Argument)
+{
+	/* Repeat the initialization command until the card leaves the idle state */
+	for (uint16_t Retries = 0; Retries < SD_BLOCKDEV_INIT_RETRIES; Retries++)
+	{
+		uint8_t Response = SDBlockDevice_SendCommand(Command, Argument);
+
+		if (Response == SD_R1_READY)
+		  return true;
+		else if (Response != SD_R1_IDLE_STATE)
+		  return false;
+	}
+
+	return false;
+}
+
+/** Determines the fastest SPI clock which does not exceed the given maximum clock frequency.
+ *
+ *  \param[in] MaxClock  Maximum SPI clock frequency in Hz
+ *
+ *  \return SPI_SPEED_FCPU_DIV_* mask of the SPI driver for the fastest allowed SPI clock, or the slowest SPI clock if none
+ *          is slow enough
+ */
+static uint8_t SDBlockDevice_GetSPISpeedMask(const uint32_t MaxClock)
+{
+	if ((F_CPU / 2) <= MaxClock)
+	  return SPI_SPEED_FCPU_DIV_2;
+	else if ((F_CPU / 4) <= MaxClock)
+	  return SPI_SPEED_FCPU_DIV_4;
+	else if ((F_CPU / 8) <= MaxClock)
+	  return SPI_SPEED_FCPU_DIV_8;
+	else if ((F_CPU / 16) <= MaxClock)
+	  return SPI_SPEED_FCPU_DIV_16;
+	else if ((F_CPU / 32) <= MaxClock)
+	  return SPI_SPEED_FCPU_DIV_32;
+	else if ((F_CPU / 64) <= MaxClock)
+	  return SPI_SPEED_FCPU_DIV_64;
+	else
+	  return SPI_SPEED_FCPU_DIV_128;
+}
+
+/** Reads the Card Specific Data register of the selected card, which holds the card's capacity and maximum clock.
+ *
+ *  \param[out] CSD  Pointer to a buffer of SD_CSD_LENGTH bytes where the register contents are to be stored
+ *
+ *  \return Boolean true if the register was read, false otherwise
+ */
+static bool SDBlockDevice_ReadCSD(uint8_t* const CSD)
+{
+	if (SDBlockDevice_SendCommand(SD_CMD_SEND_CSD, 0) != SD_R1_READY)
+	  return false;
+
+	/* The CSD register is sent as a data block, preceded by a start token and followed by a CRC */
+	if (!(SDBlockDevice_BeginBlock(1, false)))
+	  return false;
+
+	for (uint8_t ByteNum = 0; ByteNum < SD_CSD_LENGTH; ByteNum++)
+	  CSD[ByteNum] = SDBlockDevice_ReceiveByte();
+
+	return SDBlockDevice_EndBlock(false);
+}
+
+/** Resets the selected card into SPI mode, determines its type and initializes it, then reads its Card Specific Data
+ *  register. This must be performed at the identification clock of SD_BLOCKDEV_IDENTIFICATION_CLOCK.
+ *
+ *  \param[out] CSD  Pointer to a buffer of SD_CSD_LENGTH bytes where the card's CSD register is to be stored
+ *
+ *  \return Type of the initialized card, a value from the SD_CardTypes_t enum, or SD_CARDTYPE_None if no card
+ *          could be initialized
+ */
+static uint8_t SDBlockDevice_IdentifyCard(uint8_t* const CSD)
+{
+	uint8_t Response[4];
+	uint8_t NewCardType;
+
+	/* Reset the card into SPI mode */
+	if (SDBlockDevice_SendCommand(SD_CMD_GO_IDLE_STATE, 0) != SD_R1_IDLE_STATE)
+	  return SD_CARDTYPE_None;
+
+	if (SDBlockDevice_SendCommand(SD_CMD_SEND_IF_COND, SD_IF_COND_VOLTAGE_CHECK) == SD_R1_IDLE_STATE)
+	{
+		/* Version 2 card, which must accept the supply voltage range and echo back the check pattern */
+		for (uint8_t ByteNum = 0; ByteNum < sizeof(Response); ByteNum++)
+		  Response[ByteNum] = SDBlockDevice_ReceiveByte();
+
+		if (((Response[2] & 0x0F) != (uint8_t)(SD_IF_COND_VOLTAGE_CHECK >> 8)) ||
+		    (Response[3] != (uint8_t)SD_IF_COND_VOLTAGE_CHECK))
+		{
+			return SD_CARDTYPE_None;
+		}
+
+		if (!(SDBlockDevice_WaitForInit(SD_ACMD_SEND_OP_COND, SD_OP_COND_HCS)))
+		  return SD_CARDTYPE_None;
+
+		/* Read the OCR register to determine if the card is block (high capacity) or byte addressed */
+		if (SDBlockDevice_SendCommand(SD_CMD_READ_OCR, 0) != SD_R1_READY)
+		  return SD_CARDTYPE_None;
+
+		for (uint8_t ByteNum = 0; ByteNum < sizeof(Response); ByteNum++)
+		  Response[ByteNum] = SDBlockDevice_ReceiveByte();
+
+		NewCardType = (Response[0] & SD_OCR_CCS) ? SD_CARDTYPE_SDHC : SD_CARDTYPE_SDv2;
+	}
+	else
+	{
+		uint8_t InitCommand;
+
+		/* Version 1 SD cards accept the SD card initialization command, MMC cards only accept the generic command */
+		if (SDBlockDevice_SendCommand(SD_ACMD_SEND_OP_COND, 0) <= SD_R1_IDLE_STATE)
+		{
+			NewCardType = SD_CARDTYPE_SDv1;
+			InitCommand = SD_ACMD_SEND_OP_COND;
+		}
+		else
+		{
+			NewCardType = SD_CARDTYPE_MMC;
+			InitCommand = SD_CMD_SEND_OP_COND;
+		}
+
+		if (!(SDBlockDevice_WaitForInit(InitCommand, 0)))
+		  return SD_CARDTYPE_None;
+	}
+
+	/* Byte addressed cards must be set to the block size, high capacity cards always use fixed 512 byte blocks */
+	if ((NewCardType != SD_CARDTYPE_SDHC) &&
+	    (SDBlockDevice_SendCommand(SD_CMD_SET_BLOCKLEN, BLOCKDEV_BLOCK_SIZE) != SD_R1_READY))
+	{
+		return SD_CARDTYPE_None;
+	}
+
+	if (!(SDBlockDevice_ReadCSD(CSD)))
+	  return SD_CARDTYPE_None;
+
+	return NewCardType;
+}
+
+/** Begins a read or write of the given blocks, selecting the card and sending the single or multiple block read or write
+ *  command. If successful, the card is left selected until the transfer is ended by \ref SDBlockDevice_EndTransfer().
+ *
+ *  \param[in] BlockAddress  Address of the first block to transfer
+ *  \param[in] TotalBlocks   Number of blocks to transfer
+ *  \param[in] IsWrite       Boolean true if the blocks are to be written, false if they are to be read
+ *
+ *  \return A value from the \ref BlockDevice_ErrorCodes_t enum
+ */
+static uint8_t SDBlockDevice_BeginTransfer(const uint32_t BlockAddress, const uint16_t TotalBlocks, const bool IsWrite)
+{
+	uint8_t Command;
+	uint8_t Response;
+
+	if (CardType == SD_CARDTYPE_None)
+	  return BLOCKDEV_ERROR_NotReady;
+
+	/* Check that all the requested blocks lie within the card */
+	if ((BlockAddress + TotalBlocks) > CardTotalBlocks)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	SDBlockDevice_SelectCard();
+
+	if (!(TotalBlocks))
+	  return BLOCKDEV_ERROR_NoError;
+
+	if (IsWrite)
+	{
+		if (TotalBlocks > 1)
+		{
+			/* Tell SD cards how many blocks are about to be written, so that they can be erased ahead of the data */
+			if (CardType != SD_CARDTYPE_MMC)
+			  SDBlockDevice_SendCommand(SD_ACMD_SET_WR_BLK_ERASE_COUNT, TotalBlocks);
+
+			Command = SD_CMD_WRITE_MULTIPLE_BLOCK;
+		}
+		else
+		{
+			Command = SD_CMD_WRITE_BLOCK;
+		}
+	}
+	else
+	{
+		Command = (TotalBlocks > 1) ? SD_CMD_READ_MULTIPLE_BLOCK : SD_CMD_READ_SINGLE_BLOCK;
+	}
+
+	/* Byte addressed cards take the address of the first block's first byte rather than its block index */
+	Response = SDBlockDevice_SendCommand(Command, (CardType == SD_CARDTYPE_SDHC) ? BlockAddress :
+	                                              (BlockAddress * BLOCKDEV_BLOCK_SIZE));
+
+	if (Response != SD_R1_READY)
+	{
+		SDBlockDevice_DeselectCard();
+
+		/* A card which no longer responds to commands has been removed */
+		if (Response == SD_R1_NO_RESPONSE)
+		{
+			SDBlockDevice_RemoveCard();
+			return BLOCKDEV_ERROR_NotReady;
+		}
+
+		return BLOCKDEV_ERROR_DeviceError;
+	}
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+/** Ends a transfer started by \ref SDBlockDevice_BeginTransfer(), stopping a multiple block transfer and deselecting the
+ *  card. The card is left programming the last written data in the background.
+ *
+ *  \param[in] TotalBlocks  Number of blocks of the transfer
+ *  \param[in] IsWrite      Boolean true if the transfer is a write, false if it is a read
+ *  \param[in] ErrorCode    Error code of the transfer, from the \ref BlockDevice_ErrorCodes_t enum
+ *
+ *  \return The given error code, so that it can be returned directly by the transfer function
+ */
+static uint8_t SDBlockDevice_EndTransfer(const uint16_t TotalBlocks, const bool IsWrite, const uint8_t ErrorCode)
+{
+	if (TotalBlocks > 1)
+	{
+		if (IsWrite)
+		{
+			/* Wait until the card has accepted the last block before ending the multiple block write */
+			if (SDBlockDevice_WaitWhileBusy())
+			{
+				SPI_SendByte(SD_TOKEN_STOP_TRAN);
+
+				/* Skip the byte sent by the card before it begins programming the remaining data */
+				SDBlockDevice_ReceiveByte();
+				CardProgramming = true;
+			}
+		}
+		else
+		{
+			SDBlockDevice_SendCommand(SD_CMD_STOP_TRANSMISSION, 0);
+		}
+	}
+
+	SDBlockDevice_DeselectCard();
+	return ErrorCode;
+}
+
+/** Begins the transfer of the next block's data. For writes the start token is sent once the card has programmed the
+ *  previous block, and for reads the card's start token is awaited.
+ *
+ *  \param[in] TotalBlocks  Number of blocks of the transfer, to select the start token of a write
+ *  \param[in] IsWrite      Boolean true if the block is to be written, false if it is to be read
+ *
+ *  \return Boolean true if the block's data may now be transferred, false if the card is busy or returned an error
+ */
+static bool SDBlockDevice_BeginBlock(const uint16_t TotalBlocks, const bool IsWrite)
+{
+	if (IsWrite)
+	{
+		/* Wait until the card has programmed the previous block, then send the start token for the next block */
+		if (!(SDBlockDevice_WaitWhileBusy()))
+		  return false;
+
+		SPI_SendByte((TotalBlocks > 1) ? SD_TOKEN_START_MULTI_WRITE : SD_TOKEN_START_BLOCK);
+		return true;
+	}
+	else
+	{
+		/* Wait until the card has read the block and sends the start token, or sends an error token */
+		for (uint16_t Timeout = SD_BLOCKDEV_TOKEN_TIMEOUT; Timeout; Timeout--)
+		{
+			uint8_t Token = SDBlockDevice_ReceiveByte();
+
+			if (Token != 0xFF)
+			  return (Token == SD_TOKEN_START_BLOCK);
+		}
+
+		return false;
+	}
+}
+
+/** Ends the transfer of a block's data, transferring the block's CRC and checking that a written block was accepted.
+ *
+ *  \param[in] IsWrite  Boolean true if the block was written, false if it was read
+ *
+ *  \return Boolean true if the block was transferred, false if the card rejected a written block
+ */
+static bool SDBlockDevice_EndBlock(const bool IsWrite)
+{
+	/* Send or discard the block's CRC, which is not checked while the card is in SPI mode */
+	SDBlockDevice_ReceiveByte();
+	SDBlockDevice_ReceiveByte();
+
+	if (!(IsWrite))
+	  return true;
+
+	/* Check that the block was accepted, after which the card will be busy while it programs the block */
+	CardProgramming = true;
+	return ((SDBlockDevice_ReceiveByte() & SD_DATA_RESPONSE_MASK) == SD_DATA_RESPONSE_ACCEPTED);
+}
+
+/** Aborts a transfer part way through a block, clocking through the remainder of the block before ending the transfer.
+ *
+ *  \param[in] BytesRemaining  Number of bytes of the current block which have not yet been transferred
+ *  \param[in] TotalBlocks     Number of blocks of the transfer
+ *  \param[in] IsWrite         Boolean true if the transfer is a write, false if it is a read
+ *  \param[in] ErrorCode       Error code of the transfer, from the \ref BlockDevice_ErrorCodes_t enum
+ *
+ *  \return The given error code, so that it can be returned directly by the transfer function
+ */
+static uint8_t SDBlockDevice_AbortBlock(uint16_t BytesRemaining, const uint16_t TotalBlocks, const bool IsWrite,
+                                        const uint8_t ErrorCode)
+{
+	/* A block cannot be abandoned part way through, thus the remainder of the current block must be clocked through */
+	while (BytesRemaining--)
+	  SDBlockDevice_ReceiveByte();
+
+	SDBlockDevice_EndBlock(IsWrite);
+	return SDBlockDevice_EndTransfer(TotalBlocks, IsWrite, ErrorCode);
+}
+
+uint8_t BlockDevice_Init(void)
+{
+	uint8_t CSD[SD_CSD_LENGTH];
+	uint8_t NewCardType;
+
+	SDBlockDevice_RemoveCard();
+
+	SD_BLOCKDEV_CS_PORT |= SD_BLOCKDEV_CS_MASK;
+	SD_BLOCKDEV_CS_DDR  |= SD_BLOCKDEV_CS_MASK;
+
+	/* Cards must be identified at a slow clock, as the card's maximum clock is not yet known */
+	SPI_Init(SDBlockDevice_GetSPISpeedMask(SD_BLOCKDEV_IDENTIFICATION_CLOCK) |
+	         SPI_SCK_LEAD_RISING | SPI_SAMPLE_LEADING | SPI_MODE_MASTER);
+
+	/* Send at least 74 clocks with the card deselected, so that the card can complete its power up sequence */
+	for (uint8_t ByteNum = 0; ByteNum < 10; ByteNum++)
+	  SDBlockDevice_ReceiveByte();
+
+	SDBlockDevice_SelectCard();
+	NewCardType = SDBlockDevice_IdentifyCard(CSD);
+	SDBlockDevice_DeselectCard();
+
+	if (NewCardType == SD_CARDTYPE_None)
+	  return BLOCKDEV_ERROR_NotReady;
+
+	/* Decode the card's capacity from the CSD register, whose layout depends on the CSD structure version */
+	if (((CSD[0] >> 6) == 1) && (NewCardType != SD_CARDTYPE_MMC))
+	{
+		uint32_t DeviceSize = (((uint32_t)(CSD[7] & 0x3F) << 16) | ((uint16_t)CSD[8] << 8) | CSD[9]);
+
+		CardTotalBlocks = ((DeviceSize + 1) << 10);
+	}
+	else
+	{
+		uint16_t DeviceSize = (((uint16_t)(CSD[6] & 0x03) << 10) | ((uint16_t)CSD[7] << 2) | (CSD[8] >> 6));
+		uint8_t  SizeShift  = ((((CSD[9] & 0x03) << 1) | (CSD[10] >> 7)) + 2 + (CSD[5] & 0x0F) - 9);
+
+		CardTotalBlocks = (((uint32_t)DeviceSize + 1) << SizeShift);
+	}
+
+	/* Decode the card's maximum transfer rate, and switch to the fastest SPI clock which does not exceed it */
+	uint32_t MaxClock = (10000UL * pgm_read_byte(&TransferRateMultipliers[(CSD[3] >> 3) & 0x0F]));
+
+	for (uint8_t RateUnit = (CSD[3] & 0x07); RateUnit && (MaxClock < F_CPU); RateUnit--)
+	  MaxClock *= 10;
+
+	SPI_Init(SDBlockDevice_GetSPISpeedMask(MaxClock) | SPI_SCK_LEAD_RISING | SPI_SAMPLE_LEADING | SPI_MODE_MASTER);
+
+	CardType = NewCardType;
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_GetCapabilities(void)
+{
+	return (BLOCKDEV_CAP_WRITABLE | BLOCKDEV_CAP_ASYNC_WRITES | BLOCKDEV_CAP_REMOVABLE);
+}
+
+uint32_t BlockDevice_GetTotalBlocks(void)
+{
+	return CardTotalBlocks;
+}
+
+#if defined(USB_CAN_BE_DEVICE)
+uint8_t BlockDevice_WriteBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                         const volatile bool* const AbortFlag)
+{
+	uint8_t ErrorCode;
+
+	/* Wait until endpoint is ready before continuing, so that the card is not left waiting part way through a block */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+
+	if ((ErrorCode = SDBlockDevice_BeginTransfer(BlockAddress, TotalBlocks, true)) != BLOCKDEV_ERROR_NoError)
+	  return ErrorCode;
+
+	for (uint16_t CurrBlock = 0; CurrBlock < TotalBlocks; CurrBlock++)
+	{
+		if (!(SDBlockDevice_BeginBlock(TotalBlocks, true)))
+		  return SDBlockDevice_EndTransfer(TotalBlocks, true, BLOCKDEV_ERROR_DeviceError);
+
+		for (uint16_t BytesRem = BLOCKDEV_BLOCK_SIZE; BytesRem; BytesRem -= 16)
+		{
+			/* Check if the endpoint is currently empty */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the current endpoint bank */
+				Endpoint_ClearOUT();
+
+				/* Wait until the host has sent another packet */
+				if (Endpoint_WaitUntilReady())
+				  return SDBlockDevice_AbortBlock(BytesRem, TotalBlocks, true, BLOCKDEV_ERROR_EndpointError);
+			}
+
+			/* Write one 16-byte chunk of data to the card */
+			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+			  SPI_SendByte(Endpoint_Read_Byte());
+
+			/* Check if the current transfer is being aborted */
+			if ((AbortFlag != NULL) && *AbortFlag)
+			  return SDBlockDevice_AbortBlock((BytesRem - 16), TotalBlocks, true, BLOCKDEV_ERROR_Aborted);
+		}
+
+		if (!(SDBlockDevice_EndBlock(true)))
+		  return SDBlockDevice_EndTransfer(TotalBlocks, true, BLOCKDEV_ERROR_DeviceError);
+	}
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	return SDBlockDevice_EndTransfer(TotalBlocks, true, BLOCKDEV_ERROR_NoError);
+}
+
+uint8_t BlockDevice_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                        const volatile bool* const AbortFlag)
+{
+	uint8_t ErrorCode;
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+
+	if ((ErrorCode = SDBlockDevice_BeginTransfer(BlockAddress, TotalBlocks, false)) != BLOCKDEV_ERROR_NoError)
+	  return ErrorCode;
+
+	for (uint16_t CurrBlock = 0; CurrBlock < TotalBlocks; CurrBlock++)
+	{
+		if (!(SDBlockDevice_BeginBlock(TotalBlocks, false)))
+		  return SDBlockDevice_EndTransfer(TotalBlocks, false, BLOCKDEV_ERROR_DeviceError);
+
+		for (uint16_t BytesRem = BLOCKDEV_BLOCK_SIZE; BytesRem; BytesRem -= 16)
+		{
+			/* Check if the endpoint is currently full */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the endpoint bank to send its contents to the host */
+				Endpoint_ClearIN();
+
+				/* Wait until the endpoint is ready for more data */
+				if (Endpoint_WaitUntilReady())
+				  return SDBlockDevice_AbortBlock(BytesRem, TotalBlocks, false, BLOCKDEV_ERROR_EndpointError);
+			}
+
+			/* Send one 16-byte chunk of data from the card */
+			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+			  Endpoint_Write_Byte(SDBlockDevice_ReceiveByte());
+
+			/* Check if the current transfer is being aborted */
+			if ((AbortFlag != NULL) && *AbortFlag)
+			  return SDBlockDevice_AbortBlock((BytesRem - 16), TotalBlocks, false, BLOCKDEV_ERROR_Aborted);
+		}
+
+		SDBlockDevice_EndBlock(false);
+	}
+
+	/* If the endpoint is full, send its contents to the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	return SDBlockDevice_EndTransfer(TotalBlocks, false, BLOCKDEV_ERROR_NoError);
+}
+#endif
+
+uint8_t BlockDevice_WriteBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, const uint8_t* BufferPtr)
+{
+	uint8_t ErrorCode;
+
+	if ((ErrorCode = SDBlockDevice_BeginTransfer(BlockAddress, TotalBlocks, true)) != BLOCKDEV_ERROR_NoError)
+	  return ErrorCode;
+
+	for (uint16_t CurrBlock = 0; CurrBlock < TotalBlocks; CurrBlock++)
+	{
+		if (!(SDBlockDevice_BeginBlock(TotalBlocks, true)))
+		  return SDBlockDevice_EndTransfer(TotalBlocks, true, BLOCKDEV_ERROR_DeviceError);
+
+		for (uint16_t ByteNum = 0; ByteNum < BLOCKDEV_BLOCK_SIZE; ByteNum++)
+		  SPI_SendByte(*(BufferPtr++));
+
+		if (!(SDBlockDevice_EndBlock(true)))
+		  return SDBlockDevice_EndTransfer(TotalBlocks, true, BLOCKDEV_ERROR_DeviceError);
+	}
+
+	return SDBlockDevice_EndTransfer(TotalBlocks, true, BLOCKDEV_ERROR_NoError);
+}
+
+uint8_t BlockDevice_ReadBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, uint8_t* BufferPtr)
+{
+	uint8_t ErrorCode;
+
+	if ((ErrorCode = SDBlockDevice_BeginTransfer(BlockAddress, TotalBlocks, false)) != BLOCKDEV_ERROR_NoError)
+	  return ErrorCode;
+
+	for (uint16_t CurrBlock = 0; CurrBlock < TotalBlocks; CurrBlock++)
+	{
+		if (!(SDBlockDevice_BeginBlock(TotalBlocks, false)))
+		  return SDBlockDevice_EndTransfer(TotalBlocks, false, BLOCKDEV_ERROR_DeviceError);
+
+		for (uint16_t ByteNum = 0; ByteNum < BLOCKDEV_BLOCK_SIZE; ByteNum++)
+		  *(BufferPtr++) = SDBlockDevice_ReceiveByte();
+
+		SDBlockDevice_EndBlock(false);
+	}
+
+	return SDBlockDevice_EndTransfer(TotalBlocks, false, BLOCKDEV_ERROR_NoError);
+}
+
+uint8_t BlockDevice_Flush(void)
+{
+	uint8_t ErrorCode = BLOCKDEV_ERROR_NoError;
+
+	if (CardType == SD_CARDTYPE_None)
+	  return BLOCKDEV_ERROR_NotReady;
+
+	/* Wait until the card has finished programming all written data */
+	if (CardProgramming)
+	{
+		SDBlockDevice_SelectCard();
+
+		if (!(SDBlockDevice_WaitWhileBusy()))
+		  ErrorCode = BLOCKDEV_ERROR_DeviceError;
+
+		SDBlockDevice_DeselectCard();
+	}
+
+	return ErrorCode;
+}
+
+bool BlockDevice_IsBusy(void)
+{
+	/* Sample the card's data output once, which is held low while the card is programming */
+	if (CardProgramming)
+	{
+		SDBlockDevice_SelectCard();
+
+		if (SDBlockDevice_ReceiveByte() == 0xFF)
+		  CardProgramming = false;
+
+		SDBlockDevice_DeselectCard();
+	}
+
+	return CardProgramming;
+}
+
+bool BlockDevice_CheckOperation(void)
+{
+	bool CardOK;
+
+	/* Attempt to initialize a card which has been inserted since the last check */
+	if (CardType == SD_CARDTYPE_None)
+	  return (BlockDevice_Init() == BLOCKDEV_ERROR_NoError);
+
+	/* Read the card status, which is only returned by a card which is still present and operating normally */
+	SDBlockDevice_SelectCard();
+	CardOK = ((SDBlockDevice_SendCommand(SD_CMD_SEND_STATUS, 0) == SD_R1_READY) && !(SDBlockDevice_ReceiveByte()));
+	SDBlockDevice_DeselectCard();
+
+	if (!(CardOK))
+	  SDBlockDevice_RemoveCard();
+
+	return CardOK;
+}
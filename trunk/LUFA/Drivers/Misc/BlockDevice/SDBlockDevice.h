@@ -0,0 +1,152 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief SD/MMC card block device backend.
+ *
+ *  Block device backend for an SD, SDHC or MMC memory card connected to the AVR's hardware SPI port in SPI mode. The
+ *  SPI driver is initialized by this backend in \ref BlockDevice_Init(), first at a card identification clock of no more
+ *  than 400KHz, and then at the fastest SPI clock which does not exceed the maximum transfer rate reported by the card.
+ *  The card's chip select line defaults to the AVR's /SS pin, and may be changed by defining the SD_BLOCKDEV_CS_PORT,
+ *  SD_BLOCKDEV_CS_DDR and SD_BLOCKDEV_CS_MASK tokens in the project makefile and passing them to the compiler via the -D
+ *  switch.
+ *
+ *  Transfers of more than one block use the card's multiple block read and write commands, so that the command, start
+ *  token and card access latency is paid once per transfer rather than once per block. SD cards are also told the number
+ *  of blocks to be written before each multiple block write, so that the card may pre-erase the destination. Writes return
+ *  as soon as the card has accepted the last block, with the card completing its programming in the background; this may
+ *  be tracked through \ref BlockDevice_IsBusy().
+ *
+ *  As the card is removable, \ref BlockDevice_CheckOperation() re-initializes a newly inserted card, and all other
+ *  operations report \ref BLOCKDEV_ERROR_NotReady while no initialized card is present.
+ *
+ *  \note This file should not be included directly. Include LUFA/Drivers/Misc/BlockDevice.h instead, and add this backend's
+ *        source file to the project makefile.
+ */
+
+#ifndef __SD_BLOCKDEVICE_H__
+#define __SD_BLOCKDEVICE_H__
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+
+		#include "../BlockDevice.h"
+		#include "../../Peripheral/SPI.h"
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#if !defined(SD_BLOCKDEV_CS_PORT)
+				#define SD_BLOCKDEV_CS_PORT                 PORTB
+			#endif
+
+			#if !defined(SD_BLOCKDEV_CS_DDR)
+				#define SD_BLOCKDEV_CS_DDR                  DDRB
+			#endif
+
+			#if !defined(SD_BLOCKDEV_CS_MASK)
+				#define SD_BLOCKDEV_CS_MASK                 (1 << 0)
+			#endif
+
+			#define SD_BLOCKDEV_IDENTIFICATION_CLOCK        400000UL
+			#define SD_BLOCKDEV_INIT_RETRIES                4000
+			#define SD_BLOCKDEV_TOKEN_TIMEOUT               0xFFFF
+			#define SD_BLOCKDEV_BUSY_TIMEOUT                0x7FFFFUL
+			#define SD_BLOCKDEV_RESPONSE_RETRIES            10
+
+			#define SD_ACMD_MASK                            0x80
+
+			#define SD_CMD_GO_IDLE_STATE                    0
+			#define SD_CMD_SEND_OP_COND                     1
+			#define SD_CMD_SEND_IF_COND                     8
+			#define SD_CMD_SEND_CSD                         9
+			#define SD_CMD_STOP_TRANSMISSION                12
+			#define SD_CMD_SEND_STATUS                      13
+			#define SD_CMD_SET_BLOCKLEN                     16
+			#define SD_CMD_READ_SINGLE_BLOCK                17
+			#define SD_CMD_READ_MULTIPLE_BLOCK              18
+			#define SD_CMD_WRITE_BLOCK                      24
+			#define SD_CMD_WRITE_MULTIPLE_BLOCK             25
+			#define SD_CMD_APP_CMD                          55
+			#define SD_CMD_READ_OCR                         58
+			#define SD_ACMD_SET_WR_BLK_ERASE_COUNT          (SD_ACMD_MASK | 23)
+			#define SD_ACMD_SEND_OP_COND                    (SD_ACMD_MASK | 41)
+
+			#define SD_R1_READY                             0x00
+			#define SD_R1_IDLE_STATE                        (1 << 0)
+			#define SD_R1_NO_RESPONSE                       0xFF
+
+			#define SD_IF_COND_VOLTAGE_CHECK                0x000001AAUL
+			#define SD_OP_COND_HCS                          (1UL << 30)
+			#define SD_OCR_CCS                              (1 << 6)
+
+			#define SD_TOKEN_START_BLOCK                    0xFE
+			#define SD_TOKEN_START_MULTI_WRITE              0xFC
+			#define SD_TOKEN_STOP_TRAN                      0xFD
+			#define SD_DATA_RESPONSE_MASK                   0x1F
+			#define SD_DATA_RESPONSE_ACCEPTED               0x05
+
+			#define SD_CSD_LENGTH                           16
+
+		/* Enums: */
+			enum SD_CardTypes_t
+			{
+				SD_CARDTYPE_None = 0,
+				SD_CARDTYPE_MMC  = 1,
+				SD_CARDTYPE_SDv1 = 2,
+				SD_CARDTYPE_SDv2 = 3,
+				SD_CARDTYPE_SDHC = 4,
+			};
+
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_SD_BLOCKDEVICE_C)
+				static void    SDBlockDevice_SelectCard(void);
+				static void    SDBlockDevice_DeselectCard(void);
+				static void    SDBlockDevice_RemoveCard(void);
+				static uint8_t SDBlockDevice_ReceiveByte(void);
+				static bool    SDBlockDevice_WaitWhileBusy(void);
+				static uint8_t SDBlockDevice_SendCommand(const uint8_t Command, const uint32_t Argument);
+				static bool    SDBlockDevice_WaitForInit(const uint8_t Command, const uint32_t Argument);
+				static uint8_t SDBlockDevice_GetSPISpeedMask(const uint32_t MaxClock);
+				static bool    SDBlockDevice_ReadCSD(uint8_t* const CSD);
+				static uint8_t SDBlockDevice_IdentifyCard(uint8_t* const CSD);
+				static uint8_t SDBlockDevice_BeginTransfer(const uint32_t BlockAddress, const uint16_t TotalBlocks,
+				                                           const bool IsWrite);
+				static uint8_t SDBlockDevice_EndTransfer(const uint16_t TotalBlocks, const bool IsWrite,
+				                                         const uint8_t ErrorCode);
+				static bool    SDBlockDevice_BeginBlock(const uint16_t TotalBlocks, const bool IsWrite);
+				static bool    SDBlockDevice_EndBlock(const bool IsWrite);
+				static uint8_t SDBlockDevice_AbortBlock(uint16_t BytesRemaining, const uint16_t TotalBlocks,
+				                                        const bool IsWrite, const uint8_t ErrorCode);
+			#endif
+	#endif
+
+#endif
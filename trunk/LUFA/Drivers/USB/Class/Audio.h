@@ -43,10 +43,11 @@
  *  \section Sec_Dependencies Module Source Dependencies
  *  The following files must be built with any user project that uses this module:
  *    - LUFA/Drivers/USB/Class/Device/Audio.c
+ *    - LUFA/Drivers/USB/Class/Host/Audio.c
  *
  *  \section Module Description
- *  Audio Class Driver module. This module contains an internal implementation of the USB Audio Class, for Device
- *  USB mode only. User applications can use this class driver instead of implementing the Audio class manually via 
+ *  Audio Class Driver module. This module contains an internal implementation of the USB Audio Class, for both Device
+ *  and Host USB modes. User applications can use this class driver instead of implementing the Audio class manually via 
  *  the low-level LUFA APIs.
  *
  *  This module is designed to simplify the user code by exposing only the required interface needed to interface with
@@ -72,6 +73,10 @@
 		#if defined(USB_CAN_BE_DEVICE)
 			#include "Device/Audio.h"
 		#endif
+
+		#if defined(USB_CAN_BE_HOST)
+			#include "Host/Audio.h"
+		#endif
 		
 #endif
 
@@ -234,6 +234,18 @@
 		 *  will accept partially filled endpoint packets of audio samples.
 		 */
 		#define EP_ACCEPTS_SMALL_PACKETS     (0 << 7)
+
+		/** Size in bytes of the isochronous feedback endpoint of an asynchronous audio streaming OUT endpoint, holding a
+		 *  single 10.14 format samples per frame value.
+		 */
+		#define AUDIO_FEEDBACK_EPSIZE        3
+
+		/** Convenience macro, to convert a sample rate in Hz into the 10.14 fixed point samples per frame format used by
+		 *  an audio feedback endpoint.
+		 *
+		 *  \param[in] freq  Audio sampling frequency in Hz
+		 */
+		#define AUDIO_FEEDBACK_VALUE(freq)   (((uint32_t)(freq) << 14) / 1000)
 		
 	/* Type Defines: */
 		/** \brief Audio Class Specific Interface Descriptor.
@@ -375,7 +387,9 @@
 		{
 			USB_Descriptor_Endpoint_t Endpoint; /**< Standard endpoint descriptor describing the audio endpoint */
 
-			uint8_t                   Refresh; /**< Always set to zero */
+			uint8_t                   Refresh; /**< Power of two exponent of the rate in milliseconds at which a feedback endpoint
+			                                    *   provides new synchronization information, always zero for data endpoints
+			                                    */
 			uint8_t                   SyncEndpointNumber; /**< Endpoint address to send synchronization information to, if needed (zero otherwise) */
 		} USB_Audio_StreamEndpoint_Std_t;
 					
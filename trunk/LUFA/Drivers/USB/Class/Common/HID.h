@@ -136,6 +136,11 @@
 		/** Constant for a keyboard output report LED byte, indicating that the host's KATANA mode is currently set. */
 		#define HID_KEYBOARD_LED_KATANA         (1 << 3)
 
+		/** Constant for the total number of key codes (starting from key code 0x00) which may be reported as pressed in a
+		 *  \ref USB_KeyboardNKROReport_Data_t N-Key Rollover keyboard report.
+		 */
+		#define HID_KEYBOARD_NKRO_KEYCODES      104
+
 	/* Type Defines: */
 		/** Enum for the different types of HID reports. */
 		enum HID_ReportItemTypes_t
@@ -187,6 +192,23 @@
 			uint8_t KeyCode[6]; /**< Key codes of the currently pressed keys */
 		} USB_KeyboardReport_Data_t;
 
+		/** \brief N-Key Rollover Keyboard Report.
+		 *
+		 *  Type define for a N-Key Rollover keyboard report, where each key code is represented by a single bit in a bitmap
+		 *  so that any number of keys may be reported as pressed at once. This report is not boot protocol compatible, thus
+		 *  keyboards using it must fall back to the standard \ref USB_KeyboardReport_Data_t report when the host selects the
+		 *  boot protocol.
+		 */
+		typedef struct
+		{
+			uint8_t Modifier; /**< Keyboard modifier byte, indicating pressed modifier keys (a combination of
+			                   *   HID_KEYBOARD_MODIFER_* masks)
+			                   */
+			uint8_t KeyBitmap[HID_KEYBOARD_NKRO_KEYCODES / 8]; /**< Bitmap of the currently pressed keys, where key code n
+			                                                    *   is represented by bit (n % 8) of byte (n / 8)
+			                                                    */
+		} USB_KeyboardNKROReport_Data_t;
+
 		/** Type define for the data type used to store HID report descriptor elements. */
 		typedef uint8_t USB_Descriptor_HIDReport_Datatype_t;
 
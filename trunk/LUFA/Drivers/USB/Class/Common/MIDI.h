@@ -179,6 +179,12 @@
 			uint8_t Data3; /**< Third byte of data in the MIDI event */		
 		} MIDI_EventPacket_t;
 
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define MIDI_FRAME_NUMBER_MASK      0x07FF
+	#endif
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
@@ -123,6 +123,9 @@
 		/** SCSI Command Code for a MODE SENSE (10) command. */
 		#define SCSI_CMD_MODE_SENSE_10                         0x5A
 
+		/** SCSI Command Code for a SYNCHRONIZE CACHE (10) command. */
+		#define SCSI_CMD_SYNCHRONIZE_CACHE_10                  0x35
+
 		/** SCSI Sense Code to indicate no error has occurred. */
 		#define SCSI_SENSE_KEY_GOOD                            0x00
 
@@ -82,10 +82,60 @@ bool Audio_Device_ConfigureEndpoints(USB_ClassInfo_Audio_Device_t* AudioInterfac
 			return false;
 		}
 	}
+
+	if (AudioInterfaceInfo->Config.FeedbackEndpointNumber)
+	{
+		if (!(Endpoint_ConfigureEndpoint(AudioInterfaceInfo->Config.FeedbackEndpointNumber, EP_TYPE_ISOCHRONOUS,
+										 ENDPOINT_DIR_IN, AUDIO_FEEDBACK_EPSIZE, ENDPOINT_BANK_SINGLE)))
+		{
+			return false;
+		}
+	}
 	
 	return true;
 }
 
+void Audio_Device_USBTask(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(AudioInterfaceInfo->State.InterfaceEnabled))
+	  return;
+
+	if (!(AudioInterfaceInfo->Config.FeedbackEndpointNumber) || !(AudioInterfaceInfo->State.FeedbackValue))
+	  return;
+
+	Endpoint_SelectEndpoint(AudioInterfaceInfo->Config.FeedbackEndpointNumber);
+
+	/* Load the latest feedback value once the host has collected the previous one */
+	if (Endpoint_IsINReady())
+	{
+		uint32_t FeedbackValue = AudioInterfaceInfo->State.FeedbackValue;
+	
+		Endpoint_Write_Byte(FeedbackValue);
+		Endpoint_Write_Byte(FeedbackValue >> 8);
+		Endpoint_Write_Byte(FeedbackValue >> 16);
+		Endpoint_ClearIN();
+	}
+}
+
+void Audio_Device_UpdateFeedback(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                 const uint32_t SampleClocks,
+                                 const uint16_t TotalFrames,
+                                 const int16_t BufferFillError)
+{
+	if (!(TotalFrames))
+	  return;
+
+	int32_t FeedbackValue = ((SampleClocks << 14) / TotalFrames);
+
+	/* Request fewer samples per frame while the buffer is overfilled, and more while it is underfilled */
+	FeedbackValue -= ((int32_t)BufferFillError << AUDIO_FEEDBACK_FILL_SHIFT);
+
+	if (FeedbackValue < 0)
+	  FeedbackValue = 0;
+
+	AudioInterfaceInfo->State.FeedbackValue = FeedbackValue;
+}
+
 bool Audio_Device_IsSampleReceived(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo)
 {
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(AudioInterfaceInfo->State.InterfaceEnabled))
@@ -104,4 +154,55 @@ bool Audio_Device_IsReadyForNextSample(USB_ClassInfo_Audio_Device_t* const Audio
 	return Endpoint_IsINReady();
 }
 
-#endif
\ No newline at end of file
+uint16_t Audio_Device_ReadSampleFrames(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                       void* Buffer,
+                                       const uint8_t FrameSize,
+                                       const uint16_t MaxFrames)
+{
+	if (!(Audio_Device_IsSampleReceived(AudioInterfaceInfo)))
+	  return 0;
+
+	uint16_t TotalFrames = (Endpoint_BytesInEndpoint() / FrameSize);
+	
+	if (TotalFrames > MaxFrames)
+	  TotalFrames = MaxFrames;
+
+	uint8_t* DataStream = (uint8_t*)Buffer;
+
+	for (uint16_t BytesRemaining = (TotalFrames * FrameSize); BytesRemaining; BytesRemaining--)
+	  *(DataStream++) = Endpoint_Read_Byte();
+
+	/* Release the packet once no complete frames remain, discarding any trailing partial frame */
+	if (Endpoint_BytesInEndpoint() < FrameSize)
+	  Endpoint_ClearOUT();
+
+	return TotalFrames;
+}
+
+uint16_t Audio_Device_WriteSampleFrames(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                        const void* Buffer,
+                                        const uint8_t FrameSize,
+                                        const uint16_t TotalFrames)
+{
+	if (!(Audio_Device_IsReadyForNextSample(AudioInterfaceInfo)))
+	  return 0;
+
+	uint16_t BankFreeBytes = (AudioInterfaceInfo->Config.DataINEndpointSize - Endpoint_BytesInEndpoint());
+	uint16_t FramesToWrite = (BankFreeBytes / FrameSize);
+	
+	if (FramesToWrite > TotalFrames)
+	  FramesToWrite = TotalFrames;
+
+	const uint8_t* DataStream = (const uint8_t*)Buffer;
+
+	for (uint16_t BytesRemaining = (FramesToWrite * FrameSize); BytesRemaining; BytesRemaining--)
+	  Endpoint_Write_Byte(*(DataStream++));
+
+	/* Send the packet once no further complete frames will fit into it */
+	if ((BankFreeBytes - (FramesToWrite * FrameSize)) < FrameSize)
+	  Endpoint_ClearIN();
+
+	return FramesToWrite;
+}
+
+#endif
@@ -97,7 +97,11 @@
 													 */
 					uint16_t DataOUTEndpointSize; /**< Size in bytes of the outgoing Audio Streaming data endpoint, if available
 												   *   (zero if unused)
-												   */			
+												   */
+
+					uint8_t  FeedbackEndpointNumber; /**< Endpoint number of the isochronous feedback endpoint for an asynchronous
+					                                  *   outgoing Audio Streaming data endpoint, if available (zero if unused)
+					                                  */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -106,6 +110,9 @@
 					bool     InterfaceEnabled; /**< Set and cleared by the class driver to indicate if the host has enabled the streaming endpoints
 												*   of the Audio Streaming interface.
 												*/
+					uint32_t FeedbackValue; /**< Current 10.14 format samples per frame value reported to the host through the
+					                         *   feedback endpoint, or zero if no value has yet been set
+					                         */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */				
@@ -153,18 +160,82 @@
 			 */
 			bool Audio_Device_IsReadyForNextSample(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo);
 
-		/* Inline Functions: */
+			/** Reads a block of audio sample frames from the given audio interface into a buffer, up to the number of complete
+			 *  frames remaining in the current streaming OUT endpoint packet. Each frame consists of one sample for each of the
+			 *  interface's channels, interleaved and stored in the little endian byte order used on the bus. The endpoint
+			 *  packet is released once all complete frames within it have been read.
+			 *
+			 *  This should be used in preference to the single sample read functions when streaming at high sample rates, as
+			 *  the endpoint is selected and checked once per block rather than once per sample. Frames can then be consumed
+			 *  from the buffer at the sample rate, typically from a timer ISR.
+			 *
+			 *  \note This function must only be called when the Device state machine is in the DEVICE_STATE_Configured state or
+			 *        the call will fail.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state
+			 *  \param[out] Buffer     Pointer to a buffer where the read sample frames are to be stored
+			 *  \param[in]  FrameSize  Size in bytes of a single sample frame
+			 *  \param[in]  MaxFrames  Maximum number of sample frames to read into the buffer
+			 *
+			 *  \return Number of complete sample frames read into the buffer
+			 */
+			uint16_t Audio_Device_ReadSampleFrames(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                       void* Buffer,
+			                                       const uint8_t FrameSize,
+			                                       const uint16_t MaxFrames) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Writes a block of audio sample frames from a buffer to the given audio interface, up to the number of complete
+			 *  frames which will fit into the current streaming IN endpoint packet. Each frame consists of one sample for each
+			 *  of the interface's channels, interleaved and stored in the little endian byte order used on the bus. The endpoint
+			 *  packet is sent to the host once no further complete frames will fit into it.
+			 *
+			 *  This should be used in preference to the single sample write functions when streaming at high sample rates, as
+			 *  the endpoint is selected and checked once per block rather than once per sample.
+			 *
+			 *  \note This function must only be called when the Device state machine is in the DEVICE_STATE_Configured state or
+			 *        the call will fail.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state
+			 *  \param[in] Buffer       Pointer to a buffer containing the sample frames to write
+			 *  \param[in] FrameSize    Size in bytes of a single sample frame
+			 *  \param[in] TotalFrames  Number of sample frames in the buffer
+			 *
+			 *  \return Number of complete sample frames written to the interface
+			 */
+			uint16_t Audio_Device_WriteSampleFrames(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                        const void* Buffer,
+			                                        const uint8_t FrameSize,
+			                                        const uint16_t TotalFrames) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Updates the samples per frame value reported to the host through the feedback endpoint of an asynchronous audio
+			 *  interface, from a measurement of the device's actual sample clock rate against the USB Start of Frame clock. The
+			 *  measured rate is corrected by the given sample buffer fill error, so that any accumulated drift between the two
+			 *  clocks is removed over time and the device's sample buffer never over- or under-runs.
+			 *
+			 *  The new value is sent to the host by \ref Audio_Device_USBTask() the next time the host polls the feedback endpoint.
+			 *
+			 *  \note This function should be called from the main program loop rather than from an ISR, as the value is read by
+			 *        \ref Audio_Device_USBTask() non-atomically.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state
+			 *  \param[in] SampleClocks     Number of device sample clock periods counted during the measurement, no more than 2^18 - 1
+			 *  \param[in] TotalFrames      Number of USB frames elapsed during the measurement
+			 *  \param[in] BufferFillError  Number of sample frames by which the device's sample buffer exceeds its target fill level,
+			 *                              negative if the buffer holds fewer samples than the target
+			 */
+			void Audio_Device_UpdateFeedback(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                 const uint32_t SampleClocks,
+			                                 const uint16_t TotalFrames,
+			                                 const int16_t BufferFillError) ATTR_NON_NULL_PTR_ARG(1);
+
 			/** General management task for a given Audio class interface, required for the correct operation of the interface. This should
 			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
 			 *
 			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state
 			 */
-			static inline void Audio_Device_USBTask(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo);
-			static inline void Audio_Device_USBTask(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo)
-			{
-				(void)AudioInterfaceInfo;
-			}
+			void Audio_Device_USBTask(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
+		/* Inline Functions: */
 			/** Reads the next 8-bit audio sample from the current audio interface.
 			 *
 			 *  \note This should be preceded immediately by a call to the USB_Audio_IsSampleReceived() function to ensure that
@@ -294,6 +365,12 @@
 				  Endpoint_ClearIN();
 			}
 
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define AUDIO_FEEDBACK_FILL_SHIFT  8
+	#endif
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
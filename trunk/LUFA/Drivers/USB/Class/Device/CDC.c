@@ -41,6 +41,11 @@ void CDC_Device_Event_Stub(void)
 
 }
 
+bool CDC_Device_Mux_Stub(void)
+{
+	return false;
+}
+
 void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* CDCInterfaceInfo)
 {
 	if (!(Endpoint_IsSETUPReceived()))
@@ -243,6 +248,78 @@ void CDC_Device_SendControlLineStateChange(USB_ClassInfo_CDC_Device_t* const CDC
 	Endpoint_ClearIN();
 }
 
+void CDC_Device_MuxTask(CDC_Device_Mux_t* const MuxInfo)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return;
+
+	uint8_t PortIndex = MuxInfo->State.NextPort;
+
+	if (PortIndex >= MuxInfo->Config.TotalPorts)
+	  PortIndex = 0;
+
+	MuxInfo->State.NextPort = ((PortIndex + 1) < MuxInfo->Config.TotalPorts) ? (PortIndex + 1) : 0;
+
+	for (uint8_t PortsRemaining = MuxInfo->Config.TotalPorts; PortsRemaining; PortsRemaining--)
+	{
+		CDC_Device_MuxPort_t*       Port             = &MuxInfo->Config.Ports[PortIndex];
+		USB_ClassInfo_CDC_Device_t* CDCInterfaceInfo = Port->CDCInterfaceInfo;
+		
+		if (CDCInterfaceInfo->State.LineEncoding.BaudRateBPS)
+		{
+			Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpointNumber);
+
+			if (Endpoint_IsOUTReceived() && !(Endpoint_BytesInEndpoint()))
+			  Endpoint_ClearOUT();
+			
+			Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpointNumber);
+			
+			uint16_t BytesRemaining = MuxInfo->Config.PortByteBudget;
+			uint8_t  Data;
+			
+			while (BytesRemaining)
+			{
+				if (!(Endpoint_IsReadWriteAllowed()))
+				{
+					Port->BankDeferrals++;
+					break;
+				}
+
+				if (!(CALLBACK_CDC_Device_MuxGetTxByte(MuxInfo, PortIndex, &Data)))
+				{
+					Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpointNumber);
+
+					if (Endpoint_BytesInEndpoint() || CDCInterfaceInfo->State.MuxZLPPending)
+					{
+						Endpoint_ClearIN();
+						Port->BanksSent++;
+						CDCInterfaceInfo->State.MuxZLPPending = false;
+					}
+
+					break;
+				}
+
+				Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpointNumber);
+				Endpoint_Write_Byte(Data);
+
+				Port->BytesSent++;
+				BytesRemaining--;
+
+				/* Release a full bank straight away, so that the host can read it while the other ports are serviced */
+				if (!(Endpoint_IsReadWriteAllowed()))
+				{
+					Endpoint_ClearIN();
+					Port->BanksSent++;
+					CDCInterfaceInfo->State.MuxZLPPending = true;
+				}
+			}
+		}
+		
+		if (++PortIndex == MuxInfo->Config.TotalPorts)
+		  PortIndex = 0;
+	}
+}
+
 void CDC_Device_CreateStream(USB_ClassInfo_CDC_Device_t* CDCInterfaceInfo, FILE* Stream)
 {
 	*Stream = (FILE)FDEV_SETUP_STREAM(CDC_Device_putchar, CDC_Device_getchar, _FDEV_SETUP_RW);
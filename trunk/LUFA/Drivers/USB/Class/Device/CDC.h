@@ -141,10 +141,63 @@
 					} LineEncoding;	/** Line encoding used in the virtual serial port, for the device's information. This is generally
 					                 *  only used if the virtual serial port data is to be reconstructed on a physical UART.
 					                 */		
+
+					bool MuxZLPPending; /**< Set by \ref CDC_Device_MuxTask() when the last bank it released through the
+					                     *   interface was full, so that a Zero Length Packet is sent to terminate the
+					                     *   transfer if the interface has no further data. For use by the driver only, and
+					                     *   should not be altered by the user application.
+					                     */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
 			} USB_ClassInfo_CDC_Device_t;
+
+			/** \brief CDC Class Device Mode Multiplexer Port Structure.
+			 *
+			 *  Per-port record of a \ref CDC_Device_Mux_t multiplexer. An array of these structures, one for each CDC
+			 *  interface to be serviced, should be created by the user application and referenced by the multiplexer's
+			 *  configuration. The port counters are never reset by the driver, and may be read and cleared by the user
+			 *  application at any time to measure the throughput of each port. Each counter wraps back to zero once it
+			 *  exceeds its maximum value of 2^32 - 1, which should be accounted for by applications which sample the
+			 *  counters over very long periods.
+			 */
+			typedef struct
+			{
+				USB_ClassInfo_CDC_Device_t* CDCInterfaceInfo; /**< CDC interface serviced by this multiplexer port */
+
+				uint32_t BytesSent; /**< Total number of bytes queued for transmission to the host through this port */
+				uint32_t BanksSent; /**< Total number of endpoint banks (packets) released to the host through this port,
+				                     *   including any Zero Length Packets used to terminate transfers
+				                     */
+				uint32_t BankDeferrals; /**< Total number of times this port was skipped due to its IN endpoint banks
+				                         *   being occupied, i.e. the host was not reading the port's data fast enough
+				                         */
+			} CDC_Device_MuxPort_t;
+
+			/** \brief CDC Class Device Mode Multiplexer Configuration and State Structure.
+			 *
+			 *  Class multiplexer structure, used to fairly service the data IN endpoints of several CDC interfaces within
+			 *  the one device. Each call to \ref CDC_Device_MuxTask() services every port in turn, starting from a different
+			 *  port each time, and sends at most a fixed byte budget per port so that a single busy port cannot starve the
+			 *  others.
+			 */
+			typedef struct
+			{
+				const struct
+				{
+					CDC_Device_MuxPort_t* Ports; /**< Pointer to an array of ports to service */
+					uint8_t  TotalPorts; /**< Number of ports in the \ref Ports array */
+					uint16_t PortByteBudget; /**< Maximum number of bytes which may be sent through each port on each
+					                          *   call to \ref CDC_Device_MuxTask()
+					                          */
+				} Config; /**< Config data for the CDC multiplexer. All elements in this section <b>must</b> be set or the
+				           *   multiplexer will fail to operate correctly.
+				           */
+				struct
+				{
+					uint8_t NextPort; /**< Index of the port to be serviced first on the next multiplexer pass */
+				} State; /**< State data for the CDC multiplexer. */
+			} CDC_Device_Mux_t;
 		
 		/* Function Prototypes: */		
 			/** Configures the endpoints of a given CDC interface, ready for use. This should be linked to the library
@@ -294,6 +347,37 @@
 			 */
 			void CDC_Device_CreateBlockingStream(USB_ClassInfo_CDC_Device_t* CDCInterfaceInfo, FILE* Stream);
 
+			/** Services the data IN endpoints of all the CDC interfaces attached to the given multiplexer in a round-robin
+			 *  fashion. Each port may send up to the multiplexer's configured byte budget per call, with the data to send
+			 *  fetched from the user application via the \ref CALLBACK_CDC_Device_MuxGetTxByte() callback. Ports whose endpoint
+			 *  banks are still occupied are skipped rather than waited upon, and partially filled banks are only flushed once
+			 *  the port has no further data to send, so that each packet to the host is as full as possible. When a port runs
+			 *  out of data immediately after releasing a full bank, a Zero Length Packet is sent to end the transfer so that
+			 *  the host does not wait for more data.
+			 *
+			 *  This function replaces the calls to \ref CDC_Device_USBTask() for each of the multiplexed CDC interfaces, and
+			 *  should be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
+			 *  Data from the host should still be read via the regular \ref CDC_Device_BytesReceived() and
+			 *  \ref CDC_Device_ReceiveByte() functions.
+			 *
+			 *  \param[in,out] MuxInfo  Pointer to a structure containing a CDC multiplexer configuration and state
+			 */
+			void CDC_Device_MuxTask(CDC_Device_Mux_t* const MuxInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** CDC class driver callback for the retrieval of the next byte to send through a multiplexed CDC interface. This
+			 *  callback is fired by \ref CDC_Device_MuxTask() each time a port has room in its current endpoint bank and some
+			 *  of its byte budget remaining, and may be hooked in the user program by declaring a handler function with the
+			 *  same name and parameters listed here. The default handler reports that no data is waiting to be sent.
+			 *
+			 *  \param[in,out] MuxInfo  Pointer to a structure containing a CDC multiplexer configuration and state
+			 *  \param[in] PortIndex  Index of the port being serviced within the multiplexer's \ref CDC_Device_Mux_t::Config Ports array
+			 *  \param[out] Data  Pointer to a location where the next byte to send should be stored
+			 *
+			 *  \return Boolean true if a byte was stored to Data, false if the given port has no data waiting to be sent
+			 */
+			bool CALLBACK_CDC_Device_MuxGetTxByte(CDC_Device_Mux_t* const MuxInfo, const uint8_t PortIndex, uint8_t* const Data)
+			                                      ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3);
+
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
 		/* Function Prototypes: */
@@ -307,6 +391,10 @@
 														  ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_ALIAS(CDC_Device_Event_Stub);
 				void EVENT_CDC_Device_ControLineStateChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 															 ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_ALIAS(CDC_Device_Event_Stub);
+
+				bool CDC_Device_Mux_Stub(void);
+				bool CALLBACK_CDC_Device_MuxGetTxByte(CDC_Device_Mux_t* const MuxInfo, const uint8_t PortIndex, uint8_t* const Data)
+				                                      ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3) ATTR_ALIAS(CDC_Device_Mux_Stub);
 			#endif
 
 	#endif
@@ -32,6 +32,7 @@
 #include "../../HighLevel/USBMode.h"
 #if defined(USB_CAN_BE_DEVICE)
 
+#define  __INCLUDE_FROM_HID_CLASS_DEVICE_C
 #define  __INCLUDE_FROM_HID_DRIVER
 #include "HID.h"
 
@@ -46,7 +47,8 @@ void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInter
 	switch (USB_ControlRequest.bRequest)
 	{
 		case REQ_GetReport:
-			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE))
+			if ((USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE)) &&
+			    (HIDInterfaceInfo->Config.PrevReportINBuffer != NULL))
 			{
 				Endpoint_ClearSETUP();	
 
@@ -68,11 +70,16 @@ void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInter
 		case REQ_SetReport:
 			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
-				Endpoint_ClearSETUP();
-				
 				uint16_t ReportOUTSize = USB_ControlRequest.wLength;
-				uint8_t  ReportOUTData[ReportOUTSize];
-				uint8_t  ReportID = (USB_ControlRequest.wValue & 0xFF);
+				uint8_t  ReportID      = (USB_ControlRequest.wValue & 0xFF);
+
+				if (HIDInterfaceInfo->Config.ReportOUTMaxSize && (ReportOUTSize > HIDInterfaceInfo->Config.ReportOUTMaxSize))
+				  break;
+
+				Endpoint_ClearSETUP();
+
+				/* Zero length reports are also passed to the application, with a buffer of at least one byte */
+				uint8_t  ReportOUTData[ReportOUTSize ? ReportOUTSize : 1];
 
 				Endpoint_Read_Control_Stream_LE(ReportOUTData, ReportOUTSize);
 				Endpoint_ClearIN();
@@ -142,6 +149,14 @@ bool HID_Device_ConfigureEndpoints(USB_ClassInfo_HID_Device_t* const HIDInterfac
 	{
 		return false;
 	}
+
+	if (HIDInterfaceInfo->Config.ReportOUTEndpointNumber &&
+	    !(Endpoint_ConfigureEndpoint(HIDInterfaceInfo->Config.ReportOUTEndpointNumber, EP_TYPE_INTERRUPT,
+									 ENDPOINT_DIR_OUT, HIDInterfaceInfo->Config.ReportOUTEndpointSize,
+									 HIDInterfaceInfo->Config.ReportOUTEndpointDoubleBank ? ENDPOINT_BANK_DOUBLE : ENDPOINT_BANK_SINGLE)))
+	{
+		return false;
+	}
 	
 	return true;
 }
@@ -151,6 +166,15 @@ void HID_Device_USBTask(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
 	if (USB_DeviceState != DEVICE_STATE_Configured)
 	  return;
 
+	if (HIDInterfaceInfo->Config.ReportOUTEndpointNumber)
+	  HID_Device_ReceiveOUTReports(HIDInterfaceInfo);
+
+	if (HIDInterfaceInfo->Config.ReportINChangesMarked)
+	{
+		HID_Device_SendMarkedReport(HIDInterfaceInfo);
+		return;
+	}
+
 	Endpoint_SelectEndpoint(HIDInterfaceInfo->Config.ReportINEndpointNumber);
 	
 	if (Endpoint_IsReadWriteAllowed())
@@ -188,4 +212,99 @@ void HID_Device_USBTask(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
 	}
 }
 
+bool HID_Device_MarkReportChanged(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo, const uint8_t ReportID)
+{
+	for (uint8_t QueueIndex = 0; QueueIndex < HIDInterfaceInfo->State.TotalPendingReports; QueueIndex++)
+	{
+		if (HIDInterfaceInfo->State.PendingReportIDs[QueueIndex] == ReportID)
+		  return true;
+	}
+	
+	if (HIDInterfaceInfo->State.TotalPendingReports == HID_DEVICE_REPORT_QUEUE_SIZE)
+	  return false;
+	  
+	HIDInterfaceInfo->State.PendingReportIDs[HIDInterfaceInfo->State.TotalPendingReports++] = ReportID;
+	return true;
+}
+
+static void HID_Device_ReceiveOUTReports(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
+{
+	Endpoint_SelectEndpoint(HIDInterfaceInfo->Config.ReportOUTEndpointNumber);
+
+	while (Endpoint_IsOUTReceived())
+	{
+		uint16_t ReportOUTSize = Endpoint_BytesInEndpoint();
+		uint8_t  ReportID      = 0;
+
+		if (HIDInterfaceInfo->Config.ReportOUTUsingReportIDs && ReportOUTSize)
+		{
+			ReportID = Endpoint_Read_Byte();
+			ReportOUTSize--;
+		}
+
+		if (HIDInterfaceInfo->Config.ReportOUTMaxSize && (ReportOUTSize > HIDInterfaceInfo->Config.ReportOUTMaxSize))
+		{
+			Endpoint_ClearOUT();
+			continue;
+		}
+
+		/* Zero length reports are also passed to the application, with a buffer of at least one byte */
+		uint8_t  ReportOUTData[ReportOUTSize ? ReportOUTSize : 1];
+
+		Endpoint_Read_Stream_LE(ReportOUTData, ReportOUTSize, NO_STREAM_CALLBACK);
+		Endpoint_ClearOUT();
+
+		CALLBACK_HID_Device_ProcessHIDReport(HIDInterfaceInfo, ReportID, ReportOUTData, ReportOUTSize);
+
+		Endpoint_SelectEndpoint(HIDInterfaceInfo->Config.ReportOUTEndpointNumber);
+	}
+}
+
+static void HID_Device_SendMarkedReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
+{
+	bool IdlePeriodElapsed = (HIDInterfaceInfo->State.IdleCount && !(HIDInterfaceInfo->State.IdleMSRemaining));
+
+	if (!(HIDInterfaceInfo->State.TotalPendingReports) && !(IdlePeriodElapsed))
+	  return;
+
+	if (HIDInterfaceInfo->Config.PrevReportINBuffer == NULL)
+	  return;
+
+	Endpoint_SelectEndpoint(HIDInterfaceInfo->Config.ReportINEndpointNumber);
+
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  return;
+
+	uint8_t  ReportID     = 0;
+	uint16_t ReportINSize = 0;
+
+	if (HIDInterfaceInfo->State.TotalPendingReports)
+	{
+		ReportID = HIDInterfaceInfo->State.PendingReportIDs[0];
+
+		HIDInterfaceInfo->State.TotalPendingReports--;
+		memmove(&HIDInterfaceInfo->State.PendingReportIDs[0], &HIDInterfaceInfo->State.PendingReportIDs[1],
+		        HIDInterfaceInfo->State.TotalPendingReports);
+	}
+
+	memset(HIDInterfaceInfo->Config.PrevReportINBuffer, 0, HIDInterfaceInfo->Config.PrevReportINBufferSize);
+
+	CALLBACK_HID_Device_CreateHIDReport(HIDInterfaceInfo, &ReportID, REPORT_ITEM_TYPE_In,
+	                                    HIDInterfaceInfo->Config.PrevReportINBuffer, &ReportINSize);
+
+	if (!(ReportINSize))
+	  return;
+
+	HIDInterfaceInfo->State.IdleMSRemaining = HIDInterfaceInfo->State.IdleCount;
+
+	Endpoint_SelectEndpoint(HIDInterfaceInfo->Config.ReportINEndpointNumber);
+
+	if (ReportID)
+	  Endpoint_Write_Byte(ReportID);
+
+	Endpoint_Write_Stream_LE(HIDInterfaceInfo->Config.PrevReportINBuffer, ReportINSize, NO_STREAM_CALLBACK);
+	
+	Endpoint_ClearIN();
+}
+
 #endif
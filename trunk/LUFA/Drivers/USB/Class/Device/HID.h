@@ -70,6 +70,17 @@
 		#endif
 
 	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#if !defined(HID_DEVICE_REPORT_QUEUE_SIZE) || defined(__DOXYGEN__)
+				/** Constant indicating the maximum number of distinct report IDs which may be marked as changed and awaiting
+				 *  transmission at any one time on a HID interface using application marked report changes. A larger value
+				 *  allows for more simultaneously pending reports, but consumes more memory. By default this is set to 4 report
+				 *  IDs, but this can be overridden by defining HID_DEVICE_REPORT_QUEUE_SIZE to another value in the user project
+				 *  makefile, and passing the define to the compiler using the -D compiler switch.
+				 */
+				#define HID_DEVICE_REPORT_QUEUE_SIZE    4
+			#endif
+
 		/* Type Defines: */
 			/** \brief HID Class Device Mode Configuration and State Structure.
 			 *
@@ -77,9 +88,11 @@
 			 *  within the user application, and passed to each of the HID class driver functions as the
 			 *  HIDInterfaceInfo parameter. This stores each HID interface's configuration and state information.
 			 *
-			 *  \note Due to technical limitations, the HID device class driver does not utilize a separate OUT
-			 *        endpoint for host->device communications. Instead, the host->device data (if any) is sent to
-			 *        the device via the control endpoint.
+			 *  \note By default, the HID device class driver does not utilize a separate OUT endpoint for host->device
+			 *        communications, and host->device data (if any) is sent to the device via the control endpoint.
+			 *        For higher host->device throughput, an optional interrupt OUT endpoint may be configured, in which
+			 *        case reports sent by the host to the OUT endpoint are also passed to the application via the
+			 *        \ref CALLBACK_HID_Device_ProcessHIDReport() callback.
 			 */
 			typedef struct
 			{
@@ -90,13 +103,33 @@
 					uint8_t  ReportINEndpointNumber; /**< Endpoint number of the HID interface's IN report endpoint */
 					uint16_t ReportINEndpointSize; /**< Size in bytes of the HID interface's IN report endpoint */					
 					bool     ReportINEndpointDoubleBank; /** Indicates if the HID interface's IN report endpoint should use double banking */
+
+					uint8_t  ReportOUTEndpointNumber; /**< Endpoint number of the HID interface's OUT report endpoint, if used. If
+					                                   *   this is set to zero, no OUT endpoint is configured and all reports from the
+					                                   *   host are received via the control endpoint.
+					                                   */
+					uint16_t ReportOUTEndpointSize; /**< Size in bytes of the HID interface's OUT report endpoint, if used */
+					bool     ReportOUTEndpointDoubleBank; /** Indicates if the HID interface's OUT report endpoint should use double banking */
+					bool     ReportOUTUsingReportIDs; /**< Indicates if the HID interface's output reports are prefixed with a report ID
+					                                   *   byte when sent via the OUT report endpoint, i.e. if the HID report descriptor
+					                                   *   contains at least one REPORT ID element.
+					                                   */
+					uint16_t ReportOUTMaxSize; /**< Size in bytes of the largest output report accepted from the host, via either
+					                            *   the control endpoint or the OUT report endpoint. Each received report is buffered
+					                            *   on the stack before being passed to \ref CALLBACK_HID_Device_ProcessHIDReport(),
+					                            *   so this bounds the stack used by the driver; larger SET_REPORT requests are
+					                            *   stalled, and larger reports on the OUT report endpoint are discarded. If this is
+					                            *   set to zero, reports of any length requested by the host are accepted.
+					                            */
 					
 					void*    PrevReportINBuffer; /**< Pointer to a buffer where the previously created HID input report can be
 					                              *  stored by the driver, for comparison purposes to detect report changes that
 					                              *  must be sent immediately to the host. This should point to a buffer big enough
 					                              *  to hold the largest HID input report sent from the HID interface. If this is set
 												  *  to NULL, it is up to the user to force transfers when needed in the 
-												  *  \ref CALLBACK_HID_Device_CreateHIDReport() callback function.
+												  *  \ref CALLBACK_HID_Device_CreateHIDReport() callback function. This buffer is
+												  *  also used to create reports requested by the host via the control endpoint, thus
+												  *  such requests are stalled when it is NULL.
 												  *
 												  *  \note Due to the single buffer, the internal driver can only correctly compare
 												  *        subsequent reports with identical report IDs. In multiple report devices,
@@ -108,6 +141,17 @@
 					                                  *  can be compared. If the user app is to determine when reports are to be sent
 					                                  *  exclusively (i.e. \ref PrevReportINBuffer is NULL) this value is ignored.
 					                                  */
+
+					bool     ReportINChangesMarked; /**< Indicates if the user application marks changed input reports via calls to
+					                                 *   \ref HID_Device_MarkReportChanged(), rather than having the driver create and
+					                                 *   compare a new report on each call to \ref HID_Device_USBTask(). When set, input
+					                                 *   reports are only created in the \ref CALLBACK_HID_Device_CreateHIDReport() callback
+					                                 *   when a report has been marked as changed or the idle period has elapsed, and
+					                                 *   \ref PrevReportINBuffer is used as the report creation buffer rather than for
+					                                 *   comparison purposes. This makes polls with no changed reports nearly free, and
+					                                 *   allows for the correct handling of multiple report IDs. A \ref PrevReportINBuffer
+					                                 *   must be given when this is set, as no reports are sent when it is NULL.
+					                                 */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */										 
@@ -117,6 +161,9 @@
 					uint16_t IdleCount; /**< Report idle period, in milliseconds, set by the host */
 					uint16_t IdleMSRemaining; /**< Total number of milliseconds remaining before the idle period elapsed - this 
 											   *   should be decremented by the user application if non-zero each millisecond */	
+					uint8_t  PendingReportIDs[HID_DEVICE_REPORT_QUEUE_SIZE]; /**< Queue of report IDs marked as changed by the user
+					                                                           *   application which are awaiting transmission */
+					uint8_t  TotalPendingReports; /**< Number of report IDs currently stored in the \ref PendingReportIDs queue */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -152,9 +199,11 @@
 			 *  user is responsible for the creation of the next HID input report to be sent to the host.
 			 *
 			 *  \param[in,out] HIDInterfaceInfo  Pointer to a structure containing a HID Class configuration and state
-			 *  \param[in,out] ReportID  If preset to a non-zero value, this is the report ID being requested by the host. If zero, this should
-			 *                 be set to the report ID of the generated HID input report (if any). If multiple reports are not sent via the
-			 *                 given HID interface, this parameter should be ignored.
+			 *  \param[in,out] ReportID  If preset to a non-zero value, this is the report ID being requested by the host, or when the
+			 *                 ReportINChangesMarked element of the interface's configuration is set, the report ID which was marked as
+			 *                 changed via \ref HID_Device_MarkReportChanged(). If zero, this should be set to the report ID of the generated
+			 *                 HID input report (if any). If multiple reports are not sent via the given HID interface, this parameter
+			 *                 should be ignored.
 			 *  \param[in] ReportType  Type of HID report to generate, either \ref REPORT_ITEM_TYPE_In or \ref REPORT_ITEM_TYPE_Feature
 			 *  \param[out] ReportData  Pointer to a buffer where the generated HID report should be stored
 			 *  \param[out] ReportSize  Number of bytes in the generated input report, or zero if no report is to be sent
@@ -180,6 +229,22 @@
 			                                          const void* ReportData, const uint16_t ReportSize) ATTR_NON_NULL_PTR_ARG(1)
 			                                          ATTR_NON_NULL_PTR_ARG(3);
 
+			/** Marks the input report with the given report ID as changed, so that it will be created via the
+			 *  \ref CALLBACK_HID_Device_CreateHIDReport() callback and sent to the host on a subsequent call to
+			 *  \ref HID_Device_USBTask(). Reports are sent in the order they were marked, and marking a report which is already
+			 *  awaiting transmission has no effect, as the report's contents are only created once the IN endpoint is ready.
+			 *
+			 *  \note This function is only used when the ReportINChangesMarked element of the HID interface's configuration
+			 *        is set.
+			 *
+			 *  \param[in,out] HIDInterfaceInfo  Pointer to a structure containing a HID Class configuration and state
+			 *  \param[in] ReportID  Report ID of the changed input report, or zero if report IDs are not used by the interface
+			 *
+			 *  \return Boolean true if the report was queued for transmission, false if the report queue is full
+			 */
+			bool HID_Device_MarkReportChanged(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo, const uint8_t ReportID)
+			                                  ATTR_NON_NULL_PTR_ARG(1);
+
 		/* Inline Functions: */
 			/** Indicates that a millisecond of idle time has elapsed on the given HID interface, and the interface's idle count should be
 			 *  decremented. This should be called once per millisecond so that hardware key-repeats function correctly. It is recommended
@@ -195,6 +260,16 @@
 				  HIDInterfaceInfo->State.IdleMSRemaining--;
 			}
 			
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_HID_CLASS_DEVICE_C)
+				static void HID_Device_ReceiveOUTReports(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static void HID_Device_SendMarkedReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+			#endif
+
+	#endif
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
@@ -0,0 +1,662 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Host test for the CDC device class driver multiplexer, \ref CDC_Device_MuxTask(). The driver is built for the host
+ *  machine against simulated device endpoints (see CDCDeviceShim.h), with three CDC interfaces attached to the one
+ *  multiplexer. Each scenario runs the multiplexer for a fixed number of passes, with the application of every port
+ *  supplying data through \ref CALLBACK_CDC_Device_MuxGetTxByte() and the host reading each port's IN endpoint at its
+ *  own rate, which may be zero to model a host application which has stopped reading.
+ *
+ *  The port counters are then checked against the data the host received. Ports whose host keeps up must be given
+ *  their full byte budget on every pass no matter how the other ports behave, and host limited ports the rate their
+ *  host reads at. Ports with data waiting must also take turns at being serviced first. Once the applications run out
+ *  of data, every transfer must have been ended by a short packet or a Zero Length Packet, without any spurious Zero
+ *  Length Packets. A final check re-enumerates the device while a Zero Length Packet is pending, which must not be sent
+ *  to the host after the reconnection. Build and run with "make mux" in this directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define  __INCLUDE_FROM_CDC_DRIVER
+#include "../CDC.h"
+
+/** Number of CDC interfaces attached to the multiplexer. */
+#define TOTAL_PORTS            3
+
+/** Number of multiplexer passes each scenario is run for. */
+#define SCENARIO_PASSES        20000
+
+/** Number of multiplexer passes allowed for the ports to finish their transfers once their data runs out. */
+#define DRAIN_PASSES           16
+
+/** Number of endpoints modelled by the simulated device. */
+#define TOTAL_ENDPOINTS        (1 + (TOTAL_PORTS * 3))
+
+/** Largest endpoint bank size modelled by the simulated device. */
+#define MAX_BANK_SIZE          64
+
+/** Value of the port data limit for an application which never runs out of data. */
+#define UNLIMITED_DATA         0xFFFFFFFF
+
+/** Endpoint numbers of the given port's CDC interface. */
+#define PORT_TX_EPNUM(Port)           (1 + ((Port) * 3))
+#define PORT_RX_EPNUM(Port)           (2 + ((Port) * 3))
+#define PORT_NOTIFICATION_EPNUM(Port) (3 + ((Port) * 3))
+
+/** Configuration of the CDC interface of the given port, with the given data endpoint size and banking. */
+#define CDC_INTERFACE(Port, Size, DoubleBank)                                 \
+	{                                                                         \
+		.Config =                                                             \
+			{                                                                 \
+				.ControlInterfaceNumber     = ((Port) * 2),                   \
+				.DataINEndpointNumber       = PORT_TX_EPNUM(Port),            \
+				.DataINEndpointSize         = (Size),                         \
+				.DataINEndpointDoubleBank   = (DoubleBank),                   \
+				.DataOUTEndpointNumber      = PORT_RX_EPNUM(Port),            \
+				.DataOUTEndpointSize        = (Size),                         \
+				.DataOUTEndpointDoubleBank  = (DoubleBank),                   \
+				.NotificationEndpointNumber = PORT_NOTIFICATION_EPNUM(Port),  \
+				.NotificationEndpointSize   = 8,                              \
+			},                                                                \
+	}
+
+/** Type define for a simulated endpoint of the device. */
+typedef struct
+{
+	uint16_t Size; /**< Size in bytes of each bank of the endpoint */
+	uint8_t  Banks; /**< Number of banks of the endpoint */
+	uint16_t BytesInBank; /**< Number of bytes written by the application to the current bank */
+	uint8_t  BankData[MAX_BANK_SIZE]; /**< Contents of the current bank */
+	uint8_t  BanksQueued; /**< Number of banks released by the application but not yet read by the host */
+	uint16_t QueuedBytes[2]; /**< Sizes of the queued banks, oldest first */
+	uint8_t  QueuedData[2][MAX_BANK_SIZE]; /**< Contents of the queued banks, oldest first */
+} SimEndpoint_t;
+
+/** Type define for the application and host ends of a multiplexed port. */
+typedef struct
+{
+	uint32_t DataLimit; /**< Total number of bytes the application has to send, or \ref UNLIMITED_DATA */
+	uint32_t BytesGenerated; /**< Number of bytes given to the multiplexer by the application */
+	uint32_t BytesReceived; /**< Number of bytes read by the host */
+	uint32_t Packets; /**< Number of packets read by the host, including Zero Length Packets */
+	uint32_t ZLPs; /**< Number of Zero Length Packets read by the host */
+	bool     TransferOpen; /**< Indicates if the last packet read by the host was full, so the transfer continues */
+	uint32_t Errors; /**< Number of data mismatches, spurious Zero Length Packets and unterminated transfers */
+} SimPort_t;
+
+/** Type define for a test scenario. */
+typedef struct
+{
+	const char* Name; /**< Name of the scenario */
+	bool        LargeBanks; /**< Indicates if the interfaces use 64 byte double banked data endpoints */
+	uint16_t    PortByteBudget; /**< Byte budget of each port on each multiplexer pass */
+	uint8_t     ReadInterval[TOTAL_PORTS]; /**< Passes between the host's packet reads of each port, or zero for none */
+	uint32_t    DataLimit[TOTAL_PORTS]; /**< Total bytes the application of each port has to send */
+} Scenario_t;
+
+USB_Request_Header_t USB_ControlRequest;
+volatile uint8_t     USB_DeviceState;
+
+/** CDC interfaces of the device with 16 byte single banked data endpoints, as in the DualVirtualSerial demo. */
+static USB_ClassInfo_CDC_Device_t SmallBankInterfaces[TOTAL_PORTS] =
+	{
+		CDC_INTERFACE(0, 16, false),
+		CDC_INTERFACE(1, 16, false),
+		CDC_INTERFACE(2, 16, false),
+	};
+
+/** CDC interfaces of the device with 64 byte double banked data endpoints. */
+static USB_ClassInfo_CDC_Device_t LargeBankInterfaces[TOTAL_PORTS] =
+	{
+		CDC_INTERFACE(0, 64, true),
+		CDC_INTERFACE(1, 64, true),
+		CDC_INTERFACE(2, 64, true),
+	};
+
+/** Simulated endpoints of the device. */
+static SimEndpoint_t Endpoints[TOTAL_ENDPOINTS];
+
+/** Currently selected simulated endpoint. */
+static SimEndpoint_t* SelectedEndpoint = &Endpoints[0];
+
+/** Application and host ends of each multiplexed port. */
+static SimPort_t Ports[TOTAL_PORTS];
+
+/** Number of endpoint accesses which would fail on the real USB controller. */
+static uint32_t ProtocolErrors;
+
+/** Number of the current multiplexer pass, and of the pass in which the application was last asked for data. */
+static uint32_t CurrentPass, LastCallbackPass;
+
+/** Number of passes in which each port was the first to be asked for data. */
+static uint32_t FirstServed[TOTAL_PORTS];
+
+/** Test scenarios, run in order. */
+static const Scenario_t Scenarios[] =
+	{
+		{"Equal hosts",        false, 16, {1, 1, 1}, {UNLIMITED_DATA, UNLIMITED_DATA, UNLIMITED_DATA}},
+		{"Equal hosts, 64B",   true,  64, {1, 1, 1}, {UNLIMITED_DATA, UNLIMITED_DATA, UNLIMITED_DATA}},
+		{"Small budget",       false,  8, {1, 1, 1}, {UNLIMITED_DATA, UNLIMITED_DATA, UNLIMITED_DATA}},
+		{"Port 0 stalled",     false, 16, {0, 1, 1}, {UNLIMITED_DATA, UNLIMITED_DATA, UNLIMITED_DATA}},
+		{"Port 0 slow",        false, 16, {4, 1, 1}, {UNLIMITED_DATA, UNLIMITED_DATA, UNLIMITED_DATA}},
+		{"Port 1 slow, 64B",   true,  64, {1, 3, 1}, {UNLIMITED_DATA, UNLIMITED_DATA, UNLIMITED_DATA}},
+		{"Bank sized data",    false, 16, {1, 1, 2}, {16 * 40,        16 * 7,         16}},
+		{"Odd sized data",     true,  48, {1, 2, 1}, {64 * 9 + 1,     63,             1000}},
+	};
+
+/** Returns the data byte at the given offset of a port's data stream.
+ *
+ *  \param[in] PortIndex  Index of the port within the multiplexer
+ *  \param[in] Offset     Offset of the byte within the port's data stream
+ *
+ *  \return Data byte at the given offset
+ */
+static uint8_t PortDataByte(const uint8_t PortIndex, const uint32_t Offset)
+{
+	return (uint8_t)((Offset * 7) + (Offset >> 8) + (PortIndex * 61));
+}
+
+void USB_USBTask(void)
+{
+
+}
+
+bool Endpoint_ConfigureEndpoint(const uint8_t Number, const uint8_t Type, const uint8_t Direction,
+                                const uint16_t Size, const uint8_t Banks)
+{
+	SimEndpoint_t* Endpoint = &Endpoints[Number];
+
+	memset(Endpoint, 0x00, sizeof(SimEndpoint_t));
+	Endpoint->Size  = Size;
+	Endpoint->Banks = ((Banks & ENDPOINT_BANK_DOUBLE) ? 2 : 1);
+
+	return ((Number < TOTAL_ENDPOINTS) && (Size <= MAX_BANK_SIZE));
+}
+
+void Endpoint_SelectEndpoint(const uint8_t EndpointNumber)
+{
+	if (EndpointNumber >= TOTAL_ENDPOINTS)
+	{
+		ProtocolErrors++;
+		return;
+	}
+
+	SelectedEndpoint = &Endpoints[EndpointNumber];
+}
+
+bool Endpoint_IsSETUPReceived(void)
+{
+	return false;
+}
+
+void Endpoint_ClearSETUP(void)
+{
+
+}
+
+void Endpoint_ClearStatusStage(void)
+{
+
+}
+
+uint16_t Endpoint_Write_Control_Stream_LE(const void* Buffer, uint16_t Length)
+{
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint16_t Endpoint_Read_Control_Stream_LE(void* Buffer, uint16_t Length)
+{
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+bool Endpoint_IsReadWriteAllowed(void)
+{
+	return ((SelectedEndpoint->BanksQueued < SelectedEndpoint->Banks) &&
+	        (SelectedEndpoint->BytesInBank < SelectedEndpoint->Size));
+}
+
+bool Endpoint_IsOUTReceived(void)
+{
+	return false;
+}
+
+uint16_t Endpoint_BytesInEndpoint(void)
+{
+	return SelectedEndpoint->BytesInBank;
+}
+
+void Endpoint_ClearIN(void)
+{
+	SimEndpoint_t* Endpoint = SelectedEndpoint;
+
+	if (Endpoint->BanksQueued == Endpoint->Banks)
+	{
+		ProtocolErrors++;
+		return;
+	}
+
+	Endpoint->QueuedBytes[Endpoint->BanksQueued] = Endpoint->BytesInBank;
+	memcpy(Endpoint->QueuedData[Endpoint->BanksQueued], Endpoint->BankData, Endpoint->BytesInBank);
+	Endpoint->BanksQueued++;
+	Endpoint->BytesInBank = 0;
+}
+
+void Endpoint_ClearOUT(void)
+{
+	ProtocolErrors++;
+}
+
+uint8_t Endpoint_WaitUntilReady(void)
+{
+	return (Endpoint_IsReadWriteAllowed() ? ENDPOINT_READYWAIT_NoError : ENDPOINT_READYWAIT_Timeout);
+}
+
+uint8_t Endpoint_Read_Byte(void)
+{
+	ProtocolErrors++;
+	return 0;
+}
+
+void Endpoint_Write_Byte(const uint8_t Byte)
+{
+	if (!(Endpoint_IsReadWriteAllowed()))
+	{
+		ProtocolErrors++;
+		return;
+	}
+
+	SelectedEndpoint->BankData[SelectedEndpoint->BytesInBank++] = Byte;
+}
+
+uint8_t Endpoint_Write_Stream_LE(const void* Buffer, uint16_t Length, void* Callback)
+{
+	const uint8_t* Data = Buffer;
+
+	while (Length--)
+	  Endpoint_Write_Byte(*(Data++));
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+/** Supplies the next byte of a port's data stream to the multiplexer, until the port's data limit is reached. The
+ *  port's OUT endpoint is selected before returning, as an application echoing received data would, to check that the
+ *  multiplexer reselects the IN endpoint afterwards.
+ *
+ *  \param[in,out] MuxInfo  Pointer to the multiplexer being serviced
+ *  \param[in] PortIndex  Index of the port being serviced within the multiplexer
+ *  \param[out] Data  Pointer to a location where the next byte to send should be stored
+ *
+ *  \return Boolean true if a byte was stored to Data, false if the port has no data waiting to be sent
+ */
+bool CALLBACK_CDC_Device_MuxGetTxByte(CDC_Device_Mux_t* const MuxInfo, const uint8_t PortIndex, uint8_t* const Data)
+{
+	SimPort_t* Port = &Ports[PortIndex];
+
+	if (LastCallbackPass != CurrentPass)
+	{
+		LastCallbackPass = CurrentPass;
+		FirstServed[PortIndex]++;
+	}
+
+	Endpoint_SelectEndpoint(PORT_RX_EPNUM(PortIndex));
+
+	if (Port->BytesGenerated == Port->DataLimit)
+	  return false;
+
+	*Data = PortDataByte(PortIndex, Port->BytesGenerated++);
+	return true;
+}
+
+/** Reads the oldest released bank of a port's IN endpoint as the host would, checking its contents and the
+ *  termination of the port's transfers.
+ *
+ *  \param[in] PortIndex  Index of the port within the multiplexer
+ */
+static void HostReadPacket(const uint8_t PortIndex)
+{
+	SimEndpoint_t* Endpoint = &Endpoints[PORT_TX_EPNUM(PortIndex)];
+	SimPort_t*     Port     = &Ports[PortIndex];
+
+	if (!(Endpoint->BanksQueued))
+	  return;
+
+	uint16_t Bytes = Endpoint->QueuedBytes[0];
+
+	for (uint16_t Offset = 0; Offset < Bytes; Offset++)
+	{
+		if (Endpoint->QueuedData[0][Offset] != PortDataByte(PortIndex, Port->BytesReceived + Offset))
+		{
+			printf("  Port %u: data mismatch at offset %lu\n", PortIndex,
+			       (unsigned long)(Port->BytesReceived + Offset));
+			Port->Errors++;
+			break;
+		}
+	}
+
+	if (!(Bytes) && !(Port->TransferOpen))
+	{
+		printf("  Port %u: spurious Zero Length Packet after %lu bytes\n", PortIndex, (unsigned long)Port->BytesReceived);
+		Port->Errors++;
+	}
+
+	Port->BytesReceived += Bytes;
+	Port->Packets++;
+	Port->ZLPs        += !(Bytes);
+	Port->TransferOpen = (Bytes == Endpoint->Size);
+
+	Endpoint->BanksQueued--;
+	Endpoint->QueuedBytes[0] = Endpoint->QueuedBytes[1];
+	memcpy(Endpoint->QueuedData[0], Endpoint->QueuedData[1], MAX_BANK_SIZE);
+}
+
+/** Enumerates the simulated device, configuring the endpoints of each CDC interface and setting each interface's line
+ *  encoding as the host does when it opens the virtual serial port.
+ *
+ *  \param[in,out] Interfaces  CDC interfaces of the device
+ *
+ *  \return Number of errors encountered while enumerating
+ */
+static uint32_t EnumerateDevice(USB_ClassInfo_CDC_Device_t* const Interfaces)
+{
+	USB_DeviceState = DEVICE_STATE_Configured;
+
+	for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+	{
+		if (!(CDC_Device_ConfigureEndpoints(&Interfaces[PortIndex])))
+		{
+			printf("  Port %u: endpoint configuration failed\n", PortIndex);
+			return 1;
+		}
+
+		Interfaces[PortIndex].State.LineEncoding.BaudRateBPS = 115200;
+		Interfaces[PortIndex].State.LineEncoding.DataBits    = 8;
+	}
+
+	return 0;
+}
+
+/** Checks the counters of a port against the data received by the host and still held by the port's IN endpoint.
+ *
+ *  \param[in] PortIndex  Index of the port within the multiplexer
+ *  \param[in] MuxPort    Multiplexer record of the port
+ *
+ *  \return Number of counter mismatches, zero if the counters are consistent or one otherwise
+ */
+static uint32_t CheckPortCounters(const uint8_t PortIndex, const CDC_Device_MuxPort_t* const MuxPort)
+{
+	SimEndpoint_t* Endpoint    = &Endpoints[PORT_TX_EPNUM(PortIndex)];
+	SimPort_t*     Port        = &Ports[PortIndex];
+	uint32_t       BytesQueued = Endpoint->BytesInBank;
+
+	for (uint8_t Bank = 0; Bank < Endpoint->BanksQueued; Bank++)
+	  BytesQueued += Endpoint->QueuedBytes[Bank];
+
+	if ((MuxPort->BytesSent != (Port->BytesReceived + BytesQueued)) || (MuxPort->BytesSent != Port->BytesGenerated) ||
+	    (MuxPort->BanksSent != (Port->Packets + Endpoint->BanksQueued)))
+	{
+		printf("  Port %u: counters of %lu bytes, %lu banks do not match %lu bytes, %lu packets seen by the host\n",
+		       PortIndex, (unsigned long)MuxPort->BytesSent, (unsigned long)MuxPort->BanksSent,
+		       (unsigned long)(Port->BytesReceived + BytesQueued), (unsigned long)(Port->Packets + Endpoint->BanksQueued));
+		return 1;
+	}
+
+	return 0;
+}
+
+/** Runs the multiplexer with the host reading each port at the scenario's rates, and checks that each port was given
+ *  the throughput it was due. A port whose host keeps up must send its full byte budget on each pass, and a port whose
+ *  host reads one packet every few passes must send a packet every time the host reads one, regardless of the other
+ *  ports. The applications' data then runs out, and each port must end its transfers correctly.
+ *
+ *  \param[in] Scenario  Scenario to run
+ *
+ *  \return Number of errors encountered in the scenario
+ */
+static uint32_t RunScenario(const Scenario_t* const Scenario)
+{
+	USB_ClassInfo_CDC_Device_t* Interfaces = (Scenario->LargeBanks ? LargeBankInterfaces : SmallBankInterfaces);
+	CDC_Device_MuxPort_t        MuxPorts[TOTAL_PORTS];
+	uint32_t                    Errors = 0;
+
+	CDC_Device_Mux_t Mux =
+		{
+			.Config =
+				{
+					.Ports          = MuxPorts,
+					.TotalPorts     = TOTAL_PORTS,
+					.PortByteBudget = Scenario->PortByteBudget,
+				},
+		};
+
+	memset(MuxPorts, 0x00, sizeof(MuxPorts));
+	memset(Ports, 0x00, sizeof(Ports));
+	memset(FirstServed, 0x00, sizeof(FirstServed));
+	ProtocolErrors   = 0;
+	LastCallbackPass = 0;
+
+	Errors += EnumerateDevice(Interfaces);
+
+	for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+	{
+		MuxPorts[PortIndex].CDCInterfaceInfo = &Interfaces[PortIndex];
+		Ports[PortIndex].DataLimit           = Scenario->DataLimit[PortIndex];
+	}
+
+	for (CurrentPass = 1; CurrentPass <= SCENARIO_PASSES; CurrentPass++)
+	{
+		CDC_Device_MuxTask(&Mux);
+
+		for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+		{
+			if (Scenario->ReadInterval[PortIndex] && !(CurrentPass % Scenario->ReadInterval[PortIndex]))
+			  HostReadPacket(PortIndex);
+		}
+	}
+
+	for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+	{
+		CDC_Device_MuxPort_t* MuxPort    = &MuxPorts[PortIndex];
+		uint16_t              BankSize   = Interfaces[PortIndex].Config.DataINEndpointSize;
+		uint8_t               Banks      = (Interfaces[PortIndex].Config.DataINEndpointDoubleBank ? 2 : 1);
+		uint8_t               Interval   = Scenario->ReadInterval[PortIndex];
+		uint32_t              Expected;
+		uint32_t              Tolerance  = (BankSize * Banks);
+
+		if (Scenario->DataLimit[PortIndex] != UNLIMITED_DATA)
+		  Expected = Scenario->DataLimit[PortIndex];
+		else if (!(Interval))
+		  Expected = Tolerance;
+		else if ((BankSize / Interval) >= Scenario->PortByteBudget)
+		  Expected = (SCENARIO_PASSES * Scenario->PortByteBudget);
+		else
+		  Expected = ((SCENARIO_PASSES / Interval) * BankSize);
+
+		printf("  %-18s %4u %10lu %8lu %9lu %10.2f %10.2f\n", (PortIndex ? "" : Scenario->Name), PortIndex,
+		       (unsigned long)MuxPort->BytesSent, (unsigned long)MuxPort->BanksSent,
+		       (unsigned long)MuxPort->BankDeferrals, ((double)MuxPort->BytesSent / SCENARIO_PASSES),
+		       (MuxPort->BanksSent ? ((double)MuxPort->BytesSent / MuxPort->BanksSent) : 0));
+
+		if ((MuxPort->BytesSent > (Expected + Tolerance)) || ((MuxPort->BytesSent + Tolerance) < Expected))
+		{
+			printf("  Port %u: sent %lu bytes, expected %lu\n", PortIndex, (unsigned long)MuxPort->BytesSent,
+			       (unsigned long)Expected);
+			Errors++;
+		}
+
+		if (!(Interval) && (MuxPort->BankDeferrals < (SCENARIO_PASSES - 1)))
+		{
+			printf("  Port %u: deferred %lu times while its host was stalled\n", PortIndex,
+			       (unsigned long)MuxPort->BankDeferrals);
+			Errors++;
+		}
+
+		Errors += CheckPortCounters(PortIndex, MuxPort);
+
+		/* Ports which always have data and room to send it must take turns at being serviced first on each pass */
+		if ((Scenario->DataLimit[PortIndex] == UNLIMITED_DATA) && (Interval == 1) &&
+		    ((FirstServed[PortIndex] + 1) < (SCENARIO_PASSES / TOTAL_PORTS)))
+		{
+			printf("  Port %u: serviced first in only %lu passes\n", PortIndex, (unsigned long)FirstServed[PortIndex]);
+			Errors++;
+		}
+
+		/* End the application data, and let the host read everything the port has left */
+		Ports[PortIndex].DataLimit = Ports[PortIndex].BytesGenerated;
+	}
+
+	for (uint8_t Pass = 0; Pass < DRAIN_PASSES; Pass++)
+	{
+		CDC_Device_MuxTask(&Mux);
+
+		for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+		{
+			while (Endpoints[PORT_TX_EPNUM(PortIndex)].BanksQueued)
+			  HostReadPacket(PortIndex);
+		}
+	}
+
+	for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+	{
+		SimPort_t* Port = &Ports[PortIndex];
+
+		if (Port->TransferOpen || (Port->BytesReceived != Port->BytesGenerated))
+		{
+			printf("  Port %u: transfer left unterminated, host received %lu of %lu bytes\n", PortIndex,
+			       (unsigned long)Port->BytesReceived, (unsigned long)Port->BytesGenerated);
+			Errors++;
+		}
+
+		Errors += CheckPortCounters(PortIndex, &MuxPorts[PortIndex]);
+		Errors += Port->Errors;
+	}
+
+	return (Errors + ProtocolErrors);
+}
+
+/** Re-enumerates the device while a port has a Zero Length Packet pending, after it released a full bank which the
+ *  host never read. The pending packet belongs to a transfer the reconnected host knows nothing about, and so must
+ *  not be sent once the device is enumerated again.
+ *
+ *  \return Number of errors encountered in the test
+ */
+static uint32_t TestReconnect(void)
+{
+	CDC_Device_MuxPort_t MuxPorts[TOTAL_PORTS];
+	uint32_t             Errors = 0;
+
+	CDC_Device_Mux_t Mux =
+		{
+			.Config =
+				{
+					.Ports          = MuxPorts,
+					.TotalPorts     = TOTAL_PORTS,
+					.PortByteBudget = 64,
+				},
+		};
+
+	memset(MuxPorts, 0x00, sizeof(MuxPorts));
+	memset(Ports, 0x00, sizeof(Ports));
+	ProtocolErrors = 0;
+
+	Errors += EnumerateDevice(SmallBankInterfaces);
+
+	for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+	{
+		MuxPorts[PortIndex].CDCInterfaceInfo = &SmallBankInterfaces[PortIndex];
+		Ports[PortIndex].DataLimit           = SmallBankInterfaces[PortIndex].Config.DataINEndpointSize;
+	}
+
+	CDC_Device_MuxTask(&Mux);
+
+	for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+	{
+		if (!(SmallBankInterfaces[PortIndex].State.MuxZLPPending))
+		{
+			printf("  Port %u: no Zero Length Packet pending after a full bank\n", PortIndex);
+			Errors++;
+		}
+	}
+
+	/* Reconnect, discarding the unread banks, and have the host read everything sent afterwards */
+	USB_DeviceState = DEVICE_STATE_Unattached;
+	memset(Ports, 0x00, sizeof(Ports));
+	Errors += EnumerateDevice(SmallBankInterfaces);
+
+	for (uint8_t Pass = 0; Pass < DRAIN_PASSES; Pass++)
+	{
+		CDC_Device_MuxTask(&Mux);
+
+		for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+		  HostReadPacket(PortIndex);
+	}
+
+	for (uint8_t PortIndex = 0; PortIndex < TOTAL_PORTS; PortIndex++)
+	{
+		if (Ports[PortIndex].Packets)
+		{
+			printf("  Port %u: %lu packets sent after reconnection with no data\n", PortIndex,
+			       (unsigned long)Ports[PortIndex].Packets);
+			Errors++;
+		}
+	}
+
+	printf("  %-18s %s\n", "Reconnection", (Errors ? "FAILED" : "OK"));
+
+	return (Errors + ProtocolErrors);
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	printf("CDC device multiplexer test, %d ports, %d passes per scenario\n\n", TOTAL_PORTS, SCENARIO_PASSES);
+	printf("  %-18s %4s %10s %8s %9s %10s %10s\n", "Scenario", "Port", "Bytes", "Banks", "Deferrals", "Bytes/pass",
+	       "Bytes/bank");
+
+	for (uint8_t Index = 0; Index < (sizeof(Scenarios) / sizeof(Scenarios[0])); Index++)
+	  TotalErrors += RunScenario(&Scenarios[Index]);
+
+	TotalErrors += TestReconnect();
+
+	printf("\nDeferrals counts the passes in which a port was skipped as its IN endpoint banks were all waiting for\n");
+	printf("the host. A port whose host keeps up is given its full byte budget on every pass, whatever the other\n");
+	printf("ports do.\n");
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
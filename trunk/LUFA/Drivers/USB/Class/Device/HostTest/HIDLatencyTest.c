@@ -0,0 +1,771 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Host benchmark of the scan to IN token latency of the ClassDriver Keyboard and KeyboardMouse demos. The demo's own
+ *  source file and the HID device class driver are built for the host machine against a simulated device (see
+ *  HIDDeviceShim.h and the stand-in board drivers in HostStubs/), and the demo's main loop is run unmodified, with each
+ *  call to \ref USB_USBTask() advancing the simulated time by one main loop pass. The simulated host enumerates the
+ *  device, disables the keyboard's idle reports and optionally selects the Boot protocol, then sends a Start Of Frame
+ *  every millisecond and polls each interrupt IN endpoint at its polling interval.
+ *
+ *  The simulated joystick and button inputs change at pseudo-random times, and each report read by the host is matched
+ *  to the key scan it was created from. Each report must hold the key states of the latest scan at the time its bank
+ *  was released, and no key state may be reported twice. The time from each change being seen by \c ScanKeys() to
+ *  the IN token that reads it is then measured, along with the time from the input change itself. Two workloads are
+ *  run for each protocol and main loop period:
+ *
+ *   - Isolated: key changes are separated by more than one polling interval, as from a debounced key matrix. Every
+ *     change must reach the host on the first IN token after its scan, so that the scan to IN token latency is bounded
+ *     by one polling interval (one frame for the 1ms NKRO endpoint).
+ *   - Burst: key changes arrive up to once per main loop pass. A change scanned while the previous report is still
+ *     waiting in the endpoint bank must wait for the following IN token, so the latency is bounded by two polling
+ *     intervals, and intermediate key states may be superseded.
+ *
+ *  The makefile builds one binary for each demo with and without the KEYBOARD_NKRO option; build and run them all with
+ *  "make latency" in this directory. Each binary exits with a non-zero status if any check fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include <LUFA/Drivers/USB/Class/HID.h>
+#include <LUFA/Drivers/Board/Joystick.h>
+#include <LUFA/Drivers/Board/Buttons.h>
+#include <LUFA/Drivers/Board/LEDs.h>
+
+#include "Descriptors.h"
+
+/** Number of pseudo-random key changes made in each scenario. */
+#define SCENARIO_KEY_CHANGES          4000
+
+/** Number of endpoints modelled by the simulated device. */
+#define TOTAL_ENDPOINTS               8
+
+/** Largest endpoint bank size modelled by the simulated device. */
+#define MAX_BANK_SIZE                 64
+
+/** Time between Start Of Frame packets from the host, in microseconds. */
+#define FRAME_PERIOD_US               1000
+
+/** Polling interval in frames used by the simulated host for the IN endpoints other than the keyboard's. */
+#define OTHER_EP_POLLINGINTERVAL      10
+
+/** Polling interval of the keyboard IN endpoint, in microseconds. */
+#define KEYBOARD_POLL_PERIOD_US       ((uint32_t)KEYBOARD_POLLINGINTERVAL * FRAME_PERIOD_US)
+
+/** Number of the simulated keyboard keys, mapped to the key codes from 0x04 (A) upwards by the demos. */
+#define TOTAL_KEYS                    6
+
+/** Key code of the first simulated key. */
+#define FIRST_KEY_CODE                0x04
+
+/** Type define for a simulated endpoint of the device. */
+typedef struct
+{
+	bool     Configured; /**< Indicates if the endpoint has been configured by the device */
+	uint8_t  Direction; /**< Direction of the endpoint, a ENDPOINT_DIR_* mask */
+	uint16_t Size; /**< Size in bytes of each bank of the endpoint */
+	uint8_t  Banks; /**< Number of banks of the endpoint */
+	uint16_t BytesInBank; /**< Number of bytes written by the application to the current bank */
+	uint8_t  BankData[MAX_BANK_SIZE]; /**< Contents of the current bank */
+	uint8_t  BanksQueued; /**< Number of banks released by the application but not yet read by the host */
+	uint16_t QueuedBytes[2]; /**< Sizes of the queued banks, oldest first */
+	uint8_t  QueuedData[2][MAX_BANK_SIZE]; /**< Contents of the queued banks, oldest first */
+	uint32_t QueuedScan[2]; /**< Index of the latest key scan at the time each queued bank was released */
+} SimEndpoint_t;
+
+/** Type define for a key state of the simulated keyboard, set by one input change. */
+typedef struct
+{
+	uint8_t  KeyMask; /**< Mask of the pressed keys, with bit n set for the key code \ref FIRST_KEY_CODE + n */
+	uint64_t ChangeTimeUS; /**< Time of the input change which set the key state */
+	uint64_t ScanTimeUS; /**< Time of the key scan which first saw the key state */
+} SimKeyState_t;
+
+/** Type define for a test scenario. */
+typedef struct
+{
+	const char* Name; /**< Name of the scenario */
+	bool        BootProtocol; /**< Indicates if the host selects the Boot protocol for the keyboard interface */
+	bool        Burst; /**< Indicates if key changes may arrive while a report is still waiting for an IN token */
+	uint16_t    LoopPeriodUS; /**< Duration of each pass of the demo's main loop, in microseconds */
+} Scenario_t;
+
+/** Type define for the results of a test scenario. */
+typedef struct
+{
+	uint32_t Reports; /**< Number of keyboard reports read by the host */
+	uint32_t Superseded; /**< Number of key states replaced before being sent to the host */
+	uint64_t ScanToINMinUS; /**< Shortest scan to IN token latency, in microseconds */
+	uint64_t ScanToINTotalUS; /**< Sum of the scan to IN token latencies of all reports, in microseconds */
+	uint64_t ScanToINMaxUS; /**< Longest scan to IN token latency, in microseconds */
+	uint64_t KeyToINMaxUS; /**< Longest input change to IN token latency, in microseconds */
+	uint32_t Errors; /**< Number of failed checks */
+} Results_t;
+
+USB_Request_Header_t USB_ControlRequest;
+volatile uint8_t     USB_DeviceState;
+uint8_t              MCUSR;
+
+extern USB_ClassInfo_HID_Device_t Keyboard_HID_Interface;
+
+int Demo_main(void);
+
+/** Test scenarios, run in order. */
+static const Scenario_t Scenarios[] =
+	{
+		{"Report, isolated",  false, false,  25},
+		{"Report, isolated",  false, false, 250},
+		{"Report, burst",     false, true,   25},
+		{"Report, burst",     false, true,  250},
+		{"Boot, isolated",    true,  false,  25},
+		{"Boot, isolated",    true,  false, 250},
+		{"Boot, burst",       true,  true,   25},
+		{"Boot, burst",       true,  true,  250},
+	};
+
+/** Scenario currently being run. */
+static const Scenario_t* CurrentScenario;
+
+/** Results of the scenario currently being run. */
+static Results_t Results;
+
+/** Jump buffer used to leave the demo's main loop once the current scenario is complete. */
+static jmp_buf ScenarioComplete;
+
+/** Simulated endpoints of the device. */
+static SimEndpoint_t Endpoints[TOTAL_ENDPOINTS];
+
+/** Currently selected simulated endpoint. */
+static SimEndpoint_t* SelectedEndpoint = &Endpoints[0];
+
+/** Indicates if a control request from the simulated host is waiting to be handled by the device. */
+static bool SETUPPending;
+
+/** Indicates if the device has enabled its Start Of Frame events. */
+static bool SOFEventsEnabled;
+
+/** Current simulated time, and the time of the next Start Of Frame, in microseconds. */
+static uint64_t SimTimeUS, NextFrameUS;
+
+/** Current USB frame number. */
+static uint32_t FrameNumber;
+
+/** Current state of the simulated joystick and buttons. */
+static uint8_t JoystickState, ButtonsState;
+
+/** Key states of the simulated keyboard, in order. Entry zero is the initial state with no keys pressed. */
+static SimKeyState_t KeyStates[SCENARIO_KEY_CHANGES + 2];
+
+/** Number of entries in \ref KeyStates, and the time of the next input change. */
+static uint32_t TotalKeyStates;
+static uint64_t NextChangeUS;
+
+/** Index of the key state of the latest key scan, and of the last key state read by the host. */
+static uint32_t LatestScan, LastReported;
+
+/** State of the pseudo-random number generator. */
+static uint32_t RandomState;
+
+/** Returns a pseudo-random number in the given range.
+ *
+ *  \param[in] Range  Number of values in the range, starting from zero
+ *
+ *  \return Pseudo-random number from zero to Range - 1
+ */
+static uint32_t RandomNumber(const uint32_t Range)
+{
+	RandomState = (RandomState * 1103515245UL) + 12345;
+
+	return ((RandomState >> 8) % Range);
+}
+
+/** Returns the mask of the keys the demo presses for the given joystick and button states, from its key mapping.
+ *
+ *  \param[in] Joystick  Joystick state, a mask of JOY_* values
+ *  \param[in] Buttons   Buttons state, a mask of BUTTONS_* values
+ *
+ *  \return Mask of the pressed keys, with bit n set for the key code \ref FIRST_KEY_CODE + n
+ */
+static uint8_t DemoKeyMask(const uint8_t Joystick, const uint8_t Buttons)
+{
+	uint8_t KeyMask = 0;
+
+	#if defined(KEYBOARDMOUSE_DEMO)
+	/* The KeyboardMouse demo only presses keys while the first button is held, and otherwise moves the mouse */
+	if (!(Buttons & BUTTONS_BUTTON1))
+	  return 0;
+	#else
+	if (Buttons & BUTTONS_BUTTON1)
+	  KeyMask |= (1 << 5);
+	#endif
+
+	if (Joystick & JOY_UP)
+	  KeyMask |= (1 << 0);
+	else if (Joystick & JOY_DOWN)
+	  KeyMask |= (1 << 1);
+
+	if (Joystick & JOY_LEFT)
+	  KeyMask |= (1 << 2);
+	else if (Joystick & JOY_RIGHT)
+	  KeyMask |= (1 << 3);
+
+	if (Joystick & JOY_PRESS)
+	  KeyMask |= (1 << 4);
+
+	return KeyMask;
+}
+
+/** Decodes a keyboard report read by the host back into a mask of the simulated keys, checking its format.
+ *
+ *  \param[in] Report  Report read by the host
+ *  \param[in] Length  Length of the report in bytes
+ *
+ *  \return Mask of the pressed keys, or -1 if the report is malformed or holds unexpected keys
+ */
+static int DecodeKeyboardReport(const uint8_t* Report, const uint16_t Length)
+{
+	uint8_t KeyMask = 0;
+
+	#if defined(KEYBOARD_NKRO)
+	if (!(CurrentScenario->BootProtocol))
+	{
+		if (Length != sizeof(USB_KeyboardNKROReport_Data_t))
+		  return -1;
+
+		const USB_KeyboardNKROReport_Data_t* NKROReport = (const USB_KeyboardNKROReport_Data_t*)Report;
+
+		for (uint8_t KeyCode = 0; KeyCode < HID_KEYBOARD_NKRO_KEYCODES; KeyCode++)
+		{
+			if (!(NKROReport->KeyBitmap[KeyCode / 8] & (1 << (KeyCode % 8))))
+			  continue;
+
+			if ((KeyCode < FIRST_KEY_CODE) || (KeyCode >= (FIRST_KEY_CODE + TOTAL_KEYS)))
+			  return -1;
+
+			KeyMask |= (1 << (KeyCode - FIRST_KEY_CODE));
+		}
+
+		return KeyMask;
+	}
+	#endif
+
+	if (Length != sizeof(USB_KeyboardReport_Data_t))
+	  return -1;
+
+	const USB_KeyboardReport_Data_t* BootReport = (const USB_KeyboardReport_Data_t*)Report;
+
+	for (uint8_t KeyIndex = 0; KeyIndex < sizeof(BootReport->KeyCode); KeyIndex++)
+	{
+		uint8_t KeyCode = BootReport->KeyCode[KeyIndex];
+
+		if (!(KeyCode))
+		  continue;
+
+		if ((KeyCode < FIRST_KEY_CODE) || (KeyCode >= (FIRST_KEY_CODE + TOTAL_KEYS)))
+		  return -1;
+
+		KeyMask |= (1 << (KeyCode - FIRST_KEY_CODE));
+	}
+
+	return KeyMask;
+}
+
+/** Sends a class control request with no data stage from the simulated host to the keyboard's HID interface.
+ *
+ *  \param[in] Request  HID class request to send
+ *  \param[in] Value    Value of the request
+ */
+static void SendControlRequest(const uint8_t Request, const uint16_t Value)
+{
+	USB_ControlRequest = (USB_Request_Header_t)
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE),
+			.bRequest      = Request,
+			.wValue        = Value,
+			.wIndex        = Keyboard_HID_Interface.Config.InterfaceNumber,
+			.wLength       = 0,
+		};
+
+	SETUPPending = true;
+	EVENT_USB_Device_UnhandledControlRequest();
+
+	if (SETUPPending)
+	{
+		printf("  Control request 0x%02X was not handled by the device\n", Request);
+		Results.Errors++;
+		SETUPPending = false;
+	}
+}
+
+/** Enumerates the device as the simulated host, then sets up the keyboard interface as a host's HID driver would. */
+static void EnumerateDevice(void)
+{
+	USB_DeviceState = DEVICE_STATE_Configured;
+
+	EVENT_USB_Device_Connect();
+	EVENT_USB_Device_ConfigurationChanged();
+
+	if (!(Endpoints[Keyboard_HID_Interface.Config.ReportINEndpointNumber].Configured))
+	{
+		printf("  Keyboard IN endpoint was not configured by the device\n");
+		Results.Errors++;
+	}
+
+	/* Disable the keyboard's idle reports, so that reports are only sent when keys change */
+	SendControlRequest(REQ_SetIdle, 0);
+
+	if (CurrentScenario->BootProtocol)
+	  SendControlRequest(REQ_SetProtocol, 0);
+}
+
+/** Reads the next bank of the given keyboard IN endpoint as the simulated host, checking the report it holds and
+ *  recording its latency.
+ *
+ *  \param[in,out] Endpoint  Keyboard IN endpoint to read from
+ */
+static void ReadKeyboardReport(SimEndpoint_t* const Endpoint)
+{
+	uint32_t ScanIndex = Endpoint->QueuedScan[0];
+	int      KeyMask   = DecodeKeyboardReport(Endpoint->QueuedData[0], Endpoint->QueuedBytes[0]);
+
+	Results.Reports++;
+
+	if (KeyMask != KeyStates[ScanIndex].KeyMask)
+	{
+		printf("  Report at %lluus does not hold the key states of the latest scan\n", (unsigned long long)SimTimeUS);
+		Results.Errors++;
+	}
+
+	if (ScanIndex <= LastReported)
+	{
+		printf("  Report at %lluus repeats key states already sent\n", (unsigned long long)SimTimeUS);
+		Results.Errors++;
+		return;
+	}
+
+	uint64_t ScanToINUS = (SimTimeUS - KeyStates[ScanIndex].ScanTimeUS);
+	uint64_t KeyToINUS  = (SimTimeUS - KeyStates[ScanIndex].ChangeTimeUS);
+
+	if (ScanToINUS < Results.ScanToINMinUS)
+	  Results.ScanToINMinUS = ScanToINUS;
+
+	if (ScanToINUS > Results.ScanToINMaxUS)
+	  Results.ScanToINMaxUS = ScanToINUS;
+
+	if (KeyToINUS > Results.KeyToINMaxUS)
+	  Results.KeyToINMaxUS = KeyToINUS;
+
+	Results.ScanToINTotalUS += ScanToINUS;
+	Results.Superseded      += (ScanIndex - LastReported - 1);
+
+	LastReported = ScanIndex;
+}
+
+/** Starts a new USB frame as the simulated host, sending a Start Of Frame and polling the IN endpoints due in the frame.
+ */
+static void StartFrame(void)
+{
+	FrameNumber++;
+
+	if (SOFEventsEnabled)
+	  EVENT_USB_Device_StartOfFrame();
+
+	for (uint8_t EndpointNumber = 1; EndpointNumber < TOTAL_ENDPOINTS; EndpointNumber++)
+	{
+		SimEndpoint_t* Endpoint = &Endpoints[EndpointNumber];
+		bool           Keyboard = (EndpointNumber == Keyboard_HID_Interface.Config.ReportINEndpointNumber);
+
+		if (!(Endpoint->Configured) || (Endpoint->Direction != ENDPOINT_DIR_IN))
+		  continue;
+
+		if (FrameNumber % (Keyboard ? KEYBOARD_POLLINGINTERVAL : OTHER_EP_POLLINGINTERVAL))
+		  continue;
+
+		/* IN token is NAKed if the device has not released a bank */
+		if (!(Endpoint->BanksQueued))
+		  continue;
+
+		if (Keyboard)
+		  ReadKeyboardReport(Endpoint);
+
+		Endpoint->BanksQueued--;
+		Endpoint->QueuedBytes[0] = Endpoint->QueuedBytes[1];
+		Endpoint->QueuedScan[0]  = Endpoint->QueuedScan[1];
+		memcpy(Endpoint->QueuedData[0], Endpoint->QueuedData[1], MAX_BANK_SIZE);
+	}
+}
+
+/** Changes the simulated joystick and button inputs to a new pseudo-random state which changes the demo's keys,
+ *  adding the new key state to \ref KeyStates.
+ *
+ *  \param[in] Release  If true, all inputs are released rather than set to a pseudo-random state
+ */
+static void ChangeInputs(const bool Release)
+{
+	uint8_t PrevKeyMask = KeyStates[TotalKeyStates - 1].KeyMask;
+	uint8_t KeyMask;
+
+	do
+	{
+		static const uint8_t VerticalStates[]   = {0, JOY_UP, JOY_DOWN};
+		static const uint8_t HorizontalStates[] = {0, JOY_LEFT, JOY_RIGHT};
+
+		JoystickState = Release ? 0 : (VerticalStates[RandomNumber(3)] | HorizontalStates[RandomNumber(3)] |
+		                               (RandomNumber(2) ? JOY_PRESS : 0));
+		ButtonsState  = Release ? 0 : (RandomNumber(2) ? BUTTONS_BUTTON1 : 0);
+		KeyMask       = DemoKeyMask(JoystickState, ButtonsState);
+	}
+	while (!(Release) && (KeyMask == PrevKeyMask));
+
+	KeyStates[TotalKeyStates++] = (SimKeyState_t)
+		{
+			.KeyMask      = KeyMask,
+			.ChangeTimeUS = NextChangeUS,
+		};
+}
+
+/** Returns the time from one input change to the next in the current scenario. Isolated changes are spaced so that
+ *  the previous report has always been read by the host before the next change is scanned, while burst changes may
+ *  arrive on every main loop pass.
+ *
+ *  \return Time until the next input change, in microseconds
+ */
+static uint32_t NextChangeDelay(void)
+{
+	uint32_t LoopPeriodUS = CurrentScenario->LoopPeriodUS;
+
+	if (CurrentScenario->Burst)
+	  return (LoopPeriodUS + RandomNumber(KEYBOARD_POLL_PERIOD_US));
+
+	return (KEYBOARD_POLL_PERIOD_US + (2 * LoopPeriodUS) + RandomNumber(2 * KEYBOARD_POLL_PERIOD_US));
+}
+
+void USB_Init(void)
+{
+
+}
+
+void USB_Device_EnableSOFEvents(void)
+{
+	SOFEventsEnabled = true;
+}
+
+/** Simulated USB management task, called once per pass of the demo's main loop. The first call enumerates the device,
+ *  and each later call advances the simulated time by one main loop pass, running the frames of the simulated host and
+ *  making the input changes due in that time. Once all key changes have been made and the last one has had time to
+ *  reach the host, the demo's main loop is left.
+ */
+void USB_USBTask(void)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	{
+		EnumerateDevice();
+		return;
+	}
+
+	uint64_t NewTimeUS = (SimTimeUS + CurrentScenario->LoopPeriodUS);
+
+	while (NextFrameUS <= NewTimeUS)
+	{
+		SimTimeUS    = NextFrameUS;
+		NextFrameUS += FRAME_PERIOD_US;
+
+		StartFrame();
+	}
+
+	SimTimeUS = NewTimeUS;
+
+	/* Input changes are seen by the key scan at the start of the next main loop pass */
+	if (NextChangeUS <= SimTimeUS)
+	{
+		if (TotalKeyStates <= SCENARIO_KEY_CHANGES)
+		{
+			ChangeInputs(false);
+		}
+		else if (KeyStates[TotalKeyStates - 1].KeyMask)
+		{
+			ChangeInputs(true);
+		}
+		else
+		{
+			if (SimTimeUS > (NextChangeUS + (4 * KEYBOARD_POLL_PERIOD_US)))
+			  longjmp(ScenarioComplete, 1);
+
+			return;
+		}
+
+		LatestScan = (TotalKeyStates - 1);
+		KeyStates[LatestScan].ScanTimeUS = SimTimeUS;
+
+		NextChangeUS += NextChangeDelay();
+	}
+}
+
+bool Endpoint_ConfigureEndpoint(const uint8_t Number, const uint8_t Type, const uint8_t Direction,
+                                const uint16_t Size, const uint8_t Banks)
+{
+	SimEndpoint_t* Endpoint = &Endpoints[Number];
+
+	if ((Number >= TOTAL_ENDPOINTS) || (Type != EP_TYPE_INTERRUPT) || (Size > MAX_BANK_SIZE) || (Size & (Size - 1)))
+	  return false;
+
+	memset(Endpoint, 0x00, sizeof(SimEndpoint_t));
+	Endpoint->Configured = true;
+	Endpoint->Direction  = Direction;
+	Endpoint->Size       = Size;
+	Endpoint->Banks      = (Banks == ENDPOINT_BANK_DOUBLE) ? 2 : 1;
+
+	return true;
+}
+
+void Endpoint_SelectEndpoint(const uint8_t EndpointNumber)
+{
+	SelectedEndpoint = &Endpoints[EndpointNumber];
+}
+
+bool Endpoint_IsSETUPReceived(void)
+{
+	return SETUPPending;
+}
+
+void Endpoint_ClearSETUP(void)
+{
+	SETUPPending = false;
+}
+
+void Endpoint_ClearStatusStage(void)
+{
+
+}
+
+uint16_t Endpoint_Write_Control_Stream_LE(const void* Buffer, uint16_t Length)
+{
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint16_t Endpoint_Read_Control_Stream_LE(void* Buffer, uint16_t Length)
+{
+	memset(Buffer, 0x00, Length);
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+bool Endpoint_IsReadWriteAllowed(void)
+{
+	return ((SelectedEndpoint->BanksQueued < SelectedEndpoint->Banks) &&
+	        (SelectedEndpoint->BytesInBank < SelectedEndpoint->Size));
+}
+
+bool Endpoint_IsOUTReceived(void)
+{
+	return false;
+}
+
+uint16_t Endpoint_BytesInEndpoint(void)
+{
+	return SelectedEndpoint->BytesInBank;
+}
+
+void Endpoint_ClearIN(void)
+{
+	if (SelectedEndpoint == &Endpoints[ENDPOINT_CONTROLEP])
+	  return;
+
+	if (SelectedEndpoint->BanksQueued == SelectedEndpoint->Banks)
+	{
+		printf("  IN bank released while all banks are full\n");
+		Results.Errors++;
+		return;
+	}
+
+	uint8_t QueueIndex = SelectedEndpoint->BanksQueued++;
+
+	SelectedEndpoint->QueuedBytes[QueueIndex] = SelectedEndpoint->BytesInBank;
+	SelectedEndpoint->QueuedScan[QueueIndex]  = LatestScan;
+	memcpy(SelectedEndpoint->QueuedData[QueueIndex], SelectedEndpoint->BankData, MAX_BANK_SIZE);
+
+	SelectedEndpoint->BytesInBank = 0;
+}
+
+void Endpoint_ClearOUT(void)
+{
+
+}
+
+uint8_t Endpoint_Read_Byte(void)
+{
+	return 0;
+}
+
+void Endpoint_Write_Byte(const uint8_t Byte)
+{
+	if (SelectedEndpoint == &Endpoints[ENDPOINT_CONTROLEP])
+	  return;
+
+	if (!(Endpoint_IsReadWriteAllowed()))
+	{
+		printf("  IN endpoint written while its bank is full\n");
+		Results.Errors++;
+		return;
+	}
+
+	SelectedEndpoint->BankData[SelectedEndpoint->BytesInBank++] = Byte;
+}
+
+uint8_t Endpoint_Read_Stream_LE(void* Buffer, uint16_t Length, void* Callback)
+{
+	memset(Buffer, 0x00, Length);
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t Endpoint_Write_Stream_LE(const void* Buffer, uint16_t Length, void* Callback)
+{
+	const uint8_t* Data = (const uint8_t*)Buffer;
+
+	while (Length--)
+	  Endpoint_Write_Byte(*(Data++));
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t Joystick_GetStatus(void)
+{
+	return JoystickState;
+}
+
+uint8_t Buttons_GetStatus(void)
+{
+	return ButtonsState;
+}
+
+void LEDs_SetAllLEDs(const uint8_t LEDMask)
+{
+
+}
+
+/** Runs the given scenario through the demo's main loop, then checks its results against the latency bounds.
+ *
+ *  \param[in] Scenario  Scenario to run
+ */
+static void RunScenario(const Scenario_t* const Scenario)
+{
+	CurrentScenario = Scenario;
+
+	memset(&Results, 0x00, sizeof(Results));
+	memset(Endpoints, 0x00, sizeof(Endpoints));
+	Results.ScanToINMinUS = UINT64_MAX;
+
+	USB_DeviceState  = DEVICE_STATE_Unattached;
+	SOFEventsEnabled = false;
+	SimTimeUS        = 0;
+	NextFrameUS      = FRAME_PERIOD_US;
+	FrameNumber      = 0;
+	JoystickState    = 0;
+	ButtonsState     = 0;
+	TotalKeyStates   = 1;
+	LatestScan       = 0;
+	LastReported     = 0;
+	NextChangeUS     = (10 * FRAME_PERIOD_US) + RandomNumber(FRAME_PERIOD_US);
+
+	memset(KeyStates, 0x00, sizeof(KeyStates));
+
+	if (!(setjmp(ScenarioComplete)))
+	  Demo_main();
+
+	if (LastReported != (TotalKeyStates - 1))
+	{
+		printf("  Final key state was not sent to the host\n");
+		Results.Errors++;
+	}
+
+	uint64_t ScanToINBoundUS = (Scenario->Burst ? (2 * KEYBOARD_POLL_PERIOD_US) : KEYBOARD_POLL_PERIOD_US);
+	uint64_t KeyToINBoundUS  = (ScanToINBoundUS + Scenario->LoopPeriodUS);
+
+	if ((Results.ScanToINMaxUS > ScanToINBoundUS) || (Results.KeyToINMaxUS > KeyToINBoundUS))
+	{
+		printf("  Latency exceeds the bound of %lluus from the scan, %lluus from the input change\n",
+		       (unsigned long long)ScanToINBoundUS, (unsigned long long)KeyToINBoundUS);
+		Results.Errors++;
+	}
+
+	if (!(Scenario->Burst) && Results.Superseded)
+	{
+		printf("  Isolated key states were superseded before being sent\n");
+		Results.Errors++;
+	}
+
+	printf("%-18s %6u %8lu %10lu %8llu %8llu %8llu %8llu %10llu %7lu\n", Scenario->Name, Scenario->LoopPeriodUS,
+	       (unsigned long)Results.Reports, (unsigned long)Results.Superseded,
+	       (unsigned long long)(Results.Reports ? Results.ScanToINMinUS : 0),
+	       (unsigned long long)(Results.Reports ? (Results.ScanToINTotalUS / Results.Reports) : 0),
+	       (unsigned long long)Results.ScanToINMaxUS, (unsigned long long)ScanToINBoundUS,
+	       (unsigned long long)Results.KeyToINMaxUS, (unsigned long)Results.Errors);
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	RandomState = 0x1D5A8E27;
+
+	#if defined(KEYBOARDMOUSE_DEMO)
+	printf("KeyboardMouse demo");
+	#else
+	printf("Keyboard demo");
+	#endif
+
+	#if defined(KEYBOARD_NKRO)
+	printf(" with KEYBOARD_NKRO");
+	#endif
+
+	printf(", keyboard endpoint polled every %dms\n\n", KEYBOARD_POLLINGINTERVAL);
+	printf("                     Loop                             Scan to IN token (us)     Key to IN\n");
+	printf("Scenario           (us)  Reports Superseded      Min     Mean      Max    Bound   Max (us)  Errors\n");
+
+	for (uint8_t ScenarioIndex = 0; ScenarioIndex < (sizeof(Scenarios) / sizeof(Scenarios[0])); ScenarioIndex++)
+	{
+		RunScenario(&Scenarios[ScenarioIndex]);
+		TotalErrors += Results.Errors;
+	}
+
+	printf("\n");
+
+	if (TotalErrors)
+	{
+		printf("FAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	printf("All scenarios passed.\n");
+	return 0;
+}
@@ -0,0 +1,139 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Shim header force-included (via the compiler's -include switch) when building the CDC device class driver for the
+ *  host machine. The AVR specific USB core headers are suppressed, and the control request, device state and endpoint
+ *  interface the driver uses are declared here instead. The endpoint functions are implemented by the simulated
+ *  endpoints of the test, rather than the AVR's USB controller. The avr-libc stream extensions used by the driver's
+ *  stream functions are reduced to stand-ins, as the tests do not use the streams.
+ */
+
+#ifndef _CDC_DEVICE_SHIM_H_
+#define _CDC_DEVICE_SHIM_H_
+
+	/* Macros: */
+		#define __USB_H__
+
+		#define ATTR_NON_NULL_PTR_ARG(...)
+		#define ATTR_WEAK                               __attribute__ ((weak))
+		#define ATTR_ALIAS(Func)                        __attribute__ ((alias( #Func )))
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+		#include <stddef.h>
+		#include <stdio.h>
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#define REQDIR_HOSTTODEVICE                     (0 << 7)
+			#define REQDIR_DEVICETOHOST                     (1 << 7)
+			#define REQTYPE_CLASS                           (1 << 5)
+			#define REQREC_INTERFACE                        (1 << 0)
+
+			#define EP_TYPE_BULK                            0x02
+			#define EP_TYPE_INTERRUPT                       0x03
+
+			#define ENDPOINT_DIR_OUT                        (0 << 0)
+			#define ENDPOINT_DIR_IN                         (1 << 0)
+			#define ENDPOINT_BANK_SINGLE                    (0 << 1)
+			#define ENDPOINT_BANK_DOUBLE                    (1 << 1)
+
+			#define NO_STREAM_CALLBACK                      NULL
+
+			#define FDEV_SETUP_STREAM(Put, Get, RWFlag)     {(int)((Put) == NULL) + (int)((Get) == NULL)}
+			#define fdev_set_udata(Stream, Data)            ((void)(Stream), (void)(Data))
+			#define fdev_get_udata(Stream)                  ((void)(Stream), NULL)
+			#define _FDEV_SETUP_RW                          3
+			#define _FDEV_ERR                               -1
+			#define _FDEV_EOF                               -2
+
+		/* Type Defines: */
+			typedef struct
+			{
+				uint8_t Size;
+				uint8_t Type;
+			} __attribute__((packed)) USB_Descriptor_Header_t;
+
+			typedef struct
+			{
+				uint8_t  bmRequestType;
+				uint8_t  bRequest;
+				uint16_t wValue;
+				uint16_t wIndex;
+				uint16_t wLength;
+			} __attribute__((packed)) USB_Request_Header_t;
+
+		/* Enums: */
+			enum USB_Device_States_t
+			{
+				DEVICE_STATE_Unattached                 = 0,
+				DEVICE_STATE_Configured                 = 4,
+			};
+
+			enum Endpoint_Stream_RW_ErrorCodes_t
+			{
+				ENDPOINT_RWSTREAM_NoError               = 0,
+				ENDPOINT_RWSTREAM_DeviceDisconnected    = 2,
+			};
+
+			enum Endpoint_WaitUntilReady_ErrorCodes_t
+			{
+				ENDPOINT_READYWAIT_NoError              = 0,
+				ENDPOINT_READYWAIT_Timeout              = 3,
+			};
+
+		/* Global Variables: */
+			extern USB_Request_Header_t USB_ControlRequest;
+			extern volatile uint8_t     USB_DeviceState;
+
+		/* Function Prototypes: */
+			void     USB_USBTask(void);
+
+			bool     Endpoint_ConfigureEndpoint(const uint8_t Number, const uint8_t Type, const uint8_t Direction,
+			                                    const uint16_t Size, const uint8_t Banks);
+			void     Endpoint_SelectEndpoint(const uint8_t EndpointNumber);
+			bool     Endpoint_IsSETUPReceived(void);
+			void     Endpoint_ClearSETUP(void);
+			void     Endpoint_ClearStatusStage(void);
+			uint16_t Endpoint_Write_Control_Stream_LE(const void* Buffer, uint16_t Length);
+			uint16_t Endpoint_Read_Control_Stream_LE(void* Buffer, uint16_t Length);
+			bool     Endpoint_IsReadWriteAllowed(void);
+			bool     Endpoint_IsOUTReceived(void);
+			uint16_t Endpoint_BytesInEndpoint(void);
+			void     Endpoint_ClearIN(void);
+			void     Endpoint_ClearOUT(void);
+			uint8_t  Endpoint_WaitUntilReady(void);
+			uint8_t  Endpoint_Read_Byte(void);
+			void     Endpoint_Write_Byte(const uint8_t Byte);
+			uint8_t  Endpoint_Write_Stream_LE(const void* Buffer, uint16_t Length, void* Callback);
+
+#endif
@@ -0,0 +1,14 @@
+/* Stand-in for the board buttons driver, reading the simulated button state of the host test instead. */
+
+#ifndef _HOST_BUTTONS_H_
+#define _HOST_BUTTONS_H_
+
+	#include <stdint.h>
+
+	#define BUTTONS_BUTTON1     (1 << 0)
+
+	#define Buttons_Init()
+
+	uint8_t Buttons_GetStatus(void);
+
+#endif
@@ -0,0 +1,18 @@
+/* Stand-in for the board joystick driver, reading the simulated joystick position of the host test instead. */
+
+#ifndef _HOST_JOYSTICK_H_
+#define _HOST_JOYSTICK_H_
+
+	#include <stdint.h>
+
+	#define JOY_LEFT            (1 << 0)
+	#define JOY_RIGHT           (1 << 1)
+	#define JOY_UP              (1 << 2)
+	#define JOY_DOWN            (1 << 3)
+	#define JOY_PRESS           (1 << 4)
+
+	#define Joystick_Init()
+
+	uint8_t Joystick_GetStatus(void);
+
+#endif
@@ -0,0 +1,19 @@
+/* Stand-in for the board LEDs driver, recording the LED state in the host test instead. */
+
+#ifndef _HOST_LEDS_H_
+#define _HOST_LEDS_H_
+
+	#include <stdint.h>
+
+	#define LEDS_LED1           (1 << 0)
+	#define LEDS_LED2           (1 << 1)
+	#define LEDS_LED3           (1 << 2)
+	#define LEDS_LED4           (1 << 3)
+	#define LEDS_ALL_LEDS       (LEDS_LED1 | LEDS_LED2 | LEDS_LED3 | LEDS_LED4)
+	#define LEDS_NO_LEDS        0
+
+	#define LEDs_Init()
+
+	void LEDs_SetAllLEDs(const uint8_t LEDMask);
+
+#endif
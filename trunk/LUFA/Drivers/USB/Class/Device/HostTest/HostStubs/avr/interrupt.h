@@ -0,0 +1 @@
+/* Empty stand-in for the AVR interrupt header, so that the demos can be built for the host. */
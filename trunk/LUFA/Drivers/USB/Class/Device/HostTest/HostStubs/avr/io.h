@@ -0,0 +1,12 @@
+/* Stand-in for the AVR device register header, providing the MCU status register used by the demos' hardware setup. */
+
+#ifndef _HOST_AVR_IO_H_
+#define _HOST_AVR_IO_H_
+
+	#include <stdint.h>
+
+	#define WDRF    3
+
+	extern uint8_t MCUSR;
+
+#endif
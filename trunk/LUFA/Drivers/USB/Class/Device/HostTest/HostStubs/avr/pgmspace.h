@@ -0,0 +1,8 @@
+/* Stand-in for the AVR program space header, so that the demos' descriptor headers can be built for the host. */
+
+#ifndef _HOST_AVR_PGMSPACE_H_
+#define _HOST_AVR_PGMSPACE_H_
+
+	#define PROGMEM
+
+#endif
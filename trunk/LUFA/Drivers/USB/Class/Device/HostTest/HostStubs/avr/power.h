@@ -0,0 +1,9 @@
+/* Stand-in for the AVR power management header, so that the demos' hardware setup can be built for the host. */
+
+#ifndef _HOST_AVR_POWER_H_
+#define _HOST_AVR_POWER_H_
+
+	#define clock_div_1                0
+	#define clock_prescale_set(Div)    ((void)(Div))
+
+#endif
@@ -0,0 +1,8 @@
+/* Stand-in for the AVR watchdog header, so that the demos' hardware setup can be built for the host. */
+
+#ifndef _HOST_AVR_WDT_H_
+#define _HOST_AVR_WDT_H_
+
+	#define wdt_disable()
+
+#endif
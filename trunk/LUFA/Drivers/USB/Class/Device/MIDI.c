@@ -67,25 +67,85 @@ bool MIDI_Device_ConfigureEndpoints(USB_ClassInfo_MIDI_Device_t* const MIDIInter
 	return true;
 }
 
+void MIDI_Device_USBTask(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(MIDIInterfaceInfo->Config.DataINFlushFrames))
+	  return;
+
+	Endpoint_SelectEndpoint(MIDIInterfaceInfo->Config.DataINEndpointNumber);
+
+	if (!(Endpoint_IsINReady()) || !(Endpoint_BytesInEndpoint()))
+	  return;
+
+	uint16_t FramesHeld = ((USB_Device_GetFrameNumber() - MIDIInterfaceInfo->State.DataINBankFrame) & MIDI_FRAME_NUMBER_MASK);
+
+	if (FramesHeld >= MIDIInterfaceInfo->Config.DataINFlushFrames)
+	  Endpoint_ClearIN();
+}
+
 uint8_t MIDI_Device_SendEventPacket(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo, MIDI_EventPacket_t* const Event)
 {
 	if (USB_DeviceState != DEVICE_STATE_Configured)
 	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
 	
+	uint8_t ErrorCode;
+
 	Endpoint_SelectEndpoint(MIDIInterfaceInfo->Config.DataINEndpointNumber);
 
-	if (Endpoint_IsReadWriteAllowed());
+	if ((ErrorCode = Endpoint_WaitUntilReady()) != ENDPOINT_READYWAIT_NoError)
+	  return ErrorCode;
+
+	if (!(Endpoint_BytesInEndpoint()))
+	  MIDIInterfaceInfo->State.DataINBankFrame = USB_Device_GetFrameNumber();
+
+	if ((ErrorCode = Endpoint_Write_Stream_LE(Event, sizeof(MIDI_EventPacket_t), NO_STREAM_CALLBACK)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+	
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t MIDI_Device_SendEventPackets(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
+                                     const MIDI_EventPacket_t* Events, uint8_t TotalEvents)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return 0;
+
+	uint8_t EventsSent = 0;
+
+	Endpoint_SelectEndpoint(MIDIInterfaceInfo->Config.DataINEndpointNumber);
+
+	while (TotalEvents && Endpoint_IsReadWriteAllowed())
 	{
-		uint8_t ErrorCode;
+		uint16_t BytesInBank = Endpoint_BytesInEndpoint();
+		uint8_t  BankEvents  = ((MIDIInterfaceInfo->Config.DataINEndpointSize - BytesInBank) / sizeof(MIDI_EventPacket_t));
 
-		if ((ErrorCode = Endpoint_Write_Stream_LE(Event, sizeof(MIDI_EventPacket_t), NO_STREAM_CALLBACK)) != ENDPOINT_RWSTREAM_NoError)
-		  return ErrorCode;
+		if (!(BankEvents))
+		{
+			Endpoint_ClearIN();
+			continue;
+		}
+
+		if (BankEvents > TotalEvents)
+		  BankEvents = TotalEvents;
+
+		if (!(BytesInBank))
+		  MIDIInterfaceInfo->State.DataINBankFrame = USB_Device_GetFrameNumber();
+
+		if (Endpoint_Write_Stream_LE(Events, (BankEvents * sizeof(MIDI_EventPacket_t)), NO_STREAM_CALLBACK) != ENDPOINT_RWSTREAM_NoError)
+		  break;
+
+		Events      += BankEvents;
+		TotalEvents -= BankEvents;
+		EventsSent  += BankEvents;
 
 		if (!(Endpoint_IsReadWriteAllowed()))
 		  Endpoint_ClearIN();
 	}
-	
-	return ENDPOINT_RWSTREAM_NoError;
+
+	return EventsSent;
 }
 
 uint8_t MIDI_Device_Flush(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo)
@@ -126,4 +186,34 @@ bool MIDI_Device_ReceiveEventPacket(USB_ClassInfo_MIDI_Device_t* const MIDIInter
 	return true;
 }
 
+uint8_t MIDI_Device_ReceiveEventPackets(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
+                                        MIDI_EventPacket_t* Events, const uint8_t MaxEvents)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return 0;
+
+	uint8_t EventsReceived = 0;
+
+	Endpoint_SelectEndpoint(MIDIInterfaceInfo->Config.DataOUTEndpointNumber);
+
+	while ((EventsReceived < MaxEvents) && Endpoint_IsOUTReceived())
+	{
+		uint8_t BankEvents = (Endpoint_BytesInEndpoint() / sizeof(MIDI_EventPacket_t));
+
+		if (BankEvents > (MaxEvents - EventsReceived))
+		  BankEvents = (MaxEvents - EventsReceived);
+
+		if (Endpoint_Read_Stream_LE(Events, (BankEvents * sizeof(MIDI_EventPacket_t)), NO_STREAM_CALLBACK) != ENDPOINT_RWSTREAM_NoError)
+		  break;
+
+		Events         += BankEvents;
+		EventsReceived += BankEvents;
+
+		if (Endpoint_BytesInEndpoint() < sizeof(MIDI_EventPacket_t))
+		  Endpoint_ClearOUT();
+	}
+
+	return EventsReceived;
+}
+
 #endif
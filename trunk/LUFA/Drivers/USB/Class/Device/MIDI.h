@@ -90,12 +90,17 @@
 					uint8_t  DataOUTEndpointNumber; /**< Endpoint number of the outgoing MIDI data, if available (zero if unused) */
 					uint16_t DataOUTEndpointSize; /**< Size in bytes of the outgoing MIDI data endpoint, if available (zero if unused) */
 					bool     DataOUTEndpointDoubleBank; /** Indicates if the MIDI interface's IN data endpoint should use double banking */
+
+					uint8_t  DataINFlushFrames; /**< Maximum number of frames a partially filled IN endpoint bank may be held
+					                             *   before it is sent to the host by \ref MIDI_Device_USBTask(), or zero to
+					                             *   only send partially filled banks when \ref MIDI_Device_Flush() is called
+					                             */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */									 
 				struct
 				{
-					// No state information for this class yet
+					uint16_t DataINBankFrame; /**< Frame number at which the first event was queued into the current IN endpoint bank */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -121,7 +126,9 @@
 
 			/** Sends a MIDI event packet to the host. If no host is connected, the event packet is discarded. Events are queued into the
 			 *  endpoint bank until either the endpoint bank is full, or \ref MIDI_Device_Flush() is called. This allows for multiple
-			 *  MIDI events to be packed into a single endpoint packet, increasing data throughput.
+			 *  MIDI events to be packed into a single endpoint packet, increasing data throughput. If the endpoint bank is not yet
+			 *  ready for the event, this function waits until the host has read the previously sent packet, returning an error code
+			 *  instead if the endpoint timeout expires first; the event is never discarded while the function reports success.
 			 *
 			 *  \note This function must only be called when the Device state machine is in the DEVICE_STATE_Configured state or
 			 *        the call will fail.
@@ -135,6 +142,25 @@
 			                                    MIDI_EventPacket_t* const Event) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 
 
+			/** Sends several MIDI event packets to the host in a single call. Events are packed into the endpoint banks a full bank
+			 *  at a time, and each bank is sent to the host as soon as it is filled. This function does not block; if the host has
+			 *  not yet read the previously sent banks only those events which fit into the free endpoint banks are queued, and the
+			 *  remainder should be passed again on a later call. Partially filled banks are sent either by \ref MIDI_Device_Flush(),
+			 *  or by \ref MIDI_Device_USBTask() once the interface's DataINFlushFrames deadline has elapsed.
+			 *
+			 *  \note This function must only be called when the Device state machine is in the DEVICE_STATE_Configured state or
+			 *        the call will fail.
+			 *
+			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state
+			 *  \param[in] Events  Pointer to an array of populated MIDI_EventPacket_t structures containing the MIDI events to send
+			 *  \param[in] TotalEvents  Number of events in the Events array
+			 *
+			 *  \return Number of events from the Events array which were queued for transmission
+			 */
+			uint8_t MIDI_Device_SendEventPackets(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
+			                                     const MIDI_EventPacket_t* Events, uint8_t TotalEvents)
+			                                     ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
 			/** Flushes the MIDI send buffer, sending any queued MIDI events to the host. This should be called to override the
 			 *  \ref MIDI_Device_SendEventPacket() function's packing behaviour, to flush queued events.
 			 *
@@ -158,17 +184,31 @@
 			bool MIDI_Device_ReceiveEventPacket(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
 			                                    MIDI_EventPacket_t* const Event) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 
-		/* Inline Functions: */
+			/** Receives several MIDI event packets from the host in a single call. Events are unpacked from the endpoint until
+			 *  either the given array is full or no further events have been received from the host, clearing each endpoint bank
+			 *  once it has been emptied.
+			 *
+			 *  \note This function must only be called when the Device state machine is in the DEVICE_STATE_Configured state or
+			 *        the call will fail.
+			 *
+			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state
+			 *  \param[out] Events  Pointer to an array of MIDI_EventPacket_t structures where the received MIDI events are to be placed
+			 *  \param[in] MaxEvents  Maximum number of events which may be stored into the Events array
+			 *
+			 *  \return Number of events received and stored into the Events array
+			 */
+			uint8_t MIDI_Device_ReceiveEventPackets(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
+			                                        MIDI_EventPacket_t* Events, const uint8_t MaxEvents)
+			                                        ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
 			/** General management task for a given MIDI class interface, required for the correct operation of the interface. This should
-			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
+			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask(). When the
+			 *  interface's DataINFlushFrames configuration value is non-zero, this sends any partially filled IN endpoint bank to the
+			 *  host once it has been held for the configured number of frames.
 			 *
 			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state
 			 */
-			static inline void MIDI_Device_USBTask(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo);
-			static inline void MIDI_Device_USBTask(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo)
-			{
-				(void)MIDIInterfaceInfo;
-			}		
+			void MIDI_Device_USBTask(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
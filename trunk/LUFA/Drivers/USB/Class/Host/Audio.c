@@ -0,0 +1,517 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../../HighLevel/USBMode.h"
+#if defined(USB_CAN_BE_HOST)
+
+#define  __INCLUDE_FROM_AUDIO_CLASS_HOST_C
+#define  __INCLUDE_FROM_AUDIO_DRIVER
+#include "Audio.h"
+
+uint8_t Audio_Host_ConfigurePipes(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo, uint16_t ConfigDescriptorSize,
+                                  void* ConfigDescriptorData)
+{
+	uint8_t FoundStreams    = 0;
+	uint8_t RequiredStreams = 0;
+
+	memset(&AudioInterfaceInfo->State, 0x00, sizeof(AudioInterfaceInfo->State));
+
+	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	  return AUDIO_ENUMERROR_InvalidConfigDescriptor;
+	
+	if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
+	                              DComp_Audio_Host_NextAudioControlInterface) != DESCRIPTOR_SEARCH_COMP_Found)
+	{
+		return AUDIO_ENUMERROR_NoControlInterfaceFound;
+	}
+	
+	AudioInterfaceInfo->State.ControlInterfaceNumber =
+	                  DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t)->InterfaceNumber;
+
+	if (AudioInterfaceInfo->Config.DataINPipeNumber)
+	  RequiredStreams |= AUDIO_FOUND_DATAPIPE_IN;
+
+	if (AudioInterfaceInfo->Config.DataOUTPipeNumber)
+	  RequiredStreams |= AUDIO_FOUND_DATAPIPE_OUT;
+	
+	while (FoundStreams != RequiredStreams)
+	{
+		if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
+		                              DComp_Audio_Host_NextAudioStreamingInterface) != DESCRIPTOR_SEARCH_COMP_Found)
+		{
+			return AUDIO_ENUMERROR_NoStreamingInterfaceFound;
+		}
+
+		USB_Descriptor_Interface_t* InterfaceData     = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
+		USB_Audio_Interface_AS_t*   GeneralData       = NULL;
+		USB_Audio_Format_t*         FormatData        = NULL;
+		USB_Descriptor_Endpoint_t*  DataEndpoint      = NULL;
+		USB_Descriptor_Endpoint_t*  FeedbackEndpoint  = NULL;
+		USB_Descriptor_Endpoint_t*  LastEndpoint      = NULL;
+		bool                        SampleRateControl = false;
+
+		/* Gather the class specific and endpoint descriptors of the alternate setting, up to the next interface */
+		while (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
+		                                 DComp_Audio_Host_NextAudioStreamingDescriptor) == DESCRIPTOR_SEARCH_COMP_Found)
+		{
+			switch (DESCRIPTOR_TYPE(ConfigDescriptorData))
+			{
+				case DTYPE_AudioInterface:
+					if (DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Audio_Interface_AS_t)->Subtype == DSUBTYPE_General)
+					  GeneralData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Audio_Interface_AS_t);
+					else if (DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Audio_Format_t)->Subtype == DSUBTYPE_Format)
+					  FormatData  = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Audio_Format_t);
+
+					break;
+				case DTYPE_Endpoint:
+					LastEndpoint = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
+					
+					/* Any endpoint following the data endpoint within the alternate setting is its synchronization endpoint */
+					if (!(DataEndpoint) && ((LastEndpoint->Attributes & AUDIO_ENDPOINT_USAGE_MASK) != ENDPOINT_USAGE_FEEDBACK))
+					  DataEndpoint = LastEndpoint;
+					else
+					  FeedbackEndpoint = LastEndpoint;
+					
+					break;
+				case DTYPE_AudioEndpoint:
+					if ((LastEndpoint == DataEndpoint) &&
+					    (DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Audio_StreamEndpoint_Spc_t)->Attributes & AUDIO_EPATTR_SamplingFreq))
+					{
+						SampleRateControl = true;
+					}
+					
+					break;
+			}
+		}
+		
+		if (!(DataEndpoint) || ((DataEndpoint->Attributes & EP_TYPE_MASK) != EP_TYPE_ISOCHRONOUS))
+		  continue;
+
+		if (DataEndpoint->EndpointAddress & ENDPOINT_DESCRIPTOR_DIR_IN)
+		{
+			if ((FoundStreams & AUDIO_FOUND_DATAPIPE_IN) || !(RequiredStreams & AUDIO_FOUND_DATAPIPE_IN))
+			  continue;
+			  
+			if (!(Audio_Host_FormatMatches(&AudioInterfaceInfo->Config.DataINFormat, GeneralData, FormatData)))
+			  continue;
+
+			/* Skip alternate settings whose endpoint is too large for the pipe, in favour of a lower bandwidth setting */
+			if (!(Pipe_ConfigurePipe(AudioInterfaceInfo->Config.DataINPipeNumber, EP_TYPE_ISOCHRONOUS, PIPE_TOKEN_IN,
+			                         DataEndpoint->EndpointAddress, DataEndpoint->EndpointSize, PIPE_BANK_DOUBLE)))
+			{
+				continue;
+			}
+
+			Pipe_SelectPipe(AudioInterfaceInfo->Config.DataINPipeNumber);
+			Pipe_Freeze();
+
+			AudioInterfaceInfo->State.DataINInterfaceNumber   = InterfaceData->InterfaceNumber;
+			AudioInterfaceInfo->State.DataINAlternateSetting  = InterfaceData->AlternateSetting;
+			AudioInterfaceInfo->State.DataINEndpointAddress   = DataEndpoint->EndpointAddress;
+			AudioInterfaceInfo->State.DataINSampleRateControl = SampleRateControl;
+			AudioInterfaceInfo->State.DataINPipeSize          = DataEndpoint->EndpointSize;
+			AudioInterfaceInfo->State.DataINFrameSize         = (FormatData->Channels * FormatData->SubFrameSize);
+
+			FoundStreams |= AUDIO_FOUND_DATAPIPE_IN;
+		}
+		else
+		{
+			if ((FoundStreams & AUDIO_FOUND_DATAPIPE_OUT) || !(RequiredStreams & AUDIO_FOUND_DATAPIPE_OUT))
+			  continue;
+
+			if (!(Audio_Host_FormatMatches(&AudioInterfaceInfo->Config.DataOUTFormat, GeneralData, FormatData)))
+			  continue;
+
+			if (!(Pipe_ConfigurePipe(AudioInterfaceInfo->Config.DataOUTPipeNumber, EP_TYPE_ISOCHRONOUS, PIPE_TOKEN_OUT,
+			                         DataEndpoint->EndpointAddress, DataEndpoint->EndpointSize, PIPE_BANK_DOUBLE)))
+			{
+				continue;
+			}
+
+			Pipe_SelectPipe(AudioInterfaceInfo->Config.DataOUTPipeNumber);
+			Pipe_Freeze();
+
+			AudioInterfaceInfo->State.DataOUTInterfaceNumber   = InterfaceData->InterfaceNumber;
+			AudioInterfaceInfo->State.DataOUTAlternateSetting  = InterfaceData->AlternateSetting;
+			AudioInterfaceInfo->State.DataOUTEndpointAddress   = DataEndpoint->EndpointAddress;
+			AudioInterfaceInfo->State.DataOUTSampleRateControl = SampleRateControl;
+			AudioInterfaceInfo->State.DataOUTPipeSize          = DataEndpoint->EndpointSize;
+			AudioInterfaceInfo->State.DataOUTFrameSize         = (FormatData->Channels * FormatData->SubFrameSize);
+			AudioInterfaceInfo->State.DataOUTFramesPerPacket   =
+			                  AUDIO_FEEDBACK_VALUE(AudioInterfaceInfo->Config.DataOUTFormat.SampleFrequency);
+
+			if (FeedbackEndpoint && (FeedbackEndpoint->EndpointAddress & ENDPOINT_DESCRIPTOR_DIR_IN) &&
+			    AudioInterfaceInfo->Config.FeedbackPipeNumber)
+			{
+				if (Pipe_ConfigurePipe(AudioInterfaceInfo->Config.FeedbackPipeNumber, EP_TYPE_ISOCHRONOUS, PIPE_TOKEN_IN,
+				                       FeedbackEndpoint->EndpointAddress, FeedbackEndpoint->EndpointSize, PIPE_BANK_SINGLE))
+				{
+					Pipe_SelectPipe(AudioInterfaceInfo->Config.FeedbackPipeNumber);
+					Pipe_Freeze();
+					
+					AudioInterfaceInfo->State.FeedbackPipeActive = true;
+				}
+			}
+
+			FoundStreams |= AUDIO_FOUND_DATAPIPE_OUT;
+		}
+	}
+	
+	AudioInterfaceInfo->State.IsActive = true;
+	return AUDIO_ENUMERROR_NoError;
+}
+
+static uint8_t DComp_Audio_Host_NextAudioControlInterface(void* const CurrentDescriptor)
+{
+	if (DESCRIPTOR_TYPE(CurrentDescriptor) == DTYPE_Interface)
+	{
+		USB_Descriptor_Interface_t* CurrentInterface = DESCRIPTOR_PCAST(CurrentDescriptor,
+		                                                                USB_Descriptor_Interface_t);
+
+		if ((CurrentInterface->Class    == AUDIO_CONTROL_CLASS)    &&
+		    (CurrentInterface->SubClass == AUDIO_CONTROL_SUBCLASS))
+		{
+			return DESCRIPTOR_SEARCH_Found;
+		}
+	}
+	
+	return DESCRIPTOR_SEARCH_NotFound;
+}
+
+static uint8_t DComp_Audio_Host_NextAudioStreamingInterface(void* const CurrentDescriptor)
+{
+	if (DESCRIPTOR_TYPE(CurrentDescriptor) == DTYPE_Interface)
+	{
+		USB_Descriptor_Interface_t* CurrentInterface = DESCRIPTOR_PCAST(CurrentDescriptor,
+		                                                                USB_Descriptor_Interface_t);
+
+		/* Alternate setting zero of each streaming interface is the zero bandwidth setting, and has no endpoints */
+		if ((CurrentInterface->Class    == AUDIO_STREAMING_CLASS)    &&
+		    (CurrentInterface->SubClass == AUDIO_STREAMING_SUBCLASS) &&
+		    (CurrentInterface->AlternateSetting))
+		{
+			return DESCRIPTOR_SEARCH_Found;
+		}
+	}
+	
+	return DESCRIPTOR_SEARCH_NotFound;
+}
+
+static uint8_t DComp_Audio_Host_NextAudioStreamingDescriptor(void* const CurrentDescriptor)
+{
+	switch (DESCRIPTOR_TYPE(CurrentDescriptor))
+	{
+		case DTYPE_AudioInterface:
+		case DTYPE_AudioEndpoint:
+		case DTYPE_Endpoint:
+			return DESCRIPTOR_SEARCH_Found;
+		case DTYPE_Interface:
+			return DESCRIPTOR_SEARCH_Fail;
+	}
+
+	return DESCRIPTOR_SEARCH_NotFound;
+}
+
+static bool Audio_Host_FormatMatches(const Audio_Host_StreamFormat_t* const Format,
+                                     const USB_Audio_Interface_AS_t* const GeneralData,
+                                     const USB_Audio_Format_t* const FormatData)
+{
+	if (!(GeneralData) || !(FormatData))
+	  return false;
+
+	if ((GeneralData->AudioFormat != AUDIO_FORMAT_PCM) || (FormatData->FormatType != AUDIO_FORMAT_TYPE_I))
+	  return false;
+
+	if ((FormatData->Channels      != Format->Channels)     ||
+	    (FormatData->SubFrameSize  != Format->SubFrameSize) ||
+	    (FormatData->BitResolution != Format->BitResolution))
+	{
+		return false;
+	}
+
+	/* A frequency type of zero indicates a continuous range given by its lower and upper bounds */
+	uint8_t TotalFrequencies = (FormatData->SampleFrequencyType ? FormatData->SampleFrequencyType : 2);
+
+	if (FormatData->Header.Size < (offsetof(USB_Audio_Format_t, SampleFrequencies) + (TotalFrequencies * 3)))
+	  return false;
+
+	const uint8_t* FrequencyData = (const uint8_t*)FormatData->SampleFrequencies;
+
+	if (!(FormatData->SampleFrequencyType))
+	{
+		return ((Format->SampleFrequency >= AUDIO_FREQUENCY_VALUE(&FrequencyData[0])) &&
+		        (Format->SampleFrequency <= AUDIO_FREQUENCY_VALUE(&FrequencyData[3])));
+	}
+
+	while (TotalFrequencies--)
+	{
+		if (Format->SampleFrequency == AUDIO_FREQUENCY_VALUE(FrequencyData))
+		  return true;
+
+		FrequencyData += 3;
+	}
+	
+	return false;
+}
+
+static uint8_t Audio_Host_SetInterfaceAltSetting(const uint8_t InterfaceNumber, const uint8_t AltSetting)
+{
+	USB_ControlRequest = (USB_Request_Header_t)
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_INTERFACE),
+			.bRequest      = REQ_SetInterface,
+			.wValue        = AltSetting,
+			.wIndex        = InterfaceNumber,
+			.wLength       = 0,
+		};
+
+	Pipe_SelectPipe(PIPE_CONTROLPIPE);
+
+	return USB_Host_SendControlRequest(NULL);
+}
+
+static uint8_t Audio_Host_SetSampleRate(const uint8_t EndpointAddress, const uint32_t SampleFrequency)
+{
+	uint8_t SampleRate[3] = {SampleFrequency, (SampleFrequency >> 8), (SampleFrequency >> 16)};
+
+	USB_ControlRequest = (USB_Request_Header_t)
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_ENDPOINT),
+			.bRequest      = AUDIO_REQ_SetCurrent,
+			.wValue        = (AUDIO_EPCONTROL_SamplingFreq << 8),
+			.wIndex        = EndpointAddress,
+			.wLength       = sizeof(SampleRate),
+		};
+
+	Pipe_SelectPipe(PIPE_CONTROLPIPE);
+
+	return USB_Host_SendControlRequest(SampleRate);
+}
+
+uint8_t Audio_Host_StartStopStreaming(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+                                      const bool EnableStreaming)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(AudioInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	uint8_t ErrorCode;
+
+	if (AudioInterfaceInfo->Config.DataINPipeNumber)
+	{
+		if ((ErrorCode = Audio_Host_SetInterfaceAltSetting(AudioInterfaceInfo->State.DataINInterfaceNumber,
+		                                                   EnableStreaming ? AudioInterfaceInfo->State.DataINAlternateSetting : 0))
+		                                                   != HOST_SENDCONTROL_Successful)
+		{
+			return ErrorCode;
+		}
+
+		if (EnableStreaming && AudioInterfaceInfo->State.DataINSampleRateControl)
+		{
+			if ((ErrorCode = Audio_Host_SetSampleRate(AudioInterfaceInfo->State.DataINEndpointAddress,
+			                                          AudioInterfaceInfo->Config.DataINFormat.SampleFrequency))
+			                                          != HOST_SENDCONTROL_Successful)
+			{
+				return ErrorCode;
+			}
+		}
+
+		Pipe_SelectPipe(AudioInterfaceInfo->Config.DataINPipeNumber);
+		Pipe_Freeze();
+
+		/* Discard any packet left over from a previous stream so that stale samples are not read once restarted */
+		Pipe_ResetPipe(AudioInterfaceInfo->Config.DataINPipeNumber);
+
+		if (EnableStreaming)
+		  Pipe_Unfreeze();
+	}
+
+	if (AudioInterfaceInfo->Config.DataOUTPipeNumber)
+	{
+		if ((ErrorCode = Audio_Host_SetInterfaceAltSetting(AudioInterfaceInfo->State.DataOUTInterfaceNumber,
+		                                                   EnableStreaming ? AudioInterfaceInfo->State.DataOUTAlternateSetting : 0))
+		                                                   != HOST_SENDCONTROL_Successful)
+		{
+			return ErrorCode;
+		}
+
+		if (EnableStreaming && AudioInterfaceInfo->State.DataOUTSampleRateControl)
+		{
+			if ((ErrorCode = Audio_Host_SetSampleRate(AudioInterfaceInfo->State.DataOUTEndpointAddress,
+			                                          AudioInterfaceInfo->Config.DataOUTFormat.SampleFrequency))
+			                                          != HOST_SENDCONTROL_Successful)
+			{
+				return ErrorCode;
+			}
+		}
+
+		AudioInterfaceInfo->State.DataOUTFrameFraction = 0;
+		AudioInterfaceInfo->State.DataOUTPacketFrames  = 0;
+
+		Pipe_SelectPipe(AudioInterfaceInfo->Config.DataOUTPipeNumber);
+		Pipe_Freeze();
+
+		/* Discard any partially filled packet, as its frame count no longer matches the reset packet state above */
+		Pipe_ResetPipe(AudioInterfaceInfo->Config.DataOUTPipeNumber);
+
+		if (EnableStreaming)
+		  Pipe_Unfreeze();
+
+		if (AudioInterfaceInfo->State.FeedbackPipeActive)
+		{
+			Pipe_SelectPipe(AudioInterfaceInfo->Config.FeedbackPipeNumber);
+
+			if (EnableStreaming)
+			  Pipe_Unfreeze();
+			else
+			  Pipe_Freeze();
+		}
+	}
+
+	AudioInterfaceInfo->State.IsStreaming = EnableStreaming;
+	return HOST_SENDCONTROL_Successful;
+}
+
+uint16_t Audio_Host_ReadSampleFrames(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo, void* Buffer,
+                                     const uint16_t MaxFrames)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(AudioInterfaceInfo->State.IsStreaming) ||
+	    !(AudioInterfaceInfo->Config.DataINPipeNumber))
+	{
+		return 0;
+	}
+
+	Pipe_SelectPipe(AudioInterfaceInfo->Config.DataINPipeNumber);
+
+	if (!(Pipe_IsINReceived()))
+	  return 0;
+
+	uint8_t  FrameSize   = AudioInterfaceInfo->State.DataINFrameSize;
+	uint16_t TotalFrames = (Pipe_BytesInPipe() / FrameSize);
+
+	if (TotalFrames > MaxFrames)
+	  TotalFrames = MaxFrames;
+
+	uint8_t* DataStream = (uint8_t*)Buffer;
+
+	for (uint16_t BytesRemaining = (TotalFrames * FrameSize); BytesRemaining; BytesRemaining--)
+	  *(DataStream++) = Pipe_Read_Byte();
+
+	/* Release the packet once no complete frames remain, discarding any trailing partial frame */
+	if (Pipe_BytesInPipe() < FrameSize)
+	  Pipe_ClearIN();
+
+	return TotalFrames;
+}
+
+uint16_t Audio_Host_WriteSampleFrames(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo, const void* Buffer,
+                                      const uint16_t TotalFrames)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(AudioInterfaceInfo->State.IsStreaming) ||
+	    !(AudioInterfaceInfo->Config.DataOUTPipeNumber) || !(TotalFrames))
+	{
+		return 0;
+	}
+
+	Pipe_SelectPipe(AudioInterfaceInfo->Config.DataOUTPipeNumber);
+
+	if (!(Pipe_IsOUTReady()))
+	  return 0;
+
+	uint8_t FrameSize = AudioInterfaceInfo->State.DataOUTFrameSize;
+
+	/* Determine the number of frames due in a new packet, carrying any fractional frame over to the next packet */
+	if (!(Pipe_BytesInPipe()))
+	{
+		uint32_t DueFrames = (AudioInterfaceInfo->State.DataOUTFramesPerPacket + AudioInterfaceInfo->State.DataOUTFrameFraction);
+		uint16_t MaxFrames = (AudioInterfaceInfo->State.DataOUTPipeSize / FrameSize);
+
+		AudioInterfaceInfo->State.DataOUTPacketFrames  = (DueFrames >> 14);
+		AudioInterfaceInfo->State.DataOUTFrameFraction = (DueFrames & 0x3FFF);
+
+		if (AudioInterfaceInfo->State.DataOUTPacketFrames > MaxFrames)
+		  AudioInterfaceInfo->State.DataOUTPacketFrames = MaxFrames;
+	}
+
+	uint16_t FramesInPacket = (Pipe_BytesInPipe() / FrameSize);
+	uint16_t FramesToWrite  = 0;
+
+	/* Guard against a packet already holding the frames due, so that the number of frames to write cannot wrap */
+	if (AudioInterfaceInfo->State.DataOUTPacketFrames > FramesInPacket)
+	  FramesToWrite = (AudioInterfaceInfo->State.DataOUTPacketFrames - FramesInPacket);
+
+	if (FramesToWrite > TotalFrames)
+	  FramesToWrite = TotalFrames;
+
+	const uint8_t* DataStream = (const uint8_t*)Buffer;
+
+	for (uint16_t BytesRemaining = (FramesToWrite * FrameSize); BytesRemaining; BytesRemaining--)
+	  Pipe_Write_Byte(*(DataStream++));
+
+	/* Send the packet once it holds all the frames due in the current USB frame */
+	if ((FramesInPacket + FramesToWrite) >= AudioInterfaceInfo->State.DataOUTPacketFrames)
+	  Pipe_ClearOUT();
+
+	return FramesToWrite;
+}
+
+void Audio_Host_USBTask(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(AudioInterfaceInfo->State.IsStreaming) ||
+	    !(AudioInterfaceInfo->State.FeedbackPipeActive))
+	{
+		return;
+	}
+
+	Pipe_SelectPipe(AudioInterfaceInfo->Config.FeedbackPipeNumber);
+
+	if (!(Pipe_IsINReceived()))
+	  return;
+
+	if (Pipe_BytesInPipe() >= AUDIO_FEEDBACK_EPSIZE)
+	{
+		uint32_t FeedbackValue;
+		
+		FeedbackValue  = Pipe_Read_Byte();
+		FeedbackValue |= ((uint16_t)Pipe_Read_Byte() << 8);
+		FeedbackValue |= ((uint32_t)Pipe_Read_Byte() << 16);
+
+		uint32_t NominalValue = AUDIO_FEEDBACK_VALUE(AudioInterfaceInfo->Config.DataOUTFormat.SampleFrequency);
+
+		/* Discard values deviating from the nominal rate by a whole frame or more, which cannot be valid */
+		if (((FeedbackValue + (1UL << 14)) > NominalValue) && (FeedbackValue < (NominalValue + (1UL << 14))))
+		  AudioInterfaceInfo->State.DataOUTFramesPerPacket = FeedbackValue;
+	}
+	
+	Pipe_ClearIN();
+}
+
+#endif
@@ -0,0 +1,292 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *  \brief Host mode driver for the library USB Audio Class driver.
+ *
+ *  Host mode driver for the library USB Audio Class driver.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the class driver
+ *        dispatch header located in LUFA/Drivers/USB/Class/Audio.h.
+ */
+
+/** \ingroup Group_USBClassAudio
+ *  @defgroup Group_USBClassAudioHost Audio Class Host Mode Driver
+ *
+ *  \section Sec_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - LUFA/Drivers/USB/Class/Host/Audio.c
+ *
+ *  \section Module Description
+ *  Host Mode USB Class driver framework interface, for the Audio USB Class driver. Attached devices are searched for
+ *  an Audio Control interface followed by Audio Streaming interfaces, and the first alternate setting of each streaming
+ *  interface which carries PCM audio in the requested format and sample rate is selected for streaming. Isochronous
+ *  sample data is then transferred in blocks of interleaved sample frames.
+ *
+ *  @{
+ */
+
+#ifndef __AUDIO_CLASS_HOST_H__
+#define __AUDIO_CLASS_HOST_H__
+
+	/* Includes: */
+		#include "../../USB.h"
+		#include "../Common/Audio.h"
+
+		#include <string.h>
+		#include <stddef.h>
+		
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_AUDIO_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/Class/Audio.h instead.
+		#endif
+		
+	/* Public Interface - May be used in end-application: */
+		/* Type Defines: */
+			/** \brief Audio Class Host Mode Stream Format.
+			 *
+			 *  Type define for the PCM audio format requested for one direction of an Audio host interface's streams. Only
+			 *  Audio Streaming interface alternate settings which exactly match the requested format, and which support the
+			 *  requested sample rate, are selected.
+			 */
+			typedef struct
+			{
+				uint8_t  Channels; /**< Number of interleaved channels in each sample frame */
+				uint8_t  SubFrameSize; /**< Size in bytes of each channel's sample */
+				uint8_t  BitResolution; /**< Number of significant bits in each channel's sample */
+				uint32_t SampleFrequency; /**< Sample rate of the stream in Hz */
+			} Audio_Host_StreamFormat_t;
+
+			/** \brief Audio Class Host Mode Configuration and State Structure.
+			 *
+			 *  Class state structure. An instance of this structure should be made within the user application,
+			 *  and passed to each of the Audio class driver functions as the AudioInterfaceInfo parameter. This
+			 *  stores each Audio interface's configuration and state information.
+			 */
+			typedef struct
+			{
+				const struct
+				{
+					uint8_t  DataINPipeNumber; /**< Pipe number of the Audio interface's isochronous recording IN data pipe,
+					                            *   or zero if no recording stream is required
+					                            */
+					uint8_t  DataOUTPipeNumber; /**< Pipe number of the Audio interface's isochronous playback OUT data pipe,
+					                             *   or zero if no playback stream is required
+					                             */
+					uint8_t  FeedbackPipeNumber; /**< Pipe number of the Audio interface's isochronous feedback IN pipe, used
+					                              *   when the playback stream is asynchronous (zero if unused)
+					                              */
+											 
+					Audio_Host_StreamFormat_t DataINFormat; /**< Required format of the recording stream */
+					Audio_Host_StreamFormat_t DataOUTFormat; /**< Required format of the playback stream */
+				} Config; /**< Config data for the USB class interface within the device. All elements in this section
+				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
+				           */
+				struct
+				{
+					bool IsActive; /**< Indicates if the current interface instance is connected to an attached device, valid
+					                *   after \ref Audio_Host_ConfigurePipes() is called and the Host state machine is in the
+					                *   Configured state
+					                */
+					bool IsStreaming; /**< Indicates if the selected streaming interface alternate settings are currently
+					                   *   enabled, set and cleared by \ref Audio_Host_StartStopStreaming()
+					                   */
+
+					uint8_t  ControlInterfaceNumber; /**< Interface index of the Audio Control interface within the attached device */
+
+					uint8_t  DataINInterfaceNumber; /**< Interface index of the recording Audio Streaming interface */
+					uint8_t  DataINAlternateSetting; /**< Alternate setting of the recording interface selected for streaming */
+					uint8_t  DataINEndpointAddress; /**< Address of the recording stream's isochronous endpoint in the device */
+					bool     DataINSampleRateControl; /**< Indicates if the recording endpoint's sample rate can be set by the host */
+					uint16_t DataINPipeSize; /**< Size in bytes of the recording stream's IN data pipe */
+					uint8_t  DataINFrameSize; /**< Size in bytes of a single sample frame of the recording stream */
+
+					uint8_t  DataOUTInterfaceNumber; /**< Interface index of the playback Audio Streaming interface */
+					uint8_t  DataOUTAlternateSetting; /**< Alternate setting of the playback interface selected for streaming */
+					uint8_t  DataOUTEndpointAddress; /**< Address of the playback stream's isochronous endpoint in the device */
+					bool     DataOUTSampleRateControl; /**< Indicates if the playback endpoint's sample rate can be set by the host */
+					uint16_t DataOUTPipeSize; /**< Size in bytes of the playback stream's OUT data pipe */
+					uint8_t  DataOUTFrameSize; /**< Size in bytes of a single sample frame of the playback stream */
+
+					bool     FeedbackPipeActive; /**< Indicates if a feedback pipe was configured for the playback stream */
+					uint32_t DataOUTFramesPerPacket; /**< Number of sample frames sent in each playback packet, in 10.14 fixed point
+					                                  *   format, from the nominal sample rate or the device's feedback endpoint
+					                                  */
+					uint16_t DataOUTFrameFraction; /**< Accumulated fractional sample frames not yet sent, in 10.14 fixed point format */
+					uint16_t DataOUTPacketFrames; /**< Number of sample frames to be sent in the current playback packet */
+				} State; /**< State data for the USB class interface within the device. All elements in this section
+						  *   <b>may</b> be set to initial values, but may also be ignored to default to sane values when
+						  *   the interface is enumerated.
+						  */
+			} USB_ClassInfo_Audio_Host_t;
+			
+		/* Enums: */
+			/** Enum for the possible error codes returned by the \ref Audio_Host_ConfigurePipes() function. */
+			enum AudioHost_EnumerationFailure_ErrorCodes_t
+			{
+				AUDIO_ENUMERROR_NoError                    = 0, /**< Configuration Descriptor was processed successfully */
+				AUDIO_ENUMERROR_InvalidConfigDescriptor    = 1, /**< The device returned an invalid Configuration Descriptor */
+				AUDIO_ENUMERROR_NoControlInterfaceFound    = 2, /**< An Audio Control interface was not found in the device's
+				                                                 *   Configuration Descriptor
+				                                                 */
+				AUDIO_ENUMERROR_NoStreamingInterfaceFound  = 3, /**< An Audio Streaming interface alternate setting matching each
+				                                                 *   of the requested stream formats was not found in the device's
+				                                                 *   Configuration Descriptor
+				                                                 */
+			};
+	
+		/* Function Prototypes: */
+			/** Host interface configuration routine, to configure a given Audio host interface instance using the Configuration
+			 *  Descriptor read from an attached USB device. This function automatically updates the given Audio Host instance's
+			 *  state values and configures the pipes required to communicate with the interface if it is found within the device.
+			 *  This should be called once after the stack has enumerated the attached device, while the host state machine is in
+			 *  the Addressed state.
+			 *
+			 *  For each direction with a non-zero pipe number, the first Audio Streaming interface alternate setting carrying PCM
+			 *  audio in the requested format and sample rate, whose endpoint fits into the pipe, is selected.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state
+			 *  \param[in] ConfigDescriptorSize  Length of the attached device's Configuration Descriptor
+			 *  \param[in] DeviceConfigDescriptor  Pointer to a buffer containing the attached device's Configuration Descriptor
+			 *
+			 *  \return A value from the \ref AudioHost_EnumerationFailure_ErrorCodes_t enum
+			 */
+			uint8_t Audio_Host_ConfigurePipes(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo, uint16_t ConfigDescriptorSize,
+			                                  void* DeviceConfigDescriptor) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3);
+
+			/** Starts or stops streaming on the given Audio host interface, by selecting either the alternate settings chosen by
+			 *  \ref Audio_Host_ConfigurePipes() or the zero bandwidth alternate setting of each Audio Streaming interface. When
+			 *  streaming is started, the requested sample rate is also set on each stream endpoint which supports it. Any
+			 *  partially written or unread packet is discarded from the stream pipes whenever streaming is started or stopped.
+			 *
+			 *  \note This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *        call will fail.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state
+			 *  \param[in] EnableStreaming  Boolean true to start streaming, false to stop streaming
+			 *
+			 *  \return A value from the \ref USB_Host_SendControlErrorCodes_t enum
+			 */
+			uint8_t Audio_Host_StartStopStreaming(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+			                                      const bool EnableStreaming) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Reads a block of sample frames from the given Audio host interface's recording stream into a buffer, up to the
+			 *  number of complete frames remaining in the current isochronous IN pipe packet. Each frame consists of one sample
+			 *  for each of the stream's channels, interleaved and stored in the little endian byte order used on the bus. The
+			 *  pipe packet is released once all complete frames within it have been read.
+			 *
+			 *  \note This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *        call will fail.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state
+			 *  \param[out] Buffer     Pointer to a buffer where the read sample frames are to be stored
+			 *  \param[in]  MaxFrames  Maximum number of sample frames to read into the buffer
+			 *
+			 *  \return Number of complete sample frames read into the buffer
+			 */
+			uint16_t Audio_Host_ReadSampleFrames(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo, void* Buffer,
+			                                     const uint16_t MaxFrames) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Writes a block of sample frames from a buffer to the given Audio host interface's playback stream, up to the
+			 *  number of frames remaining in the current isochronous OUT pipe packet. Each packet holds the number of frames
+			 *  due in a single USB frame at the stream's sample rate, or at the rate requested by the device through its
+			 *  feedback endpoint for asynchronous streams, and is sent to the device once filled.
+			 *
+			 *  \note This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *        call will fail.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state
+			 *  \param[in] Buffer       Pointer to a buffer containing the sample frames to write
+			 *  \param[in] TotalFrames  Number of sample frames in the buffer
+			 *
+			 *  \return Number of complete sample frames written to the interface
+			 */
+			uint16_t Audio_Host_WriteSampleFrames(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo, const void* Buffer,
+			                                      const uint16_t TotalFrames) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** General management task for a given Audio host class interface, required for the correct operation of the interface.
+			 *  This should be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
+			 *  When the playback stream is asynchronous, this reads the device's latest feedback value to adjust the number of
+			 *  sample frames sent in each playback packet.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state
+			 */
+			void Audio_Host_USBTask(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define AUDIO_CONTROL_CLASS              0x01
+			#define AUDIO_CONTROL_SUBCLASS           0x01
+			#define AUDIO_STREAMING_CLASS            0x01
+			#define AUDIO_STREAMING_SUBCLASS         0x02
+
+			#define AUDIO_FORMAT_PCM                 0x0001
+			#define AUDIO_FORMAT_TYPE_I              0x01
+			
+			#define AUDIO_REQ_SetCurrent             0x01
+			#define AUDIO_EPCONTROL_SamplingFreq     0x01
+			#define AUDIO_EPATTR_SamplingFreq        (1 << 0)
+
+			#define AUDIO_ENDPOINT_USAGE_MASK        (3 << 4)
+
+			#define AUDIO_FOUND_DATAPIPE_IN          (1 << 0)
+			#define AUDIO_FOUND_DATAPIPE_OUT         (1 << 1)
+
+			#define AUDIO_FREQUENCY_VALUE(data)      ((uint32_t)(data)[0] | ((uint32_t)(data)[1] << 8) | ((uint32_t)(data)[2] << 16))
+
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_AUDIO_CLASS_HOST_C)
+				static uint8_t DComp_Audio_Host_NextAudioControlInterface(void* const CurrentDescriptor) ATTR_NON_NULL_PTR_ARG(1);
+				static uint8_t DComp_Audio_Host_NextAudioStreamingInterface(void* const CurrentDescriptor) ATTR_NON_NULL_PTR_ARG(1);
+				static uint8_t DComp_Audio_Host_NextAudioStreamingDescriptor(void* const CurrentDescriptor) ATTR_NON_NULL_PTR_ARG(1);
+
+				static bool    Audio_Host_FormatMatches(const Audio_Host_StreamFormat_t* const Format,
+				                                        const USB_Audio_Interface_AS_t* const GeneralData,
+				                                        const USB_Audio_Format_t* const FormatData) ATTR_NON_NULL_PTR_ARG(1);
+				static uint8_t Audio_Host_SetInterfaceAltSetting(const uint8_t InterfaceNumber, const uint8_t AltSetting);
+				static uint8_t Audio_Host_SetSampleRate(const uint8_t EndpointAddress, const uint32_t SampleFrequency);
+			#endif	
+	#endif
+				
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
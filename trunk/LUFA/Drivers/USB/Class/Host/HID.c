@@ -47,6 +47,7 @@ uint8_t HID_Host_ConfigurePipes(USB_ClassInfo_HID_Host_t* const HIDInterfaceInfo
 	  return HID_ENUMERROR_InvalidConfigDescriptor;
 	
 	USB_Descriptor_Interface_t* CurrentHIDInterface;
+	bool                        InterfaceBound;
 	
 	do
 	{
@@ -57,8 +58,14 @@ uint8_t HID_Host_ConfigurePipes(USB_ClassInfo_HID_Host_t* const HIDInterfaceInfo
 		}
 		
 		CurrentHIDInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-	} while (HIDInterfaceInfo->Config.HIDInterfaceProtocol &&
-	         (CurrentHIDInterface->Protocol != HIDInterfaceInfo->Config.HIDInterfaceProtocol));
+
+		uint16_t LookaheadSize = ConfigDescriptorSize;
+		void*    LookaheadData = ConfigDescriptorData;
+
+		InterfaceBound = (USB_GetNextDescriptorComp(&LookaheadSize, &LookaheadData,
+		                                            DComp_HID_Host_NextHIDInterfaceEndpoint) != DESCRIPTOR_SEARCH_COMP_Found);
+	} while (InterfaceBound || (HIDInterfaceInfo->Config.HIDInterfaceProtocol &&
+	         (CurrentHIDInterface->Protocol != HIDInterfaceInfo->Config.HIDInterfaceProtocol)));
 
 	HIDInterfaceInfo->State.InterfaceNumber      = CurrentHIDInterface->InterfaceNumber;
 	HIDInterfaceInfo->State.SupportsBootProtocol = (CurrentHIDInterface->SubClass != HID_NON_BOOT_PROTOCOL);
@@ -88,7 +95,9 @@ uint8_t HID_Host_ConfigurePipes(USB_ClassInfo_HID_Host_t* const HIDInterfaceInfo
 			Pipe_ConfigurePipe(HIDInterfaceInfo->Config.DataINPipeNumber, EP_TYPE_INTERRUPT, PIPE_TOKEN_IN,
 							   EndpointData->EndpointAddress, EndpointData->EndpointSize,
 							   HIDInterfaceInfo->Config.DataINPipeDoubleBank ? PIPE_BANK_DOUBLE : PIPE_BANK_SINGLE);
-			HIDInterfaceInfo->State.DataINPipeSize = EndpointData->EndpointSize;
+			Pipe_SetInterruptPeriod(EndpointData->PollingIntervalMS);
+			HIDInterfaceInfo->State.DataINPipeSize     = EndpointData->EndpointSize;
+			HIDInterfaceInfo->State.DataINPipeInterval = EndpointData->PollingIntervalMS ? EndpointData->PollingIntervalMS : 1;
 			
 			FoundEndpoints |= HID_FOUND_DATAPIPE_IN;
 		}
@@ -106,6 +115,7 @@ uint8_t HID_Host_ConfigurePipes(USB_ClassInfo_HID_Host_t* const HIDInterfaceInfo
 	}
 
 	HIDInterfaceInfo->State.LargestReportSize = 8;
+	HIDInterfaceInfo->State.NextPollFrame     = USB_Host_GetFrameNumber();
 	HIDInterfaceInfo->State.IsActive = true;
 	return HID_ENUMERROR_NoError;
 }
@@ -278,6 +288,65 @@ bool HID_Host_IsReportReceived(USB_ClassInfo_HID_Host_t* const HIDInterfaceInfo)
 	return ReportReceived;
 }
 
+void HID_Host_Scheduler_Stub(void)
+{
+
+}
+
+void HID_Host_SchedulerTask(HID_Host_Scheduler_t* const SchedulerInfo)
+{
+	if (USB_HostState != HOST_STATE_Configured)
+	  return;
+
+	uint8_t  PrevPipe       = Pipe_GetCurrentPipe();
+	uint16_t CurrentFrame   = USB_Host_GetFrameNumber();
+	uint8_t  InterfaceIndex = SchedulerInfo->State.NextInterface;
+
+	for (uint8_t InterfacesServiced = 0; InterfacesServiced < SchedulerInfo->Config.TotalInterfaces; InterfacesServiced++)
+	{
+		if (InterfaceIndex >= SchedulerInfo->Config.TotalInterfaces)
+		  InterfaceIndex = 0;
+
+		USB_ClassInfo_HID_Host_t* HIDInterfaceInfo = SchedulerInfo->Config.Interfaces[InterfaceIndex];
+
+		if (HIDInterfaceInfo->State.IsActive)
+		{
+			Pipe_SelectPipe(HIDInterfaceInfo->Config.DataINPipeNumber);
+
+			if (Pipe_IsFrozen())
+			{
+				/* Frame numbers are 11 bits and wrap, treat the poll as due if the scheduled frame is not in the future */
+				if (((CurrentFrame - HIDInterfaceInfo->State.NextPollFrame) & HID_FRAME_NUMBER_MASK) < (HID_FRAME_NUMBER_MASK >> 1))
+				  Pipe_Unfreeze();
+			}
+			else if (Pipe_IsINReceived())
+			{
+				uint16_t ReportSize = Pipe_BytesInPipe();
+				uint8_t  ReportData[HIDInterfaceInfo->State.DataINPipeSize];
+
+				if (ReportSize > sizeof(ReportData))
+				  ReportSize = sizeof(ReportData);
+
+				Pipe_Read_Stream_LE(ReportData, ReportSize, NO_STREAM_CALLBACK);
+				Pipe_ClearIN();
+				Pipe_Freeze();
+
+				HIDInterfaceInfo->State.NextPollFrame = ((CurrentFrame + HIDInterfaceInfo->State.DataINPipeInterval) &
+				                                         HID_FRAME_NUMBER_MASK);
+
+				CALLBACK_HID_Host_ReportReceived(SchedulerInfo, InterfaceIndex, ReportData, ReportSize);
+			}
+		}
+
+		InterfaceIndex++;
+	}
+
+	if (++SchedulerInfo->State.NextInterface >= SchedulerInfo->Config.TotalInterfaces)
+	  SchedulerInfo->State.NextInterface = 0;
+
+	Pipe_SelectPipe(PrevPipe);
+}
+
 uint8_t HID_Host_SetBootProtocol(USB_ClassInfo_HID_Host_t* const HIDInterfaceInfo)
 {
 	uint8_t ErrorCode;
@@ -352,7 +421,7 @@ uint8_t HID_Host_SetReportProtocol(USB_ClassInfo_HID_Host_t* const HIDInterfaceI
 		return HID_ERROR_LOGICAL | ErrorCode;
 	}
 
-	uint8_t LargestReportSizeBits = HIDInterfaceInfo->Config.HIDParserData->LargestReportSizeBits;
+	uint16_t LargestReportSizeBits = HIDInterfaceInfo->Config.HIDParserData->LargestReportSizeBits;
 	HIDInterfaceInfo->State.LargestReportSize = (LargestReportSizeBits >> 3) + ((LargestReportSizeBits & 0x07) != 0);
 
 	return 0;
@@ -128,12 +128,42 @@
 					uint16_t HIDReportSize; /**< Size in bytes of the HID report descriptor in the device */
 					
 					uint8_t LargestReportSize; /**< Largest report the device will send, in bytes */
+
+					uint8_t DataINPipeInterval; /**< Polling interval of the HID interface's IN data pipe in frames, as
+					                             *   requested by the device's endpoint descriptor
+					                             */
+					uint16_t NextPollFrame; /**< Frame number at which the IN data pipe is next due to be unfrozen by a
+					                         *   \ref HID_Host_Scheduler_t scheduler
+					                         */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 						  *   <b>may</b> be set to initial values, but may also be ignored to default to sane values when
 						  *   the interface is enumerated.
 						  */
 			} USB_ClassInfo_HID_Host_t;
 
+			/** \brief HID Class Host Mode Polling Scheduler Configuration and State Structure.
+			 *
+			 *  Class scheduler structure, used to service the IN data pipes of several HID interfaces within the attached
+			 *  device at the polling intervals requested by each interface's endpoint descriptor. Each interface's IN pipe
+			 *  is only unfrozen once its interval has elapsed, and is frozen again once a report has been received from it,
+			 *  so that pipes are not needlessly polled between reports. Each call to \ref HID_Host_SchedulerTask() services
+			 *  every due interface in turn, starting from a different interface each time so that none are starved.
+			 */
+			typedef struct
+			{
+				const struct
+				{
+					USB_ClassInfo_HID_Host_t** Interfaces; /**< Pointer to an array of HID interfaces to service */
+					uint8_t TotalInterfaces; /**< Number of interfaces in the \ref Interfaces array */
+				} Config; /**< Config data for the HID scheduler. All elements in this section <b>must</b> be set or the
+				           *   scheduler will fail to operate correctly.
+				           */
+				struct
+				{
+					uint8_t NextInterface; /**< Index of the interface to be serviced first on the next scheduler pass */
+				} State; /**< State data for the HID scheduler. */
+			} HID_Host_Scheduler_t;
+
 		/* Enums: */
 			/** Enum for the possible error codes returned by the \ref HID_Host_ConfigurePipes() function. */
 			enum HIDHost_EnumerationFailure_ErrorCodes_t
@@ -152,6 +182,9 @@
 			 *  device. This should be called once after the stack has enumerated the attached device, while the host state
 			 *  machine is in the Addressed state.
 			 *
+			 *  When several instances are configured against the same device, each instance is bound to the next matching HID
+			 *  interface whose endpoints have not already been bound to a pipe by a previously configured instance.
+			 *
 			 *  \note Once the device pipes are configured, the HID device's reporting protocol <b>must</b> be set via a call
 			 *        to either the \ref HID_Host_SetBootProtocol() or \ref HID_Host_SetReportProtocol() function.
 			 *
@@ -269,6 +302,33 @@
 			uint8_t HID_Host_SetReportProtocol(USB_ClassInfo_HID_Host_t* const HIDInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 			#endif
 			
+			/** Polling scheduler task for several HID host class interfaces. This should be called frequently in the main program
+			 *  loop in place of manually checking each interface with \ref HID_Host_IsReportReceived(). Each configured interface
+			 *  whose polling interval has elapsed has its IN pipe unfrozen; once a report is received it is read out of the pipe
+			 *  and passed to the \ref CALLBACK_HID_Host_ReportReceived() callback, the pipe is frozen and the interface's next
+			 *  poll is scheduled one interval into the future.
+			 *
+			 *  \note The interfaces serviced by the scheduler should not also be read via \ref HID_Host_ReceiveReport() or
+			 *        \ref HID_Host_IsReportReceived(), as this will disrupt the scheduling of their pipes.
+			 *
+			 *  \param[in,out] SchedulerInfo  Pointer to a structure containing a HID scheduler configuration and state
+			 */
+			void HID_Host_SchedulerTask(HID_Host_Scheduler_t* const SchedulerInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** HID class driver callback for the delivery of a report received by a \ref HID_Host_Scheduler_t scheduler. This
+			 *  callback is fired by \ref HID_Host_SchedulerTask() each time a report is received from one of its interfaces, and
+			 *  may be hooked in the user program by declaring a handler function with the same name and parameters listed here.
+			 *  The default handler discards the report.
+			 *
+			 *  \param[in,out] SchedulerInfo  Pointer to a structure containing a HID scheduler configuration and state
+			 *  \param[in] InterfaceIndex  Index of the interface within the scheduler's \ref HID_Host_Scheduler_t::Config Interfaces array
+			 *  \param[in] ReportData  Pointer to a buffer containing the received report, including the report ID byte (if any)
+			 *  \param[in] ReportSize  Size in bytes of the received report
+			 */
+			void CALLBACK_HID_Host_ReportReceived(HID_Host_Scheduler_t* const SchedulerInfo, const uint8_t InterfaceIndex,
+			                                      const void* ReportData, const uint16_t ReportSize)
+			                                      ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3);
+			
 		/* Inline Functions: */
 			/** General management task for a given Human Interface Class host class interface, required for the correct operation of
 			 *  the interface. This should be called frequently in the main program loop, before the master USB management task
@@ -290,11 +350,19 @@
 			#define HID_FOUND_DATAPIPE_IN           (1 << 0)
 			#define HID_FOUND_DATAPIPE_OUT          (1 << 1)
 
+			#define HID_FRAME_NUMBER_MASK           0x07FF
+
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_HID_CLASS_HOST_C)
 				static uint8_t DComp_HID_Host_NextHIDInterface(void* const CurrentDescriptor) ATTR_NON_NULL_PTR_ARG(1);
 				static uint8_t DComp_NextHID(void* const CurrentDescriptor) ATTR_NON_NULL_PTR_ARG(1);
 				static uint8_t DComp_HID_Host_NextHIDInterfaceEndpoint(void* const CurrentDescriptor) ATTR_NON_NULL_PTR_ARG(1);
+
+				void HID_Host_Scheduler_Stub(void);
+				void CALLBACK_HID_Host_ReportReceived(HID_Host_Scheduler_t* const SchedulerInfo, const uint8_t InterfaceIndex,
+				                                      const void* ReportData, const uint16_t ReportSize)
+				                                      ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3)
+				                                      ATTR_ALIAS(HID_Host_Scheduler_Stub);
 			#endif	
 	#endif	
 	
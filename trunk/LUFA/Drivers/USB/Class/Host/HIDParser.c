@@ -32,6 +32,7 @@
 #include "../../HighLevel/USBMode.h"
 #if defined(USB_CAN_BE_HOST)
 
+#define  __INCLUDE_FROM_HIDPARSER_C
 #include "HIDParser.h"
 
 uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID_ReportInfo_t* const ParserData)
@@ -44,34 +45,67 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 	uint8_t               UsageListSize           = 0;
 	HID_MinMax_t          UsageMinMax             = {0, 0};
 
+	#if defined(HID_REPORTITEM_ARENA)
+	HID_ReportItem_t*     ArenaReportItems        = ParserData->ReportItems;
+	uint8_t               ArenaMaxReportItems     = ParserData->MaxReportItems;
+	#if defined(HID_USAGE_INDEX)
+	uint8_t*              ArenaUsageIndex         = ParserData->UsageIndex;
+	#endif
+	#endif
+
 	memset(ParserData,       0x00, sizeof(HID_ReportInfo_t));
 	memset(CurrStateTable,   0x00, sizeof(HID_StateTable_t));
 	memset(CurrReportIDInfo, 0x00, sizeof(HID_ReportSizeInfo_t));
 
 	ParserData->TotalDeviceReports = 1;	
 
+	#if defined(HID_REPORTITEM_ARENA)
+	ParserData->ReportItems        = ArenaReportItems;
+	ParserData->MaxReportItems     = ArenaMaxReportItems;
+	#if defined(HID_USAGE_INDEX)
+	ParserData->UsageIndex         = ArenaUsageIndex;
+	#endif
+	#endif
+
 	while (ReportSize)
 	{
 		uint8_t  HIDReportItem  = *ReportData;
 		uint32_t ReportItemData = 0;
+		bool     ItemDataNegative = false;
 		
 		ReportData++;
 		ReportSize--;
+
+		#if defined(HID_PARSER_STATISTICS)
+		ParserData->Statistics.TotalDescriptorItems++;
+		#endif
 		
 		switch (HIDReportItem & DATA_SIZE_MASK)
 		{
 			case DATA_SIZE_4:
+				if (ReportSize < 4)
+				  return HID_PARSE_InvalidReportDescriptor;
+
 				ReportItemData  = *((uint32_t*)ReportData);
+				ItemDataNegative = ((ReportItemData & 0x80000000) != 0);
 				ReportSize     -= 4;
 				ReportData     += 4;
 				break;
 			case DATA_SIZE_2:
+				if (ReportSize < 2)
+				  return HID_PARSE_InvalidReportDescriptor;
+
 				ReportItemData  = *((uint16_t*)ReportData);
+				ItemDataNegative = ((ReportItemData & 0x8000) != 0);
 				ReportSize     -= 2;
 				ReportData     += 2;
 				break;
 			case DATA_SIZE_1:
+				if (ReportSize < 1)
+				  return HID_PARSE_InvalidReportDescriptor;
+
 				ReportItemData  = *((uint8_t*)ReportData);
+				ItemDataNegative = ((ReportItemData & 0x80) != 0);
 				ReportSize     -= 1;
 				ReportData     += 1;
 				break;
@@ -85,21 +119,44 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 	
 				memcpy((CurrStateTable + 1),
 				       CurrStateTable,
-				       sizeof(HID_ReportItem_t));
+				       sizeof(HID_StateTable_t));
 
 				CurrStateTable++;
+
+				#if defined(HID_PARSER_STATISTICS)
+				if (ParserData->Statistics.PeakStateTableDepth < (CurrStateTable - &StateTable[0]))
+				  ParserData->Statistics.PeakStateTableDepth = (CurrStateTable - &StateTable[0]);
+				#endif
 				break;
 			case (TYPE_GLOBAL | TAG_GLOBAL_POP):
 				if (CurrStateTable == &StateTable[0])
 				  return HID_PARSE_HIDStackUnderflow;
 				  
 				CurrStateTable--;
+
+				if (ParserData->UsingReportIDs)
+				{
+					CurrReportIDInfo = NULL;
+
+					for (uint8_t i = 0; i < ParserData->TotalDeviceReports; i++)
+					{
+						if (ParserData->ReportIDSizes[i].ReportID == CurrStateTable->ReportID)
+						{
+							CurrReportIDInfo = &ParserData->ReportIDSizes[i];
+							break;
+						}
+					}
+
+					if (CurrReportIDInfo == NULL)
+					  return HID_PARSE_InvalidReportDescriptor;
+				}
 				break;
 			case (TYPE_GLOBAL | TAG_GLOBAL_USAGEPAGE):
 				CurrStateTable->Attributes.Usage.Page       = ReportItemData;
 				break;
 			case (TYPE_GLOBAL | TAG_GLOBAL_LOGICALMIN):
 				CurrStateTable->Attributes.Logical.Minimum  = ReportItemData;
+				CurrStateTable->LogicalMinNegative          = ItemDataNegative;
 				break;
 			case (TYPE_GLOBAL | TAG_GLOBAL_LOGICALMAX):
 				CurrStateTable->Attributes.Logical.Maximum  = ReportItemData;
@@ -123,6 +180,13 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 				CurrStateTable->ReportCount                 = ReportItemData;
 				break;
 			case (TYPE_GLOBAL | TAG_GLOBAL_REPORTID):
+				if (!(ReportItemData) || (!(ParserData->UsingReportIDs) && (CurrReportIDInfo->ReportSizeBits[REPORT_ITEM_TYPE_In]  ||
+				                                                             CurrReportIDInfo->ReportSizeBits[REPORT_ITEM_TYPE_Out] ||
+				                                                             CurrReportIDInfo->ReportSizeBits[REPORT_ITEM_TYPE_Feature])))
+				{
+					return HID_PARSE_InvalidReportDescriptor;
+				}
+
 				CurrStateTable->ReportID                    = ReportItemData;
 
 				if (ParserData->UsingReportIDs)
@@ -157,6 +221,11 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 				  return HID_PARSE_UsageListOverflow;
 			
 				UsageList[UsageListSize++] = ReportItemData;
+
+				#if defined(HID_PARSER_STATISTICS)
+				if (ParserData->Statistics.PeakUsageListSize < UsageListSize)
+				  ParserData->Statistics.PeakUsageListSize = UsageListSize;
+				#endif
 				break;
 			case (TYPE_LOCAL | TAG_LOCAL_USAGEMIN):
 				UsageMinMax.Minimum = ReportItemData;
@@ -165,6 +234,10 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 				UsageMinMax.Maximum = ReportItemData;
 				break;
 			case (TYPE_MAIN | TAG_MAIN_COLLECTION):
+				#if defined(HID_PARSER_STATISTICS)
+				ParserData->Statistics.TotalCollections++;
+				#endif
+
 				if (CurrCollectionPath == NULL)
 				{
 					CurrCollectionPath = &ParserData->CollectionPaths[0];
@@ -193,8 +266,8 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 				{
 					CurrCollectionPath->Usage.Usage = UsageList[0];
 
-					for (uint8_t i = 0; i < UsageListSize; i++)
-					  UsageList[i] = UsageList[i + 1];
+					for (uint8_t i = 1; i < UsageListSize; i++)
+					  UsageList[i - 1] = UsageList[i];
 					
 					UsageListSize--;
 				}
@@ -217,6 +290,10 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 				{
 					HID_ReportItem_t NewReportItem;
 				  
+					#if defined(HID_PARSER_STATISTICS)
+					ParserData->Statistics.TotalDataItems++;
+					#endif
+
 					memcpy(&NewReportItem.Attributes,
 					       &CurrStateTable->Attributes,
 					       sizeof(HID_ReportItem_Attributes_t));
@@ -229,8 +306,8 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 					{
 						NewReportItem.Attributes.Usage.Usage = UsageList[0];
 
-						for (uint8_t i = 0; i < UsageListSize; i++)
-						  UsageList[i] = UsageList[i + 1];
+						for (uint8_t i = 1; i < UsageListSize; i++)
+						  UsageList[i - 1] = UsageList[i];
 						  
 						UsageListSize--;
 					}
@@ -250,15 +327,25 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 					
 					NewReportItem.BitOffset = CurrReportIDInfo->ReportSizeBits[NewReportItem.ItemType];
 
+					if (((uint32_t)NewReportItem.BitOffset + CurrStateTable->Attributes.BitSize) > 0xFFFF)
+					  return HID_PARSE_InvalidReportDescriptor;
+
 					CurrReportIDInfo->ReportSizeBits[NewReportItem.ItemType] += CurrStateTable->Attributes.BitSize;
 
-					if (ParserData->LargestReportSizeBits < NewReportItem.BitOffset)
-					  ParserData->LargestReportSizeBits = NewReportItem.BitOffset;
+					USB_CompileHIDReportItemLayout(&NewReportItem, CurrStateTable->LogicalMinNegative);
+
+					if (ParserData->LargestReportSizeBits < CurrReportIDInfo->ReportSizeBits[NewReportItem.ItemType])
+					  ParserData->LargestReportSizeBits = CurrReportIDInfo->ReportSizeBits[NewReportItem.ItemType];
 					
 					if (!(ReportItemData & IOF_CONSTANT) && CALLBACK_HIDParser_FilterHIDReportItem(&NewReportItem))
 					{					
+						#if defined(HID_REPORTITEM_ARENA)
+						if (ParserData->TotalReportItems == ParserData->MaxReportItems)
+						  return HID_PARSE_InsufficientReportItems;
+						#else
 						if (ParserData->TotalReportItems == HID_MAX_REPORTITEMS)
 						  return HID_PARSE_InsufficientReportItems;
+						#endif
 					
 						memcpy(&ParserData->ReportItems[ParserData->TotalReportItems],
 						       &NewReportItem, sizeof(HID_ReportItem_t));
@@ -280,18 +367,164 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData, uint16_t ReportSize, HID
 	
 	if (!(ParserData->TotalReportItems))
 	  return HID_PARSE_NoUnfilteredReportItems;
+
+	#if defined(HID_USAGE_INDEX)
+	USB_BuildHIDUsageIndex(ParserData);
+	#endif
 	
 	return HID_PARSE_Successful;
 }
 
-bool USB_GetHIDReportItemInfo(const uint8_t* ReportData, HID_ReportItem_t* const ReportItem)
+static int8_t USB_CompareHIDReportItemKey(const HID_ReportItem_t* const ReportItem, const uint8_t ReportType,
+                                          const uint16_t UsagePage, const uint16_t Usage, const uint8_t ReportID)
+{
+	if (ReportItem->Attributes.Usage.Page != UsagePage)
+	  return (ReportItem->Attributes.Usage.Page < UsagePage) ? -1 : 1;
+
+	if (ReportItem->Attributes.Usage.Usage != Usage)
+	  return (ReportItem->Attributes.Usage.Usage < Usage) ? -1 : 1;
+
+	if (ReportItem->ReportID != ReportID)
+	  return (ReportItem->ReportID < ReportID) ? -1 : 1;
+
+	if (ReportItem->ItemType != ReportType)
+	  return (ReportItem->ItemType < ReportType) ? -1 : 1;
+	  
+	return 0;
+}
+
+#if defined(HID_USAGE_INDEX)
+static void USB_BuildHIDUsageIndex(HID_ReportInfo_t* const ParserData)
 {
-	uint16_t DataBitsRem  = ReportItem->Attributes.BitSize;
-	uint16_t CurrentBit   = ReportItem->BitOffset;
-	uint32_t BitMask      = (1 << 0);
+	for (uint8_t ItemIndex = 0; ItemIndex < ParserData->TotalReportItems; ItemIndex++)
+	{
+		HID_ReportItem_t* ReportItem = &ParserData->ReportItems[ItemIndex];
+		uint8_t           Position   = ItemIndex;
+
+		while (Position && (USB_CompareHIDReportItemKey(&ParserData->ReportItems[ParserData->UsageIndex[Position - 1]],
+		                                                ReportItem->ItemType, ReportItem->Attributes.Usage.Page,
+		                                                ReportItem->Attributes.Usage.Usage, ReportItem->ReportID) > 0))
+		{
+			ParserData->UsageIndex[Position] = ParserData->UsageIndex[Position - 1];
+			Position--;
+		}
+
+		ParserData->UsageIndex[Position] = ItemIndex;
+	}
+}
 
+HID_ReportItem_t* USB_FindHIDReportItem(HID_ReportInfo_t* const ParserData, const uint8_t ReportType,
+                                        const uint16_t UsagePage, const uint16_t Usage, const uint8_t ReportID)
+{
+	uint8_t Lower = 0;
+	uint8_t Upper = ParserData->TotalReportItems;
+
+	while (Lower < Upper)
+	{
+		uint8_t Middle = (Lower + ((Upper - Lower) >> 1));
+
+		if (USB_CompareHIDReportItemKey(&ParserData->ReportItems[ParserData->UsageIndex[Middle]],
+		                                ReportType, UsagePage, Usage, ReportID) < 0)
+		{
+			Lower = Middle + 1;
+		}
+		else
+		{
+			Upper = Middle;
+		}
+	}
+
+	if ((Lower == ParserData->TotalReportItems) ||
+	    USB_CompareHIDReportItemKey(&ParserData->ReportItems[ParserData->UsageIndex[Lower]],
+	                                ReportType, UsagePage, Usage, ReportID))
+	{
+		return NULL;
+	}
+
+	return &ParserData->ReportItems[ParserData->UsageIndex[Lower]];
+}
+#else
+HID_ReportItem_t* USB_FindHIDReportItem(HID_ReportInfo_t* const ParserData, const uint8_t ReportType,
+                                        const uint16_t UsagePage, const uint16_t Usage, const uint8_t ReportID)
+{
+	for (uint8_t ItemIndex = 0; ItemIndex < ParserData->TotalReportItems; ItemIndex++)
+	{
+		if (!(USB_CompareHIDReportItemKey(&ParserData->ReportItems[ItemIndex], ReportType, UsagePage, Usage, ReportID)))
+		  return &ParserData->ReportItems[ItemIndex];
+	}
+
+	return NULL;
+}
+#endif
+
+#if defined(HID_REPORTITEM_ARENA)
+void USB_SetHIDReportItemArena(HID_ReportInfo_t* const ParserData, void* Arena, const uint16_t ArenaSize)
+{
+	uint16_t MaxReportItems = (ArenaSize / HID_REPORTITEM_ARENA_SIZE(1));
+
+	if (MaxReportItems > 0xFF)
+	  MaxReportItems = 0xFF;
+
+	ParserData->ReportItems    = (HID_ReportItem_t*)Arena;
+	ParserData->MaxReportItems = MaxReportItems;
+
+	#if defined(HID_USAGE_INDEX)
+	ParserData->UsageIndex     = (uint8_t*)&ParserData->ReportItems[MaxReportItems];
+	#endif
+}
+#endif
+
+static void USB_CompileHIDReportItemLayout(HID_ReportItem_t* const ReportItem, const bool SignedData)
+{
+	HID_ReportItem_Layout_t* Layout  = &ReportItem->Layout;
+	uint8_t                  BitSize = ReportItem->Attributes.BitSize;
+
+	if (BitSize > 32)
+	  BitSize = 32;
+
+	Layout->ByteOffset = (ReportItem->BitOffset >> 3);
+	Layout->BitShift   = (ReportItem->BitOffset & 0x07);
+	Layout->TotalBytes = ((Layout->BitShift + BitSize + 7) >> 3);
+	Layout->Mask       = (BitSize == 32) ? 0xFFFFFFFF : (((uint32_t)1 << BitSize) - 1);
+	Layout->SignExtend = (SignedData && BitSize && (BitSize < 32));
+}
+
+static uint32_t USB_ExtractHIDReportItemValue(const uint8_t* ReportData, const HID_ReportItem_t* const ReportItem)
+{
+	const HID_ReportItem_Layout_t* Layout = &ReportItem->Layout;
+	uint32_t                       Value  = 0;
+
+	ReportData += Layout->ByteOffset;
+
+	switch (Layout->TotalBytes)
+	{
+		case 5:
+		case 4:
+			Value |= ((uint32_t)ReportData[3] << 24);
+		case 3:
+			Value |= ((uint32_t)ReportData[2] << 16);
+		case 2:
+			Value |= ((uint32_t)ReportData[1] << 8);
+		case 1:
+			Value |= ReportData[0];
+	}
+
+	Value >>= Layout->BitShift;
+
+	if (Layout->TotalBytes == 5)
+	  Value |= ((uint32_t)ReportData[4] << (32 - Layout->BitShift));
+
+	Value &= Layout->Mask;
+
+	if (Layout->SignExtend && (Value & ((Layout->Mask >> 1) + 1)))
+	  Value |= ~(Layout->Mask);
+
+	return Value;
+}
+
+bool USB_GetHIDReportItemInfo(const uint8_t* ReportData, HID_ReportItem_t* const ReportItem)
+{
 	ReportItem->PreviousValue = ReportItem->Value;
-	ReportItem->Value = 0;
 	
 	if (ReportItem->ReportID)
 	{
@@ -301,23 +534,16 @@ bool USB_GetHIDReportItemInfo(const uint8_t* ReportData, HID_ReportItem_t* const
 		ReportData++;
 	}
 
-	while (DataBitsRem--)
-	{
-		if (ReportData[CurrentBit / 8] & (1 << (CurrentBit % 8)))
-		  ReportItem->Value |= BitMask;
-		
-		CurrentBit++;
-		BitMask <<= 1;
-	}
+	ReportItem->Value = USB_ExtractHIDReportItemValue(ReportData, ReportItem);
 	
 	return true;
 }
 
 void USB_SetHIDReportItemInfo(uint8_t* ReportData, HID_ReportItem_t* const ReportItem)
 {
-	uint16_t DataBitsRem  = ReportItem->Attributes.BitSize;
-	uint16_t CurrentBit   = ReportItem->BitOffset;
-	uint32_t BitMask      = (1 << 0);
+	HID_ReportItem_Layout_t* Layout   = &ReportItem->Layout;
+	uint32_t                 Value    = (ReportItem->Value & Layout->Mask);
+	uint8_t                  BytesRem = Layout->TotalBytes;
 
 	if (ReportItem->ReportID)
 	{
@@ -327,14 +553,42 @@ void USB_SetHIDReportItemInfo(uint8_t* ReportData, HID_ReportItem_t* const Repor
 
 	ReportItem->PreviousValue = ReportItem->Value;
 
-	while (DataBitsRem--)
+	if (!(BytesRem))
+	  return;
+
+	ReportData += Layout->ByteOffset;
+
+	*(ReportData++) |= (uint8_t)(Value << Layout->BitShift);
+	Value >>= (8 - Layout->BitShift);
+
+	while (--BytesRem)
 	{
-		if (ReportItem->Value & (1 << (CurrentBit % 8)))
-		  ReportData[CurrentBit / 8] |= BitMask;
+		*(ReportData++) |= (uint8_t)Value;
+		Value >>= 8;
+	}
+}
 
-		CurrentBit++;
-		BitMask <<= 1;
+uint8_t USB_DecodeHIDReport(const uint8_t* ReportData, HID_ReportInfo_t* const ParserData, const uint8_t ReportType)
+{
+	uint8_t ItemsDecoded = 0;
+	uint8_t ReportID     = (ParserData->UsingReportIDs) ? ReportData[0] : 0;
+
+	if (ReportID)
+	  ReportData++;
+
+	for (uint8_t ItemIndex = 0; ItemIndex < ParserData->TotalReportItems; ItemIndex++)
+	{
+		HID_ReportItem_t* ReportItem = &ParserData->ReportItems[ItemIndex];
+
+		if ((ReportItem->ItemType != ReportType) || (ReportItem->ReportID != ReportID))
+		  continue;
+
+		ReportItem->PreviousValue = ReportItem->Value;
+		ReportItem->Value         = USB_ExtractHIDReportItemValue(ReportData, ReportItem);
+		ItemsDecoded++;
 	}
+
+	return ItemsDecoded;
 }
 
 uint16_t USB_GetHIDReportSize(HID_ReportInfo_t* const ParserData, const uint8_t ReportID, const uint8_t ReportType)
@@ -129,6 +129,20 @@
 			#define HID_MAX_REPORT_IDS            10
 		#endif
 
+		#if defined(HID_USAGE_INDEX) || defined(__DOXYGEN__)
+			/** Computes the size in bytes of a report item arena which can hold the given number of report items, for use
+			 *  with \ref USB_SetHIDReportItemArena() when the HID_REPORTITEM_ARENA token is defined. When the HID_USAGE_INDEX
+			 *  token is also defined, the arena includes one byte per report item for the usage index.
+			 *
+			 *  \param[in] totalitems  Maximum number of report items to store into the arena
+			 *
+			 *  \return Size in bytes of an arena capable of holding the given number of report items and their usage index
+			 */
+			#define HID_REPORTITEM_ARENA_SIZE(totalitems) ((totalitems) * (sizeof(HID_ReportItem_t) + sizeof(uint8_t)))
+		#else
+			#define HID_REPORTITEM_ARENA_SIZE(totalitems) ((totalitems) * sizeof(HID_ReportItem_t))
+		#endif
+
 		/** Returns the value a given HID report item (once its value has been fetched via \ref USB_GetHIDReportItemInfo())
 		 *  left-aligned to the given data type. This allows for signed data to be interpreted correctly, by shifting the data
 		 *  leftwards until the data's sign bit is in the correct position.
@@ -154,6 +168,9 @@
 				HID_PARSE_UsageListOverflow           = 6, /**< More than \ref HID_USAGE_STACK_DEPTH usages listed in a row. */
 				HID_PARSE_InsufficientReportIDItems   = 7, /**< More than \ref HID_MAX_REPORT_IDS report IDs in the device. */
 				HID_PARSE_NoUnfilteredReportItems     = 8, /**< All report items from the device were filtered by the filtering callback routine. */
+				HID_PARSE_InvalidReportDescriptor     = 9, /**< The report descriptor is malformed; it ends part way through an item, uses a report ID of zero,
+				                                            *   declares its first report ID after report data items, POPs back to a state without a report ID, or describes a report of more than 65535 bits.
+				                                            */
 			};
 		
 		/* Type Defines: */		
@@ -213,6 +230,25 @@
 				HID_MinMax_t                 Physical; /**< Physical minimum and maximum of the report item. */
 			} HID_ReportItem_Attributes_t;
 			
+			/** \brief HID Parser Report Item Layout Structure.
+			 *
+			 *  Type define for the pre-computed location of a report item's data within a HID report, generated by the
+			 *  parser for each report item so that the item's value can be extracted from or inserted into a report a byte
+			 *  at a time, rather than a bit at a time.
+			 */
+			typedef struct
+			{
+				uint16_t                     ByteOffset; /**< Offset in bytes of the first report byte containing the item's data,
+				                                          *   excluding the report ID byte (if any).
+				                                          */
+				uint8_t                      BitShift;   /**< Bit position of the item's least significant bit within the first byte. */
+				uint8_t                      TotalBytes; /**< Total number of report bytes spanned by the item's data. */
+				uint32_t                     Mask;       /**< Mask of the item's data bits once shifted down to bit zero. */
+				bool                         SignExtend; /**< Indicates if the item's data is signed (i.e. the item's logical minimum
+				                                          *   is negative) and should be sign-extended to 32 bits once extracted.
+				                                          */
+			} HID_ReportItem_Layout_t;
+
 			/** \brief HID Parser Report Item Details Structure.
 			 *
 			 *  Type define for a report item (IN, OUT or FEATURE) layout attributes and other details.
@@ -226,6 +262,7 @@
 				HID_CollectionPath_t*        CollectionPath; /**< Collection path of the item. */
 
 				HID_ReportItem_Attributes_t  Attributes;     /**< Report item attributes. */
+				HID_ReportItem_Layout_t      Layout;         /**< Pre-computed layout of the item's data within its report. */
 							
 				uint32_t                     Value;          /**< Current value of the report item - use \ref HID_ALIGN_DATA() when processing
 				                                              *   a retrieved value so that it is aligned to a specific type.
@@ -245,6 +282,25 @@
 																 */
 			} HID_ReportSizeInfo_t;
 
+			/** \brief HID Parser Statistics Structure.
+			 *
+			 *  Type define for the resource usage statistics gathered by the parser while processing a device's HID report
+			 *  descriptor, so that the HID_MAX_* and HID_*_STACK_DEPTH limits may be tuned to the devices an application
+			 *  must support.
+			 *
+			 *  \note This structure is only present in the parser output when the HID_PARSER_STATISTICS token is defined.
+			 */
+			typedef struct
+			{
+				uint16_t                     TotalDescriptorItems; /**< Total number of items (of all types) in the report descriptor. */
+				uint16_t                     TotalDataItems; /**< Total number of IN, OUT and FEATURE report items in the descriptor,
+				                                              *   including constant and filtered items.
+				                                              */
+				uint8_t                      TotalCollections; /**< Total number of COLLECTION items in the descriptor. */
+				uint8_t                      PeakStateTableDepth; /**< Deepest PUSH nesting level reached while parsing. */
+				uint8_t                      PeakUsageListSize; /**< Largest number of USAGE items stacked before a main item. */
+			} HID_ParserStatistics_t;
+
 			/** \brief HID Parser State Structure.
 			 *
 			 *  Type define for a complete processed HID report, including all report item data and collections.
@@ -254,9 +310,26 @@
 				uint8_t                      TotalReportItems; /**< Total number of report items stored in the
 				                                                *   ReportItems array.
 				                                                */
+				#if !defined(HID_REPORTITEM_ARENA) || defined(__DOXYGEN__)
 				HID_ReportItem_t             ReportItems[HID_MAX_REPORTITEMS]; /**< Report items array, including
 			                                                                    *   all IN, OUT and FEATURE items.
 				                                                                */
+				#if defined(HID_USAGE_INDEX) || defined(__DOXYGEN__)
+				uint8_t                      UsageIndex[HID_MAX_REPORTITEMS]; /**< Indexes into the ReportItems array, sorted
+				                                                               *   by usage page, usage, report ID and item type
+				                                                               *   for \ref USB_FindHIDReportItem().
+				                                                               *
+				                                                               *   \note This element is only present when the
+				                                                               *         HID_USAGE_INDEX token is defined.
+				                                                               */
+				#endif
+				#else
+				HID_ReportItem_t*            ReportItems; /**< Report items array within the user supplied arena. */
+				#if defined(HID_USAGE_INDEX)
+				uint8_t*                     UsageIndex; /**< Sorted report item index array within the user supplied arena. */
+				#endif
+				uint8_t                      MaxReportItems; /**< Maximum number of report items which fit into the arena. */
+				#endif
 				HID_CollectionPath_t         CollectionPaths[HID_MAX_COLLECTIONS]; /**< All collection items, referenced
 				                                                                    *   by the report items.
 				                                                                    */
@@ -266,6 +339,13 @@
 				bool                         UsingReportIDs; /**< Indicates if the device has at least one REPORT ID
 				                                              *   element in its HID report descriptor.
 				                                              */
+				#if defined(HID_PARSER_STATISTICS) || defined(__DOXYGEN__)
+				HID_ParserStatistics_t       Statistics; /**< Resource usage statistics of the last parsed descriptor.
+				                                          *
+				                                          *   \note This element is only present when the HID_PARSER_STATISTICS
+				                                          *         token is defined.
+				                                          */
+				#endif
 			} HID_ReportInfo_t;
 			
 		/* Function Prototypes: */
@@ -285,7 +365,8 @@
 			 *  member of the report item's \ref HID_ReportItem_t structure.
 			 *
 			 *  When called, this copies the report item's Value element to it's PreviousValue element for easy
-			 *  checking to see if an item's value has changed before processing a report.
+			 *  checking to see if an item's value has changed before processing a report. Items with a negative
+			 *  logical minimum are sign-extended to 32 bits.
 			 *
 			 *  \param[in] ReportData  Buffer containing an IN or FEATURE report from an attached device
 			 *  \param[in,out] ReportItem  Pointer to the report item of interest in a \ref HID_ReportInfo_t ReportItem array
@@ -311,6 +392,55 @@
 			void USB_SetHIDReportItemInfo(uint8_t* ReportData, HID_ReportItem_t* const ReportItem)
 			                              ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 										  
+			/** Extracts the values of all the report items of the given type contained in the given HID report in a single
+			 *  pass, placing each into the Value member of the report item's \ref HID_ReportItem_t structure. This is equivalent
+			 *  to calling \ref USB_GetHIDReportItemInfo() on each report item of the given type in the report's report ID, but
+			 *  avoids the need for the application to search the report item list for matching items.
+			 *
+			 *  \param[in] ReportData  Buffer containing an IN or FEATURE report from an attached device
+			 *  \param[in,out] ParserData  Pointer to a \ref HID_ReportInfo_t instance containing the parser output
+			 *  \param[in] ReportType  Type of the given report, a value from the \ref HID_ReportItemTypes_t enum
+			 *
+			 *  \return Number of report items whose values were extracted from the given report
+			 */
+			uint8_t USB_DecodeHIDReport(const uint8_t* ReportData, HID_ReportInfo_t* const ParserData, const uint8_t ReportType)
+			                            ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Locates a report item by its usage and report ID. When the HID_USAGE_INDEX token is defined, the sorted usage
+			 *  index built by the parser is searched so that the report item array does not need to be searched linearly;
+			 *  otherwise the report item array is searched in order. If several report items share the same usage, report ID
+			 *  and type (such as the key code array items of a keyboard report) the first is returned, and the remainder can
+			 *  be located via the ReportItems array.
+			 *
+			 *  \param[in] ParserData  Pointer to a \ref HID_ReportInfo_t instance containing the parser output
+			 *  \param[in] ReportType  Type of the report item to find, a value from the \ref HID_ReportItemTypes_t enum
+			 *  \param[in] UsagePage   Usage page of the report item to find
+			 *  \param[in] Usage       Usage of the report item to find
+			 *  \param[in] ReportID    Report ID of the report item to find, or 0x00 if the device has only one report
+			 *
+			 *  \return Pointer to the matching report item, or NULL if no stored report item matches
+			 */
+			HID_ReportItem_t* USB_FindHIDReportItem(HID_ReportInfo_t* const ParserData, const uint8_t ReportType,
+			                                        const uint16_t UsagePage, const uint16_t Usage,
+			                                        const uint8_t ReportID) ATTR_NON_NULL_PTR_ARG(1);
+
+			#if defined(HID_REPORTITEM_ARENA) || defined(__DOXYGEN__)
+			/** Assigns a user supplied arena to a \ref HID_ReportInfo_t instance, into which the parser will store the
+			 *  processed report items and (if enabled) their usage index. This allows the report item storage to be sized to the descriptors
+			 *  of the devices the application expects, rather than to the fixed \ref HID_MAX_REPORTITEMS worst case. The arena
+			 *  must remain valid for as long as the parser output is in use, and must be assigned before the first call to
+			 *  \ref USB_ProcessHIDReport(); it is retained between subsequent calls.
+			 *
+			 *  \note This function is only available when the HID_REPORTITEM_ARENA token is defined.
+			 *
+			 *  \param[out] ParserData  Pointer to a \ref HID_ReportInfo_t instance to assign the arena to
+			 *  \param[in] Arena  Pointer to the arena memory, which must be suitably aligned for a \ref HID_ReportItem_t
+			 *  \param[in] ArenaSize  Size of the arena in bytes, see \ref HID_REPORTITEM_ARENA_SIZE()
+			 */
+			void USB_SetHIDReportItemArena(HID_ReportInfo_t* const ParserData, void* Arena, const uint16_t ArenaSize)
+			                               ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+			#endif
+
 			/** Retrieves the size of a given HID report in bytes from it's Report ID.
 			 *
 			 *  \param[in] ParserData  Pointer to a \ref HID_ReportInfo_t instance containing the parser output
@@ -342,7 +472,22 @@
 				 HID_ReportItem_Attributes_t Attributes;
 				 uint8_t                     ReportCount;
 				 uint8_t                     ReportID;
+				 bool                        LogicalMinNegative;
 			} HID_StateTable_t;
+
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_HIDPARSER_C)
+				static void USB_CompileHIDReportItemLayout(HID_ReportItem_t* const ReportItem, const bool SignedData)
+				                                           ATTR_NON_NULL_PTR_ARG(1);
+				#if defined(HID_USAGE_INDEX)
+				static void USB_BuildHIDUsageIndex(HID_ReportInfo_t* const ParserData) ATTR_NON_NULL_PTR_ARG(1);
+				#endif
+				static int8_t USB_CompareHIDReportItemKey(const HID_ReportItem_t* const ReportItem, const uint8_t ReportType,
+				                                          const uint16_t UsagePage, const uint16_t Usage,
+				                                          const uint8_t ReportID) ATTR_NON_NULL_PTR_ARG(1);
+				static uint32_t USB_ExtractHIDReportItemValue(const uint8_t* ReportData, const HID_ReportItem_t* const ReportItem)
+				                                              ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+			#endif
 	#endif
 			
 	/* Disable C linkage for C++ Compilers: */
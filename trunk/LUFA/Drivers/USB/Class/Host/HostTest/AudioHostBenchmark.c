@@ -0,0 +1,580 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host benchmark for the playback stream of the Audio host class driver. The driver is built for the host machine
+ *  against a simulated USB bus and Audio device (see AudioHostShim.h), which enumerates a single playback stream and
+ *  optionally an asynchronous feedback endpoint. Each scenario then runs the driver for a fixed number of USB frames,
+ *  with the application servicing the stream a set number of times per frame and occasionally stalling, and reports
+ *  the delivered sample rate, the packet sizes, the USB frames in which no packet was sent, and the fill level range
+ *  (jitter) of the device's sample buffer as it plays the stream out at its own clock rate.
+ *
+ *  The final scenario repeatedly stops and restarts the stream part way through a packet, and fails the benchmark if
+ *  a packet ever exceeds the pipe size or does not hold the number of frames due. Host CPU times are only useful when
+ *  comparing driver changes against each other; all other figures are exact. Build and run with "make audio" in this
+ *  directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define  __INCLUDE_FROM_AUDIO_DRIVER
+#include "../Audio.h"
+
+/** Number of USB frames (milliseconds) each scenario is run for. */
+#define SIMULATION_FRAMES      60000
+
+/** Number of sample frames the application generates at once, as a block of the test tone in the host demos. */
+#define SOURCE_BLOCK_FRAMES    32
+
+/** Number of milliseconds of audio the simulated device buffers before it starts playing the stream out. */
+#define DEVICE_PREFILL_MS      2
+
+/** Interval in USB frames between the values sent by the simulated device's feedback endpoint. */
+#define FEEDBACK_INTERVAL      8
+
+/** Pipe numbers used for the simulated playback stream. */
+#define DATA_OUT_PIPE          1
+#define FEEDBACK_PIPE          2
+
+/** Number of pipes modelled by the simulated USB bus. */
+#define TOTAL_PIPES            3
+
+/** Type define for a simulated pipe of the USB bus. */
+typedef struct
+{
+	uint16_t Size; /**< Size in bytes of each bank of the pipe */
+	uint8_t  Banks; /**< Number of banks of the pipe */
+	bool     Frozen; /**< Indicates if the pipe is currently frozen */
+	uint16_t BytesInBank; /**< Number of bytes written to or remaining in the current bank */
+	uint8_t  BanksQueued; /**< Number of OUT banks sent by the application but not yet taken by the bus */
+	uint16_t QueuedBytes[2]; /**< Sizes of the queued OUT banks, oldest first */
+	uint8_t  INData[4]; /**< Contents of a received IN packet */
+	bool     INReceived; /**< Indicates if an IN packet has been received and not yet cleared */
+} SimPipe_t;
+
+/** Type define for a benchmark scenario. */
+typedef struct
+{
+	const char* Name; /**< Name of the scenario */
+	uint32_t    SampleFrequency; /**< Nominal sample rate of the stream in Hz */
+	bool        Feedback; /**< Indicates if the device has an asynchronous feedback endpoint */
+	int16_t     DevicePPM; /**< Deviation of the device's clock from the nominal sample rate, in parts per million */
+	uint8_t     ServiceCalls; /**< Number of times the application services the stream in each USB frame */
+	uint16_t    StallChance; /**< Chance in 10000 of the application stalling in each USB frame */
+	uint8_t     MaxStallFrames; /**< Maximum length in USB frames of an application stall */
+	uint16_t    RestartInterval; /**< Maximum interval in USB frames between stream restarts, or zero for none */
+} Scenario_t;
+
+/** Results gathered while running a scenario. */
+typedef struct
+{
+	uint32_t FramesSent; /**< Total sample frames sent over the bus */
+	uint32_t Packets; /**< Total packets sent over the bus */
+	uint16_t MinPacketFrames; /**< Smallest packet sent, in sample frames */
+	uint16_t MaxPacketFrames; /**< Largest packet sent, in sample frames */
+	uint32_t MissedFrames; /**< USB frames in which the stream was running but no packet was sent */
+	double   Underflows; /**< Sample frames the device had to play while its buffer was empty */
+	double   MinBufferLevel; /**< Lowest device buffer level after the prefill, in sample frames */
+	double   MaxBufferLevel; /**< Highest device buffer level after the prefill, in sample frames */
+	uint32_t Restarts; /**< Number of stream restarts */
+	uint32_t Errors; /**< Number of oversized or wrongly sized packets, and writes beyond the end of a bank */
+	uint64_t WriteCalls; /**< Number of calls made to \ref Audio_Host_WriteSampleFrames() */
+	uint64_t WriteTimeNS; /**< Total host time spent in \ref Audio_Host_WriteSampleFrames() */
+} Results_t;
+
+USB_Request_Header_t USB_ControlRequest;
+volatile uint8_t     USB_HostState;
+
+/** Simulated pipes of the USB bus. */
+static SimPipe_t Pipes[TOTAL_PIPES];
+
+/** Currently selected simulated pipe. */
+static SimPipe_t* SelectedPipe = &Pipes[PIPE_CONTROLPIPE];
+
+/** Number of write errors (writes beyond the end of a bank) seen by the simulated bus. */
+static uint32_t BankOverflows;
+
+/** Alternate setting of the playback interface selected by the last SET INTERFACE request. */
+static uint8_t DeviceAltSetting;
+
+/** Configuration descriptor of the simulated device, built for each scenario. */
+static uint8_t ConfigDescriptor[128];
+
+/** Benchmark scenarios, run in order. */
+static const Scenario_t Scenarios[] =
+	{
+		{"48kHz ideal",         48000, false,    0, 4,   0, 0,   0},
+		{"44.1kHz ideal",       44100, false,    0, 4,   0, 0,   0},
+		{"44.1kHz +200ppm",     44100, false,  200, 4,   0, 0,   0},
+		{"44.1kHz +200ppm fb",  44100, true,   200, 4,   0, 0,   0},
+		{"48kHz -500ppm fb",    48000, true,  -500, 4,   0, 0,   0},
+		{"48kHz 1 call/frame",  48000, false,    0, 1,   0, 0,   0},
+		{"48kHz stall 2ms",     48000, false,    0, 4, 100, 2,   0},
+		{"48kHz stall 4ms",     48000, false,    0, 4, 100, 4,   0},
+		{"44.1kHz fb restart",  44100, true,   200, 4, 100, 2, 100},
+	};
+
+/** Returns a monotonic timestamp, in nanoseconds.
+ *
+ *  \return Current time in nanoseconds
+ */
+static uint64_t GetTimeNS(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (((uint64_t)Now.tv_sec * 1000000000ULL) + Now.tv_nsec);
+}
+
+/** Simulated version of the library's descriptor search routine, see ConfigDescriptor.c. */
+uint8_t USB_GetNextDescriptorComp(uint16_t* BytesRem, void** CurrConfigLoc, ConfigComparatorPtr_t ComparatorRoutine)
+{
+	uint8_t ErrorCode;
+
+	while (*BytesRem)
+	{
+		uint8_t*  PrevDescLoc  = *CurrConfigLoc;
+		uint16_t  PrevBytesRem = *BytesRem;
+		uint16_t  CurrDescriptorSize = DESCRIPTOR_PCAST(*CurrConfigLoc, USB_Descriptor_Header_t)->Size;
+
+		*CurrConfigLoc = ((uint8_t*)*CurrConfigLoc + CurrDescriptorSize);
+		*BytesRem     -= CurrDescriptorSize;
+
+		if ((ErrorCode = ComparatorRoutine(*CurrConfigLoc)) != DESCRIPTOR_SEARCH_NotFound)
+		{
+			if (ErrorCode == DESCRIPTOR_SEARCH_Fail)
+			{
+				*CurrConfigLoc = PrevDescLoc;
+				*BytesRem      = PrevBytesRem;
+			}
+
+			return ErrorCode;
+		}
+	}
+
+	return DESCRIPTOR_SEARCH_COMP_EndOfDescriptor;
+}
+
+/** Simulated control transfer, recording the alternate setting selected on the playback interface. All requests
+ *  are accepted by the simulated device.
+ *
+ *  \param[in] BufferPtr  Pointer to the data stage buffer of the request (unused)
+ *
+ *  \return A value from the \ref USB_Host_SendControlErrorCodes_t enum
+ */
+uint8_t USB_Host_SendControlRequest(void* BufferPtr)
+{
+	if (USB_ControlRequest.bRequest == REQ_SetInterface)
+	  DeviceAltSetting = USB_ControlRequest.wValue;
+
+	return HOST_SENDCONTROL_Successful;
+}
+
+/* Simulated pipe interface of the USB bus, in place of the AVR pipe driver (see LowLevel/Pipe.h): */
+bool Pipe_ConfigurePipe(const uint8_t Number, const uint8_t Type, const uint8_t Token, const uint8_t EndpointNumber,
+                        const uint16_t Size, const uint8_t Banks)
+{
+	if ((Number >= TOTAL_PIPES) || (Size > 256))
+	  return false;
+
+	Pipes[Number] = (SimPipe_t)
+		{
+			.Size   = Size,
+			.Banks  = ((Banks & PIPE_BANK_DOUBLE) ? 2 : 1),
+			.Frozen = true,
+		};
+
+	return true;
+}
+
+void Pipe_SelectPipe(const uint8_t PipeNumber)
+{
+	SelectedPipe = &Pipes[PipeNumber];
+}
+
+void Pipe_ResetPipe(const uint8_t PipeNumber)
+{
+	Pipes[PipeNumber].BytesInBank = 0;
+	Pipes[PipeNumber].BanksQueued = 0;
+	Pipes[PipeNumber].INReceived  = false;
+}
+
+void Pipe_Freeze(void)
+{
+	SelectedPipe->Frozen = true;
+}
+
+void Pipe_Unfreeze(void)
+{
+	SelectedPipe->Frozen = false;
+}
+
+bool Pipe_IsINReceived(void)
+{
+	return SelectedPipe->INReceived;
+}
+
+bool Pipe_IsOUTReady(void)
+{
+	return (SelectedPipe->BanksQueued < SelectedPipe->Banks);
+}
+
+uint16_t Pipe_BytesInPipe(void)
+{
+	return SelectedPipe->BytesInBank;
+}
+
+uint8_t Pipe_Read_Byte(void)
+{
+	if (!(SelectedPipe->BytesInBank))
+	  return 0;
+
+	return SelectedPipe->INData[3 - SelectedPipe->BytesInBank--];
+}
+
+void Pipe_Write_Byte(const uint8_t Byte)
+{
+	if (SelectedPipe->BytesInBank < SelectedPipe->Size)
+	  SelectedPipe->BytesInBank++;
+	else
+	  BankOverflows++;
+}
+
+void Pipe_ClearIN(void)
+{
+	SelectedPipe->INReceived  = false;
+	SelectedPipe->BytesInBank = 0;
+}
+
+void Pipe_ClearOUT(void)
+{
+	if (SelectedPipe->BanksQueued < SelectedPipe->Banks)
+	  SelectedPipe->QueuedBytes[SelectedPipe->BanksQueued++] = SelectedPipe->BytesInBank;
+
+	SelectedPipe->BytesInBank = 0;
+}
+
+/** Appends a descriptor to the simulated device's configuration descriptor.
+ *
+ *  \param[in] Length      Current length of the configuration descriptor in bytes
+ *  \param[in] Descriptor  Pointer to the descriptor to append
+ *  \param[in] Size        Size of the descriptor in bytes
+ *
+ *  \return New length of the configuration descriptor in bytes
+ */
+static uint16_t AppendDescriptor(const uint16_t Length, const uint8_t* const Descriptor, const uint8_t Size)
+{
+	memcpy(&ConfigDescriptor[Length], Descriptor, Size);
+	return (Length + Size);
+}
+
+/** Builds the configuration descriptor of the simulated device, with an Audio Control interface and a playback Audio
+ *  Streaming interface carrying 16-bit stereo PCM audio at the scenario's sample rate.
+ *
+ *  \param[in] Scenario  Scenario to build the descriptor for
+ *
+ *  \return Total size of the built configuration descriptor in bytes
+ */
+static uint16_t BuildConfigDescriptor(const Scenario_t* const Scenario)
+{
+	uint32_t Frequency    = Scenario->SampleFrequency;
+	uint16_t EndpointSize = ((((Frequency + 999) / 1000) + 1) * 4);
+	uint16_t Length       = 0;
+
+	const uint8_t Configuration[] = {9, DTYPE_Configuration, 0, 0, 2, 1, 0, 0x80, 50};
+	const uint8_t Control[]       = {9, DTYPE_Interface, 0, 0, 0, AUDIO_CONTROL_CLASS, AUDIO_CONTROL_SUBCLASS, 0, 0};
+	const uint8_t StreamingAlt0[] = {9, DTYPE_Interface, 1, 0, 0, AUDIO_STREAMING_CLASS, AUDIO_STREAMING_SUBCLASS, 0, 0};
+	const uint8_t StreamingAlt1[] = {9, DTYPE_Interface, 1, 1, (Scenario->Feedback ? 2 : 1), AUDIO_STREAMING_CLASS,
+	                                 AUDIO_STREAMING_SUBCLASS, 0, 0};
+	const uint8_t General[]       = {7, DTYPE_AudioInterface, DSUBTYPE_General, 1, 1, AUDIO_FORMAT_PCM, 0};
+	const uint8_t Format[]        = {11, DTYPE_AudioInterface, DSUBTYPE_Format, AUDIO_FORMAT_TYPE_I, 2, 2, 16, 1,
+	                                 (Frequency & 0xFF), ((Frequency >> 8) & 0xFF), ((Frequency >> 16) & 0xFF)};
+	const uint8_t DataEndpoint[]  = {9, DTYPE_Endpoint, 0x01, (Scenario->Feedback ? 0x05 : 0x0D),
+	                                 (EndpointSize & 0xFF), (EndpointSize >> 8), 1, 0, (Scenario->Feedback ? 0x82 : 0)};
+	const uint8_t DataSpecific[]  = {7, DTYPE_AudioEndpoint, DSUBTYPE_General, AUDIO_EPATTR_SamplingFreq, 0, 0, 0};
+	const uint8_t FeedbackEP[]    = {9, DTYPE_Endpoint, 0x82, (0x01 | ENDPOINT_USAGE_FEEDBACK), AUDIO_FEEDBACK_EPSIZE, 0,
+	                                 1, 3, 0};
+
+	Length = AppendDescriptor(Length, Configuration, sizeof(Configuration));
+	Length = AppendDescriptor(Length, Control, sizeof(Control));
+	Length = AppendDescriptor(Length, StreamingAlt0, sizeof(StreamingAlt0));
+	Length = AppendDescriptor(Length, StreamingAlt1, sizeof(StreamingAlt1));
+	Length = AppendDescriptor(Length, General, sizeof(General));
+	Length = AppendDescriptor(Length, Format, sizeof(Format));
+	Length = AppendDescriptor(Length, DataEndpoint, sizeof(DataEndpoint));
+	Length = AppendDescriptor(Length, DataSpecific, sizeof(DataSpecific));
+
+	if (Scenario->Feedback)
+	  Length = AppendDescriptor(Length, FeedbackEP, sizeof(FeedbackEP));
+
+	ConfigDescriptor[2] = (Length & 0xFF);
+	ConfigDescriptor[3] = (Length >> 8);
+
+	return Length;
+}
+
+/** Services the playback stream once, as the application's main loop would, sending as much of the current block of
+ *  the source as the driver will accept.
+ *
+ *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state
+ *  \param[in,out] Results             Results of the running scenario
+ */
+static void ServiceStream(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo, Results_t* const Results)
+{
+	static uint32_t SourceBlock[SOURCE_BLOCK_FRAMES];
+	static uint8_t  SourcePending;
+
+	Audio_Host_USBTask(AudioInterfaceInfo);
+
+	if (!(SourcePending))
+	  SourcePending = SOURCE_BLOCK_FRAMES;
+
+	uint64_t Start      = GetTimeNS();
+	uint16_t FramesSent = Audio_Host_WriteSampleFrames(AudioInterfaceInfo,
+	                                                   &SourceBlock[SOURCE_BLOCK_FRAMES - SourcePending], SourcePending);
+
+	Results->WriteTimeNS += (GetTimeNS() - Start);
+	Results->WriteCalls++;
+
+	SourcePending -= FramesSent;
+}
+
+/** Runs a single scenario over the simulated bus and device.
+ *
+ *  \param[in]  Scenario  Scenario to run
+ *  \param[out] Results   Results of the scenario
+ *
+ *  \return Boolean true if the driver enumerated and started the stream, false otherwise
+ */
+static bool RunScenario(const Scenario_t* const Scenario, Results_t* const Results)
+{
+	uint16_t ConfigDescriptorSize = BuildConfigDescriptor(Scenario);
+
+	memset(Results, 0x00, sizeof(Results_t));
+	memset(Pipes, 0x00, sizeof(Pipes));
+	BankOverflows    = 0;
+	DeviceAltSetting = 0;
+	USB_HostState    = HOST_STATE_Configured;
+	srand(1);
+
+	USB_ClassInfo_Audio_Host_t Speaker_Audio_Interface =
+		{
+			.Config =
+				{
+					.DataINPipeNumber    = 0,
+					.DataOUTPipeNumber   = DATA_OUT_PIPE,
+					.FeedbackPipeNumber  = FEEDBACK_PIPE,
+
+					.DataOUTFormat       =
+						{
+							.Channels        = 2,
+							.SubFrameSize    = 2,
+							.BitResolution   = 16,
+							.SampleFrequency = Scenario->SampleFrequency,
+						},
+				},
+		};
+
+	if ((Audio_Host_ConfigurePipes(&Speaker_Audio_Interface, ConfigDescriptorSize, ConfigDescriptor) != AUDIO_ENUMERROR_NoError) ||
+	    (Scenario->Feedback && !(Speaker_Audio_Interface.State.FeedbackPipeActive)))
+	{
+		return false;
+	}
+
+	if (Audio_Host_StartStopStreaming(&Speaker_Audio_Interface, true) != HOST_SENDCONTROL_Successful)
+	  return false;
+
+	double   DeviceRate     = (Scenario->SampleFrequency * (1.0 + (Scenario->DevicePPM / 1000000.0)));
+	double   BufferLevel    = 0;
+	double   FeedbackValue  = ((DeviceRate / 1000) * (1UL << 14));
+	bool     Playing        = false;
+	uint16_t StallFrames    = 0;
+	uint16_t RestartFrames  = (Scenario->RestartInterval ? ((rand() % Scenario->RestartInterval) + 1) : 0);
+	uint32_t DueFraction    = 0;
+	uint16_t FrameSize      = Speaker_Audio_Interface.State.DataOUTFrameSize;
+
+	Results->MinPacketFrames = 0xFFFF;
+	Results->MinBufferLevel  = 1e9;
+	Results->MaxBufferLevel  = 0;
+
+	for (uint32_t USBFrame = 0; USBFrame < SIMULATION_FRAMES; USBFrame++)
+	{
+		SimPipe_t* DataPipe     = &Pipes[DATA_OUT_PIPE];
+		SimPipe_t* FeedbackPipe = &Pipes[FEEDBACK_PIPE];
+
+		/* The device sends its actual sample rate on its feedback endpoint at a fixed interval */
+		if (Scenario->Feedback && !(FeedbackPipe->Frozen) && !(USBFrame % FEEDBACK_INTERVAL))
+		{
+			uint32_t Value = (uint32_t)FeedbackValue;
+
+			FeedbackPipe->INData[0]   = (Value & 0xFF);
+			FeedbackPipe->INData[1]   = ((Value >> 8) & 0xFF);
+			FeedbackPipe->INData[2]   = ((Value >> 16) & 0xFF);
+			FeedbackPipe->BytesInBank = AUDIO_FEEDBACK_EPSIZE;
+			FeedbackPipe->INReceived  = true;
+		}
+
+		/* The application services the stream, unless it is stalled by other work */
+		if (StallFrames)
+		{
+			StallFrames--;
+		}
+		else if (Scenario->StallChance && ((rand() % 10000) < Scenario->StallChance))
+		{
+			StallFrames = ((rand() % Scenario->MaxStallFrames) + 1);
+		}
+		else
+		{
+			for (uint8_t Call = 0; Call < Scenario->ServiceCalls; Call++)
+			  ServiceStream(&Speaker_Audio_Interface, Results);
+		}
+
+		/* Restart the stream at random intervals, generally part way through the packet being filled */
+		if (RestartFrames && !(--RestartFrames))
+		{
+			Audio_Host_StartStopStreaming(&Speaker_Audio_Interface, false);
+			Audio_Host_StartStopStreaming(&Speaker_Audio_Interface, true);
+
+			RestartFrames = ((rand() % Scenario->RestartInterval) + 1);
+			DueFraction   = 0;
+			Results->Restarts++;
+		}
+
+		/* The bus takes at most one queued packet from the pipe in each frame, as the stream is isochronous */
+		if (!(DataPipe->Frozen) && (DeviceAltSetting == 1))
+		{
+			if (DataPipe->BanksQueued)
+			{
+				uint16_t PacketBytes  = DataPipe->QueuedBytes[0];
+				uint16_t PacketFrames = (PacketBytes / FrameSize);
+
+				DataPipe->QueuedBytes[0] = DataPipe->QueuedBytes[1];
+				DataPipe->BanksQueued--;
+
+				/* Each packet must carry the whole number of frames due from the driver's own rate accumulator */
+				uint32_t Due = (Speaker_Audio_Interface.State.DataOUTFramesPerPacket + DueFraction);
+
+				if ((PacketBytes > DataPipe->Size) || (PacketBytes % FrameSize) ||
+				    (!(Scenario->Feedback) && (PacketFrames != (Due >> 14))))
+				{
+					Results->Errors++;
+				}
+
+				DueFraction = (Due & 0x3FFF);
+
+				Results->FramesSent += PacketFrames;
+				Results->Packets++;
+				BufferLevel         += PacketFrames;
+
+				if (PacketFrames < Results->MinPacketFrames)
+				  Results->MinPacketFrames = PacketFrames;
+				if (PacketFrames > Results->MaxPacketFrames)
+				  Results->MaxPacketFrames = PacketFrames;
+			}
+			else if (Results->Packets)
+			{
+				Results->MissedFrames++;
+			}
+		}
+
+		/* The device plays out its buffer at its own clock rate once the prefill level is reached */
+		if (!(Playing) && (BufferLevel >= ((Scenario->SampleFrequency / 1000) * DEVICE_PREFILL_MS)))
+		  Playing = true;
+
+		if (Playing)
+		{
+			BufferLevel -= (DeviceRate / 1000);
+
+			if (BufferLevel < 0)
+			{
+				Results->Underflows -= BufferLevel;
+				BufferLevel = 0;
+			}
+
+			if (BufferLevel < Results->MinBufferLevel)
+			  Results->MinBufferLevel = BufferLevel;
+			if (BufferLevel > Results->MaxBufferLevel)
+			  Results->MaxBufferLevel = BufferLevel;
+		}
+	}
+
+	Results->Errors += BankOverflows;
+
+	Audio_Host_StartStopStreaming(&Speaker_Audio_Interface, false);
+	return true;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	printf("Audio host class driver playback benchmark, %d USB frames per scenario\n\n", SIMULATION_FRAMES);
+	printf("%-20s %9s %11s %7s %7s %6s %7s %9s %9s %8s %6s %8s\n",
+	       "Scenario", "Nominal", "Frames/s", "Pkt min", "Pkt max", "Missed", "Underfl", "Buf min", "Buf max",
+	       "Restarts", "Errors", "Write ns");
+
+	for (uint8_t Index = 0; Index < (sizeof(Scenarios) / sizeof(Scenarios[0])); Index++)
+	{
+		const Scenario_t* Scenario = &Scenarios[Index];
+		Results_t         Results;
+
+		if (!(RunScenario(Scenario, &Results)))
+		{
+			printf("%-20s (enumeration failed)\n", Scenario->Name);
+			TotalErrors++;
+			continue;
+		}
+
+		printf("%-20s %9lu %11.2f %7u %7u %6lu %7.0f %9.2f %9.2f %8lu %6lu %8.1f\n",
+		       Scenario->Name, (unsigned long)Scenario->SampleFrequency,
+		       ((double)Results.FramesSent * 1000 / SIMULATION_FRAMES), Results.MinPacketFrames, Results.MaxPacketFrames,
+		       (unsigned long)Results.MissedFrames, Results.Underflows, Results.MinBufferLevel,
+		       Results.MaxBufferLevel, (unsigned long)Results.Restarts, (unsigned long)Results.Errors,
+		       ((double)Results.WriteTimeNS / Results.WriteCalls));
+
+		TotalErrors += Results.Errors;
+	}
+
+	printf("\nMissed counts USB frames without a packet once streaming, Underfl the sample frames the device played with\n");
+	printf("an empty buffer, and Buf min/max the range of the device buffer level in sample frames (the stream jitter).\n");
+	printf("Errors counts packets larger than the pipe or not holding the frames due, and writes past a pipe bank.\n");
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,244 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host benchmark for the HID report parser. Each descriptor in the corpus (see HIDReportCorpus.c) is parsed
+ *  repeatedly to measure the parse time, and the resulting report items are then used to measure the time taken to
+ *  decode a report with \ref USB_DecodeHIDReport() and to extract a single item with \ref USB_GetHIDReportItemInfo().
+ *  The parser is built for this benchmark with limits large enough for every descriptor in the corpus, and the
+ *  parser statistics are used to report whether each descriptor would fit within the library's default limits, and
+ *  how much SRAM its stored report items occupy on the AVR.
+ *
+ *  Times are those of the host CPU and are only useful when comparing parser changes against each other; the item and
+ *  SRAM figures are exact. Build and run with "make bench" in this directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../HIDParser.h"
+#include "HIDReportCorpus.h"
+
+/** Number of times each descriptor is parsed for the parse time measurement. */
+#define PARSE_ITERATIONS     20000
+
+/** Number of times each report is decoded for the decode time measurement. */
+#define DECODE_ITERATIONS    200000
+
+/** Default HID parser limits of the library, which the benchmark itself is built with larger values of. */
+#define DEFAULT_STATETABLE_STACK_DEPTH    2
+#define DEFAULT_USAGE_STACK_DEPTH         8
+#define DEFAULT_MAX_COLLECTIONS           10
+#define DEFAULT_MAX_REPORTITEMS           20
+#define DEFAULT_MAX_REPORT_IDS            10
+
+/** Size of a pointer on the AVR, used to convert the host size of the parser structures to their AVR size. */
+#define AVR_POINTER_SIZE     2
+
+/** Parsed report information, shared by all measurements. */
+static HID_ReportInfo_t ParserData;
+
+/** Report buffer used for the decode measurements, large enough for any report of a parsed descriptor. */
+static uint8_t ReportBuffer[(0xFFFF / 8) + 2];
+
+/** Accumulator for extracted item values, so that the extraction cannot be optimized away. */
+static volatile uint32_t ValueSink;
+
+/** Callback for the HID report parser, storing every non-constant item so that the benchmark measures the worst case
+ *  of an application which needs the whole report.
+ *
+ *  \param[in] CurrentItem  Pointer to the current report item for user checking
+ *
+ *  \return Boolean true, to store every item
+ */
+bool CALLBACK_HIDParser_FilterHIDReportItem(HID_ReportItem_t* CurrentItem)
+{
+	return true;
+}
+
+/** Returns a monotonic timestamp, in nanoseconds.
+ *
+ *  \return Current time in nanoseconds
+ */
+static uint64_t GetTimeNS(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (((uint64_t)Now.tv_sec * 1000000000ULL) + Now.tv_nsec);
+}
+
+/** Counts the number of collection paths used by the parsed descriptor.
+ *
+ *  \return Number of used entries in the parsed collection path table
+ */
+static uint8_t CountCollectionPaths(void)
+{
+	uint8_t Total = 0;
+
+	for (uint8_t i = 0; i < HID_MAX_COLLECTIONS; i++)
+	{
+		if ((i == 0) || (ParserData.CollectionPaths[i].Parent != NULL))
+		  Total++;
+	}
+
+	return Total;
+}
+
+/** Determines if a parsed descriptor would also parse with the library's default limits.
+ *
+ *  \param[in] CollectionPaths  Number of collection paths used by the descriptor
+ *
+ *  \return Boolean true if the descriptor fits within the default limits, false otherwise
+ */
+static bool FitsDefaultLimits(const uint8_t CollectionPaths)
+{
+	return ((ParserData.Statistics.PeakStateTableDepth < DEFAULT_STATETABLE_STACK_DEPTH) &&
+	        (ParserData.Statistics.PeakUsageListSize  <= DEFAULT_USAGE_STACK_DEPTH)     &&
+	        (CollectionPaths                           <= DEFAULT_MAX_COLLECTIONS)      &&
+	        (ParserData.TotalReportItems               <= DEFAULT_MAX_REPORTITEMS)      &&
+	        (ParserData.TotalDeviceReports             <= DEFAULT_MAX_REPORT_IDS));
+}
+
+/** Measures the time taken to decode the largest input report of the parsed descriptor.
+ *
+ *  \param[out] ItemsPerReport  Number of items decoded from each report
+ *
+ *  \return Average decode time of a whole report, in nanoseconds
+ */
+static double BenchmarkDecode(uint8_t* const ItemsPerReport)
+{
+	uint8_t  ReportID   = 0;
+	uint16_t ReportSize = 0;
+
+	for (uint8_t i = 0; i < ParserData.TotalDeviceReports; i++)
+	{
+		uint16_t Size = USB_GetHIDReportSize(&ParserData, ParserData.ReportIDSizes[i].ReportID, REPORT_ITEM_TYPE_In);
+
+		if (Size > ReportSize)
+		{
+			ReportSize = Size;
+			ReportID   = ParserData.ReportIDSizes[i].ReportID;
+		}
+	}
+
+	for (uint16_t i = 0; i < sizeof(ReportBuffer); i++)
+	  ReportBuffer[i] = (uint8_t)(i * 37);
+
+	ReportBuffer[0] = (ParserData.UsingReportIDs) ? ReportID : ReportBuffer[0];
+
+	*ItemsPerReport = USB_DecodeHIDReport(ReportBuffer, &ParserData, REPORT_ITEM_TYPE_In);
+
+	if (!(*ItemsPerReport))
+	  return 0;
+
+	uint64_t Start = GetTimeNS();
+
+	for (uint32_t i = 0; i < DECODE_ITERATIONS; i++)
+	{
+		ReportBuffer[1] = (uint8_t)i;
+		ValueSink += USB_DecodeHIDReport(ReportBuffer, &ParserData, REPORT_ITEM_TYPE_In);
+	}
+
+	return ((double)(GetTimeNS() - Start) / DECODE_ITERATIONS);
+}
+
+/** Measures the time taken to extract a single item from a report with \ref USB_GetHIDReportItemInfo(), cycling
+ *  through every stored item of the parsed descriptor.
+ *
+ *  \return Average extraction time of a single item, in nanoseconds
+ */
+static double BenchmarkExtract(void)
+{
+	uint64_t Start = GetTimeNS();
+
+	for (uint32_t i = 0; i < DECODE_ITERATIONS; i++)
+	{
+		HID_ReportItem_t* ReportItem = &ParserData.ReportItems[i % ParserData.TotalReportItems];
+
+		ReportBuffer[0] = ReportItem->ReportID;
+		USB_GetHIDReportItemInfo(ReportBuffer, ReportItem);
+		ValueSink += ReportItem->Value;
+	}
+
+	return ((double)(GetTimeNS() - Start) / DECODE_ITERATIONS);
+}
+
+int main(void)
+{
+	uint16_t AVRReportItemSize = (sizeof(HID_ReportItem_t) - (sizeof(void*) - AVR_POINTER_SIZE));
+
+	printf("HID report parser benchmark, %d parse and %d decode iterations per descriptor\n",
+	       PARSE_ITERATIONS, DECODE_ITERATIONS);
+	printf("AVR size of each stored report item: %u bytes (+1 byte of usage index)\n\n", AVRReportItemSize);
+	printf("%-20s %5s %6s %6s %5s %4s %4s %4s %4s %8s %9s %6s %9s %8s\n",
+	       "Descriptor", "Bytes", "Status", "DItems", "Items", "IDs", "Coll", "Use", "Push", "AVR SRAM",
+	       "Parse ns", "DecItm", "Decode ns", "Item ns");
+
+	for (unsigned int Entry = 0; Entry < HIDReportCorpus_Total; Entry++)
+	{
+		const HIDReportCorpus_Entry_t* Descriptor = &HIDReportCorpus[Entry];
+		uint8_t  ErrorCode;
+		uint64_t Start = GetTimeNS();
+
+		for (uint32_t i = 0; i < PARSE_ITERATIONS; i++)
+		  ErrorCode = USB_ProcessHIDReport(Descriptor->Data, Descriptor->Size, &ParserData);
+
+		double ParseNS = ((double)(GetTimeNS() - Start) / PARSE_ITERATIONS);
+
+		if (ErrorCode != HID_PARSE_Successful)
+		{
+			printf("%-20s %5u %6u (parse failed)\n", Descriptor->Name, Descriptor->Size, ErrorCode);
+			continue;
+		}
+
+		uint8_t  CollectionPaths = CountCollectionPaths();
+		uint32_t AVRItemBytes    = ((uint32_t)ParserData.TotalReportItems * (AVRReportItemSize + 1));
+		uint8_t  ItemsPerReport;
+		double   DecodeNS        = BenchmarkDecode(&ItemsPerReport);
+		double   ExtractNS       = BenchmarkExtract();
+
+		printf("%-20s %5u %6s %6u %5u %4u %4u %4u %4u %8lu %9.0f %6u %9.0f %8.1f\n",
+		       Descriptor->Name, Descriptor->Size, FitsDefaultLimits(CollectionPaths) ? "OK" : "LIMIT",
+		       ParserData.Statistics.TotalDataItems, ParserData.TotalReportItems, ParserData.TotalDeviceReports,
+		       CollectionPaths, ParserData.Statistics.PeakUsageListSize, ParserData.Statistics.PeakStateTableDepth,
+		       (unsigned long)AVRItemBytes, ParseNS, ItemsPerReport, DecodeNS, ExtractNS);
+	}
+
+	printf("\nStatus is LIMIT where the descriptor needs larger parser limits than the library defaults.\n");
+	printf("DItems counts every IN/OUT/FEATURE data item, Items those stored after filtering constant items.\n");
+	printf("AVR SRAM is the size of the stored report items on the AVR; DecItm is the number of items decoded from\n");
+	printf("the largest input report, by USB_DecodeHIDReport() in Decode ns and one at a time in Item ns.\n");
+
+	return 0;
+}
@@ -0,0 +1,444 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Fuzz target for the HID report parser. Each input is treated as a HID report descriptor from an untrusted device,
+ *  and is parsed with the library's default parser limits into an exactly sized heap buffer, so that any read past the
+ *  end of the descriptor is caught by the address sanitizer. When the descriptor parses successfully, the parsed
+ *  structure is checked for consistency (usage index order, collection path pointers and report sizes), and every
+ *  stored item is written to and read back from a report buffer sized from \ref USB_GetHIDReportSize(), so that item
+ *  layouts reaching past the end of their report are also caught.
+ *
+ *  The file provides the LLVMFuzzerTestOneInput() entry point for libFuzzer ("make fuzz-libfuzzer", which needs clang),
+ *  and unless built with FUZZ_LIBFUZZER, a standalone driver for gcc ("make fuzz"). The standalone driver either
+ *  replays the descriptor files named on its command line, or mutates the descriptors of the corpus for the given
+ *  number of iterations, as "HIDParserFuzz [-iterations N] [-seed N] [-dump DIR] [FILE...]"; -dump writes the corpus
+ *  out as seed files for libFuzzer. Any inconsistency aborts the run, after saving the failing input as crash.bin.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../HIDParser.h"
+#include "HIDReportCorpus.h"
+
+/** Maximum size of a fuzzed descriptor, in bytes. */
+#define FUZZ_MAX_DESCRIPTOR_SIZE    1024
+
+/** Parsed report information of the current input. */
+static HID_ReportInfo_t ParserData;
+
+/** Number of inputs parsed successfully, and therefore checked. */
+static unsigned long SuccessfulParses;
+
+/** Reports a consistency failure of the parsed report information and aborts. Under libFuzzer the abort causes the
+ *  input to be saved; the standalone driver installs its own handler to save it.
+ *
+ *  \param[in] Message  Description of the failed check
+ */
+static void Fail(const char* Message)
+{
+	fprintf(stderr, "HID parser check failed: %s\n", Message);
+	abort();
+}
+
+/** Callback for the HID report parser. Every non-constant item is stored, except those of usage page 0xFF00, so that
+ *  the filtering path of the parser is exercised as well.
+ *
+ *  \param[in] CurrentItem  Pointer to the current report item for user checking
+ *
+ *  \return Boolean true if the item should be stored, false otherwise
+ */
+bool CALLBACK_HIDParser_FilterHIDReportItem(HID_ReportItem_t* CurrentItem)
+{
+	return (CurrentItem->Attributes.Usage.Page != 0xFF00);
+}
+
+/** Checks that a collection path pointer is either NULL or points to an entry of the collection path table.
+ *
+ *  \param[in] CollectionPath  Collection path pointer to check
+ */
+static void CheckCollectionPath(const HID_CollectionPath_t* CollectionPath)
+{
+	if ((CollectionPath != NULL) && ((CollectionPath <  &ParserData.CollectionPaths[0]) ||
+	                                 (CollectionPath >= &ParserData.CollectionPaths[HID_MAX_COLLECTIONS])))
+	{
+		Fail("collection path outside of the collection path table");
+	}
+}
+
+/** Checks the parsed report information of a successfully parsed descriptor. */
+static void CheckParsedReport(void)
+{
+	if (ParserData.TotalReportItems > HID_MAX_REPORTITEMS)
+	  Fail("more report items stored than fit in the report item table");
+
+	if (!(ParserData.TotalDeviceReports) || (ParserData.TotalDeviceReports > HID_MAX_REPORT_IDS))
+	  Fail("report ID count out of range");
+
+	#if defined(HID_USAGE_INDEX)
+	bool IndexUsed[HID_MAX_REPORTITEMS] = {false};
+
+	for (uint8_t i = 0; i < ParserData.TotalReportItems; i++)
+	{
+		uint8_t ItemIndex = ParserData.UsageIndex[i];
+
+		if ((ItemIndex >= ParserData.TotalReportItems) || IndexUsed[ItemIndex])
+		  Fail("usage index is not a permutation of the report items");
+
+		IndexUsed[ItemIndex] = true;
+
+		if (i)
+		{
+			const HID_ReportItem_t* Previous = &ParserData.ReportItems[ParserData.UsageIndex[i - 1]];
+			const HID_ReportItem_t* Current  = &ParserData.ReportItems[ItemIndex];
+
+			if ((Previous->Attributes.Usage.Page > Current->Attributes.Usage.Page) ||
+			    ((Previous->Attributes.Usage.Page == Current->Attributes.Usage.Page) &&
+			     (Previous->Attributes.Usage.Usage > Current->Attributes.Usage.Usage)))
+			{
+				Fail("usage index is not sorted");
+			}
+		}
+	}
+	#endif
+
+	for (uint8_t i = 0; i < HID_MAX_COLLECTIONS; i++)
+	  CheckCollectionPath(ParserData.CollectionPaths[i].Parent);
+
+	for (uint8_t i = 0; i < ParserData.TotalReportItems; i++)
+	{
+		HID_ReportItem_t* ReportItem = &ParserData.ReportItems[i];
+
+		CheckCollectionPath(ReportItem->CollectionPath);
+
+		if (ReportItem->ItemType > REPORT_ITEM_TYPE_Feature)
+		  Fail("invalid report item type");
+
+		HID_ReportItem_t* FoundItem = USB_FindHIDReportItem(&ParserData, ReportItem->ItemType,
+		                                                    ReportItem->Attributes.Usage.Page,
+		                                                    ReportItem->Attributes.Usage.Usage,
+		                                                    ReportItem->ReportID);
+
+		if ((FoundItem == NULL) || (FoundItem->ItemType != ReportItem->ItemType) ||
+		    (FoundItem->ReportID != ReportItem->ReportID) ||
+		    (FoundItem->Attributes.Usage.Page  != ReportItem->Attributes.Usage.Page) ||
+		    (FoundItem->Attributes.Usage.Usage != ReportItem->Attributes.Usage.Usage))
+		{
+			Fail("stored report item not found by its usage");
+		}
+
+		uint16_t ReportSize = USB_GetHIDReportSize(&ParserData, ReportItem->ReportID, ReportItem->ItemType);
+		uint32_t ItemEnd    = ((uint32_t)ReportItem->BitOffset + ReportItem->Attributes.BitSize);
+
+		if (ItemEnd > ((uint32_t)ReportSize * 8))
+		  Fail("report item lies outside of its report");
+
+		if (ItemEnd > ParserData.LargestReportSizeBits)
+		  Fail("report item lies outside of the largest report size");
+
+		/* Exactly sized report buffer, so that the sanitizer catches accesses past the end of the report */
+		uint16_t BufferSize = (ReportSize + (ReportItem->ReportID ? 1 : 0));
+		uint8_t* Report     = calloc(1, BufferSize ? BufferSize : 1);
+		uint32_t TestValue  = (0xA5C3E187UL * (i + 1));
+
+		ReportItem->Value = TestValue;
+		USB_SetHIDReportItemInfo(Report, ReportItem);
+
+		ReportItem->Value = 0;
+		if (!(USB_GetHIDReportItemInfo(Report, ReportItem)))
+		  Fail("report ID of a written report not recognised");
+
+		if ((ReportItem->Value ^ TestValue) & ReportItem->Layout.Mask)
+		  Fail("report item value changed in a write and read back");
+
+		USB_DecodeHIDReport(Report, &ParserData, ReportItem->ItemType);
+
+		free(Report);
+	}
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
+{
+	if (Size > FUZZ_MAX_DESCRIPTOR_SIZE)
+	  return 0;
+
+	/* Exactly sized descriptor buffer, so that the sanitizer catches reads past the end of the descriptor */
+	uint8_t* Descriptor = malloc(Size ? Size : 1);
+	memcpy(Descriptor, Data, Size);
+
+	if (USB_ProcessHIDReport(Descriptor, Size, &ParserData) == HID_PARSE_Successful)
+	{
+		SuccessfulParses++;
+		CheckParsedReport();
+	}
+
+	free(Descriptor);
+	return 0;
+}
+
+#if !defined(FUZZ_LIBFUZZER)
+#include <signal.h>
+#include <unistd.h>
+
+/** Current input of the standalone driver, saved when a check fails. */
+static uint8_t CurrentInput[FUZZ_MAX_DESCRIPTOR_SIZE];
+
+/** Size of the current input of the standalone driver, in bytes. */
+static size_t  CurrentInputSize;
+
+/** State of the standalone driver's pseudo-random number generator. */
+static uint32_t RandomState;
+
+/** Returns the next value of the standalone driver's xorshift pseudo-random number generator.
+ *
+ *  \return Next pseudo-random value
+ */
+static uint32_t Random(void)
+{
+	RandomState ^= (RandomState << 13);
+	RandomState ^= (RandomState >> 17);
+	RandomState ^= (RandomState << 5);
+
+	return RandomState;
+}
+
+/** Handler for the abort signal raised by a failed check or by the sanitizers, saving the failing input.
+ *
+ *  \param[in] Signal  Number of the raised signal
+ */
+static void SaveCrashInput(int Signal)
+{
+	FILE* CrashFile = fopen("crash.bin", "wb");
+
+	if (CrashFile != NULL)
+	{
+		fwrite(CurrentInput, 1, CurrentInputSize, CrashFile);
+		fclose(CrashFile);
+	}
+
+	static const char Message[] = "Failing input saved to crash.bin\n";
+	write(STDERR_FILENO, Message, sizeof(Message) - 1);
+
+	signal(Signal, SIG_DFL);
+	raise(Signal);
+}
+
+/** Replaces the current input with a mutated copy of a corpus descriptor. Mutations are chosen to reach the parser's
+ *  error and limit paths: truncation, bit flips, replacement of item prefixes and data with boundary values, and the
+ *  insertion, deletion and duplication of byte runs, including runs spliced from another descriptor.
+ */
+static void MutateInput(void)
+{
+	const HIDReportCorpus_Entry_t* Base = &HIDReportCorpus[Random() % HIDReportCorpus_Total];
+
+	memcpy(CurrentInput, Base->Data, Base->Size);
+	CurrentInputSize = Base->Size;
+
+	uint8_t TotalMutations = (1 + (Random() % 8));
+
+	for (uint8_t Mutation = 0; Mutation < TotalMutations; Mutation++)
+	{
+		size_t Position = (CurrentInputSize ? (Random() % CurrentInputSize) : 0);
+
+		switch (Random() % 8)
+		{
+			case 0:
+				CurrentInputSize = Position;
+				break;
+			case 1:
+				if (CurrentInputSize)
+				  CurrentInput[Position] ^= (1 << (Random() % 8));
+				break;
+			case 2:
+			{
+				static const uint8_t Boundaries[] = {0x00, 0x01, 0x7F, 0x80, 0xFE, 0xFF};
+
+				if (CurrentInputSize)
+				  CurrentInput[Position] = Boundaries[Random() % sizeof(Boundaries)];
+				break;
+			}
+			case 3:
+			{
+				static const uint8_t Prefixes[] = {0x05, 0x09, 0x15, 0x19, 0x29, 0x75, 0x76, 0x95, 0x96, 0x85,
+				                                   0x81, 0x91, 0xB1, 0xA1, 0xC0, 0xA4, 0xB4, 0x27, 0x0B, 0x0A};
+
+				if (CurrentInputSize)
+				  CurrentInput[Position] = Prefixes[Random() % sizeof(Prefixes)];
+				break;
+			}
+			case 4:
+			{
+				size_t Length = (1 + (Random() % 16));
+
+				if (Length > (CurrentInputSize - Position))
+				  Length = (CurrentInputSize - Position);
+
+				memmove(&CurrentInput[Position], &CurrentInput[Position + Length], CurrentInputSize - Position - Length);
+				CurrentInputSize -= Length;
+				break;
+			}
+			case 5:
+			case 6:
+			{
+				const HIDReportCorpus_Entry_t* Donor = (Random() & 1) ? &HIDReportCorpus[Random() % HIDReportCorpus_Total]
+				                                                             : Base;
+				size_t DonorStart = (Random() % Donor->Size);
+				size_t Length     = (1 + (Random() % 32));
+
+				if (Length > (Donor->Size - DonorStart))
+				  Length = (Donor->Size - DonorStart);
+
+				if (Length > (FUZZ_MAX_DESCRIPTOR_SIZE - CurrentInputSize))
+				  break;
+
+				memmove(&CurrentInput[Position + Length], &CurrentInput[Position], CurrentInputSize - Position);
+				memcpy(&CurrentInput[Position], &Donor->Data[DonorStart], Length);
+				CurrentInputSize += Length;
+				break;
+			}
+			case 7:
+			{
+				uint8_t Repeats = (1 + (Random() % 24));
+				size_t  Length  = (1 + (Random() % 4));
+
+				if (Length > (CurrentInputSize - Position))
+				  Length = (CurrentInputSize - Position);
+
+				while (Repeats-- && ((CurrentInputSize + Length) <= FUZZ_MAX_DESCRIPTOR_SIZE))
+				{
+					memmove(&CurrentInput[Position + Length], &CurrentInput[Position], CurrentInputSize - Position);
+					CurrentInputSize += Length;
+				}
+				break;
+			}
+		}
+	}
+}
+
+/** Writes each corpus descriptor to its own file in the given directory, as seed inputs for libFuzzer.
+ *
+ *  \param[in] Directory  Path of an existing directory to write the seed files to
+ *
+ *  \return Zero on success, non-zero if a file could not be written
+ */
+static int DumpCorpus(const char* Directory)
+{
+	for (unsigned int Entry = 0; Entry < HIDReportCorpus_Total; Entry++)
+	{
+		char  FileName[512];
+		FILE* SeedFile;
+
+		snprintf(FileName, sizeof(FileName), "%s/%s.bin", Directory, HIDReportCorpus[Entry].Name);
+
+		if ((SeedFile = fopen(FileName, "wb")) == NULL)
+		{
+			perror(FileName);
+			return 1;
+		}
+
+		fwrite(HIDReportCorpus[Entry].Data, 1, HIDReportCorpus[Entry].Size, SeedFile);
+		fclose(SeedFile);
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long Iterations = 1000000;
+	unsigned int  FilesRun   = 0;
+
+	RandomState = 0x4C554641;
+	signal(SIGABRT, SaveCrashInput);
+
+	for (int Arg = 1; Arg < argc; Arg++)
+	{
+		if (!(strcmp(argv[Arg], "-iterations")) && ((Arg + 1) < argc))
+		{
+			Iterations = strtoul(argv[++Arg], NULL, 0);
+		}
+		else if (!(strcmp(argv[Arg], "-seed")) && ((Arg + 1) < argc))
+		{
+			RandomState = (strtoul(argv[++Arg], NULL, 0) ^ 0x4C554641);
+
+			if (!(RandomState))
+			  RandomState = 1;
+		}
+		else if (!(strcmp(argv[Arg], "-dump")) && ((Arg + 1) < argc))
+		{
+			return DumpCorpus(argv[++Arg]);
+		}
+		else
+		{
+			FILE* InputFile = fopen(argv[Arg], "rb");
+
+			if (InputFile == NULL)
+			{
+				perror(argv[Arg]);
+				return 1;
+			}
+
+			CurrentInputSize = fread(CurrentInput, 1, sizeof(CurrentInput), InputFile);
+			fclose(InputFile);
+
+			LLVMFuzzerTestOneInput(CurrentInput, CurrentInputSize);
+			FilesRun++;
+		}
+	}
+
+	if (FilesRun)
+	{
+		printf("%u input file(s) run without error\n", FilesRun);
+		return 0;
+	}
+
+	for (unsigned int Entry = 0; Entry < HIDReportCorpus_Total; Entry++)
+	{
+		memcpy(CurrentInput, HIDReportCorpus[Entry].Data, HIDReportCorpus[Entry].Size);
+		CurrentInputSize = HIDReportCorpus[Entry].Size;
+
+		LLVMFuzzerTestOneInput(CurrentInput, CurrentInputSize);
+	}
+
+	for (unsigned long Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		MutateInput();
+
+		LLVMFuzzerTestOneInput(CurrentInput, CurrentInputSize);
+	}
+
+	printf("%lu mutated descriptors run without error, %lu parsed successfully and checked\n",
+	       Iterations, SuccessfulParses);
+	return 0;
+}
+#endif
@@ -0,0 +1,776 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Corpus of HID report descriptors for the host HID parser benchmark and fuzz target. The descriptors are those of
+ *  common classes of real-world devices: the boot keyboard and mouse examples from the HID specification, descriptors
+ *  in the style shipped by commodity keyboards, mice, gamepads, joysticks, touch screens, pen tablets and UPSes, the
+ *  FIDO U2F vendor descriptor, and the descriptors of the LUFA device demos.
+ */
+
+#include "HIDReportCorpus.h"
+
+/** Boot protocol keyboard, from appendix B.1 of the HID 1.11 specification. */
+static const uint8_t BootKeyboard[] =
+{
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x06,          /* Usage (Keyboard)                                */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x05, 0x07,          /*   Usage Page (Key Codes)                        */
+	0x19, 0xE0,          /*   Usage Minimum (Keyboard LeftControl)          */
+	0x29, 0xE7,          /*   Usage Maximum (Keyboard Right GUI)            */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x01,          /*   Logical Maximum (1)                           */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x95, 0x08,          /*   Report Count (8)                              */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x81, 0x01,          /*   Input (Constant)                              */
+	0x95, 0x05,          /*   Report Count (5)                              */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x05, 0x08,          /*   Usage Page (LEDs)                             */
+	0x19, 0x01,          /*   Usage Minimum (Num Lock)                      */
+	0x29, 0x05,          /*   Usage Maximum (Kana)                          */
+	0x91, 0x02,          /*   Output (Data, Variable, Absolute)             */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x75, 0x03,          /*   Report Size (3)                               */
+	0x91, 0x01,          /*   Output (Constant)                             */
+	0x95, 0x06,          /*   Report Count (6)                              */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x65,          /*   Logical Maximum (101)                         */
+	0x05, 0x07,          /*   Usage Page (Key Codes)                        */
+	0x19, 0x00,          /*   Usage Minimum (Reserved (no event indicated)) */
+	0x29, 0x65,          /*   Usage Maximum (Keyboard Application)          */
+	0x81, 0x00,          /*   Input (Data, Array)                           */
+	0xC0                 /* End Collection                                  */
+};
+
+/** N-Key Rollover keyboard, as sent by the ClassDriver Keyboard demo when built with KEYBOARD_NKRO. */
+static const uint8_t NKROKeyboard[] =
+{
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x06,          /* Usage (Keyboard)                                */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x95, 0x08,          /*   Report Count (8)                              */
+	0x05, 0x07,          /*   Usage Page (Key Codes)                        */
+	0x19, 0xE0,          /*   Usage Minimum (Keyboard LeftControl)          */
+	0x29, 0xE7,          /*   Usage Maximum (Keyboard Right GUI)            */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x01,          /*   Logical Maximum (1)                           */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x95, 0x05,          /*   Report Count (5)                              */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x05, 0x08,          /*   Usage Page (LEDs)                             */
+	0x19, 0x01,          /*   Usage Minimum (Num Lock)                      */
+	0x29, 0x05,          /*   Usage Maximum (Kana)                          */
+	0x91, 0x02,          /*   Output (Data, Variable, Absolute)             */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x75, 0x03,          /*   Report Size (3)                               */
+	0x91, 0x03,          /*   Output (Const, Variable, Absolute)            */
+	0x95, 0x68,          /*   Report Count (104)                            */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x01,          /*   Logical Maximum (1)                           */
+	0x05, 0x07,          /*   Usage Page (Key Codes)                        */
+	0x19, 0x00,          /*   Usage Minimum (Reserved (no event indicated)) */
+	0x29, 0x67,          /*   Usage Maximum (Keypad =)                      */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Keyboard with multimedia and power keys, using report IDs to share one interface between the keyboard, consumer
+ *  control and system control reports.
+ */
+static const uint8_t MultimediaKeyboard[] =
+{
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x06,          /* Usage (Keyboard)                                */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x85, 0x01,          /*   Report ID (1)                                 */
+	0x05, 0x07,          /*   Usage Page (Key Codes)                        */
+	0x19, 0xE0,          /*   Usage Minimum (Keyboard LeftControl)          */
+	0x29, 0xE7,          /*   Usage Maximum (Keyboard Right GUI)            */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x01,          /*   Logical Maximum (1)                           */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x95, 0x08,          /*   Report Count (8)                              */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x81, 0x01,          /*   Input (Constant)                              */
+	0x95, 0x05,          /*   Report Count (5)                              */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x05, 0x08,          /*   Usage Page (LEDs)                             */
+	0x19, 0x01,          /*   Usage Minimum (Num Lock)                      */
+	0x29, 0x05,          /*   Usage Maximum (Kana)                          */
+	0x91, 0x02,          /*   Output (Data, Variable, Absolute)             */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x75, 0x03,          /*   Report Size (3)                               */
+	0x91, 0x01,          /*   Output (Constant)                             */
+	0x95, 0x06,          /*   Report Count (6)                              */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x26, 0xFF, 0x00,    /*   Logical Maximum (255)                         */
+	0x05, 0x07,          /*   Usage Page (Key Codes)                        */
+	0x19, 0x00,          /*   Usage Minimum (Reserved (no event indicated)) */
+	0x2A, 0xFF, 0x00,    /*   Usage Maximum (255)                           */
+	0x81, 0x00,          /*   Input (Data, Array)                           */
+	0xC0,                /* End Collection                                  */
+	0x05, 0x0C,          /* Usage Page (Consumer)                           */
+	0x09, 0x01,          /* Usage (Consumer Control)                        */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x85, 0x02,          /*   Report ID (2)                                 */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x26, 0xFF, 0x03,    /*   Logical Maximum (1023)                        */
+	0x19, 0x00,          /*   Usage Minimum (Unassigned)                    */
+	0x2A, 0xFF, 0x03,    /*   Usage Maximum (1023)                          */
+	0x75, 0x10,          /*   Report Size (16)                              */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x81, 0x00,          /*   Input (Data, Array)                           */
+	0xC0,                /* End Collection                                  */
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x80,          /* Usage (System Control)                          */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x85, 0x03,          /*   Report ID (3)                                 */
+	0x19, 0x81,          /*   Usage Minimum (System Power Down)             */
+	0x29, 0x83,          /*   Usage Maximum (System Wake Up)                */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x01,          /*   Logical Maximum (1)                           */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x95, 0x03,          /*   Report Count (3)                              */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x95, 0x05,          /*   Report Count (5)                              */
+	0x81, 0x01,          /*   Input (Constant)                              */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Boot protocol mouse, from appendix B.2 of the HID 1.11 specification. */
+static const uint8_t BootMouse[] =
+{
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x02,          /* Usage (Mouse)                                   */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x09, 0x01,          /*   Usage (Pointer)                               */
+	0xA1, 0x00,          /*   Collection (Physical)                         */
+	0x05, 0x09,          /*     Usage Page (Button)                         */
+	0x19, 0x01,          /*     Usage Minimum (Button 1)                    */
+	0x29, 0x03,          /*     Usage Maximum (Button 3)                    */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x95, 0x03,          /*     Report Count (3)                            */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x75, 0x05,          /*     Report Size (5)                             */
+	0x81, 0x01,          /*     Input (Constant)                            */
+	0x05, 0x01,          /*     Usage Page (Generic Desktop)                */
+	0x09, 0x30,          /*     Usage (X)                                   */
+	0x09, 0x31,          /*     Usage (Y)                                   */
+	0x15, 0x81,          /*     Logical Minimum (-127)                      */
+	0x25, 0x7F,          /*     Logical Maximum (127)                       */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x95, 0x02,          /*     Report Count (2)                            */
+	0x81, 0x06,          /*     Input (Data, Variable, Relative)            */
+	0xC0,                /*   End Collection                                */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Five button mouse with 16-bit axes, a scroll wheel and horizontal scroll (AC Pan), behind a report ID. */
+static const uint8_t WheelMouse[] =
+{
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x02,          /* Usage (Mouse)                                   */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x85, 0x01,          /*   Report ID (1)                                 */
+	0x09, 0x01,          /*   Usage (Pointer)                               */
+	0xA1, 0x00,          /*   Collection (Physical)                         */
+	0x05, 0x09,          /*     Usage Page (Button)                         */
+	0x19, 0x01,          /*     Usage Minimum (Button 1)                    */
+	0x29, 0x05,          /*     Usage Maximum (Button 5)                    */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x95, 0x05,          /*     Report Count (5)                            */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x75, 0x03,          /*     Report Size (3)                             */
+	0x81, 0x01,          /*     Input (Constant)                            */
+	0x05, 0x01,          /*     Usage Page (Generic Desktop)                */
+	0x16, 0x01, 0x80,    /*     Logical Minimum (-32767)                    */
+	0x26, 0xFF, 0x7F,    /*     Logical Maximum (32767)                     */
+	0x75, 0x10,          /*     Report Size (16)                            */
+	0x95, 0x02,          /*     Report Count (2)                            */
+	0x09, 0x30,          /*     Usage (X)                                   */
+	0x09, 0x31,          /*     Usage (Y)                                   */
+	0x81, 0x06,          /*     Input (Data, Variable, Relative)            */
+	0x15, 0x81,          /*     Logical Minimum (-127)                      */
+	0x25, 0x7F,          /*     Logical Maximum (127)                       */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x09, 0x38,          /*     Usage (Wheel)                               */
+	0x81, 0x06,          /*     Input (Data, Variable, Relative)            */
+	0x05, 0x0C,          /*     Usage Page (Consumer)                       */
+	0x0A, 0x38, 0x02,    /*     Usage (AC Pan)                              */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x81, 0x06,          /*     Input (Data, Variable, Relative)            */
+	0xC0,                /*   End Collection                                */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Generic twin stick USB gamepad, with eight bit axes, a hat switch, twelve buttons and a vendor specific force
+ *  feedback output report.
+ */
+static const uint8_t Gamepad[] =
+{
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x04,          /* Usage (Joystick)                                */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0xA1, 0x02,          /*   Collection (Logical)                          */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x95, 0x05,          /*     Report Count (5)                            */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x26, 0xFF, 0x00,    /*     Logical Maximum (255)                       */
+	0x35, 0x00,          /*     Physical Minimum (0)                        */
+	0x46, 0xFF, 0x00,    /*     Physical Maximum (255)                      */
+	0x09, 0x30,          /*     Usage (X)                                   */
+	0x09, 0x31,          /*     Usage (Y)                                   */
+	0x09, 0x32,          /*     Usage (Z)                                   */
+	0x09, 0x32,          /*     Usage (Z)                                   */
+	0x09, 0x35,          /*     Usage (Rz)                                  */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x75, 0x04,          /*     Report Size (4)                             */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x25, 0x07,          /*     Logical Maximum (7)                         */
+	0x46, 0x3B, 0x01,    /*     Physical Maximum (315)                      */
+	0x65, 0x14,          /*     Unit (Degrees)                              */
+	0x09, 0x39,          /*     Usage (Hat Switch)                          */
+	0x81, 0x42,          /*     Input (Data, Variable, Absolute, Null)      */
+	0x65, 0x00,          /*     Unit (None)                                 */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x95, 0x0C,          /*     Report Count (12)                           */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x45, 0x01,          /*     Physical Maximum (1)                        */
+	0x05, 0x09,          /*     Usage Page (Button)                         */
+	0x19, 0x01,          /*     Usage Minimum (Button 1)                    */
+	0x29, 0x0C,          /*     Usage Maximum (Button 12)                   */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x06, 0x00, 0xFF,    /*     Usage Page (Vendor Defined)                 */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x95, 0x08,          /*     Report Count (8)                            */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x45, 0x01,          /*     Physical Maximum (1)                        */
+	0x09, 0x01,          /*     Usage (Vendor Defined)                      */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0xC0,                /*   End Collection                                */
+	0xA1, 0x02,          /*   Collection (Logical)                          */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x95, 0x07,          /*     Report Count (7)                            */
+	0x46, 0xFF, 0x00,    /*     Physical Maximum (255)                      */
+	0x26, 0xFF, 0x00,    /*     Logical Maximum (255)                       */
+	0x09, 0x02,          /*     Usage (Vendor Defined)                      */
+	0x91, 0x02,          /*     Output (Data, Variable, Absolute)           */
+	0xC0,                /*   End Collection                                */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Flight stick with ten bit X/Y axes, twist, throttle, a hat switch and twelve buttons. */
+static const uint8_t FlightStick[] =
+{
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x04,          /* Usage (Joystick)                                */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0xA1, 0x02,          /*   Collection (Logical)                          */
+	0x75, 0x0A,          /*     Report Size (10)                            */
+	0x95, 0x02,          /*     Report Count (2)                            */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x26, 0xFF, 0x03,    /*     Logical Maximum (1023)                      */
+	0x35, 0x00,          /*     Physical Minimum (0)                        */
+	0x46, 0xFF, 0x03,    /*     Physical Maximum (1023)                     */
+	0x09, 0x30,          /*     Usage (X)                                   */
+	0x09, 0x31,          /*     Usage (Y)                                   */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x75, 0x04,          /*     Report Size (4)                             */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x25, 0x07,          /*     Logical Maximum (7)                         */
+	0x46, 0x3B, 0x01,    /*     Physical Maximum (315)                      */
+	0x65, 0x14,          /*     Unit (Degrees)                              */
+	0x09, 0x39,          /*     Usage (Hat Switch)                          */
+	0x81, 0x42,          /*     Input (Data, Variable, Absolute, Null)      */
+	0x65, 0x00,          /*     Unit (None)                                 */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x26, 0xFF, 0x00,    /*     Logical Maximum (255)                       */
+	0x46, 0xFF, 0x00,    /*     Physical Maximum (255)                      */
+	0x09, 0x35,          /*     Usage (Rz)                                  */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x05, 0x09,          /*     Usage Page (Button)                         */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x35, 0x00,          /*     Physical Minimum (0)                        */
+	0x45, 0x01,          /*     Physical Maximum (1)                        */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x95, 0x08,          /*     Report Count (8)                            */
+	0x19, 0x01,          /*     Usage Minimum (Button 1)                    */
+	0x29, 0x08,          /*     Usage Maximum (Button 8)                    */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x05, 0x01,          /*     Usage Page (Generic Desktop)                */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x26, 0xFF, 0x00,    /*     Logical Maximum (255)                       */
+	0x46, 0xFF, 0x00,    /*     Physical Maximum (255)                      */
+	0x09, 0x36,          /*     Usage (Slider)                              */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x05, 0x09,          /*     Usage Page (Button)                         */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x45, 0x01,          /*     Physical Maximum (1)                        */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x95, 0x04,          /*     Report Count (4)                            */
+	0x19, 0x09,          /*     Usage Minimum (Button 9)                    */
+	0x29, 0x0C,          /*     Usage Maximum (Button 12)                   */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x95, 0x04,          /*     Report Count (4)                            */
+	0x81, 0x01,          /*     Input (Constant)                            */
+	0xC0,                /*   End Collection                                */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Two finger multi-touch screen in the style required by Windows 7, with a contact count maximum feature report and
+ *  a separate device configuration collection.
+ */
+static const uint8_t TouchScreen[] =
+{
+	0x05, 0x0D,          /* Usage Page (Digitizer)                          */
+	0x09, 0x04,          /* Usage (Touch Screen)                            */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x85, 0x01,          /*   Report ID (1)                                 */
+	0x09, 0x22,          /*   Usage (Finger)                                */
+	0xA1, 0x02,          /*   Collection (Logical)                          */
+	0x09, 0x42,          /*     Usage (Tip Switch)                          */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x09, 0x32,          /*     Usage (In Range)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x95, 0x06,          /*     Report Count (6)                            */
+	0x81, 0x03,          /*     Input (Const, Variable, Absolute)           */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x09, 0x51,          /*     Usage (Contact Identifier)                  */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x05, 0x01,          /*     Usage Page (Generic Desktop)                */
+	0x26, 0xFF, 0x0F,    /*     Logical Maximum (4095)                      */
+	0x75, 0x10,          /*     Report Size (16)                            */
+	0x55, 0x0E,          /*     Unit Exponent (-2)                          */
+	0x65, 0x11,          /*     Unit (Centimeters)                          */
+	0x09, 0x30,          /*     Usage (X)                                   */
+	0x35, 0x00,          /*     Physical Minimum (0)                        */
+	0x46, 0xB5, 0x04,    /*     Physical Maximum (1205)                     */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x46, 0x8A, 0x03,    /*     Physical Maximum (906)                      */
+	0x09, 0x31,          /*     Usage (Y)                                   */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0xC0,                /*   End Collection                                */
+	0x05, 0x0D,          /*   Usage Page (Digitizer)                        */
+	0x09, 0x22,          /*   Usage (Finger)                                */
+	0xA1, 0x02,          /*   Collection (Logical)                          */
+	0x09, 0x42,          /*     Usage (Tip Switch)                          */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x09, 0x32,          /*     Usage (In Range)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x95, 0x06,          /*     Report Count (6)                            */
+	0x81, 0x03,          /*     Input (Const, Variable, Absolute)           */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x09, 0x51,          /*     Usage (Contact Identifier)                  */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x05, 0x01,          /*     Usage Page (Generic Desktop)                */
+	0x26, 0xFF, 0x0F,    /*     Logical Maximum (4095)                      */
+	0x75, 0x10,          /*     Report Size (16)                            */
+	0x55, 0x0E,          /*     Unit Exponent (-2)                          */
+	0x65, 0x11,          /*     Unit (Centimeters)                          */
+	0x09, 0x30,          /*     Usage (X)                                   */
+	0x35, 0x00,          /*     Physical Minimum (0)                        */
+	0x46, 0xB5, 0x04,    /*     Physical Maximum (1205)                     */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x46, 0x8A, 0x03,    /*     Physical Maximum (906)                      */
+	0x09, 0x31,          /*     Usage (Y)                                   */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0xC0,                /*   End Collection                                */
+	0x05, 0x0D,          /*   Usage Page (Digitizer)                        */
+	0x09, 0x54,          /*   Usage (Contact Count)                         */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x08,          /*   Logical Maximum (8)                           */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x85, 0x02,          /*   Report ID (2)                                 */
+	0x09, 0x55,          /*   Usage (Contact Count Maximum)                 */
+	0x25, 0x02,          /*   Logical Maximum (2)                           */
+	0xB1, 0x02,          /*   Feature (Data, Variable, Absolute)            */
+	0xC0,                /* End Collection                                  */
+	0x09, 0x0E,          /* Usage (Device Configuration)                    */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x85, 0x03,          /*   Report ID (3)                                 */
+	0x09, 0x23,          /*   Usage (Device Settings)                       */
+	0xA1, 0x02,          /*   Collection (Logical)                          */
+	0x09, 0x52,          /*     Usage (Device Mode)                         */
+	0x09, 0x53,          /*     Usage (Device Identifier)                   */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x25, 0x0A,          /*     Logical Maximum (10)                        */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x95, 0x02,          /*     Report Count (2)                            */
+	0xB1, 0x02,          /*     Feature (Data, Variable, Absolute)          */
+	0xC0,                /*   End Collection                                */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Pen tablet, reporting the pen's switches, in range state, absolute position and tip pressure. */
+static const uint8_t PenTablet[] =
+{
+	0x05, 0x0D,          /* Usage Page (Digitizer)                          */
+	0x09, 0x02,          /* Usage (Pen)                                     */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x85, 0x02,          /*   Report ID (2)                                 */
+	0x09, 0x20,          /*   Usage (Stylus)                                */
+	0xA1, 0x00,          /*   Collection (Physical)                         */
+	0x09, 0x42,          /*     Usage (Tip Switch)                          */
+	0x09, 0x44,          /*     Usage (Barrel Switch)                       */
+	0x09, 0x45,          /*     Usage (Eraser)                              */
+	0x09, 0x3C,          /*     Usage (Invert)                              */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0x75, 0x01,          /*     Report Size (1)                             */
+	0x95, 0x04,          /*     Report Count (4)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x81, 0x03,          /*     Input (Const, Variable, Absolute)           */
+	0x09, 0x32,          /*     Usage (In Range)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x95, 0x02,          /*     Report Count (2)                            */
+	0x81, 0x03,          /*     Input (Const, Variable, Absolute)           */
+	0x05, 0x01,          /*     Usage Page (Generic Desktop)                */
+	0x09, 0x30,          /*     Usage (X)                                   */
+	0x26, 0x40, 0x4E,    /*     Logical Maximum (20032)                     */
+	0x46, 0x40, 0x4E,    /*     Physical Maximum (20032)                    */
+	0x65, 0x11,          /*     Unit (Centimeters)                          */
+	0x55, 0x0D,          /*     Unit Exponent (-3)                          */
+	0x75, 0x10,          /*     Report Size (16)                            */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x09, 0x31,          /*     Usage (Y)                                   */
+	0x26, 0xD0, 0x39,    /*     Logical Maximum (14800)                     */
+	0x46, 0xD0, 0x39,    /*     Physical Maximum (14800)                    */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0x05, 0x0D,          /*     Usage Page (Digitizer)                      */
+	0x09, 0x30,          /*     Usage (Tip Pressure)                        */
+	0x65, 0x00,          /*     Unit (None)                                 */
+	0x55, 0x00,          /*     Unit Exponent (0)                           */
+	0x26, 0xFF, 0x07,    /*     Logical Maximum (2047)                      */
+	0x46, 0xFF, 0x07,    /*     Physical Maximum (2047)                     */
+	0x81, 0x02,          /*     Input (Data, Variable, Absolute)            */
+	0xC0,                /*   End Collection                                */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Uninterruptible power supply, in the style of the HID Power Device class descriptors of consumer UPSes, which
+ *  expose most of their state as feature reports and use a large number of report IDs.
+ */
+static const uint8_t PowerDevice[] =
+{
+	0x05, 0x84,          /* Usage Page (Power Device)                       */
+	0x09, 0x04,          /* Usage (UPS)                                     */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x09, 0x24,          /*   Usage (Power Summary)                         */
+	0xA1, 0x02,          /*   Collection (Logical)                          */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x15, 0x00,          /*     Logical Minimum (0)                         */
+	0x26, 0xFF, 0x00,    /*     Logical Maximum (255)                       */
+	0x85, 0x01,          /*     Report ID (1)                               */
+	0x09, 0xFE,          /*     Usage (iProduct)                            */
+	0x79, 0x01,          /*     String Index (1)                            */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x85, 0x02,          /*     Report ID (2)                               */
+	0x09, 0xFF,          /*     Usage (iSerialNumber)                       */
+	0x79, 0x02,          /*     String Index (2)                            */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x85, 0x03,          /*     Report ID (3)                               */
+	0x05, 0x85,          /*     Usage Page (Battery System)                 */
+	0x09, 0x89,          /*     Usage (iDeviceChemistry)                    */
+	0x79, 0x03,          /*     String Index (3)                            */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x85, 0x04,          /*     Report ID (4)                               */
+	0x09, 0x8F,          /*     Usage (iOEMInformation)                     */
+	0x79, 0x04,          /*     String Index (4)                            */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x85, 0x05,          /*     Report ID (5)                               */
+	0x09, 0x8B,          /*     Usage (Rechargeable)                        */
+	0x25, 0x01,          /*     Logical Maximum (1)                         */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x85, 0x06,          /*     Report ID (6)                               */
+	0x09, 0x2C,          /*     Usage (Capacity Mode)                       */
+	0x25, 0x02,          /*     Logical Maximum (2)                         */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x85, 0x07,          /*     Report ID (7)                               */
+	0x09, 0x83,          /*     Usage (Design Capacity)                     */
+	0x09, 0x67,          /*     Usage (Full Charge Capacity)                */
+	0x25, 0x64,          /*     Logical Maximum (100)                       */
+	0x95, 0x02,          /*     Report Count (2)                            */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x85, 0x08,          /*     Report ID (8)                               */
+	0x09, 0x8D,          /*     Usage (Capacity Granularity 1)              */
+	0x09, 0x8E,          /*     Usage (Capacity Granularity 2)              */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x95, 0x01,          /*     Report Count (1)                            */
+	0x85, 0x09,          /*     Report ID (9)                               */
+	0x09, 0x66,          /*     Usage (Remaining Capacity)                  */
+	0x81, 0x22,          /*     Input (Data, Variable, No Preferred)        */
+	0x09, 0x66,          /*     Usage (Remaining Capacity)                  */
+	0xB1, 0xA2,          /*     Feature (Data, Variable, No Pref, Volatile) */
+	0x85, 0x0A,          /*     Report ID (10)                              */
+	0x27, 0xFF, 0xFF, 0x00, 0x00, /* Logical Maximum (65535)                */
+	0x75, 0x10,          /*     Report Size (16)                            */
+	0x66, 0x01, 0x10,    /*     Unit (Seconds)                              */
+	0x55, 0x00,          /*     Unit Exponent (0)                           */
+	0x09, 0x68,          /*     Usage (Run Time To Empty)                   */
+	0x81, 0x22,          /*     Input (Data, Variable, No Preferred)        */
+	0x09, 0x68,          /*     Usage (Run Time To Empty)                   */
+	0xB1, 0xA2,          /*     Feature (Data, Variable, No Pref, Volatile) */
+	0x09, 0x2A,          /*     Usage (Remaining Time Limit)                */
+	0xB1, 0xA2,          /*     Feature (Data, Variable, No Pref, Volatile) */
+	0x85, 0x0B,          /*     Report ID (11)                              */
+	0x65, 0x00,          /*     Unit (None)                                 */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x26, 0xFF, 0x00,    /*     Logical Maximum (255)                       */
+	0x09, 0x29,          /*     Usage (Remaining Capacity Limit)            */
+	0xB1, 0xA2,          /*     Feature (Data, Variable, No Pref, Volatile) */
+	0x09, 0x8C,          /*     Usage (Warning Capacity Limit)              */
+	0xB1, 0xA2,          /*     Feature (Data, Variable, No Pref, Volatile) */
+	0x85, 0x0C,          /*     Report ID (12)                              */
+	0x05, 0x84,          /*     Usage Page (Power Device)                   */
+	0x09, 0x40,          /*     Usage (Config Voltage)                      */
+	0x75, 0x10,          /*     Report Size (16)                            */
+	0x27, 0xFF, 0xFF, 0x00, 0x00, /* Logical Maximum (65535)                */
+	0x67, 0x21, 0xD1, 0xF0, 0x00, /* Unit (Volts)                           */
+	0x55, 0x05,          /*     Unit Exponent (5)                           */
+	0xB1, 0x23,          /*     Feature (Const, Variable, No Preferred)     */
+	0x09, 0x30,          /*     Usage (Voltage)                             */
+	0xB1, 0xA3,          /*     Feature (Const, Variable, No Pref, Volatile)*/
+	0x67, 0x00, 0x00, 0x00, 0x00, /* Unit (None)                            */
+	0x55, 0x00,          /*     Unit Exponent (0)                           */
+	0x09, 0x02,          /*     Usage (Present Status)                      */
+	0xA1, 0x02,          /*     Collection (Logical)                        */
+	0x85, 0x0D,          /*       Report ID (13)                            */
+	0x05, 0x85,          /*       Usage Page (Battery System)               */
+	0x09, 0x44,          /*       Usage (Charging)                          */
+	0x09, 0x45,          /*       Usage (Discharging)                       */
+	0x09, 0xD0,          /*       Usage (AC Present)                        */
+	0x09, 0x42,          /*       Usage (Below Remaining Capacity Limit)    */
+	0x09, 0x43,          /*       Usage (Remaining Time Limit Expired)      */
+	0x09, 0x4B,          /*       Usage (Need Replacement)                  */
+	0x09, 0x65,          /*       Usage (Overload)                          */
+	0x15, 0x00,          /*       Logical Minimum (0)                       */
+	0x25, 0x01,          /*       Logical Maximum (1)                       */
+	0x75, 0x01,          /*       Report Size (1)                           */
+	0x95, 0x07,          /*       Report Count (7)                          */
+	0x81, 0x22,          /*       Input (Data, Variable, No Preferred)      */
+	0x95, 0x01,          /*       Report Count (1)                          */
+	0x81, 0x01,          /*       Input (Constant)                          */
+	0x09, 0x44,          /*       Usage (Charging)                          */
+	0x09, 0x45,          /*       Usage (Discharging)                       */
+	0x09, 0xD0,          /*       Usage (AC Present)                        */
+	0x09, 0x42,          /*       Usage (Below Remaining Capacity Limit)    */
+	0x09, 0x43,          /*       Usage (Remaining Time Limit Expired)      */
+	0x09, 0x4B,          /*       Usage (Need Replacement)                  */
+	0x09, 0x65,          /*       Usage (Overload)                          */
+	0x95, 0x07,          /*       Report Count (7)                          */
+	0xB1, 0xA2,          /*       Feature (Data, Variable, No Pref, Volatile) */
+	0x95, 0x01,          /*       Report Count (1)                          */
+	0xB1, 0x01,          /*       Feature (Constant)                        */
+	0xC0,                /*     End Collection                              */
+	0x05, 0x84,          /*     Usage Page (Power Device)                   */
+	0x75, 0x10,          /*     Report Size (16)                            */
+	0x16, 0xFF, 0xFF,    /*     Logical Minimum (-1)                        */
+	0x26, 0xFF, 0x7F,    /*     Logical Maximum (32767)                     */
+	0x66, 0x01, 0x10,    /*     Unit (Seconds)                              */
+	0x85, 0x0E,          /*     Report ID (14)                              */
+	0x09, 0x57,          /*     Usage (Delay Before Shutdown)               */
+	0xB1, 0xA2,          /*     Feature (Data, Variable, No Pref, Volatile) */
+	0x85, 0x0F,          /*     Report ID (15)                              */
+	0x09, 0x56,          /*     Usage (Delay Before Startup)                */
+	0xB1, 0xA2,          /*     Feature (Data, Variable, No Pref, Volatile) */
+	0x85, 0x10,          /*     Report ID (16)                              */
+	0x66, 0x00, 0x00,    /*     Unit (None)                                 */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x15, 0x01,          /*     Logical Minimum (1)                         */
+	0x25, 0x03,          /*     Logical Maximum (3)                         */
+	0x09, 0x5A,          /*     Usage (Audible Alarm Control)               */
+	0xB1, 0xA2,          /*     Feature (Data, Variable, No Pref, Volatile) */
+	0xC0,                /*   End Collection                                */
+	0xC0                 /* End Collection                                  */
+};
+
+/** FIDO U2F security key, which moves 64 byte vendor specific request and response frames through input and output
+ *  reports, as defined by the FIDO U2F HID protocol specification.
+ */
+static const uint8_t FIDOU2F[] =
+{
+	0x06, 0xD0, 0xF1,    /* Usage Page (FIDO Alliance)                      */
+	0x09, 0x01,          /* Usage (U2F Authenticator Device)                */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x09, 0x20,          /*   Usage (Input Report Data)                     */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x26, 0xFF, 0x00,    /*   Logical Maximum (255)                         */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x95, 0x40,          /*   Report Count (64)                             */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x09, 0x21,          /*   Usage (Output Report Data)                    */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x26, 0xFF, 0x00,    /*   Logical Maximum (255)                         */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x95, 0x40,          /*   Report Count (64)                             */
+	0x91, 0x02,          /*   Output (Data, Variable, Absolute)             */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Vendor defined report of the LUFA GenericHID demos, with eight byte input and output reports. */
+static const uint8_t LUFAGenericHID[] =
+{
+	0x06, 0x9C, 0xFF,    /* Usage Page (Vendor Defined)                     */
+	0x09, 0x01,          /* Usage (Vendor Defined)                          */
+	0xA1, 0x01,          /* Collection (Vendor Defined)                     */
+	0x09, 0x02,          /*   Usage (Vendor Defined)                        */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x95, 0x08,          /*   Report Count (8)                              */
+	0x15, 0x80,          /*   Logical Minimum (-128)                        */
+	0x25, 0x7F,          /*   Logical Maximum (127)                         */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x09, 0x03,          /*   Usage (Vendor Defined)                        */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x95, 0x08,          /*   Report Count (8)                              */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0xFF,          /*   Logical Maximum (255)                         */
+	0x91, 0x02,          /*   Output (Data, Variable, Absolute)             */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Joystick report of the LUFA Joystick demos, with signed eight bit axes and two buttons. */
+static const uint8_t LUFAJoystick[] =
+{
+	0x05, 0x01,          /* Usage Page (Generic Desktop)                    */
+	0x09, 0x04,          /* Usage (Joystick)                                */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x09, 0x01,          /*   Usage (Pointer)                               */
+	0xA1, 0x00,          /*   Collection (Physical)                         */
+	0x05, 0x01,          /*     Usage Page (Generic Desktop)                */
+	0x09, 0x30,          /*     Usage (X)                                   */
+	0x09, 0x31,          /*     Usage (Y)                                   */
+	0x15, 0x9C,          /*     Logical Minimum (-100)                      */
+	0x25, 0x64,          /*     Logical Maximum (100)                       */
+	0x75, 0x08,          /*     Report Size (8)                             */
+	0x95, 0x02,          /*     Report Count (2)                            */
+	0x81, 0x82,          /*     Input (Data, Variable, Absolute, Volatile)  */
+	0xC0,                /*   End Collection                                */
+	0x05, 0x09,          /*   Usage Page (Button)                           */
+	0x09, 0x02,          /*   Usage (Button 2)                              */
+	0x09, 0x01,          /*   Usage (Button 1)                              */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x25, 0x01,          /*   Logical Maximum (1)                           */
+	0x75, 0x01,          /*   Report Size (1)                               */
+	0x95, 0x02,          /*   Report Count (2)                              */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x75, 0x06,          /*   Report Size (6)                               */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x81, 0x01,          /*   Input (Constant)                              */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Vendor defined device which saves and restores its global state around a group of items with PUSH and POP, as some
+ *  composite devices do; included to exercise the parser's state table stack.
+ */
+static const uint8_t PushPopVendor[] =
+{
+	0x06, 0x00, 0xFF,    /* Usage Page (Vendor Defined)                     */
+	0x09, 0x01,          /* Usage (Vendor Defined)                          */
+	0xA1, 0x01,          /* Collection (Application)                        */
+	0x15, 0x00,          /*   Logical Minimum (0)                           */
+	0x26, 0xFF, 0x00,    /*   Logical Maximum (255)                         */
+	0x75, 0x08,          /*   Report Size (8)                               */
+	0x95, 0x02,          /*   Report Count (2)                              */
+	0x09, 0x10,          /*   Usage (Vendor Defined)                        */
+	0x09, 0x11,          /*   Usage (Vendor Defined)                        */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0xA4,                /*   Push                                          */
+	0x16, 0x00, 0x80,    /*   Logical Minimum (-32768)                      */
+	0x26, 0xFF, 0x7F,    /*   Logical Maximum (32767)                       */
+	0x75, 0x10,          /*   Report Size (16)                              */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x09, 0x20,          /*   Usage (Vendor Defined)                        */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0xB4,                /*   Pop                                           */
+	0x09, 0x12,          /*   Usage (Vendor Defined)                        */
+	0x95, 0x01,          /*   Report Count (1)                              */
+	0x81, 0x02,          /*   Input (Data, Variable, Absolute)              */
+	0x09, 0x30,          /*   Usage (Vendor Defined)                        */
+	0x95, 0x04,          /*   Report Count (4)                              */
+	0x91, 0x02,          /*   Output (Data, Variable, Absolute)             */
+	0xC0                 /* End Collection                                  */
+};
+
+/** Table of all descriptors in the corpus. */
+const HIDReportCorpus_Entry_t HIDReportCorpus[] =
+{
+	{"BootKeyboard",       BootKeyboard,       sizeof(BootKeyboard)},
+	{"NKROKeyboard",       NKROKeyboard,       sizeof(NKROKeyboard)},
+	{"MultimediaKeyboard", MultimediaKeyboard, sizeof(MultimediaKeyboard)},
+	{"BootMouse",          BootMouse,          sizeof(BootMouse)},
+	{"WheelMouse",         WheelMouse,         sizeof(WheelMouse)},
+	{"Gamepad",            Gamepad,            sizeof(Gamepad)},
+	{"FlightStick",        FlightStick,        sizeof(FlightStick)},
+	{"TouchScreen",        TouchScreen,        sizeof(TouchScreen)},
+	{"PenTablet",          PenTablet,          sizeof(PenTablet)},
+	{"PowerDevice",        PowerDevice,        sizeof(PowerDevice)},
+	{"FIDOU2F",            FIDOU2F,            sizeof(FIDOU2F)},
+	{"LUFAGenericHID",     LUFAGenericHID,     sizeof(LUFAGenericHID)},
+	{"LUFAJoystick",       LUFAJoystick,       sizeof(LUFAJoystick)},
+	{"PushPopVendor",      PushPopVendor,      sizeof(PushPopVendor)},
+};
+
+/** Number of descriptors in the \ref HIDReportCorpus table. */
+const unsigned int HIDReportCorpus_Total = (sizeof(HIDReportCorpus) / sizeof(HIDReportCorpus[0]));
@@ -0,0 +1,55 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Corpus of real-world HID report descriptors, shared by the host HID parser benchmark and fuzz target.
+ */
+
+#ifndef _HID_REPORT_CORPUS_H_
+#define _HID_REPORT_CORPUS_H_
+
+	/* Includes: */
+		#include <stdint.h>
+
+	/* Type Defines: */
+		/** Type define for a single HID report descriptor in the corpus. */
+		typedef struct
+		{
+			const char*    Name; /**< Short name of the device class the descriptor is taken from. */
+			const uint8_t* Data; /**< Raw HID report descriptor. */
+			uint16_t       Size; /**< Size of the report descriptor, in bytes. */
+		} HIDReportCorpus_Entry_t;
+
+	/* External Variables: */
+		extern const HIDReportCorpus_Entry_t HIDReportCorpus[];
+		extern const unsigned int            HIDReportCorpus_Total;
+
+#endif
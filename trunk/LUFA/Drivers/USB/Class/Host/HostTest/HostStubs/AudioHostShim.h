@@ -0,0 +1,170 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Shim header force-included (via the compiler's -include switch) when building the Audio host class driver for the
+ *  host machine. The AVR specific USB core headers are suppressed, and the descriptor types, control request and pipe
+ *  interface the driver uses are declared here instead. The pipe functions are implemented by the simulated USB bus
+ *  and device of the benchmark, rather than the AVR's USB controller.
+ */
+
+#ifndef _AUDIO_HOST_SHIM_H_
+#define _AUDIO_HOST_SHIM_H_
+
+	/* Macros: */
+		#define __USB_H__
+		#define __INCLUDE_FROM_USB_DRIVER
+
+		#define ATTR_NON_NULL_PTR_ARG(...)
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+		#include <stddef.h>
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#define DESCRIPTOR_PCAST(DescriptorPtr, Type)   ((Type*)(DescriptorPtr))
+			#define DESCRIPTOR_TYPE(DescriptorPtr)          DESCRIPTOR_PCAST(DescriptorPtr, USB_Descriptor_Header_t)->Type
+
+			#define DTYPE_Configuration                     0x02
+			#define DTYPE_Interface                         0x04
+			#define DTYPE_Endpoint                          0x05
+
+			#define ENDPOINT_DESCRIPTOR_DIR_IN              0x80
+			#define ENDPOINT_USAGE_FEEDBACK                 (1 << 4)
+
+			#define EP_TYPE_ISOCHRONOUS                     0x01
+			#define EP_TYPE_MASK                            0x03
+
+			#define PIPE_CONTROLPIPE                        0
+			#define PIPE_TOKEN_IN                           (1 << 4)
+			#define PIPE_TOKEN_OUT                          (2 << 4)
+			#define PIPE_BANK_SINGLE                        (0 << 2)
+			#define PIPE_BANK_DOUBLE                        (1 << 2)
+
+			#define REQDIR_HOSTTODEVICE                     (0 << 7)
+			#define REQTYPE_STANDARD                        (0 << 5)
+			#define REQTYPE_CLASS                           (1 << 5)
+			#define REQREC_INTERFACE                        (1 << 0)
+			#define REQREC_ENDPOINT                         (2 << 0)
+			#define REQ_SetInterface                        11
+
+		/* Type Defines: */
+			typedef struct
+			{
+				uint8_t Size;
+				uint8_t Type;
+			} __attribute__((packed)) USB_Descriptor_Header_t;
+
+			typedef struct
+			{
+				USB_Descriptor_Header_t Header;
+
+				uint8_t InterfaceNumber;
+				uint8_t AlternateSetting;
+				uint8_t TotalEndpoints;
+				uint8_t Class;
+				uint8_t SubClass;
+				uint8_t Protocol;
+				uint8_t InterfaceStrIndex;
+			} __attribute__((packed)) USB_Descriptor_Interface_t;
+
+			typedef struct
+			{
+				USB_Descriptor_Header_t Header;
+
+				uint8_t  EndpointAddress;
+				uint8_t  Attributes;
+				uint16_t EndpointSize;
+				uint8_t  PollingIntervalMS;
+			} __attribute__((packed)) USB_Descriptor_Endpoint_t;
+
+			typedef struct
+			{
+				uint8_t  bmRequestType;
+				uint8_t  bRequest;
+				uint16_t wValue;
+				uint16_t wIndex;
+				uint16_t wLength;
+			} __attribute__((packed)) USB_Request_Header_t;
+
+			typedef uint8_t (* const ConfigComparatorPtr_t)(void*);
+
+		/* Enums: */
+			enum DSearch_Return_ErrorCodes_t
+			{
+				DESCRIPTOR_SEARCH_Found,
+				DESCRIPTOR_SEARCH_Fail,
+				DESCRIPTOR_SEARCH_NotFound,
+			};
+
+			enum DSearch_Comp_Return_ErrorCodes_t
+			{
+				DESCRIPTOR_SEARCH_COMP_Found,
+				DESCRIPTOR_SEARCH_COMP_Fail,
+				DESCRIPTOR_SEARCH_COMP_EndOfDescriptor,
+			};
+
+			enum USB_Host_SendControlErrorCodes_t
+			{
+				HOST_SENDCONTROL_Successful         = 0,
+				HOST_SENDCONTROL_DeviceDisconnected = 1,
+			};
+
+			enum USB_Host_States_t
+			{
+				HOST_STATE_Configured               = 12,
+			};
+
+		/* Global Variables: */
+			extern USB_Request_Header_t USB_ControlRequest;
+			extern volatile uint8_t     USB_HostState;
+
+		/* Function Prototypes: */
+			uint8_t  USB_GetNextDescriptorComp(uint16_t* BytesRem, void** CurrConfigLoc, ConfigComparatorPtr_t ComparatorRoutine);
+			uint8_t  USB_Host_SendControlRequest(void* BufferPtr);
+
+			bool     Pipe_ConfigurePipe(const uint8_t Number, const uint8_t Type, const uint8_t Token, const uint8_t EndpointNumber,
+			                            const uint16_t Size, const uint8_t Banks);
+			void     Pipe_SelectPipe(const uint8_t PipeNumber);
+			void     Pipe_ResetPipe(const uint8_t PipeNumber);
+			void     Pipe_Freeze(void);
+			void     Pipe_Unfreeze(void);
+			bool     Pipe_IsINReceived(void);
+			bool     Pipe_IsOUTReady(void);
+			uint16_t Pipe_BytesInPipe(void);
+			uint8_t  Pipe_Read_Byte(void);
+			void     Pipe_Write_Byte(const uint8_t Byte);
+			void     Pipe_ClearIN(void);
+			void     Pipe_ClearOUT(void);
+
+#endif
@@ -0,0 +1,54 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Shim header force-included (via the compiler's -include switch) when building the HID parser for the host. The
+ *  parser itself only needs the HID class definitions, so the AVR specific USB core headers are suppressed and the one
+ *  core type the HID class header refers to is defined here instead.
+ */
+
+#ifndef _HOST_SHIM_H_
+#define _HOST_SHIM_H_
+
+	/* Macros: */
+		#define __USB_H__
+
+	/* Includes: */
+		#include <stdint.h>
+
+	/* Type Defines: */
+		typedef struct
+		{
+			uint8_t Size;
+			uint8_t Type;
+		} __attribute__((packed)) USB_Descriptor_Header_t;
+
+#endif
@@ -0,0 +1,932 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Host test for the multi-block streaming functions of the Mass Storage host class driver. The driver is built for
+ *  the host machine against a simulated USB bus and Bulk-Only Transport Mass Storage device (see
+ *  MassStorageHostShim.h), and the pipe stream functions are built from the library's own stream template. The
+ *  simulated device checks each Command Block Wrapper it is sent, stalls its endpoints when the host breaks the
+ *  transport protocol, and can be set to stall the data phase of a command at a given byte offset.
+ *
+ *  Each scenario issues a \ref MS_Host_ReadDeviceBlocks_Stream() or \ref MS_Host_WriteDeviceBlocks_Stream() command,
+ *  covering single and multi-block transfers, transfers of more than 255 blocks, the block callback aborting the
+ *  transfer part way through, and the device stalling the data phase at and between block boundaries. Every scenario
+ *  checks the returned error code, the blocks passed to the callback, the contents of the simulated medium, and then
+ *  issues a further read to check that the device was left ready for the next command. Build and run with
+ *  "make mstream" in this directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define  __INCLUDE_FROM_MS_DRIVER
+#include "../MassStorage.h"
+
+/** Size in bytes of each block of the simulated device's medium. */
+#define BLOCK_SIZE             512
+
+/** Total number of blocks in the simulated device's medium. */
+#define DISK_BLOCKS            1024
+
+/** Size in bytes of the simulated device's bulk endpoints. */
+#define ENDPOINT_SIZE          64
+
+/** Endpoint addresses of the simulated device's bulk endpoints, deliberately unequal to the pipe numbers. */
+#define DEVICE_IN_EPADDR       0x83
+#define DEVICE_OUT_EPADDR      0x04
+
+/** Pipe numbers used for the simulated Mass Storage interface. */
+#define DATA_IN_PIPE           1
+#define DATA_OUT_PIPE          2
+
+/** Number of pipes modelled by the simulated USB bus. */
+#define TOTAL_PIPES            3
+
+/** Number of consecutive pipe polls without a packet being transferred before the bus is considered hung. */
+#define HANG_POLL_LIMIT        1000000UL
+
+/** Data phase offset of a scenario which does not stall the data phase. */
+#define NO_STALL               0xFFFFFFFFUL
+
+/** Timeout in USB frames of each pipe ready wait of the stream functions, as set in LowLevel/LowLevel.h. */
+#define USB_STREAM_TIMEOUT_MS  100
+
+/** Standard request and feature selector used by the simulated USB_Host_ClearPipeStall(), see LowLevel/Host.c. */
+#define REQ_ClearFeature       1
+#define FEATURE_ENDPOINT_HALT  0
+
+/** Type define for a simulated pipe of the USB bus. */
+typedef struct
+{
+	uint8_t  Token; /**< Token of the pipe, a PIPE_TOKEN_* mask */
+	uint8_t  EndpointAddress; /**< Address of the device endpoint the pipe is bound to */
+	uint16_t Size; /**< Size in bytes of the pipe's bank */
+	bool     Frozen; /**< Indicates if the pipe is currently frozen */
+	bool     Stalled; /**< Indicates if the device has stalled the pipe, and the stall has not been reset */
+	bool     INReceived; /**< Indicates if an IN packet is held in the bank and not yet cleared */
+	bool     OUTPending; /**< Indicates if an OUT bank has been sent by the host but not yet taken by the device */
+	uint16_t BankLength; /**< Number of bytes held in the bank */
+	uint16_t BankPosition; /**< Number of bytes of a received IN packet already read */
+	uint8_t  Bank[ENDPOINT_SIZE]; /**< Contents of the pipe's bank */
+} SimPipe_t;
+
+/** Enum for the Bulk-Only Transport states of the simulated device. */
+enum SimDevice_States_t
+{
+	DEVICE_STATE_CommandBlock, /**< Waiting for a Command Block Wrapper */
+	DEVICE_STATE_DataIN, /**< Sending the data of a read command */
+	DEVICE_STATE_DataOUT, /**< Receiving the data of a write command */
+	DEVICE_STATE_StatusBlock, /**< Waiting to send a Command Status Wrapper */
+};
+
+/** Type define for the simulated Bulk-Only Mass Storage device. */
+typedef struct
+{
+	uint8_t  State; /**< Current transport state, a value from the \ref SimDevice_States_t enum */
+	bool     INHalted; /**< Indicates if the device's bulk IN endpoint is halted */
+	bool     OUTHalted; /**< Indicates if the device's bulk OUT endpoint is halted */
+	MS_CommandBlockWrapper_t CommandBlock; /**< Command Block Wrapper of the current command */
+	uint32_t BlockAddress; /**< First block addressed by the current command */
+	uint32_t DataOffset; /**< Number of bytes transferred in the data phase of the current command */
+	uint32_t StallAtOffset; /**< Data phase offset at which the current command's data phase is stalled */
+	uint8_t  CommandStatus; /**< Status of the current command, from the \ref MassStorage_CommandStatusCodes_t enum */
+	uint32_t Commands; /**< Number of valid commands received */
+	uint32_t Resets; /**< Number of MASS STORAGE RESET requests received */
+	uint32_t ClearHalts; /**< Number of CLEAR FEATURE (ENDPOINT HALT) requests received for a device endpoint */
+	uint32_t ProtocolErrors; /**< Number of invalid Command Block Wrappers and control requests received */
+} SimDevice_t;
+
+/** Type define for a test scenario. */
+typedef struct
+{
+	const char* Name; /**< Name of the scenario */
+	bool        Write; /**< Indicates if the scenario writes to the device rather than reading from it */
+	uint32_t    BlockAddress; /**< First block of the transfer */
+	uint16_t    Blocks; /**< Number of blocks in the transfer */
+	uint16_t    AbortAtBlock; /**< Index of the block for which the callback aborts the transfer, or Blocks for none */
+	uint32_t    StallAtOffset; /**< Data phase offset at which the device stalls the transfer, or NO_STALL */
+} Scenario_t;
+
+/** State of the block callbacks during a transfer. */
+typedef struct
+{
+	uint32_t BlockAddress; /**< First block of the transfer */
+	uint16_t Calls; /**< Number of calls made to the block callback */
+	uint16_t AbortAtBlock; /**< Index of the block for which the callback returns false */
+	uint8_t  Seed; /**< Seed of the data pattern checked or written by the callback */
+	uint32_t Errors; /**< Number of out of order block addresses and mismatched block contents seen */
+} CallbackState_t;
+
+USB_Request_Header_t USB_ControlRequest;
+volatile uint8_t     USB_HostState;
+
+/** Simulated pipes of the USB bus. */
+static SimPipe_t Pipes[TOTAL_PIPES];
+
+/** Currently selected simulated pipe. */
+static SimPipe_t* SelectedPipe = &Pipes[PIPE_CONTROLPIPE];
+
+/** Number of pipe polls made since a packet was last transferred over the bus. */
+static uint32_t IdlePolls;
+
+/** Number of bus errors seen by the simulation; reads and writes beyond a bank, and hung transfers. */
+static uint32_t BusErrors;
+
+/** Simulated Mass Storage device. */
+static SimDevice_t Device;
+
+/** Medium of the simulated device. */
+static uint8_t Medium[DISK_BLOCKS][BLOCK_SIZE];
+
+/** State of the block callbacks of the current transfer. */
+static CallbackState_t CallbackState;
+
+/** Mass Storage host class driver instance under test. */
+static USB_ClassInfo_MS_Host_t MSInterface =
+	{
+		.Config =
+			{
+				.DataINPipeNumber       = DATA_IN_PIPE,
+				.DataINPipeDoubleBank   = false,
+
+				.DataOUTPipeNumber      = DATA_OUT_PIPE,
+				.DataOUTPipeDoubleBank  = false,
+			},
+	};
+
+/** Configuration descriptor of the simulated device. */
+static const struct
+{
+	USB_Descriptor_Configuration_Header_t Config;
+	USB_Descriptor_Interface_t            Interface;
+	USB_Descriptor_Endpoint_t             DataINEndpoint;
+	USB_Descriptor_Endpoint_t             DataOUTEndpoint;
+} __attribute__((packed)) ConfigDescriptor =
+	{
+		.Config          = {{sizeof(USB_Descriptor_Configuration_Header_t), DTYPE_Configuration},
+		                    sizeof(ConfigDescriptor), 1, 1, 0, 0x80, 50},
+		.Interface       = {{sizeof(USB_Descriptor_Interface_t), DTYPE_Interface},
+		                    0, 0, 2, MASS_STORE_CLASS, MASS_STORE_SUBCLASS, MASS_STORE_PROTOCOL, 0},
+		.DataINEndpoint  = {{sizeof(USB_Descriptor_Endpoint_t), DTYPE_Endpoint},
+		                    DEVICE_IN_EPADDR, EP_TYPE_BULK, ENDPOINT_SIZE, 0},
+		.DataOUTEndpoint = {{sizeof(USB_Descriptor_Endpoint_t), DTYPE_Endpoint},
+		                    DEVICE_OUT_EPADDR, EP_TYPE_BULK, ENDPOINT_SIZE, 0},
+	};
+
+/** Test scenarios, run in order. */
+static const Scenario_t Scenarios[] =
+	{
+		{"Read 1 block",            false,   5,   1,   1, NO_STALL},
+		{"Read 8 blocks",           false, 100,   8,   8, NO_STALL},
+		{"Read 300 blocks",         false, 700, 300, 300, NO_STALL},
+		{"Write 1 block",           true,    9,   1,   1, NO_STALL},
+		{"Write 8 blocks",          true,  200,   8,   8, NO_STALL},
+		{"Write 300 blocks",        true,  300, 300, 300, NO_STALL},
+		{"Read abort at block 3",   false,  40,   8,   3, NO_STALL},
+		{"Read abort at block 0",   false,  60,   8,   0, NO_STALL},
+		{"Write abort at block 3",  true,   50,   8,   3, NO_STALL},
+		{"Write abort at block 0",  true,   70,   8,   0, NO_STALL},
+		{"Read stall at block 3",   false,  80,   8,   8, (3 * BLOCK_SIZE)},
+		{"Read stall in block 3",   false,  90,   8,   8, ((3 * BLOCK_SIZE) + 128)},
+		{"Write stall in block 3",  true,  110,   8,   8, ((3 * BLOCK_SIZE) + 128)},
+		{"Write stall last packet", true,  120,   8,   8, ((8 * BLOCK_SIZE) - ENDPOINT_SIZE)},
+	};
+
+/** Returns the expected contents of a byte of the medium, for a given data pattern seed.
+ *
+ *  \param[in] Seed          Seed of the data pattern
+ *  \param[in] BlockAddress  Address of the block containing the byte
+ *  \param[in] Offset        Offset of the byte within the block
+ *
+ *  \return Byte of the data pattern
+ */
+static uint8_t PatternByte(const uint8_t Seed, const uint32_t BlockAddress, const uint16_t Offset)
+{
+	return (uint8_t)((BlockAddress * 31) + (Offset * 7) + (Offset >> 8) + (Seed * 101));
+}
+
+/** Fills the given blocks of the simulated medium with a data pattern.
+ *
+ *  \param[in] Seed          Seed of the data pattern
+ *  \param[in] BlockAddress  First block to fill
+ *  \param[in] Blocks        Number of blocks to fill
+ */
+static void FillMedium(const uint8_t Seed, const uint32_t BlockAddress, const uint32_t Blocks)
+{
+	for (uint32_t Block = BlockAddress; Block < (BlockAddress + Blocks); Block++)
+	{
+		for (uint16_t Offset = 0; Offset < BLOCK_SIZE; Offset++)
+		  Medium[Block][Offset] = PatternByte(Seed, Block, Offset);
+	}
+}
+
+/** Counts the bytes within a range of the medium which do not hold the expected data pattern.
+ *
+ *  \param[in] Seed         Seed of the expected data pattern
+ *  \param[in] StartOffset  Byte offset within the medium of the start of the range
+ *  \param[in] EndOffset    Byte offset within the medium of the end of the range (exclusive)
+ *
+ *  \return Number of mismatched bytes
+ */
+static uint32_t CheckMedium(const uint8_t Seed, const uint32_t StartOffset, const uint32_t EndOffset)
+{
+	uint32_t Mismatches = 0;
+
+	for (uint32_t Offset = StartOffset; Offset < EndOffset; Offset++)
+	{
+		uint32_t Block = (Offset / BLOCK_SIZE);
+
+		if (Medium[Block][Offset % BLOCK_SIZE] != PatternByte(Seed, Block, (Offset % BLOCK_SIZE)))
+		  Mismatches++;
+	}
+
+	return Mismatches;
+}
+
+/** Simulated SOF interrupt flag, so that the driver's timeouts count one USB frame per poll. */
+bool Sim_FrameElapsed(void)
+{
+	return true;
+}
+
+/** Simulated version of the library's descriptor search routine, see ConfigDescriptor.c. */
+uint8_t USB_GetNextDescriptorComp(uint16_t* BytesRem, void** CurrConfigLoc, ConfigComparatorPtr_t ComparatorRoutine)
+{
+	uint8_t ErrorCode;
+
+	while (*BytesRem)
+	{
+		uint8_t*  PrevDescLoc  = *CurrConfigLoc;
+		uint16_t  PrevBytesRem = *BytesRem;
+		uint16_t  CurrDescriptorSize = DESCRIPTOR_PCAST(*CurrConfigLoc, USB_Descriptor_Header_t)->Size;
+
+		*CurrConfigLoc = ((uint8_t*)*CurrConfigLoc + CurrDescriptorSize);
+		*BytesRem     -= CurrDescriptorSize;
+
+		if ((ErrorCode = ComparatorRoutine(*CurrConfigLoc)) != DESCRIPTOR_SEARCH_NotFound)
+		{
+			if (ErrorCode == DESCRIPTOR_SEARCH_Fail)
+			{
+				*CurrConfigLoc = PrevDescLoc;
+				*BytesRem      = PrevBytesRem;
+			}
+
+			return ErrorCode;
+		}
+	}
+
+	return DESCRIPTOR_SEARCH_COMP_EndOfDescriptor;
+}
+
+/** Halts both bulk endpoints of the simulated device, as required by the Bulk-Only Transport specification when the
+ *  host sends an invalid Command Block Wrapper or breaks the transport protocol.
+ */
+static void SimDevice_ProtocolError(void)
+{
+	Device.ProtocolErrors++;
+	Device.INHalted  = true;
+	Device.OUTHalted = true;
+}
+
+/** Processes a Command Block Wrapper received by the simulated device.
+ *
+ *  \param[in] Data    Pointer to the received packet
+ *  \param[in] Length  Length of the received packet in bytes
+ */
+static void SimDevice_ProcessCommandBlock(const uint8_t* Data, const uint16_t Length)
+{
+	MS_CommandBlockWrapper_t* CommandBlock = &Device.CommandBlock;
+
+	if (Length != sizeof(MS_CommandBlockWrapper_t))
+	{
+		SimDevice_ProtocolError();
+		return;
+	}
+
+	memcpy(CommandBlock, Data, sizeof(MS_CommandBlockWrapper_t));
+
+	uint8_t* CDB            = CommandBlock->SCSICommandData;
+	uint32_t BlockAddress   = (((uint32_t)CDB[2] << 24) | ((uint32_t)CDB[3] << 16) | ((uint32_t)CDB[4] << 8) | CDB[5]);
+	uint32_t Blocks         = (((uint16_t)CDB[7] << 8) | CDB[8]);
+	bool     DataIN         = ((CommandBlock->Flags & COMMAND_DIRECTION_DATA_IN) ? true : false);
+
+	/* Only the READ (10) and WRITE (10) commands are issued by the tests, with the block count matching the data length */
+	if ((CommandBlock->Signature != CBW_SIGNATURE) || (CommandBlock->SCSICommandLength != 10) ||
+	    !(((CDB[0] == SCSI_CMD_READ_10) && DataIN) || ((CDB[0] == SCSI_CMD_WRITE_10) && !(DataIN))) ||
+	    (CommandBlock->DataTransferLength != (Blocks * BLOCK_SIZE)) || ((BlockAddress + Blocks) > DISK_BLOCKS))
+	{
+		SimDevice_ProtocolError();
+		return;
+	}
+
+	Device.Commands++;
+	Device.BlockAddress  = BlockAddress;
+	Device.DataOffset    = 0;
+	Device.CommandStatus = SCSI_Command_Pass;
+
+	if (!(CommandBlock->DataTransferLength))
+	  Device.State = DEVICE_STATE_StatusBlock;
+	else
+	  Device.State = (DataIN ? DEVICE_STATE_DataIN : DEVICE_STATE_DataOUT);
+}
+
+/** Sends the simulated device's next IN packet into the given pipe, or stalls the pipe, as the device state requires.
+ *  Nothing is sent (the device NAKs) if the device has no data or status waiting to be sent.
+ *
+ *  \param[in,out] Pipe  Pointer to the simulated IN pipe
+ */
+static void SimDevice_SendIN(SimPipe_t* const Pipe)
+{
+	if (Device.INHalted)
+	{
+		Pipe->Stalled = true;
+		return;
+	}
+
+	if (Device.State == DEVICE_STATE_DataIN)
+	{
+		if (Device.DataOffset == Device.StallAtOffset)
+		{
+			Device.INHalted      = true;
+			Device.CommandStatus = SCSI_Command_Fail;
+			Device.State         = DEVICE_STATE_StatusBlock;
+			Pipe->Stalled        = true;
+			return;
+		}
+
+		uint32_t BytesRem   = (Device.CommandBlock.DataTransferLength - Device.DataOffset);
+		uint16_t PacketSize = ((BytesRem < Pipe->Size) ? BytesRem : Pipe->Size);
+		uint8_t* MediumData = &Medium[Device.BlockAddress][Device.DataOffset];
+
+		memcpy(Pipe->Bank, MediumData, PacketSize);
+		Device.DataOffset += PacketSize;
+
+		if (Device.DataOffset == Device.CommandBlock.DataTransferLength)
+		  Device.State = DEVICE_STATE_StatusBlock;
+
+		Pipe->BankLength = PacketSize;
+	}
+	else if (Device.State == DEVICE_STATE_StatusBlock)
+	{
+		MS_CommandStatusWrapper_t CommandStatus =
+			{
+				.Signature           = CSW_SIGNATURE,
+				.Tag                 = Device.CommandBlock.Tag,
+				.DataTransferResidue = (Device.CommandBlock.DataTransferLength - Device.DataOffset),
+				.Status              = Device.CommandStatus,
+			};
+
+		memcpy(Pipe->Bank, &CommandStatus, sizeof(MS_CommandStatusWrapper_t));
+		Device.State = DEVICE_STATE_CommandBlock;
+
+		Pipe->BankLength = sizeof(MS_CommandStatusWrapper_t);
+	}
+	else
+	{
+		return;
+	}
+
+	Pipe->BankPosition = 0;
+	Pipe->INReceived   = true;
+	IdlePolls          = 0;
+}
+
+/** Delivers the OUT packet held in the given pipe to the simulated device, which either takes the packet or stalls it.
+ *
+ *  \param[in,out] Pipe  Pointer to the simulated OUT pipe
+ */
+static void SimDevice_ReceiveOUT(SimPipe_t* const Pipe)
+{
+	if (Device.OUTHalted)
+	{
+		Pipe->Stalled = true;
+		return;
+	}
+
+	if (Device.State == DEVICE_STATE_CommandBlock)
+	{
+		SimDevice_ProcessCommandBlock(Pipe->Bank, Pipe->BankLength);
+	}
+	else if (Device.State == DEVICE_STATE_DataOUT)
+	{
+		uint32_t BytesRem = (Device.CommandBlock.DataTransferLength - Device.DataOffset);
+
+		if (Device.DataOffset == Device.StallAtOffset)
+		{
+			Device.OUTHalted     = true;
+			Device.CommandStatus = SCSI_Command_Fail;
+			Device.State         = DEVICE_STATE_StatusBlock;
+			Pipe->Stalled        = true;
+			return;
+		}
+
+		if (Pipe->BankLength > BytesRem)
+		{
+			SimDevice_ProtocolError();
+		}
+		else
+		{
+			memcpy(&Medium[Device.BlockAddress][Device.DataOffset], Pipe->Bank, Pipe->BankLength);
+			Device.DataOffset += Pipe->BankLength;
+
+			if (Device.DataOffset == Device.CommandBlock.DataTransferLength)
+			  Device.State = DEVICE_STATE_StatusBlock;
+		}
+	}
+	else
+	{
+		/* The host sent a packet while the device was waiting to send data or status */
+		SimDevice_ProtocolError();
+	}
+
+	if (Device.OUTHalted)
+	{
+		Pipe->Stalled = true;
+		return;
+	}
+
+	Pipe->OUTPending = false;
+	Pipe->BankLength = 0;
+	IdlePolls        = 0;
+}
+
+/** Runs the simulated bus for the given pipe, transferring a packet between the pipe and the device if one can be
+ *  transferred. A pipe which has been polled for too long without a packet being transferred is treated as a hung
+ *  transfer, and detaches the device so that the driver's polling loops end.
+ *
+ *  \param[in,out] Pipe  Pointer to the simulated pipe
+ */
+static void SimBus_Service(SimPipe_t* const Pipe)
+{
+	if (!(Pipe->Frozen) && !(Pipe->Stalled))
+	{
+		if ((Pipe->Token == PIPE_TOKEN_IN) && !(Pipe->INReceived))
+		  SimDevice_SendIN(Pipe);
+		else if ((Pipe->Token == PIPE_TOKEN_OUT) && Pipe->OUTPending)
+		  SimDevice_ReceiveOUT(Pipe);
+	}
+
+	if (++IdlePolls == HANG_POLL_LIMIT)
+	{
+		BusErrors++;
+		USB_HostState = HOST_STATE_Unattached;
+	}
+}
+
+/** Simulated control transfer to the device, handling the Mass Storage class requests and the standard CLEAR FEATURE
+ *  (ENDPOINT HALT) request. All other requests, and requests addressing an unknown endpoint, are stalled.
+ *
+ *  \param[in] BufferPtr  Pointer to the data stage buffer of the request (unused)
+ *
+ *  \return A value from the \ref USB_Host_SendControlErrorCodes_t enum
+ */
+uint8_t USB_Host_SendControlRequest(void* BufferPtr)
+{
+	USB_Request_Header_t* Request = &USB_ControlRequest;
+
+	if (USB_HostState == HOST_STATE_Unattached)
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	if ((Request->bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE)) &&
+	    (Request->bRequest == REQ_MassStorageReset) && (Request->wIndex == 0))
+	{
+		/* A reset readies the device for the next command, but leaves any halted endpoints halted */
+		Device.Resets++;
+		Device.State = DEVICE_STATE_CommandBlock;
+
+		return HOST_SENDCONTROL_Successful;
+	}
+
+	if ((Request->bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_ENDPOINT)) &&
+	    (Request->bRequest == REQ_ClearFeature) && (Request->wValue == FEATURE_ENDPOINT_HALT))
+	{
+		if (Request->wIndex == DEVICE_IN_EPADDR)
+		{
+			Device.INHalted = false;
+			Device.ClearHalts++;
+
+			return HOST_SENDCONTROL_Successful;
+		}
+		else if (Request->wIndex == DEVICE_OUT_EPADDR)
+		{
+			Device.OUTHalted = false;
+			Device.ClearHalts++;
+
+			return HOST_SENDCONTROL_Successful;
+		}
+	}
+
+	Device.ProtocolErrors++;
+	return HOST_SENDCONTROL_SetupStalled;
+}
+
+/** Simulated version of the library's pipe stall clearing routine, see LowLevel/Host.c. */
+uint8_t USB_Host_ClearPipeStall(uint8_t EndpointNum)
+{
+	if (Pipe_GetPipeToken() == PIPE_TOKEN_IN)
+	  EndpointNum |= ENDPOINT_DESCRIPTOR_DIR_IN;
+
+	USB_ControlRequest = (USB_Request_Header_t)
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_ENDPOINT),
+			.bRequest      = REQ_ClearFeature,
+			.wValue        = FEATURE_ENDPOINT_HALT,
+			.wIndex        = EndpointNum,
+			.wLength       = 0,
+		};
+
+	Pipe_SelectPipe(PIPE_CONTROLPIPE);
+
+	return USB_Host_SendControlRequest(NULL);
+}
+
+/* Simulated pipe interface of the USB bus, in place of the AVR pipe driver (see LowLevel/Pipe.h): */
+bool Pipe_ConfigurePipe(const uint8_t Number, const uint8_t Type, const uint8_t Token, const uint8_t EndpointNumber,
+                        const uint16_t Size, const uint8_t Banks)
+{
+	if ((Number >= TOTAL_PIPES) || (Size > ENDPOINT_SIZE) || (Type != EP_TYPE_BULK))
+	  return false;
+
+	Pipes[Number] = (SimPipe_t)
+		{
+			.Token           = Token,
+			.EndpointAddress = EndpointNumber,
+			.Size            = Size,
+			.Frozen          = true,
+		};
+
+	return true;
+}
+
+bool Pipe_IsEndpointBound(const uint8_t EndpointAddress)
+{
+	return false;
+}
+
+void Pipe_SelectPipe(const uint8_t PipeNumber)
+{
+	SelectedPipe = &Pipes[PipeNumber];
+}
+
+void Pipe_ResetPipe(const uint8_t PipeNumber)
+{
+	SimPipe_t* Pipe = &Pipes[PipeNumber];
+
+	Pipe->Stalled      = false;
+	Pipe->INReceived   = false;
+	Pipe->OUTPending   = false;
+	Pipe->BankLength   = 0;
+	Pipe->BankPosition = 0;
+}
+
+uint8_t Pipe_BoundEndpointNumber(void)
+{
+	return (SelectedPipe->EndpointAddress & PIPE_EPNUM_MASK);
+}
+
+uint8_t Pipe_GetPipeToken(void)
+{
+	return SelectedPipe->Token;
+}
+
+void Pipe_SetPipeToken(const uint8_t Token)
+{
+	SelectedPipe->Token = Token;
+}
+
+void Pipe_Freeze(void)
+{
+	SelectedPipe->Frozen = true;
+}
+
+void Pipe_Unfreeze(void)
+{
+	SelectedPipe->Frozen = false;
+	SimBus_Service(SelectedPipe);
+}
+
+bool Pipe_IsINReceived(void)
+{
+	SimBus_Service(SelectedPipe);
+	return SelectedPipe->INReceived;
+}
+
+bool Pipe_IsOUTReady(void)
+{
+	SimBus_Service(SelectedPipe);
+	return !(SelectedPipe->OUTPending);
+}
+
+bool Pipe_IsStalled(void)
+{
+	SimBus_Service(SelectedPipe);
+	return SelectedPipe->Stalled;
+}
+
+bool Pipe_IsReadWriteAllowed(void)
+{
+	if (SelectedPipe->Token == PIPE_TOKEN_IN)
+	  return (SelectedPipe->INReceived && (SelectedPipe->BankPosition < SelectedPipe->BankLength));
+	else
+	  return (!(SelectedPipe->OUTPending) && (SelectedPipe->BankLength < SelectedPipe->Size));
+}
+
+uint16_t Pipe_BytesInPipe(void)
+{
+	if (SelectedPipe->Token == PIPE_TOKEN_IN)
+	  return (SelectedPipe->BankLength - SelectedPipe->BankPosition);
+	else
+	  return (SelectedPipe->OUTPending ? 0 : SelectedPipe->BankLength);
+}
+
+uint8_t Pipe_Read_Byte(void)
+{
+	if (!(SelectedPipe->INReceived) || (SelectedPipe->BankPosition == SelectedPipe->BankLength))
+	{
+		BusErrors++;
+		return 0;
+	}
+
+	return SelectedPipe->Bank[SelectedPipe->BankPosition++];
+}
+
+void Pipe_Write_Byte(const uint8_t Byte)
+{
+	if (SelectedPipe->OUTPending || (SelectedPipe->BankLength == SelectedPipe->Size))
+	{
+		BusErrors++;
+		return;
+	}
+
+	SelectedPipe->Bank[SelectedPipe->BankLength++] = Byte;
+}
+
+void Pipe_ClearIN(void)
+{
+	SelectedPipe->INReceived   = false;
+	SelectedPipe->BankLength   = 0;
+	SelectedPipe->BankPosition = 0;
+
+	/* An unfrozen IN pipe requests the next packet as soon as its bank is free */
+	SimBus_Service(SelectedPipe);
+}
+
+void Pipe_ClearOUT(void)
+{
+	SelectedPipe->OUTPending = true;
+	SimBus_Service(SelectedPipe);
+}
+
+/** Simulated version of the library's pipe ready wait routine, see LowLevel/Pipe.c. */
+uint8_t Pipe_WaitUntilReady(void)
+{
+	uint16_t TimeoutMSRem = USB_STREAM_TIMEOUT_MS;
+
+	for (;;)
+	{
+		if (Pipe_GetPipeToken() == PIPE_TOKEN_IN)
+		{
+			if (Pipe_IsINReceived())
+			  return PIPE_READYWAIT_NoError;
+		}
+		else
+		{
+			if (Pipe_IsOUTReady())
+			  return PIPE_READYWAIT_NoError;
+		}
+
+		if (Pipe_IsStalled())
+		  return PIPE_READYWAIT_PipeStalled;
+		else if (USB_HostState == HOST_STATE_Unattached)
+		  return PIPE_READYWAIT_DeviceDisconnected;
+
+		if (USB_INT_HasOccurred(USB_INT_HSOFI))
+		{
+			USB_INT_Clear(USB_INT_HSOFI);
+
+			if (!(TimeoutMSRem--))
+			  return PIPE_READYWAIT_Timeout;
+		}
+	}
+}
+
+/* The pipe stream functions the driver uses, built from the library's own template as in LowLevel/Pipe.c: */
+#define  TEMPLATE_FUNC_NAME                        Pipe_Write_Stream_LE
+#define  TEMPLATE_BUFFER_TYPE                      const void*
+#define  TEMPLATE_TOKEN                            PIPE_TOKEN_OUT
+#define  TEMPLATE_CLEAR_PIPE()                     Pipe_ClearOUT()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Pipe_Write_Byte(*((uint8_t*)BufferPtr++))
+#include "../../../LowLevel/Template/Template_Pipe_RW.c"
+
+#define  TEMPLATE_FUNC_NAME                        Pipe_Read_Stream_LE
+#define  TEMPLATE_BUFFER_TYPE                      void*
+#define  TEMPLATE_TOKEN                            PIPE_TOKEN_IN
+#define  TEMPLATE_CLEAR_PIPE()                     Pipe_ClearIN()
+#define  TEMPLATE_BUFFER_OFFSET(Length)            0
+#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *((uint8_t*)BufferPtr++) = Pipe_Read_Byte()
+#include "../../../LowLevel/Template/Template_Pipe_RW.c"
+
+/** Block callback for the streamed reads, checking the block addresses and contents passed by the driver. The
+ *  callback aborts the transfer at the block set in the callback state.
+ */
+static bool ReadBlockCallback(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint32_t BlockAddress,
+                              void* BlockBuffer)
+{
+	uint16_t CurrBlock = CallbackState.Calls++;
+
+	if (BlockAddress != (CallbackState.BlockAddress + CurrBlock))
+	  CallbackState.Errors++;
+
+	if (memcmp(BlockBuffer, Medium[BlockAddress % DISK_BLOCKS], BLOCK_SIZE))
+	  CallbackState.Errors++;
+
+	/* Corrupt the buffer, so that stale data is caught if the driver does not refill it for the next block */
+	memset(BlockBuffer, 0xA5, BLOCK_SIZE);
+
+	return (CurrBlock != CallbackState.AbortAtBlock);
+}
+
+/** Block callback for the streamed writes, checking the block addresses passed by the driver and filling each block
+ *  with the data pattern of the callback state. The callback aborts the transfer at the block set in the callback state.
+ */
+static bool WriteBlockCallback(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint32_t BlockAddress,
+                               void* BlockBuffer)
+{
+	uint16_t CurrBlock = CallbackState.Calls++;
+
+	if (BlockAddress != (CallbackState.BlockAddress + CurrBlock))
+	  CallbackState.Errors++;
+
+	for (uint16_t Offset = 0; Offset < BLOCK_SIZE; Offset++)
+	  ((uint8_t*)BlockBuffer)[Offset] = PatternByte(CallbackState.Seed, BlockAddress, Offset);
+
+	return (CurrBlock != CallbackState.AbortAtBlock);
+}
+
+/** Runs a single test scenario, printing out its results.
+ *
+ *  \param[in] Scenario  Scenario to run
+ *
+ *  \return Number of errors found in the scenario
+ */
+static uint32_t RunScenario(const Scenario_t* const Scenario)
+{
+	static uint8_t BlockBuffer[BLOCK_SIZE];
+
+	const uint8_t OldSeed = 1;
+	const uint8_t NewSeed = 2;
+
+	uint32_t Errors        = 0;
+	uint32_t StartOffset   = (Scenario->BlockAddress * BLOCK_SIZE);
+	uint32_t TransferBytes = ((uint32_t)Scenario->Blocks * BLOCK_SIZE);
+	uint8_t  ExpectedError = PIPE_RWSTREAM_NoError;
+	uint16_t ExpectedCalls = Scenario->Blocks;
+	uint32_t WrittenBytes  = 0;
+
+	FillMedium(OldSeed, 0, DISK_BLOCKS);
+
+	Device        = (SimDevice_t){.State = DEVICE_STATE_CommandBlock, .StallAtOffset = Scenario->StallAtOffset};
+	CallbackState = (CallbackState_t){.BlockAddress = Scenario->BlockAddress, .AbortAtBlock = Scenario->AbortAtBlock,
+	                                  .Seed = NewSeed};
+	BusErrors     = 0;
+	IdlePolls     = 0;
+	USB_HostState = HOST_STATE_Configured;
+
+	if (Scenario->AbortAtBlock < Scenario->Blocks)
+	{
+		ExpectedError = PIPE_RWSTREAM_CallbackAborted;
+		ExpectedCalls = (Scenario->AbortAtBlock + 1);
+		WrittenBytes  = ((uint32_t)Scenario->AbortAtBlock * BLOCK_SIZE);
+	}
+	else if (Scenario->StallAtOffset != NO_STALL)
+	{
+		ExpectedError = PIPE_RWSTREAM_PipeStalled;
+		ExpectedCalls = (Scenario->StallAtOffset / BLOCK_SIZE);
+		WrittenBytes  = Scenario->StallAtOffset;
+
+		/* A write callback fills each block before it is sent, so is also called for the block the stall is found in */
+		if (Scenario->Write)
+		  ExpectedCalls = ((ExpectedCalls < Scenario->Blocks) ? (ExpectedCalls + 1) : Scenario->Blocks);
+	}
+	else
+	{
+		WrittenBytes  = TransferBytes;
+	}
+
+	uint8_t ErrorCode;
+
+	if (Scenario->Write)
+	{
+		ErrorCode = MS_Host_WriteDeviceBlocks_Stream(&MSInterface, 0, Scenario->BlockAddress, Scenario->Blocks,
+		                                             BLOCK_SIZE, BlockBuffer, WriteBlockCallback);
+	}
+	else
+	{
+		ErrorCode = MS_Host_ReadDeviceBlocks_Stream(&MSInterface, 0, Scenario->BlockAddress, Scenario->Blocks,
+		                                            BLOCK_SIZE, BlockBuffer, ReadBlockCallback);
+	}
+
+	uint16_t Calls      = CallbackState.Calls;
+	uint32_t Mismatches = CallbackState.Errors;
+
+	if (ErrorCode != ExpectedError)
+	  Errors++;
+
+	if (Calls != ExpectedCalls)
+	  Errors++;
+
+	/* A written transfer must reach the medium up to the point it was ended, and leave the rest of the medium intact */
+	if (Scenario->Write)
+	{
+		Mismatches += CheckMedium(OldSeed, 0, StartOffset);
+		Mismatches += CheckMedium(NewSeed, StartOffset, (StartOffset + WrittenBytes));
+		Mismatches += CheckMedium(OldSeed, (StartOffset + WrittenBytes), (DISK_BLOCKS * BLOCK_SIZE));
+	}
+	else
+	{
+		Mismatches += CheckMedium(OldSeed, 0, (DISK_BLOCKS * BLOCK_SIZE));
+	}
+
+	/* An ended transfer must leave both pipes frozen, and the device ready for the next command */
+	if (!(Pipes[DATA_IN_PIPE].Frozen) || !(Pipes[DATA_OUT_PIPE].Frozen))
+	  Errors++;
+
+	uint32_t Resets      = Device.Resets;
+	uint32_t ClearHalts  = Device.ClearHalts;
+	uint32_t CheckBlocks = 16;
+
+	CallbackState = (CallbackState_t){.BlockAddress = 0, .AbortAtBlock = CheckBlocks};
+	Device.StallAtOffset = NO_STALL;
+
+	uint8_t CheckErrorCode = MS_Host_ReadDeviceBlocks_Stream(&MSInterface, 0, 0, CheckBlocks, BLOCK_SIZE,
+	                                                         BlockBuffer, ReadBlockCallback);
+
+	if ((CheckErrorCode != PIPE_RWSTREAM_NoError) || (CallbackState.Calls != CheckBlocks) || CallbackState.Errors)
+	  Errors++;
+
+	Errors += (Mismatches + Device.ProtocolErrors + BusErrors);
+
+	printf("%-24s %5u %5u %5u %5u %6lu %6lu %9lu %7lu %5lu   %s\n", Scenario->Name, Scenario->Blocks, ErrorCode,
+	       ExpectedError, Calls, (unsigned long)Resets, (unsigned long)ClearHalts, (unsigned long)Mismatches,
+	       (unsigned long)Device.ProtocolErrors, (unsigned long)BusErrors, (Errors ? "FAIL" : "ok"));
+
+	return Errors;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	USB_HostState = HOST_STATE_Configured;
+
+	if (MS_Host_ConfigurePipes(&MSInterface, sizeof(ConfigDescriptor), (void*)&ConfigDescriptor) != MS_ENUMERROR_NoError)
+	{
+		printf("FAILED: simulated device not enumerated\n");
+		return 1;
+	}
+
+	printf("Mass Storage host stream test, %u byte blocks, %u byte endpoints\n\n", BLOCK_SIZE, ENDPOINT_SIZE);
+	printf("%-24s %5s %5s %5s %5s %6s %6s %9s %7s %5s   %s\n", "Scenario", "Blks", "Error", "Expct", "Calls",
+	       "Resets", "Clears", "BadBytes", "Protocl", "Bus", "Result");
+
+	for (uint8_t ScenarioIndex = 0; ScenarioIndex < (sizeof(Scenarios) / sizeof(Scenarios[0])); ScenarioIndex++)
+	  TotalErrors += RunScenario(&Scenarios[ScenarioIndex]);
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	printf("\nAll scenarios passed.\n");
+	return 0;
+}
@@ -124,6 +124,25 @@ static uint8_t DComp_MIDI_Host_NextMIDIStreamingDataEndpoint(void* const Current
 	return DESCRIPTOR_SEARCH_NotFound;
 }
 
+void MIDI_Host_USBTask(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive) ||
+	    !(MIDIInterfaceInfo->Config.DataOUTFlushFrames))
+	{
+		return;
+	}
+
+	Pipe_SelectPipe(MIDIInterfaceInfo->Config.DataOUTPipeNumber);
+
+	if (!(Pipe_IsOUTReady()) || !(Pipe_BytesInPipe()))
+	  return;
+
+	uint16_t FramesHeld = ((USB_Host_GetFrameNumber() - MIDIInterfaceInfo->State.DataOUTBankFrame) & MIDI_FRAME_NUMBER_MASK);
+
+	if (FramesHeld >= MIDIInterfaceInfo->Config.DataOUTFlushFrames)
+	  Pipe_ClearOUT();
+}
+
 uint8_t MIDI_Host_Flush(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo)
 {
 	if (USB_HostState != HOST_STATE_Configured)
@@ -149,20 +168,64 @@ uint8_t MIDI_Host_SendEventPacket(USB_ClassInfo_MIDI_Host_t* const MIDIInterface
 	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive))
 	  return HOST_SENDCONTROL_DeviceDisconnected;
 	
+	uint8_t ErrorCode;
+
+	Pipe_SelectPipe(MIDIInterfaceInfo->Config.DataOUTPipeNumber);
+
+	if ((ErrorCode = Pipe_WaitUntilReady()) != PIPE_READYWAIT_NoError)
+	  return ErrorCode;
+
+	if (!(Pipe_BytesInPipe()))
+	  MIDIInterfaceInfo->State.DataOUTBankFrame = USB_Host_GetFrameNumber();
+
+	if ((ErrorCode = Pipe_Write_Stream_LE(Event, sizeof(MIDI_EventPacket_t), NO_STREAM_CALLBACK)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if (!(Pipe_IsReadWriteAllowed()))
+	  Pipe_ClearOUT();
+	
+	return PIPE_RWSTREAM_NoError;
+}
+
+uint8_t MIDI_Host_SendEventPackets(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+                                   const MIDI_EventPacket_t* Events, uint8_t TotalEvents)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive))
+	  return 0;
+
+	uint8_t EventsSent = 0;
+
 	Pipe_SelectPipe(MIDIInterfaceInfo->Config.DataOUTPipeNumber);
 
-	if (Pipe_IsReadWriteAllowed())
+	while (TotalEvents && Pipe_IsReadWriteAllowed())
 	{
-		uint8_t ErrorCode;
+		uint16_t BytesInBank = Pipe_BytesInPipe();
+		uint8_t  BankEvents  = ((MIDIInterfaceInfo->State.DataOUTPipeSize - BytesInBank) / sizeof(MIDI_EventPacket_t));
 
-		if ((ErrorCode = Pipe_Write_Stream_LE(Event, sizeof(MIDI_EventPacket_t), NO_STREAM_CALLBACK)) != PIPE_RWSTREAM_NoError)
-		  return ErrorCode;
+		if (!(BankEvents))
+		{
+			Pipe_ClearOUT();
+			continue;
+		}
+
+		if (BankEvents > TotalEvents)
+		  BankEvents = TotalEvents;
+
+		if (!(BytesInBank))
+		  MIDIInterfaceInfo->State.DataOUTBankFrame = USB_Host_GetFrameNumber();
+
+		if (Pipe_Write_Stream_LE(Events, (BankEvents * sizeof(MIDI_EventPacket_t)), NO_STREAM_CALLBACK) != PIPE_RWSTREAM_NoError)
+		  break;
+
+		Events      += BankEvents;
+		TotalEvents -= BankEvents;
+		EventsSent  += BankEvents;
 
 		if (!(Pipe_IsReadWriteAllowed()))
 		  Pipe_ClearOUT();
 	}
-	
-	return PIPE_RWSTREAM_NoError;
+
+	return EventsSent;
 }
 
 bool MIDI_Host_ReceiveEventPacket(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo, MIDI_EventPacket_t* const Event)
@@ -183,4 +246,34 @@ bool MIDI_Host_ReceiveEventPacket(USB_ClassInfo_MIDI_Host_t* const MIDIInterface
 	return true;
 }
 
+uint8_t MIDI_Host_ReceiveEventPackets(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+                                      MIDI_EventPacket_t* Events, const uint8_t MaxEvents)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive))
+	  return 0;
+
+	uint8_t EventsReceived = 0;
+
+	Pipe_SelectPipe(MIDIInterfaceInfo->Config.DataINPipeNumber);
+
+	while ((EventsReceived < MaxEvents) && Pipe_IsINReceived())
+	{
+		uint8_t BankEvents = (Pipe_BytesInPipe() / sizeof(MIDI_EventPacket_t));
+
+		if (BankEvents > (MaxEvents - EventsReceived))
+		  BankEvents = (MaxEvents - EventsReceived);
+
+		if (Pipe_Read_Stream_LE(Events, (BankEvents * sizeof(MIDI_EventPacket_t)), NO_STREAM_CALLBACK) != PIPE_RWSTREAM_NoError)
+		  break;
+
+		Events         += BankEvents;
+		EventsReceived += BankEvents;
+
+		if (Pipe_BytesInPipe() < sizeof(MIDI_EventPacket_t))
+		  Pipe_ClearIN();
+	}
+
+	return EventsReceived;
+}
+
 #endif
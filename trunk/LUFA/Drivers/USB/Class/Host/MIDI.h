@@ -84,6 +84,11 @@
 					
 					uint8_t  DataOUTPipeNumber; /**< Pipe number of the MIDI interface's streaming OUT data pipe */
 					bool     DataOUTPipeDoubleBank; /** Indicates if the MIDI interface's OUT data pipe should use double banking */
+
+					uint8_t  DataOUTFlushFrames; /**< Maximum number of frames a partially filled OUT pipe bank may be held
+					                              *   before it is sent to the device by \ref MIDI_Host_USBTask(), or zero to
+					                              *   only send partially filled banks when \ref MIDI_Host_Flush() is called
+					                              */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -96,6 +101,8 @@
 
 					uint16_t DataINPipeSize; /**< Size in bytes of the MIDI Streaming Data interface's IN data pipe */
 					uint16_t DataOUTPipeSize;  /**< Size in bytes of the MIDI Streaming Data interface's OUT data pipe */
+
+					uint16_t DataOUTBankFrame; /**< Frame number at which the first event was queued into the current OUT pipe bank */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 						  *   <b>may</b> be set to initial values, but may also be ignored to default to sane values when
 						  *   the interface is enumerated.
@@ -128,7 +135,9 @@
 			uint8_t MIDI_Host_ConfigurePipes(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo, uint16_t ConfigDescriptorSize,
 			                                 void* DeviceConfigDescriptor) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3);
 
-			/** Sends a MIDI event packet to the device. If no device is connected, the event packet is discarded.
+			/** Sends a MIDI event packet to the device. If no device is connected, the event packet is discarded. If the pipe bank
+			 *  is not yet ready for the event, this function waits until the device has accepted the previously sent packet,
+			 *  returning an error code instead if the pipe timeout expires first.
 			 *
 			 *  \note This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
 			 *        call will fail.
@@ -141,6 +150,25 @@
 			uint8_t MIDI_Host_SendEventPacket(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
 			                                  MIDI_EventPacket_t* const Event) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 
+			/** Sends several MIDI event packets to the device in a single call. Events are packed into the pipe banks a full bank
+			 *  at a time, and each bank is sent to the device as soon as it is filled. This function does not block; if the device
+			 *  has not yet accepted the previously sent banks only those events which fit into the free pipe banks are queued, and
+			 *  the remainder should be passed again on a later call. Partially filled banks are sent either by \ref MIDI_Host_Flush(),
+			 *  or by \ref MIDI_Host_USBTask() once the interface's DataOUTFlushFrames deadline has elapsed.
+			 *
+			 *  \note This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *        call will fail.
+			 *
+			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state
+			 *  \param[in] Events  Pointer to an array of populated MIDI_EventPacket_t structures containing the MIDI events to send
+			 *  \param[in] TotalEvents  Number of events in the Events array
+			 *
+			 *  \return Number of events from the Events array which were queued for transmission
+			 */
+			uint8_t MIDI_Host_SendEventPackets(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+			                                   const MIDI_EventPacket_t* Events, uint8_t TotalEvents)
+			                                   ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
 			/** Flushes the MIDI send buffer, sending any queued MIDI events to the device. This should be called to override the
 			 *  \ref MIDI_Host_SendEventPacket() function's packing behaviour, to flush queued events. Events are queued into the
 			 *  pipe bank until either the pipe bank is full, or \ref MIDI_Host_Flush() is called. This allows for multiple MIDI
@@ -165,17 +193,31 @@
 			bool MIDI_Host_ReceiveEventPacket(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
 			                                  MIDI_EventPacket_t* const Event) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 
-		/* Inline Functions: */
+			/** Receives several MIDI event packets from the device in a single call. Events are unpacked from the pipe until
+			 *  either the given array is full or no further events have been received from the device, clearing each pipe bank
+			 *  once it has been emptied.
+			 *
+			 *  \note This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *        call will fail.
+			 *
+			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state
+			 *  \param[out] Events  Pointer to an array of MIDI_EventPacket_t structures where the received MIDI events are to be placed
+			 *  \param[in] MaxEvents  Maximum number of events which may be stored into the Events array
+			 *
+			 *  \return Number of events received and stored into the Events array
+			 */
+			uint8_t MIDI_Host_ReceiveEventPackets(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+			                                      MIDI_EventPacket_t* Events, const uint8_t MaxEvents)
+			                                      ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
 			/** General management task for a given MIDI host class interface, required for the correct operation of the interface. This should
-			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
+			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask(). When the
+			 *  interface's DataOUTFlushFrames configuration value is non-zero, this sends any partially filled OUT pipe bank to the
+			 *  device once it has been held for the configured number of frames.
 			 *
 			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing an MIDI Class host configuration and state
 			 */
-			static inline void MIDI_Host_USBTask(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo);
-			static inline void MIDI_Host_USBTask(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo)
-			{
-				(void)MIDIInterfaceInfo;
-			}
+			void MIDI_Host_USBTask(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
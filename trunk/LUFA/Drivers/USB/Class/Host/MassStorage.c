@@ -168,6 +168,7 @@ static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInte
 	Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipeNumber);
 	Pipe_Unfreeze();
 
+	/* The IN pipe is left unfrozen while polling, as the OUT pipe is idle and cannot be stalled during an IN transfer */
 	while (!(Pipe_IsINReceived()))
 	{
 		if (USB_INT_HasOccurred(USB_INT_HSOFI))
@@ -178,25 +179,10 @@ static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInte
 			if (!(TimeoutMSRem))
 			  return PIPE_RWSTREAM_Timeout;
 		}
-	
-		Pipe_Freeze();
-		Pipe_SelectPipe(MSInterfaceInfo->Config.DataOUTPipeNumber);
-		Pipe_Unfreeze();
-
-		if (Pipe_IsStalled())
-		{
-			USB_Host_ClearPipeStall(MSInterfaceInfo->Config.DataOUTPipeNumber);
-
-			return PIPE_RWSTREAM_PipeStalled;
-		}
-		
-		Pipe_Freeze();
-		Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipeNumber);
-		Pipe_Unfreeze();
 
 		if (Pipe_IsStalled())
 		{
-			USB_Host_ClearPipeStall(MSInterfaceInfo->Config.DataINPipeNumber);
+			USB_Host_ClearPipeStall(Pipe_BoundEndpointNumber());
 
 			return PIPE_RWSTREAM_PipeStalled;
 		}
@@ -204,12 +190,6 @@ static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInte
 		if (USB_HostState == HOST_STATE_Unattached)
 		  return PIPE_RWSTREAM_DeviceDisconnected;
 	};
-	
-	Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipeNumber);
-	Pipe_Freeze();
-		
-	Pipe_SelectPipe(MSInterfaceInfo->Config.DataOUTPipeNumber);
-	Pipe_Freeze();
 
 	return PIPE_RWSTREAM_NoError;
 }
@@ -258,6 +238,98 @@ static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfac
 	return ErrorCode;
 }
 
+static uint8_t MS_Host_StreamBlockData(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                       MS_CommandBlockWrapper_t* const SCSICommandBlock, const uint32_t BlockAddress,
+                                       const uint16_t BlockSize, void* BlockBuffer, MS_Host_BlockCallback_t const Callback)
+{
+	uint8_t  ErrorCode   = PIPE_RWSTREAM_NoError;
+	uint16_t TotalBlocks = (SCSICommandBlock->DataTransferLength / BlockSize);
+
+	for (uint16_t CurrBlock = 0; CurrBlock < TotalBlocks; CurrBlock++)
+	{
+		if (SCSICommandBlock->Flags & COMMAND_DIRECTION_DATA_IN)
+		{
+			if ((ErrorCode = MS_Host_WaitForDataReceived(MSInterfaceInfo)) != PIPE_RWSTREAM_NoError)
+			{
+				Pipe_Freeze();
+				return ErrorCode;
+			}
+
+			if ((ErrorCode = Pipe_Read_Stream_LE(BlockBuffer, BlockSize, NO_STREAM_CALLBACK)) != PIPE_RWSTREAM_NoError)
+			  return ErrorCode;
+
+			/* Release the emptied bank, so that the device can send more data while the block is processed */
+			if (!(Pipe_IsReadWriteAllowed()))
+			  Pipe_ClearIN();
+
+			if (!(Callback(MSInterfaceInfo, (BlockAddress + CurrBlock), BlockBuffer)))
+			  return MS_Host_AbortDataPhase(MSInterfaceInfo, PIPE_RWSTREAM_CallbackAborted);
+		}
+		else
+		{
+			if (!(Callback(MSInterfaceInfo, (BlockAddress + CurrBlock), BlockBuffer)))
+			  return MS_Host_AbortDataPhase(MSInterfaceInfo, PIPE_RWSTREAM_CallbackAborted);
+
+			/* Reselect the OUT pipe each block, as the callback may have used other pipes */
+			Pipe_SelectPipe(MSInterfaceInfo->Config.DataOUTPipeNumber);
+			Pipe_Unfreeze();
+
+			if ((ErrorCode = Pipe_Write_Stream_LE(BlockBuffer, BlockSize, NO_STREAM_CALLBACK)) != PIPE_RWSTREAM_NoError)
+			  return ErrorCode;
+
+			/* Send the filled bank, so that it is transferred while the next block is prepared */
+			if (!(Pipe_IsReadWriteAllowed()))
+			  Pipe_ClearOUT();
+		}
+	}
+
+	if (SCSICommandBlock->Flags & COMMAND_DIRECTION_DATA_IN)
+	{
+		/* Reselect the IN pipe, as the callback of the last block may have used other pipes */
+		Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipeNumber);
+	}
+	else
+	{
+		/* Send any partially filled bank remaining after the last block */
+		if (Pipe_BytesInPipe())
+		  Pipe_ClearOUT();
+
+		while (!(Pipe_IsOUTReady()))
+		{
+			if (Pipe_IsStalled())
+			  return PIPE_RWSTREAM_PipeStalled;
+			else if (USB_HostState == HOST_STATE_Unattached)
+			  return PIPE_RWSTREAM_DeviceDisconnected;
+		}
+	}
+
+	Pipe_Freeze();
+
+	return ErrorCode;
+}
+
+static uint8_t MS_Host_AbortDataPhase(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t ErrorCode)
+{
+	Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipeNumber);
+	Pipe_Freeze();
+	Pipe_SelectPipe(MSInterfaceInfo->Config.DataOUTPipeNumber);
+	Pipe_Freeze();
+
+	/* End the data phase with a Bulk-Only reset recovery, so that the device discards the remainder of the command */
+	if (MS_Host_ResetMSInterface(MSInterfaceInfo) != HOST_SENDCONTROL_Successful)
+	  return ErrorCode;
+
+	Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipeNumber);
+	USB_Host_ClearPipeStall(Pipe_BoundEndpointNumber());
+	Pipe_ResetPipe(MSInterfaceInfo->Config.DataINPipeNumber);
+
+	Pipe_SelectPipe(MSInterfaceInfo->Config.DataOUTPipeNumber);
+	USB_Host_ClearPipeStall(Pipe_BoundEndpointNumber());
+	Pipe_ResetPipe(MSInterfaceInfo->Config.DataOUTPipeNumber);
+
+	return ErrorCode;
+}
+
 static uint8_t MS_Host_GetReturnedStatus(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
                                          MS_CommandStatusWrapper_t* const SCSICommandStatus)
 {
@@ -597,4 +669,110 @@ uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo
 	return PIPE_RWSTREAM_NoError;
 }
 
+uint8_t MS_Host_ReadDeviceBlocks_Stream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+                                        const uint32_t BlockAddress, const uint16_t Blocks, const uint16_t BlockSize,
+                                        void* BlockBuffer, MS_Host_BlockCallback_t const Callback)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	uint8_t ErrorCode;
+
+	MS_CommandBlockWrapper_t SCSICommandBlock = (MS_CommandBlockWrapper_t)
+		{
+			.Signature          = CBW_SIGNATURE,
+			.DataTransferLength = ((uint32_t)Blocks * BlockSize),
+			.Flags              = COMMAND_DIRECTION_DATA_IN,
+			.LUN                = LUNIndex,
+			.SCSICommandLength  = 10,
+			.SCSICommandData    =
+				{
+					SCSI_CMD_READ_10,
+					0x00,                   // Unused (control bits, all off)
+					(BlockAddress >> 24),   // MSB of Block Address
+					(BlockAddress >> 16),
+					(BlockAddress >> 8),
+					(BlockAddress & 0xFF),  // LSB of Block Address
+					0x00,                   // Unused (reserved)
+					(Blocks >> 8),          // MSB of Total Blocks to Read
+					(Blocks & 0xFF),        // LSB of Total Blocks to Read
+					0x00                    // Unused (control)
+				}
+		};
+
+	MS_CommandStatusWrapper_t SCSICommandStatus;
+
+	if ((ErrorCode = MS_Host_SendCommand(MSInterfaceInfo, &SCSICommandBlock, NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if ((ErrorCode = MS_Host_StreamBlockData(MSInterfaceInfo, &SCSICommandBlock, BlockAddress, BlockSize,
+	                                         BlockBuffer, Callback)) != PIPE_RWSTREAM_NoError)
+	{
+		/* A stalled data phase leaves the device out of step with the host, so must also end in a reset recovery */
+		if (ErrorCode == PIPE_RWSTREAM_PipeStalled)
+		  return MS_Host_AbortDataPhase(MSInterfaceInfo, ErrorCode);
+
+		Pipe_Freeze();
+		return ErrorCode;
+	}
+
+	if ((ErrorCode = MS_Host_GetReturnedStatus(MSInterfaceInfo, &SCSICommandStatus)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+uint8_t MS_Host_WriteDeviceBlocks_Stream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+                                         const uint32_t BlockAddress, const uint16_t Blocks, const uint16_t BlockSize,
+                                         void* BlockBuffer, MS_Host_BlockCallback_t const Callback)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	uint8_t ErrorCode;
+
+	MS_CommandBlockWrapper_t SCSICommandBlock = (MS_CommandBlockWrapper_t)
+		{
+			.Signature          = CBW_SIGNATURE,
+			.DataTransferLength = ((uint32_t)Blocks * BlockSize),
+			.Flags              = COMMAND_DIRECTION_DATA_OUT,
+			.LUN                = LUNIndex,
+			.SCSICommandLength  = 10,
+			.SCSICommandData    =
+				{
+					SCSI_CMD_WRITE_10,
+					0x00,                   // Unused (control bits, all off)
+					(BlockAddress >> 24),   // MSB of Block Address
+					(BlockAddress >> 16),
+					(BlockAddress >> 8),
+					(BlockAddress & 0xFF),  // LSB of Block Address
+					0x00,                   // Unused (reserved)
+					(Blocks >> 8),          // MSB of Total Blocks to Write
+					(Blocks & 0xFF),        // LSB of Total Blocks to Write
+					0x00                    // Unused (control)
+				}
+		};
+
+	MS_CommandStatusWrapper_t SCSICommandStatus;
+
+	if ((ErrorCode = MS_Host_SendCommand(MSInterfaceInfo, &SCSICommandBlock, NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if ((ErrorCode = MS_Host_StreamBlockData(MSInterfaceInfo, &SCSICommandBlock, BlockAddress, BlockSize,
+	                                         BlockBuffer, Callback)) != PIPE_RWSTREAM_NoError)
+	{
+		/* A stalled data phase leaves the device out of step with the host, so must also end in a reset recovery */
+		if (ErrorCode == PIPE_RWSTREAM_PipeStalled)
+		  return MS_Host_AbortDataPhase(MSInterfaceInfo, ErrorCode);
+
+		Pipe_Freeze();
+		return ErrorCode;
+	}
+
+	if ((ErrorCode = MS_Host_GetReturnedStatus(MSInterfaceInfo, &SCSICommandStatus)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	return PIPE_RWSTREAM_NoError;
+}
+
 #endif
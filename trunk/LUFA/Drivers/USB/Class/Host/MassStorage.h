@@ -121,6 +121,23 @@
 				uint32_t BlockSize; /**< Number of bytes in each block in the addressed LUN */
 			} SCSI_Capacity_t;
 
+			/** Type define for a block callback function, given to \ref MS_Host_ReadDeviceBlocks_Stream() and
+			 *  \ref MS_Host_WriteDeviceBlocks_Stream(). The callback is called once for each block of the transfer, with
+			 *  the block buffer given to the stream function. When reading, the buffer holds the block's data as received
+			 *  from the device; when writing, the callback must fill the buffer with the data to be written to the block.
+			 *
+			 *  If the callback fails, the data phase of the command is ended with a Mass Storage reset recovery of the
+			 *  device, and the stream function returns \ref PIPE_RWSTREAM_CallbackAborted.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to the MS Class host configuration and state of the transfer
+			 *  \param[in] BlockAddress  Address of the current block within the device
+			 *  \param[in,out] BlockBuffer  Pointer to the block buffer given to the stream function
+			 *
+			 *  \return Boolean true to continue the transfer, false to abort it
+			 */
+			typedef bool (*MS_Host_BlockCallback_t)(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+			                                        const uint32_t BlockAddress, void* BlockBuffer);
+
 		/* Enums: */
 			enum MSHost_EnumerationFailure_ErrorCodes_t
 			{
@@ -279,6 +296,56 @@
 			                                  const uint32_t BlockAddress, const uint8_t Blocks, const uint16_t BlockSize,
 			                                  void* BlockBuffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
 
+			/** Reads blocks of data from the attached Mass Storage device's medium in a single command, passing each block to
+			 *  a callback function as it is received. This allows large transfers to be made through a buffer of a single block,
+			 *  avoiding the per-command overhead of reading the blocks one at a time.
+			 *
+			 *  If the device stalls the data phase of the command, the device is recovered with a Mass Storage reset recovery
+			 *  and \ref PIPE_RWSTREAM_PipeStalled is returned, so that the next command can be issued without further action.
+			 *
+			 *  \note This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *        call will fail.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a MS Class host configuration and state
+			 *  \param[in] LUNIndex  LUN index within the device the command is being issued to
+			 *  \param[in] BlockAddress  Starting block address within the device to read from
+			 *  \param[in] Blocks  Total number of blocks to read
+			 *  \param[in] BlockSize  Size in bytes of each block within the device
+			 *  \param[out] BlockBuffer  Pointer to a buffer of BlockSize bytes, where each received block is stored
+			 *  \param[in] Callback  Callback function to process each block, once it has been stored into BlockBuffer
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or MS_ERROR_LOGICAL_CMD_FAILED if not ready
+			 */
+			uint8_t MS_Host_ReadDeviceBlocks_Stream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+			                                        const uint32_t BlockAddress, const uint16_t Blocks, const uint16_t BlockSize,
+			                                        void* BlockBuffer, MS_Host_BlockCallback_t const Callback)
+			                                        ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6) ATTR_NON_NULL_PTR_ARG(7);
+
+			/** Writes blocks of data to the attached Mass Storage device's medium in a single command, obtaining each block from
+			 *  a callback function just before it is sent. This allows large transfers to be made through a buffer of a single
+			 *  block, avoiding the per-command overhead of writing the blocks one at a time.
+			 *
+			 *  If the device stalls the data phase of the command, the device is recovered with a Mass Storage reset recovery
+			 *  and \ref PIPE_RWSTREAM_PipeStalled is returned, so that the next command can be issued without further action.
+			 *
+			 *  \note This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *        call will fail.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a MS Class host configuration and state
+			 *  \param[in] LUNIndex  LUN index within the device the command is being issued to
+			 *  \param[in] BlockAddress  Starting block address within the device to write to
+			 *  \param[in] Blocks  Total number of blocks to write
+			 *  \param[in] BlockSize  Size in bytes of each block within the device
+			 *  \param[in] BlockBuffer  Pointer to a buffer of BlockSize bytes, from which each block is sent
+			 *  \param[in] Callback  Callback function to fill BlockBuffer with the data of each block
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or MS_ERROR_LOGICAL_CMD_FAILED if not ready
+			 */
+			uint8_t MS_Host_WriteDeviceBlocks_Stream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t LUNIndex,
+			                                         const uint32_t BlockAddress, const uint16_t Blocks, const uint16_t BlockSize,
+			                                         void* BlockBuffer, MS_Host_BlockCallback_t const Callback)
+			                                         ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6) ATTR_NON_NULL_PTR_ARG(7);
+
 		/* Inline Functions: */
 			/** General management task for a given Mass Storage host class interface, required for the correct operation of
 			 *  the interface. This should be called frequently in the main program loop, before the master USB management task
@@ -324,6 +391,11 @@
 				static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo);
 				static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, 
                                                        MS_CommandBlockWrapper_t* const SCSICommandBlock, void* BufferPtr);
+				static uint8_t MS_Host_StreamBlockData(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                       MS_CommandBlockWrapper_t* const SCSICommandBlock,
+				                                       const uint32_t BlockAddress, const uint16_t BlockSize,
+				                                       void* BlockBuffer, MS_Host_BlockCallback_t const Callback);
+				static uint8_t MS_Host_AbortDataPhase(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo, const uint8_t ErrorCode);
 				static uint8_t MS_Host_GetReturnedStatus(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 				                                         MS_CommandStatusWrapper_t* const SCSICommandStatus);
 			#endif
@@ -137,6 +137,13 @@
 				 *  \ref EVENT_USB_Device_StartOfFrame() event when enumerated in device mode.
 				 */
 				static inline bool USB_Device_DisableSOFEvents(void);
+
+				/** Retrieves the frame number of the last Start of Frame received from the host, which is incremented once per
+				 *  millisecond while the bus is not suspended.
+				 *
+				 *  \return Current 11-bit USB frame number
+				 */
+				static inline uint16_t USB_Device_GetFrameNumber(void);
 			#else
 				#if !defined(NO_DEVICE_REMOTE_WAKEUP)
 					#define USB_Device_SendRemoteWakeup()   MACROS{ UDCON |= (1 << RMWKUP); }MACROE
@@ -149,6 +156,8 @@
 				#define USB_Device_EnableSOFEvents()    MACROS{ USB_INT_Enable(USB_INT_SOFI); }MACROE
 
 				#define USB_Device_DisableSOFEvents()   MACROS{ USB_INT_Disable(USB_INT_SOFI); }MACROE
+
+				#define USB_Device_GetFrameNumber()           (UDFNUM)
 			#endif
 			
 		/* Type Defines: */
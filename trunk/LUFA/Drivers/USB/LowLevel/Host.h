@@ -167,6 +167,13 @@
 				 *  \return Boolean true if no resume request is currently being sent, false otherwise
 				 */
 				static inline bool USB_Host_IsResumeFromWakeupRequestSent(void);
+
+				/** Retrieves the current USB frame number, incremented by the host each time a Start of Frame is issued to the
+				 *  attached device (once per millisecond while the bus is not suspended).
+				 *
+				 *  \return Current 11-bit USB frame number
+				 */
+				static inline uint16_t USB_Host_GetFrameNumber(void);
 			#else
 				#define USB_Host_ResetBus()                MACROS{ UHCON |=  (1 << RESET);          }MACROE
 
@@ -187,6 +194,8 @@
 				#define USB_Host_ResumeFromWakeupRequest() MACROS{ UHCON |=  (1 << RESUME);         }MACROE
 				
 				#define USB_Host_IsResumeFromWakeupRequestSent() ((UHCON &   (1 << RESUME)) ? false : true)
+
+				#define USB_Host_GetFrameNumber()                (UHFNUM)
 			#endif
 
 		/* Function Prototypes: */
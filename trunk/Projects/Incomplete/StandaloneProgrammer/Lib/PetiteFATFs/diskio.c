@@ -6,7 +6,7 @@
 
 #include <string.h>
 #include <LUFA/Drivers/USB/Class/MassStorage.h>
-#include "../DataflashManager.h"
+#include <LUFA/Drivers/Misc/BlockDevice.h>
 #include "../../DiskHost.h"
 
 /*-----------------------------------------------------------------------*/
@@ -46,7 +46,8 @@ DRESULT disk_readp (
 	else
 	{
 		#if defined(USB_CAN_BE_DEVICE)
-		DataflashManager_ReadBlocks_RAM(sector, 1, BlockTemp);
+		if (BlockDevice_ReadBlocks(sector, 1, BlockTemp) != BLOCKDEV_ERROR_NoError)
+		  ErrorCode = RES_ERROR;
 		#endif
 	}
 
@@ -197,8 +197,8 @@ static void SCSI_Command_Request_Sense(USB_ClassInfo_MS_Device_t* MSInterfaceInf
  */
 static void SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo)
 {
-	uint32_t LastBlockAddressInLUN = (VIRTUAL_MEMORY_BLOCKS - 1);
-	uint32_t MediaBlockSize        = VIRTUAL_MEMORY_BLOCK_SIZE;
+	uint32_t LastBlockAddressInLUN = (BlockDevice_GetTotalBlocks() - 1);
+	uint32_t MediaBlockSize        = BLOCKDEV_BLOCK_SIZE;
 
 	Endpoint_Write_Stream_BE(&LastBlockAddressInLUN, sizeof(LastBlockAddressInLUN), NO_STREAM_CALLBACK);
 	Endpoint_Write_Stream_BE(&MediaBlockSize, sizeof(MediaBlockSize), NO_STREAM_CALLBACK);
@@ -208,8 +208,8 @@ static void SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* MSInterface
 	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= 8;
 }
 
-/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the Dataflash ICs on the
- *  board, and indicates if they are present and functioning correctly. Only the Self-Test portion of the diagnostic command is
+/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the storage medium,
+ *  and indicates if it is present and functioning correctly. Only the Self-Test portion of the diagnostic command is
  *  supported.
  *
  *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
@@ -227,8 +227,8 @@ static void SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* MSInterfaceI
 		return;
 	}
 	
-	/* Check to see if all attached Dataflash ICs are functional */
-	if (!(DataflashManager_CheckDataflashOperation()))
+	/* Check to see if the storage medium is functional */
+	if (!(BlockDevice_CheckOperation()))
 	{
 		/* Update SENSE key with a hardware error condition and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
@@ -243,7 +243,7 @@ static void SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* MSInterfaceI
 }
 
 /** Command processing for an issued SCSI READ (10) or WRITE (10) command. This command reads in the block start address
- *  and total number of blocks to process, then calls the appropriate low-level dataflash routine to handle the actual
+ *  and total number of blocks to process, then calls the appropriate block device routine to handle the actual
  *  reading and writing of the data.
  *
  *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
@@ -253,6 +253,7 @@ static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo
 {
 	uint32_t BlockAddress;
 	uint16_t TotalBlocks;
+	uint8_t  ErrorCode;
 	
 	/* Load in the 32-bit block address (SCSI uses big-endian, so have to reverse the byte order) */
 	BlockAddress = SwapEndian_32(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[2]);
@@ -260,8 +261,8 @@ static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo
 	/* Load in the 16-bit total blocks (SCSI uses big-endian, so have to reverse the byte order) */
 	TotalBlocks  = SwapEndian_16(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[7]);
 	
-	/* Check if the block address is outside the maximum allowable value for the LUN */
-	if (BlockAddress >= VIRTUAL_MEMORY_BLOCKS)
+	/* Check if any of the requested blocks lie outside the medium */
+	if ((BlockAddress + TotalBlocks) > BlockDevice_GetTotalBlocks())
 	{
 		/* Block address is invalid, update SENSE key and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
@@ -273,11 +274,21 @@ static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo
 	
 	/* Determine if the packet is a READ (10) or WRITE (10) command, call appropriate function */
 	if (IsDataRead == DATA_READ)
-	  DataflashManager_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	  ErrorCode = BlockDevice_ReadBlocks_Endpoint(BlockAddress, TotalBlocks, &MSInterfaceInfo->State.IsMassStoreReset);
 	else
-	  DataflashManager_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	  ErrorCode = BlockDevice_WriteBlocks_Endpoint(BlockAddress, TotalBlocks, &MSInterfaceInfo->State.IsMassStoreReset);
+
+	if (ErrorCode != BLOCKDEV_ERROR_NoError)
+	{
+		/* Transfer could not be completed, update SENSE key and return command fail */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
+		               SCSI_ASENSE_NO_ADDITIONAL_INFORMATION,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return;
+	}
 
 	/* Update the bytes transferred counter and succeed the command */
-	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
 }
 #endif
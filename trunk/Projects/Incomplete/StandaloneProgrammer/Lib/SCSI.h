@@ -43,8 +43,9 @@
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
 
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
+
 		#include "Descriptors.h"
-		#include "DataflashManager.h"
 	
 	/* Macros: */
 		/** Macro to set the current SCSI sense data to the given key, additional sense code and additional sense qualifier. This
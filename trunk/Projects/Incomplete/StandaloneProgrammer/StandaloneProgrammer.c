@@ -154,7 +154,7 @@ void SetupHardware(void)
 	SerialStream_Init(9600, true);
 
 	#if defined(USB_CAN_BE_DEVICE)
-	/* Clear Dataflash sector protections, if enabled */
-	DataflashManager_ResetDataflashProtections();
+	/* Prepare the storage medium for use, clearing Dataflash sector protections if enabled */
+	BlockDevice_Init();
 	#endif
 }
@@ -46,12 +46,13 @@
 		#include "DiskHost.h"
 
 		#include "Lib/SCSI.h"
-		#include "Lib/DataflashManager.h"
 		#include "Lib/ProgrammerConfig.h"
 		#include "Lib/PetiteFATFs/pff.h"
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/Board/Buttons.h>
+		#include <LUFA/Drivers/Board/Dataflash.h>
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
 		#include <LUFA/Drivers/Peripheral/SerialStream.h>
 
 	/* Macros: */
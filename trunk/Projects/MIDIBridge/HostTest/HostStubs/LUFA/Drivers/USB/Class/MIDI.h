@@ -0,0 +1,54 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host stand-in for the LUFA MIDI class driver header, providing only the USB-MIDI event packet type used by the
+ *  MIDI stream routines. The type must be kept identical to the one in LUFA/Drivers/USB/Class/Common/MIDI.h.
+ */
+
+#ifndef _HOST_MIDI_H_
+#define _HOST_MIDI_H_
+
+	/* Includes: */
+		#include <stdint.h>
+
+	/* Type Defines: */
+		typedef struct
+		{
+			unsigned char Command     : 4;
+			unsigned char CableNumber : 4;
+
+			uint8_t Data1;
+			uint8_t Data2;
+			uint8_t Data3;
+		} MIDI_EventPacket_t;
+
+#endif
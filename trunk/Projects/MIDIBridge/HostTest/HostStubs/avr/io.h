@@ -0,0 +1 @@
+/* Empty stand-in for the AVR device register header, so that the MIDI stream routines can be built for the host. */
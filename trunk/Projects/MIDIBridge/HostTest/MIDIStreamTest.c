@@ -0,0 +1,547 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host test fixture for the MIDIBridge project's serial MIDI stream routines (Lib/MIDIStream.c), built with the
+ *  host's C compiler by running "make" in this directory. The fixture performs four groups of tests:
+ *
+ *   - Byte stream fixtures: fixed serial byte streams covering running status, real-time bytes within messages,
+ *     SysEx messages of several lengths, System Common messages and aborted messages, checked against the expected
+ *     USB-MIDI event packets and the expected re-encoded serial byte stream.
+ *   - Multiple cables: two pseudo-random serial streams are parsed with one parser per port, their events interleaved
+ *     into one USB endpoint stream as the bridge would send them, and split back out by cable number into one encoder
+ *     per port. Each port's events must survive the round trip unchanged.
+ *   - Throughput: the parse and encode rates of the routines on the host CPU, and the serial bandwidth saved by the
+ *     encoder's running status compression.
+ *   - Latency: a time-stepped model of the bridge's serial to USB path at 31250 baud, giving the delay from each event's
+ *     last serial byte to the release of its endpoint bank, for the DataINFlushFrames setting used by the project.
+ *
+ *  The program exits with a non-zero status if any test fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../Lib/MIDIStream.h"
+
+/** Maximum number of bytes or events in a single byte stream fixture. */
+#define FIXTURE_MAX_LENGTH        16
+
+/** Size of the pseudo-random streams used for the multiple cable and throughput tests, in bytes. */
+#define RANDOM_STREAM_LENGTH      (4UL * 1024 * 1024)
+
+/** Number of event packets in each USB-MIDI endpoint bank, for the project's 64 byte endpoints. */
+#define EVENTS_PER_BANK           16
+
+/** Time taken to send one byte over a 31250 baud serial MIDI link (ten bits per byte), in microseconds. */
+#define SERIAL_BYTE_TIME_US       320
+
+/** Interval between iterations of the bridge's main loop in the latency model, in microseconds. */
+#define MAIN_LOOP_PERIOD_US       20
+
+/** Type define for a single byte stream fixture. */
+typedef struct
+{
+	const char*        Name; /**< Description of the fixture. */
+	uint8_t            Input[FIXTURE_MAX_LENGTH]; /**< Serial bytes fed to the parser. */
+	uint8_t            InputLength; /**< Number of bytes in Input. */
+	MIDI_EventPacket_t Events[FIXTURE_MAX_LENGTH]; /**< Event packets expected from the parser. */
+	uint8_t            TotalEvents; /**< Number of expected event packets. */
+	uint8_t            Output[FIXTURE_MAX_LENGTH]; /**< Serial bytes expected from re-encoding the events. */
+	uint8_t            OutputLength; /**< Number of bytes in Output. */
+} StreamFixture_t;
+
+/** Byte stream fixtures, with the expected event packets given as {CIN, Cable, Data1, Data2, Data3}. */
+static const StreamFixture_t Fixtures[] =
+{
+	{"Running status note on/off",
+	 {0x90, 0x3C, 0x64, 0x3C, 0x00, 0x3E, 0x64, 0x80, 0x3E, 0x40}, 10,
+	 {{0x9, 0, 0x90, 0x3C, 0x64}, {0x9, 0, 0x90, 0x3C, 0x00}, {0x9, 0, 0x90, 0x3E, 0x64}, {0x8, 0, 0x80, 0x3E, 0x40}}, 4,
+	 {0x90, 0x3C, 0x64, 0x3C, 0x00, 0x3E, 0x64, 0x80, 0x3E, 0x40}, 10},
+	{"Encoder applies running status",
+	 {0x90, 0x3C, 0x64, 0x90, 0x3E, 0x64}, 6,
+	 {{0x9, 0, 0x90, 0x3C, 0x64}, {0x9, 0, 0x90, 0x3E, 0x64}}, 2,
+	 {0x90, 0x3C, 0x64, 0x3E, 0x64}, 5},
+	{"Real-time bytes within a message",
+	 {0x90, 0xF8, 0x3C, 0xFE, 0x64}, 5,
+	 {{0xF, 0, 0xF8, 0x00, 0x00}, {0xF, 0, 0xFE, 0x00, 0x00}, {0x9, 0, 0x90, 0x3C, 0x64}}, 3,
+	 {0xF8, 0xFE, 0x90, 0x3C, 0x64}, 5},
+	{"Two byte messages with running status",
+	 {0xC0, 0x05, 0x06, 0xD0, 0x7F}, 5,
+	 {{0xC, 0, 0xC0, 0x05, 0x00}, {0xC, 0, 0xC0, 0x06, 0x00}, {0xD, 0, 0xD0, 0x7F, 0x00}}, 3,
+	 {0xC0, 0x05, 0x06, 0xD0, 0x7F}, 5},
+	{"SysEx split over two packets",
+	 {0xF0, 0x7E, 0x7F, 0x09, 0x01, 0xF7}, 6,
+	 {{0x4, 0, 0xF0, 0x7E, 0x7F}, {0x7, 0, 0x09, 0x01, 0xF7}}, 2,
+	 {0xF0, 0x7E, 0x7F, 0x09, 0x01, 0xF7}, 6},
+	{"Empty SysEx",
+	 {0xF0, 0xF7}, 2,
+	 {{0x6, 0, 0xF0, 0xF7, 0x00}}, 1,
+	 {0xF0, 0xF7}, 2},
+	{"SysEx ending with one byte packet",
+	 {0xF0, 0x01, 0x02, 0xF7}, 4,
+	 {{0x4, 0, 0xF0, 0x01, 0x02}, {0x5, 0, 0xF7, 0x00, 0x00}}, 2,
+	 {0xF0, 0x01, 0x02, 0xF7}, 4},
+	{"Real-time byte within SysEx",
+	 {0xF0, 0x01, 0xF8, 0x02, 0x03, 0x04, 0xF7}, 7,
+	 {{0xF, 0, 0xF8, 0x00, 0x00}, {0x4, 0, 0xF0, 0x01, 0x02}, {0x7, 0, 0x03, 0x04, 0xF7}}, 3,
+	 {0xF8, 0xF0, 0x01, 0x02, 0x03, 0x04, 0xF7}, 7},
+	{"Status byte aborts partial message",
+	 {0x90, 0x3C, 0xB0, 0x07, 0x64}, 5,
+	 {{0xB, 0, 0xB0, 0x07, 0x64}}, 1,
+	 {0xB0, 0x07, 0x64}, 3},
+	{"System Common cancels running status",
+	 {0x90, 0x3C, 0x64, 0xF1, 0x20, 0x3C, 0x00}, 7,
+	 {{0x9, 0, 0x90, 0x3C, 0x64}, {0x2, 0, 0xF1, 0x20, 0x00}}, 2,
+	 {0x90, 0x3C, 0x64, 0xF1, 0x20}, 5},
+	{"Encoder resends status after System Common",
+	 {0x90, 0x3C, 0x64, 0xF3, 0x01, 0x90, 0x3E, 0x64}, 8,
+	 {{0x9, 0, 0x90, 0x3C, 0x64}, {0x2, 0, 0xF3, 0x01, 0x00}, {0x9, 0, 0x90, 0x3E, 0x64}}, 3,
+	 {0x90, 0x3C, 0x64, 0xF3, 0x01, 0x90, 0x3E, 0x64}, 8},
+	{"Song position and tune request",
+	 {0xF2, 0x00, 0x08, 0xF6}, 4,
+	 {{0x3, 0, 0xF2, 0x00, 0x08}, {0x5, 0, 0xF6, 0x00, 0x00}}, 2,
+	 {0xF2, 0x00, 0x08, 0xF6}, 4},
+	{"Data bytes without status are ignored",
+	 {0x3C, 0x64, 0xF7}, 3,
+	 {{0}}, 0,
+	 {0}, 0},
+};
+
+/** Number of failed tests. */
+static unsigned int TotalFailures;
+
+/** State of the pseudo-random number generator used to build the random streams. */
+static uint32_t RandomState = 0x4D494449;
+
+/** Returns the next value of a xorshift pseudo-random number generator.
+ *
+ *  \return Next pseudo-random value
+ */
+static uint32_t Random(void)
+{
+	RandomState ^= (RandomState << 13);
+	RandomState ^= (RandomState >> 17);
+	RandomState ^= (RandomState << 5);
+
+	return RandomState;
+}
+
+/** Returns a monotonic timestamp, in nanoseconds.
+ *
+ *  \return Current time in nanoseconds
+ */
+static uint64_t GetTimeNS(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (((uint64_t)Now.tv_sec * 1000000000ULL) + Now.tv_nsec);
+}
+
+/** Compares two event packets.
+ *
+ *  \param[in] A  First event packet to compare
+ *  \param[in] B  Second event packet to compare
+ *
+ *  \return Boolean true if the event packets are identical, false otherwise
+ */
+static bool EventsEqual(const MIDI_EventPacket_t* A, const MIDI_EventPacket_t* B)
+{
+	return ((A->Command == B->Command) && (A->CableNumber == B->CableNumber) &&
+	        (A->Data1 == B->Data1) && (A->Data2 == B->Data2) && (A->Data3 == B->Data3));
+}
+
+/** Parses a serial byte stream into event packets.
+ *
+ *  \param[in]  Input        Serial bytes to parse
+ *  \param[in]  InputLength  Number of bytes in Input
+ *  \param[in]  CableNumber  Virtual cable number to tag the events with
+ *  \param[out] Events       Buffer where the parsed event packets are to be stored, of at least InputLength entries
+ *
+ *  \return Number of event packets stored into Events
+ */
+static unsigned long ParseStream(const uint8_t* Input, const unsigned long InputLength, const uint8_t CableNumber,
+                                 MIDI_EventPacket_t* Events)
+{
+	MIDIStream_Parser_t Parser;
+	unsigned long       TotalEvents = 0;
+
+	MIDIStream_InitParser(&Parser, CableNumber);
+
+	for (unsigned long i = 0; i < InputLength; i++)
+	{
+		if (MIDIStream_ParseByte(&Parser, Input[i], &Events[TotalEvents]))
+		  TotalEvents++;
+	}
+
+	return TotalEvents;
+}
+
+/** Runs the byte stream fixtures, checking the parsed events and the re-encoded bytes of each. */
+static void TestFixtures(void)
+{
+	for (uint8_t FixtureIndex = 0; FixtureIndex < (sizeof(Fixtures) / sizeof(Fixtures[0])); FixtureIndex++)
+	{
+		const StreamFixture_t* Fixture = &Fixtures[FixtureIndex];
+		MIDI_EventPacket_t     Events[FIXTURE_MAX_LENGTH];
+		uint8_t                Output[FIXTURE_MAX_LENGTH * MIDISTREAM_MAX_EVENT_BYTES];
+		uint8_t                OutputLength = 0;
+		MIDIStream_Encoder_t   Encoder;
+		bool                   Passed;
+
+		uint8_t TotalEvents = ParseStream(Fixture->Input, Fixture->InputLength, 0, Events);
+
+		Passed = (TotalEvents == Fixture->TotalEvents);
+
+		for (uint8_t i = 0; Passed && (i < TotalEvents); i++)
+		  Passed = EventsEqual(&Events[i], &Fixture->Events[i]);
+
+		MIDIStream_InitEncoder(&Encoder);
+
+		for (uint8_t i = 0; i < TotalEvents; i++)
+		  OutputLength += MIDIStream_EncodeEvent(&Encoder, &Events[i], &Output[OutputLength]);
+
+		Passed = (Passed && (OutputLength == Fixture->OutputLength) && !(memcmp(Output, Fixture->Output, OutputLength)));
+
+		printf("  %-44s %s\n", Fixture->Name, Passed ? "PASS" : "FAIL");
+
+		if (!(Passed))
+		  TotalFailures++;
+	}
+}
+
+/** Fills a buffer with a pseudo-random but valid serial MIDI byte stream. The stream mixes channel messages on two
+ *  channels, sent with and without running status, with System Common messages, SysEx messages of up to 40 bytes, and
+ *  System Real-Time bytes inserted at random positions, including within other messages. Half of the channel messages
+ *  repeat the status of the previous message, and the stream uses running status for three quarters of those.
+ *
+ *  \param[out] Stream  Buffer to fill
+ *  \param[in]  Length  Size of the buffer, in bytes
+ *
+ *  \return Number of bytes in the stream without running status, i.e. if every channel message included its status byte
+ */
+static unsigned long BuildRandomStream(uint8_t* Stream, const unsigned long Length)
+{
+	unsigned long Position          = 0;
+	unsigned long UncompressedBytes = 0;
+	uint8_t       RunningStatus     = 0;
+
+	while (Position < (Length - 48))
+	{
+		uint8_t Message[48];
+		uint8_t MessageLength = 0;
+		uint8_t Choice        = (Random() % 16);
+
+		if (Choice < 12)
+		{
+			static const uint8_t StatusTypes[] = {0x80, 0x90, 0x90, 0x90, 0xA0, 0xB0, 0xC0, 0xD0, 0xE0};
+			uint8_t Status = (StatusTypes[Random() % sizeof(StatusTypes)] | (Random() % 2));
+
+			/* Runs of messages with the same status, such as chords or controller sweeps, are common in practice */
+			if (RunningStatus && (Random() % 2))
+			  Status = RunningStatus;
+
+			if ((Status != RunningStatus) || (Random() % 4 == 0))
+			  Message[MessageLength++] = Status;
+
+			Message[MessageLength++] = (Random() & 0x7F);
+
+			if ((Status & 0xE0) != 0xC0)
+			  Message[MessageLength++] = (Random() & 0x7F);
+
+			UncompressedBytes += (((Status & 0xE0) != 0xC0) ? 3 : 2);
+			RunningStatus      = Status;
+		}
+		else if (Choice < 14)
+		{
+			Message[MessageLength++] = 0xF0;
+
+			for (uint8_t SysExLength = (Random() % 40); SysExLength; SysExLength--)
+			  Message[MessageLength++] = (Random() & 0x7F);
+
+			Message[MessageLength++] = 0xF7;
+
+			UncompressedBytes += MessageLength;
+			RunningStatus      = 0;
+		}
+		else
+		{
+			Message[MessageLength++] = 0xF2;
+			Message[MessageLength++] = (Random() & 0x7F);
+			Message[MessageLength++] = (Random() & 0x7F);
+
+			UncompressedBytes += MessageLength;
+			RunningStatus      = 0;
+		}
+
+		for (uint8_t i = 0; i < MessageLength; i++)
+		{
+			if ((Random() % 32) == 0)
+			{
+				Stream[Position++] = (0xF8 + (Random() % 2) * 6);
+				UncompressedBytes++;
+			}
+
+			Stream[Position++] = Message[i];
+		}
+	}
+
+	while (Position < Length)
+	{
+		Stream[Position++] = 0xFE;
+		UncompressedBytes++;
+	}
+
+	return UncompressedBytes;
+}
+
+/** Tests two serial ports multiplexed through one USB-MIDI endpoint on different virtual cables, as described in the
+ *  file header.
+ */
+static void TestMultipleCables(void)
+{
+	uint8_t*            Streams[2];
+	MIDI_EventPacket_t* PortEvents[2];
+	unsigned long       TotalPortEvents[2];
+	MIDI_EventPacket_t* EndpointEvents;
+	unsigned long       TotalEndpointEvents = 0;
+	unsigned long       StreamLength        = (RANDOM_STREAM_LENGTH / 8);
+	bool                Passed              = true;
+
+	for (uint8_t Port = 0; Port < 2; Port++)
+	{
+		Streams[Port]         = malloc(StreamLength);
+		PortEvents[Port]      = malloc(StreamLength * sizeof(MIDI_EventPacket_t));
+		BuildRandomStream(Streams[Port], StreamLength);
+		TotalPortEvents[Port] = ParseStream(Streams[Port], StreamLength, (Port + 1), PortEvents[Port]);
+	}
+
+	/* Interleave the two ports' events into one endpoint stream, preserving the order of each port's own events */
+	EndpointEvents = malloc((TotalPortEvents[0] + TotalPortEvents[1]) * sizeof(MIDI_EventPacket_t));
+
+	for (unsigned long Taken[2] = {0, 0}; (Taken[0] < TotalPortEvents[0]) || (Taken[1] < TotalPortEvents[1]);)
+	{
+		uint8_t Port = (Random() % 2);
+
+		if (Taken[Port] == TotalPortEvents[Port])
+		  Port ^= 1;
+
+		EndpointEvents[TotalEndpointEvents++] = PortEvents[Port][Taken[Port]++];
+	}
+
+	/* Split the endpoint stream back out by cable, re-encode each port's events and parse them again */
+	for (uint8_t Port = 0; Port < 2; Port++)
+	{
+		MIDIStream_Encoder_t Encoder;
+		uint8_t*             Output       = malloc(StreamLength * MIDISTREAM_MAX_EVENT_BYTES);
+		unsigned long        OutputLength = 0;
+
+		MIDIStream_InitEncoder(&Encoder);
+
+		for (unsigned long i = 0; i < TotalEndpointEvents; i++)
+		{
+			if (EndpointEvents[i].CableNumber == (Port + 1))
+			  OutputLength += MIDIStream_EncodeEvent(&Encoder, &EndpointEvents[i], &Output[OutputLength]);
+		}
+
+		MIDI_EventPacket_t* Reparsed       = malloc(OutputLength * sizeof(MIDI_EventPacket_t));
+		unsigned long       TotalReparsed  = ParseStream(Output, OutputLength, (Port + 1), Reparsed);
+
+		if (TotalReparsed != TotalPortEvents[Port])
+		{
+			Passed = false;
+		}
+		else
+		{
+			for (unsigned long i = 0; i < TotalReparsed; i++)
+			{
+				if (!(EventsEqual(&Reparsed[i], &PortEvents[Port][i])))
+				{
+					Passed = false;
+					break;
+				}
+			}
+		}
+
+		printf("  Cable %u: %lu events, %lu bytes in, %lu bytes out\n", (Port + 1), TotalPortEvents[Port],
+		       StreamLength, OutputLength);
+
+		free(Reparsed);
+		free(Output);
+	}
+
+	printf("  %-44s %s\n", "Two cables through one endpoint", Passed ? "PASS" : "FAIL");
+
+	if (!(Passed))
+	  TotalFailures++;
+
+	for (uint8_t Port = 0; Port < 2; Port++)
+	{
+		free(Streams[Port]);
+		free(PortEvents[Port]);
+	}
+
+	free(EndpointEvents);
+}
+
+/** Measures the parse and encode rates of the stream routines, and the running status compression ratio. */
+static void TestThroughput(void)
+{
+	uint8_t*            Stream            = malloc(RANDOM_STREAM_LENGTH);
+	MIDI_EventPacket_t* Events            = malloc(RANDOM_STREAM_LENGTH * sizeof(MIDI_EventPacket_t));
+	uint8_t*            Output            = malloc(RANDOM_STREAM_LENGTH * MIDISTREAM_MAX_EVENT_BYTES);
+	unsigned long       UncompressedBytes = BuildRandomStream(Stream, RANDOM_STREAM_LENGTH);
+	unsigned long       OutputLength      = 0;
+	MIDIStream_Encoder_t Encoder;
+
+	uint64_t      Start       = GetTimeNS();
+	unsigned long TotalEvents = ParseStream(Stream, RANDOM_STREAM_LENGTH, 0, Events);
+	uint64_t      ParseNS     = (GetTimeNS() - Start);
+
+	MIDIStream_InitEncoder(&Encoder);
+
+	Start = GetTimeNS();
+
+	for (unsigned long i = 0; i < TotalEvents; i++)
+	  OutputLength += MIDIStream_EncodeEvent(&Encoder, &Events[i], &Output[OutputLength]);
+
+	uint64_t EncodeNS = (GetTimeNS() - Start);
+
+	printf("  Parse:  %lu bytes into %lu events, %.1f ns/byte (%.1f MB/s)\n", (unsigned long)RANDOM_STREAM_LENGTH,
+	       TotalEvents, ((double)ParseNS / RANDOM_STREAM_LENGTH), ((double)RANDOM_STREAM_LENGTH * 1000 / ParseNS));
+	printf("  Encode: %lu events into %lu bytes, %.1f ns/event\n", TotalEvents, OutputLength,
+	       ((double)EncodeNS / TotalEvents));
+	printf("  Running status: %lu bytes without compression, %lu bytes with (%.1f%% of serial bandwidth saved)\n",
+	       UncompressedBytes, OutputLength, (100.0 * (UncompressedBytes - OutputLength) / UncompressedBytes));
+	printf("  A 31250 baud port carries 3125 bytes/s, so the routines are not the bottleneck of the bridge.\n");
+
+	free(Stream);
+	free(Events);
+	free(Output);
+}
+
+/** Models the serial to USB path of the bridge, as described in the file header. Serial bytes arrive every
+ *  \ref SERIAL_BYTE_TIME_US microseconds (with random gaps when BusyPercent is below 100), the main loop parses them
+ *  and queues the events into the IN endpoint bank every \ref MAIN_LOOP_PERIOD_US microseconds, and the bank is
+ *  released when full, or by MIDI_Device_USBTask() once it has been held for FlushFrames USB frames. The host is
+ *  assumed to read each released bank immediately.
+ *
+ *  \param[in] FlushFrames  Value of the DataINFlushFrames configuration parameter
+ *  \param[in] BusyPercent  Percentage of serial byte slots carrying a byte
+ */
+static void ModelLatency(const uint8_t FlushFrames, const uint8_t BusyPercent)
+{
+	static uint8_t            Stream[8192];
+	MIDIStream_Parser_t       Parser;
+	uint32_t                  BankEventTime[EVENTS_PER_BANK];
+	uint8_t                   EventsInBank  = 0;
+	uint32_t                  BankFrame     = 0;
+	uint32_t                  ByteDoneTime  = SERIAL_BYTE_TIME_US;
+	unsigned long             StreamIndex   = 0;
+	unsigned long             TotalEvents   = 0;
+	uint64_t                  TotalLatency  = 0;
+	uint32_t                  MaxLatency    = 0;
+
+	BuildRandomStream(Stream, sizeof(Stream));
+	MIDIStream_InitParser(&Parser, 0);
+
+	for (uint32_t Time = 0; StreamIndex < sizeof(Stream); Time += MAIN_LOOP_PERIOD_US)
+	{
+		uint32_t Frame = (Time / 1000);
+
+		/* Serial bytes received since the last loop iteration are parsed and queued into the endpoint bank */
+		while ((ByteDoneTime <= Time) && (StreamIndex < sizeof(Stream)))
+		{
+			MIDI_EventPacket_t Event;
+
+			if (MIDIStream_ParseByte(&Parser, Stream[StreamIndex++], &Event))
+			{
+				if (!(EventsInBank))
+				  BankFrame = Frame;
+
+				BankEventTime[EventsInBank++] = ByteDoneTime;
+			}
+
+			ByteDoneTime += SERIAL_BYTE_TIME_US;
+
+			while ((Random() % 100) >= BusyPercent)
+			  ByteDoneTime += SERIAL_BYTE_TIME_US;
+
+			if (EventsInBank == EVENTS_PER_BANK)
+			  break;
+		}
+
+		/* The bank is released when full, or by the flush timer of MIDI_Device_USBTask() */
+		if (EventsInBank && ((EventsInBank == EVENTS_PER_BANK) || ((Frame - BankFrame) >= FlushFrames)))
+		{
+			for (uint8_t i = 0; i < EventsInBank; i++)
+			{
+				uint32_t Latency = (Time - BankEventTime[i]);
+
+				TotalLatency += Latency;
+				TotalEvents++;
+
+				if (Latency > MaxLatency)
+				  MaxLatency = Latency;
+			}
+
+			EventsInBank = 0;
+		}
+	}
+
+	printf("  DataINFlushFrames %u, serial link %3u%% busy: %5lu events, average %4lu us, maximum %4lu us\n",
+	       FlushFrames, BusyPercent, TotalEvents, (unsigned long)(TotalLatency / TotalEvents), (unsigned long)MaxLatency);
+}
+
+int main(void)
+{
+	printf("Byte stream fixtures:\n");
+	TestFixtures();
+
+	printf("\nMultiple cables:\n");
+	TestMultipleCables();
+
+	printf("\nThroughput:\n");
+	TestThroughput();
+
+	printf("\nLatency from the last serial byte of an event to the release of its endpoint bank:\n");
+	ModelLatency(1, 100);
+	ModelLatency(1, 10);
+	ModelLatency(2, 100);
+	ModelLatency(2, 10);
+
+	printf("\n%s (%u failure(s))\n", TotalFailures ? "FAILED" : "PASSED", TotalFailures);
+
+	return (TotalFailures ? 1 : 0);
+}
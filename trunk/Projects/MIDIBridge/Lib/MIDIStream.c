@@ -0,0 +1,222 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Serial MIDI byte stream conversion routines. These convert between the byte streams used by
+ *  serial (DIN) MIDI ports and the event packets used by the USB-MIDI class.
+ */
+
+#include "MIDIStream.h"
+
+/** Function to initialize or reset a serial MIDI byte stream parser. */
+void MIDIStream_InitParser(MIDIStream_Parser_t* const Parser, const uint8_t CableNumber)
+{
+	Parser->CableNumber    = CableNumber;
+	Parser->RunningStatus  = 0;
+	Parser->MessageLength  = 0;
+	Parser->ExpectedLength = 0;
+	Parser->InSysEx        = false;
+}
+
+/** Function to build a USB-MIDI event packet from the given code index number and the parser's buffered message bytes. */
+static void MIDIStream_BuildEvent(MIDIStream_Parser_t* const Parser, const uint8_t CodeIndex, MIDI_EventPacket_t* const Event)
+{
+	Event->CableNumber = Parser->CableNumber;
+	Event->Command     = CodeIndex;
+	Event->Data1       = Parser->Message[0];
+	Event->Data2       = (Parser->MessageLength > 1) ? Parser->Message[1] : 0;
+	Event->Data3       = (Parser->MessageLength > 2) ? Parser->Message[2] : 0;
+
+	Parser->MessageLength = 0;
+}
+
+/** Function to process the next byte received from a serial MIDI port, producing a USB-MIDI event packet once complete. */
+bool MIDIStream_ParseByte(MIDIStream_Parser_t* const Parser, const uint8_t Byte, MIDI_EventPacket_t* const Event)
+{
+	/* System Real-Time messages may appear anywhere, even within other messages, and do not affect the parser state */
+	if (Byte >= 0xF8)
+	{
+		Event->CableNumber = Parser->CableNumber;
+		Event->Command     = MIDISTREAM_CIN_SINGLE_BYTE;
+		Event->Data1       = Byte;
+		Event->Data2       = 0;
+		Event->Data3       = 0;
+
+		return true;
+	}
+
+	if (Byte & 0x80)
+	{
+		/* SysEx end byte completes the current SysEx message, if any, with one to three bytes in the final packet */
+		if (Byte == 0xF7)
+		{
+			if (!(Parser->InSysEx))
+			  return false;
+
+			Parser->InSysEx = false;
+			Parser->Message[Parser->MessageLength++] = Byte;
+			MIDIStream_BuildEvent(Parser, (MIDISTREAM_CIN_SYSEX_END_1 + Parser->MessageLength - 1), Event);
+			return true;
+		}
+
+		/* Any other status byte aborts an unterminated SysEx message and discards a partially received message */
+		Parser->InSysEx        = false;
+		Parser->Message[0]     = Byte;
+		Parser->MessageLength  = 1;
+		
+		if (Byte < 0xF0)
+		{
+			Parser->RunningStatus  = Byte;
+			Parser->ExpectedLength = (((Byte & 0xE0) == 0xC0) ? 2 : 3);
+			return false;
+		}
+
+		/* System Common and SysEx messages cancel the running status */
+		Parser->RunningStatus = 0;
+
+		switch (Byte)
+		{
+			case 0xF0:
+				Parser->InSysEx = true;
+				break;
+			case 0xF1:
+			case 0xF3:
+				Parser->ExpectedLength = 2;
+				break;
+			case 0xF2:
+				Parser->ExpectedLength = 3;
+				break;
+			case 0xF6:
+				MIDIStream_BuildEvent(Parser, MIDISTREAM_CIN_SYSEX_END_1, Event);
+				return true;
+			default:
+				Parser->MessageLength = 0;
+				break;
+		}
+
+		return false;
+	}
+
+	if (Parser->InSysEx)
+	{
+		Parser->Message[Parser->MessageLength++] = Byte;
+		
+		if (Parser->MessageLength == MIDISTREAM_MAX_EVENT_BYTES)
+		{
+			MIDIStream_BuildEvent(Parser, MIDISTREAM_CIN_SYSEX_START, Event);
+			return true;
+		}
+		
+		return false;
+	}
+
+	/* Data bytes arriving after a complete message re-use the running status, if one is set */
+	if (!(Parser->MessageLength))
+	{
+		if (!(Parser->RunningStatus))
+		  return false;
+
+		Parser->Message[0]     = Parser->RunningStatus;
+		Parser->MessageLength  = 1;
+		Parser->ExpectedLength = (((Parser->RunningStatus & 0xE0) == 0xC0) ? 2 : 3);
+	}
+
+	Parser->Message[Parser->MessageLength++] = Byte;
+
+	if (Parser->MessageLength < Parser->ExpectedLength)
+	  return false;
+
+	if (Parser->Message[0] < 0xF0)
+	  MIDIStream_BuildEvent(Parser, (Parser->Message[0] >> 4), Event);
+	else
+	  MIDIStream_BuildEvent(Parser, ((Parser->ExpectedLength == 2) ? MIDISTREAM_CIN_SYSCOMMON_2 : MIDISTREAM_CIN_SYSCOMMON_3), Event);
+
+	return true;
+}
+
+/** Function to initialize or reset a serial MIDI byte stream encoder. */
+void MIDIStream_InitEncoder(MIDIStream_Encoder_t* const Encoder)
+{
+	Encoder->RunningStatus = 0;
+}
+
+/** Function to convert a USB-MIDI event packet into the bytes to send to a serial MIDI port, applying running status. */
+uint8_t MIDIStream_EncodeEvent(MIDIStream_Encoder_t* const Encoder, const MIDI_EventPacket_t* const Event,
+                               uint8_t* const Bytes)
+{
+	uint8_t TotalBytes;
+
+	switch (Event->Command)
+	{
+		case MIDISTREAM_CIN_SYSEX_END_1:
+		case MIDISTREAM_CIN_SINGLE_BYTE:
+			TotalBytes = 1;
+			break;
+		case MIDISTREAM_CIN_SYSCOMMON_2:
+		case MIDISTREAM_CIN_SYSEX_END_2:
+		case 0x0C: /* Program Change */
+		case 0x0D: /* Channel Pressure */
+			TotalBytes = 2;
+			break;
+		case 0x00: /* Reserved */
+		case 0x01: /* Reserved */
+			return 0;
+		default:
+			TotalBytes = 3;
+			break;
+	}
+
+	Bytes[0] = Event->Data1;
+	Bytes[1] = Event->Data2;
+	Bytes[2] = Event->Data3;
+
+	if ((Event->Command >= 0x08) && (Event->Command <= 0x0E))
+	{
+		/* Channel messages with the same status as the last sent may omit their status byte */
+		if (Event->Data1 == Encoder->RunningStatus)
+		{
+			Bytes[0] = Event->Data2;
+			Bytes[1] = Event->Data3;
+			
+			return (TotalBytes - 1);
+		}
+
+		Encoder->RunningStatus = Event->Data1;
+	}
+	else if ((Event->Data1 & 0x80) && (Event->Data1 < 0xF8))
+	{
+		/* System Common and SysEx status bytes cancel the running status, System Real-Time bytes do not */
+		Encoder->RunningStatus = 0;
+	}
+
+	return TotalBytes;
+}
@@ -0,0 +1,134 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Header file for MIDIStream.c.
+ */
+
+#ifndef _MIDISTREAM_H_
+#define _MIDISTREAM_H_
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+		
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/USB/Class/MIDI.h>
+
+	/* Macros: */
+		/** Maximum number of bytes a single USB-MIDI event packet may expand to in a serial MIDI byte stream. */
+		#define MIDISTREAM_MAX_EVENT_BYTES   3
+
+		/** USB-MIDI Code Index Number of a two byte System Common message event packet. */
+		#define MIDISTREAM_CIN_SYSCOMMON_2   0x02
+
+		/** USB-MIDI Code Index Number of a three byte System Common message event packet. */
+		#define MIDISTREAM_CIN_SYSCOMMON_3   0x03
+
+		/** USB-MIDI Code Index Number of a SysEx start or continuation event packet, containing three SysEx bytes. */
+		#define MIDISTREAM_CIN_SYSEX_START   0x04
+
+		/** USB-MIDI Code Index Number of a single byte System Common message, or a SysEx end event packet containing one byte. */
+		#define MIDISTREAM_CIN_SYSEX_END_1   0x05
+
+		/** USB-MIDI Code Index Number of a SysEx end event packet containing two SysEx bytes. */
+		#define MIDISTREAM_CIN_SYSEX_END_2   0x06
+
+		/** USB-MIDI Code Index Number of a SysEx end event packet containing three SysEx bytes. */
+		#define MIDISTREAM_CIN_SYSEX_END_3   0x07
+
+		/** USB-MIDI Code Index Number of a single byte event packet, used for System Real-Time messages. */
+		#define MIDISTREAM_CIN_SINGLE_BYTE   0x0F
+
+	/* Type Defines: */
+		/** Type define for a serial MIDI byte stream parser. One parser should be used for each incoming serial
+		 *  MIDI port, with each port's events tagged with a different USB-MIDI virtual cable number.
+		 */
+		typedef struct
+		{
+			uint8_t CableNumber; /**< USB-MIDI virtual cable number of the events generated by the parser */
+			uint8_t RunningStatus; /**< Current channel message running status byte, or zero if none */
+			uint8_t Message[MIDISTREAM_MAX_EVENT_BYTES]; /**< Bytes of the partially received message */
+			uint8_t MessageLength; /**< Number of bytes stored in the Message buffer */
+			uint8_t ExpectedLength; /**< Total number of bytes in the message currently being received */
+			bool    InSysEx; /**< Indicates if a SysEx message is currently being received */
+		} MIDIStream_Parser_t;
+
+		/** Type define for a serial MIDI byte stream encoder. One encoder should be used for each outgoing serial
+		 *  MIDI port, as the running status of each port is tracked independently.
+		 */
+		typedef struct
+		{
+			uint8_t RunningStatus; /**< Last channel message status byte sent to the port, or zero if none */
+		} MIDIStream_Encoder_t;
+
+	/* Function Prototypes: */
+		/** Initializes or resets a given serial MIDI byte stream parser.
+		 *
+		 *  \param[out] Parser  Parser to initialize
+		 *  \param[in] CableNumber  USB-MIDI virtual cable number to tag the parser's generated events with
+		 */
+		void MIDIStream_InitParser(MIDIStream_Parser_t* const Parser, const uint8_t CableNumber) ATTR_NON_NULL_PTR_ARG(1);
+
+		/** Processes the next byte received from a serial MIDI port. Running status, System Real-Time bytes interleaved
+		 *  within other messages and SysEx messages are all handled, with SysEx data split into as many event packets as
+		 *  required.
+		 *
+		 *  \param[in,out] Parser  Parser associated with the serial MIDI port the byte was received from
+		 *  \param[in] Byte  Byte received from the serial MIDI port
+		 *  \param[out] Event  Location where a completed USB-MIDI event packet is to be stored
+		 *
+		 *  \return Boolean true if the byte completed an event packet which was stored to Event, false otherwise
+		 */
+		bool MIDIStream_ParseByte(MIDIStream_Parser_t* const Parser, const uint8_t Byte, MIDI_EventPacket_t* const Event)
+		                          ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3);
+
+		/** Initializes or resets a given serial MIDI byte stream encoder.
+		 *
+		 *  \param[out] Encoder  Encoder to initialize
+		 */
+		void MIDIStream_InitEncoder(MIDIStream_Encoder_t* const Encoder) ATTR_NON_NULL_PTR_ARG(1);
+
+		/** Converts a USB-MIDI event packet into the bytes to transmit to a serial MIDI port. The status bytes of channel
+		 *  messages are omitted where the port's running status already matches, to make best use of the serial link.
+		 *
+		 *  \param[in,out] Encoder  Encoder associated with the serial MIDI port the event is to be sent to
+		 *  \param[in] Event  USB-MIDI event packet to convert
+		 *  \param[out] Bytes  Buffer of at least \ref MIDISTREAM_MAX_EVENT_BYTES bytes where the converted bytes are to be stored
+		 *
+		 *  \return Number of bytes stored into the Bytes buffer, which may be zero for reserved event packets
+		 */
+		uint8_t MIDIStream_EncodeEvent(MIDIStream_Encoder_t* const Encoder, const MIDI_EventPacket_t* const Event,
+		                               uint8_t* const Bytes) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2)
+		                               ATTR_NON_NULL_PTR_ARG(3);
+
+#endif
@@ -0,0 +1,214 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Main source file for the MIDIBridge project. This file contains the main tasks of
+ *  the project and is responsible for the initial application hardware configuration.
+ */
+
+#include "MIDIBridge.h"
+
+/** Circular buffer to hold bytes received from the serial MIDI port before they are parsed into events. */
+RingBuff_t SerialToUSB_Buffer;
+
+/** Circular buffer to hold bytes converted from host events before they are sent to the serial MIDI port. */
+RingBuff_t USBToSerial_Buffer;
+
+/** Parser for the byte stream received from the serial MIDI port. */
+MIDIStream_Parser_t SerialParser;
+
+/** Encoder for the byte stream sent to the serial MIDI port. */
+MIDIStream_Encoder_t SerialEncoder;
+
+/** LUFA MIDI Class driver interface configuration and state information. This structure is
+ *  passed to all MIDI Class driver functions, so that multiple instances of the same class
+ *  within a device can be differentiated from one another.
+ */
+USB_ClassInfo_MIDI_Device_t Bridge_MIDI_Interface =
+	{
+		.Config =
+			{
+				.StreamingInterfaceNumber = 1,
+
+				.DataINEndpointNumber      = MIDI_STREAM_IN_EPNUM,
+				.DataINEndpointSize        = MIDI_STREAM_EPSIZE,
+				.DataINEndpointDoubleBank  = false,
+
+				.DataOUTEndpointNumber     = MIDI_STREAM_OUT_EPNUM,
+				.DataOUTEndpointSize       = MIDI_STREAM_EPSIZE,
+				.DataOUTEndpointDoubleBank = false,
+
+				.DataINFlushFrames         = 1,
+			},
+	};
+
+/** Main program entry point. This routine contains the overall program flow, including initial
+ *  setup of all components and the main program loop.
+ */
+int main(void)
+{
+	SetupHardware();
+	
+	Buffer_Initialize(&SerialToUSB_Buffer);
+	Buffer_Initialize(&USBToSerial_Buffer);
+
+	MIDIStream_InitParser(&SerialParser, MIDI_SERIAL_CABLE);
+	MIDIStream_InitEncoder(&SerialEncoder);
+
+	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+	sei();
+
+	for (;;)
+	{
+		SerialToUSB_Task();
+		USBToSerial_Task();
+
+		MIDI_Device_USBTask(&Bridge_MIDI_Interface);
+		USB_USBTask();
+	}
+}
+
+/** Configures the board hardware and chip peripherals for the project's functionality. */
+void SetupHardware(void)
+{
+	/* Disable watchdog if enabled by bootloader/fuses */
+	MCUSR &= ~(1 << WDRF);
+	wdt_disable();
+
+	/* Disable clock division */
+	clock_prescale_set(clock_div_1);
+
+	/* Hardware Initialization */
+	Serial_Init(MIDI_SERIAL_BAUDRATE, false);
+	LEDs_Init();
+	USB_Init();
+
+	/* Enable the USART receive complete interrupt, to buffer incoming serial MIDI data */
+	UCSR1B |= (1 << RXCIE1);
+}
+
+/** Parses bytes received from the serial MIDI port into USB-MIDI events, and sends them to the host in batches. */
+void SerialToUSB_Task(void)
+{
+	static MIDI_EventPacket_t PendingEvents[MIDI_EVENT_BUFFER_SIZE];
+	static uint8_t            TotalPendingEvents;
+
+	/* Parse buffered serial bytes into events until the event buffer is full */
+	while (SerialToUSB_Buffer.Elements && (TotalPendingEvents < MIDI_EVENT_BUFFER_SIZE))
+	{
+		if (MIDIStream_ParseByte(&SerialParser, Buffer_GetElement(&SerialToUSB_Buffer), &PendingEvents[TotalPendingEvents]))
+		  TotalPendingEvents++;
+	}
+
+	if (!(TotalPendingEvents))
+	  return;
+
+	/* Queue as many events as the IN endpoint banks will currently accept, retaining the remainder for later */
+	uint8_t EventsSent = MIDI_Device_SendEventPackets(&Bridge_MIDI_Interface, PendingEvents, TotalPendingEvents);
+
+	if (EventsSent)
+	{
+		TotalPendingEvents -= EventsSent;
+		memmove(PendingEvents, &PendingEvents[EventsSent], (TotalPendingEvents * sizeof(MIDI_EventPacket_t)));
+	}
+}
+
+/** Converts USB-MIDI events from the host into serial MIDI bytes, and transmits them through the serial MIDI port. */
+void USBToSerial_Task(void)
+{
+	/* Only accept as many events from the host as can be converted into the free space of the transmit buffer */
+	uint8_t MaxEvents = ((BUFF_STATICSIZE - USBToSerial_Buffer.Elements) / MIDISTREAM_MAX_EVENT_BYTES);
+
+	if (MaxEvents > MIDI_EVENT_BUFFER_SIZE)
+	  MaxEvents = MIDI_EVENT_BUFFER_SIZE;
+
+	if (MaxEvents)
+	{
+		MIDI_EventPacket_t ReceivedEvents[MaxEvents];
+		uint8_t            TotalReceivedEvents = MIDI_Device_ReceiveEventPackets(&Bridge_MIDI_Interface, ReceivedEvents, MaxEvents);
+
+		for (uint8_t EventIndex = 0; EventIndex < TotalReceivedEvents; EventIndex++)
+		{
+			uint8_t EventBytes[MIDISTREAM_MAX_EVENT_BYTES];
+			
+			if (ReceivedEvents[EventIndex].CableNumber != MIDI_SERIAL_CABLE)
+			  continue;
+
+			uint8_t TotalEventBytes = MIDIStream_EncodeEvent(&SerialEncoder, &ReceivedEvents[EventIndex], EventBytes);
+
+			for (uint8_t ByteIndex = 0; ByteIndex < TotalEventBytes; ByteIndex++)
+			  Buffer_StoreElement(&USBToSerial_Buffer, EventBytes[ByteIndex]);
+		}
+	}
+
+	/* Load the next buffered byte into the USART if it is ready, without waiting for the previous byte to be sent */
+	if (USBToSerial_Buffer.Elements && (UCSR1A & (1 << UDRE1)))
+	  UDR1 = Buffer_GetElement(&USBToSerial_Buffer);
+}
+
+/** Event handler for the library USB Connection event. */
+void EVENT_USB_Device_Connect(void)
+{
+	LEDs_SetAllLEDs(LEDMASK_USB_ENUMERATING);
+}
+
+/** Event handler for the library USB Disconnection event. */
+void EVENT_USB_Device_Disconnect(void)
+{
+	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+}
+
+/** Event handler for the library USB Configuration Changed event. */
+void EVENT_USB_Device_ConfigurationChanged(void)
+{
+	LEDs_SetAllLEDs(LEDMASK_USB_READY);
+
+	if (!(MIDI_Device_ConfigureEndpoints(&Bridge_MIDI_Interface)))
+	  LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
+}
+
+/** Event handler for the library USB Unhandled Control Request event. */
+void EVENT_USB_Device_UnhandledControlRequest(void)
+{
+	MIDI_Device_ProcessControlRequest(&Bridge_MIDI_Interface);
+}
+
+/** ISR to manage the reception of data from the serial MIDI port, placing received bytes into a circular buffer
+ *  for later conversion into USB-MIDI events.
+ */
+ISR(USART1_RX_vect, ISR_BLOCK)
+{
+	uint8_t ReceivedByte = UDR1;
+
+	if (USB_DeviceState == DEVICE_STATE_Configured)
+	  Buffer_StoreElement(&SerialToUSB_Buffer, ReceivedByte);
+}
@@ -0,0 +1,732 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Host test for the BINARY_LOG mode of the temperature data logger. The project's binary sample log and FatFs library are
+ *  built for the host against an in-memory FAT16 image and a simulated RTC. The test logs a series of simulated sessions
+ *  in the same way as the logger itself, opening the "DDMMYY.bin" file of the current date and feeding samples to the log
+ *  from a simulated sampling interrupt, while a simulated main program loop writes the queued samples out at random
+ *  intervals, sometimes falling far enough behind for samples to be lost. Sessions are started late in the evening so
+ *  that their samples cross midnight, and the month, year and leap day boundaries.
+ *
+ *  After each session the image is checked by a FAT16 filesystem checker (see FATCheck.c), and every log file found is
+ *  converted back to CSV text by the project's TempLogConverter host utility. The CSV lines must match the timestamps and
+ *  temperatures of the logged samples exactly, and the number of lost samples reported by the utility must match the
+ *  number of samples dropped by the log.
+ *
+ *  Power is removed between two sampling ticks of some sessions instead of closing the log. Each session must then hold
+ *  at least every sample older than the log's durability window (BINARY_LOG_SYNC_SECONDS) at the last write of queued
+ *  samples, and the next session must continue the file after the data which was stored. Other sessions stall the main
+ *  program loop for long enough that the gap in the sample numbers no longer fits into the current log sector, or close
+ *  the log while the sample queue is full just as the queued samples fill a log sector, so that the samples dropped after
+ *  them must be recorded in an otherwise empty sector.
+ *
+ *  Build and run with "make test" in this directory. The program exits with a non-zero status if any test fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../Lib/BinaryLog.h"
+#include "diskio.h"
+#include "FATCheck.h"
+
+/** Total number of sectors in the FAT image, the size of a board dataflash. */
+#define IMAGE_SECTORS            8192
+
+/** Number of sectors reserved for the boot sector at the start of the FAT image. */
+#define RESERVED_SECTORS         1
+
+/** Number of entries in the root directory of the FAT image. */
+#define ROOT_ENTRIES             512
+
+/** Number of simulated sessions of each test. */
+#define TOTAL_SESSIONS           40
+
+/** One in this many sessions starts on the evening of the next simulated day. */
+#define NEW_DAY_INTERVAL         5
+
+/** Largest number of sampling ticks in each session. */
+#define MAX_SESSION_TICKS        2000
+
+/** Largest number of sampling ticks between two writes of the queued samples by the simulated main program loop. */
+#define MAX_TASK_INTERVAL        8
+
+/** One in this many writes of the queued samples is delayed by up to three times the length of the sample queue. */
+#define OVERRUN_INTERVAL         40
+
+/** Sampling tick after which the main program loop stalls in the sessions with a long stall. */
+#define LONG_STALL_START         10
+
+/** Number of sampling ticks of a long main program loop stall, after which the next sample no longer fits into the log
+ *  sector holding the samples before the stall.
+ */
+#define LONG_STALL_TICKS         65540
+
+/** Command line used to convert the extracted log files to CSV text, and the files it reads from and reports to. */
+#define CONVERTER_COMMAND        "./TempLogConverter BinaryLogTest.bin 2> BinaryLogTest.err"
+#define CONVERTER_INPUT          "BinaryLogTest.bin"
+#define CONVERTER_ERRORS         "BinaryLogTest.err"
+
+/** Type define for a test configuration. */
+typedef struct
+{
+	const char* Name; /**< Name of the test */
+	struct tm   StartTime; /**< Simulated date and time at which the first session starts */
+	uint8_t     PowerLossInterval; /**< Power is removed in one in this many sessions, or never if zero */
+	uint8_t     LongStallInterval; /**< The main program loop stalls in one in this many sessions, or never if zero */
+	uint8_t     FullSectorInterval; /**< The log is closed as samples are dropped after a full sector in one in this many
+	                                 *   sessions, or never if zero
+	                                 */
+} TestConfig_t;
+
+/** Type define for the expected contents of a logging session. */
+typedef struct
+{
+	char                Name[12]; /**< Space padded FAT short name of the session's log file, null terminated */
+	time_t              StartTime; /**< Simulated time at which the session started */
+	BinaryLog_Sample_t* Samples; /**< Samples queued by the log during the session, in order */
+	uint32_t            TotalSamples; /**< Number of samples queued during the session, including any lost to power loss */
+	uint32_t            DurableSamples; /**< Number of the queued samples which must have been stored */
+	uint32_t            LostSamples; /**< Number of samples dropped by the log as the sample queue was full */
+	bool                PowerLost; /**< Indicates if the session ended with a power loss rather than closing the log */
+	bool                Discarded; /**< Indicates if the session's file was lost to a power loss before it was stored */
+} ExpectedSession_t;
+
+/** Test configurations, each run from a freshly formatted FAT image. */
+static const TestConfig_t TestConfigs[] =
+	{
+		{"Clean shutdown",    {.tm_year = 109, .tm_mon = 11, .tm_mday = 30, .tm_hour = 22}, 0, 0, 4},
+		{"Main loop stalls",  {.tm_year = 112, .tm_mon = 1,  .tm_mday = 27, .tm_hour = 22}, 0, 4, 0},
+		{"Power loss",        {.tm_year = 110, .tm_mon = 5,  .tm_mday = 29, .tm_hour = 22}, 3, 0, 0},
+	};
+
+/** Contents of the in-memory FAT image. */
+static uint8_t Image[IMAGE_SECTORS][BLOCKDEV_BLOCK_SIZE];
+
+/** Number of disk writes made by FatFs. */
+static uint32_t DiskWrites;
+
+/** Current time of the simulated RTC. */
+static time_t RTCTime;
+
+/** Expected contents of each session of the current test. */
+static ExpectedSession_t Sessions[TOTAL_SESSIONS];
+
+/** FatFs structures of the simulated logger, reset on each simulated power on. */
+static FATFS DiskFATState;
+static FIL   TempLogFile;
+
+void DS1307_GetDate(uint8_t* Day, uint8_t* Month, uint8_t* Year)
+{
+	struct tm* Time = gmtime(&RTCTime);
+
+	*Day   = Time->tm_mday;
+	*Month = (Time->tm_mon + 1);
+	*Year  = (Time->tm_year - 100);
+}
+
+void DS1307_GetTime(uint8_t* Hour, uint8_t* Minute, uint8_t* Second)
+{
+	struct tm* Time = gmtime(&RTCTime);
+
+	*Hour   = Time->tm_hour;
+	*Minute = Time->tm_min;
+	*Second = Time->tm_sec;
+}
+
+DSTATUS disk_initialize(BYTE drv)
+{
+	return 0;
+}
+
+DSTATUS disk_status(BYTE drv)
+{
+	return 0;
+}
+
+DRESULT disk_read(BYTE drv, BYTE* buff, DWORD sector, BYTE count)
+{
+	if ((sector + count) > IMAGE_SECTORS)
+	  return RES_PARERR;
+
+	memcpy(buff, Image[sector], ((uint32_t)count * BLOCKDEV_BLOCK_SIZE));
+	return RES_OK;
+}
+
+DRESULT disk_write(BYTE drv, const BYTE* buff, DWORD sector, BYTE count)
+{
+	if ((sector + count) > IMAGE_SECTORS)
+	  return RES_PARERR;
+
+	DiskWrites++;
+
+	memcpy(Image[sector], buff, ((uint32_t)count * BLOCKDEV_BLOCK_SIZE));
+	return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void* buff)
+{
+	return (ctrl == CTRL_SYNC) ? RES_OK : RES_PARERR;
+}
+
+DWORD get_fattime(void)
+{
+	struct tm* Time = gmtime(&RTCTime);
+
+	return ((DWORD)(Time->tm_year - 80) << 25) | ((DWORD)(Time->tm_mon + 1) << 21) | ((DWORD)Time->tm_mday << 16) |
+	       ((DWORD)Time->tm_hour << 11) | ((DWORD)Time->tm_min << 5) | ((DWORD)Time->tm_sec >> 1);
+}
+
+/** Stores a 16-bit value into the FAT image in little endian format.
+ *
+ *  \param[out] Data   Location of the value in the image
+ *  \param[in]  Value  Value to store
+ */
+static void PutWord(uint8_t* const Data, const uint16_t Value)
+{
+	Data[0] = (Value & 0xFF);
+	Data[1] = (Value >> 8);
+}
+
+/** Formats the FAT image as an empty FAT16 volume with one sector per cluster, as a host would format the dataflash. */
+static void FormatImage(void)
+{
+	uint32_t RootSectors = ((ROOT_ENTRIES * 32) / BLOCKDEV_BLOCK_SIZE);
+	uint32_t Clusters    = (IMAGE_SECTORS - RESERVED_SECTORS - RootSectors);
+	uint32_t FATSectors  = ((((Clusters + 2) * 2) + (BLOCKDEV_BLOCK_SIZE - 1)) / BLOCKDEV_BLOCK_SIZE);
+	uint8_t* BootSector  = Image[0];
+
+	memset(Image, 0x00, sizeof(Image));
+
+	BootSector[0] = 0xEB;
+	BootSector[1] = 0x3C;
+	BootSector[2] = 0x90;
+	memcpy(&BootSector[3], "MSDOS5.0", 8);
+	PutWord(&BootSector[11], BLOCKDEV_BLOCK_SIZE);
+	BootSector[13] = 1;
+	PutWord(&BootSector[14], RESERVED_SECTORS);
+	BootSector[16] = 2;
+	PutWord(&BootSector[17], ROOT_ENTRIES);
+	PutWord(&BootSector[19], IMAGE_SECTORS);
+	BootSector[21] = 0xF8;
+	PutWord(&BootSector[22], FATSectors);
+	BootSector[38] = 0x29;
+	memcpy(&BootSector[43], "NO NAME    ", 11);
+	memcpy(&BootSector[54], "FAT16   ", 8);
+	PutWord(&BootSector[510], 0xAA55);
+
+	for (uint8_t FAT = 0; FAT < 2; FAT++)
+	{
+		uint8_t* FATStart = Image[RESERVED_SECTORS + (FAT * FATSectors)];
+
+		PutWord(&FATStart[0], 0xFFF8);
+		PutWord(&FATStart[2], 0xFFFF);
+	}
+}
+
+/** Formats the CSV line the converter is expected to produce for a logged sample.
+ *
+ *  \param[out] Line     Buffer to store the null terminated line into
+ *  \param[in]  Session  Session the sample was logged in
+ *  \param[in]  Sample   Logged sample
+ *
+ *  \return Length of the line in characters
+ */
+static int FormatLine(char* const Line, const ExpectedSession_t* const Session, const BinaryLog_Sample_t* const Sample)
+{
+	time_t     SampleTime   = (Session->StartTime + (Sample->SampleNumber / BINARY_LOG_SAMPLE_RATE_HZ));
+	unsigned   Milliseconds = (((Sample->SampleNumber % BINARY_LOG_SAMPLE_RATE_HZ) * 1000) / BINARY_LOG_SAMPLE_RATE_HZ);
+	struct tm* Time         = gmtime(&SampleTime);
+
+	return sprintf(Line, "%02d/%02d/%04d, %02d:%02d:%02d.%03u, %d Degrees\r\n", Time->tm_mday, (Time->tm_mon + 1),
+	               (Time->tm_year + 1900), Time->tm_hour, Time->tm_min, Time->tm_sec, Milliseconds, Sample->Temperature);
+}
+
+/** Converts an extracted log file to CSV text with the TempLogConverter host utility.
+ *
+ *  \param[in]  File          Log file extracted from the FAT image
+ *  \param[out] CSVText       Location to store the allocated, null terminated CSV text output by the utility
+ *  \param[out] ReportedLost  Location to store the number of lost samples reported by the utility
+ *
+ *  \return Number of errors found
+ */
+static uint32_t ConvertFile(const FATCheck_File_t* const File, char** const CSVText, unsigned long* const ReportedLost)
+{
+	uint32_t Errors  = 0;
+	size_t   Length  = 0;
+	FILE*    BinFile = fopen(CONVERTER_INPUT, "wb");
+
+	*CSVText      = NULL;
+	*ReportedLost = 0;
+
+	if ((BinFile == NULL) || (fwrite(File->Data, 1, File->SizeBytes, BinFile) != File->SizeBytes))
+	{
+		printf("  %s: cannot write %s\n", File->Name, CONVERTER_INPUT);
+		return 1;
+	}
+
+	fclose(BinFile);
+
+	FILE* Converter = popen(CONVERTER_COMMAND, "r");
+
+	if (Converter == NULL)
+	{
+		printf("  %s: cannot run \"%s\"\n", File->Name, CONVERTER_COMMAND);
+		return 1;
+	}
+
+	for (;;)
+	{
+		*CSVText = realloc(*CSVText, (Length + 4096 + 1));
+
+		size_t BytesRead = fread(&(*CSVText)[Length], 1, 4096, Converter);
+
+		Length += BytesRead;
+
+		if (BytesRead < 4096)
+		  break;
+	}
+
+	(*CSVText)[Length] = '\0';
+
+	if (pclose(Converter))
+	{
+		printf("  %s: converter exited with an error\n", File->Name);
+		Errors++;
+	}
+
+	/* Any invalid sectors are reported as an error, lost samples are checked by the caller */
+	char  ErrorLine[200];
+	FILE* ErrorFile = fopen(CONVERTER_ERRORS, "r");
+
+	while ((ErrorFile != NULL) && fgets(ErrorLine, sizeof(ErrorLine), ErrorFile))
+	{
+		if (sscanf(ErrorLine, "Warning: %lu sample(s) were lost by the logger.", ReportedLost) != 1)
+		{
+			printf("  %s: converter reported \"%.*s\"\n", File->Name, (int)strcspn(ErrorLine, "\n"), ErrorLine);
+			Errors++;
+		}
+	}
+
+	if (ErrorFile != NULL)
+	  fclose(ErrorFile);
+
+	return Errors;
+}
+
+/** Checks the CSV text converted from a log file against the samples of every session logged to the file. The lines of
+ *  a session which lost power need only hold the session's durable samples; once checked, the number of samples stored
+ *  for such a session is recorded, as the next session continues the file after them.
+ *
+ *  \param[in] File  Log file extracted from the FAT image
+ *  \param[in] TotalSessions  Number of sessions logged so far
+ *
+ *  \return Number of errors found
+ */
+static uint32_t CheckFile(const FATCheck_File_t* const File, const uint16_t TotalSessions)
+{
+	char*         CSVText;
+	unsigned long ReportedLost;
+	unsigned long ExpectedLost = 0;
+	bool          IsLostKnown  = true;
+	uint32_t      Errors       = ConvertFile(File, &CSVText, &ReportedLost);
+
+	if (CSVText == NULL)
+	  return Errors;
+
+	const char* Position = CSVText;
+
+	for (uint16_t SessionIndex = 0; SessionIndex < TotalSessions; SessionIndex++)
+	{
+		ExpectedSession_t* Session = &Sessions[SessionIndex];
+		uint32_t           SamplesFound;
+
+		if (Session->Discarded || strcmp(Session->Name, File->Name))
+		  continue;
+
+		for (SamplesFound = 0; SamplesFound < Session->TotalSamples; SamplesFound++)
+		{
+			char Line[100];
+			int  LineLength = FormatLine(Line, Session, &Session->Samples[SamplesFound]);
+
+			if (strncmp(Position, Line, LineLength))
+			  break;
+
+			Position += LineLength;
+		}
+
+		if ((SamplesFound < Session->DurableSamples) || (!(Session->PowerLost) && (SamplesFound != Session->TotalSamples)))
+		{
+			printf("  %s: session %u converted to %u matching lines, expected %u (%u durable)\n", File->Name, SessionIndex,
+			       SamplesFound, Session->TotalSamples, Session->DurableSamples);
+			Errors++;
+		}
+
+		if (Session->PowerLost)
+		{
+			Session->TotalSamples   = SamplesFound;
+			Session->DurableSamples = SamplesFound;
+			IsLostKnown = false;
+		}
+
+		ExpectedLost += Session->LostSamples;
+	}
+
+	if (*Position)
+	{
+		printf("  %s: unexpected CSV text \"%.*s\"\n", File->Name, (int)strcspn(Position, "\r\n"), Position);
+		Errors++;
+	}
+
+	/* Samples dropped just before a power loss need not be recorded in the file */
+	if (IsLostKnown && (ReportedLost != ExpectedLost))
+	{
+		printf("  %s: converter reported %lu lost samples, expected %lu\n", File->Name, ReportedLost, ExpectedLost);
+		Errors++;
+	}
+
+	free(CSVText);
+	return Errors;
+}
+
+/** Checks the FAT image as the host would see it, and checks every log file in it against the logged sessions.
+ *
+ *  \param[in] TotalSessions  Number of sessions logged so far
+ *
+ *  \return Number of errors found
+ */
+static uint32_t CheckImage(const uint16_t TotalSessions)
+{
+	FATCheck_Layout_t Layout;
+	FATCheck_File_t   Files[FATCHECK_MAX_FILES];
+	uint8_t           TotalFiles;
+	uint8_t           FileIndex = 0;
+	uint32_t          Errors;
+
+	if ((Errors = FATCheck_ReadLayout(Image[0], &Layout)) != 0)
+	  return Errors;
+
+	Errors = FATCheck_CheckVolume(Image[0], &Layout, Files, &TotalFiles);
+
+	/* Files must be found in the order they were created, except that a file created by a session which lost power
+	 * before the file was stored may be missing */
+	for (uint16_t SessionIndex = 0; SessionIndex < TotalSessions; SessionIndex++)
+	{
+		ExpectedSession_t* Session = &Sessions[SessionIndex];
+		bool               IsKnownFile = false;
+
+		if (Session->Discarded)
+		  continue;
+
+		for (uint16_t PrevIndex = 0; PrevIndex < SessionIndex; PrevIndex++)
+		{
+			if (!(Sessions[PrevIndex].Discarded) && !(strcmp(Sessions[PrevIndex].Name, Session->Name)))
+			  IsKnownFile = true;
+		}
+
+		if (IsKnownFile)
+		  continue;
+
+		if ((FileIndex < TotalFiles) && !(strcmp(Files[FileIndex].Name, Session->Name)))
+		{
+			Errors += CheckFile(&Files[FileIndex++], TotalSessions);
+		}
+		else if (Session->PowerLost && !(Session->DurableSamples) && (SessionIndex == (TotalSessions - 1)))
+		{
+			Session->Discarded = true;
+		}
+		else
+		{
+			printf("  Expected file \"%s\" is missing\n", Session->Name);
+			Errors++;
+		}
+	}
+
+	if (FileIndex != TotalFiles)
+	{
+		printf("  Image holds %u files, expected %u\n", TotalFiles, FileIndex);
+		Errors++;
+	}
+
+	FATCheck_FreeFiles(Files, TotalFiles);
+	return Errors;
+}
+
+/** Determines the number of sampling ticks until the simulated main program loop next writes out the queued samples.
+ *
+ *  \return Number of sampling ticks until the queued samples are written
+ */
+static uint32_t NextTaskDelay(void)
+{
+	if (!(rand() % OVERRUN_INTERVAL))
+	  return (1 + (rand() % (3 * BINARY_LOG_RING_SAMPLES)));
+
+	return (1 + (rand() % MAX_TASK_INTERVAL));
+}
+
+/** Logs a single simulated session in the same way as the logger, from power on until the log is closed or power is
+ *  removed.
+ *
+ *  \param[in] Session     Expected contents of the session, filled in as samples are logged
+ *  \param[in] PowerLoss   Indicates if power is to be removed rather than the log closed at the end of the session
+ *  \param[in] LongStall   Indicates if the main program loop is to stall for \ref LONG_STALL_TICKS ticks
+ *  \param[in] FullSector  Indicates if the log is to be closed as samples are dropped after filling a sector
+ *
+ *  \return Number of errors found
+ */
+static uint32_t LogSession(ExpectedSession_t* const Session, const bool PowerLoss, const bool LongStall,
+                           const bool FullSector)
+{
+	uint32_t Errors     = 0;
+	uint32_t TotalTicks = (1 + (rand() % MAX_SESSION_TICKS) + (LongStall ? LONG_STALL_TICKS : 0));
+	uint32_t EndTick    = (PowerLoss ? (rand() % TotalTicks) : TotalTicks);
+	uint32_t TaskDelay  = NextTaskDelay();
+	uint32_t Queued     = 0;
+	uint32_t TaskTick   = 0;
+	bool     IsStalling = LongStall;
+	bool     IsFilling  = FullSector;
+	int8_t   Temperature = (15 + (rand() % 10));
+	char     LogFileName[16];
+	uint8_t  Day, Month, Year;
+
+	memset(Session, 0x00, sizeof(ExpectedSession_t));
+	Session->StartTime = RTCTime;
+	Session->Samples   = malloc((TotalTicks + BINARY_LOG_RING_SAMPLES + MAX_TASK_INTERVAL) * sizeof(BinaryLog_Sample_t));
+	Session->PowerLost = PowerLoss;
+
+	/* Open the log file of the current date from power on, as the logger does */
+	DS1307_GetDate(&Day, &Month, &Year);
+	sprintf(LogFileName, "%02d%02d%02d.bin", Day, Month, Year);
+	sprintf(Session->Name, "%02d%02d%02d  BIN", Day, Month, Year);
+
+	memset(&DiskFATState, 0x00, sizeof(DiskFATState));
+	memset(&TempLogFile, 0x00, sizeof(TempLogFile));
+
+	f_mount(0, &DiskFATState);
+
+	if (f_open(&TempLogFile, LogFileName, (FA_OPEN_ALWAYS | FA_WRITE)) != FR_OK)
+	{
+		printf("  Cannot open %s\n", LogFileName);
+		return 1;
+	}
+
+	BinaryLog_Open(&TempLogFile);
+
+	for (uint32_t Tick = 0; Tick < EndTick; Tick++)
+	{
+		RTCTime = (Session->StartTime + (Tick / BINARY_LOG_SAMPLE_RATE_HZ));
+
+		Temperature += ((rand() % 3) - 1);
+
+		/* Sampling interrupt, samples beyond those which fit into the queue are dropped by the log */
+		BinaryLog_AddSample(Temperature);
+
+		if (Queued++ < BINARY_LOG_RING_SAMPLES)
+		{
+			Session->Samples[Session->TotalSamples].SampleNumber = Tick;
+			Session->Samples[Session->TotalSamples].Temperature  = Temperature;
+			Session->TotalSamples++;
+		}
+		else
+		{
+			Session->LostSamples++;
+		}
+
+		if (--TaskDelay)
+		  continue;
+
+		/* Main program loop, writing out the queued samples */
+		if (!(BinaryLog_IsSampleQueued()))
+		{
+			printf("  %s: no samples queued after %u sampling ticks\n", LogFileName, Queued);
+			Errors++;
+		}
+
+		BinaryLog_Task();
+
+		if (BinaryLog_IsSampleQueued())
+		{
+			printf("  %s: samples still queued after writing them out\n", LogFileName);
+			Errors++;
+		}
+
+		Queued    = 0;
+		TaskTick  = (Tick + 1);
+		TaskDelay = NextTaskDelay();
+
+		if (IsStalling && (TaskTick >= LONG_STALL_START))
+		{
+			TaskDelay  = LONG_STALL_TICKS;
+			IsStalling = false;
+		}
+
+		/* Write out the queued samples no later than when a full queue would fill the current sector, then stop writing
+		 * them out and close the log once samples have been dropped after the queued samples fill the sector */
+		if (IsFilling)
+		{
+			uint32_t SectorSpace = (BINARY_LOG_SECTOR_RECORDS - (Session->TotalSamples % BINARY_LOG_SECTOR_RECORDS));
+
+			if (SectorSpace == BINARY_LOG_RING_SAMPLES)
+			{
+				EndTick   = (TaskTick + BINARY_LOG_RING_SAMPLES + 1 + (rand() % MAX_TASK_INTERVAL));
+				TaskDelay = EndTick;
+				IsFilling = false;
+			}
+			else if (SectorSpace > BINARY_LOG_RING_SAMPLES)
+			{
+				if (TaskDelay > (SectorSpace - BINARY_LOG_RING_SAMPLES))
+				  TaskDelay = (SectorSpace - BINARY_LOG_RING_SAMPLES);
+			}
+			else if (TaskDelay > SectorSpace)
+			{
+				TaskDelay = SectorSpace;
+			}
+		}
+	}
+
+	if (PowerLoss)
+	{
+		uint32_t SyncedTicks = (uint32_t)BINARY_LOG_SYNC_SECONDS * BINARY_LOG_SAMPLE_RATE_HZ;
+
+		/* Only samples which had reached the end of the durability window at the last write of the queue must be stored */
+		while ((Session->DurableSamples < Session->TotalSamples) &&
+		       ((Session->Samples[Session->DurableSamples].SampleNumber + SyncedTicks) <= TaskTick))
+		{
+			Session->DurableSamples++;
+		}
+	}
+	else
+	{
+		BinaryLog_Close();
+
+		if (f_close(&TempLogFile) != FR_OK)
+		{
+			printf("  %s: cannot close the log file\n", LogFileName);
+			Errors++;
+		}
+
+		Session->DurableSamples = Session->TotalSamples;
+	}
+
+	RTCTime = (Session->StartTime + ((EndTick + (BINARY_LOG_SAMPLE_RATE_HZ - 1)) / BINARY_LOG_SAMPLE_RATE_HZ));
+	return Errors;
+}
+
+/** Runs a test configuration, logging a series of simulated sessions and checking the FAT image after each.
+ *
+ *  \param[in] Config  Test configuration to run
+ *
+ *  \return Number of errors found
+ */
+static uint32_t RunTest(const TestConfig_t* const Config)
+{
+	struct tm StartTime   = Config->StartTime;
+	uint32_t  Errors      = 0;
+	uint32_t  PowerLosses = 0;
+	uint32_t  Samples     = 0;
+	uint32_t  LostSamples = 0;
+
+	FormatImage();
+	DiskWrites = 0;
+	RTCTime    = timegm(&StartTime);
+
+	for (uint16_t SessionIndex = 0; SessionIndex < TOTAL_SESSIONS; SessionIndex++)
+	{
+		ExpectedSession_t* Session   = &Sessions[SessionIndex];
+		bool               PowerLoss = (Config->PowerLossInterval &&
+		                                ((SessionIndex % Config->PowerLossInterval) == (Config->PowerLossInterval - 1)));
+		bool               LongStall = (Config->LongStallInterval &&
+		                                ((SessionIndex % Config->LongStallInterval) == (Config->LongStallInterval - 1)));
+		bool               FullSector = (Config->FullSectorInterval &&
+		                                 ((SessionIndex % Config->FullSectorInterval) == (Config->FullSectorInterval - 1)));
+
+		uint32_t SessionErrors = LogSession(Session, PowerLoss, LongStall, FullSector);
+
+		SessionErrors += CheckImage(SessionIndex + 1);
+
+		if (SessionErrors)
+		{
+			printf("  Session %u (%s) failed with %u errors\n", SessionIndex, (PowerLoss ? "power lost" : "log closed"),
+			       SessionErrors);
+		}
+
+		Errors      += SessionErrors;
+		PowerLosses += PowerLoss;
+		LostSamples += Session->LostSamples;
+
+		/* Start the next session after a short break, or on the evening of the next day */
+		if (!(rand() % NEW_DAY_INTERVAL))
+		  RTCTime = ((((RTCTime / 86400) + 1) * 86400) + (22 * 3600) + (rand() % 7200));
+		else
+		  RTCTime += (1 + (rand() % 600));
+	}
+
+	for (uint16_t SessionIndex = 0; SessionIndex < TOTAL_SESSIONS; SessionIndex++)
+	{
+		if (!(Sessions[SessionIndex].Discarded))
+		  Samples += Sessions[SessionIndex].TotalSamples;
+
+		free(Sessions[SessionIndex].Samples);
+	}
+
+	printf("%-18s %8u %6u %8u %8u %8u %6u\n", Config->Name, TOTAL_SESSIONS, PowerLosses, Samples, LostSamples,
+	       DiskWrites, Errors);
+
+	return Errors;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	srand(1);
+
+	printf("Binary log test, %u sessions per test at %u samples per second, %u second durability window\n\n",
+	       TOTAL_SESSIONS, BINARY_LOG_SAMPLE_RATE_HZ, BINARY_LOG_SYNC_SECONDS);
+	printf("%-18s %8s %6s %8s %8s %8s %6s\n", "Test", "Sessions", "Losses", "Samples", "Dropped", "Writes", "Errors");
+
+	for (uint8_t Index = 0; Index < (sizeof(TestConfigs) / sizeof(TestConfigs[0])); Index++)
+	  TotalErrors += RunTest(&TestConfigs[Index]);
+
+	printf("\nSamples is the number of samples found in the converted log files after the last session, Dropped the\n");
+	printf("number of samples dropped by the log while the sample queue was full and Writes the number of sector\n");
+	printf("writes made by FatFs.\n");
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %u errors\n", TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,369 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Structural checker for FAT16 volumes, in the manner of a host's filesystem check utility. The boot sector is checked
+ *  for the fields hosts rely on to identify and mount a FAT16 volume, the copies of the File Allocation Table are compared,
+ *  and the cluster chain of every file in the root directory is followed to check that it is terminated, not cross-linked
+ *  with another file and of the length given by the file's size. Allocated clusters which are not part of any file are
+ *  reported as lost clusters. Each problem found is printed, and the contents of the files are extracted so that they may
+ *  be compared against their expected contents.
+ *
+ *  Only the features used by synthesized volumes are supported - subdirectories and long file names are reported as errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FATCheck.h"
+
+/** Reads a little endian 16-bit value from a byte buffer.
+ *
+ *  \param[in] Data  Pointer to the value's first byte
+ *
+ *  \return Value read from the buffer
+ */
+static uint16_t ReadLE16(const uint8_t* Data)
+{
+	return (Data[0] | ((uint16_t)Data[1] << 8));
+}
+
+/** Reads a little endian 32-bit value from a byte buffer.
+ *
+ *  \param[in] Data  Pointer to the value's first byte
+ *
+ *  \return Value read from the buffer
+ */
+static uint32_t ReadLE32(const uint8_t* Data)
+{
+	return (ReadLE16(Data) | ((uint32_t)ReadLE16(&Data[2]) << 16));
+}
+
+/** Checks the boot sector of a FAT16 volume, and determines the volume's layout from it.
+ *
+ *  \param[in]  BootSector  Pointer to the first sector of the volume
+ *  \param[out] Layout      Pointer to the location where the volume's layout is to be stored
+ *
+ *  \return Number of errors found in the boot sector
+ */
+uint32_t FATCheck_ReadLayout(const uint8_t* BootSector, FATCheck_Layout_t* const Layout)
+{
+	uint32_t Errors = 0;
+
+	uint16_t BytesPerSector = ReadLE16(&BootSector[11]);
+	uint16_t TotalSectors16 = ReadLE16(&BootSector[19]);
+	uint32_t TotalSectors32 = ReadLE32(&BootSector[32]);
+
+	Layout->SectorsPerCluster = BootSector[13];
+	Layout->ReservedSectors   = ReadLE16(&BootSector[14]);
+	Layout->TotalFATs         = BootSector[16];
+	Layout->RootEntries       = ReadLE16(&BootSector[17]);
+	Layout->SectorsPerFAT     = ReadLE16(&BootSector[22]);
+	Layout->TotalSectors      = (TotalSectors16 ? TotalSectors16 : TotalSectors32);
+
+	if ((BootSector[0] != 0xEB) && (BootSector[0] != 0xE9))
+	{
+		printf("  Boot sector: invalid jump instruction 0x%02X\n", BootSector[0]);
+		Errors++;
+	}
+
+	if ((BootSector[510] != 0x55) || (BootSector[511] != 0xAA))
+	{
+		printf("  Boot sector: missing 0x55AA signature\n");
+		Errors++;
+	}
+
+	if (BytesPerSector != FATCHECK_SECTOR_SIZE)
+	{
+		printf("  Boot sector: unsupported sector size of %u bytes\n", BytesPerSector);
+		Errors++;
+	}
+
+	if (!(Layout->SectorsPerCluster) || (Layout->SectorsPerCluster & (Layout->SectorsPerCluster - 1)))
+	{
+		printf("  Boot sector: invalid sectors per cluster value of %u\n", Layout->SectorsPerCluster);
+		Errors++;
+	}
+
+	if (!(Layout->ReservedSectors) || !(Layout->TotalFATs) || !(Layout->SectorsPerFAT))
+	{
+		printf("  Boot sector: invalid reserved sector, FAT count or FAT size\n");
+		Errors++;
+	}
+
+	if (!(Layout->RootEntries) || ((Layout->RootEntries * 32) % FATCHECK_SECTOR_SIZE))
+	{
+		printf("  Boot sector: root directory of %u entries does not fill whole sectors\n", Layout->RootEntries);
+		Errors++;
+	}
+
+	if ((TotalSectors16 && TotalSectors32) || (!(TotalSectors16) && (TotalSectors32 < 0x10000)))
+	{
+		printf("  Boot sector: inconsistent 16-bit (%u) and 32-bit (%u) total sector counts\n",
+		       TotalSectors16, TotalSectors32);
+		Errors++;
+	}
+
+	if ((BootSector[21] < 0xF0) || (BootSector[38] != 0x29) || memcmp(&BootSector[54], "FAT16   ", 8))
+	{
+		printf("  Boot sector: invalid media descriptor, extended boot signature or filesystem type\n");
+		Errors++;
+	}
+
+	if (Errors)
+	  return Errors;
+
+	Layout->RootDirectorySector = (Layout->ReservedSectors + ((uint32_t)Layout->TotalFATs * Layout->SectorsPerFAT));
+	Layout->DataStartSector     = (Layout->RootDirectorySector + ((Layout->RootEntries * 32) / FATCHECK_SECTOR_SIZE));
+
+	if (Layout->DataStartSector >= Layout->TotalSectors)
+	{
+		printf("  Boot sector: volume of %u sectors has no data area\n", Layout->TotalSectors);
+		return (Errors + 1);
+	}
+
+	Layout->TotalClusters = ((Layout->TotalSectors - Layout->DataStartSector) / Layout->SectorsPerCluster);
+
+	/* Hosts determine the FAT type solely from the number of clusters */
+	if ((Layout->TotalClusters < 4085) || (Layout->TotalClusters > 65524))
+	{
+		printf("  Boot sector: %u clusters would be identified as FAT%s, not FAT16\n", Layout->TotalClusters,
+		       (Layout->TotalClusters < 4085) ? "12" : "32");
+		Errors++;
+	}
+
+	if (((Layout->TotalClusters + 2) * 2) > ((uint32_t)Layout->SectorsPerFAT * FATCHECK_SECTOR_SIZE))
+	{
+		printf("  Boot sector: FAT of %u sectors is too small for %u clusters\n", Layout->SectorsPerFAT,
+		       Layout->TotalClusters);
+		Errors++;
+	}
+
+	return Errors;
+}
+
+/** Checks the File Allocation Tables and root directory of a FAT16 volume, and extracts the contents of its files. The
+ *  volume image must contain at least the volume's reserved sectors, FATs, root directory and every cluster of its files.
+ *
+ *  \param[in]  Image       Pointer to the image of the volume, starting at the boot sector
+ *  \param[in]  Layout      Pointer to the volume's layout, from \ref FATCheck_ReadLayout()
+ *  \param[out] Files       Pointer to an array of \ref FATCHECK_MAX_FILES entries where the extracted files are to be stored
+ *  \param[out] TotalFiles  Pointer to the location where the number of extracted files is to be stored
+ *
+ *  \return Number of errors found in the volume
+ */
+uint32_t FATCheck_CheckVolume(const uint8_t* Image, const FATCheck_Layout_t* const Layout,
+                              FATCheck_File_t* const Files, uint8_t* const TotalFiles)
+{
+	const uint8_t* FAT        = &Image[(uint32_t)Layout->ReservedSectors * FATCHECK_SECTOR_SIZE];
+	uint32_t       FATBytes   = ((uint32_t)Layout->SectorsPerFAT * FATCHECK_SECTOR_SIZE);
+	uint32_t       Clusters   = (Layout->TotalClusters + 2);
+	uint32_t       ClusterSize = ((uint32_t)Layout->SectorsPerCluster * FATCHECK_SECTOR_SIZE);
+	uint8_t*       Owners     = calloc(Clusters, 1);
+	uint32_t       Errors     = 0;
+	bool           HasLabel   = false;
+
+	*TotalFiles = 0;
+
+	for (uint8_t FATIndex = 1; FATIndex < Layout->TotalFATs; FATIndex++)
+	{
+		if (memcmp(FAT, &FAT[FATIndex * FATBytes], FATBytes))
+		{
+			printf("  FAT: copy %u differs from the first copy\n", FATIndex + 1);
+			Errors++;
+		}
+	}
+
+	if ((ReadLE16(&FAT[0]) != (0xFF00 | Image[21])) || ((ReadLE16(&FAT[2]) & 0x3FFF) != 0x3FFF))
+	{
+		printf("  FAT: invalid reserved entries 0x%04X, 0x%04X\n", ReadLE16(&FAT[0]), ReadLE16(&FAT[2]));
+		Errors++;
+	}
+
+	const uint8_t* RootDirectory = &Image[Layout->RootDirectorySector * FATCHECK_SECTOR_SIZE];
+
+	for (uint16_t EntryIndex = 0; EntryIndex < Layout->RootEntries; EntryIndex++)
+	{
+		const uint8_t* Entry      = &RootDirectory[EntryIndex * 32];
+		uint8_t        Attributes = Entry[11];
+
+		/* An entry starting with a null byte marks the end of the directory */
+		if (!(Entry[0]))
+		  break;
+
+		if (Entry[0] == 0xE5)
+		  continue;
+
+		if ((Attributes & 0x0F) == 0x0F)
+		{
+			printf("  Root directory: unexpected long file name entry %u\n", EntryIndex);
+			Errors++;
+			continue;
+		}
+
+		if (Attributes & (1 << 3))
+		{
+			if (HasLabel)
+			{
+				printf("  Root directory: more than one volume label entry\n");
+				Errors++;
+			}
+
+			HasLabel = true;
+			continue;
+		}
+
+		FATCheck_File_t* File = &Files[*TotalFiles];
+
+		memcpy(File->Name, Entry, 11);
+		File->Name[11]     = '\0';
+		File->StartCluster = ReadLE16(&Entry[26]);
+		File->SizeBytes    = ReadLE32(&Entry[28]);
+		File->Data         = NULL;
+
+		for (uint8_t CharIndex = 0; CharIndex < 11; CharIndex++)
+		{
+			char NameChar = File->Name[CharIndex];
+
+			if ((NameChar < ' ') || strchr("\"*+,./:;<=>?[\\]|", NameChar) || ((NameChar >= 'a') && (NameChar <= 'z')))
+			{
+				printf("  Root directory: invalid character in file name \"%s\"\n", File->Name);
+				Errors++;
+				break;
+			}
+		}
+
+		if (Attributes & (1 << 4))
+		{
+			printf("  Root directory: unexpected subdirectory \"%s\"\n", File->Name);
+			Errors++;
+			continue;
+		}
+
+		if (*TotalFiles == FATCHECK_MAX_FILES)
+		{
+			printf("  Root directory: too many files to check\n");
+			Errors++;
+			break;
+		}
+
+		uint32_t ExpectedClusters = ((File->SizeBytes + ClusterSize - 1) / ClusterSize);
+		uint32_t ChainClusters    = 0;
+		uint16_t Cluster          = File->StartCluster;
+
+		if (!(ExpectedClusters) != !(File->StartCluster))
+		{
+			printf("  %s: start cluster %u does not match file size %u\n", File->Name, File->StartCluster,
+			       File->SizeBytes);
+			Errors++;
+			continue;
+		}
+
+		if (ExpectedClusters)
+		  File->Data = malloc(ExpectedClusters * ClusterSize);
+
+		/* Follow the file's cluster chain until its end of chain marker, which a free cluster must not precede */
+		while (ExpectedClusters && (Cluster < 0xFFF8))
+		{
+			if ((Cluster < 2) || (Cluster >= Clusters))
+			{
+				printf("  %s: cluster chain %s at cluster 0x%04X\n", File->Name,
+				       ((Cluster < 2) ? "ends without an end of chain marker" : "leaves the volume"), Cluster);
+				Errors++;
+				break;
+			}
+
+			if (Owners[Cluster])
+			{
+				printf("  %s: cluster %u is cross-linked with another file\n", File->Name, Cluster);
+				Errors++;
+				break;
+			}
+
+			if (ChainClusters == ExpectedClusters)
+			{
+				printf("  %s: cluster chain is longer than the file size %u\n", File->Name, File->SizeBytes);
+				Errors++;
+				break;
+			}
+
+			Owners[Cluster] = 1;
+
+			memcpy(&File->Data[ChainClusters++ * ClusterSize],
+			       &Image[(Layout->DataStartSector + ((uint32_t)(Cluster - 2) * Layout->SectorsPerCluster)) *
+			              FATCHECK_SECTOR_SIZE], ClusterSize);
+
+			Cluster = ReadLE16(&FAT[Cluster * 2]);
+		}
+
+		if (ChainClusters < ExpectedClusters)
+		{
+			printf("  %s: cluster chain of %u clusters is shorter than the file size %u\n", File->Name, ChainClusters,
+			       File->SizeBytes);
+			Errors++;
+		}
+
+		(*TotalFiles)++;
+	}
+
+	/* Every allocated cluster must belong to a file, otherwise it is lost */
+	uint32_t LostClusters = 0;
+
+	for (uint32_t Cluster = 2; Cluster < Clusters; Cluster++)
+	{
+		if (ReadLE16(&FAT[Cluster * 2]) && !(Owners[Cluster]))
+		  LostClusters++;
+	}
+
+	if (LostClusters)
+	{
+		printf("  FAT: %u lost clusters\n", LostClusters);
+		Errors++;
+	}
+
+	free(Owners);
+	return Errors;
+}
+
+/** Frees the contents of the files extracted by \ref FATCheck_CheckVolume().
+ *
+ *  \param[in] Files       Pointer to the array of extracted files
+ *  \param[in] TotalFiles  Number of extracted files
+ */
+void FATCheck_FreeFiles(FATCheck_File_t* const Files, const uint8_t TotalFiles)
+{
+	for (uint8_t FileIndex = 0; FileIndex < TotalFiles; FileIndex++)
+	{
+		free(Files[FileIndex].Data);
+		Files[FileIndex].Data = NULL;
+	}
+}
@@ -0,0 +1,80 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for FATCheck.c.
+ */
+
+#ifndef _FAT_CHECK_H_
+#define _FAT_CHECK_H_
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+
+	/* Macros: */
+		/** Size of each sector of a checked volume, in bytes. */
+		#define FATCHECK_SECTOR_SIZE     512
+
+		/** Maximum number of files which are extracted from the root directory of a checked volume. */
+		#define FATCHECK_MAX_FILES       32
+
+	/* Type Defines: */
+		/** Type define for the layout of a FAT16 volume, as described by its boot sector. */
+		typedef struct
+		{
+			uint32_t TotalSectors; /**< Total number of sectors in the volume */
+			uint8_t  SectorsPerCluster; /**< Number of sectors in each data cluster */
+			uint16_t ReservedSectors; /**< Number of reserved sectors, including the boot sector, before the first FAT */
+			uint8_t  TotalFATs; /**< Number of copies of the File Allocation Table */
+			uint16_t SectorsPerFAT; /**< Number of sectors in each copy of the File Allocation Table */
+			uint16_t RootEntries; /**< Number of entries in the root directory */
+			uint32_t RootDirectorySector; /**< First sector of the root directory */
+			uint32_t DataStartSector; /**< First sector of the data area, holding cluster 2 */
+			uint32_t TotalClusters; /**< Number of data clusters in the volume */
+		} FATCheck_Layout_t;
+
+		/** Type define for a file extracted from the root directory of a checked volume. */
+		typedef struct
+		{
+			char     Name[12]; /**< Space padded FAT short name of the file, null terminated */
+			uint32_t SizeBytes; /**< Size of the file in bytes, from its directory entry */
+			uint16_t StartCluster; /**< First cluster of the file, or zero for an empty file */
+			uint8_t* Data; /**< Contents of the file, of \c SizeBytes bytes, or NULL for an empty file */
+		} FATCheck_File_t;
+
+	/* Function Prototypes: */
+		uint32_t FATCheck_ReadLayout(const uint8_t* BootSector, FATCheck_Layout_t* const Layout);
+		uint32_t FATCheck_CheckVolume(const uint8_t* Image, const FATCheck_Layout_t* const Layout,
+		                              FATCheck_File_t* const Files, uint8_t* const TotalFiles);
+		void     FATCheck_FreeFiles(FATCheck_File_t* const Files, const uint8_t TotalFiles);
+
+#endif
@@ -0,0 +1,88 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Shim header force-included (via the compiler's -include switch) when building the project's SCSI command handler and
+ *  virtual FAT volume for the host machine. The AVR specific USB core headers and the project's main and descriptor headers
+ *  are suppressed, and the endpoint interface the command handlers use is declared here instead, implemented by the host
+ *  test. The library's Mass Storage class driver and block device headers are used unmodified.
+ */
+
+#ifndef _VIRTUALFAT_SHIM_H_
+#define _VIRTUALFAT_SHIM_H_
+
+	/* Macros: */
+		#define __USB_H__
+		#define _TEMP_DATALOGGER_H_
+		#define _DESCRIPTORS_H_
+		#define USB_CAN_BE_DEVICE
+		#define VIRTUAL_FAT_LOG
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+		#include <stdio.h>
+
+		#include <LUFA/Common/Common.h>
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#define NO_STREAM_CALLBACK      NULL
+
+			#define ENDPOINT_BANK_SIZE      64
+
+		/* Enums: */
+			enum Endpoint_WaitUntilReady_ErrorCodes_t
+			{
+				ENDPOINT_READYWAIT_NoError                 = 0,
+				ENDPOINT_READYWAIT_EndpointStalled         = 1,
+				ENDPOINT_READYWAIT_DeviceDisconnected      = 2,
+				ENDPOINT_READYWAIT_Timeout                 = 3,
+			};
+
+			enum Endpoint_Stream_RW_ErrorCodes_t
+			{
+				ENDPOINT_RWSTREAM_NoError                  = 0,
+				ENDPOINT_RWSTREAM_EndpointStalled          = 1,
+				ENDPOINT_RWSTREAM_DeviceDisconnected       = 2,
+				ENDPOINT_RWSTREAM_Timeout                  = 3,
+				ENDPOINT_RWSTREAM_CallbackAborted          = 4,
+			};
+
+		/* Function Prototypes: */
+			uint8_t Endpoint_WaitUntilReady(void);
+			bool    Endpoint_IsReadWriteAllowed(void);
+			void    Endpoint_ClearIN(void);
+			void    Endpoint_Write_Byte(const uint8_t Byte);
+			uint8_t Endpoint_Write_Stream_LE(const void* Buffer, uint16_t Length, void* Callback);
+			uint8_t Endpoint_Write_Stream_BE(const void* Buffer, uint16_t Length, void* Callback);
+
+#endif
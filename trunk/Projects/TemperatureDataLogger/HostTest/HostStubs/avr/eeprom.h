@@ -0,0 +1,12 @@
+/* Stand-in for the AVR EEPROM header. EEMEM variables are placed in host memory, and accessed through the functions
+   implemented by the host test, which record each EEPROM write so that power loss can be simulated. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define EEMEM
+
+uint8_t eeprom_read_byte(const uint8_t* Address);
+void    eeprom_write_byte(uint8_t* Address, uint8_t Value);
+void    eeprom_read_block(void* Destination, const void* Source, size_t Length);
+void    eeprom_write_block(const void* Source, void* Destination, size_t Length);
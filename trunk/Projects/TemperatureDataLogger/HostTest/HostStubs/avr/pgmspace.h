@@ -0,0 +1,3 @@
+/* Stand-in for the AVR program space header, program space data is placed in host memory. */
+
+#define PROGMEM
@@ -0,0 +1,5 @@
+/* Stand-in for the AVR atomic block header. The host test is single threaded, with the sampling interrupt simulated by
+   direct calls from the test, so atomic blocks run their contents exactly once with no other effect. */
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_BLOCK(type)       for (int AtomicOnce = 1; AtomicOnce; AtomicOnce = 0)
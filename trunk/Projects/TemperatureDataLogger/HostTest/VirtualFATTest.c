@@ -0,0 +1,836 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host test for the VIRTUAL_FAT_LOG mode of the temperature data logger. The project's SCSI command handler and virtual
+ *  FAT volume are built for the host, against a simulated storage medium, EEPROM and bulk IN endpoint. The test logs lines
+ *  of temperature data over a series of simulated power-on sessions in the same way as the logger itself, opening a new
+ *  file for each simulated day. After each session the volume is read back through SCSI READ (10) commands of random
+ *  lengths, exactly as a host would, and is checked by a FAT16 filesystem checker (see FATCheck.c). The files found must
+ *  match the logged data.
+ *
+ *  Power is removed at a random point during some sessions, after which every storage medium and EEPROM write (down to the
+ *  individual EEPROM bytes) is discarded. Once power is restored, the volume must still pass the check, and each file must
+ *  hold at least the data of every append which had completed before the power loss. Power loss is also swept over every
+ *  write in turn while a file grows past sizes at which the update of its size in EEPROM spans several bytes.
+ *
+ *  The test is repeated for a small storage medium, which the volume pads to the minimum FAT16 size; a medium of a typical
+ *  board dataflash's size; and a medium larger than a FAT16 volume can map. Build and run with "make test" in this directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../Lib/SCSI.h"
+#include "../Lib/VirtualFAT.h"
+#include "FATCheck.h"
+
+/** Number of simulated power-on sessions of each test. */
+#define TOTAL_SESSIONS           60
+
+/** One in this many sessions starts on a new simulated day, creating a new log file. */
+#define NEW_DAY_INTERVAL         6
+
+/** Largest number of lines logged during each session. */
+#define MAX_SESSION_LINES        400
+
+/** Largest number of blocks read by each SCSI READ (10) command of the volume read back. */
+#define MAX_READ_BLOCKS          128
+
+/** Number of blocks in the storage medium of the power loss sweeps. */
+#define SWEEP_MEDIUM_BLOCKS      1024
+
+/** Number of bytes logged before the swept file size, from which power loss is swept. */
+#define SWEEP_LEAD_BYTES         512
+
+/** Number of consecutive storage medium and EEPROM writes at which power is removed in each sweep. */
+#define SWEEP_WRITES             160
+
+/** Type define for a test configuration. */
+typedef struct
+{
+	const char* Name; /**< Name of the test */
+	uint32_t    MediumBlocks; /**< Number of blocks in the simulated storage medium */
+} TestConfig_t;
+
+/** Type define for the expected state of a logged file. */
+typedef struct
+{
+	char     Name[VIRTUAL_FAT_NAME_LENGTH + 1]; /**< Space padded FAT short name of the file, null terminated */
+	uint8_t* Data; /**< Data logged to the file */
+	uint32_t Length; /**< Number of bytes logged to the file, including those of appends which may have been lost */
+	uint32_t DurableLength; /**< Number of bytes logged to the file which must have been stored */
+} ExpectedFile_t;
+
+/** Test configurations, each run from an erased EEPROM and storage medium. */
+static const TestConfig_t TestConfigs[] =
+	{
+		{"Small medium",  256},
+		{"Dataflash",     32768},
+		{"Large medium",  80000},
+	};
+
+/** File table and file count of the virtual FAT volume, stored in the simulated EEPROM. */
+extern VirtualFAT_FileEntry_t FileTable_EEPROM[VIRTUAL_FAT_MAX_FILES];
+extern uint8_t                TotalFiles_EEPROM;
+
+/** Sense data of the last SCSI command issued to the command handler. */
+extern SCSI_Request_Sense_Response_t SenseData;
+
+/** Contents of the simulated storage medium. */
+static uint8_t* Medium;
+
+/** Number of blocks in the simulated storage medium. */
+static uint32_t MediumBlocks;
+
+/** Number of storage medium block writes and EEPROM byte writes remaining before power is removed, or negative if power
+ *  is not to be removed during the current session.
+ */
+static int32_t WritesUntilPowerLoss = -1;
+
+/** Indicates if power has been removed, discarding all further storage medium and EEPROM writes. */
+static bool PowerLost;
+
+/** Buffer receiving the data sent by the device through the simulated bulk IN endpoint. */
+static uint8_t* HostBuffer;
+
+/** Number of bytes sent through the simulated bulk IN endpoint during the current command. */
+static uint32_t HostBytes;
+
+/** Number of bytes in the simulated endpoint's current bank. */
+static uint8_t BankBytes;
+
+/** Number of endpoint protocol errors, such as writes to a full endpoint bank. */
+static uint32_t EndpointErrors;
+
+/** Expected state of each logged file. */
+static ExpectedFile_t ExpectedFiles[VIRTUAL_FAT_MAX_FILES];
+
+/** Number of files expected in the volume. */
+static uint8_t TotalExpectedFiles;
+
+/** Image of the virtual FAT volume, as read back by the host. */
+static uint8_t* VolumeImage;
+
+/** Mass Storage class interface, holding the command block of each SCSI command issued to the command handler. */
+static USB_ClassInfo_MS_Device_t MSInterfaceInfo;
+
+
+/** Determines if the next storage medium or EEPROM write may proceed, removing power once the configured number of writes
+ *  has been performed.
+ *
+ *  \return Boolean true if the write is performed, false if it is lost
+ */
+static bool AllowWrite(void)
+{
+	if (!(WritesUntilPowerLoss))
+	  PowerLost = true;
+
+	if (WritesUntilPowerLoss > 0)
+	  WritesUntilPowerLoss--;
+
+	return !(PowerLost);
+}
+
+uint8_t eeprom_read_byte(const uint8_t* Address)
+{
+	return *Address;
+}
+
+void eeprom_write_byte(uint8_t* Address, uint8_t Value)
+{
+	if (AllowWrite())
+	  *Address = Value;
+}
+
+void eeprom_read_block(void* Destination, const void* Source, size_t Length)
+{
+	memcpy(Destination, Source, Length);
+}
+
+void eeprom_write_block(const void* Source, void* Destination, size_t Length)
+{
+	/* The AVR's EEPROM is written one byte at a time, so a block write may be interrupted part way through */
+	for (size_t ByteNum = 0; ByteNum < Length; ByteNum++)
+	  eeprom_write_byte(&((uint8_t*)Destination)[ByteNum], ((const uint8_t*)Source)[ByteNum]);
+}
+
+uint8_t Endpoint_WaitUntilReady(void)
+{
+	return ENDPOINT_READYWAIT_NoError;
+}
+
+bool Endpoint_IsReadWriteAllowed(void)
+{
+	return (BankBytes < ENDPOINT_BANK_SIZE);
+}
+
+void Endpoint_ClearIN(void)
+{
+	BankBytes = 0;
+}
+
+void Endpoint_Write_Byte(const uint8_t Byte)
+{
+	if (BankBytes == ENDPOINT_BANK_SIZE)
+	  EndpointErrors++;
+
+	HostBuffer[HostBytes++] = Byte;
+	BankBytes++;
+}
+
+uint8_t Endpoint_Write_Stream_LE(const void* Buffer, uint16_t Length, void* Callback)
+{
+	const uint8_t* DataPtr = (const uint8_t*)Buffer;
+
+	while (Length--)
+	{
+		/* The library's stream functions send each bank to the host as soon as it is filled */
+		if (!(Endpoint_IsReadWriteAllowed()))
+		  Endpoint_ClearIN();
+
+		Endpoint_Write_Byte(*(DataPtr++));
+	}
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t Endpoint_Write_Stream_BE(const void* Buffer, uint16_t Length, void* Callback)
+{
+	const uint8_t* DataPtr = (const uint8_t*)Buffer;
+
+	while (Length--)
+	{
+		if (!(Endpoint_IsReadWriteAllowed()))
+		  Endpoint_ClearIN();
+
+		Endpoint_Write_Byte(DataPtr[Length]);
+	}
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t BlockDevice_Init(void)
+{
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint32_t BlockDevice_GetTotalBlocks(void)
+{
+	return MediumBlocks;
+}
+
+bool BlockDevice_CheckOperation(void)
+{
+	return true;
+}
+
+uint8_t BlockDevice_ReadBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, uint8_t* BufferPtr)
+{
+	if ((BlockAddress + TotalBlocks) > MediumBlocks)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	memcpy(BufferPtr, &Medium[BlockAddress * BLOCKDEV_BLOCK_SIZE], ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE));
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_WriteBlocks(const uint32_t BlockAddress, uint16_t TotalBlocks, const uint8_t* BufferPtr)
+{
+	if ((BlockAddress + TotalBlocks) > MediumBlocks)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	for (uint16_t Block = 0; Block < TotalBlocks; Block++)
+	{
+		if (AllowWrite())
+		{
+			memcpy(&Medium[(BlockAddress + Block) * BLOCKDEV_BLOCK_SIZE], &BufferPtr[Block * BLOCKDEV_BLOCK_SIZE],
+			       BLOCKDEV_BLOCK_SIZE);
+		}
+	}
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+uint8_t BlockDevice_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                        const volatile bool* const AbortFlag)
+{
+	if ((BlockAddress + TotalBlocks) > MediumBlocks)
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	/* Send the blocks a byte at a time as the library's backends do, clearing each bank once it is full */
+	for (uint32_t ByteNum = 0; ByteNum < ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE); ByteNum++)
+	{
+		if (!(Endpoint_IsReadWriteAllowed()))
+		  Endpoint_ClearIN();
+
+		Endpoint_Write_Byte(Medium[(BlockAddress * BLOCKDEV_BLOCK_SIZE) + ByteNum]);
+	}
+
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+/** Issues a SCSI command to the project's command handler, in the same way as the library's Mass Storage class driver.
+ *
+ *  \param[in] Command           Pointer to the SCSI command descriptor block
+ *  \param[in] CommandLength     Length of the command descriptor block in bytes
+ *  \param[in] TransferLength    Number of bytes the host expects to receive in the data phase
+ *  \param[in] ExpectedSenseKey  Sense key the command is expected to complete with
+ *
+ *  \return Boolean true if the command completed with the expected sense key and transferred the number of bytes it
+ *          reported, false otherwise
+ */
+static bool IssueCommand(const uint8_t* Command, const uint8_t CommandLength, const uint32_t TransferLength,
+                         const uint8_t ExpectedSenseKey)
+{
+	memset(&MSInterfaceInfo.State.CommandBlock, 0x00, sizeof(MSInterfaceInfo.State.CommandBlock));
+	memcpy(MSInterfaceInfo.State.CommandBlock.SCSICommandData, Command, CommandLength);
+
+	MSInterfaceInfo.State.CommandBlock.DataTransferLength = TransferLength;
+	MSInterfaceInfo.State.CommandBlock.SCSICommandLength  = CommandLength;
+	MSInterfaceInfo.State.IsMassStoreReset                = false;
+
+	HostBytes = 0;
+	BankBytes = 0;
+
+	bool CommandPassed = SCSI_DecodeSCSICommand(&MSInterfaceInfo);
+
+	if (SenseData.SenseKey != ExpectedSenseKey)
+	{
+		printf("  SCSI command 0x%02X completed with sense key 0x%X, expected 0x%X\n", Command[0], SenseData.SenseKey,
+		       ExpectedSenseKey);
+		return false;
+	}
+
+	/* The residue reported in the command status must account for exactly the bytes sent */
+	if (CommandPassed && (HostBytes != (TransferLength - MSInterfaceInfo.State.CommandBlock.DataTransferLength)))
+	{
+		printf("  SCSI command 0x%02X sent %u bytes but reported %u\n", Command[0], HostBytes,
+		       (TransferLength - MSInterfaceInfo.State.CommandBlock.DataTransferLength));
+		return false;
+	}
+
+	return true;
+}
+
+/** Issues a SCSI READ (10) command for the given blocks of the volume, storing them into the volume image.
+ *
+ *  \param[in] BlockAddress  Address of the first block to read
+ *  \param[in] TotalBlocks   Number of blocks to read
+ *
+ *  \return Boolean true if the blocks were read, false otherwise
+ */
+static bool ReadVolumeBlocks(const uint32_t BlockAddress, const uint16_t TotalBlocks)
+{
+	uint8_t Command[10] = {SCSI_CMD_READ_10, 0, (BlockAddress >> 24), (BlockAddress >> 16), (BlockAddress >> 8),
+	                       BlockAddress, 0, (TotalBlocks >> 8), TotalBlocks, 0};
+
+	if (!(IssueCommand(Command, sizeof(Command), ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE), SCSI_SENSE_KEY_GOOD)))
+	  return false;
+
+	memcpy(&VolumeImage[BlockAddress * BLOCKDEV_BLOCK_SIZE], HostBuffer, HostBytes);
+	return true;
+}
+
+/** Checks the responses of the SCSI commands a host issues when the volume is attached, and that the volume cannot be
+ *  written to.
+ *
+ *  \param[out] TotalBlocks  Pointer to the location where the volume's capacity from READ CAPACITY (10) is to be stored
+ *
+ *  \return Number of errors found in the command responses
+ */
+static uint32_t CheckAttachCommands(uint32_t* const TotalBlocks)
+{
+	uint8_t  Inquiry[6]      = {SCSI_CMD_INQUIRY, 0, 0, 0, 36, 0};
+	uint8_t  ReadCapacity[10] = {SCSI_CMD_READ_CAPACITY_10};
+	uint8_t  ModeSense[6]    = {SCSI_CMD_MODE_SENSE_6, 0, 0x3F, 0, 192, 0};
+	uint8_t  Write[10]       = {SCSI_CMD_WRITE_10, 0, 0, 0, 0, 0, 0, 0, 1, 0};
+	uint8_t  TestUnitReady[6] = {SCSI_CMD_TEST_UNIT_READY};
+	uint32_t Errors          = 0;
+
+	if (!(IssueCommand(Inquiry, sizeof(Inquiry), 36, SCSI_SENSE_KEY_GOOD)) || (HostBytes != 36) || (HostBuffer[0] != 0))
+	  Errors++;
+
+	if (!(IssueCommand(TestUnitReady, sizeof(TestUnitReady), 0, SCSI_SENSE_KEY_GOOD)))
+	  Errors++;
+
+	if (!(IssueCommand(ReadCapacity, sizeof(ReadCapacity), 8, SCSI_SENSE_KEY_GOOD)) || (HostBytes != 8))
+	{
+		Errors++;
+	}
+	else
+	{
+		uint32_t LastBlock = (((uint32_t)HostBuffer[0] << 24) | ((uint32_t)HostBuffer[1] << 16) |
+		                      ((uint32_t)HostBuffer[2] << 8) | HostBuffer[3]);
+		uint32_t BlockSize = (((uint32_t)HostBuffer[4] << 24) | ((uint32_t)HostBuffer[5] << 16) |
+		                      ((uint32_t)HostBuffer[6] << 8) | HostBuffer[7]);
+
+		*TotalBlocks = (LastBlock + 1);
+
+		if (BlockSize != BLOCKDEV_BLOCK_SIZE)
+		{
+			printf("  READ CAPACITY (10) reported a block size of %u bytes\n", BlockSize);
+			Errors++;
+		}
+	}
+
+	/* The volume must be reported as write protected, and writes rejected */
+	if (!(IssueCommand(ModeSense, sizeof(ModeSense), 192, SCSI_SENSE_KEY_GOOD)) || (HostBytes < 4) ||
+	    !(HostBuffer[2] & (1 << 7)))
+	{
+		printf("  MODE SENSE (6) did not report the volume as write protected\n");
+		Errors++;
+	}
+
+	if (!(IssueCommand(Write, sizeof(Write), BLOCKDEV_BLOCK_SIZE, SCSI_SENSE_KEY_DATA_PROTECT)) ||
+	    (SenseData.AdditionalSenseCode != SCSI_ASENSE_WRITE_PROTECTED))
+	{
+		Errors++;
+	}
+
+	/* Reads past the end of the volume must be rejected */
+	uint8_t ReadPastEnd[10] = {SCSI_CMD_READ_10, 0, (*TotalBlocks >> 24), (*TotalBlocks >> 16), (*TotalBlocks >> 8),
+	                           *TotalBlocks, 0, 0, 1, 0};
+
+	if (!(IssueCommand(ReadPastEnd, sizeof(ReadPastEnd), BLOCKDEV_BLOCK_SIZE, SCSI_SENSE_KEY_ILLEGAL_REQUEST)) ||
+	    (SenseData.AdditionalSenseCode != SCSI_ASENSE_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE))
+	{
+		Errors++;
+	}
+
+	return Errors;
+}
+
+/** Reads back the volume through SCSI commands and checks it, comparing the files found against the logged data. Each
+ *  file must hold at least the data which must have been stored, with any further data matching the data which may have
+ *  been lost, and the expected files are then updated to the data actually found.
+ *
+ *  \param[in] ReadWholeVolume  Boolean true to read every block of the volume, false to only read the blocks up to the end
+ *                              of the last file
+ *
+ *  \return Number of errors found in the volume
+ */
+static uint32_t CheckVolume(const bool ReadWholeVolume)
+{
+	FATCheck_Layout_t Layout;
+	FATCheck_File_t   Files[FATCHECK_MAX_FILES];
+	uint8_t           TotalFiles;
+	uint32_t          TotalBlocks = 0;
+	uint32_t          Errors;
+
+	if ((Errors = CheckAttachCommands(&TotalBlocks)) != 0)
+	  return Errors;
+
+	if (!(ReadVolumeBlocks(0, 1)) || ((Errors = FATCheck_ReadLayout(VolumeImage, &Layout)) != 0))
+	  return (Errors + 1);
+
+	if (Layout.TotalSectors != TotalBlocks)
+	{
+		printf("  Boot sector reports %u sectors, READ CAPACITY (10) %u\n", Layout.TotalSectors, TotalBlocks);
+		return 1;
+	}
+
+	/* Read the filesystem structures and data in random length commands, as hosts do */
+	uint32_t ReadBlocks = TotalBlocks;
+
+	if (!(ReadWholeVolume))
+	{
+		uint32_t DataBlocks = 0;
+
+		for (uint8_t FileIndex = 0; FileIndex < TotalExpectedFiles; FileIndex++)
+		  DataBlocks += ((ExpectedFiles[FileIndex].Length + (BLOCKDEV_BLOCK_SIZE - 1)) / BLOCKDEV_BLOCK_SIZE);
+
+		if ((Layout.DataStartSector + DataBlocks + 1) < ReadBlocks)
+		  ReadBlocks = (Layout.DataStartSector + DataBlocks + 1);
+	}
+
+	for (uint32_t BlockAddress = 1; BlockAddress < ReadBlocks;)
+	{
+		uint16_t Blocks = (1 + (rand() % MAX_READ_BLOCKS));
+
+		if (Blocks > (ReadBlocks - BlockAddress))
+		  Blocks = (ReadBlocks - BlockAddress);
+
+		if (!(ReadVolumeBlocks(BlockAddress, Blocks)))
+		  return 1;
+
+		BlockAddress += Blocks;
+	}
+
+	memset(&VolumeImage[ReadBlocks * BLOCKDEV_BLOCK_SIZE], 0x00, ((TotalBlocks - ReadBlocks) * BLOCKDEV_BLOCK_SIZE));
+
+	Errors = FATCheck_CheckVolume(VolumeImage, &Layout, Files, &TotalFiles);
+
+	/* A file being created when power was lost may not be present, but no other file may be missing */
+	if ((TotalFiles != TotalExpectedFiles) &&
+	    !(PowerLost && (TotalFiles == (TotalExpectedFiles - 1)) && !(ExpectedFiles[TotalFiles].DurableLength)))
+	{
+		printf("  Volume holds %u files, expected %u\n", TotalFiles, TotalExpectedFiles);
+		Errors++;
+	}
+
+	for (uint8_t FileIndex = 0; (FileIndex < TotalFiles) && (FileIndex < TotalExpectedFiles); FileIndex++)
+	{
+		FATCheck_File_t* File     = &Files[FileIndex];
+		ExpectedFile_t*  Expected = &ExpectedFiles[FileIndex];
+
+		if (strcmp(File->Name, Expected->Name))
+		{
+			printf("  File %u is named \"%s\", expected \"%s\"\n", FileIndex, File->Name, Expected->Name);
+			Errors++;
+			continue;
+		}
+
+		/* Data of appends which may have been lost need not be present, but all data present must be correct */
+		bool IsLengthValid = ((File->SizeBytes >= Expected->DurableLength) && (File->SizeBytes <= Expected->Length));
+
+		if (!(IsLengthValid) || (File->SizeBytes && memcmp(File->Data, Expected->Data, File->SizeBytes)))
+		{
+			printf("  %s: holds %u bytes, expected %u (%u completed)%s\n", File->Name, File->SizeBytes,
+			       Expected->Length, Expected->DurableLength, (IsLengthValid ? " with different contents" : ""));
+			Errors++;
+		}
+
+		Expected->Length        = File->SizeBytes;
+		Expected->DurableLength = File->SizeBytes;
+	}
+
+	/* Discard a file whose creation was lost, so that it is logged afresh if it is created again */
+	while (TotalExpectedFiles > TotalFiles)
+	{
+		ExpectedFile_t* Expected = &ExpectedFiles[--TotalExpectedFiles];
+
+		free(Expected->Data);
+		memset(Expected, 0x00, sizeof(ExpectedFile_t));
+	}
+
+	FATCheck_FreeFiles(Files, TotalFiles);
+	return Errors;
+}
+
+/** Logs lines of temperature data to the current file for a single simulated session, in the same way as the logger.
+ *
+ *  \param[in] FileIndex  Index of the file being logged to
+ *  \param[in] Day        Simulated day of the session, for the logged lines
+ *  \param[in] Lines      Number of lines to log
+ */
+static void LogLines(const uint8_t FileIndex, const uint8_t Day, const uint16_t Lines)
+{
+	ExpectedFile_t* Expected = &ExpectedFiles[FileIndex];
+
+	for (uint16_t Line = 0; Line < Lines; Line++)
+	{
+		char     LineBuffer[100];
+		uint16_t BytesWritten = sprintf(LineBuffer, "%02d/%02d/20%04d, %02d:%02d:%02d, %d Degrees\r\n", Day, 10, 10,
+		                                (Line / 3600) % 24, (Line / 60) % 60, Line % 60, (rand() % 60) - 10);
+
+		bool WasPowered = !(PowerLost);
+
+		Expected->Data = realloc(Expected->Data, (Expected->Length + BytesWritten));
+		memcpy(&Expected->Data[Expected->Length], LineBuffer, BytesWritten);
+
+		Expected->Length += BytesWritten;
+
+		/* Once the medium is full appends fail part way through, after which the line need not have been stored */
+		if (!(VirtualFAT_AppendFile(LineBuffer, BytesWritten)))
+		  return;
+
+		if (WasPowered && !(PowerLost))
+		  Expected->DurableLength = Expected->Length;
+	}
+}
+
+/** Erases the simulated EEPROM and replaces the simulated storage medium with one of the given size, filled with the
+ *  logged data of a previous user (which, like all logged data, contains no 0xFF bytes).
+ *
+ *  \param[in] Blocks  Number of blocks in the new storage medium
+ */
+static void ResetMedium(const uint32_t Blocks)
+{
+	MediumBlocks = Blocks;
+	Medium       = realloc(Medium, (MediumBlocks * BLOCKDEV_BLOCK_SIZE));
+
+	memset(FileTable_EEPROM, 0xFF, sizeof(FileTable_EEPROM));
+	TotalFiles_EEPROM = 0xFF;
+
+	for (uint32_t ByteNum = 0; ByteNum < (MediumBlocks * BLOCKDEV_BLOCK_SIZE); ByteNum++)
+	  Medium[ByteNum] = ((ByteNum * 7) % 0xFF);
+
+	for (uint8_t FileIndex = 0; FileIndex < VIRTUAL_FAT_MAX_FILES; FileIndex++)
+	{
+		free(ExpectedFiles[FileIndex].Data);
+		memset(&ExpectedFiles[FileIndex], 0x00, sizeof(ExpectedFile_t));
+	}
+
+	TotalExpectedFiles = 0;
+}
+
+/** Restores power at the end of a session and restarts the logger, then checks the volume as the host would see it.
+ *
+ *  \param[in] ReadWholeVolume  Boolean true to read every block of the volume, false to only read the blocks up to the end
+ *                              of the last file
+ *
+ *  \return Number of errors found in the volume
+ */
+static uint32_t RestartAndCheck(const bool ReadWholeVolume)
+{
+	bool SessionPowerLost = PowerLost;
+
+	WritesUntilPowerLoss = -1;
+	PowerLost            = false;
+
+	VirtualFAT_Init();
+
+	PowerLost = SessionPowerLost;
+
+	uint32_t Errors = CheckVolume(ReadWholeVolume);
+
+	PowerLost = false;
+
+	return Errors;
+}
+
+/** Runs a test configuration, logging over a series of simulated sessions and checking the volume after each.
+ *
+ *  \param[in] Config  Test configuration to run
+ *
+ *  \return Number of errors found
+ */
+static uint32_t RunTest(const TestConfig_t* const Config)
+{
+	uint32_t Errors       = 0;
+	uint32_t PowerLosses  = 0;
+	uint32_t LinesLogged  = 0;
+	uint8_t  Day          = 1;
+
+	ResetMedium(Config->MediumBlocks);
+
+	for (uint16_t Session = 0; Session < TOTAL_SESSIONS; Session++)
+	{
+		char LogFileName[16];
+
+		/* Power is removed part way through every third session */
+		WritesUntilPowerLoss = ((Session % 3) == 2) ? (rand() % 200) : -1;
+		PowerLost            = false;
+
+		VirtualFAT_Init();
+
+		if (!(Session) || !(rand() % NEW_DAY_INTERVAL))
+		  Day++;
+
+		sprintf(LogFileName, "%02d%02d%02d  CSV", Day, 10, 10);
+
+		/* A new file can only be created while the file table has space and the storage medium has unused blocks */
+		bool     IsNewFile  = (!(TotalExpectedFiles) || strcmp(ExpectedFiles[TotalExpectedFiles - 1].Name, LogFileName));
+		uint32_t UsedBlocks = 0;
+
+		for (uint8_t FileIndex = 0; FileIndex < TotalExpectedFiles; FileIndex++)
+		  UsedBlocks += ((ExpectedFiles[FileIndex].Length + (BLOCKDEV_BLOCK_SIZE - 1)) / BLOCKDEV_BLOCK_SIZE);
+
+		bool CanOpen = (!(IsNewFile) || ((TotalExpectedFiles < VIRTUAL_FAT_MAX_FILES) && (UsedBlocks < MediumBlocks) &&
+		                                 (UsedBlocks < VIRTUAL_FAT_MAX_CLUSTERS)));
+
+		bool IsOpened = VirtualFAT_OpenFile(LogFileName, ((uint32_t)Day << 16));
+
+		if (IsOpened != CanOpen)
+		{
+			printf("  Session %u: opening %s %s, expected it to %s\n", Session, LogFileName,
+			       (IsOpened ? "succeeded" : "failed"), (CanOpen ? "succeed" : "fail"));
+			Errors++;
+		}
+
+		if (IsOpened)
+		{
+			if (IsNewFile)
+			  strcpy(ExpectedFiles[TotalExpectedFiles++].Name, LogFileName);
+
+			uint16_t Lines = (rand() % MAX_SESSION_LINES);
+
+			LogLines(TotalExpectedFiles - 1, Day, Lines);
+			LinesLogged += Lines;
+		}
+
+		VirtualFAT_CloseFile();
+
+		if (PowerLost)
+		  PowerLosses++;
+
+		bool     SessionPowerLost = PowerLost;
+		uint32_t SessionErrors    = RestartAndCheck(Session == (TOTAL_SESSIONS - 1));
+
+		if (SessionErrors)
+		{
+			printf("  Session %u (%s) failed with %u errors\n", Session, (SessionPowerLost ? "power lost" : "no power loss"),
+			       SessionErrors);
+		}
+
+		Errors += SessionErrors;
+	}
+
+	Errors += EndpointErrors;
+
+	uint32_t TotalBytes = 0;
+
+	for (uint8_t FileIndex = 0; FileIndex < TotalExpectedFiles; FileIndex++)
+	  TotalBytes += ExpectedFiles[FileIndex].Length;
+
+	printf("%-14s %8u %8u %6u %6u %8u %9u %6u\n", Config->Name, Config->MediumBlocks, VirtualFAT_GetTotalBlocks(),
+	       TOTAL_SESSIONS, PowerLosses, LinesLogged, TotalBytes, Errors);
+
+	return Errors;
+}
+
+/** Removes power at every storage medium and EEPROM write in turn while a file grows past each of the given sizes, from
+ *  the same starting state each time. Sizes at multiples of 64KB exercise the recovery of the last file's size when the
+ *  update of its size in EEPROM is interrupted part way through a carry between the size's bytes.
+ *
+ *  \param[in] FileSize  Size of the file at which power loss is swept, in bytes
+ *
+ *  \return Number of errors found
+ */
+static uint32_t RunPowerLossSweep(const uint32_t FileSize)
+{
+	VirtualFAT_FileEntry_t SavedFileTable[VIRTUAL_FAT_MAX_FILES];
+	uint8_t                SavedTotalFiles;
+	uint32_t               SavedLength;
+	uint8_t*               SavedData;
+	uint8_t*               SavedMedium;
+	uint32_t               Errors      = 0;
+	uint32_t               PowerLosses = 0;
+
+	ResetMedium(SWEEP_MEDIUM_BLOCKS);
+
+	/* Log a single file up to just before the swept size, and save the resulting state */
+	VirtualFAT_Init();
+	VirtualFAT_OpenFile("011010  CSV", (1UL << 16));
+	strcpy(ExpectedFiles[TotalExpectedFiles++].Name, "011010  CSV");
+
+	while (ExpectedFiles[0].Length < (FileSize - SWEEP_LEAD_BYTES))
+	  LogLines(0, 1, 1);
+
+	VirtualFAT_CloseFile();
+
+	SavedMedium     = malloc(MediumBlocks * BLOCKDEV_BLOCK_SIZE);
+	SavedTotalFiles = TotalFiles_EEPROM;
+	SavedLength     = ExpectedFiles[0].Length;
+	SavedData       = malloc(SavedLength);
+
+	memcpy(SavedMedium, Medium, (MediumBlocks * BLOCKDEV_BLOCK_SIZE));
+	memcpy(SavedFileTable, FileTable_EEPROM, sizeof(SavedFileTable));
+	memcpy(SavedData, ExpectedFiles[0].Data, SavedLength);
+
+	for (int32_t PowerLossWrite = 0; PowerLossWrite < SWEEP_WRITES; PowerLossWrite++)
+	{
+		memcpy(Medium, SavedMedium, (MediumBlocks * BLOCKDEV_BLOCK_SIZE));
+		memcpy(FileTable_EEPROM, SavedFileTable, sizeof(SavedFileTable));
+		TotalFiles_EEPROM = SavedTotalFiles;
+
+		ExpectedFiles[0].Data = realloc(ExpectedFiles[0].Data, SavedLength);
+		memcpy(ExpectedFiles[0].Data, SavedData, SavedLength);
+		ExpectedFiles[0].Length        = SavedLength;
+		ExpectedFiles[0].DurableLength = SavedLength;
+		TotalExpectedFiles             = 1;
+
+		WritesUntilPowerLoss = PowerLossWrite;
+		PowerLost            = false;
+
+		VirtualFAT_Init();
+		VirtualFAT_OpenFile("011010  CSV", (1UL << 16));
+
+		while (!(PowerLost))
+		  LogLines(0, 1, 1);
+
+		VirtualFAT_CloseFile();
+		PowerLosses++;
+
+		/* Check the volume after the power loss, and again once logging has resumed without further loss */
+		uint32_t SweepErrors = RestartAndCheck(false);
+
+		VirtualFAT_OpenFile("011010  CSV", (1UL << 16));
+		LogLines(0, 1, 40);
+		VirtualFAT_CloseFile();
+
+		SweepErrors += RestartAndCheck(false);
+
+		if (SweepErrors)
+		  printf("  Power lost at write %d past %u bytes: %u errors\n", PowerLossWrite, SavedLength, SweepErrors);
+
+		Errors += SweepErrors;
+	}
+
+	free(SavedMedium);
+	free(SavedData);
+
+	char SweepName[16];
+	sprintf(SweepName, "Sweep %uK", (FileSize / 1024));
+
+	printf("%-14s %8u %8u %6u %6u %8s %9u %6u\n", SweepName, SWEEP_MEDIUM_BLOCKS, VirtualFAT_GetTotalBlocks(),
+	       (SWEEP_WRITES * 3), PowerLosses, "-", ExpectedFiles[0].Length, Errors);
+
+	return Errors;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	srand(1);
+
+	HostBuffer  = malloc((uint32_t)MAX_READ_BLOCKS * BLOCKDEV_BLOCK_SIZE);
+	VolumeImage = malloc((uint32_t)(VIRTUAL_FAT_MAX_CLUSTERS + 1024) * BLOCKDEV_BLOCK_SIZE);
+
+	printf("Virtual FAT volume test, %u sessions per medium with power lost during every third session\n\n",
+	       TOTAL_SESSIONS);
+	printf("%-14s %8s %8s %6s %6s %8s %9s %6s\n", "Medium", "Blocks", "Volume", "Boots", "Losses", "Lines", "Bytes",
+	       "Errors");
+
+	for (uint8_t Index = 0; Index < (sizeof(TestConfigs) / sizeof(TestConfigs[0])); Index++)
+	  TotalErrors += RunTest(&TestConfigs[Index]);
+
+	TotalErrors += RunPowerLossSweep(4096);
+	TotalErrors += RunPowerLossSweep(65536);
+	TotalErrors += RunPowerLossSweep(131072);
+
+	printf("\nVolume is the size of the virtual FAT volume in blocks, Lines the number of lines logged and Bytes the\n");
+	printf("total size of the logged files found in the volume after the last session. The sweeps remove power at\n");
+	printf("each of %u consecutive writes as a file grows past the given size.\n", SWEEP_WRITES);
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %u errors\n", TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
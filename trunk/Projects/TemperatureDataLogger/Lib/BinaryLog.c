@@ -0,0 +1,289 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Binary sample log, which timestamps samples into a queue in SRAM from the sampling interrupt and writes them to the
+ *  open log file from the main program loop as complete sectors of compact binary records. Each sector starts with a
+ *  header giving the logging session's start date and time and sample rate, so that the time of each sample can be
+ *  recovered from its sample number, and so that each sector can be decoded on its own.
+ *
+ *  Logged samples are only committed to the filesystem (via f_sync()) once the oldest uncommitted sample is older than
+ *  \ref BINARY_LOG_SYNC_SECONDS, or when the log is closed, rather than on every sample. If a partially filled sector
+ *  must be committed, it is written out and then rewritten in place as further samples are added to it.
+ */
+ 
+#define  INCLUDE_FROM_BINARYLOG_C
+#include "BinaryLog.h"
+
+/** Log file that samples are written to, or NULL if no logging session is open. */
+static FIL* LogFile;
+
+/** Indicates if samples should currently be queued, set while a logging session is open. */
+static volatile bool SessionActive;
+
+/** Queue of timestamped samples waiting to be written to the log file. */
+static BinaryLog_Sample_t SampleQueue[BINARY_LOG_RING_SAMPLES];
+
+/** Index of the next sample queue entry to store a sample into, from the sampling interrupt. */
+static uint8_t SampleQueueIn;
+
+/** Index of the next sample queue entry to write to the log file, from the main program loop. */
+static uint8_t SampleQueueOut;
+
+/** Number of samples currently stored in the sample queue. */
+static volatile uint8_t SampleQueueCount;
+
+/** Number of the next sample to be taken within the logging session. */
+static volatile uint32_t NextSampleNumber;
+
+/** Number of the next sample to be written to the log file if no samples are lost due to the sample queue being full. */
+static uint32_t NextStoredSample;
+
+/** Sector of the log file currently being filled with sample records. */
+static uint8_t SectorBuffer[BLOCKDEV_BLOCK_SIZE];
+
+/** Indicates if any samples have been written to the log file since the file was last committed to the filesystem. */
+static bool UnsyncedSamples;
+
+/** Number of the oldest sample not yet committed to the filesystem, when \ref UnsyncedSamples is set. */
+static uint32_t FirstUnsyncedSample;
+
+
+/** Starts a new logging session, appending sectors of samples to the given log file. The session's start date and time
+ *  are taken from the RTC.
+ *
+ *  \param[in] NewLogFile  Log file opened for writing, to append the sample sectors to
+ */
+void BinaryLog_Open(FIL* const NewLogFile)
+{
+	BinaryLog_SectorHeader_t* Header = (BinaryLog_SectorHeader_t*)SectorBuffer;
+
+	LogFile = NewLogFile;
+
+	/* Start appending after the last whole sector in the file, so that every sector of the file holds a sector header */
+	f_lseek(LogFile, ((LogFile->fsize + (BLOCKDEV_BLOCK_SIZE - 1)) & ~(uint32_t)(BLOCKDEV_BLOCK_SIZE - 1)));
+
+	memset(SectorBuffer, 0x00, sizeof(SectorBuffer));
+	Header->Signature    = BINARY_LOG_SIGNATURE;
+	Header->SampleRateHz = BINARY_LOG_SAMPLE_RATE_HZ;
+
+	DS1307_GetDate(&Header->Day,  &Header->Month,  &Header->Year);
+	DS1307_GetTime(&Header->Hour, &Header->Minute, &Header->Second);
+
+	UnsyncedSamples  = false;
+	NextStoredSample = 0;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		SampleQueueIn    = 0;
+		SampleQueueOut   = 0;
+		SampleQueueCount = 0;
+		NextSampleNumber = 0;
+		SessionActive    = true;
+	}
+}
+
+/** Timestamps and queues a new sample for writing to the log file. This function is intended to be called from the
+ *  sampling interrupt, once every sample period; samples are discarded if no logging session is open.
+ *
+ *  \param[in] Temperature  Sampled temperature to log
+ */
+void BinaryLog_AddSample(const int8_t Temperature)
+{
+	if (!(SessionActive))
+	  return;
+
+	uint32_t SampleNumber = NextSampleNumber++;
+
+	/* If the main program loop has fallen too far behind drop the sample, the gap in the sample numbers records the loss */
+	if (SampleQueueCount == BINARY_LOG_RING_SAMPLES)
+	  return;
+
+	SampleQueue[SampleQueueIn].SampleNumber = SampleNumber;
+	SampleQueue[SampleQueueIn].Temperature  = Temperature;
+
+	if (++SampleQueueIn == BINARY_LOG_RING_SAMPLES)
+	  SampleQueueIn = 0;
+
+	SampleQueueCount++;
+}
+
+/** Writes queued samples to the log file, and commits the log file to the filesystem if the oldest uncommitted sample
+ *  has reached the end of its durability window. This function must be called repeatedly from the main program loop
+ *  while a logging session is open.
+ */
+void BinaryLog_Task(void)
+{
+	uint32_t CurrentSampleNumber;
+
+	if (LogFile == NULL)
+	  return;
+
+	while (SampleQueueCount)
+	{
+		BinaryLog_StoreSample(&SampleQueue[SampleQueueOut]);
+
+		if (++SampleQueueOut == BINARY_LOG_RING_SAMPLES)
+		  SampleQueueOut = 0;
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			SampleQueueCount--;
+		}
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		CurrentSampleNumber = NextSampleNumber;
+	}
+
+	if (UnsyncedSamples && ((CurrentSampleNumber - FirstUnsyncedSample) >=
+	                        ((uint32_t)BINARY_LOG_SYNC_SECONDS * BINARY_LOG_SAMPLE_RATE_HZ)))
+	{
+		BinaryLog_Sync();
+	}
+}
+
+/** Ends the current logging session, writing any queued samples to the log file and committing the log file to the
+ *  filesystem. The log file is left open.
+ */
+void BinaryLog_Close(void)
+{
+	if (LogFile == NULL)
+	  return;
+
+	SessionActive = false;
+
+	BinaryLog_Task();
+
+	/* Record any samples lost after the last queued sample, in an otherwise empty sector if the last sector was full */
+	BinaryLog_AddLostSamples(NextSampleNumber - NextStoredSample);
+	BinaryLog_Sync();
+
+	LogFile = NULL;
+}
+
+/** Determines if any samples are queued waiting to be written to the log file by \ref BinaryLog_Task().
+ *
+ *  \return Boolean true if one or more samples are queued, false otherwise
+ */
+bool BinaryLog_IsSampleQueued(void)
+{
+	return (SampleQueueCount != 0);
+}
+
+/** Adds a sample to the sector currently being filled, writing the sector to the log file once it is full.
+ *
+ *  \param[in] Sample  Queued sample to store
+ */
+static void BinaryLog_StoreSample(const BinaryLog_Sample_t* const Sample)
+{
+	BinaryLog_SectorHeader_t* Header  = (BinaryLog_SectorHeader_t*)SectorBuffer;
+	BinaryLog_Record_t*       Records = (BinaryLog_Record_t*)&SectorBuffer[sizeof(BinaryLog_SectorHeader_t)];
+
+	/* Start a new sector if the sample is too far from the sector's first sample to be stored as an offset from it */
+	if (Header->TotalRecords && ((Sample->SampleNumber - Header->FirstSample) > 0xFFFF))
+	  BinaryLog_WriteSector(true);
+
+	BinaryLog_AddLostSamples(Sample->SampleNumber - NextStoredSample);
+	NextStoredSample = (Sample->SampleNumber + 1);
+
+	if (!(Header->TotalRecords))
+	  Header->FirstSample = Sample->SampleNumber;
+
+	if (!(UnsyncedSamples))
+	{
+		FirstUnsyncedSample = Sample->SampleNumber;
+		UnsyncedSamples     = true;
+	}
+
+	Records[Header->TotalRecords].SampleOffset = (Sample->SampleNumber - Header->FirstSample);
+	Records[Header->TotalRecords].Temperature  = Sample->Temperature;
+
+	if (++Header->TotalRecords == BINARY_LOG_SECTOR_RECORDS)
+	  BinaryLog_WriteSector(true);
+}
+
+/** Writes the sector currently being filled to the log file.
+ *
+ *  \param[in] SectorComplete  If true, a new sector is started after the sector is written, otherwise the file position
+ *                             is returned to the start of the sector so that it is rewritten once more samples are added
+ */
+static void BinaryLog_WriteSector(const bool SectorComplete)
+{
+	BinaryLog_SectorHeader_t* Header = (BinaryLog_SectorHeader_t*)SectorBuffer;
+	UINT                      BytesWritten;
+
+	f_write(LogFile, SectorBuffer, sizeof(SectorBuffer), &BytesWritten);
+
+	if (SectorComplete)
+	{
+		/* Clear the sector's records, the header's session information is carried over to the next sector */
+		memset(&SectorBuffer[sizeof(BinaryLog_SectorHeader_t)], 0x00,
+		       (sizeof(SectorBuffer) - sizeof(BinaryLog_SectorHeader_t)));
+		Header->LostSamples  = 0;
+		Header->TotalRecords = 0;
+	}
+	else
+	{
+		f_lseek(LogFile, (LogFile->fptr - BytesWritten));
+	}
+}
+
+/** Adds a number of lost samples to the lost sample count of the sector currently being filled. A new sector is started
+ *  if the count would otherwise saturate, so that the count is only saturated by a single loss of over 65535 samples.
+ *
+ *  \param[in] Samples  Number of samples lost since the last sample stored in the log
+ */
+static void BinaryLog_AddLostSamples(const uint32_t Samples)
+{
+	BinaryLog_SectorHeader_t* Header = (BinaryLog_SectorHeader_t*)SectorBuffer;
+
+	if (Header->TotalRecords && (Samples > (uint32_t)(0xFFFF - Header->LostSamples)))
+	  BinaryLog_WriteSector(true);
+
+	if (Samples >= (uint32_t)(0xFFFF - Header->LostSamples))
+	  Header->LostSamples = 0xFFFF;
+	else
+	  Header->LostSamples += Samples;
+}
+
+/** Commits all samples stored so far to the filesystem, writing out the partially filled current sector if needed. */
+static void BinaryLog_Sync(void)
+{
+	BinaryLog_SectorHeader_t* Header = (BinaryLog_SectorHeader_t*)SectorBuffer;
+
+	if (Header->TotalRecords || Header->LostSamples)
+	  BinaryLog_WriteSector(false);
+
+	f_sync(LogFile);
+	UnsyncedSamples = false;
+}
@@ -0,0 +1,136 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for BinaryLog.c.
+ */
+ 
+#ifndef _BINARYLOG_H_
+#define _BINARYLOG_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <util/atomic.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
+
+		#include "DS1307.h"
+		#include "FATFs/ff.h"
+		
+	/* Macros: */
+		#if !defined(BINARY_LOG_SAMPLE_RATE_HZ) || defined(__DOXYGEN__)
+			/** Number of temperature samples taken and logged per second. */
+			#define BINARY_LOG_SAMPLE_RATE_HZ        2
+		#endif
+
+		#if !defined(BINARY_LOG_SYNC_SECONDS) || defined(__DOXYGEN__)
+			/** Maximum age in seconds of a logged sample before it is guaranteed to be stored on the storage medium, and
+			 *  thus the maximum amount of logged data which may be lost on a power failure. Longer windows reduce the
+			 *  number of filesystem updates made to the storage medium.
+			 */
+			#define BINARY_LOG_SYNC_SECONDS          10
+		#endif
+
+		#if !defined(BINARY_LOG_RING_SAMPLES) || defined(__DOXYGEN__)
+			#if (defined(__AVR_AT90USB1287__) || defined(__AVR_AT90USB647__) || \
+			     defined(__AVR_AT90USB1286__) || defined(__AVR_AT90USB646__)) || defined(__DOXYGEN__)
+				/** Number of timestamped samples which can be queued in SRAM while a log sector is being written. Each queued
+				 *  sample occupies 5 bytes of SRAM. Samples taken while the queue is full are lost, and counted in the
+				 *  header of the log sector holding the next logged sample.
+				 */
+				#define BINARY_LOG_RING_SAMPLES      128
+			#else
+				#define BINARY_LOG_RING_SAMPLES      32
+			#endif
+		#endif
+		
+		/** Signature at the start of each sector of a binary log file, the ASCII characters "TLOG" when read as bytes. */
+		#define BINARY_LOG_SIGNATURE                 0x474F4C54UL
+		
+		/** Number of samples which fit into a single sector of a binary log file after the sector header. */
+		#define BINARY_LOG_SECTOR_RECORDS            ((BLOCKDEV_BLOCK_SIZE - sizeof(BinaryLog_SectorHeader_t)) / \
+		                                              sizeof(BinaryLog_Record_t))
+
+	/* Preprocessor Checks: */
+		#if ((BINARY_LOG_RING_SAMPLES < 1) || (BINARY_LOG_RING_SAMPLES > 255))
+			#error BINARY_LOG_RING_SAMPLES must be between 1 and 255 samples.
+		#endif
+
+	/* Type Defines: */
+		/** Type define for the header at the start of each sector of a binary log file. All multiple byte values in the
+		 *  log file are stored in little endian byte order.
+		 */
+		typedef struct
+		{
+			uint32_t Signature; /**< Sector signature, set to \ref BINARY_LOG_SIGNATURE */
+			uint8_t  Day; /**< Day of the month on which the logging session started */
+			uint8_t  Month; /**< Month in which the logging session started */
+			uint8_t  Year; /**< Year in which the logging session started, as an offset from 2000 */
+			uint8_t  Hour; /**< Hour at which the logging session started */
+			uint8_t  Minute; /**< Minute at which the logging session started */
+			uint8_t  Second; /**< Second at which the logging session started */
+			uint16_t SampleRateHz; /**< Number of samples taken per second in the logging session */
+			uint32_t FirstSample; /**< Number of the sector's first sample within the logging session, counted from zero */
+			uint16_t LostSamples; /**< Number of samples lost since the previous sector, up to the sector's last record */
+			uint8_t  TotalRecords; /**< Number of valid records following the header in the sector */
+		} BinaryLog_SectorHeader_t;
+
+		/** Type define for a single logged sample within a sector of a binary log file. */
+		typedef struct
+		{
+			uint16_t SampleOffset; /**< Number of the sample relative to the FirstSample value of the sector header */
+			int8_t   Temperature; /**< Sampled temperature, in degrees */
+		} BinaryLog_Record_t;
+
+		/** Type define for a timestamped sample queued in SRAM for writing to the log file. */
+		typedef struct
+		{
+			uint32_t SampleNumber; /**< Number of the sample within the logging session */
+			int8_t   Temperature; /**< Sampled temperature, in degrees */
+		} BinaryLog_Sample_t;
+
+	/* Function Prototypes: */
+		void BinaryLog_Open(FIL* const LogFile);
+		void BinaryLog_AddSample(const int8_t Temperature);
+		void BinaryLog_Task(void);
+		void BinaryLog_Close(void);
+		bool BinaryLog_IsSampleQueued(void);
+		
+		#if defined(INCLUDE_FROM_BINARYLOG_C)
+			static void BinaryLog_StoreSample(const BinaryLog_Sample_t* const Sample);
+			static void BinaryLog_WriteSector(const bool SectorComplete);
+			static void BinaryLog_AddLostSamples(const uint32_t Samples);
+			static void BinaryLog_Sync(void);
+		#endif
+
+#endif
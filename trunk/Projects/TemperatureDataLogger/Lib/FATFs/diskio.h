@@ -9,7 +9,7 @@
 
 #include "integer.h"
 
-#include "../DataflashManager.h"
+#include <LUFA/Drivers/Misc/BlockDevice.h>
 
 
 /* Status of Disk Functions */
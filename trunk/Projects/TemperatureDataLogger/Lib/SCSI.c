@@ -114,6 +114,11 @@ bool SCSI_DecodeSCSICommand(USB_ClassInfo_MS_Device_t* MSInterfaceInfo)
 		case SCSI_CMD_READ_10:
 			SCSI_Command_ReadWrite_10(MSInterfaceInfo, DATA_READ);
 			break;
+		#if defined(VIRTUAL_FAT_LOG)
+		case SCSI_CMD_MODE_SENSE_6:
+			SCSI_Command_Mode_Sense_6(MSInterfaceInfo);
+			break;
+		#endif
 		case SCSI_CMD_TEST_UNIT_READY:
 		case SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL:
 		case SCSI_CMD_VERIFY_10:
@@ -196,8 +201,12 @@ static void SCSI_Command_Request_Sense(USB_ClassInfo_MS_Device_t* MSInterfaceInf
  */
 static void SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo)
 {
-	uint32_t LastBlockAddressInLUN = (VIRTUAL_MEMORY_BLOCKS - 1);
-	uint32_t MediaBlockSize        = VIRTUAL_MEMORY_BLOCK_SIZE;
+	#if defined(VIRTUAL_FAT_LOG)
+	uint32_t LastBlockAddressInLUN = (VirtualFAT_GetTotalBlocks() - 1);
+	#else
+	uint32_t LastBlockAddressInLUN = (BlockDevice_GetTotalBlocks() - 1);
+	#endif
+	uint32_t MediaBlockSize        = BLOCKDEV_BLOCK_SIZE;
 
 	Endpoint_Write_Stream_BE(&LastBlockAddressInLUN, sizeof(LastBlockAddressInLUN), NO_STREAM_CALLBACK);
 	Endpoint_Write_Stream_BE(&MediaBlockSize, sizeof(MediaBlockSize), NO_STREAM_CALLBACK);
@@ -207,8 +216,30 @@ static void SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* MSInterface
 	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= 8;
 }
 
-/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the Dataflash ICs on the
- *  board, and indicates if they are present and functioning correctly. Only the Self-Test portion of the diagnostic command is
+#if defined(VIRTUAL_FAT_LOG)
+/** Command processing for an issued SCSI MODE SENSE (6) command. This command returns an empty mode parameter list, with
+ *  the Write Protect bit set in the header so that the host mounts the synthesized virtual FAT volume as read-only.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
+ */
+static void SCSI_Command_Mode_Sense_6(USB_ClassInfo_MS_Device_t* MSInterfaceInfo)
+{
+	/* Mode data length, medium type, device specific parameter (WP bit set) and block descriptor length */
+	uint8_t ModeParameterHeader[4] = {3, 0x00, (1 << 7), 0};
+
+	uint8_t AllocationLength = MSInterfaceInfo->State.CommandBlock.SCSICommandData[4];
+	uint8_t BytesTransferred = (AllocationLength < sizeof(ModeParameterHeader)) ? AllocationLength : sizeof(ModeParameterHeader);
+
+	Endpoint_Write_Stream_LE(&ModeParameterHeader, BytesTransferred, NO_STREAM_CALLBACK);
+	Endpoint_ClearIN();
+
+	/* Succeed the command and update the bytes transferred counter */
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= BytesTransferred;
+}
+#endif
+
+/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the storage medium,
+ *  and indicates if it is present and functioning correctly. Only the Self-Test portion of the diagnostic command is
  *  supported.
  *
  *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
@@ -226,8 +257,8 @@ static void SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* MSInterfaceI
 		return;
 	}
 	
-	/* Check to see if all attached Dataflash ICs are functional */
-	if (!(DataflashManager_CheckDataflashOperation()))
+	/* Check to see if the storage medium is functional */
+	if (!(BlockDevice_CheckOperation()))
 	{
 		/* Update SENSE key with a hardware error condition and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
@@ -242,7 +273,7 @@ static void SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* MSInterfaceI
 }
 
 /** Command processing for an issued SCSI READ (10) or WRITE (10) command. This command reads in the block start address
- *  and total number of blocks to process, then calls the appropriate low-level dataflash routine to handle the actual
+ *  and total number of blocks to process, then calls the appropriate block device routine to handle the actual
  *  reading and writing of the data.
  *
  *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
@@ -252,6 +283,7 @@ static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo
 {
 	uint32_t BlockAddress;
 	uint16_t TotalBlocks;
+	uint8_t  ErrorCode;
 	
 	/* Load in the 32-bit block address (SCSI uses big-endian, so have to reverse the byte order) */
 	BlockAddress = SwapEndian_32(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[2]);
@@ -259,8 +291,24 @@ static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo
 	/* Load in the 16-bit total blocks (SCSI uses big-endian, so have to reverse the byte order) */
 	TotalBlocks  = SwapEndian_16(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[7]);
 	
-	/* Check if the block address is outside the maximum allowable value for the LUN */
-	if (BlockAddress >= VIRTUAL_MEMORY_BLOCKS)
+	#if defined(VIRTUAL_FAT_LOG)
+	/* The synthesized FAT volume cannot be modified by the host, reject all writes */
+	if (IsDataRead == DATA_WRITE)
+	{
+		/* Medium is write protected, update SENSE key and return command fail */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_DATA_PROTECT,
+		               SCSI_ASENSE_WRITE_PROTECTED,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return;
+	}
+
+	/* Check if any of the requested blocks lie outside the virtual volume */
+	if ((BlockAddress + TotalBlocks) > VirtualFAT_GetTotalBlocks())
+	#else
+	/* Check if any of the requested blocks lie outside the medium */
+	if ((BlockAddress + TotalBlocks) > BlockDevice_GetTotalBlocks())
+	#endif
 	{
 		/* Block address is invalid, update SENSE key and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
@@ -271,11 +319,25 @@ static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo
 	}
 	
 	/* Determine if the packet is a READ (10) or WRITE (10) command, call appropriate function */
+	#if defined(VIRTUAL_FAT_LOG)
+	ErrorCode = VirtualFAT_ReadBlocks_Endpoint(BlockAddress, TotalBlocks, &MSInterfaceInfo->State.IsMassStoreReset);
+	#else
 	if (IsDataRead == DATA_READ)
-	  DataflashManager_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	  ErrorCode = BlockDevice_ReadBlocks_Endpoint(BlockAddress, TotalBlocks, &MSInterfaceInfo->State.IsMassStoreReset);
 	else
-	  DataflashManager_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	  ErrorCode = BlockDevice_WriteBlocks_Endpoint(BlockAddress, TotalBlocks, &MSInterfaceInfo->State.IsMassStoreReset);
+	#endif
+
+	if (ErrorCode != BLOCKDEV_ERROR_NoError)
+	{
+		/* Transfer could not be completed, update SENSE key and return command fail */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
+		               SCSI_ASENSE_NO_ADDITIONAL_INFORMATION,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return;
+	}
 
 	/* Update the bytes transferred counter and succeed the command */
-	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * BLOCKDEV_BLOCK_SIZE);
 }
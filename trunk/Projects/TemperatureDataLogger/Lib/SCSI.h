@@ -43,9 +43,10 @@
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
 
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
+
 		#include "../TempDataLogger.h"
 		#include "../Descriptors.h"
-		#include "DataflashManager.h"
 	
 	/* Macros: */
 		/** Macro to set the current SCSI sense data to the given key, additional sense code and additional sense qualifier. This
@@ -81,6 +82,10 @@
 			static void SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo);
 			static void SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* MSInterfaceInfo);
 			static void SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* MSInterfaceInfo, const bool IsDataRead);
+			
+			#if defined(VIRTUAL_FAT_LOG)
+			static void SCSI_Command_Mode_Sense_6(USB_ClassInfo_MS_Device_t* MSInterfaceInfo);
+			#endif
 		#endif
 		
 #endif
@@ -0,0 +1,486 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Virtual FAT16 volume, which presents files appended to the raw storage medium to the host as an ordinary read only
+ *  FAT filesystem. File data is stored contiguously in the storage medium's blocks, one file after another, and only a
+ *  compact table of the files' names, timestamps and sizes is kept in EEPROM. The boot sector, FAT and root directory
+ *  sectors of the volume are generated from this table on the fly as they are read by the host, and the data sectors of
+ *  the volume map directly onto the storage medium's blocks. Appending to a file therefore requires no filesystem
+ *  bookkeeping on the device, at the cost of the volume being read only to the host.
+ *
+ *  The unused portion of the last block of each file is filled with 0xFF bytes, which are used to recover the exact
+ *  size of the last file after a power loss - file data must therefore not contain any 0xFF bytes.
+ */
+ 
+#define  INCLUDE_FROM_VIRTUALFAT_C
+#include "VirtualFAT.h"
+
+/** Non-volatile copy of the file table in EEPROM. The size of the last file is only updated here when a block of the file
+ *  is completed, with the size of its partial block recovered from its 0xFF padding on startup. The exact size of each
+ *  previous file is stored when the file following it is created.
+ *
+ *  As EEPROM is written a byte at a time, a power loss while the last file's size is updated can leave a size which is
+ *  smaller than both the old and new sizes. The block following the last file's partial block is therefore kept erased,
+ *  so that the file's tail can always be found on startup by skipping over its completed blocks.
+ */
+VirtualFAT_FileEntry_t EEMEM FileTable_EEPROM[VIRTUAL_FAT_MAX_FILES];
+
+/** Non-volatile number of valid entries in the EEPROM file table. */
+uint8_t EEMEM TotalFiles_EEPROM;
+
+/** SRAM copy of the file table, holding the exact size of each file. */
+static VirtualFAT_FileEntry_t FileTable[VIRTUAL_FAT_MAX_FILES];
+
+/** Number of valid entries in the file table. */
+static uint8_t TotalFiles;
+
+/** Indicates if the last file in the file table is currently open for appending. */
+static bool IsFileOpen;
+
+/** Contents of the last, partially filled block of the last file in the file table, with unused bytes set to 0xFF. */
+static uint8_t TailBlockBuffer[BLOCKDEV_BLOCK_SIZE];
+
+/** Number of storage medium blocks which may be used to store file data. */
+static uint16_t RecordBlocks;
+
+/** Number of clusters (and blocks) in the data area of the virtual volume. */
+static uint16_t TotalClusters;
+
+/** Number of blocks occupied by each copy of the File Allocation Table in the virtual volume. */
+static uint16_t FATBlocks;
+
+/** Block address of the root directory in the virtual volume. */
+static uint16_t RootDirectoryBlock;
+
+/** Block address of the first data cluster in the virtual volume. */
+static uint16_t DataStartBlock;
+
+
+/** Initializes the virtual FAT volume, loading the file table from EEPROM and recovering the size of the last file. The
+ *  storage medium must be initialized via \ref BlockDevice_Init() before this function is called.
+ */
+void VirtualFAT_Init(void)
+{
+	uint32_t MediumBlocks = BlockDevice_GetTotalBlocks();
+
+	/* Determine the layout of the virtual volume from the storage medium's capacity */
+	RecordBlocks       = (MediumBlocks < VIRTUAL_FAT_MAX_CLUSTERS) ? MediumBlocks : VIRTUAL_FAT_MAX_CLUSTERS;
+	TotalClusters      = (RecordBlocks < VIRTUAL_FAT_MIN_CLUSTERS) ? VIRTUAL_FAT_MIN_CLUSTERS : RecordBlocks;
+	FATBlocks          = ((((uint32_t)TotalClusters + 2) * sizeof(uint16_t)) + (BLOCKDEV_BLOCK_SIZE - 1)) / BLOCKDEV_BLOCK_SIZE;
+	RootDirectoryBlock = (1 + (FATBlocks * 2));
+	DataStartBlock     = (RootDirectoryBlock + ((VIRTUAL_FAT_ROOT_ENTRIES * sizeof(VirtualFAT_DirectoryEntry_t)) /
+	                                            BLOCKDEV_BLOCK_SIZE));
+
+	/* Load the file table from EEPROM, an invalid number of files indicates that the table has never been written */
+	TotalFiles = eeprom_read_byte(&TotalFiles_EEPROM);
+	IsFileOpen = false;
+
+	if (TotalFiles > VIRTUAL_FAT_MAX_FILES)
+	  TotalFiles = 0;
+
+	eeprom_read_block(FileTable, FileTable_EEPROM, (TotalFiles * sizeof(VirtualFAT_FileEntry_t)));
+
+	memset(TailBlockBuffer, 0xFF, sizeof(TailBlockBuffer));
+
+	if (!(TotalFiles))
+	  return;
+
+	/* Recover the size of the last file from the 0xFF padding of its partially filled last block, skipping over any
+	 * completed blocks whose completion was not recorded in EEPROM */
+	VirtualFAT_FileEntry_t* LastFile  = &FileTable[TotalFiles - 1];
+	uint32_t                TailBlock = (VirtualFAT_GetFileStartBlock(TotalFiles - 1) +
+	                                     (LastFile->SizeBytes / BLOCKDEV_BLOCK_SIZE));
+	uint16_t                TailBytes = 0;
+
+	LastFile->SizeBytes -= (LastFile->SizeBytes % BLOCKDEV_BLOCK_SIZE);
+
+	uint32_t RecordedSize = LastFile->SizeBytes;
+
+	while (TailBlock < RecordBlocks)
+	{
+		BlockDevice_ReadBlocks(TailBlock, 1, TailBlockBuffer);
+
+		TailBytes = 0;
+		while ((TailBytes < BLOCKDEV_BLOCK_SIZE) && (TailBlockBuffer[TailBytes] != 0xFF))
+		  TailBytes++;
+
+		if (TailBytes < BLOCKDEV_BLOCK_SIZE)
+		  break;
+
+		LastFile->SizeBytes += BLOCKDEV_BLOCK_SIZE;
+		TailBlock++;
+	}
+
+	if (TailBlock >= RecordBlocks)
+	{
+		memset(TailBlockBuffer, 0xFF, sizeof(TailBlockBuffer));
+		TailBytes = 0;
+	}
+
+	/* Record any completed blocks which were not recorded, and ensure that the block following the tail block is erased */
+	if (LastFile->SizeBytes != RecordedSize)
+	  VirtualFAT_SaveFileEntry(TotalFiles - 1);
+
+	if ((TailBlock + 1) < RecordBlocks)
+	{
+		/* The tail block buffer is used to check the following block, and the tail block is then read back into it */
+		BlockDevice_ReadBlocks((TailBlock + 1), 1, TailBlockBuffer);
+
+		for (uint16_t ByteIndex = 0; ByteIndex < BLOCKDEV_BLOCK_SIZE; ByteIndex++)
+		{
+			if (TailBlockBuffer[ByteIndex] != 0xFF)
+			{
+				memset(TailBlockBuffer, 0xFF, sizeof(TailBlockBuffer));
+				BlockDevice_WriteBlocks((TailBlock + 1), 1, TailBlockBuffer);
+				break;
+			}
+		}
+
+		BlockDevice_ReadBlocks(TailBlock, 1, TailBlockBuffer);
+	}
+
+	LastFile->SizeBytes += TailBytes;
+}
+
+/** Retrieves the total number of blocks in the virtual FAT volume, for the SCSI READ CAPACITY command.
+ *
+ *  \return Total number of blocks in the virtual volume
+ */
+uint32_t VirtualFAT_GetTotalBlocks(void)
+{
+	return ((uint32_t)DataStartBlock + TotalClusters);
+}
+
+/** Reads blocks of the virtual FAT volume, and writes them to the currently selected endpoint. Filesystem blocks are
+ *  generated from the file table, while data blocks are read directly from the storage medium.
+ *
+ *  \param[in] BlockAddress  Address of the first virtual volume block to read
+ *  \param[in] TotalBlocks   Number of blocks to read
+ *  \param[in] AbortFlag     Pointer to a flag which aborts the transfer when set, or NULL if the transfer cannot be aborted
+ *
+ *  \return A value from the \ref BlockDevice_ErrorCodes_t enum
+ */
+uint8_t VirtualFAT_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+                                       const volatile bool* const AbortFlag)
+{
+	uint32_t CurrentBlock = BlockAddress;
+	uint8_t  ErrorCode;
+
+	/* Check that all the requested blocks lie within the virtual volume */
+	if ((BlockAddress + TotalBlocks) > VirtualFAT_GetTotalBlocks())
+	  return BLOCKDEV_ERROR_OutOfRange;
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return BLOCKDEV_ERROR_EndpointError;
+
+	while (TotalBlocks)
+	{
+		if ((CurrentBlock >= DataStartBlock) && ((CurrentBlock - DataStartBlock) < RecordBlocks))
+		{
+			uint32_t RecordBlock     = (CurrentBlock - DataStartBlock);
+			uint16_t RecordBlockRead = TotalBlocks;
+
+			if (RecordBlockRead > (RecordBlocks - RecordBlock))
+			  RecordBlockRead = (RecordBlocks - RecordBlock);
+
+			/* Data clusters map directly onto the storage medium blocks, read them all in a single transfer */
+			if ((ErrorCode = BlockDevice_ReadBlocks_Endpoint(RecordBlock, RecordBlockRead, AbortFlag)) != BLOCKDEV_ERROR_NoError)
+			  return ErrorCode;
+
+			CurrentBlock += RecordBlockRead;
+			TotalBlocks  -= RecordBlockRead;
+		}
+		else
+		{
+			uint8_t BlockBuffer[BLOCKDEV_BLOCK_SIZE];
+
+			/* Generate the filesystem block from the file table and send it to the host */
+			VirtualFAT_GenerateBlock(CurrentBlock, BlockBuffer);
+
+			if (Endpoint_Write_Stream_LE(BlockBuffer, sizeof(BlockBuffer), NO_STREAM_CALLBACK))
+			  return BLOCKDEV_ERROR_EndpointError;
+
+			/* Check if the current transfer is being aborted */
+			if ((AbortFlag != NULL) && *AbortFlag)
+			  return BLOCKDEV_ERROR_Aborted;
+
+			CurrentBlock++;
+			TotalBlocks--;
+		}
+	}
+
+	/* If the endpoint is full, send its contents to the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	return BLOCKDEV_ERROR_NoError;
+}
+
+/** Opens a file in the virtual FAT volume for appending. If the given file is the last file in the file table it is
+ *  reopened so that new data is appended to its existing contents, otherwise a new empty file is created after the
+ *  last file.
+ *
+ *  \param[in] Name       Space padded, upper case FAT short name of the file to open, of \ref VIRTUAL_FAT_NAME_LENGTH characters
+ *  \param[in] Timestamp  FAT creation date (upper 16 bits) and time (lower 16 bits) of the file if it is created
+ *
+ *  \return Boolean true if the file was opened, false if the file table or storage medium is full
+ */
+bool VirtualFAT_OpenFile(const char* Name, const uint32_t Timestamp)
+{
+	/* Reopen the last file if it has the requested name */
+	if (TotalFiles && !(memcmp(FileTable[TotalFiles - 1].Name, Name, VIRTUAL_FAT_NAME_LENGTH)))
+	{
+		IsFileOpen = true;
+		return true;
+	}
+
+	if (TotalFiles == VIRTUAL_FAT_MAX_FILES)
+	  return false;
+
+	/* Store the exact size of the previous file, as its partial block is no longer the last block on the medium */
+	if (TotalFiles)
+	  VirtualFAT_SaveFileEntry(TotalFiles - 1);
+
+	uint32_t StartBlock = VirtualFAT_GetFileStartBlock(TotalFiles);
+
+	if (StartBlock >= RecordBlocks)
+	  return false;
+
+	/* Erase the new file's first two blocks, so that its size can be recovered from the padding after a power loss */
+	memset(TailBlockBuffer, 0xFF, sizeof(TailBlockBuffer));
+	BlockDevice_WriteBlocks(StartBlock, 1, TailBlockBuffer);
+
+	if ((StartBlock + 1) < RecordBlocks)
+	  BlockDevice_WriteBlocks((StartBlock + 1), 1, TailBlockBuffer);
+
+	VirtualFAT_FileEntry_t* NewFile = &FileTable[TotalFiles];
+
+	memcpy(NewFile->Name, Name, VIRTUAL_FAT_NAME_LENGTH);
+	NewFile->Timestamp = Timestamp;
+	NewFile->SizeBytes = 0;
+
+	/* Store the new file's entry before the updated file count, so that the table is always valid in EEPROM */
+	VirtualFAT_SaveFileEntry(TotalFiles);
+	eeprom_write_byte(&TotalFiles_EEPROM, ++TotalFiles);
+
+	IsFileOpen = true;
+	return true;
+}
+
+/** Appends data to the end of the currently open file. The data is written to the storage medium before the function
+ *  returns, so that it is retained if power is lost.
+ *
+ *  \param[in] Data    Pointer to the data to append to the file, which must not contain any 0xFF bytes
+ *  \param[in] Length  Number of bytes to append to the file
+ *
+ *  \return Boolean true if all the data was appended, false if no file is open or the storage medium is full
+ */
+bool VirtualFAT_AppendFile(const void* Data, uint16_t Length)
+{
+	const uint8_t* DataPtr = (const uint8_t*)Data;
+
+	if (!(IsFileOpen))
+	  return false;
+
+	VirtualFAT_FileEntry_t* File      = &FileTable[TotalFiles - 1];
+	uint32_t                TailBlock = (VirtualFAT_GetFileStartBlock(TotalFiles - 1) + (File->SizeBytes / BLOCKDEV_BLOCK_SIZE));
+
+	while (Length)
+	{
+		uint16_t TailBytes = (File->SizeBytes % BLOCKDEV_BLOCK_SIZE);
+		uint16_t CopyBytes = (BLOCKDEV_BLOCK_SIZE - TailBytes);
+
+		if (TailBlock >= RecordBlocks)
+		  return false;
+
+		if (CopyBytes > Length)
+		  CopyBytes = Length;
+
+		memcpy(&TailBlockBuffer[TailBytes], DataPtr, CopyBytes);
+
+		DataPtr         += CopyBytes;
+		Length          -= CopyBytes;
+		File->SizeBytes += CopyBytes;
+
+		/* Write the updated tail block to the storage medium, padded with 0xFF bytes if it is not yet complete */
+		BlockDevice_WriteBlocks(TailBlock, 1, TailBlockBuffer);
+
+		if (File->SizeBytes % BLOCKDEV_BLOCK_SIZE)
+		  continue;
+
+		/* Block completed, the next block is already erased - erase the block after it before recording the new size */
+		memset(TailBlockBuffer, 0xFF, sizeof(TailBlockBuffer));
+
+		TailBlock++;
+
+		if ((TailBlock + 1) < RecordBlocks)
+		  BlockDevice_WriteBlocks((TailBlock + 1), 1, TailBlockBuffer);
+
+		VirtualFAT_SaveFileEntry(TotalFiles - 1);
+	}
+
+	return true;
+}
+
+/** Closes the currently open file, so that no further data can be appended to it until it is reopened. */
+void VirtualFAT_CloseFile(void)
+{
+	IsFileOpen = false;
+}
+
+/** Retrieves the first storage medium block of the given file, which directly follows the last block of the previous file.
+ *
+ *  \param[in] FileIndex  Index of the file in the file table
+ *
+ *  \return Storage medium block address of the file's first block
+ */
+static uint32_t VirtualFAT_GetFileStartBlock(const uint8_t FileIndex)
+{
+	uint32_t StartBlock = 0;
+
+	for (uint8_t PrevFileIndex = 0; PrevFileIndex < FileIndex; PrevFileIndex++)
+	  StartBlock += ((FileTable[PrevFileIndex].SizeBytes + (BLOCKDEV_BLOCK_SIZE - 1)) / BLOCKDEV_BLOCK_SIZE);
+
+	return StartBlock;
+}
+
+/** Stores the given file's entry from the SRAM file table into the EEPROM file table.
+ *
+ *  \param[in] FileIndex  Index of the file in the file table
+ */
+static void VirtualFAT_SaveFileEntry(const uint8_t FileIndex)
+{
+	eeprom_write_block(&FileTable[FileIndex], &FileTable_EEPROM[FileIndex], sizeof(VirtualFAT_FileEntry_t));
+}
+
+/** Generates the contents of the given boot sector, FAT, root directory or unused data block of the virtual FAT volume.
+ *
+ *  \param[in]  BlockAddress  Address of the virtual volume block to generate
+ *  \param[out] BlockBuffer   Pointer to a buffer where the generated block is to be stored
+ */
+static void VirtualFAT_GenerateBlock(const uint32_t BlockAddress, uint8_t* const BlockBuffer)
+{
+	memset(BlockBuffer, 0x00, BLOCKDEV_BLOCK_SIZE);
+
+	if (BlockAddress == 0)
+	{
+		VirtualFAT_BootBlock_t* BootBlock    = (VirtualFAT_BootBlock_t*)BlockBuffer;
+		uint32_t                TotalSectors = VirtualFAT_GetTotalBlocks();
+
+		BootBlock->Bootstrap[0]       = 0xEB;
+		BootBlock->Bootstrap[1]       = 0x3C;
+		BootBlock->Bootstrap[2]       = 0x90;
+		memcpy(BootBlock->OEMName, "MSDOS5.0", sizeof(BootBlock->OEMName));
+		BootBlock->BytesPerSector     = BLOCKDEV_BLOCK_SIZE;
+		BootBlock->SectorsPerCluster  = 1;
+		BootBlock->ReservedSectors    = 1;
+		BootBlock->TotalFATs          = 2;
+		BootBlock->RootEntries        = VIRTUAL_FAT_ROOT_ENTRIES;
+		BootBlock->TotalSectors16     = (TotalSectors < 0x10000) ? TotalSectors : 0;
+		BootBlock->MediaDescriptor    = 0xF8;
+		BootBlock->SectorsPerFAT      = FATBlocks;
+		BootBlock->SectorsPerTrack    = 32;
+		BootBlock->TotalHeads         = 64;
+		BootBlock->TotalSectors32     = (TotalSectors < 0x10000) ? 0 : TotalSectors;
+		BootBlock->DriveNumber        = 0x80;
+		BootBlock->BootSignature      = 0x29;
+		BootBlock->VolumeSerialNumber = 0x4C554641;
+		memcpy(BootBlock->VolumeLabel, "DATALOGGER ", sizeof(BootBlock->VolumeLabel));
+		memcpy(BootBlock->FileSystemType, "FAT16   ", sizeof(BootBlock->FileSystemType));
+
+		BlockBuffer[BLOCKDEV_BLOCK_SIZE - 2] = 0x55;
+		BlockBuffer[BLOCKDEV_BLOCK_SIZE - 1] = 0xAA;
+	}
+	else if (BlockAddress < RootDirectoryBlock)
+	{
+		uint16_t* FATEntries  = (uint16_t*)BlockBuffer;
+		uint16_t  FirstEntry  = (((BlockAddress - 1) % FATBlocks) * (BLOCKDEV_BLOCK_SIZE / sizeof(uint16_t)));
+		uint16_t  StartBlock  = 0;
+
+		/* Reserved entries for the media descriptor and the clean shutdown flags */
+		if (!(FirstEntry))
+		{
+			FATEntries[0] = 0xFFF8;
+			FATEntries[1] = 0xFFFF;
+		}
+
+		/* Chain together the clusters of each file, which are stored contiguously one file after another */
+		for (uint8_t FileIndex = 0; FileIndex < TotalFiles; FileIndex++)
+		{
+			uint16_t FileBlocks   = ((FileTable[FileIndex].SizeBytes + (BLOCKDEV_BLOCK_SIZE - 1)) / BLOCKDEV_BLOCK_SIZE);
+			uint16_t FirstCluster = (2 + StartBlock);
+			uint16_t LastCluster  = (FirstCluster + FileBlocks - 1);
+
+			StartBlock += FileBlocks;
+
+			if (!(FileBlocks) || (LastCluster < FirstEntry))
+			  continue;
+
+			for (uint16_t EntryIndex = 0; EntryIndex < (BLOCKDEV_BLOCK_SIZE / sizeof(uint16_t)); EntryIndex++)
+			{
+				uint16_t Cluster = (FirstEntry + EntryIndex);
+
+				if ((Cluster >= FirstCluster) && (Cluster <= LastCluster))
+				  FATEntries[EntryIndex] = (Cluster == LastCluster) ? 0xFFFF : (Cluster + 1);
+			}
+		}
+	}
+	else if (BlockAddress == RootDirectoryBlock)
+	{
+		VirtualFAT_DirectoryEntry_t* DirectoryEntry = (VirtualFAT_DirectoryEntry_t*)BlockBuffer;
+		uint16_t                     StartBlock     = 0;
+
+		memcpy(DirectoryEntry->Name, "DATALOGGER ", VIRTUAL_FAT_NAME_LENGTH);
+		DirectoryEntry->Attributes = VIRTUAL_FAT_ATTR_VOLUME_ID;
+
+		for (uint8_t FileIndex = 0; FileIndex < TotalFiles; FileIndex++)
+		{
+			VirtualFAT_FileEntry_t* File = &FileTable[FileIndex];
+
+			DirectoryEntry++;
+
+			memcpy(DirectoryEntry->Name, File->Name, VIRTUAL_FAT_NAME_LENGTH);
+			DirectoryEntry->Attributes       = (VIRTUAL_FAT_ATTR_READONLY | VIRTUAL_FAT_ATTR_ARCHIVE);
+			DirectoryEntry->CreationTime     = (File->Timestamp & 0xFFFF);
+			DirectoryEntry->CreationDate     = (File->Timestamp >> 16);
+			DirectoryEntry->AccessDate       = (File->Timestamp >> 16);
+			DirectoryEntry->ModificationTime = (File->Timestamp & 0xFFFF);
+			DirectoryEntry->ModificationDate = (File->Timestamp >> 16);
+			DirectoryEntry->StartCluster     = (File->SizeBytes) ? (2 + StartBlock) : 0;
+			DirectoryEntry->SizeBytes        = File->SizeBytes;
+
+			StartBlock += ((File->SizeBytes + (BLOCKDEV_BLOCK_SIZE - 1)) / BLOCKDEV_BLOCK_SIZE);
+		}
+	}
+}
@@ -0,0 +1,151 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Header file for VirtualFAT.c.
+ */
+ 
+#ifndef _VIRTUALFAT_H_
+#define _VIRTUALFAT_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/eeprom.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include <LUFA/Drivers/USB/USB.h>
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
+		
+	/* Macros: */
+		#if !defined(VIRTUAL_FAT_MAX_FILES) || defined(__DOXYGEN__)
+			/** Maximum number of files which can be stored in the virtual FAT volume's file table. Each file's entry
+			 *  occupies 19 bytes of EEPROM, and this value must be less than the number of root directory entries in
+			 *  the volume.
+			 */
+			#define VIRTUAL_FAT_MAX_FILES            8
+		#endif
+
+		/** Number of root directory entries in the virtual FAT volume, including the volume label entry. */
+		#define VIRTUAL_FAT_ROOT_ENTRIES             16
+
+		/** Length of a file's space padded FAT short name (8 name characters and 3 extension characters). */
+		#define VIRTUAL_FAT_NAME_LENGTH              11
+
+		/** Minimum number of clusters in the virtual FAT volume, so that hosts always identify the volume as FAT16. */
+		#define VIRTUAL_FAT_MIN_CLUSTERS             4096
+
+		/** Maximum number of clusters in a FAT16 volume. */
+		#define VIRTUAL_FAT_MAX_CLUSTERS             65524
+
+		/** Attribute mask for a FAT directory entry, indicating a read only file. */
+		#define VIRTUAL_FAT_ATTR_READONLY            (1 << 0)
+
+		/** Attribute mask for a FAT directory entry, indicating the volume label entry. */
+		#define VIRTUAL_FAT_ATTR_VOLUME_ID           (1 << 3)
+
+		/** Attribute mask for a FAT directory entry, indicating a file which has changed since it was last archived. */
+		#define VIRTUAL_FAT_ATTR_ARCHIVE             (1 << 5)
+
+	/* Preprocessor Checks: */
+		#if (VIRTUAL_FAT_MAX_FILES >= VIRTUAL_FAT_ROOT_ENTRIES)
+			#error VIRTUAL_FAT_MAX_FILES must be less than the number of root directory entries.
+		#endif
+
+	/* Type Defines: */
+		/** Type define for an entry in the virtual FAT volume's file table. Files are stored one after another in the
+		 *  storage medium's blocks, each starting at the first block following the previous file.
+		 */
+		typedef struct
+		{
+			char     Name[VIRTUAL_FAT_NAME_LENGTH]; /**< Space padded, upper case FAT short name of the file */
+			uint32_t Timestamp; /**< FAT creation date (upper 16 bits) and time (lower 16 bits) of the file */
+			uint32_t SizeBytes; /**< Size of the file in bytes, rounded down to the last completed block in EEPROM */
+		} VirtualFAT_FileEntry_t;
+
+		/** Type define for the boot sector of a FAT16 volume, up to the end of the extended boot record. */
+		typedef struct
+		{
+			uint8_t  Bootstrap[3];
+			char     OEMName[8];
+			uint16_t BytesPerSector;
+			uint8_t  SectorsPerCluster;
+			uint16_t ReservedSectors;
+			uint8_t  TotalFATs;
+			uint16_t RootEntries;
+			uint16_t TotalSectors16;
+			uint8_t  MediaDescriptor;
+			uint16_t SectorsPerFAT;
+			uint16_t SectorsPerTrack;
+			uint16_t TotalHeads;
+			uint32_t HiddenSectors;
+			uint32_t TotalSectors32;
+			uint8_t  DriveNumber;
+			uint8_t  Reserved;
+			uint8_t  BootSignature;
+			uint32_t VolumeSerialNumber;
+			char     VolumeLabel[11];
+			char     FileSystemType[8];
+		} VirtualFAT_BootBlock_t;
+
+		/** Type define for a FAT directory entry. */
+		typedef struct
+		{
+			char     Name[VIRTUAL_FAT_NAME_LENGTH];
+			uint8_t  Attributes;
+			uint8_t  Reserved[2];
+			uint16_t CreationTime;
+			uint16_t CreationDate;
+			uint16_t AccessDate;
+			uint16_t StartClusterHigh;
+			uint16_t ModificationTime;
+			uint16_t ModificationDate;
+			uint16_t StartCluster;
+			uint32_t SizeBytes;
+		} VirtualFAT_DirectoryEntry_t;
+		
+	/* Function Prototypes: */
+		void     VirtualFAT_Init(void);
+		uint32_t VirtualFAT_GetTotalBlocks(void);
+		uint8_t  VirtualFAT_ReadBlocks_Endpoint(const uint32_t BlockAddress, uint16_t TotalBlocks,
+		                                        const volatile bool* const AbortFlag);
+		bool     VirtualFAT_OpenFile(const char* Name, const uint32_t Timestamp);
+		bool     VirtualFAT_AppendFile(const void* Data, uint16_t Length);
+		void     VirtualFAT_CloseFile(void);
+		
+		#if defined(INCLUDE_FROM_VIRTUALFAT_C)
+			static uint32_t VirtualFAT_GetFileStartBlock(const uint8_t FileIndex);
+			static void     VirtualFAT_SaveFileEntry(const uint8_t FileIndex);
+			static void     VirtualFAT_GenerateBlock(const uint32_t BlockAddress, uint8_t* const BlockBuffer);
+		#endif
+
+#endif
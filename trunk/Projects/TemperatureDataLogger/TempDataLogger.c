@@ -48,11 +48,11 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 
 				.DataINEndpointNumber      = MASS_STORAGE_IN_EPNUM,
 				.DataINEndpointSize        = MASS_STORAGE_IO_EPSIZE,
-				.DataINEndpointDoubleBank  = false,
+				.DataINEndpointDoubleBank  = true,
 
 				.DataOUTEndpointNumber     = MASS_STORAGE_OUT_EPNUM,
 				.DataOUTEndpointSize       = MASS_STORAGE_IO_EPSIZE,
-				.DataOUTEndpointDoubleBank = false,
+				.DataOUTEndpointDoubleBank = true,
 
 				.TotalLUNs                 = 1,
 			},
@@ -89,16 +89,35 @@ uint8_t LoggingInterval500MS_SRAM;
 /** Total number of 500ms logging ticks elapsed since the last log value was recorded */
 uint16_t CurrentLoggingTicks;
 
+#if !defined(VIRTUAL_FAT_LOG)
 /** FAT Fs structure to hold the internal state of the FAT driver for the dataflash contents. */
 FATFS DiskFATState;
 
 /** FAT Fs structure to hold a FAT file handle for the log data write destination. */
 FIL TempLogFile;
+#endif
 
+#if defined(BINARY_LOG)
+/** Indicates if the log file should currently be open. This is set and cleared by the USB connection events, so that
+ *  the log file is only ever opened and closed from the main program loop rather than while a log sector is being written.
+ */
+volatile bool LogFileRequested;
+
+/** Indicates if the log file is currently open. */
+bool LogFileOpen;
+#endif
 
-/** ISR to handle the 500ms ticks for sampling and data logging */
+
+/** ISR to handle the sampling timer ticks for data logging, every 500ms or at BINARY_LOG_SAMPLE_RATE_HZ when BINARY_LOG
+ *  is defined.
+ */
 ISR(TIMER1_COMPA_vect, ISR_BLOCK)
 {
+	#if defined(BINARY_LOG)
+	/* Timestamp and queue a sample on every tick, the main program loop writes the queued samples to the log file */
+	if (USB_DeviceState == DEVICE_STATE_Unattached)
+	  BinaryLog_AddSample(Temperature_GetTemperature());
+	#else
 	uint8_t LEDMask = LEDs_GetLEDs();
 
 	/* Check to see if the logging interval has expired */
@@ -125,11 +144,16 @@ ISR(TIMER1_COMPA_vect, ISR_BLOCK)
 		BytesWritten = sprintf(LineBuffer, "%02d/%02d/20%04d, %02d:%02d:%02d, %d Degrees\r\n",
 							   Day, Month, Year, Hour, Minute, Second, Temperature_GetTemperature());
 
+		#if defined(VIRTUAL_FAT_LOG)
+		VirtualFAT_AppendFile(LineBuffer, BytesWritten);
+		#else
 		f_write(&TempLogFile, LineBuffer, BytesWritten, &BytesWritten);
 		f_sync(&TempLogFile);
+		#endif
 	}
 	
 	LEDs_SetAllLEDs(LEDMask);
+	#endif
 }
 
 /** Main program entry point. This routine contains the overall program flow, including initial
@@ -145,6 +169,9 @@ int main(void)
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 
 	/* Mount and open the log file on the dataflash FAT partition */
+	#if defined(BINARY_LOG)
+	LogFileRequested = true;
+	#endif
 	OpenLogFile();
 
 	/* Discard the first sample from the temperature sensor, as it is generally incorrect */
@@ -153,6 +180,31 @@ int main(void)
 	
 	for (;;)
 	{
+		#if defined(BINARY_LOG)
+		/* Open or close the log file as requested by the USB connection events */
+		if (LogFileRequested != LogFileOpen)
+		{
+			if (LogFileRequested)
+			  OpenLogFile();
+			else
+			  CloseLogFile();
+		}
+		
+		/* Write out queued samples to the log file, showing the logging activity on the board LEDs while doing so */
+		if (BinaryLog_IsSampleQueued())
+		{
+			uint8_t LEDMask = LEDs_GetLEDs();
+
+			LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
+			BinaryLog_Task();
+			LEDs_SetAllLEDs(LEDMask);
+		}
+		else
+		{
+			BinaryLog_Task();
+		}
+		#endif
+
 		MS_Device_USBTask(&Disk_MS_Interface);
 		HID_Device_USBTask(&Generic_HID_Interface);
 		USB_USBTask();
@@ -167,20 +219,47 @@ void OpenLogFile(void)
 	/* Get the current date for the filename as "DDMMYY.csv" */
 	uint8_t Day, Month, Year;
 	DS1307_GetDate(&Day, &Month, &Year);
+
+	#if defined(VIRTUAL_FAT_LOG)
+	/* Create the file in the virtual FAT volume's file table, or reopen it if it was the last file logged to */
+	sprintf(LogFileName, "%02d%02d%02d  CSV", Day, Month, Year);
+	VirtualFAT_OpenFile(LogFileName, get_fattime());
+	#elif defined(BINARY_LOG)
+	sprintf(LogFileName, "%02d%02d%02d.bin", Day, Month, Year);
+
+	/* Mount the storage device, open the file and start a new logging session at the end of the file */
+	f_mount(0, &DiskFATState);
+	f_open(&TempLogFile, LogFileName, FA_OPEN_ALWAYS | FA_WRITE);
+	BinaryLog_Open(&TempLogFile);
+
+	LogFileOpen = true;
+	#else
 	sprintf(LogFileName, "%02d%02d%02d.csv", Day, Month, Year);
 
 	/* Mount the storage device, open the file */
 	f_mount(0, &DiskFATState);
 	f_open(&TempLogFile, LogFileName, FA_OPEN_ALWAYS | FA_WRITE);
 	f_lseek(&TempLogFile, TempLogFile.fsize);
+	#endif
 }
 
 /** Closes the open data log file on the Dataflash's FAT formatted partition */
 void CloseLogFile(void)
 {
+	#if defined(VIRTUAL_FAT_LOG)
+	/* Appended data is already stored, stop appending to the file */
+	VirtualFAT_CloseFile();
+	#elif defined(BINARY_LOG)
+	/* Write out all queued samples and sync them to the file, unmount the storage device */
+	BinaryLog_Close();
+	f_close(&TempLogFile);
+
+	LogFileOpen = false;
+	#else
 	/* Sync any data waiting to be written, unmount the storage device */
 	f_sync(&TempLogFile);
 	f_close(&TempLogFile);
+	#endif
 }
 
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
@@ -202,13 +281,24 @@ void SetupHardware(void)
 	USB_Init();
 	TWI_Init();
 	
+	#if defined(BINARY_LOG)
+	/* Sample timer configuration, at the binary log's sample rate */
+	OCR1A   = ((((F_CPU / LOG_TIMER_PRESCALER) + (BINARY_LOG_SAMPLE_RATE_HZ / 2)) / BINARY_LOG_SAMPLE_RATE_HZ) - 1);
+	TCCR1B  = (1 << WGM12) | LOG_TIMER_CLOCK_MASK;
+	#else
 	/* 500ms logging interval timer configuration */
 	OCR1A   = ((F_CPU / 1024) / 2);
 	TCCR1B  = (1 << WGM12) | (1 << CS12) | (1 << CS10);
+	#endif
 	TIMSK1  = (1 << OCIE1A);
 
-	/* Clear Dataflash sector protections, if enabled */
-	DataflashManager_ResetDataflashProtections();
+	/* Prepare the storage medium for use, clearing Dataflash sector protections if enabled */
+	BlockDevice_Init();
+
+	#if defined(VIRTUAL_FAT_LOG)
+	/* Load the virtual FAT volume's file table */
+	VirtualFAT_Init();
+	#endif
 }
 
 /** Event handler for the library USB Connection event. */
@@ -216,8 +306,13 @@ void EVENT_USB_Device_Connect(void)
 {
 	LEDs_SetAllLEDs(LEDMASK_USB_ENUMERATING);
 
+	#if defined(BINARY_LOG)
+	/* Have the main program loop close the log file so that the host has exclusive filesystem access */
+	LogFileRequested = false;
+	#else
 	/* Close the log file so that the host has exclusive filesystem access */
 	CloseLogFile();
+	#endif
 }
 
 /** Event handler for the library USB Disconnection event. */
@@ -225,8 +320,13 @@ void EVENT_USB_Device_Disconnect(void)
 {
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 	
+	#if defined(BINARY_LOG)
+	/* Have the main program loop mount and open the log file on the dataflash FAT partition */
+	LogFileRequested = true;
+	#else
 	/* Mount and open the log file on the dataflash FAT partition */
 	OpenLogFile();
+	#endif
 }
 
 /** Event handler for the library USB Configuration Changed event. */
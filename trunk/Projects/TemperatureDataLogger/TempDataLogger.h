@@ -45,13 +45,16 @@
 		#include "Descriptors.h"
 
 		#include "Lib/SCSI.h"
-		#include "Lib/DataflashManager.h"
+		#include "Lib/VirtualFAT.h"
+		#include "Lib/BinaryLog.h"
 		#include "Lib/FATFs/ff.h"
 		#include "Lib/DS1307.h"
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Board/Temperature.h>
+		#include <LUFA/Drivers/Board/Dataflash.h>
+		#include <LUFA/Drivers/Misc/BlockDevice.h>
 		#include <LUFA/Drivers/Peripheral/ADC.h>
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
@@ -78,6 +81,30 @@
 		
 		/** Data log interval between samples, in tens of milliseconds */
 		#define LOG_INTERVAL_10MS        1000
+
+		#if defined(BINARY_LOG) || defined(__DOXYGEN__)
+			#if ((((F_CPU / 8) + (BINARY_LOG_SAMPLE_RATE_HZ / 2)) / BINARY_LOG_SAMPLE_RATE_HZ) <= 65536) || defined(__DOXYGEN__)
+				/** Clock prescaler of the sample timer, chosen as the smallest which can reach the binary log sample rate. */
+				#define LOG_TIMER_PRESCALER  8
+
+				/** Timer 1 clock select mask for the \ref LOG_TIMER_PRESCALER clock prescaler. */
+				#define LOG_TIMER_CLOCK_MASK (1 << CS11)
+			#elif ((((F_CPU / 64) + (BINARY_LOG_SAMPLE_RATE_HZ / 2)) / BINARY_LOG_SAMPLE_RATE_HZ) <= 65536)
+				#define LOG_TIMER_PRESCALER  64
+				#define LOG_TIMER_CLOCK_MASK ((1 << CS11) | (1 << CS10))
+			#elif ((((F_CPU / 256) + (BINARY_LOG_SAMPLE_RATE_HZ / 2)) / BINARY_LOG_SAMPLE_RATE_HZ) <= 65536)
+				#define LOG_TIMER_PRESCALER  256
+				#define LOG_TIMER_CLOCK_MASK (1 << CS12)
+			#else
+				#define LOG_TIMER_PRESCALER  1024
+				#define LOG_TIMER_CLOCK_MASK ((1 << CS12) | (1 << CS10))
+			#endif
+		#endif
+
+	/* Preprocessor Checks: */
+		#if (defined(VIRTUAL_FAT_LOG) && defined(BINARY_LOG))
+			#error Only one of VIRTUAL_FAT_LOG and BINARY_LOG may be defined.
+		#endif
 		
 	/* Type Defines: */
 		typedef struct
@@ -0,0 +1,210 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host utility for the TemperatureDataLogger project, which converts a binary log file written by the logger when
+ *  compiled with the BINARY_LOG option into CSV text, in the same format as the text log files written by the logger
+ *  in its default mode. Build with any C99 compiler, e.g. "gcc -std=c99 -o TempLogConverter TempLogConverter.c", and
+ *  run as "TempLogConverter DDMMYY.bin > DDMMYY.csv".
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** Size of each sector of a binary log file, in bytes. */
+#define SECTOR_SIZE          512
+
+/** Signature at the start of each sector of a binary log file. */
+#define SECTOR_SIGNATURE     0x474F4C54UL
+
+/** Size of the header at the start of each sector of a binary log file, in bytes. */
+#define SECTOR_HEADER_SIZE   19
+
+/** Size of each sample record following the sector header, in bytes. */
+#define RECORD_SIZE          3
+
+/** Reads a little endian 16-bit value from a log sector.
+ *
+ *  \param[in] Data  Pointer to the first byte of the value
+ *
+ *  \return Value read from the sector
+ */
+static uint16_t ReadLE16(const uint8_t* Data)
+{
+	return ((uint16_t)Data[0] | ((uint16_t)Data[1] << 8));
+}
+
+/** Reads a little endian 32-bit value from a log sector.
+ *
+ *  \param[in] Data  Pointer to the first byte of the value
+ *
+ *  \return Value read from the sector
+ */
+static uint32_t ReadLE32(const uint8_t* Data)
+{
+	return ((uint32_t)ReadLE16(Data) | ((uint32_t)ReadLE16(&Data[2]) << 16));
+}
+
+/** Converts a date to a number of days since 1/1/1970.
+ *
+ *  \param[in] Year   Full year number
+ *  \param[in] Month  Month of the year, from 1 to 12
+ *  \param[in] Day    Day of the month, from 1 to 31
+ *
+ *  \return Number of days between 1/1/1970 and the given date
+ */
+static long DateToDays(long Year, const unsigned Month, const unsigned Day)
+{
+	Year -= (Month <= 2);
+
+	long     Era       = (Year / 400);
+	unsigned YearOfEra = (unsigned)(Year - (Era * 400));
+	unsigned DayOfYear = ((153 * (Month + ((Month > 2) ? -3 : 9)) + 2) / 5) + Day - 1;
+	unsigned DayOfEra  = (YearOfEra * 365) + (YearOfEra / 4) - (YearOfEra / 100) + DayOfYear;
+
+	return ((Era * 146097) + (long)DayOfEra - 719468);
+}
+
+/** Converts a number of days since 1/1/1970 to a date.
+ *
+ *  \param[in]  Days   Number of days since 1/1/1970
+ *  \param[out] Year   Full year number of the date
+ *  \param[out] Month  Month of the year of the date, from 1 to 12
+ *  \param[out] Day    Day of the month of the date, from 1 to 31
+ */
+static void DaysToDate(long Days, long* const Year, unsigned* const Month, unsigned* const Day)
+{
+	Days += 719468;
+
+	long     Era       = (Days / 146097);
+	unsigned DayOfEra  = (unsigned)(Days - (Era * 146097));
+	unsigned YearOfEra = (DayOfEra - (DayOfEra / 1460) + (DayOfEra / 36524) - (DayOfEra / 146096)) / 365;
+	unsigned DayOfYear = DayOfEra - ((365 * YearOfEra) + (YearOfEra / 4) - (YearOfEra / 100));
+	unsigned MonthPos  = ((5 * DayOfYear) + 2) / 153;
+
+	*Day   = DayOfYear - (((153 * MonthPos) + 2) / 5) + 1;
+	*Month = MonthPos + ((MonthPos < 10) ? 3 : -9);
+	*Year  = (long)YearOfEra + (Era * 400) + (*Month <= 2);
+}
+
+/** Writes the samples of a single binary log sector to the output as CSV lines.
+ *
+ *  \param[in] Sector  Sector data read from the binary log file
+ *
+ *  \return Number of samples lost before the sector's first sample, or -1 if the sector is not a valid log sector
+ */
+static long ConvertSector(const uint8_t* Sector)
+{
+	if (ReadLE32(&Sector[0]) != SECTOR_SIGNATURE)
+	  return -1;
+
+	unsigned Day          = Sector[4];
+	unsigned Month        = Sector[5];
+	unsigned Year         = Sector[6];
+	unsigned Hour         = Sector[7];
+	unsigned Minute       = Sector[8];
+	unsigned Second       = Sector[9];
+	uint16_t SampleRateHz = ReadLE16(&Sector[10]);
+	uint32_t FirstSample  = ReadLE32(&Sector[12]);
+	uint16_t LostSamples  = ReadLE16(&Sector[16]);
+	uint8_t  TotalRecords = Sector[18];
+
+	if (!(SampleRateHz) || !(Month) || (Month > 12) ||
+	    ((SECTOR_HEADER_SIZE + (TotalRecords * RECORD_SIZE)) > SECTOR_SIZE))
+	{
+		return -1;
+	}
+
+	/* Session start time in seconds from 1/1/1970 */
+	long long SessionStart = ((((long long)DateToDays(2000 + Year, Month, Day) * 24 + Hour) * 60 + Minute) * 60 + Second);
+
+	for (uint8_t RecordIndex = 0; RecordIndex < TotalRecords; RecordIndex++)
+	{
+		const uint8_t* Record = &Sector[SECTOR_HEADER_SIZE + (RecordIndex * RECORD_SIZE)];
+
+		uint32_t  SampleNumber = (FirstSample + ReadLE16(&Record[0]));
+		long long SampleTime   = SessionStart + (SampleNumber / SampleRateHz);
+		unsigned  Milliseconds = (unsigned)(((uint64_t)(SampleNumber % SampleRateHz) * 1000) / SampleRateHz);
+
+		long     SampleYear;
+		unsigned SampleMonth, SampleDay;
+		DaysToDate((long)(SampleTime / 86400), &SampleYear, &SampleMonth, &SampleDay);
+
+		long SecondOfDay = (long)(SampleTime % 86400);
+
+		printf("%02u/%02u/%04ld, %02ld:%02ld:%02ld.%03u, %d Degrees\r\n", SampleDay, SampleMonth, SampleYear,
+		       (SecondOfDay / 3600), ((SecondOfDay / 60) % 60), (SecondOfDay % 60), Milliseconds, (int8_t)Record[2]);
+	}
+
+	return LostSamples;
+}
+
+int main(int argc, char* argv[])
+{
+	uint8_t       Sector[SECTOR_SIZE];
+	unsigned long InvalidSectors = 0;
+	unsigned long LostSamples    = 0;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <binary log file>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FILE* LogFile = fopen(argv[1], "rb");
+
+	if (LogFile == NULL)
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	while (fread(Sector, 1, sizeof(Sector), LogFile) == sizeof(Sector))
+	{
+		long SectorLostSamples = ConvertSector(Sector);
+
+		if (SectorLostSamples < 0)
+		  InvalidSectors++;
+		else
+		  LostSamples += SectorLostSamples;
+	}
+
+	fclose(LogFile);
+
+	if (InvalidSectors)
+	  fprintf(stderr, "Warning: %lu invalid sector(s) skipped.\n", InvalidSectors);
+
+	if (LostSamples)
+	  fprintf(stderr, "Warning: %lu sample(s) were lost by the logger.\n", LostSamples);
+
+	return EXIT_SUCCESS;
+}
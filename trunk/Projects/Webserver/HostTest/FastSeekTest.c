@@ -0,0 +1,591 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Host test for the cluster link map ("fast seek") support of the project's FatFs library, which lets the HTTP server
+ *  seek back in a served file on TCP retransmissions without following the file's FAT cluster chain. The library is
+ *  built for the host against an in-memory FAT16 image holding files split into a varying number of fragments, placed
+ *  in shuffled order with free clusters between them so that no two fragments of a file are contiguous. Each file is
+ *  read by the same pseudo-random sequence of forward reads and retransmission seeks (including seeks to the cluster
+ *  boundaries the link map lookup must handle exactly) without a link map, with a link map sized to fit the file, and
+ *  with a link map one fragment too small, which must fail with FR_NOT_ENOUGH_CORE and fall back to the cluster chain.
+ *  All data read is verified against the file contents, the created link maps against the fragments of each file, and
+ *  the number of FAT sector reads made by each sequence is reported. The sequence is repeated for images with one and
+ *  four sectors per cluster.
+ *
+ *  Build and run with "make" in this directory. The program exits with a non-zero status if any test fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "ff.h"
+#include "diskio.h"
+
+/** Size in bytes of each sector of the FAT image. */
+#define SECTOR_SIZE              512
+
+/** Total number of sectors in the FAT image. */
+#define IMAGE_SECTORS            32768
+
+/** Number of sectors reserved for the boot sector at the start of the FAT image. */
+#define RESERVED_SECTORS         1
+
+/** Number of entries in the root directory of the FAT image. */
+#define ROOT_ENTRIES             512
+
+/** Number of link map entries needed to map a file of the given number of fragments, including the table size entry and
+ *  the table terminator, as used to size the link maps of the project's HTTP connections.
+ */
+#define LINKMAP_ENTRIES(Fragments)  (2 + ((Fragments) * 2))
+
+/** Maximum number of fragments of a test file. */
+#define MAX_FRAGMENTS            40
+
+/** Maximum number of clusters of a test file. */
+#define MAX_FILE_CLUSTERS        256
+
+/** Largest single read made by the simulated HTTP server, the maximum TCP segment size of the project. */
+#define MAX_READ_BYTES           1460
+
+/** Number of reads and seeks made on each file. */
+#define FILE_OPERATIONS          3000
+
+/** Type define for a test file of the FAT image. */
+typedef struct
+{
+	const char* Name; /**< Name of the file */
+	uint8_t     Fragments; /**< Number of fragments the file is split into */
+	uint16_t    Clusters; /**< Number of clusters of the file */
+} TestFile_t;
+
+/** Enum for the link map configurations each file is read with. */
+enum LinkMapModes_t
+{
+	LINKMAP_None      = 0, /**< No link map, seeks and reads follow the FAT cluster chain */
+	LINKMAP_Fits      = 1, /**< Link map large enough for all fragments of the file */
+	LINKMAP_TooSmall  = 2, /**< Link map one fragment too small, creation must fail and fall back to the cluster chain */
+};
+
+/** Test files of the FAT image, which are each read with every link map configuration. The Webserver project's default
+ *  FAST_SEEK_FRAGMENTS setting of 4 is able to map the file of 4 fragments, but not the file of 5 fragments.
+ */
+static const TestFile_t Files[] =
+	{
+		{"CONTIG.BIN",  1,  64},
+		{"FRAG4.BIN",   4, 100},
+		{"FRAG5.BIN",   5, 100},
+		{"FRAG40.BIN", 40, 256},
+	};
+
+/** Names of the link map configurations, for the results table. */
+static const char* const LinkMapModeNames[] = {"None", "Fits", "Too small"};
+
+/** Contents of the in-memory FAT image. */
+static uint8_t  Image[IMAGE_SECTORS][SECTOR_SIZE];
+
+/** Number of sectors per cluster of the current FAT image. */
+static uint8_t  SectorsPerCluster;
+
+/** Sector number of the first FAT of the current FAT image. */
+static uint32_t FATStartSector;
+
+/** Number of sectors in each FAT of the current FAT image. */
+static uint32_t FATSectors;
+
+/** Sector number of the first data cluster (cluster 2) of the current FAT image. */
+static uint32_t DataStartSector;
+
+/** First cluster and length of each fragment of each test file, in the file's logical order. */
+static uint32_t FragmentStart[sizeof(Files) / sizeof(Files[0])][MAX_FRAGMENTS];
+static uint16_t FragmentLength[sizeof(Files) / sizeof(Files[0])][MAX_FRAGMENTS];
+
+/** Expected contents of each test file. */
+static uint8_t  FileData[sizeof(Files) / sizeof(Files[0])][MAX_FILE_CLUSTERS * 4 * SECTOR_SIZE];
+
+/** Number of disk reads made by FatFs, and the number of those which read sectors of the FATs. */
+static uint32_t DiskReads;
+static uint32_t FATReads;
+
+DSTATUS disk_initialize(BYTE drv)
+{
+	return 0;
+}
+
+DSTATUS disk_status(BYTE drv)
+{
+	return 0;
+}
+
+DRESULT disk_read(BYTE drv, BYTE* buff, DWORD sector, BYTE count)
+{
+	if ((sector + count) > IMAGE_SECTORS)
+	  return RES_PARERR;
+
+	DiskReads++;
+
+	if ((sector < (FATStartSector + (2 * FATSectors))) && ((sector + count) > FATStartSector))
+	  FATReads++;
+
+	memcpy(buff, Image[sector], ((uint32_t)count * SECTOR_SIZE));
+	return RES_OK;
+}
+
+/** Stores a 16-bit value into the FAT image in little endian format.
+ *
+ *  \param[out] Data   Location of the value in the image
+ *  \param[in]  Value  Value to store
+ */
+static void PutWord(uint8_t* const Data, const uint16_t Value)
+{
+	Data[0] = (Value & 0xFF);
+	Data[1] = (Value >> 8);
+}
+
+/** Stores a 32-bit value into the FAT image in little endian format.
+ *
+ *  \param[out] Data   Location of the value in the image
+ *  \param[in]  Value  Value to store
+ */
+static void PutDWord(uint8_t* const Data, const uint32_t Value)
+{
+	PutWord(&Data[0], (Value & 0xFFFF));
+	PutWord(&Data[2], (Value >> 16));
+}
+
+/** Sets the FAT entry of a cluster in both FATs of the image.
+ *
+ *  \param[in] Cluster  Cluster whose entry is to be set
+ *  \param[in] Value    New value of the cluster's entry
+ */
+static void SetFATEntry(const uint32_t Cluster, const uint16_t Value)
+{
+	for (uint8_t FAT = 0; FAT < 2; FAT++)
+	{
+		uint32_t Offset = (Cluster * 2);
+
+		PutWord(&Image[FATStartSector + (FAT * FATSectors) + (Offset / SECTOR_SIZE)][Offset % SECTOR_SIZE], Value);
+	}
+}
+
+/** Stores the name of a file into a directory entry, in the space padded 8.3 format of FAT directory entries.
+ *
+ *  \param[out] DirEntry  Directory entry to store the name into
+ *  \param[in]  Name      Name of the file, with a three character extension
+ */
+static void PutFileName(uint8_t* const DirEntry, const char* const Name)
+{
+	const char* Extension = strchr(Name, '.');
+
+	memset(DirEntry, ' ', 11);
+	memcpy(&DirEntry[0], Name, (Extension - Name));
+	memcpy(&DirEntry[8], (Extension + 1), 3);
+}
+
+/** Determines the size of a test file, which ends part way through its last cluster.
+ *
+ *  \param[in] File  Test file whose size is to be determined
+ *
+ *  \return Size of the file in bytes
+ */
+static uint32_t FileSize(const TestFile_t* const File)
+{
+	return (((uint32_t)File->Clusters * SectorsPerCluster * SECTOR_SIZE) - 100);
+}
+
+/** Builds a FAT16 image with the given cluster size, holding each test file split into its fragments. The fragments of
+ *  all files are placed in shuffled order, each followed by a free cluster, so that no fragment of a file directly
+ *  follows another fragment of the same file on the disk.
+ *
+ *  \param[in] ClusterSectors  Number of sectors per cluster of the image
+ */
+static void BuildImage(const uint8_t ClusterSectors)
+{
+	uint8_t  FileCount = (sizeof(Files) / sizeof(Files[0]));
+	uint16_t PlacementFile[FileCount * MAX_FRAGMENTS];
+	uint16_t PlacementFragment[FileCount * MAX_FRAGMENTS];
+	uint16_t TotalFragments = 0;
+	uint32_t RootSectors    = ((ROOT_ENTRIES * 32) / SECTOR_SIZE);
+	uint32_t Clusters;
+
+	memset(Image, 0x00, sizeof(Image));
+
+	SectorsPerCluster = ClusterSectors;
+	FATStartSector    = RESERVED_SECTORS;
+
+	/* Size the FATs for the clusters which remain once the FATs themselves are allocated */
+	Clusters        = ((IMAGE_SECTORS - RESERVED_SECTORS - RootSectors) / SectorsPerCluster);
+	FATSectors      = ((((Clusters + 2) * 2) + (SECTOR_SIZE - 1)) / SECTOR_SIZE);
+	DataStartSector = (FATStartSector + (2 * FATSectors) + RootSectors);
+
+	uint8_t* BootSector = Image[0];
+
+	BootSector[0] = 0xEB;
+	BootSector[1] = 0x3C;
+	BootSector[2] = 0x90;
+	memcpy(&BootSector[3], "MSDOS5.0", 8);
+	PutWord(&BootSector[11], SECTOR_SIZE);
+	BootSector[13] = SectorsPerCluster;
+	PutWord(&BootSector[14], RESERVED_SECTORS);
+	BootSector[16] = 2;
+	PutWord(&BootSector[17], ROOT_ENTRIES);
+	PutWord(&BootSector[19], IMAGE_SECTORS);
+	BootSector[21] = 0xF8;
+	PutWord(&BootSector[22], FATSectors);
+	BootSector[38] = 0x29;
+	memcpy(&BootSector[43], "NO NAME    ", 11);
+	memcpy(&BootSector[54], "FAT16   ", 8);
+	PutWord(&BootSector[510], 0xAA55);
+
+	SetFATEntry(0, 0xFFF8);
+	SetFATEntry(1, 0xFFFF);
+
+	/* Split each file into fragments of random lengths, of at least one cluster each */
+	for (uint8_t FileIndex = 0; FileIndex < FileCount; FileIndex++)
+	{
+		const TestFile_t* File = &Files[FileIndex];
+		uint16_t ClustersLeft  = File->Clusters;
+
+		for (uint8_t Fragment = 0; Fragment < File->Fragments; Fragment++)
+		{
+			uint16_t FragmentsLeft = (File->Fragments - Fragment);
+			uint16_t Length        = ((FragmentsLeft == 1) ? ClustersLeft :
+			                          (1 + (rand() % (ClustersLeft - FragmentsLeft + 1) / 2)));
+
+			FragmentLength[FileIndex][Fragment] = Length;
+			ClustersLeft -= Length;
+
+			PlacementFile[TotalFragments]       = FileIndex;
+			PlacementFragment[TotalFragments++] = Fragment;
+		}
+
+		for (uint32_t Offset = 0; Offset < FileSize(File); Offset++)
+		  FileData[FileIndex][Offset] = rand();
+	}
+
+	/* Shuffle the placement order of all fragments */
+	for (uint16_t Index = (TotalFragments - 1); Index > 0; Index--)
+	{
+		uint16_t SwapIndex = (rand() % (Index + 1));
+		uint16_t File      = PlacementFile[Index];
+		uint16_t Fragment  = PlacementFragment[Index];
+
+		PlacementFile[Index]         = PlacementFile[SwapIndex];
+		PlacementFragment[Index]     = PlacementFragment[SwapIndex];
+		PlacementFile[SwapIndex]     = File;
+		PlacementFragment[SwapIndex] = Fragment;
+	}
+
+	uint32_t NextCluster = 2;
+
+	for (uint16_t Index = 0; Index < TotalFragments; Index++)
+	{
+		FragmentStart[PlacementFile[Index]][PlacementFragment[Index]] = NextCluster;
+		NextCluster += (FragmentLength[PlacementFile[Index]][PlacementFragment[Index]] + 1);
+	}
+
+	/* Link the clusters of each file's fragments in logical order, and store the file data into them */
+	for (uint8_t FileIndex = 0; FileIndex < FileCount; FileIndex++)
+	{
+		const TestFile_t* File = &Files[FileIndex];
+		uint32_t FileOffset    = 0;
+		uint32_t PrevCluster   = 0;
+		uint8_t* DirEntry      = Image[FATStartSector + (2 * FATSectors)] + (FileIndex * 32);
+
+		for (uint8_t Fragment = 0; Fragment < File->Fragments; Fragment++)
+		{
+			for (uint16_t Cluster = 0; Cluster < FragmentLength[FileIndex][Fragment]; Cluster++)
+			{
+				uint32_t CurrCluster = (FragmentStart[FileIndex][Fragment] + Cluster);
+				uint32_t Sector      = (DataStartSector + ((CurrCluster - 2) * SectorsPerCluster));
+				uint32_t ClusterSize = ((uint32_t)SectorsPerCluster * SECTOR_SIZE);
+				uint32_t CopyBytes   = (((FileSize(File) - FileOffset) < ClusterSize) ? (FileSize(File) - FileOffset) :
+				                        ClusterSize);
+
+				if (PrevCluster)
+				  SetFATEntry(PrevCluster, CurrCluster);
+
+				memcpy(Image[Sector], &FileData[FileIndex][FileOffset], CopyBytes);
+
+				FileOffset += CopyBytes;
+				PrevCluster = CurrCluster;
+			}
+		}
+
+		SetFATEntry(PrevCluster, 0xFFFF);
+
+		PutFileName(DirEntry, File->Name);
+		DirEntry[11] = 0x20;
+		PutWord(&DirEntry[26], FragmentStart[FileIndex][0]);
+		PutDWord(&DirEntry[28], FileSize(File));
+	}
+}
+
+/** Checks a created link map against the fragments of a test file.
+ *
+ *  \param[in] FileIndex  Index of the test file
+ *  \param[in] LinkMap    Link map created by FatFs
+ *
+ *  \return Number of failures of the check
+ */
+static uint32_t CheckLinkMap(const uint8_t FileIndex, const DWORD* const LinkMap)
+{
+	const TestFile_t* File = &Files[FileIndex];
+
+	for (uint8_t Fragment = 0; Fragment < File->Fragments; Fragment++)
+	{
+		if ((LinkMap[1 + (Fragment * 2)] != FragmentLength[FileIndex][Fragment]) ||
+		    (LinkMap[2 + (Fragment * 2)] != FragmentStart[FileIndex][Fragment]))
+		{
+			printf("%s: link map entry of fragment %u is %lu clusters from cluster %lu, expected %u from %lu\n",
+			       File->Name, Fragment, (unsigned long)LinkMap[1 + (Fragment * 2)],
+			       (unsigned long)LinkMap[2 + (Fragment * 2)], FragmentLength[FileIndex][Fragment],
+			       (unsigned long)FragmentStart[FileIndex][Fragment]);
+			return 1;
+		}
+	}
+
+	if (LinkMap[1 + (File->Fragments * 2)] != 0)
+	{
+		printf("%s: link map not terminated\n", File->Name);
+		return 1;
+	}
+
+	return 0;
+}
+
+/** Chooses the position of the next seek of the simulated HTTP server. Most seeks go back a short distance to the last
+ *  acknowledged position as a TCP retransmission does, and the remainder go to a cluster boundary, to either side of a
+ *  cluster boundary, or to the end of the file. Positions past the end of the file may be returned.
+ *
+ *  \param[in] File      Test file being read
+ *  \param[in] Position  Current position in the file
+ *
+ *  \return Position to seek to
+ */
+static uint32_t ChooseSeekPosition(const TestFile_t* const File, const uint32_t Position)
+{
+	uint32_t ClusterSize = ((uint32_t)SectorsPerCluster * SECTOR_SIZE);
+	uint32_t Boundary    = ((rand() % (File->Clusters + 1)) * ClusterSize);
+
+	switch (rand() % 6)
+	{
+		case 0:
+			return Boundary;
+		case 1:
+			return (Boundary ? (Boundary - 1) : 0);
+		case 2:
+			return (Boundary + 1);
+		case 3:
+			return FileSize(File);
+		default:
+			return ((Position > (3 * MAX_READ_BYTES)) ? (Position - (rand() % (3 * MAX_READ_BYTES))) : 0);
+	}
+}
+
+/** Reads a test file with the given link map configuration, through a pseudo-random sequence of reads and seeks which
+ *  is the same for every configuration, printing the results.
+ *
+ *  \param[in]  FileIndex   Index of the test file to read
+ *  \param[in]  Mode        Link map configuration, a value from the \ref LinkMapModes_t enum
+ *  \param[out] ReadCounts  Number of disk reads and FAT sector reads made by the sequence
+ *
+ *  \return Number of failures of the test
+ */
+static uint32_t ReadFile(const uint8_t FileIndex, const uint8_t Mode, uint32_t ReadCounts[2])
+{
+	const TestFile_t* File = &Files[FileIndex];
+	uint32_t Failures      = 0;
+	uint32_t Position      = 0;
+	FRESULT  MapResult     = FR_OK;
+	FIL      FileHandle;
+	DWORD    LinkMap[LINKMAP_ENTRIES(MAX_FRAGMENTS)];
+	BYTE     ReadBuffer[MAX_READ_BYTES];
+
+	ReadCounts[0] = 0;
+	ReadCounts[1] = 0;
+
+	if (f_open(&FileHandle, File->Name, (FA_OPEN_EXISTING | FA_READ)) != FR_OK)
+	{
+		printf("%s: could not be opened\n", File->Name);
+		return 1;
+	}
+
+	if (Mode != LINKMAP_None)
+	{
+		DWORD RequiredEntries = LINKMAP_ENTRIES(File->Fragments);
+
+		FileHandle.cltbl = LinkMap;
+		LinkMap[0]       = ((Mode == LINKMAP_Fits) ? RequiredEntries : (RequiredEntries - 2));
+
+		MapResult = f_lseek(&FileHandle, CREATE_LINKMAP);
+
+		if (Mode == LINKMAP_Fits)
+		{
+			if (MapResult != FR_OK)
+			{
+				printf("%s: link map creation failed with a large enough table\n", File->Name);
+				Failures++;
+			}
+			else
+			{
+				Failures += CheckLinkMap(FileIndex, LinkMap);
+			}
+		}
+		else if ((MapResult != FR_NOT_ENOUGH_CORE) || (FileHandle.cltbl != NULL) || (LinkMap[0] != RequiredEntries))
+		{
+			printf("%s: table too small did not fail with FR_NOT_ENOUGH_CORE and the required table size\n", File->Name);
+			Failures++;
+		}
+	}
+
+	/* Discard the sector held in the FatFs sector window by link map creation, so that every configuration starts alike */
+	FileHandle.fs->winsect = 0;
+
+	DiskReads = 0;
+	FATReads  = 0;
+
+	/* Use the same sequence of reads and seeks for every link map configuration of the file */
+	srand(FileIndex + 1);
+
+	for (uint16_t Operation = 0; Operation < FILE_OPERATIONS; Operation++)
+	{
+		if (!(rand() % 3) || (Position >= FileSize(File)))
+		{
+			uint32_t SeekPosition = ChooseSeekPosition(File, Position);
+
+			/* Seeks past the end of a file opened for reading are clipped to the end of the file */
+			Position = ((SeekPosition < FileSize(File)) ? SeekPosition : FileSize(File));
+
+			if ((f_lseek(&FileHandle, SeekPosition) != FR_OK) || (FileHandle.fptr != Position))
+			{
+				printf("%s: seek to %lu failed\n", File->Name, (unsigned long)SeekPosition);
+				Failures++;
+				break;
+			}
+		}
+
+		UINT RequestBytes = (1 + (rand() % MAX_READ_BYTES));
+		UINT ExpectedBytes = (((FileSize(File) - Position) < RequestBytes) ? (FileSize(File) - Position) : RequestBytes);
+		UINT ReadBytes;
+
+		if ((f_read(&FileHandle, ReadBuffer, RequestBytes, &ReadBytes) != FR_OK) || (ReadBytes != ExpectedBytes) ||
+		    memcmp(ReadBuffer, &FileData[FileIndex][Position], ReadBytes))
+		{
+			printf("%s: read of %u bytes at %lu returned incorrect data\n", File->Name, RequestBytes,
+			       (unsigned long)Position);
+			Failures++;
+			break;
+		}
+
+		Position += ReadBytes;
+	}
+
+	ReadCounts[0] = DiskReads;
+	ReadCounts[1] = FATReads;
+
+	printf("  %-12s %9u %-10s %-18s %10lu %9lu\n", File->Name, File->Fragments, LinkMapModeNames[Mode],
+	       ((MapResult == FR_OK) ? ((Mode == LINKMAP_None) ? "-" : "FR_OK") : "FR_NOT_ENOUGH_CORE"),
+	       (unsigned long)DiskReads, (unsigned long)FATReads);
+
+	f_close(&FileHandle);
+	return Failures;
+}
+
+/** Builds a FAT image with the given cluster size, and reads every test file with each link map configuration.
+ *
+ *  \param[in] ClusterSectors  Number of sectors per cluster of the image
+ *
+ *  \return Number of errors encountered with the image
+ */
+static uint32_t TestImage(const uint8_t ClusterSectors)
+{
+	uint32_t Errors = 0;
+	FATFS    FileSystem;
+
+	BuildImage(ClusterSectors);
+	f_mount(0, &FileSystem);
+
+	printf("FAT16 image, %u sector clusters:\n", ClusterSectors);
+	printf("  %-12s %9s %-10s %-18s %10s %9s\n", "File", "Fragments", "Link map", "CREATE_LINKMAP", "Disk reads",
+	       "FAT reads");
+
+	for (uint8_t FileIndex = 0; FileIndex < (sizeof(Files) / sizeof(Files[0])); FileIndex++)
+	{
+		uint32_t ReadCounts[3][2];
+
+		for (uint8_t Mode = LINKMAP_None; Mode <= LINKMAP_TooSmall; Mode++)
+		  Errors += ReadFile(FileIndex, Mode, ReadCounts[Mode]);
+
+		/* With a link map, seeks and reads must never need to read the FAT */
+		if (ReadCounts[LINKMAP_Fits][1])
+		{
+			printf("%s: %lu FAT reads with a link map\n", Files[FileIndex].Name, (unsigned long)ReadCounts[LINKMAP_Fits][1]);
+			Errors++;
+		}
+
+		/* A failed link map creation must leave the file exactly as if no link map had been given */
+		if (memcmp(ReadCounts[LINKMAP_TooSmall], ReadCounts[LINKMAP_None], sizeof(ReadCounts[0])))
+		{
+			printf("%s: fallback after FR_NOT_ENOUGH_CORE differs from reading without a link map\n", Files[FileIndex].Name);
+			Errors++;
+		}
+	}
+
+	f_mount(0, NULL);
+	printf("\n");
+
+	return Errors;
+}
+
+int main(void)
+{
+	uint32_t TotalErrors = 0;
+
+	srand(1);
+	TotalErrors += TestImage(1);
+
+	srand(2);
+	TotalErrors += TestImage(4);
+
+	printf("Disk reads is the number of disk_read() calls made by each sequence of %u reads and seeks, and FAT reads the\n",
+	       FILE_OPERATIONS);
+	printf("number of those which read a FAT sector.\n");
+
+	if (TotalErrors)
+	{
+		printf("\nFAILED: %lu errors\n", (unsigned long)TotalErrors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+/** \file
+ *
+ *  Shim header force-included (via the compiler's -include switch) when building the project's FatFs library for the
+ *  host machine. The FatFs integer types are defined here with their exact AVR sizes, as the library's own definitions
+ *  give a 64-bit DWORD on most hosts, and the block device header included by the disk IO layer is suppressed, as the
+ *  disk IO functions are implemented by the test over an in-memory FAT image instead.
+ */
+
+#ifndef _FATFS_SHIM_H_
+#define _FATFS_SHIM_H_
+
+	/* Macros: */
+		#define _INTEGER
+		#define __BLOCKDEVICE_H__
+
+	/* Includes: */
+		#include <stdint.h>
+
+	/* Type Defines: */
+		typedef int16_t         INT;
+		typedef uint16_t        UINT;
+
+		typedef int8_t          CHAR;
+		typedef uint8_t         UCHAR;
+		typedef uint8_t         BYTE;
+
+		typedef int16_t         SHORT;
+		typedef uint16_t        USHORT;
+		typedef uint16_t        WORD;
+		typedef uint16_t        WCHAR;
+
+		typedef int32_t         LONG;
+		typedef uint32_t        ULONG;
+		typedef uint32_t        DWORD;
+
+		typedef enum { FALSE = 0, TRUE } BOOL;
+
+#endif
@@ -14,7 +14,11 @@ DSTATUS disk_initialize (
 	BYTE drv				/* Physical drive nmuber (0..) */
 )
 {
-	return FR_OK;
+	/* A removed or unresponsive medium, such as a detached USB flash drive, cannot be mounted */
+	if (!(BlockDevice_CheckOperation()))
+	  return (STA_NOINIT | STA_NODISK);
+
+	return 0;
 }
 
 
@@ -26,7 +30,11 @@ DSTATUS disk_status (
 	BYTE drv		/* Physical drive nmuber (0..) */
 )
 {
-	return FR_OK;
+	/* Report a medium removed since it was mounted, so that FatFs fails accesses to it until it is mounted again */
+	if (!(BlockDevice_CheckOperation()))
+	  return (STA_NOINIT | STA_NODISK);
+
+	return 0;
 }
 
 
@@ -41,7 +49,9 @@ DRESULT disk_read (
 	BYTE count		/* Number of sectors to read (1..255) */
 )
 {
-	DataflashManager_ReadBlocks_RAM(sector, count, buff);
+	if (BlockDevice_ReadBlocks(sector, count, buff) != BLOCKDEV_ERROR_NoError)
+	  return RES_ERROR;
+
 	return RES_OK;
 }
 
@@ -58,7 +68,9 @@ DRESULT disk_write (
 	BYTE count			/* Number of sectors to write (1..255) */
 )
 {
-	DataflashManager_WriteBlocks_RAM(sector, count, buff);
+	if (BlockDevice_WriteBlocks(sector, count, buff) != BLOCKDEV_ERROR_NoError)
+	  return RES_ERROR;
+
 	return RES_OK;
 }
 #endif /* _READONLY */
@@ -10,7 +10,7 @@
 #include "integer.h"
 #include "ff.h"
 
-#include "../DataflashManager.h"
+#include <LUFA/Drivers/Misc/BlockDevice.h>
 
 
 /* Status of Disk Functions */
@@ -537,6 +537,35 @@ DWORD clust2sect (	/* !=0: Sector number, 0: Failed - invalid cluster# */
 
 
 
+#if _USE_FASTSEEK
+/*-----------------------------------------------------------------------*/
+/* Get cluster# from the cluster link map table                          */
+/*-----------------------------------------------------------------------*/
+
+static
+DWORD clmt_clust (	/* !=0: Cluster number, 0: Offset is not in the table */
+	FIL *fp,		/* Pointer to the file object */
+	DWORD ofs		/* File offset to be converted to cluster# */
+)
+{
+	DWORD cl, ncl, *tbl;
+
+
+	tbl = fp->cltbl + 1;	/* Top of the fragment list */
+	cl = ofs / SS(fp->fs) / fp->fs->csize;	/* Cluster order from top of the file */
+	for (;;) {
+		ncl = *tbl++;			/* Number of clusters in the fragment */
+		if (!ncl) return 0;		/* End of table */
+		if (cl < ncl) break;	/* In this fragment? */
+		cl -= ncl; tbl++;		/* Next fragment */
+	}
+	return cl + *tbl;		/* Return the cluster# */
+}
+#endif /* _USE_FASTSEEK */
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Directory handling - Seek directory index                             */
 /*-----------------------------------------------------------------------*/
@@ -1748,6 +1777,9 @@ FRESULT f_open (
 	fp->fsize = LD_DWORD(dir+DIR_FileSize);	/* File size */
 	fp->fptr = 0; fp->csect = 255;		/* File pointer */
 	fp->dsect = 0;
+#if _USE_FASTSEEK
+	fp->cltbl = 0;						/* No cluster link map table */
+#endif
 	fp->fs = dj.fs; fp->id = dj.fs->id;	/* Owner file system object of the file */
 
 	LEAVE_FF(dj.fs, FR_OK);
@@ -1788,6 +1820,12 @@ FRESULT f_read (
 		rbuff += rcnt, fp->fptr += rcnt, *br += rcnt, btr -= rcnt) {
 		if ((fp->fptr % SS(fp->fs)) == 0) {			/* On the sector boundary? */
 			if (fp->csect >= fp->fs->csize) {		/* On the cluster boundary? */
+#if _USE_FASTSEEK
+				clst = 0;
+				if (fp->cltbl && fp->fptr)			/* Get the next cluster from the link map if given */
+					clst = clmt_clust(fp, fp->fptr);
+				if (!clst)
+#endif
 				clst = (fp->fptr == 0) ?			/* On the top of the file? */
 					fp->org_clust : get_fat(fp->fs, fp->curr_clust);
 				if (clst <= 1) ABORT(fp->fs, FR_INT_ERR);
@@ -2106,12 +2144,45 @@ FRESULT f_lseek (
 {
 	FRESULT res;
 	DWORD clst, bcs, nsect, ifptr;
+#if _USE_FASTSEEK
+	DWORD pcl, ncl, tcl, tlen, ulen, *tbl;
+#endif
 
 
 	res = validate(fp->fs, fp->id);		/* Check validity of the object */
 	if (res != FR_OK) LEAVE_FF(fp->fs, res);
 	if (fp->flag & FA__ERROR)			/* Check abort flag */
 		LEAVE_FF(fp->fs, FR_INT_ERR);
+#if _USE_FASTSEEK
+	if (ofs == CREATE_LINKMAP) {		/* Create the cluster link map table */
+		if (!fp->cltbl) LEAVE_FF(fp->fs, FR_INVALID_OBJECT);
+		tbl = fp->cltbl;
+		tlen = *tbl++; ulen = 2;		/* Given table size and required table size */
+		clst = fp->org_clust;
+		if (clst) {
+			do {
+				tcl = clst; ncl = 0; ulen += 2;	/* Top and length of a fragment */
+				do {
+					pcl = clst; ncl++;
+					clst = get_fat(fp->fs, clst);
+					if (clst == 0xFFFFFFFF) ABORT(fp->fs, FR_DISK_ERR);
+					if (clst <= 1) ABORT(fp->fs, FR_INT_ERR);
+				} while (clst == pcl + 1);	/* Follow the chain while it is contiguous */
+				if (ulen <= tlen) {		/* Store the length and top of the fragment */
+					*tbl++ = ncl; *tbl++ = tcl;
+				}
+			} while (clst < fp->fs->max_clust);	/* Repeat until end of chain */
+		}
+		*fp->cltbl = ulen;				/* Number of items required */
+		if (ulen <= tlen) {
+			*tbl = 0;					/* Terminate the table */
+		} else {
+			fp->cltbl = 0;				/* Given table is too small, fast seek is not used */
+			res = FR_NOT_ENOUGH_CORE;
+		}
+		LEAVE_FF(fp->fs, res);
+	}
+#endif
 	if (ofs > fp->fsize					/* In read-only mode, clip offset with the file size */
 #if !_FS_READONLY
 		 && !(fp->flag & FA_WRITE)
@@ -2122,6 +2193,13 @@ FRESULT f_lseek (
 	fp->fptr = nsect = 0; fp->csect = 255;
 	if (ofs > 0) {
 		bcs = (DWORD)fp->fs->csize * SS(fp->fs);	/* Cluster size (byte) */
+#if _USE_FASTSEEK
+		if (fp->cltbl && (clst = clmt_clust(fp, ofs - 1)) != 0) {	/* When the cluster is in the link map, */
+			fp->fptr = (ofs - 1) & ~(bcs - 1);	/* start from the cluster without following the chain */
+			ofs -= fp->fptr;
+			fp->curr_clust = clst;
+		} else
+#endif
 		if (ifptr > 0 &&
 			(ofs - 1) / bcs >= (ifptr - 1) / bcs) {	/* When seek to same or following cluster, */
 			fp->fptr = (ifptr - 1) & ~(bcs - 1);	/* start from the current cluster */
@@ -362,6 +362,9 @@ typedef struct _FIL_ {
 	DWORD	org_clust;	/* File start cluster */
 	DWORD	curr_clust;	/* Current cluster */
 	DWORD	dsect;		/* Current data sector */
+#if _USE_FASTSEEK
+	DWORD*	cltbl;		/* Pointer to the cluster link map table (null: not used) */
+#endif
 #if !_FS_READONLY
 	DWORD	dir_sect;	/* Sector containing the directory entry */
 	BYTE*	dir_ptr;	/* Ponter to the directory entry in the window */
@@ -407,7 +410,8 @@ typedef enum {
 	FR_NOT_ENABLED,		/* 12 */
 	FR_NO_FILESYSTEM,	/* 13 */
 	FR_MKFS_ABORTED,	/* 14 */
-	FR_TIMEOUT			/* 15 */
+	FR_TIMEOUT,			/* 15 */
+	FR_NOT_ENOUGH_CORE	/* 16 */
 } FRESULT;
 
 
@@ -495,6 +499,11 @@ void ff_rel_grant(_SYNC_t);
 #define FA__ERROR			0x80
 
 
+/* Special offset given to f_lseek to create the cluster link map table */
+
+#define CREATE_LINKMAP		0xFFFFFFFF
+
+
 /* FAT sub type (FATFS.fs_type) */
 
 #define FS_FAT12	1
@@ -48,6 +48,14 @@
 /* To enable f_forward function, set _USE_FORWARD to 1 and set _FS_TINY to 1. */
 
 
+#define	_USE_FASTSEEK	1	/* 0 or 1 */
+/* To enable fast seek feature, set _USE_FASTSEEK to 1. When a cluster link map
+/  table is given to a file object and created with f_lseek(fp, CREATE_LINKMAP),
+/  f_lseek and f_read look up clusters in the table instead of following the
+/  cluster chain in the FAT. The table must be re-created if the file size is
+/  changed while the table is in use. */
+
+
 
 /*---------------------------------------------------------------------------/
 / Locale and Namespace Configurations
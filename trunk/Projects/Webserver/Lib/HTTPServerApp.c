@@ -203,6 +203,17 @@ static void HTTPServerApp_OpenRequestedFile(void)
 	AppState->HTTPServer.FileOpen     = (f_open(&AppState->HTTPServer.FileHandle, AppState->HTTPServer.FileName,
 	                                            (FA_OPEN_EXISTING | FA_READ)) == FR_OK);
 
+	#if (FAST_SEEK_FRAGMENTS > 0)
+	/* Map the file's clusters so that seeking back on retransmissions does not need to follow the FAT cluster chain -
+	 * if the file is too fragmented to fit into the map, it is still served but seeks fall back to the cluster chain */
+	if (AppState->HTTPServer.FileOpen)
+	{
+		AppState->HTTPServer.FileHandle.cltbl    = AppState->HTTPServer.FileLinkMap;
+		AppState->HTTPServer.FileLinkMap[0]      = (sizeof(AppState->HTTPServer.FileLinkMap) / sizeof(DWORD));
+		f_lseek(&AppState->HTTPServer.FileHandle, CREATE_LINKMAP);
+	}
+	#endif
+
 	/* Lock to the SendResponseHeader state until connection terminated */
 	AppState->HTTPServer.CurrentState = WEBSERVER_STATE_SendResponseHeader;
 	AppState->HTTPServer.NextState    = WEBSERVER_STATE_SendResponseHeader;
@@ -693,6 +693,9 @@ typedef union
 		
 		char     FileName[MAX_URI_LENGTH];
 		FIL      FileHandle;
+		#if (FAST_SEEK_FRAGMENTS > 0)
+		DWORD    FileLinkMap[2 + (FAST_SEEK_FRAGMENTS * 2)];
+		#endif
 		bool     FileOpen;
 		uint32_t ACKedFilePos;
 		uint16_t SentChunkSize;
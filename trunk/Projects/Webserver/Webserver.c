@@ -71,4 +71,7 @@ void SetupHardware(void)
 	Dataflash_Init();
 	LEDs_Init();
 	USB_Init(USB_MODE_UID);
+
+	/* Prepare the storage medium for use, clearing Dataflash sector protections if enabled */
+	BlockDevice_Init();
 }